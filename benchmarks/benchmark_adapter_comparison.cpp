@@ -0,0 +1,281 @@
+/**
+ * @file
+ *
+ * @brief   Benchmark comparing the performance of the JSON adapters
+ *
+ * The adapter comparison test suite (tests/test_adapter_comparison.cpp)
+ * checks that all adapters agree on semantics; this benchmark is its
+ * performance twin. It runs an identical schema/document workload through
+ * every adapter that was available at build time, and reports document
+ * parse time, validation time and the process peak RSS, so that an adapter
+ * can be chosen on measurements rather than folklore.
+ *
+ * Peak RSS is process-wide and only ever grows, so for meaningful memory
+ * numbers run one adapter at a time, e.g.:
+ *
+ *     benchmark_adapter_comparison --benchmark_filter=NlohmannJsonAdapter
+ */
+
+#ifdef _MSC_VER
+#pragma warning(disable: 4706)
+#include <picojson.h>
+#pragma warning(default: 4706)
+#else
+#include <picojson.h>
+#endif
+
+#include <string>
+
+#include <benchmark/benchmark.h>
+
+#include <rapidjson/document.h>
+
+#include <nlohmann/json.hpp>
+
+#include <valijson/adapters/nlohmann_json_adapter.hpp>
+#include <valijson/adapters/picojson_adapter.hpp>
+#include <valijson/adapters/rapidjson_adapter.hpp>
+#include <valijson/schema.hpp>
+#include <valijson/schema_parser.hpp>
+#include <valijson/validator.hpp>
+
+#ifdef VALIJSON_BUILD_BOOST_JSON_ADAPTER
+#include <boost/json.hpp>
+#include <valijson/adapters/boost_json_adapter.hpp>
+#endif
+
+#ifdef VALIJSON_BUILD_BOOST_PROPERTY_TREE_ADAPTER
+#include <sstream>
+#include <boost/property_tree/json_parser.hpp>
+#include <boost/property_tree/ptree.hpp>
+#include <valijson/adapters/property_tree_adapter.hpp>
+#endif
+
+#ifndef _WIN32
+#include <sys/resource.h>
+#endif
+
+using valijson::Schema;
+using valijson::SchemaParser;
+using valijson::Validator;
+
+namespace {
+
+/**
+ * Build the schema for the shared event-batch workload. Values are kept
+ * loosely typed (validated with weak type checking) so that adapters that
+ * represent scalars as strings, such as the property tree adapter, complete
+ * the same validation work as the strongly typed adapters.
+ */
+std::string makeEventBatchSchema()
+{
+    return R"({
+        "type": "object",
+        "properties": {
+            "source": {"type": "string", "minLength": 1},
+            "events": {
+                "type": "array",
+                "items": {
+                    "type": "object",
+                    "properties": {
+                        "kind": {"enum": ["created", "updated", "deleted"]},
+                        "id": {"type": "string", "pattern": "^[a-z]+-[0-9]+$"},
+                        "sequence": {"type": "integer", "minimum": 0},
+                        "payload": {"type": "string"}
+                    },
+                    "required": ["kind", "id", "sequence"]
+                }
+            }
+        },
+        "required": ["source", "events"]
+    })";
+}
+
+/**
+ * Build a document with the requested number of events, valid against the
+ * schema produced by makeEventBatchSchema.
+ */
+std::string makeEventBatchDocument(size_t numEvents)
+{
+    static const char *kinds[] = { "created", "updated", "deleted" };
+
+    std::string document = R"({"source": "benchmark", "events": [)";
+    for (size_t i = 0; i < numEvents; i++) {
+        if (i > 0) {
+            document += ",";
+        }
+        document += std::string("{\"kind\": \"") + kinds[i % 3] +
+                "\", \"id\": \"event-" + std::to_string(i) +
+                "\", \"sequence\": " + std::to_string(i) +
+                ", \"payload\": \"abcdefghijklmnopqrstuvwxyz\"}";
+    }
+    document += "]}";
+
+    return document;
+}
+
+/**
+ * Parse a JSON string into a rapidjson document
+ */
+bool parseDocument(const std::string &json, rapidjson::Document &document)
+{
+    document.Parse(json.c_str());
+    return !document.HasParseError();
+}
+
+/**
+ * Parse a JSON string into an nlohmann::json document
+ */
+bool parseDocument(const std::string &json, nlohmann::json &document)
+{
+    document = nlohmann::json::parse(json, nullptr, false);
+    return !document.is_discarded();
+}
+
+/**
+ * Parse a JSON string into a picojson document
+ */
+bool parseDocument(const std::string &json, picojson::value &document)
+{
+    return picojson::parse(document, json).empty();
+}
+
+#ifdef VALIJSON_BUILD_BOOST_JSON_ADAPTER
+/**
+ * Parse a JSON string into a Boost.JSON document
+ */
+bool parseDocument(const std::string &json, boost::json::value &document)
+{
+    boost::json::error_code errorCode;
+    document = boost::json::parse(json, errorCode);
+    return !errorCode;
+}
+#endif
+
+#ifdef VALIJSON_BUILD_BOOST_PROPERTY_TREE_ADAPTER
+/**
+ * Parse a JSON string into a Boost property tree
+ */
+bool parseDocument(const std::string &json, boost::property_tree::ptree &document)
+{
+#if VALIJSON_USE_EXCEPTIONS
+    try {
+#endif
+        std::istringstream stream(json);
+        boost::property_tree::read_json(stream, document);
+        return true;
+#if VALIJSON_USE_EXCEPTIONS
+    } catch (const boost::property_tree::json_parser_error &) {
+        return false;
+    }
+#endif
+}
+#endif
+
+/**
+ * Record the process peak RSS, in kilobytes, as a benchmark counter
+ */
+void recordPeakRss(benchmark::State &state)
+{
+#ifndef _WIN32
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) == 0) {
+#ifdef __APPLE__
+        state.counters["peak_rss_kb"] = static_cast<double>(usage.ru_maxrss / 1024);
+#else
+        state.counters["peak_rss_kb"] = static_cast<double>(usage.ru_maxrss);
+#endif
+    }
+#else
+    (void) state;
+#endif
+}
+
+/**
+ * Measure the time taken to parse the event-batch document
+ */
+template<typename AdapterType>
+void benchmarkParse(benchmark::State &state)
+{
+    typedef valijson::adapters::AdapterTraits<AdapterType> AdapterTraits;
+
+    const std::string documentJson = makeEventBatchDocument(state.range(0));
+
+    for (auto _ : state) {
+        typename AdapterTraits::DocumentType document;
+        if (!parseDocument(documentJson, document)) {
+            state.SkipWithError("Failed to parse benchmark document");
+            return;
+        }
+        benchmark::DoNotOptimize(document);
+    }
+
+    state.SetBytesProcessed(state.iterations() * documentJson.size());
+    recordPeakRss(state);
+}
+
+/**
+ * Measure the time taken to validate the event-batch document
+ */
+template<typename AdapterType>
+void benchmarkValidate(benchmark::State &state)
+{
+    typedef valijson::adapters::AdapterTraits<AdapterType> AdapterTraits;
+
+    typename AdapterTraits::DocumentType schemaDocument;
+    typename AdapterTraits::DocumentType targetDocument;
+    if (!parseDocument(makeEventBatchSchema(), schemaDocument) ||
+            !parseDocument(makeEventBatchDocument(state.range(0)), targetDocument)) {
+        state.SkipWithError("Failed to parse benchmark fixture");
+        return;
+    }
+
+    Schema schema;
+    SchemaParser parser;
+    parser.populateSchema(AdapterType(schemaDocument), schema);
+
+    // Weak type checking keeps the workload identical across adapters; see
+    // the note on makeEventBatchSchema
+    Validator validator(Validator::kWeakTypes);
+    const AdapterType targetAdapter(targetDocument);
+    if (!validator.validate(schema, targetAdapter, nullptr)) {
+        state.SkipWithError("Benchmark document failed validation");
+        return;
+    }
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(validator.validate(schema, targetAdapter, nullptr));
+    }
+
+    recordPeakRss(state);
+}
+
+using valijson::adapters::NlohmannJsonAdapter;
+using valijson::adapters::PicoJsonAdapter;
+using valijson::adapters::RapidJsonAdapter;
+
+} // end anonymous namespace
+
+BENCHMARK_TEMPLATE(benchmarkParse, RapidJsonAdapter)->Range(8, 4096);
+BENCHMARK_TEMPLATE(benchmarkParse, NlohmannJsonAdapter)->Range(8, 4096);
+BENCHMARK_TEMPLATE(benchmarkParse, PicoJsonAdapter)->Range(8, 4096);
+
+BENCHMARK_TEMPLATE(benchmarkValidate, RapidJsonAdapter)->Range(8, 4096);
+BENCHMARK_TEMPLATE(benchmarkValidate, NlohmannJsonAdapter)->Range(8, 4096);
+BENCHMARK_TEMPLATE(benchmarkValidate, PicoJsonAdapter)->Range(8, 4096);
+
+#ifdef VALIJSON_BUILD_BOOST_JSON_ADAPTER
+using valijson::adapters::BoostJsonAdapter;
+
+BENCHMARK_TEMPLATE(benchmarkParse, BoostJsonAdapter)->Range(8, 4096);
+BENCHMARK_TEMPLATE(benchmarkValidate, BoostJsonAdapter)->Range(8, 4096);
+#endif
+
+#ifdef VALIJSON_BUILD_BOOST_PROPERTY_TREE_ADAPTER
+using valijson::adapters::PropertyTreeAdapter;
+
+BENCHMARK_TEMPLATE(benchmarkParse, PropertyTreeAdapter)->Range(8, 4096);
+BENCHMARK_TEMPLATE(benchmarkValidate, PropertyTreeAdapter)->Range(8, 4096);
+#endif
+
+BENCHMARK_MAIN();
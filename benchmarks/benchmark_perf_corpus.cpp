@@ -0,0 +1,144 @@
+/**
+ * Benchmark that replays the performance regression corpus.
+ *
+ * The corpus is a directory of JSON files, each an array of the form
+ * [schema, document], archived by the perf-fuzz harness
+ * (tests/fuzzing/perf_fuzzer.cpp) when it finds an input whose validation
+ * cost is super-linear in its size. Replaying the corpus here keeps those
+ * pathological inputs under continuous measurement, so a change that
+ * reintroduces an algorithmic blowup shows up as a step change in these
+ * timings before it is deployed.
+ *
+ * Each corpus entry is benchmarked under both the default std::regex
+ * engine and FastRegexEngine, since several historical blowups were
+ * specific to backtracking regex evaluation.
+ *
+ * The corpus directory is taken from the VALIJSON_PERF_CORPUS_DIR
+ * environment variable, falling back to the compile-time default set by
+ * the build system.
+ */
+
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include <nlohmann/json.hpp>
+
+#include <valijson/adapters/nlohmann_json_adapter.hpp>
+#include <valijson/utils/nlohmann_json_utils.hpp>
+#include <valijson/fast_regex_engine.hpp>
+#include <valijson/schema.hpp>
+#include <valijson/schema_parser.hpp>
+#include <valijson/validator.hpp>
+
+#ifndef _WIN32
+#include <dirent.h>
+#endif
+
+#ifndef VALIJSON_PERF_CORPUS_DIR
+#define VALIJSON_PERF_CORPUS_DIR "benchmarks/perf_corpus"
+#endif
+
+using valijson::FastRegexEngine;
+using valijson::Schema;
+using valijson::SchemaParser;
+using valijson::Validator;
+using valijson::ValidatorT;
+using valijson::adapters::NlohmannJsonAdapter;
+
+namespace {
+
+/// A corpus entry, parsed and compiled once before benchmark registration
+struct CorpusEntry
+{
+    std::string name;
+    nlohmann::json document;
+    std::shared_ptr<Schema> schema;
+};
+
+std::string corpusDir()
+{
+    const char *dir = getenv("VALIJSON_PERF_CORPUS_DIR");
+    return dir ? dir : VALIJSON_PERF_CORPUS_DIR;
+}
+
+std::vector<std::string> listCorpusFiles(const std::string &dir)
+{
+    std::vector<std::string> files;
+#ifndef _WIN32
+    if (DIR *handle = opendir(dir.c_str())) {
+        while (const dirent *entry = readdir(handle)) {
+            const std::string name = entry->d_name;
+            if (name.size() > 5 && name.compare(name.size() - 5, 5, ".json") == 0) {
+                files.push_back(name);
+            }
+        }
+        closedir(handle);
+    }
+#endif
+    std::sort(files.begin(), files.end());
+    return files;
+}
+
+std::vector<CorpusEntry> loadCorpus()
+{
+    std::vector<CorpusEntry> corpus;
+    const std::string dir = corpusDir();
+    for (const std::string &file : listCorpusFiles(dir)) {
+        nlohmann::json entry;
+        if (!valijson::utils::loadDocument(dir + "/" + file, entry)) {
+            continue;
+        }
+        if (!entry.is_array() || entry.size() != 2) {
+            continue;
+        }
+
+        CorpusEntry parsed;
+        parsed.name = file.substr(0, file.size() - 5);
+        parsed.document = entry[1];
+        parsed.schema = std::make_shared<Schema>();
+
+        SchemaParser parser;
+        NlohmannJsonAdapter schemaAdapter(entry[0]);
+        parser.populateSchema(schemaAdapter, *parsed.schema);
+
+        corpus.push_back(parsed);
+    }
+    return corpus;
+}
+
+template<typename RegexEngine>
+void benchmarkCorpusEntry(benchmark::State &state, const CorpusEntry &entry)
+{
+    ValidatorT<RegexEngine> validator;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(validator.validate(
+                *entry.schema, NlohmannJsonAdapter(entry.document), nullptr));
+    }
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    // Entries are owned by a static so that they outlive the registered
+    // benchmark closures
+    static const std::vector<CorpusEntry> corpus = loadCorpus();
+
+    for (const CorpusEntry &entry : corpus) {
+        benchmark::RegisterBenchmark(("PerfCorpus/" + entry.name).c_str(),
+                [&entry](benchmark::State &state) {
+                    benchmarkCorpusEntry<valijson::DefaultRegexEngine>(state, entry);
+                });
+        benchmark::RegisterBenchmark(("PerfCorpus/" + entry.name + "/FastRegex").c_str(),
+                [&entry](benchmark::State &state) {
+                    benchmarkCorpusEntry<FastRegexEngine>(state, entry);
+                });
+    }
+
+    benchmark::Initialize(&argc, argv);
+    benchmark::RunSpecifiedBenchmarks();
+    return 0;
+}
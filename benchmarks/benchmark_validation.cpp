@@ -0,0 +1,234 @@
+#ifdef _MSC_VER
+#pragma warning(disable: 4706)
+#include <picojson.h>
+#pragma warning(default: 4706)
+#else
+#include <picojson.h>
+#endif
+
+#include <string>
+
+#include <benchmark/benchmark.h>
+
+#include <rapidjson/document.h>
+
+#include <nlohmann/json.hpp>
+
+#include <valijson/adapters/nlohmann_json_adapter.hpp>
+#include <valijson/adapters/picojson_adapter.hpp>
+#include <valijson/adapters/rapidjson_adapter.hpp>
+#include <valijson/utils/nlohmann_json_utils.hpp>
+#include <valijson/utils/picojson_utils.hpp>
+#include <valijson/utils/rapidjson_utils.hpp>
+#include <valijson/schema.hpp>
+#include <valijson/schema_parser.hpp>
+#include <valijson/validator.hpp>
+
+#define TEST_DATA_DIR "../tests/data/"
+
+using valijson::Schema;
+using valijson::SchemaParser;
+using valijson::Validator;
+
+namespace {
+
+/**
+ * Build a schema document containing a chain of allOf constraints, each
+ * of which contains a trivial type constraint.
+ *
+ * The resulting schema exercises the constraint dispatch and subschema
+ * recursion hot paths without requiring a large target document.
+ */
+std::string makeDeepAllOfSchema(size_t depth)
+{
+    std::string schema = "{\"type\": \"object\"}";
+    for (size_t i = 0; i < depth; i++) {
+        schema = "{\"allOf\": [" + schema + "]}";
+    }
+
+    return schema;
+}
+
+/**
+ * Build a schema document containing a 'properties' map with the requested
+ * number of entries, each mapping to a simple type constraint.
+ */
+std::string makeWidePropertiesSchema(size_t numProperties)
+{
+    std::string schema = "{\"type\": \"object\", \"properties\": {";
+    for (size_t i = 0; i < numProperties; i++) {
+        if (i > 0) {
+            schema += ",";
+        }
+        schema += "\"property_" + std::to_string(i) + "\": {\"type\": \"string\"}";
+    }
+    schema += "}}";
+
+    return schema;
+}
+
+/**
+ * Build a schema document containing an 'enum' constraint with the requested
+ * number of unique string values.
+ */
+std::string makeLargeEnumSchema(size_t numValues)
+{
+    std::string schema = "{\"enum\": [";
+    for (size_t i = 0; i < numValues; i++) {
+        if (i > 0) {
+            schema += ",";
+        }
+        schema += "\"enum_value_" + std::to_string(i) + "\"";
+    }
+    schema += "]}";
+
+    return schema;
+}
+
+/**
+ * Build an object document with the requested number of string properties,
+ * suitable for validation against the schema produced by
+ * makeWidePropertiesSchema.
+ */
+std::string makeWideObjectDocument(size_t numProperties)
+{
+    std::string document = "{";
+    for (size_t i = 0; i < numProperties; i++) {
+        if (i > 0) {
+            document += ",";
+        }
+        document += "\"property_" + std::to_string(i) + "\": \"value\"";
+    }
+    document += "}";
+
+    return document;
+}
+
+/**
+ * Parse a JSON string into a rapidjson document
+ */
+bool parseDocument(const std::string &json, rapidjson::Document &document)
+{
+    document.Parse(json.c_str());
+    return !document.HasParseError();
+}
+
+/**
+ * Parse a JSON string into an nlohmann::json document
+ */
+bool parseDocument(const std::string &json, nlohmann::json &document)
+{
+    document = nlohmann::json::parse(json, nullptr, false);
+    return !document.is_discarded();
+}
+
+/**
+ * Parse a JSON string into a picojson document
+ */
+bool parseDocument(const std::string &json, picojson::value &document)
+{
+    return picojson::parse(document, json).empty();
+}
+
+/**
+ * Helper that parses a schema and repeatedly validates a document against it,
+ * using the requested Adapter type.
+ */
+template<typename AdapterType>
+void validateLoop(benchmark::State &state, const std::string &schemaJson, const std::string &documentJson)
+{
+    typedef valijson::adapters::AdapterTraits<AdapterType> AdapterTraits;
+
+    typename AdapterTraits::DocumentType schemaDocument;
+    typename AdapterTraits::DocumentType targetDocument;
+    if (!parseDocument(schemaJson, schemaDocument) || !parseDocument(documentJson, targetDocument)) {
+        state.SkipWithError("Failed to parse benchmark fixture");
+        return;
+    }
+
+    Schema schema;
+    SchemaParser parser;
+    parser.populateSchema(AdapterType(schemaDocument), schema);
+
+    Validator validator;
+    const AdapterType targetAdapter(targetDocument);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(validator.validate(schema, targetAdapter, nullptr));
+    }
+}
+
+template<typename AdapterType>
+void benchmarkDeepAllOf(benchmark::State &state)
+{
+    validateLoop<AdapterType>(state, makeDeepAllOfSchema(state.range(0)), "{}");
+}
+
+template<typename AdapterType>
+void benchmarkWideProperties(benchmark::State &state)
+{
+    validateLoop<AdapterType>(state,
+            makeWidePropertiesSchema(state.range(0)),
+            makeWideObjectDocument(state.range(0)));
+}
+
+template<typename AdapterType>
+void benchmarkLargeEnum(benchmark::State &state)
+{
+    const size_t numValues = state.range(0);
+    validateLoop<AdapterType>(state,
+            makeLargeEnumSchema(numValues),
+            "\"enum_value_" + std::to_string(numValues - 1) + "\"");
+}
+
+/**
+ * Validate one of the array documents from the shared test corpus against
+ * the allOf schema that accompanies it in tests/data/schemas.
+ */
+template<typename AdapterType>
+void benchmarkCorpusDocument(benchmark::State &state, const std::string &documentName)
+{
+    typedef valijson::adapters::AdapterTraits<AdapterType> AdapterTraits;
+
+    typename AdapterTraits::DocumentType schemaDocument;
+    typename AdapterTraits::DocumentType targetDocument;
+    if (!valijson::utils::loadDocument(TEST_DATA_DIR "schemas/allof_integers_and_numbers.schema.json",
+                schemaDocument) ||
+            !valijson::utils::loadDocument(TEST_DATA_DIR "documents/" + documentName, targetDocument)) {
+        state.SkipWithError("Failed to load benchmark corpus; run from the build directory");
+        return;
+    }
+
+    Schema schema;
+    SchemaParser parser;
+    parser.populateSchema(AdapterType(schemaDocument), schema);
+
+    Validator validator;
+    const AdapterType targetAdapter(targetDocument);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(validator.validate(schema, targetAdapter, nullptr));
+    }
+}
+
+using valijson::adapters::NlohmannJsonAdapter;
+using valijson::adapters::PicoJsonAdapter;
+using valijson::adapters::RapidJsonAdapter;
+
+} // end anonymous namespace
+
+BENCHMARK_TEMPLATE(benchmarkDeepAllOf, RapidJsonAdapter)->Range(8, 512);
+BENCHMARK_TEMPLATE(benchmarkDeepAllOf, NlohmannJsonAdapter)->Range(8, 512);
+BENCHMARK_TEMPLATE(benchmarkDeepAllOf, PicoJsonAdapter)->Range(8, 512);
+
+BENCHMARK_TEMPLATE(benchmarkWideProperties, RapidJsonAdapter)->Range(8, 1024);
+BENCHMARK_TEMPLATE(benchmarkWideProperties, NlohmannJsonAdapter)->Range(8, 1024);
+BENCHMARK_TEMPLATE(benchmarkWideProperties, PicoJsonAdapter)->Range(8, 1024);
+
+BENCHMARK_TEMPLATE(benchmarkLargeEnum, RapidJsonAdapter)->Range(8, 2048);
+BENCHMARK_TEMPLATE(benchmarkLargeEnum, NlohmannJsonAdapter)->Range(8, 2048);
+BENCHMARK_TEMPLATE(benchmarkLargeEnum, PicoJsonAdapter)->Range(8, 2048);
+
+BENCHMARK_CAPTURE(benchmarkCorpusDocument<RapidJsonAdapter>, array_doubles, "array_doubles_10_20_30_40.json");
+BENCHMARK_CAPTURE(benchmarkCorpusDocument<NlohmannJsonAdapter>, array_doubles, "array_doubles_10_20_30_40.json");
+BENCHMARK_CAPTURE(benchmarkCorpusDocument<PicoJsonAdapter>, array_doubles, "array_doubles_10_20_30_40.json");
+
+BENCHMARK_MAIN();
@@ -31,7 +31,14 @@ usage() {
   echo
   echo 'Usage:'
   echo
-  echo '  ./bundle.sh <adapter-prefix>'
+  echo '  ./bundle.sh [options] <adapter-prefix>'
+  echo
+  echo 'Options:'
+  echo
+  echo '  --strip          remove comment-only and blank lines, so that each'
+  echo '                   translation unit has fewer bytes to lex'
+  echo '  --no-exceptions  pin VALIJSON_USE_EXCEPTIONS to 0 at the top of the'
+  echo '                   bundle, for builds compiled with -fno-exceptions'
   echo
   echo 'Example usage:'
   echo
@@ -46,6 +53,28 @@ usage() {
   exit 64
 }
 
+strip_comments=0
+no_exceptions=0
+
+while [ $# -gt 0 ]; do
+  case "$1" in
+    --strip)
+      strip_comments=1
+      shift
+      ;;
+    --no-exceptions)
+      no_exceptions=1
+      shift
+      ;;
+    --*)
+      usage
+      ;;
+    *)
+      break
+      ;;
+  esac
+done
+
 if [ $# -ne 1 ]; then
   usage
 fi
@@ -63,18 +92,30 @@ if [ -z "${adapter_header}" ]; then
   exit 65
 fi
 
+# Only the core validation stack is bundled; opt-in extras such as the batch,
+# NDJSON and SAX validators are left out so that a bundle carries no more code
+# than the chosen adapter needs. The headers are listed in dependency order,
+# since the bundled output cannot rely on nested #includes.
 common_headers=(
   include/valijson/exceptions.hpp
   include/compat/optional.hpp
   include/valijson/internal/optional_bundled.hpp
-  include/valijson/internal/adapter.hpp
-  include/valijson/internal/basic_adapter.hpp
+  include/valijson/internal/string_view.hpp
   include/valijson/internal/custom_allocator.hpp
+  include/valijson/internal/small_vector.hpp
   include/valijson/internal/debug.hpp
+  include/valijson/internal/adapter.hpp
+  include/valijson/internal/json_hash.hpp
+  include/valijson/internal/numeric_parsing.hpp
+  include/valijson/internal/string_intern_pool.hpp
   include/valijson/internal/frozen_value.hpp
+  include/valijson/internal/basic_adapter.hpp
+  include/valijson/internal/compact_frozen_value.hpp
+  include/valijson/internal/frozen_value_pool.hpp
   include/valijson/internal/json_pointer.hpp
   include/valijson/internal/json_reference.hpp
   include/valijson/internal/uri.hpp
+  include/valijson/internal/validation_context.hpp
   include/valijson/utils/file_utils.hpp
   include/valijson/utils/utf8_utils.hpp
   include/valijson/constraints/constraint.hpp
@@ -82,24 +123,76 @@ common_headers=(
   include/valijson/schema.hpp
   include/valijson/constraints/constraint_visitor.hpp
   include/valijson/constraints/basic_constraint.hpp
+  include/valijson/adapters/std_string_adapter.hpp
+  include/valijson/adapters/scalar_value_adapter.hpp
+  include/valijson/regex_cache.hpp
+  include/valijson/format_checkers.hpp
   include/valijson/constraints/concrete_constraints.hpp
   include/valijson/constraint_builder.hpp
+  include/valijson/internal/flat_hash_map.hpp
+  include/valijson/document_cache.hpp
+  include/valijson/parallel_executor.hpp
   include/valijson/schema_parser.hpp
-  include/valijson/adapters/std_string_adapter.hpp
   include/valijson/validation_results.hpp
+  include/valijson/scratch_arena.hpp
+  include/valijson/validation_instrumentation.hpp
+  include/valijson/cancellation.hpp
+  include/valijson/validation_budget.hpp
+  include/valijson/validation_cache.hpp
   include/valijson/validation_visitor.hpp
+  include/valijson/schema_statistics.hpp
   include/valijson/validator.hpp)
 
-# remove internal #includes
-grep --no-filename -v "include <valijson/" ${common_headers[@]}
+emit() {
+  # remove internal #includes; the bundle is ordered so they are unnecessary
+  if [ "${strip_comments}" -eq 1 ]; then
+    # drop whole-line comments (line comments, and block comments that open
+    # at the start of a line) and blank lines; trailing comments are kept,
+    # since removing them by pattern could corrupt string literals that
+    # happen to contain '//'
+    grep --no-filename -v "include <valijson/" "$@" \
+      | awk '
+        in_block {
+          end = index($0, "*/")
+          if (end) {
+            in_block = 0
+            rest = substr($0, end + 2)
+            if (rest !~ /^[[:space:]]*$/) print rest
+          }
+          next
+        }
+        /^[[:space:]]*\/\*/ {
+          end = index($0, "*/")
+          if (end) {
+            rest = substr($0, end + 2)
+            if (rest !~ /^[[:space:]]*$/) print rest
+          } else {
+            in_block = 1
+          }
+          next
+        }
+        /^[[:space:]]*\/\// { next }
+        /^[[:space:]]*$/ { next }
+        { print }'
+  else
+    grep --no-filename -v "include <valijson/" "$@"
+  fi
+}
+
+if [ "${no_exceptions}" -eq 1 ]; then
+  # pinned before exceptions.hpp is seen, so every guarded path compiles out
+  echo '#define VALIJSON_USE_EXCEPTIONS 0'
+fi
+
+emit "${common_headers[@]}"
 
 # std_string_adapter is always included
 if [ "${adapter}" != "std_string" ]; then
-  grep --no-filename -v "include <valijson/" "${adapter_header}"
+  emit "${adapter_header}"
 fi
 
 # include file utils if available
 utils_header="${utils_path}/${adapter}_utils.hpp"
 if [ -f "${utils_header}" ]; then
-  grep --no-filename -v "include <valijson/" "${utils_header}"
+  emit "${utils_header}"
 fi
@@ -10,6 +10,7 @@
 #include <stdexcept>
 
 #include <curlpp/cURLpp.hpp>
+#include <curlpp/Easy.hpp>
 #include <curlpp/Options.hpp>
 
 #include <valijson/adapters/rapidjson_adapter.hpp>
@@ -32,9 +33,18 @@ using valijson::adapters::RapidJsonAdapter;
 const rapidjson::Document * fetchDocument(const std::string &uri)
 {
     cout << "Fetching " << uri << "..." << endl;
-    curlpp::Cleanup myCleanup;
+
+    // The handle is reused across fetches, so that libcurl can keep
+    // connections and TLS sessions to repeatedly-referenced hosts alive
+    // instead of reconnecting for every document
+    static curlpp::Cleanup myCleanup;
+    static curlpp::Easy request;
+
     std::ostringstream os;
-    os << curlpp::options::Url(uri);
+    request.setOpt(curlpp::options::Url(uri));
+    request.setOpt(curlpp::options::WriteStream(&os));
+    request.perform();
+
     rapidjson::Document *fetchedRoot = new rapidjson::Document();
     fetchedRoot->template Parse<0>(os.str().c_str());
     return fetchedRoot;
@@ -25,6 +25,7 @@
 
 #pragma once
 
+#include <limits>
 #include <string>
 
 #include <boost/json.hpp>
@@ -350,6 +351,25 @@ public:
             result = m_value.get_int64();
             return true;
         }
+        if (m_value.is_uint64()) {
+            // Unsigned values above the int64_t range are retrievable
+            // through getUnsignedInteger() instead
+            const std::uint64_t u = m_value.get_uint64();
+            if (u <= static_cast<std::uint64_t>(
+                    std::numeric_limits<int64_t>::max())) {
+                result = static_cast<int64_t>(u);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool getUnsignedInteger(uint64_t &result) const
+    {
+        if (m_value.is_uint64()) {
+            result = m_value.get_uint64();
+            return true;
+        }
         return false;
     }
 
@@ -430,7 +450,7 @@ public:
 
     bool isInteger() const
     {
-        return m_value.is_int64();
+        return m_value.is_int64() || m_value.is_uint64();
     }
 
     bool isNull() const
@@ -399,6 +399,15 @@ public:
         return false;
     }
 
+    /// Every container access in json11 goes through a virtual call on the
+    /// shared JsonValue, so BasicAdapter memoizes container sizes rather
+    /// than repeating that indirection for every probe made while
+    /// validating a value
+    static bool hasCheapContainerSize()
+    {
+        return false;
+    }
+
     static bool hasStrictTypes()
     {
         return true;
@@ -340,7 +340,22 @@ public:
     bool getInteger(int64_t &result) const
     {
         if (m_value.isIntegral()) {
-            result = static_cast<int64_t>(m_value.asInt());
+            if (!m_value.isInt64()) {
+                // Unsigned values above the int64_t range are retrievable
+                // through getUnsignedInteger() instead
+                return false;
+            }
+            result = static_cast<int64_t>(m_value.asInt64());
+            return true;
+        }
+
+        return false;
+    }
+
+    bool getUnsignedInteger(uint64_t &result) const
+    {
+        if (m_value.isIntegral() && m_value.isUInt64()) {
+            result = static_cast<uint64_t>(m_value.asUInt64());
             return true;
         }
 
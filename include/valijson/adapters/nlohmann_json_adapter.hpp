@@ -25,11 +25,13 @@
 
 #pragma once
 
+#include <limits>
 #include <string>
 #include <nlohmann/json.hpp>
 
 #include <valijson/internal/adapter.hpp>
 #include <valijson/internal/basic_adapter.hpp>
+#include <valijson/internal/compact_frozen_value.hpp>
 #include <valijson/internal/frozen_value.hpp>
 #include <valijson/exceptions.hpp>
 #include <utility>
@@ -39,7 +41,29 @@ namespace adapters {
 
 class NlohmannJsonAdapter;
 
-typedef std::pair<std::string, NlohmannJsonAdapter> NlohmannJsonObjectMember;
+/**
+ * @brief   Object member exposed while iterating over an object's members.
+ *
+ * The member name refers directly to the key storage inside the source
+ * document, so iterating over an object does not copy member names. The
+ * source document must outlive the member, which is already required for
+ * the value adapter the member contains.
+ */
+template <class ValueType>
+struct NlohmannJsonGenericObjectMember
+{
+    NlohmannJsonGenericObjectMember(const std::string &name, const nlohmann::json &value)
+      : first(name),
+        second(value) { }
+
+    /// Name of the object member, referencing the source document
+    const std::string &first;
+
+    /// Adapter for the member's value
+    ValueType second;
+};
+
+typedef NlohmannJsonGenericObjectMember<NlohmannJsonAdapter> NlohmannJsonObjectMember;
 
 /**
  * @brief   Class for iterating over values held in a JSON array.
@@ -409,6 +433,10 @@ private:
  * document. NlohmannJson makes this easy to do, as it does not perform any
  * custom memory management.
  *
+ * Note that NlohmannJsonValue::freeze() only falls back to this class for
+ * values that cannot be packed into the compact frozen-value encoding, such
+ * as binary values.
+ *
  * @see FrozenValue
  */
 class NlohmannJsonFrozenValue: public FrozenValue
@@ -465,14 +493,23 @@ public:
       : m_value(value) { }
 
     /**
-     * @brief   Create a new NlohmannJsonFrozenValue instance that contains the
-     *          value referenced by this NlohmannJsonValue instance.
+     * @brief   Create a new FrozenValue instance that contains the value
+     *          referenced by this NlohmannJsonValue instance.
      *
-     * @returns pointer to a new NlohmannJsonFrozenValue instance, belonging to the
+     * Since NlohmannJson preserves strict JSON types, nearly every value can
+     * be packed into the compact flat encoding rather than cloned as a
+     * subtree of NlohmannJson nodes; the fallback covers values that have no
+     * definite JSON type, such as binary values.
+     *
+     * @returns pointer to a new FrozenValue instance, belonging to the
      *          caller.
      */
     FrozenValue * freeze() const
     {
+        if (FrozenValue *compact = freezeCompactValue(ValueType(m_value))) {
+            return compact;
+        }
+
         return new NlohmannJsonFrozenValue(m_value);
     }
 
@@ -537,6 +574,17 @@ public:
 
     bool getInteger(int64_t &result) const
     {
+        if (m_value.is_number_unsigned()) {
+            // Unsigned values above the int64_t range are retrievable
+            // through getUnsignedInteger() instead of being wrapped to a
+            // negative value here
+            const uint64_t u = m_value.get<uint64_t>();
+            if (u > static_cast<uint64_t>(std::numeric_limits<int64_t>::max())) {
+                return false;
+            }
+            result = static_cast<int64_t>(u);
+            return true;
+        }
         if(m_value.is_number_integer()) {
             result = m_value.get<int64_t>();
             return true;
@@ -544,6 +592,15 @@ public:
         return false;
     }
 
+    bool getUnsignedInteger(uint64_t &result) const
+    {
+        if (m_value.is_number_unsigned()) {
+            result = m_value.get<uint64_t>();
+            return true;
+        }
+        return false;
+    }
+
     /**
      * @brief   Optionally return a NlohmannJsonObject instance.
      *
@@ -579,7 +636,18 @@ public:
     bool getString(std::string &result) const
     {
         if (m_value.is_string()) {
-            result = m_value.get<std::string>();
+            result = m_value.template get_ref<const std::string &>();
+            return true;
+        }
+
+        return false;
+    }
+
+    /// Strings can be viewed in place via a reference to the stored value
+    bool getStringView(internal::string_view &result) const
+    {
+        if (m_value.is_string()) {
+            result = internal::string_view(m_value.template get_ref<const std::string &>());
             return true;
         }
 
@@ -411,6 +411,17 @@ public:
         return false;
     }
 
+    /// Strings can be viewed in place via a reference to the stored value
+    bool getStringView(internal::string_view &result) const
+    {
+        if (m_value.is<std::string>()) {
+            result = internal::string_view(m_value.get<std::string>());
+            return true;
+        }
+
+        return false;
+    }
+
     static bool hasStrictTypes()
     {
         return true;
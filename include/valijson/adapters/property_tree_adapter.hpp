@@ -420,6 +420,15 @@ public:
         return false;
     }
 
+    /// Property trees store children in a node-based sequence, so container
+    /// size queries are not constant time; BasicAdapter memoizes the sizes
+    /// so that the many probes made while validating a value walk the
+    /// children at most once
+    static bool hasCheapContainerSize()
+    {
+        return false;
+    }
+
     static bool hasStrictTypes()
     {
         return false;
@@ -40,6 +40,8 @@
 
 #pragma once
 
+#include <cstdint>
+#include <limits>
 #include <string>
 #include <iterator>
 
@@ -483,8 +485,18 @@ public:
         } else if (m_value.IsUint()) {
             result = static_cast<int64_t>(m_value.GetUint());
             return true;
-        } else if (m_value.IsUint64()) {
-            result = static_cast<int64_t>(m_value.GetUint64());
+        }
+
+        // A value that is unsigned but not Int64 lies above the int64_t
+        // range; it is retrievable through getUnsignedInteger() instead of
+        // being wrapped to a negative value here
+        return false;
+    }
+
+    bool getUnsignedInteger(uint64_t &result) const
+    {
+        if (m_value.IsUint64()) {
+            result = m_value.GetUint64();
             return true;
         }
 
@@ -540,6 +552,79 @@ public:
         return false;
     }
 
+    /**
+     * @brief   Sweep a numeric array in place, returning its size and bounds
+     *
+     * RapidJson stores the elements of an array contiguously, so an array
+     * of numbers can be reduced to its smallest and largest values with one
+     * linear pass over the underlying storage, without constructing an
+     * adapter per element. Elements whose conversion to double would lose
+     * precision - integers beyond 2^53 in magnitude, or NaN doubles - cause
+     * the sweep to report failure, so that the caller falls back to exact
+     * per-element validation.
+     *
+     * @param   size      receives the number of elements in the array
+     * @param   minValue  receives the smallest element value
+     * @param   maxValue  receives the largest element value
+     *
+     * @returns true if the bounds were computed; false when the value is
+     *          not an array or an element cannot be summarised as a double
+     */
+    bool getNumericArrayBounds(size_t &size, double &minValue,
+            double &maxValue) const
+    {
+        if (!m_value.IsArray()) {
+            return false;
+        }
+
+        // Largest magnitude at which every integer is exactly representable
+        // as a double
+        static const int64_t kExactLimit = int64_t(1) << 53;
+
+        double lowest = std::numeric_limits<double>::infinity();
+        double highest = -std::numeric_limits<double>::infinity();
+        for (typename ValueType::ConstValueIterator itr = m_value.Begin();
+                itr != m_value.End(); ++itr) {
+            if (!itr->IsNumber()) {
+                return false;
+            }
+
+            if (!itr->IsDouble()) {
+                if (itr->IsUint64() && itr->GetUint64() > uint64_t(kExactLimit)) {
+                    return false;
+                } else if (itr->IsInt64() && (itr->GetInt64() > kExactLimit ||
+                        itr->GetInt64() < -kExactLimit)) {
+                    return false;
+                }
+            }
+
+            const double value = itr->GetDouble();
+            if (value != value) {
+                // NaN compares false against any bound
+                return false;
+            }
+
+            lowest = value < lowest ? value : lowest;
+            highest = value > highest ? value : highest;
+        }
+
+        size = m_value.Size();
+        minValue = lowest;
+        maxValue = highest;
+        return true;
+    }
+
+    /// RapidJson string storage is stable, so strings can be viewed in place
+    bool getStringView(internal::string_view &result) const
+    {
+        if (m_value.IsString()) {
+            result = internal::string_view(m_value.GetString(), m_value.GetStringLength());
+            return true;
+        }
+
+        return false;
+    }
+
     static bool hasStrictTypes()
     {
         return true;
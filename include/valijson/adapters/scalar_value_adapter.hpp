@@ -0,0 +1,709 @@
+/**
+ * @file
+ *
+ * @brief   Adapter implementation that wraps a single scalar JSON value
+ *
+ * This allows individual scalar values produced by a SAX-style parser to be
+ * validated against a schema, without materializing a document tree. It is
+ * used by the streaming SaxValidator, which routes each scalar parse event
+ * through the regular ValidationVisitor using this adapter.
+ */
+
+#pragma once
+
+#include <cmath>
+#include <limits>
+#include <string>
+
+#include <valijson/internal/adapter.hpp>
+#include <valijson/internal/frozen_value.hpp>
+#include <valijson/internal/json_hash.hpp>
+#include <valijson/internal/basic_adapter.hpp>
+#include <valijson/exceptions.hpp>
+
+namespace valijson {
+namespace adapters {
+
+class ScalarValueAdapter;
+class ScalarValueArrayValueIterator;
+class ScalarValueObjectMemberIterator;
+
+typedef std::pair<std::string, ScalarValueAdapter> ScalarValueObjectMember;
+
+/**
+ * @brief  Tagged union describing a single scalar JSON value
+ *
+ * Instances of this struct are typically populated from SAX parse events,
+ * then wrapped in a ScalarValueAdapter for validation.
+ */
+struct ScalarValue
+{
+    enum Type
+    {
+        kNull,
+        kBool,
+        kInteger,
+        kDouble,
+        kString
+    };
+
+    static ScalarValue makeNull()
+    {
+        return ScalarValue(kNull);
+    }
+
+    static ScalarValue makeBool(bool value)
+    {
+        ScalarValue result(kBool);
+        result.boolValue = value;
+        return result;
+    }
+
+    static ScalarValue makeInteger(int64_t value)
+    {
+        ScalarValue result(kInteger);
+        result.integerValue = value;
+        return result;
+    }
+
+    static ScalarValue makeDouble(double value)
+    {
+        ScalarValue result(kDouble);
+        result.doubleValue = value;
+        return result;
+    }
+
+    static ScalarValue makeString(const char *value, size_t length)
+    {
+        ScalarValue result(kString);
+        result.stringValue.assign(value, length);
+        return result;
+    }
+
+    Type type;
+    bool boolValue;
+    int64_t integerValue;
+    double doubleValue;
+    std::string stringValue;
+
+private:
+    explicit ScalarValue(Type t)
+      : type(t),
+        boolValue(false),
+        integerValue(0),
+        doubleValue(0) { }
+};
+
+class ScalarValueArray
+{
+public:
+    typedef ScalarValueArrayValueIterator const_iterator;
+    typedef ScalarValueArrayValueIterator iterator;
+
+    ScalarValueArray() = default;
+
+    ScalarValueArrayValueIterator begin() const;
+
+    ScalarValueArrayValueIterator end() const;
+
+    static size_t size()
+    {
+        return 0;
+    }
+};
+
+class ScalarValueObject
+{
+public:
+    typedef ScalarValueObjectMemberIterator const_iterator;
+    typedef ScalarValueObjectMemberIterator iterator;
+
+    ScalarValueObject() = default;
+
+    ScalarValueObjectMemberIterator begin() const;
+
+    ScalarValueObjectMemberIterator end() const;
+
+    ScalarValueObjectMemberIterator find(const std::string &propertyName) const;
+
+    static size_t size()
+    {
+        return 0;
+    }
+};
+
+class ScalarValueFrozenValue: public FrozenValue
+{
+public:
+    explicit ScalarValueFrozenValue(ScalarValue source)
+      : value(std::move(source)) { }
+
+    FrozenValue * clone() const override
+    {
+        return new ScalarValueFrozenValue(value);
+    }
+
+    bool equalTo(const Adapter &other, bool strict) const override;
+
+    /**
+     * @brief  Return the scalar value held by this frozen value
+     *
+     * Unlike adapter-specific frozen values, the contents of a frozen scalar
+     * can be inspected, which allows it to be serialized.
+     */
+    const ScalarValue & getValue() const
+    {
+        return value;
+    }
+
+private:
+    ScalarValue value;
+};
+
+class ScalarValueAdapter: public Adapter
+{
+public:
+    typedef ScalarValueArray Array;
+    typedef ScalarValueObject Object;
+    typedef ScalarValueObjectMember ObjectMember;
+
+    explicit ScalarValueAdapter(const ScalarValue &value)
+      : m_value(value) { }
+
+    bool applyToArray(ArrayValueCallback) const override
+    {
+        return maybeArray();
+    }
+
+    bool applyToObject(ObjectMemberCallback) const override
+    {
+        return maybeObject();
+    }
+
+    VALIJSON_NORETURN ScalarValueArray asArray() const
+    {
+        throwRuntimeError("Scalar value cannot be cast to array");
+    }
+
+    bool asBool() const override
+    {
+        bool result = false;
+        if (!asBool(result)) {
+            throwRuntimeError("Scalar value cannot be cast to bool");
+        }
+
+        return result;
+    }
+
+    bool asBool(bool &result) const override
+    {
+        if (m_value.type == ScalarValue::kBool) {
+            result = m_value.boolValue;
+            return true;
+        }
+
+        return false;
+    }
+
+    double asDouble() const override
+    {
+        double result = 0;
+        if (!asDouble(result)) {
+            throwRuntimeError("Scalar value cannot be cast to double");
+        }
+
+        return result;
+    }
+
+    bool asDouble(double &result) const override
+    {
+        if (m_value.type == ScalarValue::kDouble) {
+            result = m_value.doubleValue;
+            return true;
+        } else if (m_value.type == ScalarValue::kInteger) {
+            result = static_cast<double>(m_value.integerValue);
+            return true;
+        }
+
+        return false;
+    }
+
+    int64_t asInteger() const override
+    {
+        int64_t result = 0;
+        if (!asInteger(result)) {
+            throwRuntimeError("Scalar value cannot be cast to integer");
+        }
+
+        return result;
+    }
+
+    bool asInteger(int64_t &result) const override
+    {
+        if (m_value.type == ScalarValue::kInteger) {
+            result = m_value.integerValue;
+            return true;
+        } else if (m_value.type == ScalarValue::kDouble &&
+                isIntegralDouble(m_value.doubleValue)) {
+            result = static_cast<int64_t>(m_value.doubleValue);
+            return true;
+        }
+
+        return false;
+    }
+
+    bool getUnsignedInteger(uint64_t &result) const override
+    {
+        int64_t signedResult;
+        if (asInteger(signedResult) && signedResult >= 0) {
+            result = static_cast<uint64_t>(signedResult);
+            return true;
+        }
+
+        return false;
+    }
+
+    VALIJSON_NORETURN ScalarValueObject asObject() const
+    {
+        throwRuntimeError("Scalar value cannot be cast to object");
+    }
+
+    std::string asString() const override
+    {
+        std::string result;
+        if (!asString(result)) {
+            throwRuntimeError("Scalar value cannot be cast to string");
+        }
+
+        return result;
+    }
+
+    bool asString(std::string &result) const override
+    {
+        if (m_value.type == ScalarValue::kString) {
+            result = m_value.stringValue;
+            return true;
+        }
+
+        return false;
+    }
+
+    bool equalTo(const Adapter &other, bool strict) const override
+    {
+        switch (m_value.type) {
+        case ScalarValue::kNull:
+            return other.isNull() || (!strict && other.maybeNull());
+
+        case ScalarValue::kBool: {
+            if (strict && !other.isBool()) {
+                return false;
+            }
+            bool b = false;
+            return other.asBool(b) && b == m_value.boolValue;
+        }
+
+        case ScalarValue::kInteger:
+        case ScalarValue::kDouble: {
+            if (strict && !other.isNumber()) {
+                return false;
+            }
+            double d = 0;
+            return other.asDouble(d) && d == getNumber();
+        }
+
+        case ScalarValue::kString: {
+            if (strict && !other.isString()) {
+                return false;
+            }
+            std::string s;
+            return other.asString(s) && s == m_value.stringValue;
+        }
+        }
+
+        return false;
+    }
+
+    FrozenValue* freeze() const override
+    {
+        return new ScalarValueFrozenValue(m_value);
+    }
+
+    VALIJSON_NORETURN static ScalarValueArray getArray()
+    {
+        throwNotSupported();
+    }
+
+    VALIJSON_NORETURN size_t getArraySize() const override
+    {
+        throwNotSupported();
+    }
+
+    VALIJSON_NORETURN bool getArraySize(size_t &) const override
+    {
+        throwNotSupported();
+    }
+
+    bool getBool() const override
+    {
+        return asBool();
+    }
+
+    bool getBool(bool &result) const override
+    {
+        return asBool(result);
+    }
+
+    double getDouble() const override
+    {
+        return asDouble();
+    }
+
+    bool getDouble(double &result) const override
+    {
+        if (m_value.type == ScalarValue::kDouble) {
+            result = m_value.doubleValue;
+            return true;
+        }
+
+        return false;
+    }
+
+    int64_t getInteger() const override
+    {
+        return asInteger();
+    }
+
+    bool getInteger(int64_t &result) const override
+    {
+        if (m_value.type == ScalarValue::kInteger) {
+            result = m_value.integerValue;
+            return true;
+        }
+
+        return false;
+    }
+
+    double getNumber() const override
+    {
+        return asDouble();
+    }
+
+    bool getNumber(double &result) const override
+    {
+        return asDouble(result);
+    }
+
+    VALIJSON_NORETURN size_t getObjectSize() const override
+    {
+        throwNotSupported();
+    }
+
+    VALIJSON_NORETURN bool getObjectSize(size_t &) const override
+    {
+        throwNotSupported();
+    }
+
+    std::string getString() const override
+    {
+        return asString();
+    }
+
+    bool getString(std::string &result) const override
+    {
+        return asString(result);
+    }
+
+    bool getStringView(internal::string_view &result, std::string &) const override
+    {
+        if (m_value.type == ScalarValue::kString) {
+            result = internal::string_view(m_value.stringValue);
+            return true;
+        }
+
+        return false;
+    }
+
+    /// A scalar is never an array, so a numeric bounds sweep never applies
+    bool getNumericArrayBounds(size_t &, double &, double &) const
+    {
+        return false;
+    }
+
+    size_t hash() const override
+    {
+        return internal::hashJsonValue(*this);
+    }
+
+    bool hasStrictTypes() const override
+    {
+        return true;
+    }
+
+    bool isArray() const override
+    {
+        return false;
+    }
+
+    bool isBool() const override
+    {
+        return m_value.type == ScalarValue::kBool;
+    }
+
+    bool isDouble() const override
+    {
+        return m_value.type == ScalarValue::kDouble;
+    }
+
+    bool isInteger() const override
+    {
+        return m_value.type == ScalarValue::kInteger;
+    }
+
+    bool isNull() const override
+    {
+        return m_value.type == ScalarValue::kNull;
+    }
+
+    bool isNumber() const override
+    {
+        return m_value.type == ScalarValue::kInteger ||
+                m_value.type == ScalarValue::kDouble;
+    }
+
+    bool isObject() const override
+    {
+        return false;
+    }
+
+    bool isString() const override
+    {
+        return m_value.type == ScalarValue::kString;
+    }
+
+    bool maybeArray() const override
+    {
+        return false;
+    }
+
+    bool maybeBool() const override
+    {
+        return isBool();
+    }
+
+    bool maybeDouble() const override
+    {
+        return isNumber();
+    }
+
+    bool maybeInteger() const override
+    {
+        return isInteger() || (m_value.type == ScalarValue::kDouble &&
+                isIntegralDouble(m_value.doubleValue));
+    }
+
+    bool maybeNull() const override
+    {
+        return isNull();
+    }
+
+    bool maybeObject() const override
+    {
+        return false;
+    }
+
+    bool maybeString() const override
+    {
+        return isString();
+    }
+
+private:
+    static bool isIntegralDouble(double value)
+    {
+        return std::floor(value) == value &&
+                value >= static_cast<double>(std::numeric_limits<int64_t>::min()) &&
+                value <= static_cast<double>(std::numeric_limits<int64_t>::max());
+    }
+
+    const ScalarValue &m_value;
+};
+
+class ScalarValueArrayValueIterator
+{
+public:
+    using iterator_category = std::bidirectional_iterator_tag;
+    using value_type = ScalarValueAdapter;
+    using difference_type = ScalarValueAdapter;
+    using pointer = ScalarValueAdapter*;
+    using reference = ScalarValueAdapter&;
+
+    VALIJSON_NORETURN ScalarValueAdapter operator*() const
+    {
+        throwNotSupported();
+    }
+
+    VALIJSON_NORETURN DerefProxy<ScalarValueAdapter> operator->() const
+    {
+        throwNotSupported();
+    }
+
+    bool operator==(const ScalarValueArrayValueIterator &) const
+    {
+        return true;
+    }
+
+    bool operator!=(const ScalarValueArrayValueIterator &) const
+    {
+        return false;
+    }
+
+    VALIJSON_NORETURN const ScalarValueArrayValueIterator& operator++()
+    {
+        throwNotSupported();
+    }
+
+    VALIJSON_NORETURN ScalarValueArrayValueIterator operator++(int)
+    {
+        throwNotSupported();
+    }
+
+    VALIJSON_NORETURN const ScalarValueArrayValueIterator& operator--()
+    {
+        throwNotSupported();
+    }
+
+    VALIJSON_NORETURN void advance(std::ptrdiff_t)
+    {
+        throwNotSupported();
+    }
+};
+
+inline ScalarValueArrayValueIterator ScalarValueArray::begin() const
+{
+    return {};
+}
+
+inline ScalarValueArrayValueIterator ScalarValueArray::end() const
+{
+    return {};
+}
+
+class ScalarValueObjectMemberIterator
+{
+public:
+    using iterator_category = std::bidirectional_iterator_tag;
+    using value_type = ScalarValueObjectMember;
+    using difference_type = ScalarValueObjectMember;
+    using pointer = ScalarValueObjectMember*;
+    using reference = ScalarValueObjectMember&;
+
+    VALIJSON_NORETURN ScalarValueObjectMember operator*() const
+    {
+        throwNotSupported();
+    }
+
+    VALIJSON_NORETURN DerefProxy<ScalarValueObjectMember> operator->() const
+    {
+        throwNotSupported();
+    }
+
+    bool operator==(const ScalarValueObjectMemberIterator &) const
+    {
+        return true;
+    }
+
+    bool operator!=(const ScalarValueObjectMemberIterator &) const
+    {
+        return false;
+    }
+
+    VALIJSON_NORETURN const ScalarValueObjectMemberIterator& operator++()
+    {
+        throwNotSupported();
+    }
+
+    VALIJSON_NORETURN ScalarValueObjectMemberIterator operator++(int)
+    {
+        throwNotSupported();
+    }
+
+    VALIJSON_NORETURN const ScalarValueObjectMemberIterator& operator--()
+    {
+        throwNotSupported();
+    }
+};
+
+inline ScalarValueObjectMemberIterator ScalarValueObject::begin() const
+{
+    return {};
+}
+
+inline ScalarValueObjectMemberIterator ScalarValueObject::end() const
+{
+    return {};
+}
+
+inline ScalarValueObjectMemberIterator ScalarValueObject::find(const std::string &) const
+{
+    return {};
+}
+
+template<>
+struct AdapterTraits<valijson::adapters::ScalarValueAdapter>
+{
+    typedef ScalarValue DocumentType;
+
+    static std::string adapterName()
+    {
+        return "ScalarValueAdapter";
+    }
+};
+
+inline bool ScalarValueFrozenValue::equalTo(const Adapter &other, bool strict) const
+{
+    return ScalarValueAdapter(value).equalTo(other, strict);
+}
+
+/**
+ * @brief   Freeze a scalar value in a canonical representation
+ *
+ * The returned frozen value is independent of the adapter that the source
+ * value was read through, which allows values frozen by different parsers to
+ * be treated uniformly, and allows the frozen value to be serialized.
+ *
+ * @param   value  adapter for the value to be frozen
+ *
+ * @returns pointer to a new ScalarValueFrozenValue, owned by the caller, or
+ *          nullptr if the value is an array or an object
+ */
+inline FrozenValue * freezeScalarValue(const Adapter &value)
+{
+    if (value.isNull()) {
+        return new ScalarValueFrozenValue(ScalarValue::makeNull());
+    }
+
+    bool boolValue = false;
+    if (value.isBool() && value.getBool(boolValue)) {
+        return new ScalarValueFrozenValue(ScalarValue::makeBool(boolValue));
+    }
+
+    int64_t integerValue = 0;
+    if (value.isInteger() && value.getInteger(integerValue)) {
+        return new ScalarValueFrozenValue(ScalarValue::makeInteger(integerValue));
+    }
+
+    double doubleValue = 0;
+    if (value.isNumber() && value.getNumber(doubleValue)) {
+        return new ScalarValueFrozenValue(ScalarValue::makeDouble(doubleValue));
+    }
+
+    std::string stringValue;
+    if (value.isString() && value.getString(stringValue)) {
+        return new ScalarValueFrozenValue(ScalarValue::makeString(
+                stringValue.data(), stringValue.size()));
+    }
+
+    return nullptr;
+}
+
+}  // namespace adapters
+}  // namespace valijson
@@ -1,7 +1,7 @@
 /**
  * @file
  *
- * @brief   Adapter implementation that wraps a single std::string value
+ * @brief   Adapter implementation that wraps a single string value
  *
  * This allows property names to be validated against a schema as though they are a generic JSON
  * value, while allowing the rest of Valijson's API to expose property names as plain std::string
@@ -10,6 +10,10 @@
  * This was added while implementing draft 7 support. This included support for a constraint
  * called propertyNames, which can be used to ensure that the property names in an object
  * validate against a subschema.
+ *
+ * The adapter is backed by a non-owning string view, so wrapping a property name never copies
+ * it; the viewed storage must outlive the adapter, which for property name validation is the
+ * lifetime of the object member being visited.
  */
 
 #pragma once
@@ -18,6 +22,8 @@
 
 #include <valijson/internal/adapter.hpp>
 #include <valijson/internal/frozen_value.hpp>
+#include <valijson/internal/json_hash.hpp>
+#include <valijson/internal/numeric_parsing.hpp>
 #include <valijson/internal/basic_adapter.hpp>
 #include <valijson/exceptions.hpp>
 
@@ -95,6 +101,9 @@ public:
     explicit StdStringAdapter(const std::string &value)
       : m_value(value) { }
 
+    explicit StdStringAdapter(const internal::string_view &value)
+      : m_value(value) { }
+
     bool applyToArray(ArrayValueCallback) const override
     {
         return maybeArray();
@@ -147,6 +156,12 @@ public:
         return true;
     }
 
+    bool getUnsignedInteger(uint64_t &result) const override
+    {
+        result = 0;
+        return true;
+    }
+
     StdStringObject asObject() const
     {
         if (maybeObject()) {
@@ -158,12 +173,12 @@ public:
 
     std::string asString() const override
     {
-        return m_value;
+        return m_value.to_string();
     }
 
     bool asString(std::string &result) const override
     {
-        result = m_value;
+        result = m_value.to_string();
         return true;
     }
 
@@ -173,12 +188,19 @@ public:
             return false;
         }
 
-        return m_value == other.asString();
+        internal::string_view otherView;
+        std::string scratch;
+        if (other.getStringView(otherView, scratch)) {
+            return m_value == otherView;
+        }
+
+        const std::string otherValue = other.asString();
+        return m_value == internal::string_view(otherValue);
     }
 
     FrozenValue* freeze() const override
     {
-        return new StdStringFrozenValue(m_value);
+        return new StdStringFrozenValue(m_value.to_string());
     }
 
     VALIJSON_NORETURN static StdStringArray getArray()
@@ -248,15 +270,32 @@ public:
 
     std::string getString() const override
     {
-        return m_value;
+        return m_value.to_string();
     }
 
     bool getString(std::string &result) const override
+    {
+        result = m_value.to_string();
+        return true;
+    }
+
+    bool getStringView(internal::string_view &result, std::string &) const override
     {
         result = m_value;
         return true;
     }
 
+    /// A string is never an array, so a numeric bounds sweep never applies
+    bool getNumericArrayBounds(size_t &, double &, double &) const
+    {
+        return false;
+    }
+
+    size_t hash() const override
+    {
+        return internal::hashJsonValue(*this);
+    }
+
     bool hasStrictTypes() const override
     {
         return true;
@@ -309,27 +348,20 @@ public:
 
     bool maybeBool() const override
     {
-        return m_value == "true" || m_value == "false";
+        return m_value == internal::string_view("true", 4) ||
+                m_value == internal::string_view("false", 5);
     }
 
     bool maybeDouble() const override
     {
-        const char *b = m_value.c_str();
-        char *e = nullptr;
-        strtod(b, &e);
-        return e != b && e == b + m_value.length();
+        double unused;
+        return internal::parseDouble(m_value.data(), m_value.size(), unused);
     }
 
     bool maybeInteger() const override
     {
-        std::istringstream i(m_value);
-        int64_t x;
-        char c;
-        if (!(i >> x) || i.get(c)) {
-            return false;
-        }
-
-        return true;
+        int64_t unused;
+        return internal::parseInteger(m_value.data(), m_value.size(), unused);
     }
 
     bool maybeNull() const override
@@ -348,7 +380,9 @@ public:
     }
 
 private:
-    const std::string &m_value;
+    /// Non-owning view of the wrapped string; the viewed storage must
+    /// outlive the adapter
+    internal::string_view m_value;
 };
 
 class StdStringArrayValueIterator
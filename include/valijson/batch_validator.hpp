@@ -0,0 +1,317 @@
+/**
+ * @file
+ *
+ * @brief   Parallel validation of document batches against a shared schema
+ *
+ * BatchValidatorT validates a range of documents against a single schema,
+ * spreading the work across a pool of threads. The schema is immutable during
+ * validation and all per-schema state, such as compiled regular expressions,
+ * is stored within the schema's constraints, so every worker shares the same
+ * warm caches instead of each thread compiling its own copies.
+ *
+ * Work distribution uses per-worker chunks of the batch with work stealing:
+ * each worker consumes indices from its own chunk through an atomic cursor,
+ * and when its chunk is exhausted it takes indices from the chunks of other
+ * workers. This keeps workers busy even when document validation costs are
+ * highly skewed, without a central queue that all threads contend on.
+ *
+ * Each worker owns a context holding a ScratchArena for the transient
+ * containers built while validating a document. The arena is rewound by a
+ * pointer bump between documents and kept across batches, so steady-state
+ * batch validation performs no global-allocator calls for that transient
+ * state; getPoolStats() reports arena sizes and growth so pools can be
+ * sized and the steady state verified.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <valijson/exceptions.hpp>
+#include <valijson/schema.hpp>
+#include <valijson/scratch_arena.hpp>
+#include <valijson/validation_results.hpp>
+#include <valijson/validator.hpp>
+
+namespace valijson {
+
+/**
+ * @brief   Validates batches of documents in parallel against one schema
+ *
+ * A BatchValidatorT owns per-worker scratch pools that are reused across
+ * batches, so a single instance must not be asked to validate two batches
+ * concurrently; use one instance per concurrent batch.
+ *
+ * @tparam  RegexEngine  regular expression engine used for pattern constraint
+ *                       validation
+ */
+template<typename RegexEngine>
+class BatchValidatorT
+{
+public:
+    typedef typename ValidatorT<RegexEngine>::TypeCheckingMode TypeCheckingMode;
+
+    /**
+     * @brief  Aggregate sizes and growth of the per-worker scratch pools
+     *
+     * The counters are cumulative over the validator's lifetime. Once the
+     * pools have warmed to the high-water mark of a workload,
+     * \c arenaBlockAllocations stops growing while \c documentsValidated
+     * continues to, which verifies that steady-state validation is not
+     * touching the global allocator for its transient state.
+     */
+    struct PoolStats
+    {
+        PoolStats()
+          : numWorkerPools(0),
+            arenaCapacity(0),
+            arenaBlockAllocations(0),
+            documentsValidated(0) { }
+
+        /// Number of per-worker pools allocated so far
+        size_t numWorkerPools;
+
+        /// Total bytes currently held across the worker arenas
+        size_t arenaCapacity;
+
+        /// Blocks requested from the global allocator across the worker
+        /// arenas, cumulative over the validator's lifetime
+        size_t arenaBlockAllocations;
+
+        /// Documents validated across all batches so far
+        size_t documentsValidated;
+    };
+
+    /**
+     * @brief  Construct a BatchValidator that uses strong type checking and
+     *         one worker per hardware thread
+     */
+    BatchValidatorT()
+      : m_validator(),
+        m_numThreads(defaultNumThreads()) { }
+
+    /**
+     * @brief  Construct a BatchValidator using a specific type checking mode
+     *         and worker count
+     *
+     * @param  typeCheckingMode  choice of strong or weak type checking
+     * @param  numThreads        number of worker threads to use, or 0 to use
+     *                           one worker per hardware thread
+     */
+    explicit BatchValidatorT(TypeCheckingMode typeCheckingMode,
+            size_t numThreads = 0)
+      : m_validator(typeCheckingMode),
+        m_numThreads(numThreads == 0 ? defaultNumThreads() : numThreads) { }
+
+    /**
+     * @brief  Validate a batch of documents and return per-document outcomes
+     *
+     * The documents are validated against the schema across the configured
+     * number of worker threads; the calling thread participates as one of the
+     * workers. The schema's regular expressions are compiled eagerly before
+     * validation begins, so that workers share compiled patterns rather than
+     * racing to compile them lazily.
+     *
+     * When a results vector is provided via the \c results parameter, it is
+     * resized to match the batch and element \c i receives the validation
+     * errors for document \c i; each document is then validated exhaustively,
+     * as with ValidatorT. Without a results vector, validation of each
+     * document stops at its first failing constraint.
+     *
+     * @param  schema     schema to validate against
+     * @param  documents  batch of adapter values to be validated
+     * @param  results    optional pointer to a vector that will receive
+     *                    per-document validation errors
+     *
+     * @returns  vector with one entry per document, true where the document
+     *           is valid
+     */
+    template<typename AdapterType>
+    std::vector<bool> validate(const Schema &schema,
+            const std::vector<AdapterType> &documents,
+            std::vector<ValidationResults> *results) const
+    {
+        precompilePatterns<RegexEngine>(schema);
+
+        if (results != nullptr) {
+            results->assign(documents.size(), ValidationResults());
+        }
+
+        // std::vector<bool> packs its elements, so neighbouring documents
+        // would race on the same byte; collect outcomes in plain chars first
+        std::vector<char> outcomes(documents.size(), 0);
+
+        const size_t numWorkers =
+                std::min(std::max<size_t>(m_numThreads, 1), std::max<size_t>(documents.size(), 1));
+
+        // Per-worker contexts persist across batches, so arenas warmed by
+        // one batch serve the next without growing again
+        while (m_workerContexts.size() < numWorkers) {
+            m_workerContexts.emplace_back(new WorkerContext());
+        }
+
+        // Split the batch into one contiguous chunk per worker; each chunk
+        // is consumed through an atomic cursor, by its owner or by thieves
+        std::vector<Chunk> chunks(numWorkers);
+        const size_t chunkSize = documents.size() / numWorkers;
+        const size_t remainder = documents.size() % numWorkers;
+        size_t begin = 0;
+        for (size_t i = 0; i < numWorkers; i++) {
+            const size_t end = begin + chunkSize + (i < remainder ? 1 : 0);
+            chunks[i].cursor.store(begin, std::memory_order_relaxed);
+            chunks[i].end = end;
+            begin = end;
+        }
+
+        std::atomic<bool> failed(false);
+        std::exception_ptr firstException = nullptr;
+        std::mutex exceptionMutex;
+
+        const auto worker = [&](size_t workerIndex) {
+#if VALIJSON_USE_EXCEPTIONS
+            try {
+#endif
+                runWorker(workerIndex, chunks, schema, documents,
+                        outcomes, results, failed);
+#if VALIJSON_USE_EXCEPTIONS
+            } catch (...) {
+                failed.store(true, std::memory_order_relaxed);
+                std::lock_guard<std::mutex> lock(exceptionMutex);
+                if (!firstException) {
+                    firstException = std::current_exception();
+                }
+            }
+#endif
+        };
+
+        std::vector<std::thread> threads;
+        threads.reserve(numWorkers - 1);
+        for (size_t i = 1; i < numWorkers; i++) {
+            threads.emplace_back(worker, i);
+        }
+
+        worker(0);
+
+        for (std::thread &thread : threads) {
+            thread.join();
+        }
+
+#if VALIJSON_USE_EXCEPTIONS
+        if (firstException) {
+            std::rethrow_exception(firstException);
+        }
+#endif
+
+        return std::vector<bool>(outcomes.begin(), outcomes.end());
+    }
+
+    /**
+     * @brief  Report the sizes and growth of the per-worker scratch pools
+     *
+     * Must not be called while a batch is being validated, since the
+     * workers update their pools without synchronisation.
+     *
+     * @returns  aggregate statistics across the worker pools
+     */
+    PoolStats getPoolStats() const
+    {
+        PoolStats stats;
+        stats.numWorkerPools = m_workerContexts.size();
+        for (const std::unique_ptr<WorkerContext> &context : m_workerContexts) {
+            stats.arenaCapacity += context->scratch.capacity();
+            stats.arenaBlockAllocations += context->scratch.blockAllocations();
+            stats.documentsValidated += context->documentsValidated;
+        }
+        return stats;
+    }
+
+private:
+    /// Pooled per-worker state, reused across documents and batches
+    struct WorkerContext
+    {
+        WorkerContext()
+          : documentsValidated(0) { }
+
+        /// Arena for transient validation state; rewound between documents
+        ScratchArena scratch;
+
+        /// Number of documents this worker has validated
+        size_t documentsValidated;
+    };
+
+    /// Range of document indices consumed through an atomic cursor
+    struct Chunk
+    {
+        Chunk()
+          : cursor(0),
+            end(0) { }
+
+        std::atomic<size_t> cursor;
+        size_t end;
+    };
+
+    template<typename AdapterType>
+    void runWorker(size_t workerIndex,
+            std::vector<Chunk> &chunks,
+            const Schema &schema,
+            const std::vector<AdapterType> &documents,
+            std::vector<char> &outcomes,
+            std::vector<ValidationResults> *results,
+            std::atomic<bool> &failed) const
+    {
+        const size_t numChunks = chunks.size();
+        WorkerContext &context = *m_workerContexts[workerIndex];
+
+        // Consume the worker's own chunk first, then steal from the other
+        // workers' chunks, starting with the nearest neighbour; the atomic
+        // cursor guarantees each index is claimed by exactly one worker
+        for (size_t offset = 0; offset < numChunks; offset++) {
+            Chunk &chunk = chunks[(workerIndex + offset) % numChunks];
+
+            while (true) {
+                if (failed.load(std::memory_order_relaxed)) {
+                    return;
+                }
+
+                const size_t index = chunk.cursor.fetch_add(1,
+                        std::memory_order_relaxed);
+                if (index >= chunk.end) {
+                    break;
+                }
+
+                ValidationResults *documentResults =
+                        results == nullptr ? nullptr : &(*results)[index];
+                outcomes[index] = m_validator.validate(*schema.root(),
+                        documents[index], documentResults,
+                        context.scratch) ? 1 : 0;
+                context.documentsValidated++;
+            }
+        }
+    }
+
+    static size_t defaultNumThreads()
+    {
+        const unsigned int numThreads = std::thread::hardware_concurrency();
+        return numThreads == 0 ? 1 : numThreads;
+    }
+
+    /// Validator shared by all workers; holds no mutable state
+    ValidatorT<RegexEngine> m_validator;
+
+    /// Number of workers used to process a batch
+    size_t m_numThreads;
+
+    /// Per-worker pooled state; entry i belongs exclusively to worker i
+    /// while a batch is running
+    mutable std::vector<std::unique_ptr<WorkerContext>> m_workerContexts;
+};
+
+using BatchValidator = BatchValidatorT<DefaultRegexEngine>;
+
+}  // namespace valijson
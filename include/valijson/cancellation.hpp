@@ -0,0 +1,174 @@
+/**
+ * @file
+ *
+ * @brief   Cooperative cancellation of in-flight validation
+ *
+ * Validation of a large, hostile document can occupy a thread for a long
+ * time, with no way to stop it short of killing the thread. The
+ * CancellationToken defined here provides a cooperative alternative: the
+ * validator polls the token at sub-schema boundaries and abandons the run
+ * once cancellation has been requested, either explicitly from another
+ * thread or implicitly by an expired deadline.
+ *
+ * Polling is cheap. The explicit flag is a single relaxed atomic load, and
+ * the validator only consults the clock for deadline checks once every few
+ * dozen sub-schema visits.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+
+namespace valijson {
+
+/**
+ * @brief  Token through which in-flight validation can be cancelled
+ *
+ * A token is handed to a validate call and polled by the validator as it
+ * walks the schema. Cancellation can be requested explicitly by calling
+ * cancel() from any thread, or by attaching a deadline with setDeadline()
+ * or setTimeout() before validation begins.
+ *
+ * A cancelled run reports failure, with the cancellation recorded in the
+ * ValidationResults object where one was provided, so that callers can
+ * distinguish a cancelled run from a document that failed validation.
+ *
+ * A token may be reused across sequential validation runs by calling
+ * reset() between them, and may be shared by concurrent runs that should
+ * be cancelled as a group.
+ */
+class CancellationToken
+{
+public:
+
+    /**
+     * @brief  Construct a token with no deadline and cancellation not
+     *         requested
+     */
+    CancellationToken()
+      : m_cancelled(false),
+        m_pollCount(0),
+        m_hasDeadline(false) { }
+
+    CancellationToken(const CancellationToken &) = delete;
+    CancellationToken & operator=(const CancellationToken &) = delete;
+
+    /**
+     * @brief  Request cancellation
+     *
+     * May be called from any thread. Validation runs polling this token
+     * will abandon their work at the next sub-schema boundary.
+     */
+    void cancel()
+    {
+        m_cancelled.store(true, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief  Attach a deadline after which validation should be abandoned
+     *
+     * Must be called before the token is shared with a running validation.
+     *
+     * @param  deadline  point in time at which cancellation takes effect
+     */
+    void setDeadline(std::chrono::steady_clock::time_point deadline)
+    {
+        m_deadline = deadline;
+        m_hasDeadline = true;
+    }
+
+    /**
+     * @brief  Attach a deadline a fixed duration from now
+     *
+     * @param  timeout  time budget for the validation run
+     */
+    template<typename Rep, typename Period>
+    void setTimeout(std::chrono::duration<Rep, Period> timeout)
+    {
+        setDeadline(std::chrono::steady_clock::now() + timeout);
+    }
+
+    /**
+     * @brief  Returns true if cancellation has been requested
+     *
+     * This checks only the explicit flag; deadline expiry is latched into
+     * the flag by poll(), which is what the validator calls.
+     */
+    bool isCancelled() const
+    {
+        return m_cancelled.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief  Poll the token from within a validation run
+     *
+     * Checks the explicit flag on every call, and the deadline - which
+     * requires reading the clock - once every kPollsPerDeadlineCheck
+     * calls. Deadline expiry is latched into the cancelled flag, so other
+     * runs sharing the token observe it through the cheap flag check.
+     *
+     * @returns  true if cancellation has been requested or the deadline
+     *           has passed
+     */
+    bool poll()
+    {
+        if (m_cancelled.load(std::memory_order_relaxed)) {
+            return true;
+        }
+
+        if (!m_hasDeadline) {
+            return false;
+        }
+
+        const unsigned int count =
+                m_pollCount.fetch_add(1, std::memory_order_relaxed);
+        if (count % kPollsPerDeadlineCheck != 0) {
+            return false;
+        }
+
+        if (std::chrono::steady_clock::now() >= m_deadline) {
+            m_cancelled.store(true, std::memory_order_relaxed);
+            return true;
+        }
+
+        return false;
+    }
+
+    /**
+     * @brief  Clear the cancelled flag and any deadline, so that the token
+     *         can be reused for another run
+     *
+     * Must not be called while a validation run is polling the token.
+     */
+    void reset()
+    {
+        m_cancelled.store(false, std::memory_order_relaxed);
+        m_pollCount.store(0, std::memory_order_relaxed);
+        m_hasDeadline = false;
+    }
+
+private:
+
+    /// Number of poll() calls between deadline checks; the first poll of a
+    /// run checks the deadline, so an already-expired deadline is noticed
+    /// immediately
+    static const unsigned int kPollsPerDeadlineCheck = 64;
+
+    /// Set when cancellation has been requested, explicitly or by an
+    /// expired deadline
+    std::atomic<bool> m_cancelled;
+
+    /// Number of times the token has been polled, used to rate-limit
+    /// deadline checks
+    std::atomic<unsigned int> m_pollCount;
+
+    /// Deadline after which validation should be abandoned; only
+    /// meaningful when m_hasDeadline is set
+    std::chrono::steady_clock::time_point m_deadline;
+
+    /// Whether a deadline has been attached to this token
+    bool m_hasDeadline;
+};
+
+}  // namespace valijson
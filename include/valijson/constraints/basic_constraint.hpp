@@ -29,6 +29,9 @@ struct BasicConstraint: Constraint
     BasicConstraint(const BasicConstraint &other)
       : m_allocator(other.m_allocator) { }
 
+    BasicConstraint(BasicConstraint &&other) noexcept
+      : m_allocator(other.m_allocator) { }
+
     ~BasicConstraint() override = default;
 
     bool accept(ConstraintVisitor &visitor) const override
@@ -52,6 +55,32 @@ struct BasicConstraint: Constraint
         return ptr;
     }
 
+    OwningPointer moveClone(CustomAlloc allocFn, CustomFree freeFn) override
+    {
+        // smart pointer to automatically free raw memory on exception
+        typedef std::unique_ptr<Constraint, CustomFree> RawOwningPointer;
+        auto ptr = RawOwningPointer(static_cast<Constraint*>(allocFn(sizeof(ConstraintType))), freeFn);
+        if (!ptr) {
+            throwRuntimeError("Failed to allocate memory for cloned constraint");
+        }
+
+        // selects the concrete type's move constructor when it has one, and
+        // falls back to its copy constructor otherwise
+        (void)new (ptr.get()) ConstraintType(std::move(*static_cast<ConstraintType*>(this)));
+
+        return ptr;
+    }
+
+    Constraint * cloneInto(void *ptr) const override
+    {
+        return new (ptr) ConstraintType(*static_cast<const ConstraintType*>(this));
+    }
+
+    size_t sizeOf() const override
+    {
+        return sizeof(ConstraintType);
+    }
+
 protected:
 
     Allocator m_allocator;
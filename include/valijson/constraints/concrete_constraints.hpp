@@ -14,15 +14,27 @@
 
 #pragma once
 
+#include <algorithm>
 #include <limits>
 #include <map>
+#include <memory>
+#include <regex>
 #include <set>
 #include <string>
+#include <typeinfo>
+#include <unordered_map>
 #include <vector>
 
+#include <valijson/adapters/scalar_value_adapter.hpp>
 #include <valijson/constraints/basic_constraint.hpp>
+#include <valijson/format_checkers.hpp>
+#include <valijson/internal/compact_frozen_value.hpp>
 #include <valijson/internal/custom_allocator.hpp>
 #include <valijson/internal/frozen_value.hpp>
+#include <valijson/internal/frozen_value_pool.hpp>
+#include <valijson/internal/json_hash.hpp>
+#include <valijson/internal/string_intern_pool.hpp>
+#include <valijson/regex_cache.hpp>
 #include <valijson/schema.hpp>
 #include <valijson/exceptions.hpp>
 
@@ -182,58 +194,179 @@ class ConstConstraint: public BasicConstraint<ConstConstraint>
 {
 public:
     ConstConstraint()
-      : m_value(nullptr) { }
+      : m_value(nullptr),
+        m_valueHash(0),
+        m_hasValueHash(false) { }
 
     ConstConstraint(CustomAlloc allocFn, CustomFree freeFn)
       : BasicConstraint(allocFn, freeFn),
-        m_value(nullptr) { }
+        m_value(nullptr),
+        m_valueHash(0),
+        m_hasValueHash(false) { }
 
     ConstConstraint(const ConstConstraint &other)
       : BasicConstraint(other),
-        m_value(other.m_value->clone()) { }
+        m_value(other.m_value->clone()),
+        m_valueHash(other.m_valueHash),
+        m_hasValueHash(other.m_hasValueHash) { }
+
+    ConstConstraint(ConstConstraint &&other) noexcept
+      : BasicConstraint(other),
+        m_value(std::move(other.m_value)),
+        m_valueHash(other.m_valueHash),
+        m_hasValueHash(other.m_hasValueHash) { }
 
     adapters::FrozenValue * getValue() const
     {
         return m_value.get();
     }
 
+    /**
+     * @brief  Return the canonical hash of the expected value
+     *
+     * Must only be used when hasValueHash() returns \c true.
+     */
+    size_t getValueHash() const
+    {
+        return m_valueHash;
+    }
+
+    /**
+     * @brief  Return true if the canonical hash of the expected value is
+     *         available
+     *
+     * The hash is only retained for composite values, where a hash-based
+     * pre-check can skip a deep comparison; scalar comparisons are already
+     * as cheap as a hash comparison.
+     */
+    bool hasValueHash() const
+    {
+        return m_hasValueHash;
+    }
+
     void setValue(const adapters::Adapter &value)
     {
-        m_value = std::unique_ptr<adapters::FrozenValue>(value.freeze());
+        // Identical literals recur across many constraints in large schemas,
+        // so when a pool is active the frozen value is hash-consed through
+        // it, sharing one immutable instance per distinct literal
+        if (internal::FrozenValuePool *pool = internal::FrozenValuePool::active()) {
+            adapters::FrozenValue *shared = pool->intern(value, [&value]() {
+                adapters::FrozenValue *frozen = adapters::freezeScalarValue(value);
+                return frozen ? frozen : adapters::freezeCompactValue(value);
+            });
+            if (shared != nullptr) {
+                m_value = std::unique_ptr<adapters::FrozenValue>(shared);
+
+                // The canonical hash is only retained for composite values,
+                // matching the private freezing path below
+                if (value.isArray() || value.isObject()) {
+                    m_valueHash = value.hash();
+                    m_hasValueHash = true;
+                } else {
+                    m_valueHash = 0;
+                    m_hasValueHash = false;
+                }
+                return;
+            }
+        }
+
+        // Scalar values are frozen in a canonical representation, independent
+        // of the adapter the schema was parsed with, so that they can be
+        // serialized; composite values use the adapter's own frozen form
+        if (adapters::FrozenValue *scalar = adapters::freezeScalarValue(value)) {
+            m_value = std::unique_ptr<adapters::FrozenValue>(scalar);
+            m_valueHash = 0;
+            m_hasValueHash = false;
+            return;
+        }
+
+        // Composite values are packed into a flat compact encoding where
+        // possible, falling back to the adapter's own frozen form when the
+        // value cannot be encoded faithfully
+        adapters::FrozenValue *composite = adapters::freezeCompactValue(value);
+        if (composite == nullptr) {
+            composite = value.freeze();
+        }
+        m_value = std::unique_ptr<adapters::FrozenValue>(composite);
+        m_valueHash = value.hash();
+        m_hasValueHash = true;
     }
 
 private:
     std::unique_ptr<adapters::FrozenValue> m_value;
+
+    /// Canonical hash of the expected value; only valid for composite values
+    size_t m_valueHash;
+
+    /// Whether m_valueHash holds the hash of the expected value
+    bool m_hasValueHash;
 };
 
 /**
  * @brief  Represents a 'contains' constraint
  *
  * A 'contains' constraint specifies a schema that must be satisfied by at least one
- * of the values in an array.
+ * of the values in an array. The number of matching values can be bounded
+ * with the 'minContains' and 'maxContains' keywords; by default at least one
+ * match is required and there is no upper bound.
  */
 class ContainsConstraint: public BasicConstraint<ContainsConstraint>
 {
 public:
+    /// Value of 'maxContains' representing the absence of an upper bound
+    static constexpr uint64_t kUnbounded =
+            (std::numeric_limits<uint64_t>::max)();
+
     ContainsConstraint()
-      : m_subschema(nullptr) { }
+      : m_subschema(nullptr),
+        m_minContains(1),
+        m_maxContains(kUnbounded) { }
 
     ContainsConstraint(CustomAlloc allocFn, CustomFree freeFn)
       : BasicConstraint(allocFn, freeFn),
-        m_subschema(nullptr) { }
+        m_subschema(nullptr),
+        m_minContains(1),
+        m_maxContains(kUnbounded) { }
 
     const Subschema * getSubschema() const
     {
         return m_subschema;
     }
 
+    uint64_t getMinContains() const
+    {
+        return m_minContains;
+    }
+
+    uint64_t getMaxContains() const
+    {
+        return m_maxContains;
+    }
+
     void setSubschema(const Subschema *subschema)
     {
         m_subschema = subschema;
     }
 
+    void setMinContains(uint64_t minContains)
+    {
+        m_minContains = minContains;
+    }
+
+    void setMaxContains(uint64_t maxContains)
+    {
+        m_maxContains = maxContains;
+    }
+
 private:
     const Subschema *m_subschema;
+
+    /// Minimum number of array values that must match the subschema
+    uint64_t m_minContains;
+
+    /// Maximum number of array values that may match the subschema, or
+    /// kUnbounded when no upper bound applies
+    uint64_t m_maxContains;
 };
 
 /**
@@ -353,15 +486,23 @@ class EnumConstraint: public BasicConstraint<EnumConstraint>
 {
 public:
     EnumConstraint()
-      : m_enumValues(Allocator::rebind<const EnumValue *>::other(m_allocator)) { }
+      : m_enumValues(Allocator::rebind<const EnumValue *>::other(m_allocator)),
+        m_enumValueHashes(Allocator::rebind<size_t>::other(m_allocator)),
+        m_hashIndex(1, std::hash<size_t>(), std::equal_to<size_t>(),
+                Allocator::rebind<HashIndex::value_type>::other(m_allocator)) { }
 
     EnumConstraint(CustomAlloc allocFn, CustomFree freeFn)
       : BasicConstraint(allocFn, freeFn),
-        m_enumValues(Allocator::rebind<const EnumValue *>::other(m_allocator)) { }
+        m_enumValues(Allocator::rebind<const EnumValue *>::other(m_allocator)),
+        m_enumValueHashes(Allocator::rebind<size_t>::other(m_allocator)),
+        m_hashIndex(1, std::hash<size_t>(), std::equal_to<size_t>(),
+                Allocator::rebind<HashIndex::value_type>::other(m_allocator)) { }
 
     EnumConstraint(const EnumConstraint &other)
       : BasicConstraint(other),
-        m_enumValues(Allocator::rebind<const EnumValue *>::other(m_allocator))
+        m_enumValues(Allocator::rebind<const EnumValue *>::other(m_allocator)),
+        m_enumValueHashes(other.m_enumValueHashes),
+        m_hashIndex(other.m_hashIndex)
     {
 #if VALIJSON_USE_EXCEPTIONS
         try {
@@ -390,6 +531,17 @@ public:
         }
     }
 
+    EnumConstraint(EnumConstraint &&other) noexcept
+      : BasicConstraint(other),
+        m_enumValues(std::move(other.m_enumValues)),
+        m_enumValueHashes(std::move(other.m_enumValueHashes)),
+        m_hashIndex(std::move(other.m_hashIndex))
+    {
+        // Ensure the moved-from constraint does not delete the transferred
+        // values when it is destroyed
+        other.m_enumValues.clear();
+    }
+
     ~EnumConstraint() override
     {
         for (const EnumValue *value : m_enumValues) {
@@ -400,9 +552,66 @@ public:
     void addValue(const adapters::Adapter &value)
     {
         // TODO: Freeze value using custom alloc/free functions
+
+        // When a pool is active the frozen value is hash-consed through it,
+        // so repeated literals share one immutable instance
+        if (const adapters::FrozenValue *shared = internFrozenValue(value)) {
+            m_enumValues.push_back(shared);
+            return;
+        }
+
+        // Scalar values are frozen in a canonical representation, independent
+        // of the adapter the schema was parsed with, so that they can be
+        // serialized; composite values use the adapter's own frozen form
+        if (const adapters::FrozenValue *scalar = adapters::freezeScalarValue(value)) {
+            m_enumValues.push_back(scalar);
+            return;
+        }
+
+        // Composite values are packed into a flat compact encoding where
+        // possible, falling back to the adapter's own frozen form when the
+        // value cannot be encoded faithfully
+        if (const adapters::FrozenValue *composite =
+                adapters::freezeCompactValue(value)) {
+            m_enumValues.push_back(composite);
+            return;
+        }
+
         m_enumValues.push_back(value.freeze());
     }
 
+    /**
+     * @brief  Add a value to the constraint, indexing it by canonical hash
+     *
+     * When all of the values in a constraint have been added through this
+     * overload, the hash index can be used to test enum membership without
+     * performing a deep comparison against every value.
+     */
+    template<typename AdapterType, typename = typename AdapterType::Object>
+    void addValue(const AdapterType &value)
+    {
+        const size_t hash = internal::hashJsonValue(value);
+
+        // TODO: Freeze value using custom alloc/free functions
+        if (const adapters::FrozenValue *shared = internFrozenValue(value)) {
+            m_enumValues.push_back(shared);
+        } else if (const adapters::FrozenValue *scalar = adapters::freezeScalarValue(value)) {
+            m_enumValues.push_back(scalar);
+        } else if (const adapters::FrozenValue *composite =
+                adapters::freezeCompactValue(value)) {
+            m_enumValues.push_back(composite);
+        } else {
+            m_enumValues.push_back(value.freeze());
+        }
+
+        // The hash index is only maintained while every value in the
+        // constraint has a known hash
+        if (m_enumValueHashes.size() == m_enumValues.size() - 1) {
+            m_enumValueHashes.push_back(hash);
+            m_hashIndex.insert(HashIndex::value_type(hash, m_enumValues.size() - 1));
+        }
+    }
+
     void addValue(const adapters::FrozenValue &value)
     {
         // TODO: Clone using custom alloc/free functions
@@ -419,12 +628,69 @@ public:
         }
     }
 
+    /**
+     * @brief  Invoke a function on each value whose canonical hash matches
+     *         the given hash
+     *
+     * This must only be used when hasHashIndex() returns \c true. Values
+     * that share a hash bucket are visited in an unspecified order.
+     */
+    template<typename FunctorType>
+    void applyToValuesWithHash(size_t hash, const FunctorType &fn) const
+    {
+        const auto range = m_hashIndex.equal_range(hash);
+        for (auto itr = range.first; itr != range.second; ++itr) {
+            if (!fn(*m_enumValues[itr->second])) {
+                return;
+            }
+        }
+    }
+
+    /**
+     * @brief  Return true if every value in this constraint is indexed by
+     *         its canonical hash
+     */
+    bool hasHashIndex() const
+    {
+        return !m_enumValues.empty() &&
+                m_enumValueHashes.size() == m_enumValues.size();
+    }
+
 private:
     typedef adapters::FrozenValue EnumValue;
 
+    /// Intern a value through the active frozen-value pool, returning a
+    /// shared frozen instance, or nullptr when no pool is active or the
+    /// value cannot be canonically encoded
+    static const adapters::FrozenValue * internFrozenValue(
+            const adapters::Adapter &value)
+    {
+        internal::FrozenValuePool *pool = internal::FrozenValuePool::active();
+        if (pool == nullptr) {
+            return nullptr;
+        }
+
+        return pool->intern(value, [&value]() {
+            adapters::FrozenValue *frozen = adapters::freezeScalarValue(value);
+            return frozen ? frozen : adapters::freezeCompactValue(value);
+        });
+    }
+
     typedef std::vector<const EnumValue *, internal::CustomAllocator<const EnumValue *>> EnumValues;
 
+    typedef std::vector<size_t, internal::CustomAllocator<size_t>> EnumValueHashes;
+
+    /// Maps a canonical hash to an index within m_enumValues
+    typedef std::unordered_multimap<size_t, size_t, std::hash<size_t>, std::equal_to<size_t>,
+            internal::CustomAllocator<std::pair<const size_t, size_t>>> HashIndex;
+
     EnumValues m_enumValues;
+
+    /// Canonical hash of each value in m_enumValues; maintained only while
+    /// every value has been added with a known hash
+    EnumValueHashes m_enumValueHashes;
+
+    HashIndex m_hashIndex;
 };
 
 /**
@@ -438,7 +704,17 @@ class FormatConstraint: public BasicConstraint<FormatConstraint>
 {
 public:
     FormatConstraint()
-        : m_format() { }
+        : m_checker(nullptr),
+          m_format() { }
+
+    /**
+     * @brief  Return the checker resolved for this constraint's format, or
+     *         nullptr if the format has no registered checker
+     */
+    FormatChecker getChecker() const
+    {
+        return m_checker;
+    }
 
     const std::string & getFormat() const
     {
@@ -448,9 +724,15 @@ public:
     void setFormat(const std::string & format)
     {
         m_format = format;
+
+        // The checker is resolved once, when the constraint is populated,
+        // so that validation does not take the registry lock
+        m_checker = FormatCheckerRegistry::instance().find(format);
     }
 
 private:
+    FormatChecker m_checker;
+
     std::string m_format;
 };
 
@@ -528,12 +810,16 @@ class MaximumConstraint: public BasicConstraint<MaximumConstraint>
 public:
     MaximumConstraint()
       : m_maximum(std::numeric_limits<double>::infinity()),
-        m_exclusiveMaximum(false) { }
+        m_integerMaximum(0),
+        m_exclusiveMaximum(false),
+        m_hasIntegerMaximum(false) { }
 
     MaximumConstraint(CustomAlloc allocFn, CustomFree freeFn)
       : BasicConstraint(allocFn, freeFn),
         m_maximum(std::numeric_limits<double>::infinity()),
-        m_exclusiveMaximum(false) { }
+        m_integerMaximum(0),
+        m_exclusiveMaximum(false),
+        m_hasIntegerMaximum(false) { }
 
     bool getExclusiveMaximum() const
     {
@@ -545,11 +831,37 @@ public:
         m_exclusiveMaximum = newExclusiveMaximum;
     }
 
+    /// Returns true if the bound also has an integral representation
+    bool hasIntegerMaximum() const
+    {
+        return m_hasIntegerMaximum;
+    }
+
+    int64_t getIntegerMaximum() const
+    {
+        return m_integerMaximum;
+    }
+
     double getMaximum() const
     {
         return m_maximum;
     }
 
+    /**
+     * @brief  Record an integral representation of the maximum
+     *
+     * When the schema expresses the bound as an integer, the validator can
+     * compare integer targets using integer arithmetic, avoiding a round
+     * trip through double
+     *
+     * @param  newMaximum  integral form of the maximum value
+     */
+    void setIntegerMaximum(int64_t newMaximum)
+    {
+        m_integerMaximum = newMaximum;
+        m_hasIntegerMaximum = true;
+    }
+
     void setMaximum(double newMaximum)
     {
         m_maximum = newMaximum;
@@ -557,7 +869,9 @@ public:
 
 private:
     double m_maximum;
+    int64_t m_integerMaximum;
     bool m_exclusiveMaximum;
+    bool m_hasIntegerMaximum;
 };
 
 /**
@@ -649,12 +963,16 @@ class MinimumConstraint: public BasicConstraint<MinimumConstraint>
 public:
     MinimumConstraint()
       : m_minimum(-std::numeric_limits<double>::infinity()),
-        m_exclusiveMinimum(false) { }
+        m_integerMinimum(0),
+        m_exclusiveMinimum(false),
+        m_hasIntegerMinimum(false) { }
 
     MinimumConstraint(CustomAlloc allocFn, CustomFree freeFn)
       : BasicConstraint(allocFn, freeFn),
         m_minimum(-std::numeric_limits<double>::infinity()),
-        m_exclusiveMinimum(false) { }
+        m_integerMinimum(0),
+        m_exclusiveMinimum(false),
+        m_hasIntegerMinimum(false) { }
 
     bool getExclusiveMinimum() const
     {
@@ -666,11 +984,37 @@ public:
         m_exclusiveMinimum = newExclusiveMinimum;
     }
 
+    /// Returns true if the bound also has an integral representation
+    bool hasIntegerMinimum() const
+    {
+        return m_hasIntegerMinimum;
+    }
+
+    int64_t getIntegerMinimum() const
+    {
+        return m_integerMinimum;
+    }
+
     double getMinimum() const
     {
         return m_minimum;
     }
 
+    /**
+     * @brief  Record an integral representation of the minimum
+     *
+     * When the schema expresses the bound as an integer, the validator can
+     * compare integer targets using integer arithmetic, avoiding a round
+     * trip through double
+     *
+     * @param  newMinimum  integral form of the minimum value
+     */
+    void setIntegerMinimum(int64_t newMinimum)
+    {
+        m_integerMinimum = newMinimum;
+        m_hasIntegerMinimum = true;
+    }
+
     void setMinimum(double newMinimum)
     {
         m_minimum = newMinimum;
@@ -678,7 +1022,9 @@ public:
 
 private:
     double m_minimum;
+    int64_t m_integerMinimum;
     bool m_exclusiveMinimum;
+    bool m_hasIntegerMinimum;
 };
 
 /**
@@ -854,11 +1200,30 @@ class OneOfConstraint: public BasicConstraint<OneOfConstraint>
 {
 public:
     OneOfConstraint()
-      : m_subschemas(Allocator::rebind<const Subschema *>::other(m_allocator)) { }
+      : m_subschemas(Allocator::rebind<const Subschema *>::other(m_allocator)),
+        m_discriminatorProperty(Allocator::rebind<char>::other(m_allocator)),
+        m_discriminatorIndex(1, std::hash<size_t>(), std::equal_to<size_t>(),
+                Allocator::rebind<DiscriminatorIndex::value_type>::other(m_allocator)) { }
 
     OneOfConstraint(CustomAlloc allocFn, CustomFree freeFn)
       : BasicConstraint(allocFn, freeFn),
-        m_subschemas(Allocator::rebind<const Subschema *>::other(m_allocator)) { }
+        m_subschemas(Allocator::rebind<const Subschema *>::other(m_allocator)),
+        m_discriminatorProperty(Allocator::rebind<char>::other(m_allocator)),
+        m_discriminatorIndex(1, std::hash<size_t>(), std::equal_to<size_t>(),
+                Allocator::rebind<DiscriminatorIndex::value_type>::other(m_allocator)) { }
+
+    /**
+     * @brief  Record a discriminator value for one of the sub-schemas
+     *
+     * Returns \c false when another sub-schema has already been indexed
+     * under the same hash, in which case the property cannot discriminate
+     * between the two and the index should not be used.
+     */
+    bool addDiscriminatorValue(size_t valueHash, const Subschema *subschema)
+    {
+        return m_discriminatorIndex.insert(
+                DiscriminatorIndex::value_type(valueHash, subschema)).second;
+    }
 
     void addSubschema(const Subschema *subschema)
     {
@@ -878,11 +1243,61 @@ public:
         }
     }
 
+    /**
+     * @brief  Return the sub-schema indexed under a discriminator value
+     *         hash, or nullptr if no sub-schema requires that value
+     *
+     * Must only be used when hasDiscriminator() returns \c true.
+     */
+    const Subschema * findDiscriminatedSubschema(size_t valueHash) const
+    {
+        const auto itr = m_discriminatorIndex.find(valueHash);
+        return itr == m_discriminatorIndex.end() ? nullptr : itr->second;
+    }
+
+    template<typename AllocatorType>
+    std::basic_string<char, std::char_traits<char>, AllocatorType> getDiscriminatorProperty(
+            const AllocatorType &alloc = AllocatorType()) const
+    {
+        return std::basic_string<char, std::char_traits<char>, AllocatorType>(
+                m_discriminatorProperty.c_str(), alloc);
+    }
+
+    /**
+     * @brief  Return true when every sub-schema has been indexed by the
+     *         constant value it requires for a discriminating property
+     */
+    bool hasDiscriminator() const
+    {
+        return !m_discriminatorProperty.empty() &&
+                m_discriminatorIndex.size() == m_subschemas.size();
+    }
+
+    template<typename AllocatorType>
+    void setDiscriminatorProperty(
+            const std::basic_string<char, std::char_traits<char>, AllocatorType> &propertyName)
+    {
+        m_discriminatorProperty.assign(propertyName.c_str());
+    }
+
 private:
     typedef std::vector<const Subschema *, internal::CustomAllocator<const Subschema *>> Subschemas;
 
+    /// Maps the canonical hash of a discriminator value to the sub-schema
+    /// that requires it
+    typedef std::unordered_map<size_t, const Subschema *, std::hash<size_t>, std::equal_to<size_t>,
+            internal::CustomAllocator<std::pair<const size_t, const Subschema *>>> DiscriminatorIndex;
+
     /// Collection of sub-schemas, exactly one of which must be satisfied
     Subschemas m_subschemas;
+
+    /// Name of the property whose constant value discriminates between the
+    /// sub-schemas, or an empty string when no discriminator is available
+    std::basic_string<char, std::char_traits<char>, internal::CustomAllocator<char>> m_discriminatorProperty;
+
+    /// Index from discriminator value hash to the matching sub-schema; see
+    /// indexOneOfDiscriminators() in validator.hpp
+    DiscriminatorIndex m_discriminatorIndex;
 };
 
 /**
@@ -918,8 +1333,68 @@ public:
         m_pattern.assign(pattern.c_str());
     }
 
+    /**
+     * @brief  Return a compiled regular expression for this constraint's
+     *         pattern, compiling it on first use
+     *
+     * The compiled engine is obtained from the process-wide RegexCache and a
+     * reference to it is stored within the constraint, so a pattern that is
+     * repeated across many schemas is compiled at most once per process, and
+     * looked up at most once per constraint.
+     *
+     * Lazy compilation uses atomic shared_ptr operations, so it is safe for
+     * multiple threads to validate against the same schema concurrently, as
+     * long as they all use the same regular expression engine. Switching to
+     * a different engine re-compiles the pattern, and is not supported while
+     * other threads may hold a reference to the previous engine.
+     */
+    template<typename RegexEngine>
+    const RegexEngine & getCompiledRegex() const
+    {
+        std::shared_ptr<const CompiledRegexHolder> current = std::atomic_load(&m_compiledRegex);
+        while (!current || current->engineType() != typeid(RegexEngine)) {
+            const auto replacement = std::make_shared<CompiledRegex<RegexEngine>>(
+                    std::string(m_pattern.c_str()));
+            if (std::atomic_compare_exchange_strong(&m_compiledRegex, &current,
+                    std::shared_ptr<const CompiledRegexHolder>(replacement))) {
+                current = replacement;
+            }
+
+            // When the exchange fails, 'current' will have been updated to
+            // refer to the holder installed by a competing thread, which can
+            // be used as long as the engine type matches
+        }
+
+        return *static_cast<const CompiledRegex<RegexEngine> &>(*current).engine;
+    }
+
 private:
+    /// Base class for type-erased storage of a compiled regular expression
+    struct CompiledRegexHolder
+    {
+        virtual ~CompiledRegexHolder() = default;
+
+        virtual const std::type_info & engineType() const = 0;
+    };
+
+    template<typename RegexEngine>
+    struct CompiledRegex: CompiledRegexHolder
+    {
+        explicit CompiledRegex(const std::string &pattern)
+          : engine(RegexCache<RegexEngine>::instance().fetch(pattern)) { }
+
+        const std::type_info & engineType() const override
+        {
+            return typeid(RegexEngine);
+        }
+
+        std::shared_ptr<const RegexEngine> engine;
+    };
+
     String m_pattern;
+
+    /// Lazily compiled regular expression engine for this pattern
+    mutable std::shared_ptr<const CompiledRegexHolder> m_compiledRegex;
 };
 
 class PolyConstraint : public Constraint
@@ -949,11 +1424,6 @@ public:
     virtual bool validate(const adapters::Adapter &target,
             const std::vector<std::string>& context,
             valijson::ValidationResults *results) const = 0;
-
-private:
-    virtual Constraint * cloneInto(void *) const = 0;
-
-    virtual size_t sizeOf() const = 0;
 };
 
 /**
@@ -963,21 +1433,98 @@ private:
 class PropertiesConstraint: public BasicConstraint<PropertiesConstraint>
 {
 public:
+    /// Property names and patterns are stored as references into an intern
+    /// pool, so that a name that recurs across a schema is stored only once
+    typedef internal::InternedString String;
+
     PropertiesConstraint()
-      : m_properties(std::less<String>(), m_allocator),
+      : m_names(m_allocator.m_allocFn, m_allocator.m_freeFn),
+        m_properties(std::less<String>(), m_allocator),
         m_patternProperties(std::less<String>(), m_allocator),
+        m_compiledPatternProperties(std::less<String>(), m_allocator),
         m_additionalProperties(nullptr) { }
 
     PropertiesConstraint(CustomAlloc allocFn, CustomFree freeFn)
       : BasicConstraint(allocFn, freeFn),
+        m_names(allocFn, freeFn),
         m_properties(std::less<String>(), m_allocator),
         m_patternProperties(std::less<String>(), m_allocator),
+        m_compiledPatternProperties(std::less<String>(), m_allocator),
         m_additionalProperties(nullptr) { }
 
+    PropertiesConstraint(const PropertiesConstraint &other)
+      : BasicConstraint(other),
+        m_names(other.m_allocator.m_allocFn, other.m_allocator.m_freeFn),
+        m_properties(std::less<String>(), m_allocator),
+        m_patternProperties(std::less<String>(), m_allocator),
+        m_compiledPatternProperties(std::less<String>(), m_allocator),
+        m_combinedPatternRegex(other.m_combinedPatternRegex),
+        m_additionalProperties(other.m_additionalProperties)
+    {
+        if (other.m_names.empty()) {
+            // Every key is interned in an external pool, such as the one
+            // owned by the Schema that both constraints belong to, so the
+            // references can be copied directly
+            m_properties = other.m_properties;
+            m_patternProperties = other.m_patternProperties;
+            m_compiledPatternProperties = other.m_compiledPatternProperties;
+        } else {
+            // Keys interned in the other constraint's own pool must be
+            // re-interned, as they would dangle once it is destroyed
+            for (const auto &property : other.m_properties) {
+                m_properties.insert(PropertySchemaMap::value_type(
+                        internKey(property.first), property.second));
+            }
+            for (const auto &pattern : other.m_patternProperties) {
+                m_patternProperties.insert(PropertySchemaMap::value_type(
+                        internKey(pattern.first), pattern.second));
+            }
+            for (const auto &compiled : other.m_compiledPatternProperties) {
+                m_compiledPatternProperties.insert(PatternRegexMap::value_type(
+                        internKey(compiled.first), compiled.second));
+            }
+        }
+    }
+
+    PropertiesConstraint(PropertiesConstraint &&other) noexcept
+      : BasicConstraint(other),
+        m_names(std::move(other.m_names)),
+        m_properties(std::move(other.m_properties)),
+        m_patternProperties(std::move(other.m_patternProperties)),
+        m_compiledPatternProperties(std::move(other.m_compiledPatternProperties)),
+        m_combinedPatternRegex(std::move(other.m_combinedPatternRegex)),
+        m_additionalProperties(other.m_additionalProperties)
+    {
+        // Keys interned in the other constraint's own pool remain valid,
+        // because the pool's storage blocks move with the pool
+    }
+
     bool addPatternPropertySubschema(const char *patternProperty, const Subschema *subschema)
     {
-        return m_patternProperties.insert(PropertySchemaMap::value_type(
-                String(patternProperty, m_allocator), subschema)).second;
+        const String key(internName(patternProperty, strlen(patternProperty)));
+        if (!m_patternProperties.insert(
+                PropertySchemaMap::value_type(key, subschema)).second) {
+            return false;
+        }
+
+#if VALIJSON_USE_EXCEPTIONS
+        try {
+#endif
+            // Compiling at insertion time leaves the map of compiled regexes
+            // immutable during validation, so that concurrent validators do
+            // not need to synchronise access to it
+            m_compiledPatternProperties.insert(PatternRegexMap::value_type(
+                    key, std::regex(patternProperty)));
+#if VALIJSON_USE_EXCEPTIONS
+        } catch (const std::regex_error &) {
+            // Defer compilation of an invalid pattern, so that the error
+            // surfaces during validation rather than while building a schema
+        }
+#endif
+
+        rebuildCombinedPatternRegex();
+
+        return true;
     }
 
     template<typename AllocatorType>
@@ -992,7 +1539,8 @@ public:
             const Subschema *subschema)
     {
         return m_properties.insert(PropertySchemaMap::value_type(
-                String(propertyName, m_allocator), subschema)).second;
+                String(internName(propertyName, strlen(propertyName))),
+                subschema)).second;
     }
 
     template<typename AllocatorType>
@@ -1025,11 +1573,91 @@ public:
         }
     }
 
+    /**
+     * @brief  Return a regex that matches a property name if and only if at
+     *         least one of this constraint's patternProperties patterns
+     *         matches it, or nullptr when no combined automaton is available
+     *
+     * The combined automaton is an alternation over all of the patterns in
+     * the constraint, built as patterns are added. It allows a validator to
+     * scan each property name once, rather than once per pattern, to decide
+     * whether any per-pattern validation is needed at all.
+     */
+    const std::regex * combinedPatternRegex() const
+    {
+        return m_combinedPatternRegex.get();
+    }
+
+    /**
+     * @brief  Look up the sub-schema associated with a named property
+     *
+     * This allows a validator that is already iterating over an object's
+     * members to probe the 'properties' map directly, rather than iterating
+     * over the map and probing the object for each entry.
+     *
+     * @param  propertyName  name of the property to look up
+     *
+     * @returns  pointer to the property's sub-schema, or nullptr if the
+     *           name does not appear in this constraint
+     */
+    const Subschema * findPropertySubschema(const std::string &propertyName) const
+    {
+        const typename PropertySchemaMap::const_iterator itr = m_properties.find(
+                String(propertyName.data(), propertyName.size()));
+        if (itr == m_properties.end()) {
+            return nullptr;
+        }
+
+        return itr->second;
+    }
+
     const Subschema * getAdditionalPropertiesSubschema() const
     {
         return m_additionalProperties;
     }
 
+    /**
+     * @brief  Return a compiled regular expression for one of this
+     *         constraint's pattern properties, compiling it on first use
+     *
+     * The compiled object is stored within the constraint, so the cost of
+     * compiling a pattern property is paid at most once per schema, rather
+     * than once per validation attempt.
+     */
+    const std::regex & getPatternPropertyRegex(const String &patternProperty) const
+    {
+        auto itr = m_compiledPatternProperties.find(patternProperty);
+        if (itr == m_compiledPatternProperties.end()) {
+            itr = m_compiledPatternProperties.insert(PatternRegexMap::value_type(
+                    patternProperty, std::regex(patternProperty.c_str()))).first;
+        }
+
+        return itr->second;
+    }
+
+    /// Number of 'patternProperties' entries held by this constraint
+    size_t patternPropertySubschemaCount() const
+    {
+        return m_patternProperties.size();
+    }
+
+    /**
+     * @brief  Eagerly compile the regular expressions for all of this
+     *         constraint's pattern properties
+     */
+    void precompilePatternRegexes() const
+    {
+        for (const auto &patternProperty : m_patternProperties) {
+            getPatternPropertyRegex(patternProperty.first);
+        }
+    }
+
+    /// Number of named 'properties' entries held by this constraint
+    size_t propertySubschemaCount() const
+    {
+        return m_properties.size();
+    }
+
     void setAdditionalPropertiesSubschema(const Subschema *subschema)
     {
         m_additionalProperties = subschema;
@@ -1043,9 +1671,106 @@ private:
             internal::CustomAllocator<std::pair<const String, const Subschema *>>
         > PropertySchemaMap;
 
+    typedef std::map<
+            String,
+            std::regex,
+            std::less<String>,
+            internal::CustomAllocator<std::pair<const String, std::regex>>
+        > PatternRegexMap;
+
+    /**
+     * @brief  Rebuild the alternation regex that combines all of the
+     *         patterns in this constraint
+     *
+     * The combined automaton is only built when the constraint has more than
+     * one pattern, every pattern compiled successfully, and no pattern
+     * contains a backreference, whose group numbering would be disturbed by
+     * the surrounding alternation.
+     */
+    void rebuildCombinedPatternRegex()
+    {
+        m_combinedPatternRegex.reset();
+
+        if (m_patternProperties.size() < 2 ||
+                m_compiledPatternProperties.size() != m_patternProperties.size()) {
+            return;
+        }
+
+        std::string combined;
+        for (const auto &patternProperty : m_patternProperties) {
+            if (hasBackreference(patternProperty.first.c_str())) {
+                return;
+            }
+
+            if (!combined.empty()) {
+                combined += "|";
+            }
+
+            combined += "(?:";
+            combined += patternProperty.first.c_str();
+            combined += ")";
+        }
+
+#if VALIJSON_USE_EXCEPTIONS
+        try {
+#endif
+            m_combinedPatternRegex = std::make_shared<const std::regex>(combined);
+#if VALIJSON_USE_EXCEPTIONS
+        } catch (const std::regex_error &) {
+            // Fall back to per-pattern matching if the combined expression
+            // cannot be compiled
+        }
+#endif
+    }
+
+    /// Check whether a pattern contains a backreference (e.g. \1)
+    static bool hasBackreference(const char *pattern)
+    {
+        for (const char *c = pattern; *c != '\0'; c++) {
+            if (*c == '\\') {
+                if (c[1] >= '1' && c[1] <= '9') {
+                    return true;
+                }
+                if (c[1] != '\0') {
+                    c++;
+                }
+            }
+        }
+
+        return false;
+    }
+
+    /// Intern a property name or pattern, preferring the active pool when
+    /// one has been established (typically the pool owned by the Schema
+    /// being parsed)
+    internal::string_view internName(const char *data, size_t size)
+    {
+        if (internal::StringInternPool *active =
+                internal::StringInternPool::active()) {
+            return active->intern(data, size);
+        }
+
+        return m_names.intern(data, size);
+    }
+
+    /// Re-intern an existing key through internName
+    String internKey(const String &key)
+    {
+        return String(internName(key.data(), key.size()));
+    }
+
+    /// Fallback storage for keys interned without an active pool
+    internal::StringInternPool m_names;
+
     PropertySchemaMap m_properties;
     PropertySchemaMap m_patternProperties;
 
+    /// Lazily compiled regular expressions for the pattern properties
+    mutable PatternRegexMap m_compiledPatternProperties;
+
+    /// Alternation regex covering all patterns, used as a prefilter
+    std::shared_ptr<const std::regex> m_combinedPatternRegex;
+
     const Subschema *m_additionalProperties;
 };
 
@@ -1079,17 +1804,60 @@ private:
 class RequiredConstraint: public BasicConstraint<RequiredConstraint>
 {
 public:
+    /// Property names are stored as references into an intern pool, so that
+    /// a name that recurs across a schema is stored only once
+    typedef internal::InternedString String;
+
     RequiredConstraint()
-      : m_requiredProperties(std::less<String>(), m_allocator) { }
+      : m_names(m_allocator.m_allocFn, m_allocator.m_freeFn),
+        m_requiredProperties(m_allocator) { }
 
     RequiredConstraint(CustomAlloc allocFn, CustomFree freeFn)
       : BasicConstraint(allocFn, freeFn),
-        m_requiredProperties(std::less<String>(), m_allocator) { }
+        m_names(allocFn, freeFn),
+        m_requiredProperties(m_allocator) { }
+
+    RequiredConstraint(const RequiredConstraint &other)
+      : BasicConstraint(other),
+        m_names(other.m_allocator.m_allocFn, other.m_allocator.m_freeFn),
+        m_requiredProperties(m_allocator)
+    {
+        if (other.m_names.empty()) {
+            // Every name is interned in an external pool, such as the one
+            // owned by the Schema that both constraints belong to, so the
+            // references can be copied directly
+            m_requiredProperties = other.m_requiredProperties;
+        } else {
+            // Names interned in the other constraint's own pool must be
+            // re-interned, as they would dangle once it is destroyed
+            m_requiredProperties.reserve(other.m_requiredProperties.size());
+            for (const String &name : other.m_requiredProperties) {
+                m_requiredProperties.push_back(
+                        String(internName(name.data(), name.size())));
+            }
+        }
+    }
+
+    RequiredConstraint(RequiredConstraint &&other) noexcept
+      : BasicConstraint(other),
+        m_names(std::move(other.m_names)),
+        m_requiredProperties(std::move(other.m_requiredProperties))
+    {
+        // Names interned in the other constraint's own pool remain valid,
+        // because the pool's storage blocks move with the pool
+    }
 
     bool addRequiredProperty(const char *propertyName)
     {
-        return m_requiredProperties.insert(String(propertyName,
-                Allocator::rebind<char>::other(m_allocator))).second;
+        const String name(internName(propertyName, strlen(propertyName)));
+        const typename RequiredProperties::iterator itr = std::lower_bound(
+                m_requiredProperties.begin(), m_requiredProperties.end(), name);
+        if (itr != m_requiredProperties.end() && *itr == name) {
+            return false;
+        }
+
+        m_requiredProperties.insert(itr, name);
+        return true;
     }
 
     template<typename AllocatorType>
@@ -1108,13 +1876,202 @@ public:
         }
     }
 
+    /**
+     * @brief  Find the index of a name in the sorted list of required
+     *         properties
+     *
+     * The property names are kept in sorted order, so membership can be
+     * tested with a binary search over the list rather than by probing the
+     * target object once per required name.
+     *
+     * @param  name  property name to search for
+     *
+     * @returns  index of the property name if it is required, or
+     *           requiredPropertyCount() otherwise
+     */
+    size_t findRequiredProperty(const std::string &name) const
+    {
+        const typename RequiredProperties::const_iterator itr =
+                std::lower_bound(m_requiredProperties.begin(),
+                        m_requiredProperties.end(), name,
+                        [](const String &lhs, const std::string &rhs) {
+                            return lhs < String(rhs.data(), rhs.size());
+                        });
+        if (itr != m_requiredProperties.end() &&
+                *itr == String(name.data(), name.size())) {
+            return static_cast<size_t>(itr - m_requiredProperties.begin());
+        }
+
+        return m_requiredProperties.size();
+    }
+
+    /// Return the required property name at a given index, in sorted order
+    const String & requiredPropertyAt(size_t index) const
+    {
+        return m_requiredProperties[index];
+    }
+
+    /// Number of required property names held by this constraint
+    size_t requiredPropertyCount() const
+    {
+        return m_requiredProperties.size();
+    }
+
 private:
-    typedef std::set<String, std::less<String>,
-            internal::CustomAllocator<String>> RequiredProperties;
+    /// Intern a property name, preferring the active pool when one has been
+    /// established (typically the pool owned by the Schema being parsed)
+    internal::string_view internName(const char *data, size_t size)
+    {
+        if (internal::StringInternPool *active =
+                internal::StringInternPool::active()) {
+            return active->intern(data, size);
+        }
+
+        return m_names.intern(data, size);
+    }
+
+    /// Fallback storage for names interned without an active pool
+    internal::StringInternPool m_names;
+
+    /// Required property names, sorted so that membership of a given name
+    /// can be tested with a binary search
+    typedef std::vector<String, internal::CustomAllocator<String>>
+            RequiredProperties;
 
     RequiredProperties m_requiredProperties;
 };
 
+/**
+ * @brief  Represents the object-related constraints of a sub-schema, fused
+ *         into a single constraint
+ *
+ * A sub-schema that constrains an object may hold several constraints that
+ * each iterate over, or probe, the same object: 'properties' (with
+ * 'patternProperties' and 'additionalProperties'), 'required',
+ * 'propertyNames', 'minProperties' and 'maxProperties'. Fusing them into one
+ * constraint allows a validator to evaluate all of them in a single pass
+ * over the object's members. See fuseObjectConstraints() in validator.hpp
+ * for the pass that builds instances of this constraint; it is never
+ * produced by the schema parser directly.
+ *
+ * The fused parts are stored by value as copies of the original constraint
+ * instances, so a fused constraint remains valid after the originals have
+ * been removed from their sub-schema. Parts that were not present in the
+ * sub-schema are default-constructed, which makes them vacuously
+ * satisfiable, but the has-functions should be consulted so that absent
+ * parts can be skipped entirely.
+ *
+ * This class is defined after the constraints that it aggregates, rather
+ * than in alphabetical order, because it holds them as complete types.
+ */
+class FusedObjectConstraint: public BasicConstraint<FusedObjectConstraint>
+{
+public:
+    FusedObjectConstraint()
+      : m_hasProperties(false),
+        m_hasRequired(false),
+        m_hasPropertyNames(false),
+        m_hasMinProperties(false),
+        m_hasMaxProperties(false) { }
+
+    /**
+     * @brief  Construct a fused constraint from the constraints it replaces
+     *
+     * Each pointer may be nullptr, indicating that the sub-schema does not
+     * hold a constraint of that kind. The referenced constraints are copied,
+     * so they need only remain valid for the duration of this call.
+     */
+    FusedObjectConstraint(
+            const PropertiesConstraint *properties,
+            const RequiredConstraint *required,
+            const PropertyNamesConstraint *propertyNames,
+            const MinPropertiesConstraint *minProperties,
+            const MaxPropertiesConstraint *maxProperties)
+      : m_properties(properties ? *properties : PropertiesConstraint()),
+        m_required(required ? *required : RequiredConstraint()),
+        m_propertyNames(propertyNames ? *propertyNames : PropertyNamesConstraint()),
+        m_minProperties(minProperties ? *minProperties : MinPropertiesConstraint()),
+        m_maxProperties(maxProperties ? *maxProperties : MaxPropertiesConstraint()),
+        m_hasProperties(properties != nullptr),
+        m_hasRequired(required != nullptr),
+        m_hasPropertyNames(propertyNames != nullptr),
+        m_hasMinProperties(minProperties != nullptr),
+        m_hasMaxProperties(maxProperties != nullptr) { }
+
+    bool hasProperties() const
+    {
+        return m_hasProperties;
+    }
+
+    const PropertiesConstraint & getProperties() const
+    {
+        return m_properties;
+    }
+
+    bool hasRequired() const
+    {
+        return m_hasRequired;
+    }
+
+    const RequiredConstraint & getRequired() const
+    {
+        return m_required;
+    }
+
+    bool hasPropertyNames() const
+    {
+        return m_hasPropertyNames;
+    }
+
+    const PropertyNamesConstraint & getPropertyNames() const
+    {
+        return m_propertyNames;
+    }
+
+    bool hasMinProperties() const
+    {
+        return m_hasMinProperties;
+    }
+
+    const MinPropertiesConstraint & getMinProperties() const
+    {
+        return m_minProperties;
+    }
+
+    bool hasMaxProperties() const
+    {
+        return m_hasMaxProperties;
+    }
+
+    const MaxPropertiesConstraint & getMaxProperties() const
+    {
+        return m_maxProperties;
+    }
+
+    /// Number of constraints that were fused into this one
+    size_t numParts() const
+    {
+        return (m_hasProperties ? 1 : 0) +
+               (m_hasRequired ? 1 : 0) +
+               (m_hasPropertyNames ? 1 : 0) +
+               (m_hasMinProperties ? 1 : 0) +
+               (m_hasMaxProperties ? 1 : 0);
+    }
+
+private:
+    PropertiesConstraint m_properties;
+    RequiredConstraint m_required;
+    PropertyNamesConstraint m_propertyNames;
+    MinPropertiesConstraint m_minProperties;
+    MaxPropertiesConstraint m_maxProperties;
+
+    bool m_hasProperties;
+    bool m_hasRequired;
+    bool m_hasPropertyNames;
+    bool m_hasMinProperties;
+    bool m_hasMaxProperties;
+};
+
 /**
  * @brief  Represents an 'items' constraint that specifies one sub-schema
  *
@@ -1168,16 +2125,19 @@ public:
 
     TypeConstraint()
       : m_namedTypes(std::less<JsonType>(), m_allocator),
-        m_schemaTypes(Allocator::rebind<const Subschema *>::other(m_allocator)) { }
+        m_schemaTypes(Allocator::rebind<const Subschema *>::other(m_allocator)),
+        m_namedTypeMask(0) { }
 
     TypeConstraint(CustomAlloc allocFn, CustomFree freeFn)
       : BasicConstraint(allocFn, freeFn),
         m_namedTypes(std::less<JsonType>(), m_allocator),
-        m_schemaTypes(Allocator::rebind<const Subschema *>::other(m_allocator)) { }
+        m_schemaTypes(Allocator::rebind<const Subschema *>::other(m_allocator)),
+        m_namedTypeMask(0) { }
 
     void addNamedType(JsonType type)
     {
         m_namedTypes.insert(type);
+        m_namedTypeMask |= jsonTypeMask(type);
     }
 
     void addSchemaType(const Subschema *subschema)
@@ -1195,6 +2155,31 @@ public:
         }
     }
 
+    /// Single-bit mask corresponding to a named JSON type
+    static unsigned int jsonTypeMask(JsonType type)
+    {
+        return 1u << static_cast<unsigned int>(type);
+    }
+
+    /**
+     * @brief  Return a bitmask with one bit set for each named type
+     *
+     * The mask is maintained by addNamedType, so that the validator can
+     * test whether a value's type is acceptable with a single bitwise AND
+     * instead of iterating over the named types. Each bit position is
+     * given by jsonTypeMask().
+     */
+    unsigned int namedTypeMask() const
+    {
+        return m_namedTypeMask;
+    }
+
+    /// Number of schema-based types held by this constraint
+    size_t schemaTypeCount() const
+    {
+        return m_schemaTypes.size();
+    }
+
     template<typename FunctorType>
     void applyToSchemaTypes(const FunctorType &fn) const
     {
@@ -1246,6 +2231,9 @@ private:
 
     /// Set of sub-schemas that serve as valid types
     SchemaTypes m_schemaTypes;
+
+    /// Bitmask over the named types, with bits given by jsonTypeMask()
+    unsigned int m_namedTypeMask;
 };
 
 /**
@@ -69,6 +69,40 @@ struct Constraint
      */
     virtual OwningPointer clone(CustomAlloc, CustomFree) const = 0;
 
+    /**
+     * @brief  Make a copy of a constraint, transferring its payload where
+     *         possible.
+     *
+     * Constraints that own deep payloads - such as frozen 'enum' values -
+     * can hand the payload to the new instance instead of copying it, which
+     * leaves this constraint in a valid but unspecified state. The default
+     * implementation falls back to clone(), so custom constraint types that
+     * do not override this function are copied as before.
+     *
+     * @returns  an owning-pointer to the new constraint.
+     */
+    virtual OwningPointer moveClone(CustomAlloc allocFn, CustomFree freeFn)
+    {
+        return static_cast<const Constraint *>(this)->clone(allocFn, freeFn);
+    }
+
+    /**
+     * @brief  Make a copy of a constraint at a caller-provided address.
+     *
+     * The caller is responsible for providing suitably sized and aligned
+     * storage, typically obtained via sizeOf(). Note that this should be a
+     * deep copy of the constraint, although ownership of the underlying
+     * storage remains with the caller.
+     *
+     * @returns  a pointer to the new constraint.
+     */
+    virtual Constraint * cloneInto(void *) const = 0;
+
+    /**
+     * @brief  Return the number of bytes occupied by a concrete constraint.
+     */
+    virtual size_t sizeOf() const = 0;
+
 };
 
 } // namespace constraints
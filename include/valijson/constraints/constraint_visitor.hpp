@@ -11,6 +11,7 @@ class ContainsConstraint;
 class DependenciesConstraint;
 class EnumConstraint;
 class FormatConstraint;
+class FusedObjectConstraint;
 class LinearItemsConstraint;
 class MaxItemsConstraint;
 class MaximumConstraint;
@@ -48,6 +49,7 @@ protected:
     typedef constraints::DependenciesConstraint DependenciesConstraint;
     typedef constraints::EnumConstraint EnumConstraint;
     typedef constraints::FormatConstraint FormatConstraint;
+    typedef constraints::FusedObjectConstraint FusedObjectConstraint;
     typedef constraints::LinearItemsConstraint LinearItemsConstraint;
     typedef constraints::MaximumConstraint MaximumConstraint;
     typedef constraints::MaxItemsConstraint MaxItemsConstraint;
@@ -80,6 +82,7 @@ public:
     virtual bool visit(const DependenciesConstraint &) = 0;
     virtual bool visit(const EnumConstraint &) = 0;
     virtual bool visit(const FormatConstraint &) = 0;
+    virtual bool visit(const FusedObjectConstraint &) = 0;
     virtual bool visit(const LinearItemsConstraint &) = 0;
     virtual bool visit(const MaximumConstraint &) = 0;
     virtual bool visit(const MaxItemsConstraint &) = 0;
@@ -0,0 +1,435 @@
+/**
+ * @file
+ *
+ * @brief   Shareable cache of fetched remote documents
+ *
+ * SchemaParser resolves remote JSON References by invoking a user-provided
+ * fetch function, and by default remembers fetched documents only for the
+ * duration of a single populateSchema call. SharedDocumentCache allows the
+ * fetched documents to be kept across calls, so that many schemas referring
+ * to the same remote targets - a meta-schema, or a registry of common
+ * definitions - trigger a single fetch each.
+ *
+ * The cache is thread-safe, bounds its size with least-recently-used
+ * eviction, and maintains hit/miss counters so that cache effectiveness can
+ * be monitored. Documents that are in use by an in-flight populateSchema
+ * call are pinned and will not be evicted until that call completes.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <list>
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <valijson/internal/adapter.hpp>
+#include <valijson/exceptions.hpp>
+
+namespace valijson {
+
+/**
+ * @brief   Thread-safe LRU cache of fetched remote documents
+ *
+ * The cache owns the documents it holds: they are fetched through the
+ * function provided at construction, and freed through the corresponding
+ * free function when evicted or when the cache is destroyed. A document is
+ * evicted only when the cache exceeds its capacity and the document is not
+ * pinned by an in-flight parse; the capacity is therefore a target rather
+ * than a hard limit.
+ *
+ * Fetches are performed outside of the cache's lock, with in-flight
+ * requests coalesced: when several parsers ask for the same URI at the
+ * same time, one of them performs the fetch while the others wait for its
+ * result, and fetches of distinct URIs proceed in parallel. Concerns that
+ * belong to the transport itself - connection reuse, TLS session caching,
+ * or an on-disk cache driven by ETag and Cache-Control headers - live in
+ * the fetch function supplied by the caller, which is free to implement
+ * them; the cache guarantees only that it will not issue two concurrent
+ * fetches for the same URI.
+ *
+ * @tparam  AdapterType  Adapter type used to parse the referencing schemas
+ */
+template<typename AdapterType>
+class SharedDocumentCache
+{
+public:
+    typedef typename adapters::AdapterTraits<AdapterType>::DocumentType
+            DocumentType;
+
+    /// Function used to fetch a remote document by URI
+    typedef std::function<const DocumentType* (const std::string &uri)>
+            FetchDocFn;
+
+    /// Function used to free a fetched document
+    typedef std::function<void (const DocumentType *)> FreeDocFn;
+
+    /**
+     * @brief  Construct a cache around a pair of fetch/free functions
+     *
+     * @param  fetchDoc      function used to fetch remote documents
+     * @param  freeDoc       function used to free fetched documents
+     * @param  maxDocuments  number of documents to retain before evicting
+     *                       the least recently used, or 0 for no bound
+     */
+    SharedDocumentCache(FetchDocFn fetchDoc, FreeDocFn freeDoc,
+            size_t maxDocuments = 0)
+      : m_fetchDoc(fetchDoc),
+        m_freeDoc(freeDoc),
+        m_maxDocuments(maxDocuments),
+        m_hits(0),
+        m_misses(0)
+    {
+        if (!m_fetchDoc || !m_freeDoc) {
+            throwRuntimeError("SharedDocumentCache requires both a fetch "
+                    "function and a free function");
+        }
+    }
+
+    SharedDocumentCache(const SharedDocumentCache &) = delete;
+    SharedDocumentCache & operator=(const SharedDocumentCache &) = delete;
+
+    ~SharedDocumentCache()
+    {
+        for (const typename EntryMap::value_type &entry : m_entries) {
+            m_freeDoc(entry.second.document);
+        }
+    }
+
+    /**
+     * @brief  Fetch a document through the cache and pin it
+     *
+     * Returns the cached document for the given URI, fetching it on a cache
+     * miss. The document's pin count is incremented and must be balanced by
+     * a call to release() once the document is no longer in use; pinned
+     * documents are never evicted.
+     *
+     * The fetch itself runs outside of the cache's lock. If another caller
+     * is already fetching the same URI, this call waits for that fetch to
+     * complete rather than issuing a duplicate request.
+     *
+     * @param  uri  URI of the document to fetch
+     *
+     * @returns  pointer to the fetched document, or nullptr if the fetch
+     *           function failed to provide one
+     */
+    const DocumentType * acquire(const std::string &uri)
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+
+        while (true) {
+            const typename EntryMap::iterator itr = m_entries.find(uri);
+            if (itr != m_entries.end()) {
+                m_hits++;
+                itr->second.pinCount++;
+                touch(itr);
+                return itr->second.document;
+            }
+
+            if (m_inFlight.find(uri) == m_inFlight.end()) {
+                break;
+            }
+
+            // Another caller is already fetching this URI; wait for it to
+            // finish, then re-check the cache. If that fetch failed, this
+            // caller falls through and retries the fetch itself.
+            m_fetchComplete.wait(lock);
+        }
+
+        m_misses++;
+        m_inFlight.insert(uri);
+        lock.unlock();
+
+        const DocumentType *document = nullptr;
+#if VALIJSON_USE_EXCEPTIONS
+        try {
+#endif
+            document = m_fetchDoc(uri);
+#if VALIJSON_USE_EXCEPTIONS
+        } catch (...) {
+            lock.lock();
+            m_inFlight.erase(uri);
+            m_fetchComplete.notify_all();
+            throw;
+        }
+#endif
+
+        lock.lock();
+        m_inFlight.erase(uri);
+        m_fetchComplete.notify_all();
+
+        if (document == nullptr) {
+            return nullptr;
+        }
+
+        m_recentUris.push_front(uri);
+        Entry entry;
+        entry.document = document;
+        entry.pinCount = 1;
+        entry.recentPosition = m_recentUris.begin();
+        m_documents[document] = m_entries.insert(
+                typename EntryMap::value_type(uri, entry)).first;
+
+        evictIfNeeded();
+
+        return document;
+    }
+
+    /**
+     * @brief  Unpin a document previously returned by acquire()
+     *
+     * Once a document's pin count drops to zero it becomes eligible for
+     * eviction; if the cache is over capacity, the least recently used
+     * unpinned documents are evicted immediately.
+     *
+     * @param  document  document to unpin
+     */
+    void release(const DocumentType *document)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        const typename DocumentMap::iterator itr = m_documents.find(document);
+        if (itr == m_documents.end() || itr->second->second.pinCount == 0) {
+            throwRuntimeError("SharedDocumentCache::release called for a "
+                    "document that is not pinned");
+        }
+
+        itr->second->second.pinCount--;
+
+        evictIfNeeded();
+    }
+
+    /**
+     * @brief  Fetch a set of documents concurrently, without pinning them
+     *
+     * URIs that are already present in the cache, or already being fetched
+     * by another caller, are skipped; the remainder
+     * are fetched across up to \c maxConcurrentFetches threads, outside of
+     * the cache's lock, and inserted as the fetches complete. This is
+     * intended for warming the cache ahead of a parse, so that the
+     * subsequent on-demand acquire() calls are hits.
+     *
+     * Unlike acquire(), documents fetched this way are not pinned, so they
+     * are immediately eligible for eviction if the cache is over capacity.
+     * If any fetch throws, the remaining fetches are completed or abandoned,
+     * successfully fetched documents are retained, and the first exception
+     * is rethrown.
+     *
+     * @param  uris                 URIs of the documents to fetch
+     * @param  maxConcurrentFetches maximum number of fetches in flight
+     *
+     * @returns  the newly fetched documents, as URI/document pairs
+     */
+    std::vector<std::pair<std::string, const DocumentType *>> prefetch(
+            const std::vector<std::string> &uris, size_t maxConcurrentFetches)
+    {
+        // Determine which URIs actually need to be fetched, skipping any
+        // that are already being fetched elsewhere, and mark the remainder
+        // as in flight so that concurrent acquire() calls wait for the
+        // prefetch instead of duplicating its requests
+        std::vector<std::string> pending;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            for (const std::string &uri : uris) {
+                if (m_entries.find(uri) == m_entries.end() &&
+                        m_inFlight.find(uri) == m_inFlight.end() &&
+                        std::find(pending.begin(), pending.end(), uri) ==
+                                pending.end()) {
+                    pending.push_back(uri);
+                    m_inFlight.insert(uri);
+                }
+            }
+        }
+
+        std::vector<std::pair<std::string, const DocumentType *>> fetched;
+        if (pending.empty()) {
+            return fetched;
+        }
+
+        std::vector<const DocumentType *> documents(pending.size(), nullptr);
+        std::atomic<size_t> cursor(0);
+        std::exception_ptr firstException = nullptr;
+        std::mutex exceptionMutex;
+
+        const auto worker = [&]() {
+            while (true) {
+                const size_t index = cursor.fetch_add(1);
+                if (index >= pending.size()) {
+                    return;
+                }
+#if VALIJSON_USE_EXCEPTIONS
+                try {
+#endif
+                    documents[index] = m_fetchDoc(pending[index]);
+#if VALIJSON_USE_EXCEPTIONS
+                } catch (...) {
+                    std::lock_guard<std::mutex> lock(exceptionMutex);
+                    if (!firstException) {
+                        firstException = std::current_exception();
+                    }
+                }
+#endif
+            }
+        };
+
+        const size_t numThreads = std::min(
+                maxConcurrentFetches == 0 ? size_t(1) : maxConcurrentFetches,
+                pending.size());
+        std::vector<std::thread> threads;
+        threads.reserve(numThreads - 1);
+        for (size_t i = 1; i < numThreads; i++) {
+            threads.emplace_back(worker);
+        }
+        worker();
+        for (std::thread &thread : threads) {
+            thread.join();
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            for (size_t i = 0; i < pending.size(); i++) {
+                m_inFlight.erase(pending[i]);
+
+                if (documents[i] == nullptr) {
+                    continue;
+                }
+
+                if (m_entries.find(pending[i]) != m_entries.end()) {
+                    // Defensive: the in-flight set should prevent this URI
+                    // from being fetched elsewhere while the prefetch runs
+                    m_freeDoc(documents[i]);
+                    continue;
+                }
+
+                m_misses++;
+                m_recentUris.push_front(pending[i]);
+                Entry entry;
+                entry.document = documents[i];
+                entry.pinCount = 0;
+                entry.recentPosition = m_recentUris.begin();
+                m_documents[documents[i]] = m_entries.insert(
+                        typename EntryMap::value_type(pending[i], entry)).first;
+                fetched.push_back(std::make_pair(pending[i], documents[i]));
+            }
+
+            evictIfNeeded();
+        }
+        m_fetchComplete.notify_all();
+
+#if VALIJSON_USE_EXCEPTIONS
+        if (firstException) {
+            std::rethrow_exception(firstException);
+        }
+#endif
+
+        return fetched;
+    }
+
+    /// Number of acquire() calls satisfied without fetching
+    size_t hits() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_hits;
+    }
+
+    /// Number of acquire() calls that required a fetch
+    size_t misses() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_misses;
+    }
+
+    /// Number of documents currently held by the cache
+    size_t size() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_entries.size();
+    }
+
+private:
+    struct Entry;
+
+    typedef std::map<std::string, Entry> EntryMap;
+
+    /// Index from document pointer back to its cache entry, used by release()
+    typedef std::map<const DocumentType *,
+            typename EntryMap::iterator> DocumentMap;
+
+    struct Entry
+    {
+        /// Fetched document owned by the cache
+        const DocumentType *document;
+
+        /// Number of in-flight parses using this document
+        size_t pinCount;
+
+        /// Position of this entry's URI in the recency list
+        std::list<std::string>::iterator recentPosition;
+    };
+
+    /// Move an entry to the front of the recency list
+    void touch(const typename EntryMap::iterator &itr)
+    {
+        m_recentUris.splice(m_recentUris.begin(), m_recentUris,
+                itr->second.recentPosition);
+    }
+
+    /// Evict least recently used unpinned documents while over capacity
+    void evictIfNeeded()
+    {
+        if (m_maxDocuments == 0) {
+            return;
+        }
+
+        typename std::list<std::string>::reverse_iterator ritr =
+                m_recentUris.rbegin();
+        while (m_entries.size() > m_maxDocuments &&
+                ritr != m_recentUris.rend()) {
+            const typename EntryMap::iterator itr = m_entries.find(*ritr);
+            if (itr->second.pinCount > 0) {
+                ++ritr;
+                continue;
+            }
+
+            const DocumentType *document = itr->second.document;
+            ritr = typename std::list<std::string>::reverse_iterator(
+                    m_recentUris.erase(itr->second.recentPosition));
+            m_documents.erase(document);
+            m_entries.erase(itr);
+            m_freeDoc(document);
+        }
+    }
+
+    const FetchDocFn m_fetchDoc;
+    const FreeDocFn m_freeDoc;
+    const size_t m_maxDocuments;
+
+    mutable std::mutex m_mutex;
+
+    /// Signalled whenever an in-flight fetch completes
+    std::condition_variable m_fetchComplete;
+
+    EntryMap m_entries;
+    DocumentMap m_documents;
+
+    /// URIs currently being fetched outside of the lock
+    std::set<std::string> m_inFlight;
+
+    /// URIs ordered from most to least recently used
+    std::list<std::string> m_recentUris;
+
+    size_t m_hits;
+    size_t m_misses;
+};
+
+}  // namespace valijson
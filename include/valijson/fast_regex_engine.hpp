@@ -0,0 +1,874 @@
+#pragma once
+
+#include <cstdint>
+#include <regex>
+#include <string>
+#include <vector>
+
+namespace valijson {
+
+/**
+ * @brief  Linear-time regular expression engine for 'pattern' constraints
+ *
+ * std::regex uses a backtracking matcher whose running time can grow
+ * exponentially in the length of the target string, and whose construction
+ * cost is high. This engine compiles the restricted ECMA-262 subset that
+ * JSON Schema patterns typically use into a Thompson NFA, and evaluates it
+ * with a Pike-style virtual machine whose running time is bounded by
+ * O(pattern size * target length) regardless of the pattern.
+ *
+ * The supported subset covers literals, '.', character classes (including
+ * ranges, negation and the \d \D \w \W \s \S shorthands), the ^ and $
+ * anchors, the * + ? and {m,n} quantifiers, alternation, and capturing or
+ * non-capturing groups. Patterns that use constructs outside this subset,
+ * such as backreferences or lookaround assertions, fall back transparently
+ * to std::regex, so every pattern that the default engine accepts remains
+ * supported.
+ *
+ * The engine satisfies the same concept as DefaultRegexEngine, so it can be
+ * selected via the regular expression engine template parameter:
+ *
+ * @code
+ * using FastValidator = valijson::ValidatorT<valijson::FastRegexEngine>;
+ * @endcode
+ */
+class FastRegexEngine
+{
+public:
+    /**
+     * @brief  Compile a regular expression
+     *
+     * Throws the same std::regex_error as DefaultRegexEngine if the pattern
+     * is not a valid ECMAScript regular expression.
+     *
+     * @param  pattern  ECMA-262 regular expression to compile
+     */
+    FastRegexEngine(const std::string &pattern)
+    {
+        Compiler compiler(pattern);
+        if (compiler.compile(m_program, m_classes)) {
+            m_useFallback = false;
+        } else {
+            // Outside the supported subset; std::regex also reports invalid
+            // patterns for us by throwing std::regex_error here
+            m_useFallback = true;
+            m_fallback = std::regex(pattern);
+        }
+    }
+
+    /**
+     * @brief   Search for a match anywhere within a target string
+     *
+     * @param   s  string to search
+     * @param   r  compiled regular expression to search for
+     *
+     * @returns true if any substring of the target matches, false otherwise
+     */
+    static bool search(const std::string &s, const FastRegexEngine &r)
+    {
+        return search(s.data(), s.size(), r);
+    }
+
+    /**
+     * @brief   Search a character range without materialising a std::string
+     *
+     * @param   data  start of the character range to search
+     * @param   size  number of characters in the range
+     * @param   r     compiled regular expression to search for
+     *
+     * @returns true if any substring of the range matches, false otherwise
+     */
+    static bool search(const char *data, size_t size, const FastRegexEngine &r)
+    {
+        if (r.m_useFallback) {
+            return std::regex_search(data, data + size, r.m_fallback);
+        }
+
+        return r.run(data, size);
+    }
+
+private:
+    /// Bitmap over the 256 possible byte values of a target string
+    struct ByteClass
+    {
+        ByteClass()
+          : bits() { }
+
+        void set(unsigned char c)
+        {
+            bits[c >> 6] |= (uint64_t(1) << (c & 63));
+        }
+
+        void setRange(unsigned char lo, unsigned char hi)
+        {
+            for (unsigned int c = lo; c <= hi; c++) {
+                set(static_cast<unsigned char>(c));
+            }
+        }
+
+        bool test(unsigned char c) const
+        {
+            return (bits[c >> 6] >> (c & 63)) & 1;
+        }
+
+        void negate()
+        {
+            for (uint64_t &word : bits) {
+                word = ~word;
+            }
+        }
+
+        uint64_t bits[4];
+    };
+
+    /// Single instruction of the compiled NFA program
+    struct Instruction
+    {
+        enum OpCode : uint8_t
+        {
+            kChar,      ///< consume one byte matching the class in 'x'
+            kSplit,     ///< continue at both 'x' and 'y'
+            kJump,      ///< continue at 'x'
+            kBegin,     ///< match only at the start of the target
+            kEnd,       ///< match only at the end of the target
+            kMatch      ///< accept
+        };
+
+        OpCode op;
+        uint32_t x;
+        uint32_t y;
+    };
+
+    /**
+     * @brief  Compiles the supported pattern subset to an NFA program
+     *
+     * The pattern is first parsed into a small syntax tree, from which the
+     * program is emitted. Going via a tree keeps counted repetition simple:
+     * '{m,n}' is compiled by emitting its operand multiple times, which
+     * would be awkward to do by splicing already-emitted instructions.
+     */
+    class Compiler
+    {
+    public:
+        Compiler(const std::string &pattern)
+          : m_pattern(pattern),
+            m_pos(0),
+            m_failed(false) { }
+
+        /**
+         * @brief   Attempt to compile the pattern
+         *
+         * @param   program  vector to receive the compiled instructions
+         * @param   classes  vector to receive the referenced byte classes
+         *
+         * @returns true if the pattern lies within the supported subset,
+         *          false if the caller should fall back to std::regex
+         */
+        bool compile(std::vector<Instruction> &program,
+                std::vector<ByteClass> &classes)
+        {
+            const uint32_t root = parseAlternation();
+            if (m_failed || m_pos != m_pattern.size()) {
+                return false;
+            }
+
+            emit(root, program);
+            if (m_failed) {
+                return false;
+            }
+
+            const Instruction match = { Instruction::kMatch, 0, 0 };
+            program.push_back(match);
+            classes.swap(m_classes);
+            return true;
+        }
+
+    private:
+        /// Upper bound on the emitted program size, to keep the expansion
+        /// of nested counted repetitions in check
+        static const size_t kMaxProgramSize = 4096;
+
+        /// Syntax tree node; children are indices into m_nodes
+        struct Node
+        {
+            enum Kind : uint8_t
+            {
+                kEmpty,     ///< matches the empty string
+                kChar,      ///< byte class, index in 'arg'
+                kBegin,     ///< '^' anchor
+                kEnd,       ///< '$' anchor
+                kConcat,    ///< 'left' followed by 'right'
+                kAlt,       ///< 'left' or 'right'
+                kRepeat     ///< 'left' repeated 'min' to 'max' times
+            };
+
+            Kind kind;
+            uint32_t arg;
+            uint32_t left;
+            uint32_t right;
+            uint32_t min;
+            uint32_t max;   ///< kUnbounded for open-ended repetition
+        };
+
+        static const uint32_t kUnbounded = 0xffffffffu;
+        static const uint32_t kInvalidNode = 0xffffffffu;
+
+        uint32_t addNode(Node::Kind kind)
+        {
+            Node node = { kind, 0, kInvalidNode, kInvalidNode, 0, 0 };
+            m_nodes.push_back(node);
+            return static_cast<uint32_t>(m_nodes.size() - 1);
+        }
+
+        uint32_t fail()
+        {
+            m_failed = true;
+            return kInvalidNode;
+        }
+
+        bool atEnd() const
+        {
+            return m_pos >= m_pattern.size();
+        }
+
+        char peek() const
+        {
+            return m_pattern[m_pos];
+        }
+
+        // --- Parsing ---
+
+        uint32_t parseAlternation()
+        {
+            uint32_t left = parseConcatenation();
+            while (!m_failed && !atEnd() && peek() == '|') {
+                m_pos++;
+                const uint32_t right = parseConcatenation();
+                const uint32_t alt = addNode(Node::kAlt);
+                m_nodes[alt].left = left;
+                m_nodes[alt].right = right;
+                left = alt;
+            }
+
+            return left;
+        }
+
+        uint32_t parseConcatenation()
+        {
+            uint32_t left = addNode(Node::kEmpty);
+            while (!m_failed && !atEnd() && peek() != '|' && peek() != ')') {
+                const uint32_t right = parseRepetition();
+                const uint32_t cat = addNode(Node::kConcat);
+                m_nodes[cat].left = left;
+                m_nodes[cat].right = right;
+                left = cat;
+            }
+
+            return left;
+        }
+
+        uint32_t parseRepetition()
+        {
+            const uint32_t atom = parseAtom();
+            if (m_failed || atEnd()) {
+                return atom;
+            }
+
+            uint32_t min = 0;
+            uint32_t max = 0;
+            const char c = peek();
+            if (c == '*') {
+                min = 0;
+                max = kUnbounded;
+                m_pos++;
+            } else if (c == '+') {
+                min = 1;
+                max = kUnbounded;
+                m_pos++;
+            } else if (c == '?') {
+                min = 0;
+                max = 1;
+                m_pos++;
+            } else if (c == '{') {
+                if (!parseBounds(min, max)) {
+                    // An unmatched '{' is treated as a literal by some
+                    // grammars and rejected by others; defer to std::regex
+                    return fail();
+                }
+            } else {
+                return atom;
+            }
+
+            // A lazy quantifier only affects which match is preferred, not
+            // whether a match exists, so the modifier can be ignored here
+            if (!atEnd() && peek() == '?') {
+                m_pos++;
+            }
+
+            const uint32_t repeat = addNode(Node::kRepeat);
+            m_nodes[repeat].left = atom;
+            m_nodes[repeat].min = min;
+            m_nodes[repeat].max = max;
+            return repeat;
+        }
+
+        bool parseBounds(uint32_t &min, uint32_t &max)
+        {
+            size_t p = m_pos + 1;
+            uint32_t lo = 0;
+            if (!parseDecimal(p, lo)) {
+                return false;
+            }
+
+            uint32_t hi = lo;
+            if (p < m_pattern.size() && m_pattern[p] == ',') {
+                p++;
+                if (p < m_pattern.size() && m_pattern[p] == '}') {
+                    hi = kUnbounded;
+                } else if (!parseDecimal(p, hi) || hi < lo) {
+                    return false;
+                }
+            }
+
+            if (p >= m_pattern.size() || m_pattern[p] != '}') {
+                return false;
+            }
+
+            m_pos = p + 1;
+            min = lo;
+            max = hi;
+            return true;
+        }
+
+        bool parseDecimal(size_t &p, uint32_t &value)
+        {
+            if (p >= m_pattern.size() || !isDigit(m_pattern[p])) {
+                return false;
+            }
+
+            uint64_t result = 0;
+            while (p < m_pattern.size() && isDigit(m_pattern[p])) {
+                result = result * 10 + (m_pattern[p] - '0');
+                if (result > kMaxProgramSize) {
+                    // The expansion would exceed the program size limit
+                    // anyway, so reject the bounds before they overflow
+                    return false;
+                }
+                p++;
+            }
+
+            value = static_cast<uint32_t>(result);
+            return true;
+        }
+
+        uint32_t parseAtom()
+        {
+            if (atEnd()) {
+                return addNode(Node::kEmpty);
+            }
+
+            const char c = peek();
+            if (c == '^') {
+                m_pos++;
+                return addNode(Node::kBegin);
+            } else if (c == '$') {
+                m_pos++;
+                return addNode(Node::kEnd);
+            } else if (c == '(') {
+                return parseGroup();
+            } else if (c == '[') {
+                return parseCharClass();
+            } else if (c == '.') {
+                m_pos++;
+                // ECMA-262 '.' matches any character other than a line
+                // terminator
+                ByteClass cls;
+                cls.negate();
+                cls.bits[0] &= ~((uint64_t(1) << '\n') | (uint64_t(1) << '\r'));
+                return addCharNode(cls);
+            } else if (c == '\\') {
+                return parseEscape();
+            } else if (c == '*' || c == '+' || c == '?' || c == ')') {
+                // A quantifier with nothing to repeat, or a stray ')'
+                return fail();
+            }
+
+            m_pos++;
+            ByteClass cls;
+            cls.set(static_cast<unsigned char>(c));
+            return addCharNode(cls);
+        }
+
+        uint32_t parseGroup()
+        {
+            m_pos++;  // consume '('
+            if (!atEnd() && peek() == '?') {
+                if (m_pos + 1 < m_pattern.size() &&
+                        m_pattern[m_pos + 1] == ':') {
+                    m_pos += 2;
+                } else {
+                    // Lookaround assertions and named groups are outside
+                    // the supported subset
+                    return fail();
+                }
+            }
+
+            const uint32_t body = parseAlternation();
+            if (m_failed || atEnd() || peek() != ')') {
+                return fail();
+            }
+
+            m_pos++;  // consume ')'
+            return body;
+        }
+
+        uint32_t parseCharClass()
+        {
+            m_pos++;  // consume '['
+            ByteClass cls;
+            bool negated = false;
+            if (!atEnd() && peek() == '^') {
+                negated = true;
+                m_pos++;
+            }
+
+            // ECMA-262 reads a ']' in first position as closing the class -
+            // '[]' is an empty class that never matches - where the POSIX
+            // grammar would read it as a literal. The construct is outside
+            // the supported subset, so it is left to the std::regex fallback
+            // rather than matched with the wrong semantics here.
+            if (!atEnd() && peek() == ']') {
+                return fail();
+            }
+
+            while (!atEnd() && peek() != ']') {
+                bool singleByte = false;
+                unsigned char lo = 0;
+                if (peek() == '\\') {
+                    if (!parseClassEscape(cls, singleByte, lo)) {
+                        return fail();
+                    }
+                } else {
+                    lo = static_cast<unsigned char>(peek());
+                    m_pos++;
+                    singleByte = true;
+                }
+
+                if (singleByte && !atEnd() && peek() == '-' &&
+                        m_pos + 1 < m_pattern.size() &&
+                        m_pattern[m_pos + 1] != ']') {
+                    m_pos++;  // consume '-'
+                    unsigned char hi = 0;
+                    bool hiSingle = false;
+                    if (peek() == '\\') {
+                        if (!parseClassEscape(cls, hiSingle, hi) ||
+                                !hiSingle) {
+                            return fail();
+                        }
+                    } else {
+                        hi = static_cast<unsigned char>(peek());
+                        m_pos++;
+                    }
+
+                    if (hi < lo) {
+                        return fail();
+                    }
+
+                    cls.setRange(lo, hi);
+                } else if (singleByte) {
+                    cls.set(lo);
+                }
+            }
+
+            if (atEnd()) {
+                return fail();
+            }
+
+            m_pos++;  // consume ']'
+            if (negated) {
+                cls.negate();
+            }
+
+            return addCharNode(cls);
+        }
+
+        /**
+         * @brief   Handle an escape sequence inside a character class
+         *
+         * Shorthand classes are merged into the class directly; single-byte
+         * escapes are reported through the out-parameters so the caller can
+         * use them as the endpoint of a range.
+         */
+        bool parseClassEscape(ByteClass &cls, bool &singleByte,
+                unsigned char &byte)
+        {
+            m_pos++;  // consume '\\'
+            if (atEnd()) {
+                return false;
+            }
+
+            const char c = peek();
+            if (c == 'd' || c == 'D' || c == 'w' || c == 'W' || c == 's' ||
+                    c == 'S') {
+                ByteClass shorthand;
+                addShorthand(shorthand, c);
+                for (int i = 0; i < 4; i++) {
+                    cls.bits[i] |= shorthand.bits[i];
+                }
+                singleByte = false;
+                m_pos++;
+                return true;
+            }
+
+            if (c == 'b') {
+                // Inside a class, '\b' is a backspace rather than a word
+                // boundary assertion
+                singleByte = true;
+                byte = 0x08;
+                m_pos++;
+                return true;
+            }
+
+            return parseSingleByteEscape(singleByte, byte);
+        }
+
+        uint32_t parseEscape()
+        {
+            m_pos++;  // consume '\\'
+            if (atEnd()) {
+                return fail();
+            }
+
+            const char c = peek();
+            if (c == 'd' || c == 'D' || c == 'w' || c == 'W' || c == 's' ||
+                    c == 'S') {
+                ByteClass cls;
+                addShorthand(cls, c);
+                m_pos++;
+                return addCharNode(cls);
+            }
+
+            bool singleByte = false;
+            unsigned char byte = 0;
+            if (!parseSingleByteEscape(singleByte, byte) || !singleByte) {
+                // Backreferences, word boundaries, \u escapes and other
+                // constructs we do not implement
+                return fail();
+            }
+
+            ByteClass cls;
+            cls.set(byte);
+            return addCharNode(cls);
+        }
+
+        /**
+         * @brief  Handle the escape sequences that denote a single byte
+         *
+         * Control escapes, '\xHH', '\0' and escaped punctuation are
+         * supported; anything else (including '\uXXXX', whose code points
+         * map to multi-byte UTF-8 sequences) is left to std::regex.
+         */
+        bool parseSingleByteEscape(bool &singleByte, unsigned char &byte)
+        {
+            const char c = peek();
+            switch (c) {
+            case 'n': byte = '\n'; break;
+            case 'r': byte = '\r'; break;
+            case 't': byte = '\t'; break;
+            case 'f': byte = '\f'; break;
+            case 'v': byte = '\v'; break;
+            case '0': byte = '\0'; break;
+            case 'x': {
+                if (m_pos + 2 >= m_pattern.size() ||
+                        !isHexDigit(m_pattern[m_pos + 1]) ||
+                        !isHexDigit(m_pattern[m_pos + 2])) {
+                    return false;
+                }
+                byte = static_cast<unsigned char>(
+                        hexValue(m_pattern[m_pos + 1]) * 16 +
+                        hexValue(m_pattern[m_pos + 2]));
+                m_pos += 3;
+                singleByte = true;
+                return true;
+            }
+            default:
+                if (isDigit(c) || isWordChar(c)) {
+                    // An alphanumeric escape we do not recognise
+                    return false;
+                }
+                byte = static_cast<unsigned char>(c);
+                break;
+            }
+
+            m_pos++;
+            singleByte = true;
+            return true;
+        }
+
+        static void addShorthand(ByteClass &cls, char shorthand)
+        {
+            switch (shorthand) {
+            case 'd':
+            case 'D':
+                cls.setRange('0', '9');
+                break;
+            case 'w':
+            case 'W':
+                cls.setRange('0', '9');
+                cls.setRange('A', 'Z');
+                cls.setRange('a', 'z');
+                cls.set('_');
+                break;
+            case 's':
+            case 'S':
+                cls.set(' ');
+                cls.set('\t');
+                cls.set('\n');
+                cls.set('\r');
+                cls.set('\f');
+                cls.set('\v');
+                break;
+            default:
+                break;
+            }
+
+            if (shorthand == 'D' || shorthand == 'W' || shorthand == 'S') {
+                cls.negate();
+            }
+        }
+
+        uint32_t addCharNode(const ByteClass &cls)
+        {
+            const uint32_t node = addNode(Node::kChar);
+            m_nodes[node].arg = static_cast<uint32_t>(m_classes.size());
+            m_classes.push_back(cls);
+            return node;
+        }
+
+        static bool isDigit(char c)
+        {
+            return c >= '0' && c <= '9';
+        }
+
+        static bool isWordChar(char c)
+        {
+            return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') ||
+                    c == '_';
+        }
+
+        static bool isHexDigit(char c)
+        {
+            return isDigit(c) || (c >= 'a' && c <= 'f') ||
+                    (c >= 'A' && c <= 'F');
+        }
+
+        static int hexValue(char c)
+        {
+            if (isDigit(c)) {
+                return c - '0';
+            }
+
+            return (c >= 'a' ? c - 'a' : c - 'A') + 10;
+        }
+
+        // --- Code generation ---
+
+        void emit(uint32_t nodeIndex, std::vector<Instruction> &program)
+        {
+            if (m_failed) {
+                return;
+            } else if (program.size() > kMaxProgramSize) {
+                m_failed = true;
+                return;
+            }
+
+            const Node node = m_nodes[nodeIndex];
+            switch (node.kind) {
+            case Node::kEmpty:
+                break;
+            case Node::kChar: {
+                const Instruction ins = { Instruction::kChar, node.arg, 0 };
+                program.push_back(ins);
+                break;
+            }
+            case Node::kBegin: {
+                const Instruction ins = { Instruction::kBegin, 0, 0 };
+                program.push_back(ins);
+                break;
+            }
+            case Node::kEnd: {
+                const Instruction ins = { Instruction::kEnd, 0, 0 };
+                program.push_back(ins);
+                break;
+            }
+            case Node::kConcat:
+                emit(node.left, program);
+                emit(node.right, program);
+                break;
+            case Node::kAlt: {
+                const size_t split = program.size();
+                const Instruction ins = { Instruction::kSplit, 0, 0 };
+                program.push_back(ins);
+                program[split].x = static_cast<uint32_t>(program.size());
+                emit(node.left, program);
+                const size_t jump = program.size();
+                const Instruction jmp = { Instruction::kJump, 0, 0 };
+                program.push_back(jmp);
+                program[split].y = static_cast<uint32_t>(program.size());
+                emit(node.right, program);
+                program[jump].x = static_cast<uint32_t>(program.size());
+                break;
+            }
+            case Node::kRepeat:
+                emitRepeat(node, program);
+                break;
+            }
+        }
+
+        void emitRepeat(const Node &node, std::vector<Instruction> &program)
+        {
+            // Mandatory copies
+            for (uint32_t i = 0; i < node.min && !m_failed; i++) {
+                emit(node.left, program);
+            }
+
+            if (m_failed) {
+                return;
+            }
+
+            if (node.max == kUnbounded) {
+                // Loop: split(body, out); body; jump(split)
+                const size_t split = program.size();
+                const Instruction ins = { Instruction::kSplit, 0, 0 };
+                program.push_back(ins);
+                program[split].x = static_cast<uint32_t>(program.size());
+                emit(node.left, program);
+                const Instruction jmp = { Instruction::kJump,
+                        static_cast<uint32_t>(split), 0 };
+                program.push_back(jmp);
+                program[split].y = static_cast<uint32_t>(program.size());
+                return;
+            }
+
+            // Optional copies, each of which may skip past all that follow
+            std::vector<size_t> exits;
+            for (uint32_t i = node.min; i < node.max && !m_failed; i++) {
+                const size_t split = program.size();
+                const Instruction ins = { Instruction::kSplit, 0, 0 };
+                program.push_back(ins);
+                program[split].x = static_cast<uint32_t>(program.size());
+                exits.push_back(split);
+                emit(node.left, program);
+            }
+
+            for (const size_t split : exits) {
+                program[split].y = static_cast<uint32_t>(program.size());
+            }
+        }
+
+        const std::string &m_pattern;
+        size_t m_pos;
+        bool m_failed;
+        std::vector<Node> m_nodes;
+        std::vector<ByteClass> m_classes;
+    };
+
+    /**
+     * @brief   Run the compiled program against a target string
+     *
+     * Implements an unanchored search by seeding a thread at the start of
+     * the program for every position in the target. Each thread list holds
+     * at most one thread per instruction, which bounds the total work by
+     * the product of the program and target sizes.
+     */
+    bool run(const char *s, size_t length) const
+    {
+        const size_t numInstructions = m_program.size();
+        std::vector<uint32_t> seen(numInstructions, 0);
+        std::vector<uint32_t> current, next;
+        current.reserve(numInstructions);
+        next.reserve(numInstructions);
+
+        uint32_t generation = 0;
+        for (size_t pos = 0; pos <= length; pos++) {
+            generation++;
+            // Seed a new attempt starting at this position
+            if (!addThread(current, seen, generation, 0, pos, length)) {
+                return true;
+            }
+
+            generation++;
+            next.clear();
+            for (const uint32_t pc : current) {
+                // Only kChar instructions survive epsilon closure
+                const Instruction &ins = m_program[pc];
+                if (pos < length && m_classes[ins.x].test(
+                        static_cast<unsigned char>(s[pos]))) {
+                    if (!addThread(next, seen, generation, pc + 1, pos + 1,
+                            length)) {
+                        return true;
+                    }
+                }
+            }
+
+            current.swap(next);
+        }
+
+        return false;
+    }
+
+    /**
+     * @brief   Add a thread to a thread list, following epsilon transitions
+     *
+     * @returns false if a kMatch instruction was reached, true otherwise
+     */
+    bool addThread(std::vector<uint32_t> &list, std::vector<uint32_t> &seen,
+            uint32_t generation, uint32_t pc, size_t pos,
+            size_t length) const
+    {
+        if (seen[pc] == generation) {
+            return true;
+        }
+
+        seen[pc] = generation;
+        const Instruction &ins = m_program[pc];
+        switch (ins.op) {
+        case Instruction::kChar:
+            list.push_back(pc);
+            return true;
+        case Instruction::kSplit:
+            return addThread(list, seen, generation, ins.x, pos, length) &&
+                    addThread(list, seen, generation, ins.y, pos, length);
+        case Instruction::kJump:
+            return addThread(list, seen, generation, ins.x, pos, length);
+        case Instruction::kBegin:
+            if (pos != 0) {
+                return true;
+            }
+            return addThread(list, seen, generation, pc + 1, pos, length);
+        case Instruction::kEnd:
+            if (pos != length) {
+                return true;
+            }
+            return addThread(list, seen, generation, pc + 1, pos, length);
+        case Instruction::kMatch:
+            return false;
+        }
+
+        return true;
+    }
+
+    /// Compiled NFA program; empty when the fallback engine is in use
+    std::vector<Instruction> m_program;
+
+    /// Byte classes referenced by kChar instructions
+    std::vector<ByteClass> m_classes;
+
+    /// Whether pattern matching is delegated to std::regex
+    bool m_useFallback;
+
+    /// Fallback engine for patterns outside the supported subset
+    std::regex m_fallback;
+};
+
+}  // namespace valijson
@@ -0,0 +1,568 @@
+/**
+ * @file
+ *
+ * @brief   Pluggable registry of 'format' checkers with fast built-ins
+ *
+ * Until now only the 'date', 'time' and 'date-time' formats were validated,
+ * each by compiling and running a std::regex, and every other format was
+ * accepted unchecked - pushing validation of common formats such as 'uuid'
+ * or 'email' into application code. This file provides hand-rolled checkers
+ * for the formats that appear most often in real schemas, built on a single
+ * table-driven character classifier rather than regular expressions, and a
+ * process-wide registry through which applications can add checkers for
+ * their own formats.
+ *
+ * A checker is resolved when a FormatConstraint is populated, so custom
+ * checkers should be registered before schemas are parsed or deserialized.
+ * Formats with no registered checker continue to be treated as annotations
+ * and accepted unchecked.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <map>
+#include <mutex>
+#include <string>
+
+namespace valijson {
+
+/// Typedef for a function that checks a string against a 'format'
+typedef bool (*FormatChecker)(const char *data, size_t size);
+
+namespace internal {
+namespace format {
+
+/**
+ * @brief  Table-driven character classifier shared by the format checkers
+ *
+ * A single 256-entry table maps each byte to a bitmask of the character
+ * classes it belongs to, so checkers test membership with one load and one
+ * mask rather than a chain of comparisons.
+ */
+class CharClassifier
+{
+public:
+    enum CharClass
+    {
+        kDigit = 1u << 0,
+        kHexDigit = 1u << 1,
+        kAlpha = 1u << 2,
+
+        /// Characters allowed in the local part of an email address,
+        /// excluding '.', which needs positional checks
+        kEmailAtom = 1u << 3,
+
+        /// Characters allowed in a URI after the scheme, excluding '%',
+        /// which must introduce a valid percent-encoded octet
+        kUriChar = 1u << 4,
+
+        /// Characters allowed within a hostname label, excluding '-',
+        /// which needs positional checks
+        kHostChar = 1u << 5
+    };
+
+    static bool test(char c, unsigned char charClass)
+    {
+        return (instance().m_table[static_cast<unsigned char>(c)] &
+                charClass) != 0;
+    }
+
+private:
+    CharClassifier()
+    {
+        for (int i = 0; i < 256; i++) {
+            m_table[i] = 0;
+        }
+
+        mark("0123456789", kDigit | kHexDigit | kEmailAtom | kUriChar |
+                kHostChar);
+        mark("abcdefABCDEF", kHexDigit);
+        for (char c = 'a'; c <= 'z'; c++) {
+            markChar(c, kAlpha | kEmailAtom | kUriChar | kHostChar);
+        }
+        for (char c = 'A'; c <= 'Z'; c++) {
+            markChar(c, kAlpha | kEmailAtom | kUriChar | kHostChar);
+        }
+
+        // RFC 5322 atext, minus the alphanumerics marked above
+        mark("!#$%&'*+-/=?^_`{|}~", kEmailAtom);
+
+        // RFC 3986 unreserved, reserved and fragment/query extras, minus
+        // the alphanumerics marked above and the '%' escape introducer
+        mark("-._~:/?#[]@!$&'()*+,;=", kUriChar);
+    }
+
+    void mark(const char *chars, unsigned char charClass)
+    {
+        for (; *chars != '\0'; chars++) {
+            markChar(*chars, charClass);
+        }
+    }
+
+    void markChar(char c, unsigned char charClass)
+    {
+        m_table[static_cast<unsigned char>(c)] |=
+                static_cast<unsigned char>(charClass);
+    }
+
+    static const CharClassifier & instance()
+    {
+        static const CharClassifier classifier;
+        return classifier;
+    }
+
+    unsigned char m_table[256];
+};
+
+/// Parse exactly two digits at an offset, returning the value or -1
+inline int twoDigits(const char *data, size_t size, size_t offset)
+{
+    if (offset + 2 > size ||
+            !CharClassifier::test(data[offset], CharClassifier::kDigit) ||
+            !CharClassifier::test(data[offset + 1], CharClassifier::kDigit)) {
+        return -1;
+    }
+
+    return (data[offset] - '0') * 10 + (data[offset + 1] - '0');
+}
+
+/// Return true if a month and day form a plausible calendar date; February
+/// the 29th is always allowed, since the year may be a leap year
+inline bool plausibleMonthDay(int month, int day)
+{
+    if (month < 1 || month > 12 || day < 1) {
+        return false;
+    }
+
+    if (month == 2) {
+        return day <= 29;
+    }
+
+    const bool longMonth = (month <= 7) ? (month % 2 == 1) : (month % 2 == 0);
+    return day <= (longMonth ? 31 : 30);
+}
+
+/**
+ * @brief  Check an RFC 3339 full-date, e.g. '2022-07-18'
+ *
+ * The year may have any number of digits, for consistency with the regex
+ * this checker replaced.
+ */
+inline bool checkDate(const char *data, size_t size)
+{
+    size_t offset = 0;
+    while (offset < size &&
+            CharClassifier::test(data[offset], CharClassifier::kDigit)) {
+        offset++;
+    }
+    if (offset == 0 || offset + 6 != size || data[offset] != '-' ||
+            data[offset + 3] != '-') {
+        return false;
+    }
+
+    const int month = twoDigits(data, size, offset + 1);
+    const int day = twoDigits(data, size, offset + 4);
+    return plausibleMonthDay(month, day);
+}
+
+/// Check the partial-time and offset portion of an RFC 3339 time, starting
+/// at the given offset, e.g. '16:52:45Z' or '16:52:45.5+02:00'
+inline bool checkTimeAt(const char *data, size_t size, size_t offset)
+{
+    const int hours = twoDigits(data, size, offset);
+    if (hours < 0 || hours > 23 ||
+            offset + 8 > size || data[offset + 2] != ':' ||
+            data[offset + 5] != ':') {
+        return false;
+    }
+
+    const int minutes = twoDigits(data, size, offset + 3);
+    if (minutes < 0 || minutes > 59) {
+        return false;
+    }
+
+    // A leap second is represented as a seconds value of 60
+    const int seconds = twoDigits(data, size, offset + 6);
+    if (seconds < 0 || seconds > 60) {
+        return false;
+    }
+
+    offset += 8;
+
+    // Optional fractional seconds: '.' followed by one or more digits
+    if (offset < size && data[offset] == '.') {
+        offset++;
+        const size_t firstFractionDigit = offset;
+        while (offset < size &&
+                CharClassifier::test(data[offset], CharClassifier::kDigit)) {
+            offset++;
+        }
+        if (offset == firstFractionDigit) {
+            return false;
+        }
+    }
+
+    // Mandatory offset: 'Z', or a signed hours and minutes pair
+    if (offset == size) {
+        return false;
+    }
+    if (data[offset] == 'Z' || data[offset] == 'z') {
+        return offset + 1 == size;
+    }
+    if (data[offset] != '+' && data[offset] != '-') {
+        return false;
+    }
+
+    const int offsetHours = twoDigits(data, size, offset + 1);
+    if (offsetHours < 0 || offsetHours > 23 ||
+            offset + 6 != size || data[offset + 3] != ':') {
+        return false;
+    }
+
+    const int offsetMinutes = twoDigits(data, size, offset + 4);
+    return offsetMinutes >= 0 && offsetMinutes <= 59;
+}
+
+/// Check an RFC 3339 full-time, e.g. '16:52:45+02:00'
+inline bool checkTime(const char *data, size_t size)
+{
+    return checkTimeAt(data, size, 0);
+}
+
+/// Check an RFC 3339 date-time, e.g. '2022-07-18T16:52:45Z'
+inline bool checkDateTime(const char *data, size_t size)
+{
+    size_t offset = 0;
+    while (offset < size && data[offset] != 'T' && data[offset] != 't') {
+        offset++;
+    }
+
+    return offset < size && checkDate(data, offset) &&
+            checkTimeAt(data, size, offset + 1);
+}
+
+/// Check an RFC 4122 UUID, e.g. '930a47a2-b206-4606-bcbb-e2dbc2bbe01c'
+inline bool checkUuid(const char *data, size_t size)
+{
+    if (size != 36 || data[8] != '-' || data[13] != '-' ||
+            data[18] != '-' || data[23] != '-') {
+        return false;
+    }
+
+    for (size_t i = 0; i < 36; i++) {
+        if (i == 8 || i == 13 || i == 18 || i == 23) {
+            continue;
+        }
+        if (!CharClassifier::test(data[i], CharClassifier::kHexDigit)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/// Check a hostname as defined by RFC 1034: dot-separated labels of up to
+/// 63 alphanumeric-or-hyphen characters, not starting or ending with a
+/// hyphen, with at most 253 characters overall
+inline bool checkHostname(const char *data, size_t size)
+{
+    if (size == 0 || size > 253) {
+        return false;
+    }
+
+    size_t labelLength = 0;
+    for (size_t i = 0; i < size; i++) {
+        if (data[i] == '.') {
+            if (labelLength == 0 || data[i - 1] == '-') {
+                return false;
+            }
+            labelLength = 0;
+        } else if (data[i] == '-') {
+            if (labelLength == 0) {
+                return false;
+            }
+            labelLength++;
+        } else if (CharClassifier::test(data[i], CharClassifier::kHostChar)) {
+            labelLength++;
+        } else {
+            return false;
+        }
+
+        if (labelLength > 63) {
+            return false;
+        }
+    }
+
+    return labelLength > 0 && data[size - 1] != '-';
+}
+
+/// Check an email address: an RFC 5322 dot-atom local part, followed by a
+/// hostname. Quoted local parts and address literals are not accepted.
+inline bool checkEmail(const char *data, size_t size)
+{
+    size_t atOffset = size;
+    for (size_t i = 0; i < size; i++) {
+        if (data[i] == '@') {
+            atOffset = i;
+            break;
+        }
+    }
+    if (atOffset == 0 || atOffset == size) {
+        return false;
+    }
+
+    bool previousWasDot = true;  // a leading dot is not allowed
+    for (size_t i = 0; i < atOffset; i++) {
+        if (data[i] == '.') {
+            if (previousWasDot) {
+                return false;
+            }
+            previousWasDot = true;
+        } else if (CharClassifier::test(data[i], CharClassifier::kEmailAtom)) {
+            previousWasDot = false;
+        } else {
+            return false;
+        }
+    }
+    if (previousWasDot) {  // a trailing dot is not allowed
+        return false;
+    }
+
+    return checkHostname(data + atOffset + 1, size - atOffset - 1);
+}
+
+/// Check a dotted-quad IPv4 address; leading zeros are not accepted
+inline bool checkIpv4(const char *data, size_t size)
+{
+    size_t offset = 0;
+    for (int octet = 0; octet < 4; octet++) {
+        if (octet > 0) {
+            if (offset >= size || data[offset] != '.') {
+                return false;
+            }
+            offset++;
+        }
+
+        size_t numDigits = 0;
+        int value = 0;
+        while (offset < size && numDigits < 3 &&
+                CharClassifier::test(data[offset], CharClassifier::kDigit)) {
+            value = value * 10 + (data[offset] - '0');
+            numDigits++;
+            offset++;
+        }
+
+        if (numDigits == 0 || value > 255 ||
+                (numDigits > 1 && data[offset - numDigits] == '0')) {
+            return false;
+        }
+    }
+
+    return offset == size;
+}
+
+/// Check an RFC 4291 IPv6 address: up to eight colon-separated groups of
+/// hexadecimal digits, with at most one '::' standing in for one or more
+/// zero groups, and an optional trailing embedded IPv4 address
+inline bool checkIpv6(const char *data, size_t size)
+{
+    int numGroups = 0;
+    bool compressed = false;
+    size_t offset = 0;
+
+    // A leading '::' is the only way a group list may start with a colon
+    if (size >= 2 && data[0] == ':' && data[1] == ':') {
+        compressed = true;
+        offset = 2;
+        if (offset == size) {
+            return true;
+        }
+    } else if (size >= 1 && data[0] == ':') {
+        return false;
+    }
+
+    while (offset < size) {
+        // An embedded IPv4 address occupies the final two groups; it is
+        // recognised by a dot within the current colon-delimited segment
+        if (numGroups <= 6) {
+            bool hasDot = false;
+            for (size_t i = offset; i < size && data[i] != ':'; i++) {
+                hasDot = hasDot || (data[i] == '.');
+            }
+            if (hasDot) {
+                return (compressed ? numGroups <= 5 : numGroups == 6) &&
+                        checkIpv4(data + offset, size - offset);
+            }
+        }
+
+        size_t numDigits = 0;
+        while (offset < size && numDigits < 4 &&
+                CharClassifier::test(data[offset],
+                        CharClassifier::kHexDigit)) {
+            numDigits++;
+            offset++;
+        }
+        if (numDigits == 0) {
+            return false;
+        }
+        numGroups++;
+
+        if (offset == size) {
+            break;
+        }
+        if (data[offset] != ':') {
+            return false;
+        }
+        offset++;
+
+        if (offset < size && data[offset] == ':') {
+            if (compressed) {
+                return false;
+            }
+            compressed = true;
+            offset++;
+            if (offset == size) {
+                return numGroups <= 7;
+            }
+        } else if (offset == size) {
+            // A single trailing colon is not a valid group separator
+            return false;
+        }
+    }
+
+    return compressed ? numGroups <= 7 : numGroups == 8;
+}
+
+/// Check a URI: an RFC 3986 scheme, a colon, and a non-empty remainder
+/// built from URI characters and valid percent-encoded octets
+inline bool checkUri(const char *data, size_t size)
+{
+    if (size == 0 || !CharClassifier::test(data[0], CharClassifier::kAlpha)) {
+        return false;
+    }
+
+    size_t offset = 1;
+    while (offset < size && (
+            CharClassifier::test(data[offset], CharClassifier::kAlpha) ||
+            CharClassifier::test(data[offset], CharClassifier::kDigit) ||
+            data[offset] == '+' || data[offset] == '-' ||
+            data[offset] == '.')) {
+        offset++;
+    }
+    if (offset == size || data[offset] != ':' || offset + 1 == size) {
+        return false;
+    }
+
+    for (offset++; offset < size; offset++) {
+        if (data[offset] == '%') {
+            if (offset + 2 >= size ||
+                    !CharClassifier::test(data[offset + 1],
+                            CharClassifier::kHexDigit) ||
+                    !CharClassifier::test(data[offset + 2],
+                            CharClassifier::kHexDigit)) {
+                return false;
+            }
+            offset += 2;
+        } else if (!CharClassifier::test(data[offset],
+                CharClassifier::kUriChar)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+}  // namespace format
+}  // namespace internal
+
+/**
+ * @brief   Process-wide registry mapping 'format' names to checkers
+ *
+ * The registry is created with checkers for the built-in formats ('date',
+ * 'date-time', 'email', 'hostname', 'ipv4', 'ipv6', 'time', 'uri' and
+ * 'uuid'). Applications may add checkers for their own formats, or replace
+ * a built-in checker, through registerChecker().
+ *
+ * FormatConstraint resolves its checker through this registry when the
+ * format is assigned, typically while a schema is being parsed, so changes
+ * to the registry affect schemas parsed afterwards but not constraints that
+ * already exist.
+ */
+class FormatCheckerRegistry
+{
+public:
+    /**
+     * @brief   Return the process-wide registry instance
+     */
+    static FormatCheckerRegistry & instance()
+    {
+        static FormatCheckerRegistry registry;
+        return registry;
+    }
+
+    /**
+     * @brief   Return the checker registered for a format
+     *
+     * @param   format  format name to look up
+     *
+     * @returns the registered checker, or nullptr if the format has none
+     */
+    FormatChecker find(const std::string &format) const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        const auto itr = m_checkers.find(format);
+        return itr == m_checkers.end() ? nullptr : itr->second;
+    }
+
+    /**
+     * @brief   Register a checker for a format, replacing any existing one
+     *
+     * @param   format   format name the checker applies to
+     * @param   checker  function that checks a candidate string
+     */
+    void registerChecker(const std::string &format, FormatChecker checker)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_checkers[format] = checker;
+    }
+
+    /**
+     * @brief   Remove the checker registered for a format
+     *
+     * Subsequently populated constraints will treat the format as an
+     * annotation and accept any string.
+     *
+     * @param   format  format name whose checker should be removed
+     */
+    void removeChecker(const std::string &format)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_checkers.erase(format);
+    }
+
+private:
+    FormatCheckerRegistry()
+    {
+        m_checkers["date"] = internal::format::checkDate;
+        m_checkers["date-time"] = internal::format::checkDateTime;
+        m_checkers["email"] = internal::format::checkEmail;
+        m_checkers["hostname"] = internal::format::checkHostname;
+        m_checkers["ipv4"] = internal::format::checkIpv4;
+        m_checkers["ipv6"] = internal::format::checkIpv6;
+        m_checkers["time"] = internal::format::checkTime;
+        m_checkers["uri"] = internal::format::checkUri;
+        m_checkers["uuid"] = internal::format::checkUuid;
+    }
+
+    FormatCheckerRegistry(const FormatCheckerRegistry &) = delete;
+    FormatCheckerRegistry & operator=(const FormatCheckerRegistry &) = delete;
+
+    /// Guards access to the checker map
+    mutable std::mutex m_mutex;
+
+    /// Registered checkers keyed by format name
+    std::map<std::string, FormatChecker> m_checkers;
+};
+
+}  // namespace valijson
@@ -0,0 +1,737 @@
+/**
+ * @file
+ *
+ * @brief   Incremental revalidation of documents that change one subtree
+ *          at a time
+ *
+ * Editor-style workloads revalidate the same large document after every
+ * small edit. IncrementalValidatorT avoids repeating the unchanged work: a
+ * priming validation records, for every location in the document, which
+ * sub-schemas were applied there and whether they passed. When the caller
+ * subsequently replaces the value at a known JSON Pointer, only the
+ * sub-schemas governing that location - plus any ancestor whose constraints
+ * can observe descendant values - are re-evaluated, and the cached verdicts
+ * for the rest of the document are reused.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <deque>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <valijson/constraints/concrete_constraints.hpp>
+#include <valijson/constraints/constraint_visitor.hpp>
+#include <valijson/internal/validation_context.hpp>
+#include <valijson/iterative_validator.hpp>
+#include <valijson/schema.hpp>
+#include <valijson/validation_results.hpp>
+#include <valijson/validator.hpp>
+
+namespace valijson {
+
+/**
+ * @brief   Validator that caches per-location verdicts and revalidates only
+ *          the subtree affected by an edit
+ *
+ * The cache is built on the work-stack decomposition used by
+ * IterativeValidatorT: every unit of deferred work pairs one document
+ * location with one sub-schema, and the overall verdict is the conjunction
+ * of the per-item verdicts. validate() runs that loop to completion,
+ * recording an entry per location; revalidate() discards and recomputes the
+ * entries for the mutated location and its descendants, leaving the rest of
+ * the cache untouched.
+ *
+ * Soundness of the narrow re-run rests on a classification of each
+ * sub-schema's directly evaluated constraints. Constraints that inspect
+ * only the shallow shape of a value - property membership and counts
+ * ('required', 'minProperties', 'additionalProperties' coverage), array
+ * lengths, types - cannot change when a descendant value is replaced in
+ * place, so ancestor entries holding only such constraints keep their
+ * cached verdicts. Constraints whose outcome can depend on values anywhere
+ * beneath them - 'enum', 'const', 'uniqueItems', 'contains', 'anyOf',
+ * 'oneOf', 'not', 'if'/'then'/'else', schema dependencies and custom poly
+ * constraints - mark their location as opaque, and an edit below an opaque
+ * location triggers re-evaluation from that location instead.
+ *
+ * The contract for revalidate() is that the document is unchanged outside
+ * the subtree named by the pointer. An edit that adds or removes a value,
+ * rather than replacing one, changes the shallow shape of the enclosing
+ * container, so the caller should pass the pointer of that container (the
+ * parent of the added or removed value); a pointer that no longer resolves
+ * is treated this way automatically, by re-running from the deepest
+ * resolvable ancestor.
+ *
+ * When a ValidationResults object is passed to revalidate(), it receives
+ * only the errors discovered by the re-run; errors in untouched regions of
+ * the document were reported by the call that validated them. isValid()
+ * always reflects the whole document.
+ *
+ * An instance is bound to one schema and one logical document. It is not
+ * safe to share between threads.
+ *
+ * @tparam  AdapterType  Adapter type for the document being validated
+ * @tparam  RegexEngine  Regular expression engine used for pattern
+ *                       constraint validation
+ */
+template<typename AdapterType, typename RegexEngine = DefaultRegexEngine>
+class IncrementalValidatorT
+{
+public:
+    /**
+     * @brief  Construct an incremental validator bound to a schema
+     *
+     * @param  schema       Schema that the document must validate against;
+     *                      must remain valid for the lifetime of this object
+     * @param  strictTypes  Use strict type comparison
+     */
+    explicit IncrementalValidatorT(const Subschema &schema, bool strictTypes = true)
+      : m_schema(&schema),
+        m_strictTypes(strictTypes),
+        m_primed(false) { }
+
+    IncrementalValidatorT(const IncrementalValidatorT &) = delete;
+    IncrementalValidatorT & operator=(const IncrementalValidatorT &) = delete;
+
+    /**
+     * @brief  Validate the full document and prime the location cache
+     *
+     * The document is always validated exhaustively, even when no results
+     * object is provided, so that the cache covers every location.
+     *
+     * @param  target   Document to be validated
+     * @param  results  Optional pointer to a ValidationResults instance
+     *                  that will be used to report validation errors
+     *
+     * @returns  \c true if the document is valid; \c false otherwise
+     */
+    bool validate(const AdapterType &target, ValidationResults *results = nullptr)
+    {
+        typedef IterativeValidationVisitor<AdapterType, RegexEngine> Visitor;
+
+        m_entries.clear();
+        m_primed = true;
+
+        typename Visitor::ContextArena contextArena;
+        typename Visitor::NameArena nameArena;
+        typename Visitor::WorkStack workStack;
+
+        contextArena.emplace_back();
+        workStack.emplace_back(target, m_schema, &contextArena.front());
+
+        runAndRecord(workStack, contextArena, nameArena, results);
+        return isValid();
+    }
+
+    /**
+     * @brief  Revalidate after the value at a JSON Pointer was replaced
+     *
+     * The pointer names the root of the mutated subtree within the updated
+     * document; everything outside that subtree must be unchanged since the
+     * previous validate() or revalidate() call. Only the sub-schemas
+     * recorded at the mutated location - lifted to the nearest enclosing
+     * location with value-dependent constraints, where one exists - are
+     * re-evaluated.
+     *
+     * @param  target   The updated document
+     * @param  pointer  JSON Pointer (RFC 6901) to the mutated subtree; the
+     *                  empty string revalidates the entire document
+     * @param  results  Optional pointer to a ValidationResults instance
+     *                  that receives errors found by the re-run
+     *
+     * @returns  \c true if the whole document is valid; \c false otherwise
+     */
+    bool revalidate(const AdapterType &target, const std::string &pointer,
+            ValidationResults *results = nullptr)
+    {
+        typedef IterativeValidationVisitor<AdapterType, RegexEngine> Visitor;
+
+        if (!m_primed) {
+            return validate(target, results);
+        }
+
+        // Resolve the pointer against the updated document, keeping the
+        // chain of values and building the matching chain of context frames
+        // so that errors reported by the re-run carry full paths. A pointer
+        // that stops resolving part-way - an added or removed value - falls
+        // back to the deepest ancestor that does resolve.
+        typename Visitor::ContextArena contextArena;
+        typename Visitor::NameArena nameArena;
+        std::deque<AdapterType> valueChain;
+
+        contextArena.emplace_back();
+        valueChain.push_back(target);
+
+        std::string resolved;
+        size_t pos = 0;
+        while (pos < pointer.size()) {
+            if (pointer[pos] != '/') {
+                // Malformed pointer; be conservative
+                return validate(target, results);
+            }
+
+            size_t end = pointer.find('/', pos + 1);
+            if (end == std::string::npos) {
+                end = pointer.size();
+            }
+
+            if (!resolveSegment(unescapePointerSegment(pointer.substr(pos + 1, end - pos - 1)),
+                    valueChain, contextArena, nameArena)) {
+                break;
+            }
+
+            resolved = pointer.substr(0, end);
+            pos = end;
+        }
+
+        // Choose the location to re-run from: the deepest recorded prefix
+        // of the resolved pointer, lifted to the outermost enclosing
+        // location whose constraints can observe descendant values
+        std::string start;
+        bool lifted = false;
+        forEachPrefix(resolved, [&](const std::string &prefix) {
+            const typename EntryMap::const_iterator itr = m_entries.find(prefix);
+            if (itr == m_entries.end()) {
+                return;
+            }
+            if (!lifted) {
+                start = prefix;
+                lifted = itr->second.deep;
+            }
+        });
+
+        const typename EntryMap::iterator startItr = m_entries.find(start);
+        if (startItr == m_entries.end()) {
+            // The cache does not cover the location; should not happen, as
+            // the root location is always recorded
+            return validate(target, results);
+        }
+
+        const std::vector<const Subschema *> startSubschemas =
+                startItr->second.subschemas;
+
+        // Discard the cached entries for the re-run region; stale entries
+        // beneath a removed value are discarded with it
+        erasePathAndDescendants(start);
+
+        // Trim the resolution chains back to the re-run location
+        while (valueChain.size() > numSegments(start) + 1) {
+            valueChain.pop_back();
+            contextArena.pop_back();
+            nameArena.pop_back();
+        }
+
+        typename Visitor::WorkStack workStack;
+        for (const Subschema *subschema : startSubschemas) {
+            workStack.emplace_back(valueChain.back(), subschema,
+                    &contextArena.back());
+        }
+
+        runAndRecord(workStack, contextArena, nameArena, results);
+        return isValid();
+    }
+
+    /**
+     * @brief  Revalidate after an RFC 6902 (JSON Patch) document was applied
+     *
+     * Each patch operation is mapped to the document location it affects: a
+     * 'replace' touches the value at its path, while 'add', 'remove', 'copy'
+     * and 'move' change the shape of the enclosing container and touch the
+     * parent of their path (and of 'from', for a move); 'test' touches
+     * nothing. Only those locations are revalidated, so the cost scales with
+     * the size of the patch rather than the size of the document.
+     *
+     * The patch must describe every change made to the document since the
+     * previous validation call, and must already have been applied by the
+     * caller. A patch that is not a well-formed operation array falls back
+     * to a full validation.
+     *
+     * @param  target   The document after the patch was applied
+     * @param  patch    RFC 6902 operation array describing the edit
+     * @param  results  Optional pointer to a ValidationResults instance
+     *                  that receives errors found by the re-runs; regions
+     *                  touched by several operations may report an error
+     *                  more than once
+     *
+     * @returns  \c true if the whole document is valid; \c false otherwise
+     */
+    bool validatePatch(const AdapterType &target, const AdapterType &patch,
+            ValidationResults *results = nullptr)
+    {
+        if (!m_primed || !patch.isArray()) {
+            return validate(target, results);
+        }
+
+        std::vector<std::string> affected;
+        for (const AdapterType &operation : patch.getArray()) {
+            if (!operation.isObject()) {
+                return validate(target, results);
+            }
+
+            const typename AdapterType::Object object = operation.asObject();
+
+            std::string op;
+            if (!memberString(object, "op", op)) {
+                return validate(target, results);
+            }
+
+            if (op == "test") {
+                continue;
+            }
+
+            std::string path;
+            if (!memberString(object, "path", path)) {
+                return validate(target, results);
+            }
+
+            if (op == "replace") {
+                affected.push_back(path);
+            } else if (op == "add" || op == "remove" || op == "copy" ||
+                    op == "move") {
+                // These change the shape of the enclosing container -
+                // membership, counts, or the indices of later array items -
+                // so the container itself must be re-run
+                affected.push_back(parentPointer(path));
+
+                if (op == "move") {
+                    std::string from;
+                    if (!memberString(object, "from", from)) {
+                        return validate(target, results);
+                    }
+                    affected.push_back(parentPointer(from));
+                }
+            } else {
+                return validate(target, results);
+            }
+        }
+
+        // Skip locations nested within another affected location; the outer
+        // re-run covers them
+        std::sort(affected.begin(), affected.end());
+        std::vector<std::string> roots;
+        for (const std::string &pointer : affected) {
+            if (roots.empty() || !isPathPrefix(roots.back(), pointer)) {
+                roots.push_back(pointer);
+            }
+        }
+
+        for (const std::string &pointer : roots) {
+            revalidate(target, pointer, results);
+        }
+
+        return isValid();
+    }
+
+    /**
+     * @brief  Return the verdict for the document as of the last call
+     *
+     * @returns  \c true if every cached location is valid
+     */
+    bool isValid() const
+    {
+        for (const typename EntryMap::value_type &entry : m_entries) {
+            if (!entry.second.validated) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    /**
+     * @brief  Return the number of document locations in the cache
+     */
+    size_t numTrackedLocations() const
+    {
+        return m_entries.size();
+    }
+
+    /**
+     * @brief  Discard all cached state
+     *
+     * The next validation call primes the cache from scratch, e.g. after a
+     * different document is loaded.
+     */
+    void reset()
+    {
+        m_entries.clear();
+        m_primed = false;
+    }
+
+private:
+    typedef IterativeValidationVisitor<AdapterType, RegexEngine> VisitorType;
+
+    /// Cached outcome of the sub-schemas applied at one document location
+    struct Entry
+    {
+        Entry()
+          : validated(true),
+            deep(false) { }
+
+        /// Sub-schemas applied at this location; used to seed a re-run
+        std::vector<const Subschema *> subschemas;
+
+        /// Conjunction of the verdicts of the sub-schemas at this location
+        bool validated;
+
+        /// Whether any sub-schema here directly evaluates a constraint
+        /// whose outcome can depend on descendant values
+        bool deep;
+    };
+
+    typedef std::map<std::string, Entry> EntryMap;
+
+    /**
+     * @brief  Visitor that classifies a constraint as value-dependent
+     *
+     * visit() returns \c true for constraints whose outcome can depend on
+     * values below the location they are applied at, and \c false for
+     * constraints that inspect only the shallow shape of the value. The
+     * structural constraints that defer descendant validation to the work
+     * stack ('properties', 'items', 'allOf' and friends) are shallow here,
+     * because their descendants are recorded as separate cache entries.
+     */
+    class DeepConstraintDetector: public constraints::ConstraintVisitor
+    {
+    public:
+        bool visit(const constraints::AllOfConstraint &) override { return false; }
+        bool visit(const constraints::AnyOfConstraint &) override { return true; }
+        bool visit(const constraints::ConditionalConstraint &) override { return true; }
+        bool visit(const constraints::ConstConstraint &) override { return true; }
+        bool visit(const constraints::ContainsConstraint &) override { return true; }
+
+        bool visit(const constraints::DependenciesConstraint &constraint) override
+        {
+            // Property dependencies inspect only membership; schema
+            // dependencies validate the whole object recursively
+            bool hasSchemaDependencies = false;
+            constraint.applyToSchemaDependencies(
+                    DetectSchemaDependency(&hasSchemaDependencies));
+            return hasSchemaDependencies;
+        }
+
+        bool visit(const constraints::EnumConstraint &) override { return true; }
+        bool visit(const constraints::FormatConstraint &) override { return false; }
+        bool visit(const constraints::FusedObjectConstraint &) override { return false; }
+        bool visit(const constraints::LinearItemsConstraint &) override { return false; }
+        bool visit(const constraints::MaximumConstraint &) override { return false; }
+        bool visit(const constraints::MaxItemsConstraint &) override { return false; }
+        bool visit(const constraints::MaxLengthConstraint &) override { return false; }
+        bool visit(const constraints::MaxPropertiesConstraint &) override { return false; }
+        bool visit(const constraints::MinimumConstraint &) override { return false; }
+        bool visit(const constraints::MinItemsConstraint &) override { return false; }
+        bool visit(const constraints::MinLengthConstraint &) override { return false; }
+        bool visit(const constraints::MinPropertiesConstraint &) override { return false; }
+        bool visit(const constraints::MultipleOfDoubleConstraint &) override { return false; }
+        bool visit(const constraints::MultipleOfIntConstraint &) override { return false; }
+        bool visit(const constraints::NotConstraint &) override { return true; }
+        bool visit(const constraints::OneOfConstraint &) override { return true; }
+        bool visit(const constraints::PatternConstraint &) override { return false; }
+        bool visit(const constraints::PolyConstraint &) override { return true; }
+        bool visit(const constraints::PropertiesConstraint &) override { return false; }
+        bool visit(const constraints::PropertyNamesConstraint &) override { return false; }
+        bool visit(const constraints::RequiredConstraint &) override { return false; }
+        bool visit(const constraints::SingularItemsConstraint &) override { return false; }
+
+        bool visit(const constraints::TypeConstraint &constraint) override
+        {
+            // Named types inspect only the shallow type; schema types
+            // validate the whole value recursively
+            return constraint.schemaTypeCount() > 0;
+        }
+
+        bool visit(const constraints::UniqueItemsConstraint &) override { return true; }
+
+    private:
+        /// Functor that records the presence of a schema dependency
+        struct DetectSchemaDependency
+        {
+            explicit DetectSchemaDependency(bool *found)
+              : m_found(found) { }
+
+            template<typename StringType>
+            bool operator()(const StringType &, const Subschema *) const
+            {
+                *m_found = true;
+                return false;
+            }
+
+        private:
+            bool * const m_found;
+        };
+    };
+
+    /**
+     * @brief  Drain a work stack, recording a cache entry per item
+     *
+     * Unlike IterativeValidatorT, the stack is always drained to
+     * completion, even without a results object, so that every reachable
+     * location receives a cache entry.
+     */
+    void runAndRecord(typename VisitorType::WorkStack &workStack,
+            typename VisitorType::ContextArena &contextArena,
+            typename VisitorType::NameArena &nameArena,
+            ValidationResults *results)
+    {
+        while (!workStack.empty()) {
+            const typename VisitorType::WorkItem item = workStack.back();
+            workStack.pop_back();
+
+            VisitorType visitor(item.value, *item.context, m_strictTypes,
+                    results, workStack, contextArena, nameArena);
+            const bool validated = visitor.validateSchema(*item.subschema);
+
+            Entry &entry = m_entries[pointerForContext(*item.context)];
+            entry.subschemas.push_back(item.subschema);
+            entry.validated = entry.validated && validated;
+            entry.deep = entry.deep || hasDeepConstraints(*item.subschema);
+        }
+    }
+
+    /**
+     * @brief  Classify a sub-schema, caching the result per sub-schema
+     */
+    bool hasDeepConstraints(const Subschema &subschema)
+    {
+        const std::map<const Subschema *, bool>::const_iterator itr =
+                m_deepCache.find(&subschema);
+        if (itr != m_deepCache.end()) {
+            return itr->second;
+        }
+
+        DeepConstraintDetector detector;
+        bool deep = false;
+        Subschema::ApplyFunction fn(
+                [&detector, &deep](const constraints::Constraint &constraint) {
+                    if (constraint.accept(detector)) {
+                        deep = true;
+                    }
+                    return true;
+                });
+        subschema.apply(fn);
+
+        m_deepCache[&subschema] = deep;
+        return deep;
+    }
+
+    /**
+     * @brief  Build the JSON Pointer for a chain of context frames
+     *
+     * Uses the same escaping as ValidationResults::Error::jsonPointer, so
+     * the cache keys line up with reported error locations.
+     */
+    static std::string pointerForContext(const internal::ValidationContext &context)
+    {
+        const std::vector<std::string> segments = context.materialize();
+
+        std::string pointer;
+        for (size_t i = 1; i < segments.size(); i++) {
+            const std::string &segment = segments[i];
+            pointer += '/';
+
+            // Context strings have the form '[name]' or '[index]'
+            for (size_t j = 1; j + 1 < segment.size(); j++) {
+                if (segment[j] == '~') {
+                    pointer += "~0";
+                } else if (segment[j] == '/') {
+                    pointer += "~1";
+                } else {
+                    pointer += segment[j];
+                }
+            }
+        }
+
+        return pointer;
+    }
+
+    /// Reverse RFC 6901 escaping within one pointer segment
+    static std::string unescapePointerSegment(const std::string &segment)
+    {
+        std::string result;
+        result.reserve(segment.size());
+        for (size_t i = 0; i < segment.size(); i++) {
+            if (segment[i] == '~' && i + 1 < segment.size()) {
+                if (segment[i + 1] == '0') {
+                    result += '~';
+                    i++;
+                    continue;
+                } else if (segment[i + 1] == '1') {
+                    result += '/';
+                    i++;
+                    continue;
+                }
+            }
+            result += segment[i];
+        }
+
+        return result;
+    }
+
+    /// Extract a string-valued member of an object, e.g. a patch op's path
+    static bool memberString(const typename AdapterType::Object &object,
+            const char *name, std::string &result)
+    {
+        const typename AdapterType::Object::const_iterator itr =
+                object.find(std::string(name));
+        if (itr == object.end()) {
+            return false;
+        }
+
+        return itr->second.getString(result);
+    }
+
+    /// JSON Pointer to the container enclosing a location; the parent of
+    /// the root is the root itself
+    static std::string parentPointer(const std::string &pointer)
+    {
+        const size_t pos = pointer.rfind('/');
+        return pos == std::string::npos ? std::string() : pointer.substr(0, pos);
+    }
+
+    /// Whether one JSON Pointer names a location at or beneath another
+    static bool isPathPrefix(const std::string &prefix, const std::string &pointer)
+    {
+        if (prefix.empty()) {
+            return true;
+        }
+
+        if (pointer.size() < prefix.size() ||
+                pointer.compare(0, prefix.size(), prefix) != 0) {
+            return false;
+        }
+
+        return pointer.size() == prefix.size() || pointer[prefix.size()] == '/';
+    }
+
+    /// Number of segments in a JSON Pointer; the empty pointer has none
+    static size_t numSegments(const std::string &pointer)
+    {
+        size_t count = 0;
+        for (const char c : pointer) {
+            if (c == '/') {
+                count++;
+            }
+        }
+        return count;
+    }
+
+    /**
+     * @brief  Descend one pointer segment, extending the value and context
+     *         chains
+     *
+     * @returns  \c false if the segment does not resolve against the value
+     *           at the back of the chain
+     */
+    bool resolveSegment(const std::string &segment,
+            std::deque<AdapterType> &valueChain,
+            typename VisitorType::ContextArena &contextArena,
+            typename VisitorType::NameArena &nameArena)
+    {
+        const AdapterType &current = valueChain.back();
+        const internal::ValidationContext &parent = contextArena.back();
+
+        if (current.isObject()) {
+            const typename AdapterType::Object object = current.asObject();
+            const typename AdapterType::Object::const_iterator itr =
+                    object.find(segment);
+            if (itr == object.end()) {
+                return false;
+            }
+
+            valueChain.push_back(itr->second);
+            nameArena.push_back(segment);
+            contextArena.emplace_back(parent, nameArena.back());
+            return true;
+
+        } else if (current.isArray()) {
+            if (segment.empty()) {
+                return false;
+            }
+
+            size_t index = 0;
+            for (const char c : segment) {
+                if (c < '0' || c > '9') {
+                    return false;
+                }
+                index = index * 10 + static_cast<size_t>(c - '0');
+            }
+
+            if (index >= current.getArraySize()) {
+                return false;
+            }
+
+            typename AdapterType::Array::const_iterator itr =
+                    current.getArray().begin();
+            itr.advance(index);
+            valueChain.push_back(*itr);
+            nameArena.push_back(segment);
+            contextArena.emplace_back(parent, index);
+            return true;
+        }
+
+        return false;
+    }
+
+    /**
+     * @brief  Apply a functor to each prefix of a pointer, outermost first
+     *
+     * The empty pointer (the document root) is always included.
+     */
+    template<typename FunctorType>
+    static void forEachPrefix(const std::string &pointer, const FunctorType &fn)
+    {
+        fn(std::string());
+
+        size_t pos = 0;
+        while (pos < pointer.size() && pointer[pos] == '/') {
+            size_t end = pointer.find('/', pos + 1);
+            if (end == std::string::npos) {
+                end = pointer.size();
+            }
+            fn(pointer.substr(0, end));
+            pos = end;
+        }
+    }
+
+    /// Erase the cache entries for a location and everything beneath it
+    void erasePathAndDescendants(const std::string &pointer)
+    {
+        typename EntryMap::iterator itr = m_entries.lower_bound(pointer);
+        while (itr != m_entries.end() &&
+                itr->first.compare(0, pointer.size(), pointer) == 0) {
+            // A shared string prefix is not enough; '/ab' must survive the
+            // erasure of '/a'
+            if (isPathPrefix(pointer, itr->first)) {
+                itr = m_entries.erase(itr);
+            } else {
+                ++itr;
+            }
+        }
+    }
+
+    /// Schema that the document is validated against
+    const Subschema * const m_schema;
+
+    /// Option to use strict type comparison
+    const bool m_strictTypes;
+
+    /// Whether a priming validation has populated the cache
+    bool m_primed;
+
+    /// Cached verdicts, keyed by JSON Pointer
+    EntryMap m_entries;
+
+    /// Per-sub-schema classification cache
+    std::map<const Subschema *, bool> m_deepCache;
+};
+
+/**
+ * @brief  Incremental validator using the default regex engine
+ */
+template<typename AdapterType>
+using IncrementalValidator = IncrementalValidatorT<AdapterType>;
+
+}  // namespace valijson
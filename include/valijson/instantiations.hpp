@@ -0,0 +1,49 @@
+/**
+ * @file
+ *
+ * @brief   Explicit instantiation declarations for common template combinations
+ *
+ * Every translation unit that validates a rapidjson document implicitly
+ * instantiates ValidationVisitor and its helper functors, and for services
+ * with many translation units that repeated instantiation can dominate
+ * incremental build times. Including this header after the usual Valijson
+ * headers suppresses the implicit instantiations for the most common
+ * combination - RapidJsonAdapter with the default std::regex engine and no
+ * instrumentation - so each translation unit only references symbols that
+ * are compiled once into the optional valijson_precompiled static library
+ * (src/instantiations.cpp, enabled with valijson_BUILD_PRECOMPILED).
+ *
+ * Other adapter, regex engine or instrumentation combinations are not
+ * affected and continue to be instantiated implicitly.
+ */
+
+#pragma once
+
+#include <valijson/adapters/rapidjson_adapter.hpp>
+#include <valijson/adapters/std_string_adapter.hpp>
+#include <valijson/validator.hpp>
+
+#ifdef VALIJSON_DEFINE_INSTANTIATIONS
+#define VALIJSON_INSTANTIATION template
+#else
+#define VALIJSON_INSTANTIATION extern template
+#endif
+
+namespace valijson {
+
+VALIJSON_INSTANTIATION class ValidationVisitor<adapters::RapidJsonAdapter,
+        DefaultRegexEngine, NoInstrumentation>;
+
+// 'propertyNames' validation wraps each member name in a StdStringAdapter,
+// so the visitor for that adapter is always instantiated alongside the main
+// one and is worth pre-compiling too
+VALIJSON_INSTANTIATION class ValidationVisitor<adapters::StdStringAdapter,
+        DefaultRegexEngine, NoInstrumentation>;
+
+VALIJSON_INSTANTIATION bool ValidatorT<DefaultRegexEngine>::validate<
+        adapters::RapidJsonAdapter>(const Subschema &,
+        const adapters::RapidJsonAdapter &, ValidationResults *) const;
+
+}  // namespace valijson
+
+#undef VALIJSON_INSTANTIATION
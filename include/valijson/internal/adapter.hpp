@@ -1,7 +1,10 @@
 #pragma once
 
+#include <cstdint>
 #include <functional>
 
+#include <valijson/internal/string_view.hpp>
+
 namespace valijson {
 namespace adapters {
 
@@ -147,6 +150,23 @@ public:
      */
     virtual bool asInteger(int64_t &result) const = 0;
 
+    /**
+     * @brief   Retrieve the uint64_t representation of the contained value.
+     *
+     * This function shall retrieve a uint64_t value if the Adapter contains
+     * a non-negative integer, including integers above the range of int64_t,
+     * which asInteger() cannot represent. Adapters whose underlying parser
+     * tracks an unsigned integer kind natively provide such values without
+     * wrapping or precision loss.
+     *
+     * The retrieved value is returned via reference.
+     *
+     * @param   result  reference to a uint64_t to set with retrieved value.
+     *
+     * @returns true if the value could be retrieved, false otherwise
+     */
+    virtual bool getUnsignedInteger(uint64_t &result) const = 0;
+
     /**
      * @brief   Return the string representation of the contained value.
      *
@@ -354,6 +374,53 @@ public:
      */
     virtual bool getString(std::string &result) const = 0;
 
+    /**
+     * @brief   Retrieve a non-owning view of the contained string value.
+     *
+     * Adapters whose underlying storage is stable, such as those that wrap a
+     * parsed document, may return a view that refers directly to that
+     * storage, avoiding a copy. Other adapters fall back to copying the
+     * string into the caller-provided scratch buffer and returning a view of
+     * the buffer. In either case, the view is invalidated when the storage
+     * it refers to is destroyed or modified.
+     *
+     * This function shall return false if the contained value is not a
+     * string - even if the value could be cast to a string.
+     *
+     * @param   result   reference to a view to set with the result
+     * @param   scratch  buffer that may be used as backing storage when a
+     *                   zero-copy view is not available
+     *
+     * @returns true if a view of the string was retrieved, false otherwise
+     */
+    virtual bool getStringView(internal::string_view &result, std::string &scratch) const
+    {
+        if (getString(scratch)) {
+            result = internal::string_view(scratch);
+            return true;
+        }
+
+        return false;
+    }
+
+    /**
+     * @brief   Compute a canonical structural hash of the contained value.
+     *
+     * Values that compare equal through equalTo() with strict types enabled
+     * hash to the same result, regardless of which Adapter implementation
+     * or underlying parser they were loaded with. The converse does not
+     * hold: distinct values may share a hash, so a matching hash must be
+     * confirmed by a deep comparison, whereas differing hashes prove that
+     * two values are not strictly equal.
+     *
+     * Weakly-typed comparisons, where a string may compare equal to a
+     * number, cannot be modelled by a hash function and must always be
+     * performed as a deep comparison.
+     *
+     * @returns computed hash of the contained value
+     */
+    virtual size_t hash() const = 0;
+
     /**
      * @brief   Returns whether or not this Adapter supports strict types.
      *
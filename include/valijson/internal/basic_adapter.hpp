@@ -1,9 +1,10 @@
 #pragma once
 
 #include <cstdint>
-#include <sstream>
 
 #include <valijson/internal/adapter.hpp>
+#include <valijson/internal/json_hash.hpp>
+#include <valijson/internal/numeric_parsing.hpp>
 #include <valijson/internal/optional.hpp>
 #include <valijson/exceptions.hpp>
 
@@ -288,7 +289,7 @@ public:
             return *m_value.getArrayOptional();
         } else if (m_value.isObject()) {
             size_t objectSize;
-            if (m_value.getObjectSize(objectSize) && objectSize == 0) {
+            if (getObjectSize(objectSize) && objectSize == 0) {
                 return ArrayType();
             }
         } else if (m_value.isString()) {
@@ -351,18 +352,16 @@ public:
                 result = double(i);
                 return true;
             }
-        } else if (m_value.isString()) {
-            std::string s;
-            if (m_value.getString(s)) {
-                const char *b = s.c_str();
-                char *e = nullptr;
-                double x = strtod(b, &e);
-                if (e == b || e != b + s.length()) {
-                    return false;
-                }
-                result = x;
+
+            // Integers above the int64_t range are only retrievable through
+            // the unsigned representation
+            uint64_t u;
+            if (getUnsignedInteger(u)) {
+                result = static_cast<double>(u);
                 return true;
             }
+        } else if (m_value.isString()) {
+            return coerceToDouble(result);
         }
 
         return false;
@@ -378,21 +377,43 @@ public:
         throwRuntimeError("JSON value cannot be cast as an integer.");
     }
 
+    /**
+     * @brief   Retrieve the value held by this Adapter as an unsigned 64-bit
+     *          integer
+     *
+     * This is what distinguishes integers above the int64_t range, which
+     * asInteger() cannot represent, from values that are not integers at
+     * all. Value types that track an unsigned integer kind natively provide
+     * their own getUnsignedInteger() member function, which is picked up
+     * via expression SFINAE; for the rest, any non-negative integer is
+     * converted.
+     *
+     * @param   result  reference to be set to the unsigned integer value
+     *
+     * @returns true if the value is a non-negative integer, false otherwise
+     */
+    bool getUnsignedInteger(uint64_t &result) const override
+    {
+        if (getUnsignedIntegerImpl(m_value, result, 0)) {
+            return true;
+        }
+
+        int64_t signedResult;
+        if (m_value.isInteger() && m_value.getInteger(signedResult) &&
+                signedResult >= 0) {
+            result = static_cast<uint64_t>(signedResult);
+            return true;
+        }
+
+        return false;
+    }
+
     bool asInteger(int64_t &result) const override
     {
         if (m_value.isInteger()) {
             return m_value.getInteger(result);
         } else if (m_value.isString()) {
-            std::string s;
-            if (m_value.getString(s)) {
-                std::istringstream i(s);
-                int64_t x;
-                char c;
-                if (!(!(i >> x) || i.get(c))) {
-                    result = x;
-                    return true;
-                }
-            }
+            return coerceToInteger(result);
         }
 
         return false;
@@ -416,7 +437,7 @@ public:
             return *m_value.getObjectOptional();
         } else if (m_value.isArray()) {
             size_t arraySize;
-            if (m_value.getArraySize(arraySize) && arraySize == 0) {
+            if (getArraySize(arraySize) && arraySize == 0) {
                 return ObjectType();
             }
         } else if (m_value.isString()) {
@@ -448,13 +469,13 @@ public:
             return true;
         } else if (m_value.isArray()) {
             size_t arraySize;
-            if (m_value.getArraySize(arraySize) && arraySize == 0) {
+            if (getArraySize(arraySize) && arraySize == 0) {
                 result.clear();
                 return true;
             }
         } else if (m_value.isObject()) {
             size_t objectSize;
-            if (m_value.getObjectSize(objectSize) && objectSize == 0) {
+            if (getObjectSize(objectSize) && objectSize == 0) {
                 result.clear();
                 return true;
             }
@@ -470,6 +491,12 @@ public:
                 result = std::to_string(integerValue);
                 return true;
             }
+
+            uint64_t unsignedValue;
+            if (getUnsignedInteger(unsignedValue)) {
+                result = std::to_string(unsignedValue);
+                return true;
+            }
         } else if (m_value.isDouble()) {
             double doubleValue;
             if (m_value.getDouble(doubleValue)) {
@@ -521,6 +548,14 @@ public:
         return false;
     }
 
+    size_t hash() const override
+    {
+        // Hashing through the concrete adapter type avoids the virtual
+        // dispatch and string copies that an implementation written against
+        // the abstract interface would incur at every node
+        return internal::hashJsonValue(static_cast<const AdapterType &>(*this));
+    }
+
     /**
      * @brief   Return an ArrayType instance representing the array contained
      *          by this Adapter instance.
@@ -548,7 +583,7 @@ public:
     size_t getArraySize() const override
     {
         size_t result;
-        if (m_value.getArraySize(result)) {
+        if (getArraySize(result)) {
             return result;
         }
 
@@ -557,7 +592,22 @@ public:
 
     bool getArraySize(size_t &result) const override
     {
-        return m_value.getArraySize(result);
+        if (hasCheapContainerSizeImpl<ValueType>(0)) {
+            return m_value.getArraySize(result);
+        }
+
+        if (m_cachedArraySize == kContainerSizeUnknown) {
+            size_t computed;
+            m_cachedArraySize = m_value.getArraySize(computed) ?
+                    computed : kContainerSizeNotApplicable;
+        }
+
+        if (m_cachedArraySize == kContainerSizeNotApplicable) {
+            return false;
+        }
+
+        result = m_cachedArraySize;
+        return true;
     }
 
     bool getBool() const override
@@ -625,6 +675,12 @@ public:
                 result = static_cast<double>(integerResult);
                 return true;
             }
+
+            uint64_t unsignedResult;
+            if (getUnsignedInteger(unsignedResult)) {
+                result = static_cast<double>(unsignedResult);
+                return true;
+            }
         }
 
         return false;
@@ -666,7 +722,22 @@ public:
 
     bool getObjectSize(size_t &result) const override
     {
-        return m_value.getObjectSize(result);
+        if (hasCheapContainerSizeImpl<ValueType>(0)) {
+            return m_value.getObjectSize(result);
+        }
+
+        if (m_cachedObjectSize == kContainerSizeUnknown) {
+            size_t computed;
+            m_cachedObjectSize = m_value.getObjectSize(computed) ?
+                    computed : kContainerSizeNotApplicable;
+        }
+
+        if (m_cachedObjectSize == kContainerSizeNotApplicable) {
+            return false;
+        }
+
+        result = m_cachedObjectSize;
+        return true;
     }
 
     std::string getString() const override
@@ -684,6 +755,11 @@ public:
         return m_value.getString(result);
     }
 
+    bool getStringView(internal::string_view &result, std::string &scratch) const override
+    {
+        return getStringViewImpl(m_value, result, scratch, 0);
+    }
+
     FrozenValue * freeze() const override
     {
         return m_value.freeze();
@@ -740,7 +816,7 @@ public:
             return true;
         } else if (m_value.isObject()) {
             size_t objectSize;
-            if (m_value.getObjectSize(objectSize) && objectSize == 0) {
+            if (getObjectSize(objectSize) && objectSize == 0) {
                 return true;
             }
         }
@@ -769,13 +845,8 @@ public:
         if (m_value.isNumber()) {
             return true;
         } else if (maybeString()) {
-            std::string s;
-            if (m_value.getString(s)) {
-                const char *b = s.c_str();
-                char *e = nullptr;
-                strtod(b, &e);
-                return e != b && e == b + s.length();
-            }
+            double unused;
+            return coerceToDouble(unused);
         }
 
         return false;
@@ -786,16 +857,8 @@ public:
         if (m_value.isInteger()) {
             return true;
         } else if (maybeString()) {
-            std::string s;
-            if (m_value.getString(s)) {
-                std::istringstream i(s);
-                int64_t x;
-                char c;
-                if (!(i >> x) || i.get(c)) {
-                    return false;
-                }
-                return true;
-            }
+            int64_t unused;
+            return coerceToInteger(unused);
         }
 
         return false;
@@ -823,7 +886,7 @@ public:
             return true;
         } else if (maybeArray()) {
             size_t arraySize;
-            if (m_value.getArraySize(arraySize) && arraySize == 0) {
+            if (getArraySize(arraySize) && arraySize == 0) {
                 return true;
             }
         }
@@ -837,12 +900,12 @@ public:
             return true;
         } else if (m_value.isObject()) {
             size_t objectSize;
-            if (m_value.getObjectSize(objectSize) && objectSize == 0) {
+            if (getObjectSize(objectSize) && objectSize == 0) {
                 return true;
             }
         } else if (m_value.isArray()) {
             size_t arraySize;
-            if (m_value.getArraySize(arraySize) && arraySize == 0) {
+            if (getArraySize(arraySize) && arraySize == 0) {
                 return true;
             }
         }
@@ -850,9 +913,235 @@ public:
         return false;
     }
 
+    /**
+     * @brief   Summarise an array of numbers as its size and numeric bounds
+     *
+     * When the value is an array whose elements are all numbers, and the
+     * value type can sweep its array storage natively, the element count
+     * and the smallest and largest element values are returned in a single
+     * pass, allowing numeric range constraints to be checked against the
+     * bounds instead of against each element.
+     *
+     * @param   size      receives the number of elements in the array
+     * @param   minValue  receives the smallest element value; unspecified
+     *                    for an empty array
+     * @param   maxValue  receives the largest element value; unspecified
+     *                    for an empty array
+     *
+     * @returns true if the bounds were computed; false when the value is
+     *          not an array, contains a non-numeric element, contains an
+     *          element that cannot be summarised faithfully as a double,
+     *          or the value type has no native support for the sweep
+     */
+    bool getNumericArrayBounds(size_t &size, double &minValue,
+            double &maxValue) const
+    {
+        return getNumericArrayBoundsImpl(m_value, size, minValue, maxValue, 0);
+    }
+
 private:
 
+    /**
+     * @brief   Compute numeric array bounds using the value type's native
+     *          support
+     *
+     * This overload is selected, via expression SFINAE, for value types that
+     * provide a getNumericArrayBounds() member function, allowing the sweep
+     * to run over the underlying document's array storage.
+     */
+    template<typename Value>
+    static auto getNumericArrayBoundsImpl(const Value &value, size_t &size,
+            double &minValue, double &maxValue, int)
+            -> decltype(value.getNumericArrayBounds(size, minValue, maxValue))
+    {
+        return value.getNumericArrayBounds(size, minValue, maxValue);
+    }
+
+    /**
+     * @brief   Fallback for value types without a native bounds sweep
+     */
+    template<typename Value>
+    static bool getNumericArrayBoundsImpl(const Value &, size_t &, double &,
+            double &, long)
+    {
+        return false;
+    }
+
+    /**
+     * @brief   Coerce this value's string representation to a double
+     *
+     * The outcome is memoized: a weakly-typed value tested against a chain
+     * of numeric constraints - type, then minimum, then multipleOf - is
+     * parsed once, with every subsequent coercion served from the cache.
+     *
+     * @param   result  reference to be set to the coerced value
+     *
+     * @returns true if the value coerces to a double
+     */
+    bool coerceToDouble(double &result) const
+    {
+        if (m_doubleCoercion == kCoercionUnknown) {
+            internal::string_view view;
+            std::string scratch;
+            double parsed;
+            if (getStringView(view, scratch) &&
+                    internal::parseDouble(view.data(), view.size(), parsed)) {
+                m_coercedDouble = parsed;
+                m_doubleCoercion = kCoercionSucceeded;
+            } else {
+                m_doubleCoercion = kCoercionFailed;
+            }
+        }
+
+        if (m_doubleCoercion == kCoercionFailed) {
+            return false;
+        }
+
+        result = m_coercedDouble;
+        return true;
+    }
+
+    /// Coerce this value's string representation to a signed integer,
+    /// memoizing the outcome as coerceToDouble() does
+    bool coerceToInteger(int64_t &result) const
+    {
+        if (m_integerCoercion == kCoercionUnknown) {
+            internal::string_view view;
+            std::string scratch;
+            int64_t parsed;
+            if (getStringView(view, scratch) &&
+                    internal::parseInteger(view.data(), view.size(), parsed)) {
+                m_coercedInteger = parsed;
+                m_integerCoercion = kCoercionSucceeded;
+            } else {
+                m_integerCoercion = kCoercionFailed;
+            }
+        }
+
+        if (m_integerCoercion == kCoercionFailed) {
+            return false;
+        }
+
+        result = m_coercedInteger;
+        return true;
+    }
+
+    /**
+     * @brief   Retrieve a string view using the value type's native support
+     *
+     * This overload is selected, via expression SFINAE, for value types that
+     * provide a getStringView() member function, allowing the string to be
+     * viewed without copying it out of the underlying document.
+     */
+    template<typename Value>
+    static auto getStringViewImpl(const Value &value, internal::string_view &result,
+            std::string &, int) -> decltype(value.getStringView(result))
+    {
+        return value.getStringView(result);
+    }
+
+    /**
+     * @brief   Retrieve a string view by copying into the scratch buffer
+     *
+     * Fallback for value types that cannot provide a stable view of their
+     * string storage.
+     */
+    template<typename Value>
+    static bool getStringViewImpl(const Value &value, internal::string_view &result,
+            std::string &scratch, long)
+    {
+        if (value.getString(scratch)) {
+            result = internal::string_view(scratch);
+            return true;
+        }
+
+        return false;
+    }
+
+    /**
+     * @brief   Report whether the value type measures container sizes in
+     *          constant time
+     *
+     * This overload is selected, via expression SFINAE, for value types that
+     * declare a hasCheapContainerSize() function. Value types backed by
+     * containers without an O(1) size operation declare it returning false,
+     * which enables per-instance memoization of container sizes.
+     */
+    template<typename Value>
+    static auto hasCheapContainerSizeImpl(int) -> decltype(Value::hasCheapContainerSize())
+    {
+        return Value::hasCheapContainerSize();
+    }
+
+    /// Fallback for value types that do not say otherwise, whose container
+    /// sizes are assumed to be cheap to compute on every call
+    template<typename Value>
+    static bool hasCheapContainerSizeImpl(long)
+    {
+        return true;
+    }
+
+    /**
+     * @brief   Retrieve an unsigned integer using the value type's native
+     *          support
+     *
+     * This overload is selected, via expression SFINAE, for value types
+     * that provide a getUnsignedInteger() member function, which allows
+     * integers above the int64_t range to be retrieved without wrapping
+     * or precision loss.
+     */
+    template<typename Value>
+    static auto getUnsignedIntegerImpl(const Value &value, uint64_t &result, int)
+        -> decltype(value.getUnsignedInteger(result))
+    {
+        return value.getUnsignedInteger(result);
+    }
+
+    /// Fallback for value types without a native unsigned integer kind; the
+    /// caller converts non-negative signed integers instead
+    template<typename Value>
+    static bool getUnsignedIntegerImpl(const Value &, uint64_t &, long)
+    {
+        return false;
+    }
+
+    /// Sentinel indicating that a container size has not been computed yet
+    static const size_t kContainerSizeUnknown = static_cast<size_t>(-1);
+
+    /// Sentinel indicating that a size was requested for a container of the
+    /// wrong type, so the underlying query returned false
+    static const size_t kContainerSizeNotApplicable = static_cast<size_t>(-2);
+
     const ValueType m_value;
+
+    /// Memoized array size, for value types without cheap container sizes.
+    /// Values are immutable while being validated, so a size computed once
+    /// can be served to every subsequent probe against this adapter.
+    mutable size_t m_cachedArraySize = kContainerSizeUnknown;
+
+    /// Memoized object size, as above
+    mutable size_t m_cachedObjectSize = kContainerSizeUnknown;
+
+    /// Outcome of a memoized string-to-number coercion
+    enum CoercionOutcome : char
+    {
+        kCoercionUnknown,
+        kCoercionSucceeded,
+        kCoercionFailed
+    };
+
+    /// Memoized result of coercing this value's string representation to a
+    /// double, populated the first time a numeric constraint asks
+    mutable double m_coercedDouble = 0;
+
+    /// Memoized result of coercing to a signed integer, as above
+    mutable int64_t m_coercedInteger = 0;
+
+    /// Whether the double coercion has run, and whether it succeeded
+    mutable CoercionOutcome m_doubleCoercion = kCoercionUnknown;
+
+    /// Whether the integer coercion has run, and whether it succeeded
+    mutable CoercionOutcome m_integerCoercion = kCoercionUnknown;
 };
 
 }  // namespace adapters
@@ -0,0 +1,494 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <valijson/internal/adapter.hpp>
+#include <valijson/internal/frozen_value.hpp>
+#include <valijson/internal/string_view.hpp>
+
+namespace valijson {
+namespace adapters {
+
+/**
+ * @brief   FrozenValue that stores a JSON value as one flat encoded buffer
+ *
+ * Adapter-specific frozen values clone the source document tree, so freezing
+ * a composite value - such as one entry in a long 'enum' array - produces
+ * many small heap nodes scattered across memory. This implementation instead
+ * packs the entire value into a single contiguous buffer, using a compact
+ * type-tag-plus-inline-payload encoding with children stored contiguously,
+ * and implements comparison by walking that encoding alongside the value
+ * being validated. Cloning the frozen value copies one buffer, and comparing
+ * against it is a linear scan with memcmp-based string comparisons, rather
+ * than a pointer chase through a cloned tree.
+ *
+ * Object members are encoded in key order, so the encoding of a value does
+ * not depend on the iteration order of the adapter it was frozen from, and
+ * member lookup during comparison can binary search the encoded members.
+ *
+ * Values read through weakly-typed adapters that do not preserve JSON types
+ * cannot be encoded faithfully; freezeCompactValue() returns nullptr for
+ * those values so that callers can fall back to the adapter's own frozen
+ * representation.
+ */
+class CompactFrozenValue: public FrozenValue
+{
+public:
+    FrozenValue * clone() const override
+    {
+        return new CompactFrozenValue(*this);
+    }
+
+    bool equalTo(const Adapter &other, bool strict) const override
+    {
+        const char *cursor = m_data.data();
+        return equalToValue(cursor, other, strict);
+    }
+
+    /**
+     * @brief   Freeze a value into a compact encoding
+     *
+     * @param   value  adapter for the value to be frozen
+     *
+     * @returns pointer to a new CompactFrozenValue, owned by the caller, or
+     *          nullptr if any part of the value lacks a definite JSON type
+     */
+    static CompactFrozenValue * freeze(const Adapter &value)
+    {
+        std::vector<char> buffer;
+        if (!encodeValue(value, buffer)) {
+            return nullptr;
+        }
+
+        return new CompactFrozenValue(std::move(buffer));
+    }
+
+    /**
+     * @brief   Produce the canonical compact encoding of a value
+     *
+     * Two values have the same encoding if and only if they are
+     * structurally equal, which makes the encoding usable as a
+     * hash-consing key for frozen values.
+     *
+     * @param   value     adapter for the value to be encoded
+     * @param   encoding  string that receives the encoded bytes
+     *
+     * @returns true if the value was encoded, or false if any part of it
+     *          lacks a definite JSON type
+     */
+    static bool encode(const Adapter &value, std::string &encoding)
+    {
+        std::vector<char> buffer;
+        if (!encodeValue(value, buffer)) {
+            return false;
+        }
+
+        encoding.assign(buffer.begin(), buffer.end());
+        return true;
+    }
+
+    /**
+     * @brief   Produce the canonical compact encoding of a value, abandoning
+     *          values whose encoding would exceed a size limit
+     *
+     * The limit allows callers that key small values by their encoding -
+     * such as the validation memoization cache - to skip large subtrees
+     * without paying to encode them in full; encoding stops soon after the
+     * limit is crossed.
+     *
+     * @param   value     adapter for the value to be encoded
+     * @param   encoding  string that receives the encoded bytes
+     * @param   maxBytes  greatest encoded size, in bytes, worth producing
+     *
+     * @returns true if the value was encoded within the limit, or false if
+     *          the encoding was abandoned or any part of the value lacks a
+     *          definite JSON type
+     */
+    static bool encode(const Adapter &value, std::string &encoding,
+            size_t maxBytes)
+    {
+        std::vector<char> buffer;
+        if (!encodeValue(value, buffer, maxBytes) ||
+                buffer.size() > maxBytes) {
+            return false;
+        }
+
+        encoding.assign(buffer.begin(), buffer.end());
+        return true;
+    }
+
+private:
+    /// Type tag that begins the encoding of each value
+    enum Tag : char
+    {
+        kNullTag,
+        kFalseTag,
+        kTrueTag,
+
+        /// Followed by an int64_t payload
+        kIntegerTag,
+
+        /// Followed by a double payload
+        kDoubleTag,
+
+        /// Followed by a uint32_t byte count, then that many bytes
+        kStringTag,
+
+        /// Followed by a uint32_t element count, then the encoded elements
+        kArrayTag,
+
+        /// Followed by a uint32_t member count, then for each member a
+        /// uint32_t key byte count, the key bytes, and the encoded value;
+        /// members are ordered by key
+        kObjectTag
+    };
+
+    /// Non-owning reference to one member of an encoded object, pairing the
+    /// member's key with a pointer to its encoded value
+    typedef std::pair<internal::string_view, const char *> EncodedMember;
+
+    explicit CompactFrozenValue(std::vector<char> data)
+      : m_data(std::move(data)) { }
+
+    template<typename ValueType>
+    static void appendScalar(std::vector<char> &buffer, ValueType value)
+    {
+        const char *bytes = reinterpret_cast<const char *>(&value);
+        buffer.insert(buffer.end(), bytes, bytes + sizeof(value));
+    }
+
+    template<typename ValueType>
+    static ValueType readScalar(const char *&cursor)
+    {
+        ValueType value;
+        std::memcpy(&value, cursor, sizeof(value));
+        cursor += sizeof(value);
+        return value;
+    }
+
+    static bool encodeValue(const Adapter &value, std::vector<char> &buffer)
+    {
+        return encodeValue(value, buffer,
+                std::numeric_limits<size_t>::max());
+    }
+
+    /**
+     * @brief   Encode a value, abandoning the attempt soon after the output
+     *          exceeds a size limit
+     *
+     * The limit is checked between values rather than between bytes, so the
+     * output may briefly overshoot it; the caller enforces the limit on the
+     * finished encoding.
+     */
+    static bool encodeValue(const Adapter &value, std::vector<char> &buffer,
+            size_t maxBytes)
+    {
+        if (buffer.size() > maxBytes) {
+            return false;
+        }
+
+        if (value.isNull()) {
+            buffer.push_back(kNullTag);
+            return true;
+
+        } else if (value.isBool()) {
+            buffer.push_back(value.getBool() ? kTrueTag : kFalseTag);
+            return true;
+
+        } else if (value.isInteger()) {
+            buffer.push_back(kIntegerTag);
+            appendScalar<int64_t>(buffer, value.getInteger());
+            return true;
+
+        } else if (value.isNumber()) {
+            buffer.push_back(kDoubleTag);
+            appendScalar<double>(buffer, value.getNumber());
+            return true;
+
+        } else if (value.isString()) {
+            internal::string_view view;
+            std::string scratch;
+            if (!value.getStringView(view, scratch)) {
+                return false;
+            }
+
+            buffer.push_back(kStringTag);
+            appendScalar<uint32_t>(buffer,
+                    static_cast<uint32_t>(view.size()));
+            buffer.insert(buffer.end(), view.begin(), view.end());
+            return true;
+
+        } else if (value.isArray()) {
+            buffer.push_back(kArrayTag);
+            appendScalar<uint32_t>(buffer,
+                    static_cast<uint32_t>(value.getArraySize()));
+            return value.applyToArray([&buffer, maxBytes](const Adapter &element) {
+                return encodeValue(element, buffer, maxBytes);
+            });
+
+        } else if (value.isObject()) {
+            // Members are encoded into temporary buffers so that they can
+            // be emitted in key order, making the encoding independent of
+            // the adapter's member iteration order
+            typedef std::pair<std::string, std::vector<char>> Member;
+            std::vector<Member> members;
+            members.reserve(value.getObjectSize());
+
+            // Member buffers are separate from the output buffer, so the
+            // bytes accumulated across members are tracked explicitly to
+            // enforce the size limit
+            size_t encodedBytes = buffer.size();
+            const bool encoded = value.applyToObject(
+                    [&members, &encodedBytes, maxBytes](
+                            const std::string &key, const Adapter &member) {
+                        members.push_back(Member(key, std::vector<char>()));
+                        if (!encodeValue(member, members.back().second,
+                                maxBytes)) {
+                            return false;
+                        }
+                        encodedBytes += sizeof(uint32_t) + key.size() +
+                                members.back().second.size();
+                        return encodedBytes <= maxBytes;
+                    });
+            if (!encoded) {
+                return false;
+            }
+
+            std::sort(members.begin(), members.end(),
+                    [](const Member &lhs, const Member &rhs) {
+                        return lhs.first < rhs.first;
+                    });
+
+            buffer.push_back(kObjectTag);
+            appendScalar<uint32_t>(buffer,
+                    static_cast<uint32_t>(members.size()));
+            for (const Member &member : members) {
+                appendScalar<uint32_t>(buffer,
+                        static_cast<uint32_t>(member.first.size()));
+                buffer.insert(buffer.end(), member.first.begin(),
+                        member.first.end());
+                buffer.insert(buffer.end(), member.second.begin(),
+                        member.second.end());
+            }
+            return true;
+        }
+
+        // A value without a definite type cannot be encoded faithfully
+        return false;
+    }
+
+    /**
+     * @brief   Compare the encoded value at the cursor against an adapter
+     *
+     * The cursor is advanced past the encoded value as the comparison
+     * proceeds; once the comparison fails, the cursor is left mid-value and
+     * must not be read further, which is safe because failure propagates
+     * immediately to the caller.
+     *
+     * The comparison mirrors the type dispatch used by BasicAdapter's
+     * equalTo implementation, so a compact frozen value compares exactly as
+     * the adapter-specific frozen value it replaces would have.
+     */
+    static bool equalToValue(const char *&cursor, const Adapter &other,
+            bool strict)
+    {
+        const char tag = *cursor++;
+        switch (tag) {
+        case kNullTag:
+            return other.isNull() || (!strict && other.maybeNull());
+
+        case kFalseTag:
+        case kTrueTag:
+            return (other.isBool() || (!strict && other.maybeBool())) &&
+                    other.asBool() == (tag == kTrueTag);
+
+        case kIntegerTag:
+        case kDoubleTag: {
+            const double number = (tag == kIntegerTag) ?
+                    static_cast<double>(readScalar<int64_t>(cursor)) :
+                    readScalar<double>(cursor);
+            if (strict) {
+                return other.isNumber() && other.getNumber() == number;
+            }
+            double otherNumber = 0;
+            return other.asDouble(otherNumber) && otherNumber == number;
+        }
+
+        case kStringTag: {
+            const uint32_t size = readScalar<uint32_t>(cursor);
+            const internal::string_view encoded(cursor, size);
+            cursor += size;
+
+            if (!other.isString() && (strict || !other.maybeString())) {
+                return false;
+            }
+
+            internal::string_view view;
+            std::string scratch;
+            if (other.getStringView(view, scratch)) {
+                return view == encoded;
+            }
+
+            return other.asString(scratch) &&
+                    internal::string_view(scratch) == encoded;
+        }
+
+        case kArrayTag: {
+            const uint32_t numElements = readScalar<uint32_t>(cursor);
+            if (other.isArray() && other.getArraySize() == numElements) {
+                bool equal = true;
+                other.applyToArray(
+                        [&cursor, &equal, strict](const Adapter &element) {
+                            equal = equalToValue(cursor, element, strict);
+                            return equal;
+                        });
+                return equal;
+            }
+
+            return !strict && numElements == 0 && other.maybeArray();
+        }
+
+        case kObjectTag: {
+            const uint32_t numMembers = readScalar<uint32_t>(cursor);
+
+            // Build a table of the encoded members, which are stored in key
+            // order, while advancing the cursor past the object
+            std::vector<EncodedMember> members;
+            members.reserve(numMembers);
+            for (uint32_t index = 0; index < numMembers; index++) {
+                const uint32_t keySize = readScalar<uint32_t>(cursor);
+                const internal::string_view key(cursor, keySize);
+                cursor += keySize;
+                members.push_back(EncodedMember(key, cursor));
+                skipValue(cursor);
+            }
+
+            if (other.isObject() && other.getObjectSize() == numMembers) {
+                bool equal = true;
+                other.applyToObject(
+                        [&members, &equal, strict](const std::string &key,
+                                const Adapter &member) {
+                            const EncodedMember *encoded =
+                                    findMember(members, key);
+                            if (encoded == nullptr) {
+                                equal = false;
+                                return false;
+                            }
+                            const char *valueCursor = encoded->second;
+                            equal = equalToValue(valueCursor, member, strict);
+                            return equal;
+                        });
+                return equal;
+            }
+
+            return !strict && numMembers == 0 && other.maybeObject();
+        }
+
+        default:
+            return false;
+        }
+    }
+
+    /// Binary search a table of encoded object members by key
+    static const EncodedMember * findMember(
+            const std::vector<EncodedMember> &members, const std::string &key)
+    {
+        const internal::string_view keyView(key);
+        const auto itr = std::lower_bound(members.begin(), members.end(),
+                keyView,
+                [](const EncodedMember &member,
+                        const internal::string_view &sought) {
+                    return lessThan(member.first, sought);
+                });
+        if (itr == members.end() || itr->first != keyView) {
+            return nullptr;
+        }
+
+        return &(*itr);
+    }
+
+    /// Lexicographic comparison of two string views
+    static bool lessThan(const internal::string_view &lhs,
+            const internal::string_view &rhs)
+    {
+        const size_t commonSize = (std::min)(lhs.size(), rhs.size());
+        const int order = (commonSize == 0) ? 0 :
+                std::memcmp(lhs.data(), rhs.data(), commonSize);
+        return order < 0 || (order == 0 && lhs.size() < rhs.size());
+    }
+
+    /// Advance the cursor past the encoded value that begins at it
+    static void skipValue(const char *&cursor)
+    {
+        const char tag = *cursor++;
+        switch (tag) {
+        case kNullTag:
+        case kFalseTag:
+        case kTrueTag:
+            break;
+
+        case kIntegerTag:
+            cursor += sizeof(int64_t);
+            break;
+
+        case kDoubleTag:
+            cursor += sizeof(double);
+            break;
+
+        case kStringTag:
+            cursor += readScalar<uint32_t>(cursor);
+            break;
+
+        case kArrayTag: {
+            const uint32_t numElements = readScalar<uint32_t>(cursor);
+            for (uint32_t index = 0; index < numElements; index++) {
+                skipValue(cursor);
+            }
+            break;
+        }
+
+        case kObjectTag: {
+            const uint32_t numMembers = readScalar<uint32_t>(cursor);
+            for (uint32_t index = 0; index < numMembers; index++) {
+                cursor += readScalar<uint32_t>(cursor);
+                skipValue(cursor);
+            }
+            break;
+        }
+
+        default:
+            break;
+        }
+    }
+
+    /// Flat encoding of the frozen value
+    std::vector<char> m_data;
+};
+
+/**
+ * @brief   Freeze a composite value in a compact, adapter-independent form
+ *
+ * The returned frozen value stores the entire value in a single contiguous
+ * buffer and compares against candidate values by scanning that buffer,
+ * which avoids both the scattered allocations and the pointer chasing of an
+ * adapter-specific frozen document tree.
+ *
+ * @param   value  adapter for the value to be frozen
+ *
+ * @returns pointer to a new CompactFrozenValue, owned by the caller, or
+ *          nullptr if part of the value lacks a definite JSON type, as can
+ *          occur with weakly-typed adapters
+ */
+inline FrozenValue * freezeCompactValue(const Adapter &value)
+{
+    return CompactFrozenValue::freeze(value);
+}
+
+}  // namespace adapters
+}  // namespace valijson
@@ -1,10 +1,169 @@
 #pragma once
 
+#include <cstddef>
 #include <limits>
+#include <vector>
+
+#include <valijson/exceptions.hpp>
 
 namespace valijson {
 namespace internal {
 
+/**
+ * @brief  Monotonic arena allocator for schema parsing
+ *
+ * Memory is carved from large blocks using a simple bump pointer, and only
+ * returned to the system when the arena is destroyed (or released). This
+ * suits the allocation profile of schema parsing, where a Schema makes many
+ * small allocations that all share the Schema's lifetime: constraints end up
+ * contiguous in memory, and tearing down a fully parsed schema becomes a
+ * handful of block deallocations rather than one free per constraint.
+ *
+ * The CustomAlloc/CustomFree hooks used by Schema and Subschema are plain
+ * function pointers, so they cannot carry a pointer to an arena instance.
+ * The customAlloc/customFree trampolines below bridge that gap using a
+ * thread-local 'active' arena, established with a MonotonicArena::Scope:
+ *
+ *     internal::MonotonicArena arena;
+ *     {
+ *         internal::MonotonicArena::Scope scope(arena);
+ *         Schema schema(internal::MonotonicArena::customAlloc,
+ *                       internal::MonotonicArena::customFree);
+ *         parser.populateSchema(adapter, schema);
+ *         // ... validate within or after the scope ...
+ *     }
+ *
+ * A scope must be active whenever the schema allocates (construction,
+ * parsing, adding constraints, or compile()), and the arena must outlive
+ * the Schema. customFree is a no-op; the memory is reclaimed when the
+ * arena goes away.
+ */
+class MonotonicArena
+{
+public:
+    /**
+     * @brief  Construct an arena
+     *
+     * @param  blockSize  granularity at which blocks of memory are requested
+     *                    from the system; allocations larger than this are
+     *                    given a dedicated block
+     */
+    explicit MonotonicArena(size_t blockSize = 65536)
+      : m_blockSize(blockSize),
+        m_next(nullptr),
+        m_remaining(0) { }
+
+    MonotonicArena(const MonotonicArena &) = delete;
+    MonotonicArena & operator=(const MonotonicArena &) = delete;
+
+    ~MonotonicArena()
+    {
+        release();
+    }
+
+    /**
+     * @brief  Allocate a suitably aligned region of memory from the arena
+     */
+    void * allocate(size_t size)
+    {
+        const size_t alignment = alignof(std::max_align_t);
+        size = (size + alignment - 1) / alignment * alignment;
+
+        if (size > m_remaining) {
+            const size_t blockSize = size > m_blockSize ? size : m_blockSize;
+            char *block = static_cast<char *>(::operator new(blockSize));
+            m_blocks.push_back(block);
+            m_next = block;
+            m_remaining = blockSize;
+        }
+
+        void *result = m_next;
+        m_next += size;
+        m_remaining -= size;
+        return result;
+    }
+
+    /**
+     * @brief  Return all memory held by the arena to the system
+     *
+     * Everything previously allocated from the arena is invalidated.
+     */
+    void release()
+    {
+        for (char *block : m_blocks) {
+            ::operator delete(block);
+        }
+
+        m_blocks.clear();
+        m_next = nullptr;
+        m_remaining = 0;
+    }
+
+    /**
+     * @brief  CustomAlloc-compatible trampoline that allocates from the
+     *         thread's active arena
+     *
+     * @throws std::runtime_error if no arena is active on this thread
+     */
+    static void * customAlloc(size_t size)
+    {
+        MonotonicArena *arena = activeArena();
+        if (!arena) {
+            throwRuntimeError("No active MonotonicArena on this thread");
+        }
+
+        return arena->allocate(size);
+    }
+
+    /**
+     * @brief  CustomFree-compatible no-op
+     *
+     * Memory allocated from an arena is reclaimed when the arena is
+     * destroyed or released, so individual frees do nothing.
+     */
+    static void customFree(void *) { }
+
+    /**
+     * @brief  Makes an arena the active target of the customAlloc trampoline
+     *         for the current thread, for the lifetime of the Scope
+     */
+    class Scope
+    {
+    public:
+        explicit Scope(MonotonicArena &arena)
+          : m_previous(activeArena())
+        {
+            activeArena() = &arena;
+        }
+
+        Scope(const Scope &) = delete;
+        Scope & operator=(const Scope &) = delete;
+
+        ~Scope()
+        {
+            activeArena() = m_previous;
+        }
+
+    private:
+        MonotonicArena *m_previous;
+    };
+
+private:
+    static MonotonicArena *& activeArena()
+    {
+        static thread_local MonotonicArena *active = nullptr;
+        return active;
+    }
+
+    const size_t m_blockSize;
+
+    std::vector<char *> m_blocks;
+
+    char *m_next;
+
+    size_t m_remaining;
+};
+
 template<class T>
 class CustomAllocator
 {
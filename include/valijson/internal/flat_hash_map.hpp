@@ -0,0 +1,510 @@
+/**
+ * @file
+ *
+ * @brief   Lightweight open-addressing hash map for internal lookup tables
+ *
+ * The schema parser keys several of its caches - resolved documents, JSON
+ * Pointer targets and populated sub-schemas - on strings, and probes them on
+ * every '$ref' resolution. A red-black tree pays one allocation per node and
+ * O(log n) string comparisons per probe; this map stores its entries in a
+ * single flat array with linear probing, so a lookup is one hash, one index
+ * and typically one comparison.
+ *
+ * The map deliberately supports only the operations its callers need:
+ * insertion, lookup, iteration, erasure and clearing. Deletion uses
+ * backward shifting rather than tombstones - entries whose probe sequence
+ * crossed the vacated slot are moved back into it - so lookup cost does
+ * not degrade as entries are removed. Unlike node-based maps, iteration
+ * order is unspecified and references and iterators are invalidated by
+ * erasure as well as by insertion, so it is not a drop-in replacement for
+ * tables whose ordering or reference stability is observable (such as the
+ * constraint-owned property maps, whose iteration order determines
+ * error-report order).
+ *
+ * The allocator parameter composes with CustomAllocator from
+ * custom_allocator.hpp, so tables owned by a Schema can draw from the same
+ * custom allocation functions as the rest of the schema's storage.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+namespace valijson {
+namespace internal {
+
+template<
+        typename Key,
+        typename Value,
+        typename Hash = std::hash<Key>,
+        typename KeyEqual = std::equal_to<Key>,
+        typename Allocator = std::allocator<std::pair<Key, Value>>>
+class FlatHashMap
+{
+public:
+    typedef Key key_type;
+    typedef Value mapped_type;
+    typedef std::pair<Key, Value> value_type;
+    typedef size_t size_type;
+
+private:
+    /// A single bucket; the value is constructed in place only while the
+    /// bucket is occupied
+    struct Slot
+    {
+        bool occupied;
+
+        typename std::aligned_storage<sizeof(value_type),
+                alignof(value_type)>::type storage;
+
+        value_type * value()
+        {
+            return reinterpret_cast<value_type *>(&storage);
+        }
+
+        const value_type * value() const
+        {
+            return reinterpret_cast<const value_type *>(&storage);
+        }
+    };
+
+    typedef typename std::allocator_traits<Allocator>::
+            template rebind_alloc<Slot> SlotAllocator;
+    typedef std::allocator_traits<SlotAllocator> SlotAllocatorTraits;
+
+public:
+    class const_iterator;
+
+    class iterator
+    {
+        friend class FlatHashMap;
+        friend class const_iterator;
+
+    public:
+        iterator()
+          : m_slot(nullptr),
+            m_last(nullptr) { }
+
+        value_type & operator*() const
+        {
+            return *m_slot->value();
+        }
+
+        value_type * operator->() const
+        {
+            return m_slot->value();
+        }
+
+        iterator & operator++()
+        {
+            do {
+                ++m_slot;
+            } while (m_slot != m_last && !m_slot->occupied);
+            return *this;
+        }
+
+        bool operator==(const iterator &other) const
+        {
+            return m_slot == other.m_slot;
+        }
+
+        bool operator!=(const iterator &other) const
+        {
+            return m_slot != other.m_slot;
+        }
+
+    private:
+        iterator(Slot *slot, Slot *last)
+          : m_slot(slot),
+            m_last(last) { }
+
+        Slot *m_slot;
+        Slot *m_last;
+    };
+
+    class const_iterator
+    {
+        friend class FlatHashMap;
+
+    public:
+        const_iterator()
+          : m_slot(nullptr),
+            m_last(nullptr) { }
+
+        const_iterator(const iterator &other)
+          : m_slot(other.m_slot),
+            m_last(other.m_last) { }
+
+        const value_type & operator*() const
+        {
+            return *m_slot->value();
+        }
+
+        const value_type * operator->() const
+        {
+            return m_slot->value();
+        }
+
+        const_iterator & operator++()
+        {
+            do {
+                ++m_slot;
+            } while (m_slot != m_last && !m_slot->occupied);
+            return *this;
+        }
+
+        bool operator==(const const_iterator &other) const
+        {
+            return m_slot == other.m_slot;
+        }
+
+        bool operator!=(const const_iterator &other) const
+        {
+            return m_slot != other.m_slot;
+        }
+
+    private:
+        const_iterator(const Slot *slot, const Slot *last)
+          : m_slot(slot),
+            m_last(last) { }
+
+        const Slot *m_slot;
+        const Slot *m_last;
+    };
+
+    FlatHashMap()
+      : m_slots(nullptr),
+        m_capacity(0),
+        m_size(0) { }
+
+    explicit FlatHashMap(const Allocator &allocator)
+      : m_allocator(allocator),
+        m_slots(nullptr),
+        m_capacity(0),
+        m_size(0) { }
+
+    FlatHashMap(const FlatHashMap &other)
+      : m_hash(other.m_hash),
+        m_equal(other.m_equal),
+        m_allocator(other.m_allocator),
+        m_slots(nullptr),
+        m_capacity(0),
+        m_size(0)
+    {
+        reserveSlots(other.m_size);
+        for (const value_type &value : other) {
+            insert(value);
+        }
+    }
+
+    FlatHashMap(FlatHashMap &&other) noexcept
+      : m_hash(std::move(other.m_hash)),
+        m_equal(std::move(other.m_equal)),
+        m_allocator(std::move(other.m_allocator)),
+        m_slots(other.m_slots),
+        m_capacity(other.m_capacity),
+        m_size(other.m_size)
+    {
+        other.m_slots = nullptr;
+        other.m_capacity = 0;
+        other.m_size = 0;
+    }
+
+    FlatHashMap & operator=(const FlatHashMap &other)
+    {
+        if (this != &other) {
+            FlatHashMap copy(other);
+            swap(copy);
+        }
+        return *this;
+    }
+
+    FlatHashMap & operator=(FlatHashMap &&other) noexcept
+    {
+        if (this != &other) {
+            destroy();
+            m_hash = std::move(other.m_hash);
+            m_equal = std::move(other.m_equal);
+            m_allocator = std::move(other.m_allocator);
+            m_slots = other.m_slots;
+            m_capacity = other.m_capacity;
+            m_size = other.m_size;
+            other.m_slots = nullptr;
+            other.m_capacity = 0;
+            other.m_size = 0;
+        }
+        return *this;
+    }
+
+    ~FlatHashMap()
+    {
+        destroy();
+    }
+
+    iterator begin()
+    {
+        return firstOccupied();
+    }
+
+    const_iterator begin() const
+    {
+        return firstOccupied();
+    }
+
+    iterator end()
+    {
+        return iterator(m_slots + m_capacity, m_slots + m_capacity);
+    }
+
+    const_iterator end() const
+    {
+        return const_iterator(m_slots + m_capacity, m_slots + m_capacity);
+    }
+
+    /// Destroy all entries, retaining the bucket array for re-use
+    void clear()
+    {
+        for (size_type i = 0; i < m_capacity; i++) {
+            if (m_slots[i].occupied) {
+                m_slots[i].value()->~value_type();
+                m_slots[i].occupied = false;
+            }
+        }
+        m_size = 0;
+    }
+
+    bool empty() const
+    {
+        return m_size == 0;
+    }
+
+    size_type size() const
+    {
+        return m_size;
+    }
+
+    iterator find(const Key &key)
+    {
+        const size_type index = findSlot(key);
+        if (index == m_capacity) {
+            return end();
+        }
+        return iterator(m_slots + index, m_slots + m_capacity);
+    }
+
+    const_iterator find(const Key &key) const
+    {
+        const size_type index = findSlot(key);
+        if (index == m_capacity) {
+            return end();
+        }
+        return const_iterator(m_slots + index, m_slots + m_capacity);
+    }
+
+    /**
+     * @brief  Remove the entry for a key, if present
+     *
+     * Deletion uses backward shifting rather than tombstones: entries whose
+     * probe sequence crossed the vacated slot are moved back into it, so
+     * lookup cost does not degrade as entries are removed. Iterators and
+     * references are invalidated.
+     *
+     * @returns  the number of entries removed (zero or one)
+     */
+    size_type erase(const Key &key)
+    {
+        size_type index = findSlot(key);
+        if (index == m_capacity) {
+            return 0;
+        }
+
+        m_slots[index].value()->~value_type();
+        m_slots[index].occupied = false;
+        m_size--;
+
+        // Shift later entries back over the vacated slot when their ideal
+        // position lies at or before it
+        size_type probe = index;
+        while (true) {
+            probe = (probe + 1) & (m_capacity - 1);
+            if (!m_slots[probe].occupied) {
+                break;
+            }
+
+            const size_type ideal =
+                    m_hash(m_slots[probe].value()->first) & (m_capacity - 1);
+            const size_type probeDistance = (probe - ideal) & (m_capacity - 1);
+            const size_type vacatedDistance = (probe - index) & (m_capacity - 1);
+            if (probeDistance >= vacatedDistance) {
+                new (m_slots[index].value()) value_type(
+                        std::move(*m_slots[probe].value()));
+                m_slots[index].occupied = true;
+                m_slots[probe].value()->~value_type();
+                m_slots[probe].occupied = false;
+                index = probe;
+            }
+        }
+
+        return 1;
+    }
+
+    std::pair<iterator, bool> insert(const value_type &value)
+    {
+        return emplaceValue(value);
+    }
+
+    std::pair<iterator, bool> insert(value_type &&value)
+    {
+        return emplaceValue(std::move(value));
+    }
+
+    void swap(FlatHashMap &other) noexcept
+    {
+        std::swap(m_hash, other.m_hash);
+        std::swap(m_equal, other.m_equal);
+        std::swap(m_allocator, other.m_allocator);
+        std::swap(m_slots, other.m_slots);
+        std::swap(m_capacity, other.m_capacity);
+        std::swap(m_size, other.m_size);
+    }
+
+private:
+    /// Initial bucket count on first insertion; always a power of two so
+    /// that probing can mask rather than divide
+    static const size_type kInitialCapacity = 16;
+
+    template<typename ValueType>
+    std::pair<iterator, bool> emplaceValue(ValueType &&value)
+    {
+        reserveSlots(m_size + 1);
+
+        const size_type existing = findSlot(value.first);
+        if (existing != m_capacity) {
+            return std::make_pair(
+                    iterator(m_slots + existing, m_slots + m_capacity), false);
+        }
+
+        const size_type index = probeForInsert(value.first);
+        new (m_slots[index].value()) value_type(std::forward<ValueType>(value));
+        m_slots[index].occupied = true;
+        m_size++;
+
+        return std::make_pair(
+                iterator(m_slots + index, m_slots + m_capacity), true);
+    }
+
+    /// Return the index of the slot holding a key, or m_capacity if absent
+    size_type findSlot(const Key &key) const
+    {
+        if (m_capacity == 0) {
+            return 0;
+        }
+
+        size_type index = m_hash(key) & (m_capacity - 1);
+        while (m_slots[index].occupied) {
+            if (m_equal(m_slots[index].value()->first, key)) {
+                return index;
+            }
+            index = (index + 1) & (m_capacity - 1);
+        }
+
+        return m_capacity;
+    }
+
+    /// Return the index of the unoccupied slot where a new key belongs
+    size_type probeForInsert(const Key &key) const
+    {
+        size_type index = m_hash(key) & (m_capacity - 1);
+        while (m_slots[index].occupied) {
+            index = (index + 1) & (m_capacity - 1);
+        }
+
+        return index;
+    }
+
+    /// Grow the bucket array when needed to hold the given number of
+    /// entries below a load factor of 3/4
+    void reserveSlots(size_type numEntries)
+    {
+        if (m_capacity != 0 && numEntries * 4 <= m_capacity * 3) {
+            return;
+        }
+
+        size_type newCapacity =
+                m_capacity == 0 ? kInitialCapacity : m_capacity * 2;
+        while (numEntries * 4 > newCapacity * 3) {
+            newCapacity *= 2;
+        }
+
+        Slot * const oldSlots = m_slots;
+        const size_type oldCapacity = m_capacity;
+
+        m_slots = SlotAllocatorTraits::allocate(m_allocator, newCapacity);
+        m_capacity = newCapacity;
+        for (size_type i = 0; i < newCapacity; i++) {
+            m_slots[i].occupied = false;
+        }
+
+        for (size_type i = 0; i < oldCapacity; i++) {
+            if (!oldSlots[i].occupied) {
+                continue;
+            }
+            const size_type index =
+                    probeForInsert(oldSlots[i].value()->first);
+            new (m_slots[index].value()) value_type(
+                    std::move(*oldSlots[i].value()));
+            m_slots[index].occupied = true;
+            oldSlots[i].value()->~value_type();
+        }
+
+        if (oldSlots != nullptr) {
+            SlotAllocatorTraits::deallocate(m_allocator, oldSlots,
+                    oldCapacity);
+        }
+    }
+
+    iterator firstOccupied()
+    {
+        Slot *slot = m_slots;
+        Slot * const last = m_slots + m_capacity;
+        while (slot != last && !slot->occupied) {
+            ++slot;
+        }
+        return iterator(slot, last);
+    }
+
+    const_iterator firstOccupied() const
+    {
+        const Slot *slot = m_slots;
+        const Slot * const last = m_slots + m_capacity;
+        while (slot != last && !slot->occupied) {
+            ++slot;
+        }
+        return const_iterator(slot, last);
+    }
+
+    void destroy()
+    {
+        if (m_slots == nullptr) {
+            return;
+        }
+        clear();
+        SlotAllocatorTraits::deallocate(m_allocator, m_slots, m_capacity);
+        m_slots = nullptr;
+        m_capacity = 0;
+    }
+
+    Hash m_hash;
+    KeyEqual m_equal;
+    SlotAllocator m_allocator;
+    Slot *m_slots;
+    size_type m_capacity;
+    size_type m_size;
+};
+
+}  // namespace internal
+}  // namespace valijson
@@ -0,0 +1,219 @@
+/**
+ * @file
+ *
+ * @brief   Hash-consing pool that shares identical frozen values
+ *
+ * Large schemas repeat the same literals many times: status strings, the
+ * number zero, default objects. Each occurrence in a 'const' or 'enum'
+ * constraint is ordinarily frozen independently, producing a separate heap
+ * allocation - or a separate cloned tree - per constraint. The pool defined
+ * here is hash-consed on the canonical compact encoding of a value, so
+ * every occurrence of an identical literal within one schema shares a
+ * single immutable frozen instance, handed out through cheaply-clonable
+ * reference-counted wrappers.
+ */
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+#include <valijson/internal/adapter.hpp>
+#include <valijson/internal/compact_frozen_value.hpp>
+#include <valijson/internal/custom_allocator.hpp>
+#include <valijson/internal/frozen_value.hpp>
+
+namespace valijson {
+namespace adapters {
+
+/**
+ * @brief   FrozenValue that shares ownership of a pooled frozen instance
+ *
+ * Constraints treat the frozen values they hold as exclusively owned,
+ * cloning them when a constraint is copied and deleting them when it is
+ * destroyed. This wrapper preserves those semantics while sharing the
+ * underlying instance: cloning copies a reference count rather than the
+ * value, and the pooled instance is released when the last wrapper
+ * referring to it is destroyed.
+ */
+class SharedFrozenValue: public FrozenValue
+{
+public:
+    explicit SharedFrozenValue(std::shared_ptr<const FrozenValue> value)
+      : m_value(std::move(value)) { }
+
+    FrozenValue * clone() const override
+    {
+        return new SharedFrozenValue(m_value);
+    }
+
+    bool equalTo(const Adapter &other, bool strict) const override
+    {
+        return m_value->equalTo(other, strict);
+    }
+
+    /// Return the pooled instance that this wrapper refers to
+    const FrozenValue & underlying() const
+    {
+        return *m_value;
+    }
+
+private:
+    std::shared_ptr<const FrozenValue> m_value;
+};
+
+}  // namespace adapters
+
+namespace internal {
+
+/**
+ * @brief  Deduplicating storage for frozen 'const' and 'enum' values
+ *
+ * Values are keyed by their canonical compact encoding, which is
+ * independent of the adapter the schema was parsed with and of member
+ * iteration order, so structurally identical literals map to the same
+ * pooled instance regardless of where they appear in the schema.
+ *
+ * The constraint classes freeze values deep inside parsing code that has no
+ * reference to the schema being built. As with StringInternPool, that gap
+ * is bridged with a thread-local 'active' pool, established with a
+ * FrozenValuePool::Scope; SchemaParser activates the schema's own pool for
+ * the duration of a parse. Constraints built without an active pool freeze
+ * their values privately, as before.
+ *
+ * A pool must not be mutated while other threads are reading values that it
+ * owns; in practice, interning ends when schema construction does.
+ */
+class FrozenValuePool
+{
+public:
+    /**
+     * @brief  Establishes a pool as the active pool for the current thread
+     *
+     * The previously active pool, if any, is restored when the scope is
+     * destroyed. Scopes may be nested.
+     */
+    class Scope
+    {
+    public:
+        explicit Scope(FrozenValuePool &pool)
+          : m_previous(activePool())
+        {
+            activePool() = &pool;
+        }
+
+        Scope(const Scope &) = delete;
+        Scope & operator=(const Scope &) = delete;
+
+        ~Scope()
+        {
+            activePool() = m_previous;
+        }
+
+    private:
+        FrozenValuePool *m_previous;
+    };
+
+    /**
+     * @brief  Return the active pool for the current thread, or nullptr
+     */
+    static FrozenValuePool * active()
+    {
+        return activePool();
+    }
+
+    FrozenValuePool()
+      : m_values(kInitialBuckets, typename Values::hasher(),
+                typename Values::key_equal(),
+                typename Values::allocator_type()) { }
+
+    /**
+     * @brief  Construct a pool that uses custom memory management functions
+     *
+     * The pool's lookup table draws from the supplied functions; the pooled
+     * frozen instances themselves are allocated by the freeze functions
+     * that produce them.
+     *
+     * @param  allocFn  malloc- or new-like function to allocate memory
+     * @param  freeFn   free-like function to free memory allocated with
+     *                  the `allocFn` function
+     */
+    FrozenValuePool(CustomAllocator<void *>::CustomAlloc allocFn,
+            CustomAllocator<void *>::CustomFree freeFn)
+      : m_values(kInitialBuckets, typename Values::hasher(),
+                typename Values::key_equal(),
+                typename Values::allocator_type(allocFn, freeFn)) { }
+
+    FrozenValuePool(const FrozenValuePool &) = delete;
+    FrozenValuePool & operator=(const FrozenValuePool &) = delete;
+
+    FrozenValuePool(FrozenValuePool &&other) = default;
+    FrozenValuePool & operator=(FrozenValuePool &&other) = default;
+
+    /**
+     * @brief   Intern a value, sharing the frozen instance of any identical
+     *          value interned previously
+     *
+     * The value is keyed by its canonical compact encoding. On the first
+     * occurrence of a value, the supplied functor is invoked to freeze it
+     * and the result is stored; subsequent occurrences share that instance.
+     *
+     * @param   value     adapter for the value to be interned
+     * @param   freezeFn  functor returning a new FrozenValue for the value;
+     *                    only invoked on the first occurrence
+     *
+     * @returns pointer to a new SharedFrozenValue, owned by the caller, or
+     *          nullptr if the value cannot be canonically encoded, in which
+     *          case the caller should freeze the value privately
+     */
+    template<typename FreezeFn>
+    adapters::FrozenValue * intern(const adapters::Adapter &value,
+            const FreezeFn &freezeFn)
+    {
+        std::string encoding;
+        if (!adapters::CompactFrozenValue::encode(value, encoding)) {
+            return nullptr;
+        }
+
+        const typename Values::const_iterator itr = m_values.find(encoding);
+        if (itr != m_values.end()) {
+            return new adapters::SharedFrozenValue(itr->second);
+        }
+
+        std::shared_ptr<const adapters::FrozenValue> frozen(freezeFn());
+        m_values.insert(typename Values::value_type(std::move(encoding), frozen));
+        return new adapters::SharedFrozenValue(std::move(frozen));
+    }
+
+    /**
+     * @brief  Return the number of distinct values held by the pool
+     */
+    size_t size() const
+    {
+        return m_values.size();
+    }
+
+private:
+    /// Initial bucket count for the lookup table
+    static const size_t kInitialBuckets = 16;
+
+    typedef std::unordered_map<std::string,
+            std::shared_ptr<const adapters::FrozenValue>,
+            std::hash<std::string>, std::equal_to<std::string>,
+            CustomAllocator<std::pair<const std::string,
+                    std::shared_ptr<const adapters::FrozenValue>>>> Values;
+
+    static FrozenValuePool *& activePool()
+    {
+        static thread_local FrozenValuePool *pool = nullptr;
+        return pool;
+    }
+
+    /// Pooled instances, keyed by canonical compact encoding
+    Values m_values;
+};
+
+} // namespace internal
+} // namespace valijson
@@ -0,0 +1,116 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <string>
+
+#include <valijson/internal/string_view.hpp>
+
+namespace valijson {
+namespace internal {
+
+/**
+ * @brief  Combine a hash value with a seed
+ *
+ * Based on the algorithm used by boost::hash_combine.
+ */
+inline size_t combineHash(size_t seed, size_t value)
+{
+    return seed ^ (value + 0x9e3779b9 + (seed << 6) + (seed >> 2));
+}
+
+/**
+ * @brief  Compute an FNV-1a hash over a sequence of bytes
+ *
+ * Used for hashing string values without first copying them into a
+ * std::string.
+ */
+inline size_t hashBytes(const char *data, size_t size)
+{
+    size_t result = 2166136261u;
+    for (size_t i = 0; i < size; i++) {
+        result = (result ^ static_cast<unsigned char>(data[i])) * 16777619u;
+    }
+
+    return result;
+}
+
+/**
+ * @brief   Compute a canonical structural hash of a JSON value
+ *
+ * The hash is computed over the logical structure of a value, using the
+ * typed Adapter interface, so that equal values hash to the same result
+ * regardless of which underlying JSON parser they were loaded with.
+ *
+ * Hashing follows the semantics of Adapter::equalTo with strict types
+ * enabled: numbers are hashed by numeric value, so that integer and
+ * floating point representations of the same number hash identically, and
+ * object members are combined in an order-independent manner. Weakly-typed
+ * comparisons, where a string may compare equal to a number, cannot be
+ * modelled by a hash function and must be handled by deep comparison.
+ *
+ * @param   value  value to be hashed
+ *
+ * @returns computed hash for the value
+ */
+template<typename AdapterType>
+size_t hashJsonValue(const AdapterType &value)
+{
+    // Arbitrary seeds to distinguish values of different types
+    static const size_t nullSeed = 0xd16e8510;
+    static const size_t boolSeed = 0x422d4b57;
+    static const size_t numberSeed = 0x7d67862c;
+    static const size_t stringSeed = 0x330757d9;
+    static const size_t arraySeed = 0xa6303854;
+    static const size_t objectSeed = 0x9ca43302;
+
+    if (value.isNull()) {
+        return nullSeed;
+
+    } else if (value.isBool()) {
+        return combineHash(boolSeed, value.asBool() ? 1 : 0);
+
+    } else if (value.isNumber()) {
+        // Hashing the numeric value mirrors equalTo, which compares numbers
+        // using getNumber() irrespective of their underlying representation
+        double number = value.getNumber();
+        if (number == 0.0) {
+            // Normalise negative zero
+            number = 0.0;
+        }
+        return combineHash(numberSeed, std::hash<double>()(number));
+
+    } else if (value.isString()) {
+        // Viewing the string avoids a copy for adapters with stable storage
+        string_view view;
+        std::string scratch;
+        if (value.getStringView(view, scratch)) {
+            return combineHash(stringSeed, hashBytes(view.data(), view.size()));
+        }
+
+        const std::string str = value.asString();
+        return combineHash(stringSeed, hashBytes(str.data(), str.size()));
+
+    } else if (value.isArray()) {
+        size_t result = arraySeed;
+        for (const AdapterType element : value.asArray()) {
+            result = combineHash(result, hashJsonValue<AdapterType>(element));
+        }
+        return combineHash(result, static_cast<size_t>(value.getArraySize()));
+
+    } else if (value.isObject()) {
+        // Object members are combined with XOR, so that the result does not
+        // depend on the order in which an adapter iterates over them
+        size_t members = 0;
+        for (const typename AdapterType::ObjectMember member : value.asObject()) {
+            members ^= combineHash(std::hash<std::string>()(member.first),
+                    hashJsonValue<AdapterType>(member.second));
+        }
+        return combineHash(objectSeed, members);
+    }
+
+    return 0;
+}
+
+} // namespace internal
+} // namespace valijson
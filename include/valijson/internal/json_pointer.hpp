@@ -4,8 +4,10 @@
 #include <cerrno>
 #include <cstddef>
 #include <cstring>
+#include <deque>
 #include <stdexcept>
 #include <string>
+#include <vector>
 
 #include <valijson/internal/adapter.hpp>
 #include <valijson/internal/optional.hpp>
@@ -123,6 +125,160 @@ inline std::string extractReferenceToken(std::string::const_iterator begin,
     return token;
 }
 
+/**
+ * @brief   A JSON Pointer that has been tokenized and unescaped once, for
+ *          repeated resolution
+ *
+ * Resolving a JSON Pointer with resolveJsonPointer() re-tokenizes the
+ * pointer string and re-applies the RFC 6901 and RFC 3986 unescaping rules
+ * on every call. When the same pointer is resolved more than once - as
+ * happens when many '$ref' nodes name the same target - that work can be
+ * performed once by constructing a ParsedJsonPointer, which stores the
+ * decoded reference tokens, and calling resolve() against each document.
+ *
+ * Resolution follows the same rules and produces the same errors as
+ * resolveJsonPointer(), except that error messages describe the offending
+ * token and the complete pointer rather than the unprocessed remainder of
+ * the pointer string.
+ */
+class ParsedJsonPointer
+{
+public:
+    /**
+     * @brief   Tokenize and unescape a JSON Pointer string
+     *
+     * @param   jsonPointer  string containing complete JSON Pointer
+     *
+     * @throws  std::runtime_error if the pointer is non-empty but does not
+     *          begin with a leading slash, or contains a token with an
+     *          invalid %-encoded character sequence
+     */
+    explicit ParsedJsonPointer(const std::string &jsonPointer)
+      : m_jsonPointer(jsonPointer)
+    {
+        std::string::const_iterator itr = jsonPointer.begin();
+        const std::string::const_iterator end = jsonPointer.end();
+
+        if (itr != end && *itr != '/') {
+            throwRuntimeError("Expected reference token to begin with "
+                    "leading slash; remaining tokens: " +
+                    std::string(itr, end));
+        }
+
+        while (itr != end) {
+            const std::string::const_iterator next =
+                    std::find(itr + 1, end, '/');
+            std::string token = extractReferenceToken(itr + 1, next);
+
+            // Empty reference tokens should be ignored
+            if (!token.empty()) {
+                m_tokens.push_back(std::move(token));
+            }
+
+            itr = next;
+        }
+    }
+
+    /**
+     * @brief   Locate the value referenced by this pointer within a document
+     *
+     * @param   rootNode  node to use as root for JSON Pointer resolution
+     *
+     * @return  an instance of AdapterType that wraps the referenced node
+     */
+    template<typename AdapterType>
+    AdapterType resolve(const AdapterType &rootNode) const
+    {
+        // Nodes visited while consuming reference tokens; a deque preserves
+        // the addresses of its elements as it grows, so the 'current'
+        // pointer below remains valid
+        std::deque<AdapterType> visitedNodes;
+        const AdapterType *current = &rootNode;
+
+        for (const std::string &token : m_tokens) {
+            if (current->isArray()) {
+                visitedNodes.push_back(resolveArrayElement(*current, token));
+            } else if (current->maybeObject()) {
+                // Token must identify a member of the candidate object
+                typedef typename AdapterType::Object Object;
+
+                const Object object = current->asObject();
+                typename Object::const_iterator itr = object.find(token);
+                if (itr == object.end()) {
+                    throwRuntimeError("Expected reference token to identify "
+                            "an element in the current object; "
+                            "actual token: " + token);
+                }
+
+                visitedNodes.push_back(itr->second);
+            } else {
+                throwRuntimeError("Expected end of JSON Pointer, but at "
+                        "least one reference token has not been processed; "
+                        "in pointer: " + m_jsonPointer);
+            }
+
+            current = &visitedNodes.back();
+        }
+
+        return *current;
+    }
+
+private:
+    /**
+     * @brief   Dereference an array using a token that must contain a
+     *          non-negative integral index
+     */
+    template<typename AdapterType>
+    static AdapterType resolveArrayElement(const AdapterType &node,
+            const std::string &token)
+    {
+        if (token == "-") {
+            throwRuntimeError("Hyphens cannot be used as array indices "
+                    "since the requested array element does not yet exist");
+        }
+
+#if VALIJSON_USE_EXCEPTIONS
+        try {
+#endif
+            // Token must be a non-negative integer
+            const uint64_t index = std::stoul(token);
+            typedef typename AdapterType::Array Array;
+            const Array arr = node.asArray();
+            typename Array::const_iterator itr = arr.begin();
+            const uint64_t arrSize = arr.size();
+
+            if (arrSize == 0 || index > arrSize - 1) {
+                throwRuntimeError("Expected reference token to identify "
+                        "an element in the current array, but array index is "
+                        "out of bounds; actual token: " + token);
+            }
+
+            if (index > static_cast<uint64_t>(std::numeric_limits<std::ptrdiff_t>::max())) {
+                throwRuntimeError("Array index out of bounds; hard "
+                        "limit is " + std::to_string(
+                                std::numeric_limits<std::ptrdiff_t>::max()));
+            }
+
+            itr.advance(static_cast<std::ptrdiff_t>(index));
+            return *itr;
+
+#if VALIJSON_USE_EXCEPTIONS
+        } catch (std::invalid_argument &) {
+            throwRuntimeError("Expected reference token to contain a "
+                    "non-negative integer to identify an element in the "
+                    "current array; actual token: " + token);
+        }
+        abort();
+#endif
+    }
+
+    /// Original pointer string, retained for error messages
+    std::string m_jsonPointer;
+
+    /// Decoded reference tokens, in the order they are to be applied
+    std::vector<std::string> m_tokens;
+};
+
 /**
  * @brief   Recursively locate the value referenced by a JSON Pointer
  *
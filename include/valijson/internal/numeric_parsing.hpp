@@ -0,0 +1,131 @@
+/**
+ * @file
+ *
+ * @brief   Allocation-free parsing of strings as numbers
+ *
+ * Weakly-typed validation coerces string values to numbers for the numeric
+ * constraints, and the original conversion kernels paid for a string stream
+ * or a std::string copy on every coercion. The routines here parse directly
+ * from a character range: integers through a hand-rolled digit loop with
+ * exact overflow detection, and doubles through strtod over a small
+ * stack buffer, so that the common case performs no heap allocation.
+ *
+ * Both routines accept what their stream-based predecessors accepted -
+ * leading whitespace and an optional sign - and reject input with trailing
+ * characters, so that weak-type coercion behaves exactly as before.
+ */
+
+#pragma once
+
+#include <cctype>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+namespace valijson {
+namespace internal {
+
+/**
+ * @brief   Parse a character range as a signed 64-bit integer
+ *
+ * Leading whitespace and an optional leading sign are accepted; any other
+ * non-digit character, including trailing whitespace, causes the parse to
+ * fail, as does a value outside the range of int64_t.
+ *
+ * @param   data    pointer to the first character
+ * @param   size    number of characters
+ * @param   result  reference to be set to the parsed value
+ *
+ * @returns true if the entire range parsed as an integer
+ */
+inline bool parseInteger(const char *data, size_t size, int64_t &result)
+{
+    size_t pos = 0;
+    while (pos < size && std::isspace(static_cast<unsigned char>(data[pos]))) {
+        pos++;
+    }
+
+    bool negative = false;
+    if (pos < size && (data[pos] == '-' || data[pos] == '+')) {
+        negative = (data[pos] == '-');
+        pos++;
+    }
+
+    if (pos == size) {
+        return false;
+    }
+
+    // Accumulate into an unsigned value so that the magnitude of INT64_MIN,
+    // which has no positive int64_t counterpart, can be represented
+    const uint64_t limit = negative
+            ? static_cast<uint64_t>(INT64_MAX) + 1
+            : static_cast<uint64_t>(INT64_MAX);
+
+    uint64_t magnitude = 0;
+    for (; pos < size; pos++) {
+        const char c = data[pos];
+        if (c < '0' || c > '9') {
+            return false;
+        }
+
+        const uint64_t digit = static_cast<uint64_t>(c - '0');
+        if (magnitude > (limit - digit) / 10) {
+            return false;
+        }
+
+        magnitude = magnitude * 10 + digit;
+    }
+
+    result = negative
+            ? static_cast<int64_t>(~magnitude + 1)
+            : static_cast<int64_t>(magnitude);
+    return true;
+}
+
+/**
+ * @brief   Parse a character range as a double
+ *
+ * Accepts exactly what strtod accepts, including leading whitespace, and
+ * rejects input with trailing characters. Strings short enough for the
+ * stack buffer - which covers any number a schema is likely to meet - are
+ * parsed without heap allocation; longer strings fall back to a copy.
+ *
+ * @param   data    pointer to the first character
+ * @param   size    number of characters
+ * @param   result  reference to be set to the parsed value
+ *
+ * @returns true if the entire range parsed as a double
+ */
+inline bool parseDouble(const char *data, size_t size, double &result)
+{
+    if (size == 0) {
+        return false;
+    }
+
+    // strtod requires null-terminated storage, so the characters are copied
+    // into a stack buffer, or into a string for improbably long input
+    char buffer[128];
+    std::string overflow;
+    const char *begin;
+    if (size < sizeof(buffer)) {
+        std::memcpy(buffer, data, size);
+        buffer[size] = '\0';
+        begin = buffer;
+    } else {
+        overflow.assign(data, size);
+        begin = overflow.c_str();
+    }
+
+    char *end = nullptr;
+    const double value = strtod(begin, &end);
+    if (end == begin || end != begin + size) {
+        return false;
+    }
+
+    result = value;
+    return true;
+}
+
+}  // namespace internal
+}  // namespace valijson
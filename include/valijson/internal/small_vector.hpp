@@ -0,0 +1,340 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include <valijson/exceptions.hpp>
+
+namespace valijson {
+namespace internal {
+
+/**
+ * @brief  Vector with inline storage for a small number of elements
+ *
+ * Most sub-schemas hold only a handful of constraints, and most validation
+ * runs report only a handful of errors, so a std::vector pays a heap
+ * allocation plus a pointer chase for what is typically one to three
+ * elements. This container stores up to InlineCapacity elements directly
+ * within the object, and only spills to the heap when that capacity is
+ * exceeded. Spilled storage is obtained through the same CustomAlloc and
+ * CustomFree hooks used elsewhere by Schema and Subschema, so it can be
+ * placed in an arena alongside the constraints it refers to.
+ *
+ * Only the parts of the std::vector interface that are needed by Subschema
+ * and ValidationResults are provided. Iterators are plain pointers, and are
+ * invalidated by any operation that adds or removes elements.
+ */
+template<typename T, size_t InlineCapacity>
+class SmallVector
+{
+public:
+    /// Typedef for custom new-/malloc-like function
+    typedef void * (*CustomAlloc)(size_t size);
+
+    /// Typedef for custom free-like function
+    typedef void (*CustomFree)(void *);
+
+    // Standard container typedefs
+    typedef T value_type;
+    typedef T * iterator;
+    typedef const T * const_iterator;
+    typedef std::size_t size_type;
+
+    SmallVector()
+      : m_allocFn([](size_t size) { return ::operator new(size, std::nothrow); }),
+        m_freeFn(::operator delete),
+        m_data(inlineData()),
+        m_size(0),
+        m_capacity(InlineCapacity) { }
+
+    /**
+     * @brief  Construct a SmallVector using custom memory management
+     *         functions for spilled storage
+     *
+     * @param  allocFn  malloc- or new-like function used when the inline
+     *                  capacity is exceeded
+     * @param  freeFn   free-like function to free memory allocated with
+     *                  the `allocFn` function
+     */
+    SmallVector(CustomAlloc allocFn, CustomFree freeFn)
+      : m_allocFn(allocFn),
+        m_freeFn(freeFn),
+        m_data(inlineData()),
+        m_size(0),
+        m_capacity(InlineCapacity) { }
+
+    SmallVector(const SmallVector &other)
+      : m_allocFn(other.m_allocFn),
+        m_freeFn(other.m_freeFn),
+        m_data(inlineData()),
+        m_size(0),
+        m_capacity(InlineCapacity)
+    {
+        reserve(other.m_size);
+        for (size_type i = 0; i < other.m_size; i++) {
+            new (m_data + i) T(other.m_data[i]);
+            m_size++;
+        }
+    }
+
+    SmallVector(SmallVector &&other)
+      : m_allocFn(other.m_allocFn),
+        m_freeFn(other.m_freeFn),
+        m_data(inlineData()),
+        m_size(0),
+        m_capacity(InlineCapacity)
+    {
+        stealOrMove(other);
+    }
+
+    SmallVector & operator=(const SmallVector &other)
+    {
+        if (this != &other) {
+            clear();
+            reserve(other.m_size);
+            for (size_type i = 0; i < other.m_size; i++) {
+                new (m_data + i) T(other.m_data[i]);
+                m_size++;
+            }
+        }
+
+        return *this;
+    }
+
+    SmallVector & operator=(SmallVector &&other)
+    {
+        if (this != &other) {
+            clear();
+            releaseStorage();
+            m_allocFn = other.m_allocFn;
+            m_freeFn = other.m_freeFn;
+            stealOrMove(other);
+        }
+
+        return *this;
+    }
+
+    ~SmallVector()
+    {
+        clear();
+        releaseStorage();
+    }
+
+    iterator begin()
+    {
+        return m_data;
+    }
+
+    const_iterator begin() const
+    {
+        return m_data;
+    }
+
+    iterator end()
+    {
+        return m_data + m_size;
+    }
+
+    const_iterator end() const
+    {
+        return m_data + m_size;
+    }
+
+    T & operator[](size_type index)
+    {
+        return m_data[index];
+    }
+
+    const T & operator[](size_type index) const
+    {
+        return m_data[index];
+    }
+
+    T & front()
+    {
+        return m_data[0];
+    }
+
+    const T & front() const
+    {
+        return m_data[0];
+    }
+
+    T & back()
+    {
+        return m_data[m_size - 1];
+    }
+
+    const T & back() const
+    {
+        return m_data[m_size - 1];
+    }
+
+    bool empty() const
+    {
+        return m_size == 0;
+    }
+
+    size_type size() const
+    {
+        return m_size;
+    }
+
+    size_type capacity() const
+    {
+        return m_capacity;
+    }
+
+    void clear()
+    {
+        for (size_type i = 0; i < m_size; i++) {
+            m_data[i].~T();
+        }
+
+        m_size = 0;
+    }
+
+    void reserve(size_type capacity)
+    {
+        if (capacity > m_capacity) {
+            grow(capacity);
+        }
+    }
+
+    void push_back(const T &value)
+    {
+        if (m_size == m_capacity) {
+            grow(m_capacity * 2);
+        }
+
+        new (m_data + m_size) T(value);
+        m_size++;
+    }
+
+    void push_back(T &&value)
+    {
+        if (m_size == m_capacity) {
+            grow(m_capacity * 2);
+        }
+
+        new (m_data + m_size) T(std::move(value));
+        m_size++;
+    }
+
+    void pop_back()
+    {
+        m_size--;
+        m_data[m_size].~T();
+    }
+
+    /**
+     * @brief  Remove the elements in the range [first, last)
+     *
+     * Elements after the range are moved down to close the gap, as per
+     * std::vector::erase.
+     */
+    iterator erase(iterator first, iterator last)
+    {
+        iterator out = first;
+        for (iterator in = last; in != end(); ++in, ++out) {
+            *out = std::move(*in);
+        }
+
+        const size_type newSize = static_cast<size_type>(out - m_data);
+        while (m_size > newSize) {
+            pop_back();
+        }
+
+        return first;
+    }
+
+private:
+    T * inlineData()
+    {
+        return reinterpret_cast<T *>(&m_inlineStorage);
+    }
+
+    const T * inlineData() const
+    {
+        return reinterpret_cast<const T *>(&m_inlineStorage);
+    }
+
+    bool spilled() const
+    {
+        return m_data != inlineData();
+    }
+
+    /// Free spilled storage and point back at the inline buffer; elements
+    /// must already have been destroyed
+    void releaseStorage()
+    {
+        if (spilled()) {
+            m_freeFn(m_data);
+            m_data = inlineData();
+            m_capacity = InlineCapacity;
+        }
+    }
+
+    /// Take ownership of another vector's contents, stealing its spilled
+    /// storage where possible and moving element-wise otherwise
+    void stealOrMove(SmallVector &other)
+    {
+        if (other.spilled()) {
+            m_data = other.m_data;
+            m_size = other.m_size;
+            m_capacity = other.m_capacity;
+            other.m_data = other.inlineData();
+            other.m_size = 0;
+            other.m_capacity = InlineCapacity;
+        } else {
+            for (size_type i = 0; i < other.m_size; i++) {
+                new (m_data + i) T(std::move(other.m_data[i]));
+            }
+            m_size = other.m_size;
+            other.clear();
+        }
+    }
+
+    void grow(size_type capacity)
+    {
+        if (capacity < InlineCapacity) {
+            capacity = InlineCapacity;
+        }
+
+        T *data = static_cast<T *>(m_allocFn(capacity * sizeof(T)));
+        if (!data) {
+            throwRuntimeError("Failed to allocate memory for SmallVector");
+        }
+
+        for (size_type i = 0; i < m_size; i++) {
+            new (data + i) T(std::move(m_data[i]));
+            m_data[i].~T();
+        }
+
+        const size_type size = m_size;
+        m_size = 0;
+        releaseStorage();
+        m_data = data;
+        m_size = size;
+        m_capacity = capacity;
+    }
+
+    CustomAlloc m_allocFn;
+    CustomFree m_freeFn;
+
+    /// Storage for up to InlineCapacity elements, constructed in place
+    typename std::aligned_storage<sizeof(T) * InlineCapacity, alignof(T)>::type
+            m_inlineStorage;
+
+    /// Current element storage; either the inline buffer or a spilled block
+    T *m_data;
+
+    size_type m_size;
+
+    size_type m_capacity;
+};
+
+} // namespace internal
+} // namespace valijson
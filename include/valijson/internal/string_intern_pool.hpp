@@ -0,0 +1,333 @@
+#pragma once
+
+#include <cstddef>
+#include <cstring>
+#include <unordered_set>
+#include <vector>
+
+#include <valijson/internal/custom_allocator.hpp>
+#include <valijson/internal/json_hash.hpp>
+#include <valijson/internal/string_view.hpp>
+#include <valijson/exceptions.hpp>
+
+namespace valijson {
+namespace internal {
+
+/**
+ * @brief   Non-owning reference to an interned property name
+ *
+ * Keys interned through a StringInternPool are stored once per pool, so two
+ * references obtained from the same pool refer to equal names if and only
+ * if they point at the same characters. The comparison operators exploit
+ * this by comparing pointers before falling back to a length check and a
+ * character-wise comparison, which also handles references constructed
+ * directly over caller-owned storage, such as a property name read from a
+ * document during validation.
+ *
+ * The referenced characters are always followed by a NUL terminator when
+ * the reference was produced by a pool, which allows c_str() to be used
+ * with APIs that expect C-style strings.
+ */
+class InternedString
+{
+public:
+    InternedString()
+      : m_data(""),
+        m_size(0) { }
+
+    InternedString(const char *data, size_t size)
+      : m_data(data),
+        m_size(size) { }
+
+    explicit InternedString(const string_view &view)
+      : m_data(view.data()),
+        m_size(view.size()) { }
+
+    const char * c_str() const
+    {
+        return m_data;
+    }
+
+    const char * data() const
+    {
+        return m_data;
+    }
+
+    size_t size() const
+    {
+        return m_size;
+    }
+
+    bool empty() const
+    {
+        return m_size == 0;
+    }
+
+    bool operator==(const InternedString &other) const
+    {
+        if (m_data == other.m_data) {
+            return m_size == other.m_size;
+        }
+
+        return m_size == other.m_size &&
+                memcmp(m_data, other.m_data, m_size) == 0;
+    }
+
+    bool operator!=(const InternedString &other) const
+    {
+        return !(*this == other);
+    }
+
+    bool operator<(const InternedString &other) const
+    {
+        if (m_data == other.m_data) {
+            return m_size < other.m_size;
+        }
+
+        const size_t common = m_size < other.m_size ? m_size : other.m_size;
+        const int result = memcmp(m_data, other.m_data, common);
+        return result < 0 || (result == 0 && m_size < other.m_size);
+    }
+
+private:
+    const char *m_data;
+    size_t m_size;
+};
+
+/**
+ * @brief  Deduplicating storage for property-name strings
+ *
+ * Schemas repeat the same property names many times: a name that appears in
+ * a 'properties' map is typically also listed under 'required', and often
+ * recurs across many sub-schemas. This pool stores each distinct name once,
+ * in stable NUL-terminated storage carved from blocks obtained through the
+ * same CustomAlloc/CustomFree hooks used elsewhere by Schema, and hands out
+ * non-owning views into that storage. References remain valid for the
+ * lifetime of the pool.
+ *
+ * The CustomAlloc hooks used by the constraint classes are plain function
+ * pointers, so they cannot carry a pointer to a pool instance. As with
+ * MonotonicArena, that gap is bridged with a thread-local 'active' pool,
+ * established with a StringInternPool::Scope. SchemaParser activates the
+ * schema's own pool for the duration of a parse, so that the names stored
+ * by the parsed constraints all share the schema's storage. Constraints
+ * built without an active pool fall back to a small pool of their own.
+ *
+ * A pool must not be mutated while other threads are reading strings that
+ * it owns; in practice, interning ends when schema construction does.
+ */
+class StringInternPool
+{
+public:
+    /// Typedef for custom new-/malloc-like function
+    typedef void * (*CustomAlloc)(size_t size);
+
+    /// Typedef for custom free-like function
+    typedef void (*CustomFree)(void *);
+
+    /**
+     * @brief  Establishes a pool as the active pool for the current thread
+     *
+     * The previously active pool, if any, is restored when the scope is
+     * destroyed. Scopes may be nested.
+     */
+    class Scope
+    {
+    public:
+        explicit Scope(StringInternPool &pool)
+          : m_previous(activePool())
+        {
+            activePool() = &pool;
+        }
+
+        Scope(const Scope &) = delete;
+        Scope & operator=(const Scope &) = delete;
+
+        ~Scope()
+        {
+            activePool() = m_previous;
+        }
+
+    private:
+        StringInternPool *m_previous;
+    };
+
+    /**
+     * @brief  Return the active pool for the current thread, or nullptr
+     */
+    static StringInternPool * active()
+    {
+        return activePool();
+    }
+
+    StringInternPool()
+      : m_strings(kInitialBuckets, Hash(), Equal(),
+                typename Strings::allocator_type()),
+        m_blocks(typename Blocks::allocator_type()),
+        m_allocFn([](size_t size) { return ::operator new(size, std::nothrow); }),
+        m_freeFn(::operator delete),
+        m_next(nullptr),
+        m_remaining(0) { }
+
+    /**
+     * @brief  Construct a pool that uses custom memory management functions
+     *
+     * @param  allocFn  malloc- or new-like function to allocate memory
+     * @param  freeFn   free-like function to free memory allocated with
+     *                  the `allocFn` function
+     */
+    StringInternPool(CustomAlloc allocFn, CustomFree freeFn)
+      : m_strings(kInitialBuckets, Hash(), Equal(),
+                typename Strings::allocator_type(allocFn, freeFn)),
+        m_blocks(typename Blocks::allocator_type(allocFn, freeFn)),
+        m_allocFn(allocFn),
+        m_freeFn(freeFn),
+        m_next(nullptr),
+        m_remaining(0) { }
+
+    StringInternPool(const StringInternPool &) = delete;
+    StringInternPool & operator=(const StringInternPool &) = delete;
+
+    StringInternPool(StringInternPool &&other)
+      : m_strings(std::move(other.m_strings)),
+        m_blocks(std::move(other.m_blocks)),
+        m_allocFn(other.m_allocFn),
+        m_freeFn(other.m_freeFn),
+        m_next(other.m_next),
+        m_remaining(other.m_remaining)
+    {
+        other.m_blocks.clear();
+        other.m_strings.clear();
+        other.m_next = nullptr;
+        other.m_remaining = 0;
+    }
+
+    StringInternPool & operator=(StringInternPool &&other)
+    {
+        if (this != &other) {
+            for (char *block : m_blocks) {
+                m_freeFn(block);
+            }
+            m_strings = std::move(other.m_strings);
+            m_blocks = std::move(other.m_blocks);
+            m_allocFn = other.m_allocFn;
+            m_freeFn = other.m_freeFn;
+            m_next = other.m_next;
+            m_remaining = other.m_remaining;
+            other.m_blocks.clear();
+            other.m_strings.clear();
+            other.m_next = nullptr;
+            other.m_remaining = 0;
+        }
+
+        return *this;
+    }
+
+    ~StringInternPool()
+    {
+        for (char *block : m_blocks) {
+            m_freeFn(block);
+        }
+    }
+
+    /**
+     * @brief   Intern a string, returning a view of its canonical copy
+     *
+     * @param   data  pointer to the characters of the string
+     * @param   size  number of characters in the string
+     *
+     * @returns view of the pooled copy of the string, valid for the
+     *          lifetime of the pool
+     */
+    string_view intern(const char *data, size_t size)
+    {
+        const string_view probe(data, size);
+        const typename Strings::const_iterator itr = m_strings.find(probe);
+        if (itr != m_strings.end()) {
+            return *itr;
+        }
+
+        if (size + 1 > m_remaining) {
+            const size_t blockSize =
+                    size + 1 > kBlockSize ? size + 1 : kBlockSize;
+            char *block = static_cast<char *>(m_allocFn(blockSize));
+            if (!block) {
+                throwRuntimeError(
+                        "Failed to allocate memory for interned string");
+            }
+            m_blocks.push_back(block);
+            m_next = block;
+            m_remaining = blockSize;
+        }
+
+        char *copy = m_next;
+        memcpy(copy, data, size);
+        copy[size] = '\0';
+        m_next += size + 1;
+        m_remaining -= size + 1;
+
+        const string_view result(copy, size);
+        m_strings.insert(result);
+        return result;
+    }
+
+    /**
+     * @brief  Return true if no strings have been interned in this pool
+     */
+    bool empty() const
+    {
+        return m_strings.empty();
+    }
+
+private:
+    /// Granularity at which blocks of string storage are allocated
+    static const size_t kBlockSize = 4096;
+
+    /// Initial bucket count for the lookup table
+    static const size_t kInitialBuckets = 16;
+
+    struct Hash
+    {
+        size_t operator()(const string_view &view) const
+        {
+            return hashBytes(view.data(), view.size());
+        }
+    };
+
+    struct Equal
+    {
+        bool operator()(const string_view &lhs, const string_view &rhs) const
+        {
+            return lhs == rhs;
+        }
+    };
+
+    typedef std::unordered_set<string_view, Hash, Equal,
+            CustomAllocator<string_view>> Strings;
+
+    typedef std::vector<char *, CustomAllocator<char *>> Blocks;
+
+    static StringInternPool *& activePool()
+    {
+        static thread_local StringInternPool *pool = nullptr;
+        return pool;
+    }
+
+    /// Canonical views of the interned strings
+    Strings m_strings;
+
+    /// Blocks of character storage owned by the pool
+    Blocks m_blocks;
+
+    CustomAlloc m_allocFn;
+    CustomFree m_freeFn;
+
+    /// Bump pointer into the newest block
+    char *m_next;
+
+    /// Bytes remaining in the newest block
+    size_t m_remaining;
+};
+
+} // namespace internal
+} // namespace valijson
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <cstddef>
+#include <cstring>
+#include <string>
+
+namespace valijson {
+namespace internal {
+
+/**
+ * @brief   A lightweight, non-owning view of a contiguous character sequence
+ *
+ * This is a minimal C++11-compatible subset of std::string_view, used by the
+ * adapters to expose string values without copying them when the underlying
+ * storage is stable. A view remains valid only as long as the storage it
+ * refers to; for adapter strings this is typically the lifetime of the
+ * document that the adapter wraps.
+ */
+class string_view
+{
+public:
+    string_view()
+      : m_data(nullptr),
+        m_size(0) { }
+
+    string_view(const char *data, size_t size)
+      : m_data(data),
+        m_size(size) { }
+
+    string_view(const std::string &str)
+      : m_data(str.data()),
+        m_size(str.size()) { }
+
+    const char * data() const
+    {
+        return m_data;
+    }
+
+    size_t size() const
+    {
+        return m_size;
+    }
+
+    size_t length() const
+    {
+        return m_size;
+    }
+
+    bool empty() const
+    {
+        return m_size == 0;
+    }
+
+    const char * begin() const
+    {
+        return m_data;
+    }
+
+    const char * end() const
+    {
+        return m_data + m_size;
+    }
+
+    char operator[](size_t index) const
+    {
+        return m_data[index];
+    }
+
+    bool operator==(const string_view &other) const
+    {
+        return m_size == other.m_size &&
+                (m_size == 0 || memcmp(m_data, other.m_data, m_size) == 0);
+    }
+
+    bool operator!=(const string_view &other) const
+    {
+        return !(*this == other);
+    }
+
+    /// Return an owning std::string copy of the viewed characters
+    std::string to_string() const
+    {
+        return std::string(m_data, m_size);
+    }
+
+private:
+    const char *m_data;
+    size_t m_size;
+};
+
+} // namespace internal
+} // namespace valijson
@@ -0,0 +1,158 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace valijson {
+namespace internal {
+
+/**
+ * @brief   Lazily materialised description of the location being validated
+ *
+ * Each nested visit during validation pushes one of these frames onto the
+ * stack, recording either an array index or a pointer to a property name,
+ * together with a pointer to the parent frame. Building the chain is free of
+ * allocation; the human-readable path strings that accompany an error are
+ * only constructed when an error is actually pushed to a ValidationResults
+ * object, via materialize().
+ *
+ * A frame refers to its parent frame and, for properties, to a string owned
+ * by the caller, so a frame must not outlive the scope that created it. This
+ * is the natural shape of recursive validation, where child frames live in
+ * the stack frames of nested visit functions.
+ */
+class ValidationContext
+{
+public:
+    /**
+     * @brief  Construct a root frame, corresponding to the document root
+     */
+    ValidationContext()
+      : m_parent(nullptr),
+        m_kind(kRoot),
+        m_index(0),
+        m_property(nullptr),
+        m_depth(0) { }
+
+    /**
+     * @brief  Construct a frame for an array item
+     *
+     * @param  parent  frame for the enclosing value, which must outlive this
+     *                 frame
+     * @param  index   index of the array item being validated
+     */
+    ValidationContext(const ValidationContext &parent, size_t index)
+      : m_parent(&parent),
+        m_kind(kIndex),
+        m_index(index),
+        m_property(nullptr),
+        m_depth(parent.m_depth + 1) { }
+
+    /**
+     * @brief  Construct a frame for an object property
+     *
+     * @param  parent    frame for the enclosing value, which must outlive
+     *                   this frame
+     * @param  property  name of the property being validated; the string
+     *                   must outlive this frame
+     */
+    ValidationContext(const ValidationContext &parent, const std::string &property)
+      : m_parent(&parent),
+        m_kind(kProperty),
+        m_index(0),
+        m_property(&property),
+        m_depth(parent.m_depth + 1) { }
+
+    /// Depth of this frame below the document root, which is at depth zero
+    size_t depth() const
+    {
+        return m_depth;
+    }
+
+    /**
+     * @brief   Build the vector of path strings described by this chain of
+     *          frames
+     *
+     * The result matches the context vectors that were previously maintained
+     * eagerly, e.g. {"<root>", "[items]", "[0]"}.
+     *
+     * @returns vector containing one string per frame, from root to leaf
+     */
+    std::vector<std::string> materialize() const
+    {
+        std::vector<std::string> result;
+        materializeInto(result);
+        return result;
+    }
+
+    /**
+     * @brief   Build the path strings described by this chain of frames,
+     *          reusing the storage of an existing vector
+     *
+     * Equivalent to materialize(), but the path is written into the given
+     * vector, overwriting its contents. Strings already present keep their
+     * buffers where they are large enough, so a results object that is
+     * recycled across documents stops allocating for context paths once
+     * its buffers have grown to a typical error's depth.
+     *
+     * @param  result  vector to receive one string per frame, from root to
+     *                 leaf
+     */
+    void materializeInto(std::vector<std::string> &result) const
+    {
+        size_t depth = 1;
+        for (const ValidationContext *frame = m_parent; frame != nullptr;
+                frame = frame->m_parent) {
+            depth++;
+        }
+
+        result.resize(depth);
+        const ValidationContext *frame = this;
+        for (size_t i = depth; i-- > 0; frame = frame->m_parent) {
+            std::string &out = result[i];
+            out.clear();
+            switch (frame->m_kind) {
+            case kRoot:
+                out += "<root>";
+                break;
+            case kIndex:
+                out += '[';
+                out += std::to_string(frame->m_index);
+                out += ']';
+                break;
+            case kProperty:
+                out += '[';
+                out += *frame->m_property;
+                out += ']';
+                break;
+            }
+        }
+    }
+
+private:
+    enum Kind
+    {
+        kRoot,
+        kIndex,
+        kProperty
+    };
+
+    /// Frame for the enclosing value, or nullptr for the root frame
+    const ValidationContext *m_parent;
+
+    /// Discriminator for the value held by this frame
+    Kind m_kind;
+
+    /// Array index, used when m_kind is kIndex
+    size_t m_index;
+
+    /// Property name owned by the caller, used when m_kind is kProperty
+    const std::string *m_property;
+
+    /// Number of frames above this one
+    size_t m_depth;
+};
+
+} // namespace internal
+} // namespace valijson
@@ -0,0 +1,745 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <regex>
+#include <set>
+#include <string>
+#include <vector>
+
+#include <valijson/internal/validation_context.hpp>
+#include <valijson/schema.hpp>
+#include <valijson/validation_results.hpp>
+#include <valijson/validation_visitor.hpp>
+#include <valijson/validator.hpp>
+
+namespace valijson {
+
+/**
+ * @brief   Visitor that defers structural descent to an explicit work stack
+ *
+ * This visitor behaves like ValidationVisitor for all constraints that
+ * inspect the target value directly. For the structural constraints that
+ * account for unbounded recursion depth - 'properties', 'patternProperties',
+ * 'additionalProperties', 'items', 'additionalItems' and 'allOf' - it pushes
+ * a work item describing each child value and sub-schema onto a caller-owned
+ * stack, instead of validating the child with a nested visitor. The caller
+ * is expected to pop and evaluate those items in a loop, so the depth of the
+ * C++ call stack no longer grows with the depth of the document.
+ *
+ * Combinator keywords whose result depends on the outcome of their child
+ * schemas - 'anyOf', 'oneOf', 'not', 'if'/'then'/'else', 'contains' and
+ * schema dependencies - cannot be deferred, because the parent needs the
+ * child verdicts before it can produce its own. These fall back to the
+ * recursive behaviour inherited from ValidationVisitor, so C++ stack usage
+ * is bounded by the nesting of combinators in the schema, rather than by
+ * the nesting of the document being validated.
+ *
+ * Context frames and property name strings for deferred work items are
+ * allocated from caller-owned deques, which preserve the addresses of their
+ * elements as they grow; this keeps the parent pointers within each chain of
+ * context frames valid for the lifetime of the validation run.
+ */
+template<typename AdapterType, typename RegexEngine>
+class IterativeValidationVisitor: public ValidationVisitor<AdapterType, RegexEngine>
+{
+public:
+
+    /**
+     * @brief  A deferred unit of validation work
+     *
+     * Adapters are lightweight wrappers around values owned by the
+     * underlying document, so work items store the adapter by value.
+     */
+    struct WorkItem
+    {
+        WorkItem(const AdapterType &valueArg, const Subschema *subschemaArg,
+                const internal::ValidationContext *contextArg)
+          : value(valueArg),
+            subschema(subschemaArg),
+            context(contextArg) { }
+
+        /// Value to be validated
+        AdapterType value;
+
+        /// Sub-schema that the value must validate against
+        const Subschema *subschema;
+
+        /// Context frame for the value; points into the context arena
+        const internal::ValidationContext *context;
+    };
+
+    /// Stack of deferred work items, with the top at the back
+    typedef std::deque<WorkItem> WorkStack;
+
+    /// Arena that owns the context frames referenced by deferred work items
+    typedef std::deque<internal::ValidationContext> ContextArena;
+
+    /// Arena that owns the property names referenced by context frames
+    typedef std::deque<std::string> NameArena;
+
+    /**
+     * @brief  Construct a visitor for a single work item
+     *
+     * @param  target        Target value to be validated
+     * @param  context       Context frame for the target value; must remain
+     *                       valid for the lifetime of the validation run
+     * @param  strictTypes   Use strict type comparison
+     * @param  results       Optional pointer to a ValidationResults object
+     * @param  workStack     Stack that deferred work items are pushed onto
+     * @param  contextArena  Arena used to allocate child context frames
+     * @param  nameArena     Arena used to allocate property name strings
+     */
+    IterativeValidationVisitor(const AdapterType &target,
+            const internal::ValidationContext &context,
+            const bool strictTypes,
+            ValidationResults *results,
+            WorkStack &workStack,
+            ContextArena &contextArena,
+            NameArena &nameArena)
+      : ValidationVisitor<AdapterType, RegexEngine>(target, context, strictTypes, results),
+        m_target(target),
+        m_context(context),
+        m_results(results),
+        m_strictTypes(strictTypes),
+        m_workStack(workStack),
+        m_contextArena(contextArena),
+        m_nameArena(nameArena) { }
+
+    /**
+     * @brief   Defer validation against an AllOfConstraint
+     *
+     * One work item is pushed for each child schema, pairing it with the
+     * current target value. The verdicts of the child schemas are folded
+     * into the overall result when the deferred items are evaluated.
+     *
+     * @param   constraint  Constraint that the target must validate against
+     *
+     * @return  \c true, since child evaluation is deferred
+     */
+    bool visit(const constraints::AllOfConstraint &constraint) override
+    {
+        constraint.applyToSubschemas(
+                [this](unsigned int, const Subschema *subschema) {
+                    pushWorkItem(m_target, subschema, &m_context);
+                    return true;
+                });
+
+        return true;
+    }
+
+    /**
+     * @brief   Defer validation against a FusedObjectConstraint
+     *
+     * The single pass over the object's members evaluates required property
+     * membership, property name validity and the property count limits
+     * immediately, exactly as the recursive visitor would. Validation of the
+     * property values themselves - against 'properties',
+     * 'patternProperties' and 'additionalProperties' sub-schemas - is
+     * deferred to the work stack.
+     *
+     * @param   constraint  Constraint that the target must validate against
+     *
+     * @return  \c true if no immediate error was found; \c false otherwise
+     */
+    bool visit(const constraints::FusedObjectConstraint &constraint) override
+    {
+        if ((m_strictTypes && !m_target.isObject()) || !m_target.maybeObject()) {
+            return true;
+        }
+
+        typedef constraints::PropertiesConstraint::String PatternString;
+
+        bool validated = true;
+
+        const constraints::PropertiesConstraint *properties =
+                constraint.hasProperties() ? &constraint.getProperties() : nullptr;
+        const Subschema *additionalProperties = properties ?
+                properties->getAdditionalPropertiesSubschema() : nullptr;
+        const std::regex *combined = properties ?
+                properties->combinedPatternRegex() : nullptr;
+
+        const Subschema *propertyNamesSubschema = constraint.hasPropertyNames() ?
+                constraint.getPropertyNames().getSubschema() : nullptr;
+
+        const constraints::RequiredConstraint *required =
+                constraint.hasRequired() ? &constraint.getRequired() : nullptr;
+        const size_t numRequired = required ? required->requiredPropertyCount() : 0;
+        std::vector<bool> requiredFound(numRequired, false);
+
+        uint64_t numMembers = 0;
+
+        const typename AdapterType::Object object = m_target.asObject();
+        for (const typename AdapterType::ObjectMember m : object) {
+            numMembers++;
+
+            // Tick off required property names as they are seen, using the
+            // constraint's sorted name list rather than probing the object
+            if (required) {
+                const size_t index = required->findRequiredProperty(m.first);
+                if (index < numRequired) {
+                    requiredFound[index] = true;
+                }
+            }
+
+            // Validate the property's name immediately; name strings are
+            // shallow, so this does not recurse into the document. Unlike a
+            // standalone PropertyNamesConstraint, which rejects silently,
+            // an error description naming the offending property is recorded
+            if (propertyNamesSubschema) {
+                adapters::StdStringAdapter stringAdapter(m.first);
+                ValidationVisitor<adapters::StdStringAdapter, RegexEngine> nameValidator(
+                        stringAdapter, m_context, m_strictTypes, nullptr);
+                if (!nameValidator.validateSchema(*propertyNamesSubschema)) {
+                    if (!m_results) {
+                        return false;
+                    }
+                    m_results->pushError(m_context, ValidationResults::kPropertyNamesFailed,
+                            [&]() { return "Failed to validate property name against "
+                                    "'propertyNames' schema: '" + m.first + "'."; },
+                            propertyNamesSubschema);
+                    validated = false;
+                }
+            }
+
+            if (!properties) {
+                continue;
+            }
+
+            // Defer the property's value against the sub-schemas of any
+            // matching 'properties' and 'patternProperties' entries
+            bool matched = false;
+
+            if (const Subschema *subschema = properties->findPropertySubschema(m.first)) {
+                matched = true;
+                pushWorkItem(m.second, subschema, childContext(m.first));
+            }
+
+            if (!combined || std::regex_search(m.first, *combined)) {
+                properties->applyToPatternProperties(
+                        [&, this](const PatternString &pattern, const Subschema *subschema) {
+                            const std::regex &r = properties->getPatternPropertyRegex(pattern);
+                            if (std::regex_search(m.first, r)) {
+                                matched = true;
+                                pushWorkItem(m.second, subschema, childContext(m.first));
+                            }
+                            return true;
+                        });
+            }
+
+            // Fall back to the 'additionalProperties' sub-schema, if any,
+            // for properties that did not match by name or pattern
+            if (!matched) {
+                if (additionalProperties) {
+                    pushWorkItem(m.second, additionalProperties, childContext(m.first));
+                } else {
+                    if (!m_results) {
+                        return false;
+                    }
+                    m_results->pushError(m_context, ValidationResults::kPropertiesFailed,
+                            [&]() { return "Object contains a property "
+                                "that could not be validated using 'properties' "
+                                "or 'additionalProperties' constraints: '" + m.first + "'."; });
+                    validated = false;
+                }
+            }
+        }
+
+        // Report required properties that were never seen
+        if (required) {
+            for (size_t index = 0; index < numRequired; index++) {
+                if (requiredFound[index]) {
+                    continue;
+                }
+                if (!m_results) {
+                    return false;
+                }
+                m_results->pushError(m_context, ValidationResults::kRequiredMissing,
+                        [&]() { return "Missing required property '" + std::string(
+                                required->requiredPropertyAt(index).c_str()) + "'."; });
+                validated = false;
+            }
+        }
+
+        // Property count limits re-use the count accumulated while iterating
+        // above, rather than calling getObjectSize() again
+        if (constraint.hasMinProperties()) {
+            const uint64_t minProperties = constraint.getMinProperties().getMinProperties();
+            if (numMembers < minProperties) {
+                if (!m_results) {
+                    return false;
+                }
+                m_results->pushError(m_context, ValidationResults::kMinPropertiesNotReached,
+                        [&]() { return "Object should have no fewer than " + std::to_string(minProperties) +
+                        " properties."; });
+                validated = false;
+            }
+        }
+
+        if (constraint.hasMaxProperties()) {
+            const uint64_t maxProperties = constraint.getMaxProperties().getMaxProperties();
+            if (numMembers > maxProperties) {
+                if (!m_results) {
+                    return false;
+                }
+                m_results->pushError(m_context, ValidationResults::kMaxPropertiesExceeded,
+                        [&]() { return "Object should have no more than " + std::to_string(maxProperties) +
+                        " properties."; });
+                validated = false;
+            }
+        }
+
+        return validated;
+    }
+
+    /**
+     * @brief   Defer validation against a LinearItemsConstraint
+     *
+     * Size mismatches between the array and the tuple of 'items' schemas
+     * are reported immediately, exactly as the recursive visitor would
+     * report them. Validation of the individual items is deferred.
+     *
+     * @param   constraint  Constraint that the target must validate against
+     *
+     * @return  \c true if no immediate error was found; \c false otherwise
+     */
+    bool visit(const constraints::LinearItemsConstraint &constraint) override
+    {
+        // Ignore values that are not arrays
+        if ((m_strictTypes && !m_target.isArray()) || (!m_target.maybeArray())) {
+            return true;
+        }
+
+        const Subschema * const additionalItemsSubschema =
+                constraint.getAdditionalItemsSubschema();
+
+        const typename AdapterType::Array arr = m_target.asArray();
+        const size_t arrSize = arr.size();
+        const size_t itemSubschemaCount = constraint.getItemSubschemaCount();
+
+        bool validated = true;
+
+        typename AdapterType::Array::const_iterator itr = arr.begin();
+        size_t index = 0;
+
+        if (itemSubschemaCount > 0) {
+            if (!additionalItemsSubschema && arrSize > itemSubschemaCount) {
+                if (!m_results) {
+                    return false;
+                }
+                m_results->pushError(m_context, ValidationResults::kItemsFailed,
+                        [&]() { return "Array contains more items than allowed by items constraint."; });
+                validated = false;
+            }
+
+            // Defer as many items as possible using 'items' sub-schemas
+            constraint.applyToItemSubschemas(
+                    [&](unsigned int, const Subschema *subschema) {
+                        if (itr == arr.end()) {
+                            return false;
+                        }
+                        pushWorkItem(*itr, subschema, childContext(index));
+                        ++itr;
+                        ++index;
+                        return true;
+                    });
+        }
+
+        // Defer remaining items using the 'additionalItems' sub-schema
+        if (index < arrSize) {
+            if (additionalItemsSubschema) {
+                for (; itr != arr.end(); ++itr) {
+                    pushWorkItem(*itr, additionalItemsSubschema, childContext(index));
+                    index++;
+                }
+
+            } else if (m_results) {
+                m_results->pushError(m_context, ValidationResults::kItemsFailed,
+                        [&]() { return "Cannot validate item #" + std::to_string(index) +
+                        " or greater using 'items' constraint or 'additionalItems' constraint."; });
+                validated = false;
+
+            } else {
+                return false;
+            }
+        }
+
+        return validated;
+    }
+
+    /**
+     * @brief   Defer validation against a PropertiesConstraint
+     *
+     * Property matching - against the 'properties' map, the
+     * 'patternProperties' patterns and the 'additionalProperties' fallback -
+     * happens immediately, as does the error for a property that no schema
+     * covers. Validation of the matched property values is deferred.
+     *
+     * @param   constraint  Constraint that the target must validate against
+     *
+     * @return  \c true if no immediate error was found; \c false otherwise
+     */
+    bool visit(const constraints::PropertiesConstraint &constraint) override
+    {
+        if ((m_strictTypes && !m_target.isObject()) || !m_target.maybeObject()) {
+            return true;
+        }
+
+        // Track which properties have been matched by at least one schema
+        std::set<std::string> propertiesMatched;
+
+        const typename AdapterType::Object object = m_target.asObject();
+
+        // Defer properties with a matching entry in the 'properties' map
+        constraint.applyToProperties(
+                PushPropertyWorkItems(*this, object, &propertiesMatched));
+
+        // When a combined automaton covering all patternProperties patterns
+        // is available, scan each property name once to find the names that
+        // match at least one pattern; all other names can then be skipped by
+        // each of the per-pattern passes below
+        std::set<std::string> patternCandidates;
+        const std::set<std::string> *patternCandidatesPtr = nullptr;
+        if (const std::regex *combined = constraint.combinedPatternRegex()) {
+            for (const typename AdapterType::ObjectMember m : object) {
+                if (std::regex_search(m.first, *combined)) {
+                    patternCandidates.insert(m.first);
+                }
+            }
+            patternCandidatesPtr = &patternCandidates;
+        }
+
+        // Defer properties matching a 'patternProperties' pattern
+        constraint.applyToPatternProperties(
+                PushPatternPropertyWorkItems(*this, constraint, object,
+                        &propertiesMatched, patternCandidatesPtr));
+
+        // Defer unmatched properties using the 'additionalProperties'
+        // sub-schema, or report an error if there is none
+        const Subschema *additionalPropertiesSubschema =
+                constraint.getAdditionalPropertiesSubschema();
+        if (!additionalPropertiesSubschema) {
+            if (propertiesMatched.size() != m_target.getObjectSize()) {
+                if (m_results) {
+                    std::string unwanted;
+                    for (const typename AdapterType::ObjectMember m : object) {
+                        if (propertiesMatched.find(m.first) == propertiesMatched.end()) {
+                            unwanted = m.first;
+                            break;
+                        }
+                    }
+                    m_results->pushError(m_context, ValidationResults::kPropertiesFailed,
+                        [&]() { return "Object contains a property "
+                            "that could not be validated using 'properties' "
+                            "or 'additionalProperties' constraints: '" + unwanted + "'."; });
+                }
+
+                return false;
+            }
+
+            return true;
+        }
+
+        for (const typename AdapterType::ObjectMember m : object) {
+            if (propertiesMatched.find(m.first) == propertiesMatched.end()) {
+                pushWorkItem(m.second, additionalPropertiesSubschema,
+                        childContext(m.first));
+            }
+        }
+
+        return true;
+    }
+
+    /**
+     * @brief  Defer validation against a SingularItemsConstraint
+     *
+     * One work item is pushed for each item in the array, paired with the
+     * single 'items' sub-schema.
+     *
+     * @param  constraint  SingularItemsConstraint to validate against
+     *
+     * @returns  \c true, since item evaluation is deferred
+     */
+    bool visit(const constraints::SingularItemsConstraint &constraint) override
+    {
+        // Ignore values that are not arrays
+        if (!m_target.isArray()) {
+            return true;
+        }
+
+        const Subschema *itemsSubschema = constraint.getItemsSubschema();
+
+        // Default items sub-schema accepts all values
+        if (!itemsSubschema) {
+            return true;
+        }
+
+        size_t index = 0;
+        for (const AdapterType &item : m_target.getArray()) {
+            pushWorkItem(item, itemsSubschema, childContext(index));
+            index++;
+        }
+
+        return true;
+    }
+
+private:
+
+    /**
+     * @brief  Functor that defers object properties matched by a
+     *         'properties' constraint
+     */
+    struct PushPropertyWorkItems
+    {
+        PushPropertyWorkItems(IterativeValidationVisitor &visitor,
+                const typename AdapterType::Object &object,
+                std::set<std::string> *propertiesMatched)
+          : m_visitor(visitor),
+            m_object(object),
+            m_propertiesMatched(propertiesMatched) { }
+
+        template<typename StringType>
+        bool operator()(const StringType &propertyName, const Subschema *subschema) const
+        {
+            const std::string propertyNameKey(propertyName.c_str());
+            const typename AdapterType::Object::const_iterator itr =
+                    m_object.find(propertyNameKey);
+            if (itr == m_object.end()) {
+                return true;
+            }
+
+            m_propertiesMatched->insert(propertyNameKey);
+            m_visitor.pushWorkItem(itr->second, subschema,
+                    m_visitor.childContext(propertyNameKey));
+
+            return true;
+        }
+
+    private:
+        IterativeValidationVisitor &m_visitor;
+        const typename AdapterType::Object &m_object;
+        std::set<std::string> * const m_propertiesMatched;
+    };
+
+    /**
+     * @brief  Functor that defers object properties matched by a
+     *         'patternProperties' constraint
+     */
+    struct PushPatternPropertyWorkItems
+    {
+        PushPatternPropertyWorkItems(IterativeValidationVisitor &visitor,
+                const constraints::PropertiesConstraint &constraint,
+                const typename AdapterType::Object &object,
+                std::set<std::string> *propertiesMatched,
+                const std::set<std::string> *patternCandidates)
+          : m_visitor(visitor),
+            m_constraint(constraint),
+            m_object(object),
+            m_propertiesMatched(propertiesMatched),
+            m_patternCandidates(patternCandidates) { }
+
+        template<typename StringType>
+        bool operator()(const StringType &patternProperty, const Subschema *subschema) const
+        {
+            // The compiled regex is cached within the constraint itself, so
+            // the pattern is compiled at most once per schema
+            const std::regex &r = m_constraint.getPatternPropertyRegex(patternProperty);
+
+            typedef const typename AdapterType::ObjectMember ObjectMember;
+            for (const ObjectMember m : m_object) {
+                // Names outside the prefiltered candidate set are known not
+                // to match any of the patterns
+                if (m_patternCandidates &&
+                        m_patternCandidates->find(m.first) == m_patternCandidates->end()) {
+                    continue;
+                }
+
+                if (std::regex_search(m.first, r)) {
+                    m_propertiesMatched->insert(m.first);
+                    m_visitor.pushWorkItem(m.second, subschema,
+                            m_visitor.childContext(m.first));
+                }
+            }
+
+            return true;
+        }
+
+    private:
+        IterativeValidationVisitor &m_visitor;
+        const constraints::PropertiesConstraint &m_constraint;
+        const typename AdapterType::Object &m_object;
+        std::set<std::string> * const m_propertiesMatched;
+        const std::set<std::string> * const m_patternCandidates;
+    };
+
+    /**
+     * @brief  Allocate a context frame for an array item of the target
+     *
+     * @param  index  index of the array item
+     *
+     * @returns  pointer to a frame owned by the context arena
+     */
+    const internal::ValidationContext * childContext(size_t index)
+    {
+        m_contextArena.emplace_back(m_context, index);
+        return &m_contextArena.back();
+    }
+
+    /**
+     * @brief  Allocate a context frame for a property of the target
+     *
+     * The property name is copied into the name arena, so that the frame's
+     * pointer to it remains valid after the caller's string goes out of
+     * scope.
+     *
+     * @param  propertyName  name of the property
+     *
+     * @returns  pointer to a frame owned by the context arena
+     */
+    const internal::ValidationContext * childContext(const std::string &propertyName)
+    {
+        m_nameArena.push_back(propertyName);
+        m_contextArena.emplace_back(m_context, m_nameArena.back());
+        return &m_contextArena.back();
+    }
+
+    /// Push a deferred work item onto the top of the work stack
+    void pushWorkItem(const AdapterType &value, const Subschema *subschema,
+            const internal::ValidationContext *context)
+    {
+        m_workStack.emplace_back(value, subschema, context);
+    }
+
+    /// The JSON value being validated
+    const AdapterType m_target;
+
+    /// Context frame describing the location of the value being validated
+    const internal::ValidationContext &m_context;
+
+    /// Optional pointer to a ValidationResults object to be populated
+    ValidationResults * const m_results;
+
+    /// Option to use strict type comparison
+    const bool m_strictTypes;
+
+    /// Stack that deferred work items are pushed onto
+    WorkStack &m_workStack;
+
+    /// Arena used to allocate context frames for deferred work items
+    ContextArena &m_contextArena;
+
+    /// Arena used to allocate property name strings for context frames
+    NameArena &m_nameArena;
+};
+
+/**
+ * @brief   Validator that evaluates structural descent with an explicit
+ *          work stack, bounding C++ stack usage
+ *
+ * This validator produces the same verdict as ValidatorT, but descends into
+ * object properties, array items and 'allOf' child schemas by pushing work
+ * items onto an explicit stack and draining it in a loop, rather than by
+ * recursing. The depth of the C++ call stack is therefore bounded by the
+ * nesting of combinator keywords in the schema - which is fixed once the
+ * schema is parsed - rather than by the nesting of the document, removing
+ * the stack-overflow hazard posed by deeply nested untrusted documents.
+ *
+ * Two observable differences from ValidatorT follow from deferring child
+ * validation. Errors are reported in work-stack order rather than document
+ * order, and the summary errors that the recursive visitor adds at the
+ * parent level when a child schema fails (e.g. "Failed to validate against
+ * schema associated with property name ...") are not produced; the errors
+ * recorded at the failing location itself, with their full context paths,
+ * are unaffected.
+ *
+ * @tparam  RegexEngine  regular expression engine used for pattern
+ *                       constraint validation
+ */
+template<typename RegexEngine>
+class IterativeValidatorT
+{
+public:
+    enum TypeCheckingMode
+    {
+        kStrongTypes,
+        kWeakTypes
+    };
+
+    /**
+     * @brief  Construct a validator that uses strong type checking by default
+     */
+    IterativeValidatorT()
+      : strictTypes(true) { }
+
+    /**
+     * @brief  Construct a validator using a specific type checking mode
+     *
+     * @param  typeCheckingMode  choice of strong or weak type checking
+     */
+    IterativeValidatorT(TypeCheckingMode typeCheckingMode)
+      : strictTypes(typeCheckingMode == kStrongTypes) { }
+
+    /**
+     * @brief  Validate a JSON document and optionally return the results.
+     *
+     * When a ValidationResults object is provided via the \c results
+     * parameter, validation will continue to drain the work stack even after
+     * a failure has been recorded, so that every reachable error is
+     * reported. If a pointer to a ValidationResults instance is not
+     * provided, validation stops at the first work item that fails.
+     *
+     * @param  schema   The schema to validate against
+     * @param  target   The document to be validated
+     * @param  results  An optional pointer to a ValidationResults instance
+     *                  that will be used to report validation errors
+     *
+     * @returns  true if validation succeeds, false otherwise
+     */
+    template<typename AdapterType>
+    bool validate(const Subschema &schema, const AdapterType &target,
+            ValidationResults *results) const
+    {
+        typedef IterativeValidationVisitor<AdapterType, RegexEngine> Visitor;
+
+        // Deques preserve the addresses of their elements as they grow, so
+        // the parent pointers within each chain of context frames, and the
+        // frames' pointers to property names, remain valid while new work
+        // items are pushed
+        typename Visitor::ContextArena contextArena;
+        typename Visitor::NameArena nameArena;
+        typename Visitor::WorkStack workStack;
+
+        contextArena.emplace_back();
+        workStack.emplace_back(target, &schema, &contextArena.front());
+
+        bool validated = true;
+        while (!workStack.empty()) {
+            const typename Visitor::WorkItem item = workStack.back();
+            workStack.pop_back();
+
+            Visitor visitor(item.value, *item.context, strictTypes, results,
+                    workStack, contextArena, nameArena);
+            if (!visitor.validateSchema(*item.subschema)) {
+                if (!results) {
+                    return false;
+                }
+
+                validated = false;
+                if (results->errorBudgetExhausted()) {
+                    break;
+                }
+            }
+        }
+
+        return validated;
+    }
+
+private:
+
+    /// Flag indicating that strict type comparisons should be used
+    bool strictTypes;
+};
+
+using IterativeValidator = IterativeValidatorT<DefaultRegexEngine>;
+
+}  // namespace valijson
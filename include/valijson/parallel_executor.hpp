@@ -0,0 +1,188 @@
+/**
+ * @file
+ *
+ * @brief   Executor interface for parallel evaluation of combinator branches
+ *
+ * A schema with a wide 'oneOf' or 'anyOf' combinator forces a validator to
+ * walk many candidate sub-schemas for a single document, and single-document
+ * latency is then dominated by branches that fail late. The ParallelExecutor
+ * interface lets a caller supply a bounded source of parallelism that a
+ * ValidationVisitor can use to evaluate combinator branches concurrently;
+ * see ParallelOptions for how it is attached to a validation run.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <valijson/exceptions.hpp>
+
+namespace valijson {
+
+/**
+ * @brief   Interface through which batches of independent tasks are executed
+ *
+ * Implementations are free to run tasks on any number of threads, including
+ * the calling thread, but must execute every task in the batch and must not
+ * return from run() until all of them have completed. An executor may be
+ * shared by several validation runs, so implementations should be safe to
+ * call from multiple threads.
+ */
+class ParallelExecutor
+{
+public:
+    virtual ~ParallelExecutor() = default;
+
+    /**
+     * @brief  Execute every task in a batch, returning once all are complete
+     *
+     * @param  tasks  batch of independent tasks to execute
+     */
+    virtual void run(std::vector<std::function<void()>> &tasks) = 0;
+};
+
+/**
+ * @brief   ParallelExecutor that runs each batch on a bounded set of threads
+ *
+ * Worker threads are started per batch and consume tasks through a shared
+ * atomic cursor, with the calling thread participating as one of the
+ * workers. This keeps the executor self-contained - there is no pool to
+ * manage - at the cost of thread start-up overhead per batch, which is only
+ * worth paying when the branches being evaluated are substantial.
+ */
+class ThreadParallelExecutor: public ParallelExecutor
+{
+public:
+    /**
+     * @brief  Construct an executor with a bounded worker count
+     *
+     * @param  numThreads  maximum number of threads used per batch,
+     *                     including the calling thread, or 0 to use one
+     *                     thread per hardware thread
+     */
+    explicit ThreadParallelExecutor(size_t numThreads = 0)
+      : m_numThreads(numThreads > 0 ? numThreads : defaultNumThreads()) { }
+
+    void run(std::vector<std::function<void()>> &tasks) override
+    {
+        if (tasks.empty()) {
+            return;
+        }
+
+        const size_t numWorkers = (std::min)(m_numThreads, tasks.size());
+        if (numWorkers <= 1) {
+            for (auto &task : tasks) {
+                task();
+            }
+            return;
+        }
+
+        std::atomic<size_t> cursor(0);
+
+#if VALIJSON_USE_EXCEPTIONS
+        std::mutex exceptionMutex;
+        std::exception_ptr firstException;
+#endif
+
+        const auto worker = [&]() {
+            while (true) {
+                const size_t index = cursor.fetch_add(1);
+                if (index >= tasks.size()) {
+                    return;
+                }
+#if VALIJSON_USE_EXCEPTIONS
+                try {
+                    tasks[index]();
+                } catch (...) {
+                    std::lock_guard<std::mutex> lock(exceptionMutex);
+                    if (!firstException) {
+                        firstException = std::current_exception();
+                    }
+                }
+#else
+                tasks[index]();
+#endif
+            }
+        };
+
+        std::vector<std::thread> threads;
+        threads.reserve(numWorkers - 1);
+        for (size_t i = 0; i + 1 < numWorkers; i++) {
+            threads.emplace_back(worker);
+        }
+
+        // The calling thread works through the same batch rather than
+        // blocking, so a batch never needs more than numWorkers - 1 threads
+        worker();
+
+        for (std::thread &thread : threads) {
+            thread.join();
+        }
+
+#if VALIJSON_USE_EXCEPTIONS
+        if (firstException) {
+            std::rethrow_exception(firstException);
+        }
+#endif
+    }
+
+private:
+    static size_t defaultNumThreads()
+    {
+        const unsigned int numCores = std::thread::hardware_concurrency();
+        return numCores > 0 ? numCores : 2;
+    }
+
+    size_t m_numThreads;
+};
+
+/**
+ * @brief   Options controlling parallel evaluation of combinator branches
+ *
+ * When an executor is provided, a ValidationVisitor evaluates the branches
+ * of 'oneOf' and 'anyOf' constraints with at least minBranches branches as
+ * one batch of tasks, aggregating per-branch outcomes in branch order so
+ * that the verdict and the order of reported errors match serial
+ * evaluation. Combinators below the threshold, and combinators nested
+ * inside a branch that is already being evaluated in parallel, are
+ * evaluated serially.
+ *
+ * Note that parallel evaluation is speculative: every branch is evaluated,
+ * whereas serial 'anyOf' evaluation stops at the first success. This trades
+ * extra work for lower single-document latency, which is the intended use.
+ */
+struct ParallelOptions
+{
+    ParallelOptions()
+      : executor(nullptr),
+        minBranches(8) { }
+
+    /**
+     * @brief  Construct options that enable parallel branch evaluation
+     *
+     * @param  branchExecutor   executor used to run branch batches; must
+     *                          outlive the validation runs that use it
+     * @param  branchThreshold  minimum number of branches a combinator must
+     *                          have before its branches are evaluated in
+     *                          parallel
+     */
+    explicit ParallelOptions(ParallelExecutor *branchExecutor,
+            size_t branchThreshold = 8)
+      : executor(branchExecutor),
+        minBranches(branchThreshold) { }
+
+    /// Executor used to run branch batches, or nullptr to disable parallel
+    /// evaluation
+    ParallelExecutor *executor;
+
+    /// Minimum branch count for parallel evaluation of a combinator
+    size_t minBranches;
+};
+
+}  // namespace valijson
@@ -0,0 +1,168 @@
+/**
+ * @file
+ *
+ * @brief   Process-wide cache of compiled regular expressions
+ *
+ * Deployments that load many schemas tend to repeat a small set of patterns
+ * (UUIDs, ISO-8601 timestamps, email addresses), and compiling each
+ * occurrence independently makes warmup time and memory usage scale with the
+ * number of schemas rather than the number of distinct patterns. RegexCache
+ * maintains one compiled engine per distinct pattern string, shared by every
+ * schema and validator in the process; PatternConstraint consults it when a
+ * pattern is first used.
+ *
+ * The cache is templated on the regular expression engine, mirroring
+ * ValidatorT<RegexEngine>, so each engine type maintains its own set of
+ * compiled patterns.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace valijson {
+
+/**
+ * @brief   Process-wide, thread-safe store of compiled regular expressions
+ *
+ * Compiled engines are handed out as shared pointers, so an entry remains
+ * valid for as long as any constraint refers to it, even if the cache is
+ * cleared in the meantime.
+ *
+ * @tparam  RegexEngine  regular expression engine whose compiled form is
+ *                       cached; must be constructible from a pattern string
+ */
+template<typename RegexEngine>
+class RegexCache
+{
+public:
+    /**
+     * @brief   Counters describing cache effectiveness
+     *
+     * A high ratio of hits to misses indicates that patterns are being
+     * shared across schemas; the number of misses is also the number of
+     * times a pattern has been compiled.
+     */
+    struct Statistics
+    {
+        /// Number of distinct patterns currently held by the cache
+        size_t numCompiledPatterns;
+
+        /// Number of lookups satisfied by an existing compiled pattern
+        size_t numHits;
+
+        /// Number of lookups that required a pattern to be compiled
+        size_t numMisses;
+    };
+
+    /**
+     * @brief   Return the process-wide cache instance for this engine type
+     */
+    static RegexCache & instance()
+    {
+        static RegexCache cache;
+        return cache;
+    }
+
+    /**
+     * @brief   Return a compiled engine for a pattern, compiling it if no
+     *          other schema has used the pattern yet
+     *
+     * Compilation takes place outside the cache lock, so a slow pattern does
+     * not stall lookups for unrelated patterns. If two threads race to
+     * compile the same pattern, one of the compiled engines is discarded and
+     * both threads receive the engine that was inserted first.
+     *
+     * @param   pattern  regular expression to look up
+     *
+     * @returns shared pointer to the compiled engine
+     */
+    std::shared_ptr<const RegexEngine> fetch(const std::string &pattern)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            const auto itr = m_entries.find(pattern);
+            if (itr != m_entries.end()) {
+                m_numHits++;
+                return itr->second;
+            }
+        }
+
+        auto compiled = std::make_shared<const RegexEngine>(pattern);
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        const auto result = m_entries.emplace(pattern, std::move(compiled));
+        if (result.second) {
+            m_numMisses++;
+        } else {
+            m_numHits++;
+        }
+
+        return result.first->second;
+    }
+
+    /**
+     * @brief   Compile a set of patterns ahead of first use
+     *
+     * Intended to be called at startup with the patterns known to be shared
+     * across a deployment's schemas, so that no validation request pays for
+     * compiling them.
+     *
+     * @param   patterns  patterns to compile and cache
+     */
+    void prewarm(const std::vector<std::string> &patterns)
+    {
+        for (const std::string &pattern : patterns) {
+            fetch(pattern);
+        }
+    }
+
+    /**
+     * @brief   Return a snapshot of the cache's counters
+     */
+    Statistics statistics() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return { m_entries.size(), m_numHits, m_numMisses };
+    }
+
+    /**
+     * @brief   Discard all cached patterns and reset the counters
+     *
+     * Engines that are still referenced by a constraint remain valid; the
+     * cache merely stops handing them out, and subsequent lookups for the
+     * same patterns will re-compile them.
+     */
+    void clear()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_entries.clear();
+        m_numHits = 0;
+        m_numMisses = 0;
+    }
+
+private:
+    RegexCache() = default;
+
+    RegexCache(const RegexCache &) = delete;
+    RegexCache & operator=(const RegexCache &) = delete;
+
+    /// Guards access to the entry map and counters
+    mutable std::mutex m_mutex;
+
+    /// Compiled engines keyed by their pattern string
+    std::unordered_map<std::string, std::shared_ptr<const RegexEngine>> m_entries;
+
+    /// Number of lookups satisfied without compiling
+    size_t m_numHits = 0;
+
+    /// Number of lookups that compiled a pattern
+    size_t m_numMisses = 0;
+};
+
+}  // namespace valijson
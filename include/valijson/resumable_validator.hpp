@@ -0,0 +1,198 @@
+/**
+ * @file
+ *
+ * @brief   Resumable validation in bounded-work slices for event loops
+ *
+ * A single-threaded event loop cannot afford to validate a huge document in
+ * one call, because every other connection on the loop waits for it. The
+ * iterative engine already drives validation by draining an explicit work
+ * stack, so its loop can be paused between work items and resumed later.
+ * ResumableValidationT exposes that as a session object: the caller creates
+ * a session for one document, repeatedly asks it to process a bounded slice
+ * of work - counted in work items or in wall-clock time - and interleaves
+ * those slices with I/O, without threads.
+ *
+ * The verdict and error reporting match IterativeValidatorT exactly; only
+ * the pacing differs.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+
+#include <valijson/internal/validation_context.hpp>
+#include <valijson/iterative_validator.hpp>
+#include <valijson/schema.hpp>
+#include <valijson/validation_results.hpp>
+#include <valijson/validator.hpp>
+
+namespace valijson {
+
+/**
+ * @brief   A single validation run that can be paused and resumed
+ *
+ * The session owns all intermediate state - the work stack, context frames
+ * and property names - so nothing is held on the C++ stack between slices.
+ * The schema, the target document and the optional results object must
+ * outlive the session.
+ *
+ * When a ValidationResults object is provided, the session continues to
+ * drain the work stack after a failure so that every reachable error is
+ * reported, exactly as IterativeValidatorT does; without one, the session
+ * completes at the first work item that fails.
+ *
+ * @tparam  AdapterType  adapter for the document being validated
+ * @tparam  RegexEngine  regular expression engine used for pattern
+ *                       constraint validation
+ */
+template<typename AdapterType, typename RegexEngine = DefaultRegexEngine>
+class ResumableValidationT
+{
+public:
+    /**
+     * @brief  Begin a validation session
+     *
+     * No validation work is performed until the first slice is requested.
+     *
+     * @param  schema       schema to validate against; must outlive the
+     *                      session
+     * @param  target       document to be validated; must outlive the
+     *                      session
+     * @param  results      optional pointer to a ValidationResults instance
+     *                      that will be used to report validation errors
+     * @param  strictTypes  use strict type comparison
+     */
+    ResumableValidationT(const Subschema &schema, const AdapterType &target,
+            ValidationResults *results = nullptr, bool strictTypes = true)
+      : m_results(results),
+        m_strictTypes(strictTypes),
+        m_complete(false),
+        m_validated(true)
+    {
+        m_contextArena.emplace_back();
+        m_workStack.emplace_back(target, &schema, &m_contextArena.front());
+    }
+
+    /**
+     * @brief  Process up to a fixed number of work items
+     *
+     * Each work item validates one value against one sub-schema, deferring
+     * structural descent back onto the work stack, so the cost of a slice
+     * is bounded by the size of the individual values it touches rather
+     * than by the size of the whole document.
+     *
+     * @param  maxWorkItems  maximum number of work items to process
+     *
+     * @returns  true if validation has completed, false if work remains
+     */
+    bool step(size_t maxWorkItems)
+    {
+        typedef IterativeValidationVisitor<AdapterType, RegexEngine> Visitor;
+
+        for (size_t i = 0; i < maxWorkItems && !m_workStack.empty(); i++) {
+            const typename Visitor::WorkItem item = m_workStack.back();
+            m_workStack.pop_back();
+
+            Visitor visitor(item.value, *item.context, m_strictTypes,
+                    m_results, m_workStack, m_contextArena, m_nameArena);
+            if (!visitor.validateSchema(*item.subschema)) {
+                m_validated = false;
+                if (!m_results || m_results->errorBudgetExhausted()) {
+                    m_complete = true;
+                    return true;
+                }
+            }
+        }
+
+        if (m_workStack.empty()) {
+            m_complete = true;
+        }
+
+        return m_complete;
+    }
+
+    /**
+     * @brief  Process work items until a wall-clock budget is spent
+     *
+     * The clock is checked after every work item, so the slice overruns the
+     * budget by at most the cost of the largest single value in the
+     * document.
+     *
+     * @param  budget  maximum time to spend in this slice
+     *
+     * @returns  true if validation has completed, false if work remains
+     */
+    bool stepFor(std::chrono::steady_clock::duration budget)
+    {
+        const auto deadline = std::chrono::steady_clock::now() + budget;
+        while (!step(1)) {
+            if (std::chrono::steady_clock::now() >= deadline) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    /**
+     * @brief  Return whether the session has finished validating
+     */
+    bool isComplete() const
+    {
+        return m_complete;
+    }
+
+    /**
+     * @brief  Return the verdict of the validation run
+     *
+     * Only final once isComplete() returns true; before then, a return
+     * value of false indicates that a failure has already been recorded,
+     * while true means no failure has been found so far.
+     */
+    bool isValid() const
+    {
+        return m_validated;
+    }
+
+    /**
+     * @brief  Return the number of work items awaiting processing
+     *
+     * This grows as structural descent discovers nested values, so it is a
+     * measure of outstanding work, not an estimate of remaining effort.
+     */
+    size_t pendingWorkItems() const
+    {
+        return m_workStack.size();
+    }
+
+private:
+    typedef IterativeValidationVisitor<AdapterType, RegexEngine> VisitorType;
+
+    /// Arena that owns the context frames referenced by deferred work items
+    typename VisitorType::ContextArena m_contextArena;
+
+    /// Arena that owns the property names referenced by context frames
+    typename VisitorType::NameArena m_nameArena;
+
+    /// Stack of deferred work items, with the top at the back
+    typename VisitorType::WorkStack m_workStack;
+
+    /// Optional destination for validation errors
+    ValidationResults *m_results;
+
+    /// Flag indicating that strict type comparisons should be used
+    bool m_strictTypes;
+
+    /// Whether the session has finished validating
+    bool m_complete;
+
+    /// Verdict accumulated so far
+    bool m_validated;
+};
+
+/// Resumable validation session using the default regular expression engine
+template<typename AdapterType>
+using ResumableValidation = ResumableValidationT<AdapterType>;
+
+}  // namespace valijson
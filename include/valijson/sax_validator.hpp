@@ -0,0 +1,1040 @@
+/**
+ * @file
+ *
+ * @brief   Streaming validation engine that consumes SAX-style parse events
+ *
+ * The SaxValidator class validates a document against a schema while the
+ * document is being parsed, without materializing a document tree. Its
+ * event interface matches the duck-typed handler concept used by
+ * rapidjson::Reader, so it can be passed directly to a rapidjson Reader,
+ * but it has no dependency on rapidjson and can be driven by any SAX-style
+ * parser.
+ *
+ * Scalar parse events are validated using the regular ValidationVisitor,
+ * via the ScalarValueAdapter, so all constraints behave identically to DOM
+ * validation when applied to scalar values. Containers are validated
+ * incrementally: properties, patternProperties, additionalProperties and
+ * items route child subschemas as keys and elements arrive, and counting
+ * constraints are checked when a container ends. Constraints that require
+ * access to a complete object or array value - such as 'anyOf', 'oneOf',
+ * 'not', 'enum', 'uniqueItems' or 'contains' applied to containers - cannot
+ * be evaluated incrementally; encountering one of these on a container
+ * causes validation to fail with a descriptive error.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstdlib>
+#include <deque>
+#include <limits>
+#include <map>
+#include <regex>
+#include <set>
+#include <string>
+#include <vector>
+
+#include <valijson/adapters/scalar_value_adapter.hpp>
+#include <valijson/adapters/std_string_adapter.hpp>
+#include <valijson/constraints/concrete_constraints.hpp>
+#include <valijson/constraints/constraint_visitor.hpp>
+#include <valijson/internal/validation_context.hpp>
+#include <valijson/exceptions.hpp>
+#include <valijson/subschema.hpp>
+#include <valijson/validation_results.hpp>
+#include <valijson/validation_visitor.hpp>
+#include <valijson/validator.hpp>
+
+namespace valijson {
+
+/**
+ * @brief   Validates a stream of SAX parse events against a schema
+ *
+ * A SaxValidator is bound to a single schema and, optionally, to a
+ * ValidationResults object. Parse events are delivered through member
+ * functions named after the rapidjson Reader handler concept:
+ *
+ *     valijson::SaxValidator handler(*schema.root(), &results);
+ *     rapidjson::Reader reader;
+ *     rapidjson::StringStream ss(documentText);
+ *     reader.Parse(ss, handler);
+ *     if (!handler.isValid()) {
+ *         // results contains the validation errors
+ *     }
+ *
+ * When no ValidationResults object is provided, the first validation
+ * failure causes the current event function to return \c false, which a
+ * conforming SAX parser treats as a request to terminate parsing - so an
+ * invalid document fails fast, mid-parse. When a ValidationResults object
+ * is provided, event functions keep returning \c true so that all errors
+ * in the document can be collected.
+ *
+ * A single instance can validate a sequence of documents, such as the lines
+ * of an NDJSON batch, by calling reset() between documents.
+ *
+ * @tparam  RegexEngine  regular expression engine used for pattern
+ *                       constraint validation
+ */
+template<typename RegexEngine>
+class SaxValidatorT
+{
+public:
+    /// Character type expected by the rapidjson handler concept
+    typedef char Ch;
+
+    /**
+     * @brief  Construct a validator for a given schema
+     *
+     * @param  schema   schema that the event stream must validate against;
+     *                  must outlive this validator
+     * @param  results  optional pointer to a ValidationResults instance
+     *                  that will be used to report validation errors
+     */
+    explicit SaxValidatorT(const Subschema &schema,
+            ValidationResults *results = nullptr)
+      : m_schema(schema),
+        m_results(results),
+        m_valid(true),
+        m_complete(false) { }
+
+    /**
+     * @brief  Prepare the validator for a new document
+     *
+     * Any state from a previously validated document is discarded. Errors
+     * already recorded in the ValidationResults object are left untouched.
+     */
+    void reset()
+    {
+        m_stack.clear();
+        m_skipDepth = 0;
+        m_valid = true;
+        m_complete = false;
+    }
+
+    /**
+     * @brief   Return whether the events seen so far are valid
+     *
+     * This may be queried mid-stream; once it returns \c false it will
+     * remain \c false until reset() is called.
+     */
+    bool isValid() const
+    {
+        return m_valid;
+    }
+
+    /**
+     * @brief   Return whether a complete document has been consumed
+     */
+    bool isComplete() const
+    {
+        return m_complete;
+    }
+
+    // -- SAX event interface (matches the rapidjson Reader handler concept) --
+
+    bool Null()
+    {
+        return scalar(adapters::ScalarValue::makeNull());
+    }
+
+    bool Bool(bool value)
+    {
+        return scalar(adapters::ScalarValue::makeBool(value));
+    }
+
+    bool Int(int value)
+    {
+        return scalar(adapters::ScalarValue::makeInteger(value));
+    }
+
+    bool Uint(unsigned value)
+    {
+        return scalar(adapters::ScalarValue::makeInteger(value));
+    }
+
+    bool Int64(int64_t value)
+    {
+        return scalar(adapters::ScalarValue::makeInteger(value));
+    }
+
+    bool Uint64(uint64_t value)
+    {
+        if (value <= static_cast<uint64_t>(std::numeric_limits<int64_t>::max())) {
+            return scalar(adapters::ScalarValue::makeInteger(
+                    static_cast<int64_t>(value)));
+        }
+
+        return scalar(adapters::ScalarValue::makeDouble(
+                static_cast<double>(value)));
+    }
+
+    bool Double(double value)
+    {
+        return scalar(adapters::ScalarValue::makeDouble(value));
+    }
+
+    bool RawNumber(const Ch *str, size_t length, bool)
+    {
+        const std::string number(str, length);
+        return scalar(adapters::ScalarValue::makeDouble(
+                strtod(number.c_str(), nullptr)));
+    }
+
+    bool String(const Ch *str, size_t length, bool)
+    {
+        return scalar(adapters::ScalarValue::makeString(str, length));
+    }
+
+    bool StartObject()
+    {
+        return startContainer(true);
+    }
+
+    bool Key(const Ch *str, size_t length, bool)
+    {
+        if (m_skipDepth > 0) {
+            return true;
+        }
+
+        if (m_stack.empty() || !m_stack.back().isObject) {
+            throwRuntimeError("Key event outside of an object");
+        }
+
+        Frame &top = m_stack.back();
+        top.currentKey.assign(str, length);
+        top.haveKey = true;
+        top.count++;
+        top.seenProperties.insert(top.currentKey);
+        top.childSchemas.clear();
+
+        bool ok = true;
+        for (const SchemaState &state : top.states) {
+            // Validate the property name itself, when required
+            if (state.propertyNames != nullptr) {
+                const adapters::StdStringAdapter keyAdapter(top.currentKey);
+                ValidationVisitor<adapters::StdStringAdapter, RegexEngine> v(
+                        keyAdapter, top.context, true, nullptr);
+                if (!v.validateSchema(*state.propertyNames->getSubschema())) {
+                    ok = false;
+                }
+            }
+
+            if (state.properties == nullptr) {
+                continue;
+            }
+
+            // Route the member's value to the subschemas for matching
+            // 'properties' and 'patternProperties' entries
+            bool matched = false;
+
+            const auto itr = state.propertySubschemas.find(top.currentKey);
+            if (itr != state.propertySubschemas.end()) {
+                matched = true;
+                if (itr->second != nullptr) {
+                    top.childSchemas.push_back(itr->second);
+                }
+            }
+
+            for (const PatternProperty &pattern : state.patternProperties) {
+                if (std::regex_search(top.currentKey, *pattern.regex)) {
+                    matched = true;
+                    if (pattern.subschema != nullptr) {
+                        top.childSchemas.push_back(pattern.subschema);
+                    }
+                }
+            }
+
+            if (!matched) {
+                const Subschema *additional =
+                        state.properties->getAdditionalPropertiesSubschema();
+                if (additional != nullptr) {
+                    top.childSchemas.push_back(additional);
+                } else {
+                    if (m_results) {
+                        m_results->pushError(top.context,
+                                "Object contains a property that could not be "
+                                "validated using 'properties' or "
+                                "'additionalProperties' constraints: '" +
+                                top.currentKey + "'.");
+                    }
+                    ok = false;
+                }
+            }
+        }
+
+        if (!ok) {
+            m_valid = false;
+            if (!m_results) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    bool EndObject(size_t)
+    {
+        if (m_skipDepth > 0) {
+            return skipEnd();
+        }
+
+        if (m_stack.empty() || !m_stack.back().isObject) {
+            throwRuntimeError("EndObject event outside of an object");
+        }
+
+        Frame &top = m_stack.back();
+        bool ok = true;
+
+        for (const SchemaState &state : top.states) {
+            if (state.required != nullptr) {
+                state.required->applyToRequiredProperties(
+                        [&](const constraints::RequiredConstraint::String &name) {
+                            if (top.seenProperties.count(name.c_str()) == 0) {
+                                if (m_results) {
+                                    m_results->pushError(top.context,
+                                            "Missing required property '" +
+                                            std::string(name.c_str()) + "'.");
+                                }
+                                ok = false;
+                            }
+                            return true;
+                        });
+            }
+
+            if (state.maxProperties != nullptr &&
+                    top.count > state.maxProperties->getMaxProperties()) {
+                if (m_results) {
+                    m_results->pushError(top.context,
+                            "Object should have no more than " +
+                            std::to_string(state.maxProperties->getMaxProperties()) +
+                            " properties.");
+                }
+                ok = false;
+            }
+
+            if (state.minProperties != nullptr &&
+                    top.count < state.minProperties->getMinProperties()) {
+                if (m_results) {
+                    m_results->pushError(top.context,
+                            "Object should have no fewer than " +
+                            std::to_string(state.minProperties->getMinProperties()) +
+                            " properties.");
+                }
+                ok = false;
+            }
+        }
+
+        return endContainer(ok);
+    }
+
+    bool StartArray()
+    {
+        return startContainer(false);
+    }
+
+    bool EndArray(size_t)
+    {
+        if (m_skipDepth > 0) {
+            return skipEnd();
+        }
+
+        if (m_stack.empty() || m_stack.back().isObject) {
+            throwRuntimeError("EndArray event outside of an array");
+        }
+
+        Frame &top = m_stack.back();
+        bool ok = true;
+
+        for (const SchemaState &state : top.states) {
+            if (state.maxItems != nullptr &&
+                    top.count > state.maxItems->getMaxItems()) {
+                if (m_results) {
+                    m_results->pushError(top.context,
+                            "Array should contain no more than " +
+                            std::to_string(state.maxItems->getMaxItems()) +
+                            " elements.");
+                }
+                ok = false;
+            }
+
+            if (state.minItems != nullptr &&
+                    top.count < state.minItems->getMinItems()) {
+                if (m_results) {
+                    m_results->pushError(top.context,
+                            "Array should contain no fewer than " +
+                            std::to_string(state.minItems->getMinItems()) +
+                            " elements.");
+                }
+                ok = false;
+            }
+        }
+
+        return endContainer(ok);
+    }
+
+private:
+    /// Compiled pattern from a 'patternProperties' entry, together with the
+    /// subschema that matching properties must validate against
+    struct PatternProperty
+    {
+        const Subschema *subschema;
+        const std::regex *regex;
+    };
+
+    /// Container-relevant constraints of a single active subschema, gathered
+    /// when a container value starts
+    struct SchemaState
+    {
+        SchemaState()
+          : properties(nullptr),
+            propertyNames(nullptr),
+            required(nullptr),
+            maxProperties(nullptr),
+            minProperties(nullptr),
+            linearItems(nullptr),
+            singularItems(nullptr),
+            maxItems(nullptr),
+            minItems(nullptr) { }
+
+        const constraints::PropertiesConstraint *properties;
+        const constraints::PropertyNamesConstraint *propertyNames;
+        const constraints::RequiredConstraint *required;
+        const constraints::MaxPropertiesConstraint *maxProperties;
+        const constraints::MinPropertiesConstraint *minProperties;
+        const constraints::LinearItemsConstraint *linearItems;
+        const constraints::SingularItemsConstraint *singularItems;
+        const constraints::MaxItemsConstraint *maxItems;
+        const constraints::MinItemsConstraint *minItems;
+
+        /// Exact property names mapped to their subschemas
+        std::map<std::string, const Subschema *> propertySubschemas;
+
+        /// Compiled patternProperties entries
+        std::vector<PatternProperty> patternProperties;
+
+        /// Per-index subschemas from a LinearItemsConstraint
+        std::vector<const Subschema *> itemSubschemas;
+    };
+
+    /// State for one open container in the event stream
+    struct Frame
+    {
+        Frame()
+          : isObject(false),
+            count(0),
+            haveKey(false) { }
+
+        /// Distinguishes object frames from array frames
+        bool isObject;
+
+        /// Context frame describing the location of this container
+        internal::ValidationContext context;
+
+        /// Subschemas that this container must validate against
+        std::vector<SchemaState> states;
+
+        /// Number of members or elements seen so far
+        size_t count;
+
+        /// Name of the member currently being parsed (objects only)
+        std::string currentKey;
+
+        /// Set once the first Key event has been seen (objects only)
+        bool haveKey;
+
+        /// Property names seen so far, for 'required' checks (objects only)
+        std::set<std::string> seenProperties;
+
+        /// Subschemas routed to the value of the current member
+        std::vector<const Subschema *> childSchemas;
+    };
+
+    /**
+     * @brief  Constraint visitor that gathers the container-relevant
+     *         constraints of a subschema into a SchemaState
+     *
+     * Constraints that only apply to scalar values are ignored, because a
+     * container value trivially satisfies them. Constraints that would
+     * require access to the complete container value are flagged as
+     * unsupported. 'allOf' subschemas are appended to a caller-provided
+     * worklist so that they can be expanded into additional SchemaState
+     * entries.
+     */
+    class CollectContainerConstraints: public constraints::ConstraintVisitor
+    {
+    public:
+        CollectContainerConstraints(SchemaState &state, bool isObject,
+                std::deque<const Subschema *> &worklist)
+          : m_state(state),
+            m_isObject(isObject),
+            m_worklist(worklist),
+            m_typeAllowed(true),
+            m_unsupported(nullptr) { }
+
+        /// Returns the JSON Schema keyword of the first unsupported
+        /// constraint, or nullptr if all constraints are supported
+        const char * unsupportedKeyword() const
+        {
+            return m_unsupported;
+        }
+
+        /// Returns false if a 'type' constraint rejects this container type
+        bool typeAllowed() const
+        {
+            return m_typeAllowed;
+        }
+
+        bool visit(const AllOfConstraint &constraint) override
+        {
+            constraint.applyToSubschemas(
+                    [this](unsigned int, const Subschema *subschema) {
+                        m_worklist.push_back(subschema);
+                        return true;
+                    });
+            return true;
+        }
+
+        bool visit(const AnyOfConstraint &) override
+        {
+            m_unsupported = "anyOf";
+            return true;
+        }
+
+        bool visit(const ConditionalConstraint &) override
+        {
+            m_unsupported = "if";
+            return true;
+        }
+
+        bool visit(const ConstConstraint &) override
+        {
+            m_unsupported = "const";
+            return true;
+        }
+
+        bool visit(const ContainsConstraint &) override
+        {
+            if (!m_isObject) {
+                m_unsupported = "contains";
+            }
+            return true;
+        }
+
+        bool visit(const DependenciesConstraint &) override
+        {
+            if (m_isObject) {
+                m_unsupported = "dependencies";
+            }
+            return true;
+        }
+
+        bool visit(const EnumConstraint &) override
+        {
+            m_unsupported = "enum";
+            return true;
+        }
+
+        bool visit(const FormatConstraint &) override
+        {
+            // Only applies to strings
+            return true;
+        }
+
+        bool visit(const FusedObjectConstraint &constraint) override
+        {
+            // Delegate to the handlers for the fused parts; the parts are
+            // owned by the fused constraint, which is owned by the
+            // subschema, so pointers stored into the SchemaState remain
+            // valid for as long as the schema itself
+            if (constraint.hasProperties()) {
+                visit(constraint.getProperties());
+            }
+            if (constraint.hasPropertyNames()) {
+                visit(constraint.getPropertyNames());
+            }
+            if (constraint.hasRequired()) {
+                visit(constraint.getRequired());
+            }
+            if (constraint.hasMinProperties()) {
+                visit(constraint.getMinProperties());
+            }
+            if (constraint.hasMaxProperties()) {
+                visit(constraint.getMaxProperties());
+            }
+            return true;
+        }
+
+        bool visit(const LinearItemsConstraint &constraint) override
+        {
+            if (m_isObject) {
+                return true;
+            }
+
+            m_state.linearItems = &constraint;
+            constraint.applyToItemSubschemas(
+                    [this](unsigned int, const Subschema *subschema) {
+                        m_state.itemSubschemas.push_back(subschema);
+                        return true;
+                    });
+            return true;
+        }
+
+        bool visit(const MaximumConstraint &) override
+        {
+            // Only applies to numbers
+            return true;
+        }
+
+        bool visit(const MaxItemsConstraint &constraint) override
+        {
+            if (!m_isObject) {
+                m_state.maxItems = &constraint;
+            }
+            return true;
+        }
+
+        bool visit(const MaxLengthConstraint &) override
+        {
+            // Only applies to strings
+            return true;
+        }
+
+        bool visit(const MaxPropertiesConstraint &constraint) override
+        {
+            if (m_isObject) {
+                m_state.maxProperties = &constraint;
+            }
+            return true;
+        }
+
+        bool visit(const MinimumConstraint &) override
+        {
+            // Only applies to numbers
+            return true;
+        }
+
+        bool visit(const MinItemsConstraint &constraint) override
+        {
+            if (!m_isObject) {
+                m_state.minItems = &constraint;
+            }
+            return true;
+        }
+
+        bool visit(const MinLengthConstraint &) override
+        {
+            // Only applies to strings
+            return true;
+        }
+
+        bool visit(const MinPropertiesConstraint &constraint) override
+        {
+            if (m_isObject) {
+                m_state.minProperties = &constraint;
+            }
+            return true;
+        }
+
+        bool visit(const MultipleOfDoubleConstraint &) override
+        {
+            // Only applies to numbers
+            return true;
+        }
+
+        bool visit(const MultipleOfIntConstraint &) override
+        {
+            // Only applies to numbers
+            return true;
+        }
+
+        bool visit(const NotConstraint &) override
+        {
+            m_unsupported = "not";
+            return true;
+        }
+
+        bool visit(const OneOfConstraint &) override
+        {
+            m_unsupported = "oneOf";
+            return true;
+        }
+
+        bool visit(const PatternConstraint &) override
+        {
+            // Only applies to strings
+            return true;
+        }
+
+        bool visit(const constraints::PolyConstraint &) override
+        {
+            m_unsupported = "custom constraint";
+            return true;
+        }
+
+        bool visit(const PropertiesConstraint &constraint) override
+        {
+            if (!m_isObject) {
+                return true;
+            }
+
+            m_state.properties = &constraint;
+            constraint.applyToProperties(
+                    [this](const constraints::PropertiesConstraint::String &name,
+                            const Subschema *subschema) {
+                        m_state.propertySubschemas[name.c_str()] = subschema;
+                        return true;
+                    });
+            constraint.applyToPatternProperties(
+                    [this, &constraint](
+                            const constraints::PropertiesConstraint::String &pattern,
+                            const Subschema *subschema) {
+                        m_state.patternProperties.push_back(PatternProperty{
+                                subschema,
+                                &constraint.getPatternPropertyRegex(pattern)});
+                        return true;
+                    });
+            return true;
+        }
+
+        bool visit(const PropertyNamesConstraint &constraint) override
+        {
+            if (m_isObject) {
+                m_state.propertyNames = &constraint;
+            }
+            return true;
+        }
+
+        bool visit(const RequiredConstraint &constraint) override
+        {
+            if (m_isObject) {
+                m_state.required = &constraint;
+            }
+            return true;
+        }
+
+        bool visit(const SingularItemsConstraint &constraint) override
+        {
+            if (!m_isObject) {
+                m_state.singularItems = &constraint;
+            }
+            return true;
+        }
+
+        bool visit(const TypeConstraint &constraint) override
+        {
+            bool allowed = false;
+            constraint.applyToNamedTypes(
+                    [this, &allowed](TypeConstraint::JsonType jsonType) {
+                        if (jsonType == TypeConstraint::kAny ||
+                                jsonType == (m_isObject ? TypeConstraint::kObject
+                                                        : TypeConstraint::kArray)) {
+                            allowed = true;
+                        }
+                        return true;
+                    });
+
+            if (!allowed) {
+                // A schema-based type could still accept this container, but
+                // cannot be evaluated incrementally
+                size_t numSchemaTypes = 0;
+                constraint.applyToSchemaTypes(
+                        [&numSchemaTypes](unsigned int, const Subschema *) {
+                            numSchemaTypes++;
+                            return true;
+                        });
+                if (numSchemaTypes > 0) {
+                    m_unsupported = "type";
+                } else {
+                    m_typeAllowed = false;
+                }
+            }
+
+            return true;
+        }
+
+        bool visit(const UniqueItemsConstraint &) override
+        {
+            if (!m_isObject) {
+                m_unsupported = "uniqueItems";
+            }
+            return true;
+        }
+
+    private:
+        SchemaState &m_state;
+        const bool m_isObject;
+        std::deque<const Subschema *> &m_worklist;
+        bool m_typeAllowed;
+        const char *m_unsupported;
+    };
+
+    /**
+     * @brief  Record a validation failure
+     *
+     * @returns  \c false if parsing should terminate, \c true otherwise
+     */
+    bool fail()
+    {
+        m_valid = false;
+        return m_results != nullptr;
+    }
+
+    /**
+     * @brief  Determine the subschemas that the next value must validate
+     *         against, and the context frame for error descriptions
+     *
+     * For array elements, this also advances the element count.
+     */
+    std::vector<const Subschema *> routeValue(internal::ValidationContext &context)
+    {
+        if (m_stack.empty()) {
+            if (m_complete) {
+                throwRuntimeError("Parse event after the end of the document");
+            }
+            context = internal::ValidationContext();
+            return std::vector<const Subschema *>(1, &m_schema);
+        }
+
+        Frame &top = m_stack.back();
+        if (top.isObject) {
+            if (!top.haveKey) {
+                throwRuntimeError("Value event without a preceding Key event");
+            }
+            context = internal::ValidationContext(top.context, top.currentKey);
+            return std::move(top.childSchemas);
+        }
+
+        const size_t index = top.count++;
+        context = internal::ValidationContext(top.context, index);
+
+        std::vector<const Subschema *> result;
+        for (const SchemaState &state : top.states) {
+            if (state.singularItems != nullptr) {
+                const Subschema *itemsSubschema =
+                        state.singularItems->getItemsSubschema();
+                if (itemsSubschema != nullptr) {
+                    result.push_back(itemsSubschema);
+                }
+            }
+
+            if (state.linearItems != nullptr) {
+                if (index < state.itemSubschemas.size()) {
+                    result.push_back(state.itemSubschemas[index]);
+                } else {
+                    const Subschema *additional =
+                            state.linearItems->getAdditionalItemsSubschema();
+                    if (additional != nullptr) {
+                        result.push_back(additional);
+                    } else if (m_results) {
+                        if (state.itemSubschemas.empty()) {
+                            m_results->pushError(top.context,
+                                    "Cannot validate item #" + std::to_string(index) +
+                                    " or greater using 'items' constraint or "
+                                    "'additionalItems' constraint.");
+                        } else {
+                            m_results->pushError(top.context,
+                                    "Array contains more items than allowed by "
+                                    "items constraint.");
+                        }
+                        m_valid = false;
+                    } else {
+                        m_valid = false;
+                    }
+                }
+            }
+        }
+
+        return result;
+    }
+
+    /**
+     * @brief  Validate a scalar value against the subschemas routed to the
+     *         current position in the document
+     */
+    bool scalar(const adapters::ScalarValue &value)
+    {
+        if (m_skipDepth > 0) {
+            return true;
+        }
+
+        internal::ValidationContext context;
+        const std::vector<const Subschema *> schemas = routeValue(context);
+        if (!m_valid && !m_results) {
+            return false;
+        }
+
+        const adapters::ScalarValueAdapter adapter(value);
+
+        bool ok = true;
+        for (const Subschema *subschema : schemas) {
+            ValidationVisitor<adapters::ScalarValueAdapter, RegexEngine> visitor(
+                    adapter, context, true, m_results);
+            if (!visitor.validateSchema(*subschema)) {
+                ok = false;
+            }
+        }
+
+        if (m_stack.empty()) {
+            m_complete = true;
+        }
+
+        return ok ? true : fail();
+    }
+
+    /**
+     * @brief  Open a new container frame for an object or array value
+     */
+    bool startContainer(bool isObject)
+    {
+        if (m_skipDepth > 0) {
+            m_skipDepth++;
+            return true;
+        }
+
+        internal::ValidationContext context;
+        std::vector<const Subschema *> schemas = routeValue(context);
+        if (!m_valid && !m_results) {
+            return false;
+        }
+
+        Frame frame;
+        frame.isObject = isObject;
+        frame.context = context;
+
+        // Expand 'allOf' constraints so that a container can be validated
+        // against all applicable subschemas in a single pass
+        bool ok = true;
+        std::set<const Subschema *> seen;
+        std::deque<const Subschema *> worklist(schemas.begin(), schemas.end());
+        while (!worklist.empty()) {
+            const Subschema *subschema = worklist.front();
+            worklist.pop_front();
+            if (!seen.insert(subschema).second) {
+                continue;
+            }
+
+            if (subschema->getAlwaysInvalid()) {
+                ok = false;
+                continue;
+            }
+
+            SchemaState state;
+            CollectContainerConstraints collector(state, isObject, worklist);
+            subschema->forEachConstraint(
+                    [&collector](const constraints::Constraint &constraint) {
+                        constraint.accept(collector);
+                        return true;
+                    });
+
+            if (collector.unsupportedKeyword() != nullptr) {
+                if (m_results) {
+                    m_results->pushError(context, "Constraint '" +
+                            std::string(collector.unsupportedKeyword()) +
+                            "' cannot be applied to " +
+                            (isObject ? "an object" : "an array") +
+                            " by the streaming validator.");
+                }
+                ok = false;
+                continue;
+            }
+
+            if (!collector.typeAllowed()) {
+                if (m_results) {
+                    m_results->pushError(context,
+                            "Value type not permitted by 'type' constraint.");
+                }
+                ok = false;
+                continue;
+            }
+
+            // A subschema with no container-relevant constraints accepts
+            // any object or array; omitting its state keeps the per-event
+            // work proportional to the constraints that can actually fail
+            if (!inert(state)) {
+                frame.states.push_back(std::move(state));
+            }
+        }
+
+        // When no active subschema constrains this container - typically a
+        // subtree admitted by 'additionalProperties': true or by an empty
+        // schema - the entire subtree is skipped with a depth counter, so
+        // its events cost nothing beyond bracket matching
+        if (ok && frame.states.empty()) {
+            m_skipDepth = 1;
+            return true;
+        }
+
+        m_stack.push_back(std::move(frame));
+
+        return ok ? true : fail();
+    }
+
+    /**
+     * @brief  Close one level of a skipped subtree
+     */
+    bool skipEnd()
+    {
+        m_skipDepth--;
+        if (m_skipDepth == 0 && m_stack.empty()) {
+            m_complete = true;
+        }
+
+        return true;
+    }
+
+    /**
+     * @brief  Return true if a SchemaState contains no constraints that
+     *         could affect validation
+     */
+    static bool inert(const SchemaState &state)
+    {
+        return state.properties == nullptr &&
+                state.propertyNames == nullptr &&
+                state.required == nullptr &&
+                state.maxProperties == nullptr &&
+                state.minProperties == nullptr &&
+                state.linearItems == nullptr &&
+                state.singularItems == nullptr &&
+                state.maxItems == nullptr &&
+                state.minItems == nullptr;
+    }
+
+    /**
+     * @brief  Close the current container frame
+     *
+     * @param  ok  whether the checks performed at the container's end event
+     *             all passed
+     */
+    bool endContainer(bool ok)
+    {
+        m_stack.pop_back();
+        if (m_stack.empty()) {
+            m_complete = true;
+        }
+
+        return ok ? true : fail();
+    }
+
+    /// Schema that the event stream must validate against
+    const Subschema &m_schema;
+
+    /// Optional pointer to a ValidationResults object to be populated
+    ValidationResults *m_results;
+
+    /// Cleared when the first validation failure is recorded
+    bool m_valid;
+
+    /// Set once a complete document has been consumed
+    bool m_complete;
+
+    /// Number of open containers within a subtree that is being skipped
+    /// because no active subschema constrains it; zero when not skipping
+    size_t m_skipDepth = 0;
+
+    /// One frame per open container in the event stream
+    std::deque<Frame> m_stack;
+};
+
+using SaxValidator = SaxValidatorT<DefaultRegexEngine>;
+
+}  // namespace valijson
@@ -2,7 +2,10 @@
 
 #include <cstdio>
 #include <set>
+#include <vector>
 
+#include <valijson/internal/frozen_value_pool.hpp>
+#include <valijson/internal/string_intern_pool.hpp>
 #include <valijson/subschema.hpp>
 #include <valijson/exceptions.hpp>
 
@@ -34,6 +37,8 @@ public:
      */
     Schema(CustomAlloc allocFn, CustomFree freeFn)
       : Subschema(allocFn, freeFn),
+        stringPool(allocFn, freeFn),
+        frozenPool(allocFn, freeFn),
         sharedEmptySubschema(newSubschema()) { }
 
     // Disable copy construction
@@ -49,11 +54,15 @@ public:
      */
     Schema(Schema &&other)
       : Subschema(std::move(other)),
+        stringPool(std::move(other.stringPool)),
+        frozenPool(std::move(other.frozenPool)),
         subschemaSet(std::move(other.subschemaSet)),
-        sharedEmptySubschema(other.sharedEmptySubschema)
+        sharedEmptySubschema(other.sharedEmptySubschema),
+        constraintArena(other.constraintArena)
     {
         // Makes other invalid by setting sharedEmptySubschema to nullptr
         other.sharedEmptySubschema = nullptr;
+        other.constraintArena = nullptr;
     }
 
     /**
@@ -68,8 +77,11 @@ public:
         Subschema::operator=(std::move(other));
 
         // Swaps all Schema members
+        std::swap(stringPool, other.stringPool);
+        std::swap(frozenPool, other.frozenPool);
         std::swap(subschemaSet, other.subschemaSet);
         std::swap(sharedEmptySubschema, other.sharedEmptySubschema);
+        std::swap(constraintArena, other.constraintArena);
 
         return *this;
     }
@@ -96,6 +108,14 @@ public:
                 subschema->~Subschema();
                 m_freeFn(subschema);
             }
+
+            // Constraints owned by the root sub-schema must be destroyed
+            // before the arena that backs a compiled schema is released
+            if (constraintArena) {
+                clearConstraints();
+                m_freeFn(constraintArena);
+                constraintArena = nullptr;
+            }
 #if VALIJSON_USE_EXCEPTIONS
         } catch (const std::exception &e) {
             fprintf(stderr, "Caught an exception while destroying Schema: %s",
@@ -123,6 +143,212 @@ public:
         mutableSubschema(subschema)->addConstraint(constraint);
     }
 
+    /**
+     * @brief  Move a constraint's payload into a specific sub-schema
+     *
+     * Equivalent to the copying overload, except that the constraint's deep
+     * payload is transferred rather than copied; see
+     * Subschema::addConstraint(Constraint &&).
+     *
+     * @param  constraint  reference to a constraint that will be consumed
+     * @param  subschema   pointer to the sub-schema that will own the new
+     *                     constraint
+     *
+     * @throws std::runtime_error if the sub-schema is not owned by this Schema
+     *         instance
+     */
+    void addConstraintToSubschema(Constraint &&constraint,
+            const Subschema *subschema)
+    {
+        mutableSubschema(subschema)->addConstraint(std::move(constraint));
+    }
+
+    /**
+     * @brief  Return the intern pool that stores this schema's property names
+     *
+     * Constraints populated while this pool is active, via a
+     * StringInternPool::Scope, store their property names in the schema's
+     * own storage, with each distinct name stored exactly once. SchemaParser
+     * activates this pool for the duration of a parse.
+     */
+    internal::StringInternPool & internPool()
+    {
+        return stringPool;
+    }
+
+    /**
+     * @brief  Return the pool that stores this schema's frozen values
+     *
+     * 'const' and 'enum' constraints populated while this pool is active,
+     * via a FrozenValuePool::Scope, share one immutable frozen instance per
+     * distinct literal rather than freezing each occurrence independently.
+     * SchemaParser activates this pool for the duration of a parse.
+     */
+    internal::FrozenValuePool & frozenValuePool()
+    {
+        return frozenPool;
+    }
+
+    /**
+     * @brief  Compact all constraints owned by this Schema into a single
+     *         contiguous buffer
+     *
+     * Constraints are ordinarily allocated individually as they are added
+     * during schema parsing, which can scatter them across the heap. This
+     * function clones every constraint, across all sub-schemas, into one
+     * arena-style allocation, so that the constraints visited while
+     * validating a sub-schema are adjacent in memory.
+     *
+     * References between sub-schemas are unaffected, so a compiled Schema
+     * can be used anywhere an ordinary Schema can. Calling this function
+     * more than once is supported, but has no benefit unless constraints
+     * have been added since the previous call.
+     *
+     * @throws std::runtime_error if memory for the arena cannot be allocated
+     */
+    void compile()
+    {
+        compile(std::vector<const Subschema *>());
+    }
+
+    /**
+     * @brief  Compact all constraints owned by this Schema into a single
+     *         contiguous buffer, placing sub-schemas in a given order
+     *
+     * Behaves like compile(), except that sub-schemas are cloned into the
+     * arena in the order they appear in the layout order, so that
+     * sub-schemas expected to be visited in succession share cache lines
+     * and pages. Entries that are not owned by this Schema are ignored,
+     * duplicates are placed at their first occurrence, and owned
+     * sub-schemas missing from the order - including the root, if omitted
+     * - are placed after the ordered ones. See
+     * layoutConstraintsInVisitOrder() in validator.hpp for a pass that
+     * derives a suitable order from the schema graph.
+     *
+     * @param  layoutOrder  sub-schemas in the order they should be laid out
+     *
+     * @throws std::runtime_error if memory for the arena cannot be allocated
+     */
+    void compile(const std::vector<const Subschema *> &layoutOrder)
+    {
+        size_t storageSize = constraintStorageSize();
+        for (auto subschema : subschemaSet) {
+            storageSize += subschema->constraintStorageSize();
+        }
+
+        if (storageSize == 0) {
+            return;
+        }
+
+        void *buffer = m_allocFn(storageSize);
+        if (!buffer) {
+            throwRuntimeError("Failed to allocate memory for compiled schema");
+        }
+
+        // Clone the constraints owned by each sub-schema in layout order,
+        // followed by those owned by any remaining sub-schemas; when
+        // re-compiling, this copies out of the old arena before it is
+        // released
+        std::set<const Subschema *> placed;
+        void *next = buffer;
+        for (const Subschema *entry : layoutOrder) {
+            Subschema *target = nullptr;
+            if (entry == this) {
+                target = this;
+            } else {
+                const auto itr = subschemaSet.find(
+                        const_cast<Subschema *>(entry));
+                if (itr != subschemaSet.end()) {
+                    target = *itr;
+                }
+            }
+
+            if (target != nullptr && placed.insert(entry).second) {
+                next = target->compactConstraints(next);
+            }
+        }
+
+        if (placed.find(this) == placed.end()) {
+            next = compactConstraints(next);
+        }
+        for (auto subschema : subschemaSet) {
+            if (placed.find(subschema) == placed.end()) {
+                next = subschema->compactConstraints(next);
+            }
+        }
+
+        if (constraintArena) {
+            m_freeFn(constraintArena);
+        }
+
+        constraintArena = buffer;
+    }
+
+    /**
+     * @brief  Reorder the constraints of every sub-schema using a rank
+     *         function
+     *
+     * Applies Subschema::scheduleConstraints to the root sub-schema and to
+     * every nested sub-schema, so that an entire schema can be re-ordered
+     * for cheap-first evaluation in a single pass. See
+     * scheduleCheapConstraintsFirst() in validator.hpp for a ready-made
+     * rank function based on estimated constraint cost.
+     *
+     * @param  rankFn  callable that returns an integer rank for a given
+     *                 Constraint; lower ranks are evaluated earlier
+     */
+    template<typename RankFunction>
+    void scheduleConstraints(const RankFunction &rankFn)
+    {
+        Subschema::scheduleConstraints(rankFn);
+        for (auto subschema : subschemaSet) {
+            subschema->scheduleConstraints(rankFn);
+        }
+    }
+
+    /**
+     * @brief  Invoke a callable that may modify each of the sub-schemas
+     *         owned by this Schema, including the root
+     *
+     * This is intended for whole-schema transformation passes that run
+     * after parsing, such as fuseObjectConstraints() in validator.hpp. It
+     * must not be called while other threads are validating against this
+     * Schema.
+     *
+     * @param  fn  callable to invoke on each sub-schema
+     */
+    template<typename FunctorType>
+    void transformSubschemas(const FunctorType &fn)
+    {
+        fn(*static_cast<Subschema *>(this));
+        for (auto subschema : subschemaSet) {
+            fn(*subschema);
+        }
+    }
+
+    /**
+     * @brief  Invoke a function on each of the sub-schemas owned by this
+     *         Schema, including the root
+     *
+     * Iteration will terminate early if an invocation of the callback
+     * function returns \c false.
+     *
+     * @param  fn  callback function to invoke on each sub-schema
+     */
+    template<typename FunctorType>
+    void applyToSubschemas(const FunctorType &fn) const
+    {
+        if (!fn(*static_cast<const Subschema *>(this))) {
+            return;
+        }
+
+        for (const auto subschema : subschemaSet) {
+            if (!fn(*subschema)) {
+                return;
+            }
+        }
+    }
+
     /**
      * @brief  Create a new Subschema instance that is owned by this Schema
      *
@@ -149,6 +375,52 @@ public:
         return subschema;
     }
 
+    /**
+     * @brief  Create an empty Schema that uses this Schema's memory
+     *         management functions
+     *
+     * Sub-schemas built in the returned Schema can later be transferred to
+     * this Schema via adoptSubschemas(), which requires that the two
+     * schemas share allocation functions.
+     */
+    Schema createCompatibleSchema() const
+    {
+        return Schema(m_allocFn, m_freeFn);
+    }
+
+    /**
+     * @brief  Take ownership of every sub-schema owned by another Schema
+     *
+     * Sub-schema pointers returned by the other Schema remain valid, but
+     * are owned by - and eventually freed with - this Schema instead. The
+     * other schema's shared empty sub-schema may be referenced by
+     * constraints that were built against it, so it is adopted as an
+     * ordinary sub-schema. The other schema is left in the same state as
+     * a moved-from Schema, and should not be used further.
+     *
+     * @param  other  Schema whose sub-schemas will be adopted
+     *
+     * @throws std::runtime_error if the other Schema uses different
+     *         allocation functions
+     */
+    void adoptSubschemas(Schema &other)
+    {
+        if (m_allocFn != other.m_allocFn || m_freeFn != other.m_freeFn) {
+            throwRuntimeError("Cannot adopt sub-schemas from a Schema that "
+                    "uses different allocation functions");
+        }
+
+        subschemaSet.insert(other.subschemaSet.begin(),
+                other.subschemaSet.end());
+        other.subschemaSet.clear();
+
+        if (other.sharedEmptySubschema) {
+            subschemaSet.insert(
+                    const_cast<Subschema *>(other.sharedEmptySubschema));
+            other.sharedEmptySubschema = nullptr;
+        }
+    }
+
     /**
      * @brief  Return a pointer to the shared empty schema
      */
@@ -250,10 +522,21 @@ private:
     }
 
     /// Set of Subschema instances owned by this schema
+    /// Deduplicated storage for the property names used by this schema's
+    /// constraints; see StringInternPool for how it is activated
+    internal::StringInternPool stringPool;
+
+    /// Pool of frozen values shared by this schema's 'const' and 'enum'
+    /// constraints; see FrozenValuePool for how it is activated
+    internal::FrozenValuePool frozenPool;
+
     std::set<Subschema*> subschemaSet;
 
     /// Empty schema that can be reused by multiple constraints
     const Subschema *sharedEmptySubschema;
+
+    /// Contiguous storage for constraints owned by a compiled schema
+    void *constraintArena = nullptr;
 };
 
 } // namespace valijson
@@ -0,0 +1,402 @@
+/**
+ * @file
+ *
+ * @brief   On-disk cache of compiled schemas, keyed by document fingerprint
+ *
+ * Services tend to re-parse the same schema files at every restart and on
+ * each config-reload tick, even when nothing has changed. The
+ * SchemaCompilationCache defined here layers above SchemaParser: the root
+ * schema document is fingerprinted via its canonical compact encoding, and
+ * the compiled schema is stored in a cache directory in the binary
+ * serialized form, so a warm restart reconstructs the schema with a single
+ * linear read instead of a full parse, JSON pointer resolution and $ref
+ * fetching.
+ *
+ * Remote documents resolved through $ref are fingerprinted as they are
+ * fetched, and their fingerprints are recorded in the cache entry alongside
+ * the compiled schema. A later lookup re-fetches those documents - cheaply,
+ * when the fetch function is backed by local files or a SharedDocumentCache
+ * - and revalidates their fingerprints, so a change to any referenced
+ * document invalidates the entry just as a change to the root does.
+ *
+ * Schemas that cannot be serialized - those holding composite 'enum' or
+ * 'const' values, or custom constraints - are parsed normally and simply
+ * not cached. Cache files are written to a temporary name and renamed into
+ * place, so concurrent processes sharing a cache directory never observe a
+ * partially written entry.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <valijson/internal/compact_frozen_value.hpp>
+#include <valijson/exceptions.hpp>
+#include <valijson/schema.hpp>
+#include <valijson/schema_parser.hpp>
+#include <valijson/schema_serialization.hpp>
+
+namespace valijson {
+
+/**
+ * @brief   Cache that loads compiled schemas from disk when the source
+ *          documents are unchanged
+ *
+ * The cache is keyed on a 64-bit fingerprint of the root schema document's
+ * canonical compact encoding, which does not depend on the adapter the
+ * document was read through or on member ordering. Entries carry the
+ * fingerprints of every document fetched through $ref during the original
+ * parse, and are revalidated against freshly fetched copies on lookup.
+ *
+ * A cache instance is cheap and holds no schema state; it may be
+ * constructed per reload tick or kept for the life of the process.
+ */
+class SchemaCompilationCache
+{
+public:
+
+    /**
+     * @brief  Construct a cache over a directory of compiled schemas
+     *
+     * The directory must already exist; entries are files within it, named
+     * by fingerprint.
+     *
+     * @param  directory  path to the cache directory
+     */
+    explicit SchemaCompilationCache(std::string directory)
+      : m_directory(std::move(directory)),
+        m_hits(0),
+        m_misses(0) { }
+
+    /**
+     * @brief  Populate a Schema, re-using a compiled schema from the cache
+     *         when the source documents are unchanged
+     *
+     * On a cache hit the schema is reconstructed from its binary serialized
+     * form; on a miss it is parsed by the supplied SchemaParser and the
+     * result is stored for the next call. Either way, the populated schema
+     * is equivalent to what SchemaParser::populateSchema would produce.
+     *
+     * @param  parser    parser used to compile the schema on a cache miss
+     * @param  rootNode  reference to the root of the schema document
+     * @param  schema    reference to the Schema to populate
+     * @param  fetchDoc  function to fetch remote JSON documents (optional)
+     * @param  freeDoc   function to free fetched documents (optional)
+     */
+    template<typename AdapterType>
+    void populateSchema(
+        SchemaParser &parser,
+        const AdapterType &rootNode,
+        Schema &schema,
+        typename SchemaParser::FunctionPtrs<AdapterType>::FetchDoc fetchDoc = nullptr,
+        typename SchemaParser::FunctionPtrs<AdapterType>::FreeDoc freeDoc = nullptr)
+    {
+        typedef typename adapters::AdapterTraits<AdapterType>::DocumentType
+                DocumentType;
+
+        const uint64_t rootFingerprint = fingerprintValue(rootNode);
+        const std::string path = entryPath(rootFingerprint);
+
+        if (loadEntry<AdapterType>(path, rootFingerprint, fetchDoc, freeDoc,
+                schema)) {
+            m_hits++;
+            return;
+        }
+
+        m_misses++;
+
+        // Documents fetched through $ref are fingerprinted on the way past,
+        // so that the cache entry can be revalidated against them later
+        std::vector<Dependency> dependencies;
+        typename SchemaParser::FunctionPtrs<AdapterType>::FetchDoc
+                recordingFetch = nullptr;
+        if (fetchDoc != nullptr) {
+            recordingFetch = [&dependencies, &fetchDoc](
+                    const std::string &uri) -> const DocumentType * {
+                const DocumentType *doc = fetchDoc(uri);
+                if (doc != nullptr) {
+                    dependencies.push_back(Dependency(uri,
+                            fingerprintValue(AdapterType(*doc))));
+                }
+                return doc;
+            };
+        }
+
+        parser.populateSchema(rootNode, schema, recordingFetch, freeDoc);
+
+#if VALIJSON_USE_EXCEPTIONS
+        try {
+            storeEntry(path, rootFingerprint, dependencies, schema);
+        } catch (const std::exception &) {
+            // Schemas holding composite enum/const values or custom
+            // constraints cannot be serialized; they are parsed on every
+            // call rather than cached
+        }
+#else
+        // Without exceptions there is no way to recover from an
+        // unserializable schema, so callers compiling with
+        // VALIJSON_USE_EXCEPTIONS=0 must only cache serializable schemas
+        storeEntry(path, rootFingerprint, dependencies, schema);
+#endif
+    }
+
+    /// Number of lookups satisfied from the cache directory
+    size_t hits() const
+    {
+        return m_hits;
+    }
+
+    /// Number of lookups that fell back to a full parse
+    size_t misses() const
+    {
+        return m_misses;
+    }
+
+private:
+
+    /// URI of a document fetched through $ref, paired with the fingerprint
+    /// it had when the cached schema was compiled
+    typedef std::pair<std::string, uint64_t> Dependency;
+
+    /// Identifies a cache entry file and guards against reading a file
+    /// that is not one
+    static const uint32_t kMagic = 0x564a5343;  // "VJSC"
+
+    /// Bumped when the entry layout, the fingerprint function, or the
+    /// underlying binary schema format changes incompatibly
+    static const uint32_t kVersion = 1;
+
+    /**
+     * @brief  Fingerprint a document via its canonical compact encoding
+     *
+     * Two documents have the same encoding exactly when they are
+     * structurally equal, so the fingerprint does not depend on the
+     * adapter or on object member ordering. Weakly-typed adapters cannot
+     * be encoded faithfully and cannot be fingerprinted.
+     */
+    static uint64_t fingerprintValue(const adapters::Adapter &value)
+    {
+        std::string encoding;
+        if (!adapters::CompactFrozenValue::encode(value, encoding)) {
+            throwRuntimeError("Cannot fingerprint a schema document read "
+                    "through a weakly-typed adapter");
+        }
+
+        // FNV-1a, 64-bit
+        uint64_t hash = 0xcbf29ce484222325ull;
+        for (size_t i = 0; i < encoding.size(); i++) {
+            hash = (hash ^ static_cast<unsigned char>(encoding[i])) *
+                    0x100000001b3ull;
+        }
+
+        return hash;
+    }
+
+    /// Path of the entry file for a given root document fingerprint
+    std::string entryPath(uint64_t rootFingerprint) const
+    {
+        char name[32];
+        snprintf(name, sizeof(name), "%016llx.vjc",
+                static_cast<unsigned long long>(rootFingerprint));
+        return m_directory + "/" + name;
+    }
+
+    template<typename ValueType>
+    static void appendScalar(std::vector<char> &buffer, ValueType value)
+    {
+        const char *bytes = reinterpret_cast<const char *>(&value);
+        buffer.insert(buffer.end(), bytes, bytes + sizeof(value));
+    }
+
+    template<typename ValueType>
+    static bool readScalar(const std::string &data, size_t &cursor,
+            ValueType &value)
+    {
+        if (data.size() - cursor < sizeof(value)) {
+            return false;
+        }
+
+        std::memcpy(&value, data.data() + cursor, sizeof(value));
+        cursor += sizeof(value);
+        return true;
+    }
+
+    /**
+     * @brief  Attempt to populate a schema from a cache entry file
+     *
+     * Returns false - leaving the schema untouched - when the entry is
+     * missing, malformed, produced by a different version, or stale with
+     * respect to any of its recorded $ref dependencies. An entry whose
+     * framing is intact but whose serialized schema payload is corrupt -
+     * which a crash between writing and flushing a data block can leave
+     * behind - is removed and reported as a miss, so the caller re-parses
+     * and rewrites it. When exceptions are disabled such a payload cannot
+     * be intercepted and deserialization will abort.
+     */
+    template<typename AdapterType>
+    bool loadEntry(
+            const std::string &path,
+            uint64_t rootFingerprint,
+            const typename SchemaParser::FunctionPtrs<AdapterType>::FetchDoc &fetchDoc,
+            const typename SchemaParser::FunctionPtrs<AdapterType>::FreeDoc &freeDoc,
+            Schema &schema) const
+    {
+        std::string contents;
+        if (!readFile(path, contents)) {
+            return false;
+        }
+
+        size_t cursor = 0;
+        uint32_t magic = 0;
+        uint32_t version = 0;
+        uint64_t storedFingerprint = 0;
+        uint32_t dependencyCount = 0;
+        if (!readScalar(contents, cursor, magic) || magic != kMagic ||
+                !readScalar(contents, cursor, version) || version != kVersion ||
+                !readScalar(contents, cursor, storedFingerprint) ||
+                storedFingerprint != rootFingerprint ||
+                !readScalar(contents, cursor, dependencyCount)) {
+            return false;
+        }
+
+        // Every document the original parse fetched must still fetch and
+        // still carry the fingerprint it had then
+        for (uint32_t index = 0; index < dependencyCount; index++) {
+            uint32_t uriSize = 0;
+            if (!readScalar(contents, cursor, uriSize) ||
+                    contents.size() - cursor < uriSize) {
+                return false;
+            }
+
+            const std::string uri = contents.substr(cursor, uriSize);
+            cursor += uriSize;
+
+            uint64_t dependencyFingerprint = 0;
+            if (!readScalar(contents, cursor, dependencyFingerprint)) {
+                return false;
+            }
+
+            if (fetchDoc == nullptr) {
+                return false;
+            }
+
+            const typename adapters::AdapterTraits<AdapterType>::DocumentType
+                    *doc = fetchDoc(uri);
+            if (doc == nullptr) {
+                return false;
+            }
+
+            const uint64_t freshFingerprint =
+                    fingerprintValue(AdapterType(*doc));
+            if (freeDoc != nullptr) {
+                freeDoc(doc);
+            }
+
+            if (freshFingerprint != dependencyFingerprint) {
+                return false;
+            }
+        }
+
+        // The payload is reconstructed into a scratch Schema first; the
+        // checks above validate only the entry's own framing, so a corrupt
+        // payload can still fail part-way through deserialization, and must
+        // not leave the caller's schema partially populated
+#if VALIJSON_USE_EXCEPTIONS
+        try {
+            Schema loaded = schema.createCompatibleSchema();
+            deserializeBinarySchema(contents.data() + cursor,
+                    contents.size() - cursor, loaded);
+            schema = std::move(loaded);
+        } catch (const std::exception &) {
+            // Remove the corrupt entry so the re-parse that follows this
+            // miss rewrites it, rather than failing on every warm start
+            // until someone deletes the file by hand
+            std::remove(path.c_str());
+            return false;
+        }
+#else
+        deserializeBinarySchema(contents.data() + cursor,
+                contents.size() - cursor, schema);
+#endif
+        return true;
+    }
+
+    /// Serialize a compiled schema and write it, with its dependency
+    /// fingerprints, atomically into the cache directory
+    void storeEntry(
+            const std::string &path,
+            uint64_t rootFingerprint,
+            const std::vector<Dependency> &dependencies,
+            const Schema &schema) const
+    {
+        std::vector<char> entry;
+        appendScalar(entry, kMagic);
+        appendScalar(entry, kVersion);
+        appendScalar(entry, rootFingerprint);
+        appendScalar(entry, static_cast<uint32_t>(dependencies.size()));
+        for (size_t index = 0; index < dependencies.size(); index++) {
+            const Dependency &dependency = dependencies[index];
+            appendScalar(entry,
+                    static_cast<uint32_t>(dependency.first.size()));
+            entry.insert(entry.end(), dependency.first.begin(),
+                    dependency.first.end());
+            appendScalar(entry, dependency.second);
+        }
+
+        serializeBinarySchema(schema, entry);
+
+        // Written under a temporary name and renamed into place, so that a
+        // concurrent reader never sees a partial entry; rename failure just
+        // means another process won the race to write the same entry
+        const std::string temporaryPath = path + ".tmp";
+        {
+            std::ofstream file(temporaryPath.c_str(),
+                    std::ios::binary | std::ios::trunc);
+            if (!file.is_open()) {
+                return;
+            }
+            file.write(entry.data(),
+                    static_cast<std::streamsize>(entry.size()));
+            if (!file.good()) {
+                file.close();
+                std::remove(temporaryPath.c_str());
+                return;
+            }
+        }
+
+        if (std::rename(temporaryPath.c_str(), path.c_str()) != 0) {
+            std::remove(temporaryPath.c_str());
+        }
+    }
+
+    /// Read an entire file in binary mode; returns false if it cannot be
+    /// opened
+    static bool readFile(const std::string &path, std::string &contents)
+    {
+        std::ifstream file(path.c_str(), std::ios::binary);
+        if (!file.is_open()) {
+            return false;
+        }
+
+        contents.assign(std::istreambuf_iterator<char>(file),
+                std::istreambuf_iterator<char>());
+        return true;
+    }
+
+    /// Directory in which cache entries are stored
+    std::string m_directory;
+
+    /// Number of lookups satisfied from the cache directory
+    size_t m_hits;
+
+    /// Number of lookups that fell back to a full parse
+    size_t m_misses;
+};
+
+}  // namespace valijson
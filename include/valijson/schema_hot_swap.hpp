@@ -0,0 +1,124 @@
+/**
+ * @file
+ *
+ * @brief   Atomic hot-swapping of compiled schemas between validation threads
+ *
+ * Services that refresh their schemas from a registry need to replace a
+ * compiled Schema while validation threads are using it. Quiescing every
+ * thread before destroying and re-parsing the schema stalls the service, so
+ * HotSwappableSchema instead publishes the current schema through an atomic
+ * shared pointer: validation threads resolve a handle at the start of each
+ * validation, updaters swap a newly parsed schema in atomically, and the
+ * previous schema is destroyed when the last in-flight validation releases
+ * its handle. This mirrors read-copy-update: readers never block, and
+ * retirement of the old schema is deferred to the end of its grace period
+ * by the shared pointer's reference count.
+ *
+ * This relies on a parsed Schema being immutable through a const reference.
+ * All of Schema's mutators are non-const and validation only ever reads, so
+ * a schema published as a pointer-to-const is safe to share across threads;
+ * the one piece of lazily-initialised state, PatternConstraint's compiled
+ * regular expression, is initialised with atomic operations.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+#include <valijson/schema.hpp>
+
+namespace valijson {
+
+/// Reference-counted handle to an immutable compiled schema; holding one
+/// keeps the schema alive for the duration of a validation
+typedef std::shared_ptr<const Schema> SchemaHandle;
+
+/**
+ * @brief   Holder for the current compiled schema, supporting atomic
+ *          replacement while validations are in flight
+ *
+ * Validation threads call load() once per validation and use the returned
+ * handle for the entire run; updaters parse a replacement schema off to the
+ * side and publish it with swap(). Neither operation blocks the other, and
+ * the schema that was replaced remains valid until every handle referring
+ * to it has been released.
+ *
+ * A holder may be shared freely between any number of reader and updater
+ * threads.
+ */
+class HotSwappableSchema
+{
+public:
+    /// Construct a holder with no published schema
+    HotSwappableSchema()
+      : m_generation(0) { }
+
+    /**
+     * @brief  Construct a holder that initially publishes a schema
+     *
+     * @param  schema  compiled schema to publish
+     */
+    explicit HotSwappableSchema(SchemaHandle schema)
+      : m_current(std::move(schema)),
+        m_generation(0) { }
+
+    HotSwappableSchema(const HotSwappableSchema &) = delete;
+    HotSwappableSchema & operator=(const HotSwappableSchema &) = delete;
+
+    /**
+     * @brief  Resolve a handle to the currently published schema
+     *
+     * Intended to be called once at the start of a validation; the handle
+     * pins that version of the schema for as long as it is held, so a
+     * validation is never affected by a concurrent swap.
+     *
+     * @returns handle to the current schema, or an empty handle if no
+     *          schema has been published yet
+     */
+    SchemaHandle load() const
+    {
+        return std::atomic_load(&m_current);
+    }
+
+    /**
+     * @brief  Atomically publish a replacement schema
+     *
+     * In-flight validations continue against the schema they resolved;
+     * validations that start after the swap see the replacement. The
+     * previous schema is destroyed when the returned handle and every
+     * handle held by an in-flight validation have been released.
+     *
+     * @param  replacement  newly compiled schema to publish; may be empty
+     *                      to unpublish the current schema
+     *
+     * @returns handle to the schema that was previously published
+     */
+    SchemaHandle swap(SchemaHandle replacement)
+    {
+        m_generation.fetch_add(1, std::memory_order_relaxed);
+        return std::atomic_exchange(&m_current, std::move(replacement));
+    }
+
+    /**
+     * @brief  Return the number of swaps performed on this holder
+     *
+     * Monotonically increasing; useful for logging and for detecting that
+     * an update was published without comparing schema pointers.
+     */
+    uint64_t generation() const
+    {
+        return m_generation.load(std::memory_order_relaxed);
+    }
+
+private:
+    /// Currently published schema; accessed only via atomic operations
+    SchemaHandle m_current;
+
+    /// Number of times a replacement schema has been published
+    std::atomic<uint64_t> m_generation;
+};
+
+}  // namespace valijson
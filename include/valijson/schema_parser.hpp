@@ -1,7 +1,11 @@
 #pragma once
 
+#include <cstdio>
 #include <stdexcept>
 #include <iostream>
+#include <algorithm>
+#include <deque>
+#include <set>
 #include <vector>
 #include <memory>
 #include <functional>
@@ -9,10 +13,13 @@
 #include <valijson/constraints/concrete_constraints.hpp>
 #include <valijson/internal/adapter.hpp>
 #include <valijson/internal/debug.hpp>
+#include <valijson/internal/flat_hash_map.hpp>
 #include <valijson/internal/json_pointer.hpp>
 #include <valijson/internal/json_reference.hpp>
 #include <valijson/internal/uri.hpp>
 #include <valijson/constraint_builder.hpp>
+#include <valijson/document_cache.hpp>
+#include <valijson/parallel_executor.hpp>
 #include <valijson/schema.hpp>
 #include <valijson/exceptions.hpp>
 
@@ -43,15 +50,22 @@ public:
      * @param  version  Version of JSON Schema that will be expected
      */
     explicit SchemaParser(const Version version = kDraft7)
-      : m_version(version) { }
+      : m_version(version),
+        m_populateWorklist(nullptr),
+        m_structuralCache(nullptr),
+        m_sharedSchemaCache(nullptr),
+        m_sharedStructuralCache(nullptr),
+        m_pointerCache(nullptr) { }
 
     /**
      * @brief  Release memory associated with custom ConstraintBuilders
      */
     virtual ~SchemaParser()
     {
-        for (const auto& entry : constraintBuilders) {
-            delete entry.second;
+        if (m_ownsConstraintBuilders) {
+            for (const auto& entry : constraintBuilders) {
+                delete entry.second;
+            }
         }
     }
 
@@ -70,6 +84,15 @@ public:
         typedef std::function<void (const DocumentType *)> FreeDoc;
     };
 
+    /// Cache mapping cache keys, derived from document URIs and JSON
+    /// Pointers, to populated sub-schemas. A cache normally lives for a
+    /// single populateSchema call, but SchemaRegistry keeps one alive
+    /// across calls so that sub-schemas resolved from shared documents are
+    /// parsed once and reused by every schema that references them. Keys
+    /// are probed on every '$ref' resolution, so the cache uses the flat
+    /// hash map rather than a node-based tree.
+    typedef internal::FlatHashMap<std::string, const Subschema *> SchemaCache;
+
     /**
      * @brief  Add a custom contraint to this SchemaParser
 
@@ -116,23 +139,474 @@ public:
             throwRuntimeError("Remote document fetching can't be enabled without both fetch and free functions");
         }
 
-        typename DocumentCache<AdapterType>::Type docCache;
         SchemaCache schemaCache;
+        populateSchemaWithCache(node, schema, fetchDoc, freeDoc, schemaCache);
+    }
+
+    /**
+     * @brief  Populate a Schema object, parsing root-level definitions in
+     *         parallel
+     *
+     * The sub-schemas collected under a root node's 'definitions' (or
+     * '$defs') member typically form independent subtrees, connected to
+     * the rest of the schema only through '$ref'. This overload partitions
+     * those subtrees across the given executor: each definition is parsed
+     * by its own worker, building sub-schemas into a private arena, and a
+     * sequential final pass then parses the remainder of the document,
+     * wiring '$ref' links to the pre-populated definitions through the
+     * schema cache. The arenas are adopted by the target schema, so the
+     * resulting Schema owns every sub-schema, just as it would after a
+     * sequential parse.
+     *
+     * Two behavioural differences from the sequential overloads should be
+     * noted. Every definition is compiled, including those that are never
+     * referenced, so a malformed definition that a sequential parse would
+     * never visit becomes a parse error here. And property names and
+     * frozen 'enum'/'const' values built by the workers are owned by their
+     * constraints individually, rather than interned into the schema's
+     * pools, which costs some memory when definitions repeat the same
+     * names.
+     *
+     * The fetch and free functions, when provided, may be invoked from
+     * several worker threads at once and must be safe to call
+     * concurrently.
+     *
+     * @param  node      Reference to node to parse
+     * @param  schema    Reference to Schema to populate
+     * @param  executor  Executor across which definition subtrees are
+     *                   parsed
+     * @param  fetchDoc  Function to fetch remote JSON documents (optional)
+     * @param  freeDoc   Function to free fetched documents (optional)
+     */
+    template<typename AdapterType>
+    void populateSchema(
+        const AdapterType &node,
+        Schema &schema,
+        ParallelExecutor &executor,
+        typename FunctionPtrs<AdapterType>::FetchDoc fetchDoc = nullptr,
+        typename FunctionPtrs<AdapterType>::FreeDoc freeDoc = nullptr)
+    {
+        if ((fetchDoc == nullptr ) ^ (freeDoc == nullptr)) {
+            throwRuntimeError("Remote document fetching can't be enabled without both fetch and free functions");
+        }
+
+        SchemaCache schemaCache;
+
+        // Resolution scope that applies to the root node's children,
+        // mirroring the scope update that populateSchema performs when it
+        // visits the root; keys seeded under this scope must match the
+        // keys the final pass will construct when resolving '$ref's
+        opt::optional<std::string> rootScope;
+
+        std::vector<AdapterType> definitionNodes;
+        std::vector<std::string> definitionPaths;
+
+        if (node.isObject()) {
+            const typename AdapterType::Object object = node.getObject();
+            typename AdapterType::Object::const_iterator itr =
+                    object.find("id");
+            if (itr != object.end() && itr->second.maybeString()) {
+                rootScope = itr->second.asString();
+            }
+
+            static const char * const containerNames[] =
+                    { "definitions", "$defs" };
+            for (const char * containerName : containerNames) {
+                itr = object.find(containerName);
+                if (itr == object.end() || !itr->second.isObject()) {
+                    continue;
+                }
+
+                for (const auto &member : itr->second.getObject()) {
+                    // Definitions that are merely aliases for other
+                    // schemas are left to the final pass, which resolves
+                    // reference chains with the whole document in view
+                    std::string jsonRef;
+                    if (extractJsonReference(member.second, jsonRef)) {
+                        continue;
+                    }
+
+                    definitionNodes.push_back(member.second);
+                    definitionPaths.push_back(std::string("/") +
+                            containerName + "/" +
+                            escapeJsonPointerToken(member.first));
+                }
+            }
+        }
+
+        // A lone definition parses no faster in a worker than it would in
+        // the final pass
+        if (definitionNodes.size() < 2) {
+            populateSchemaWithCache(node, schema, fetchDoc, freeDoc,
+                    schemaCache);
+            return;
+        }
+
+        // Each definition is populated into a sub-schema created up front
+        // in a private arena. The cache entries seeded here are found both
+        // by the workers, when one definition refers to another, and by
+        // the final pass, when the body of the schema does; in either case
+        // the reference links to the pre-created sub-schema without
+        // re-parsing its subtree.
+        std::deque<Schema> arenas;
+        std::vector<const Subschema *> subschemas;
+        for (size_t index = 0; index < definitionNodes.size(); index++) {
+            arenas.push_back(schema.createCompatibleSchema());
+            const Subschema *subschema = arenas.back().createSubschema();
+            subschemas.push_back(subschema);
+            const std::string key = rootScope ?
+                    (*rootScope + definitionPaths[index]) :
+                    definitionPaths[index];
+            schemaCache.insert(SchemaCache::value_type(key, subschema));
+        }
+
+        std::vector<std::function<void()>> tasks;
+        tasks.reserve(definitionNodes.size());
+        for (size_t index = 0; index < definitionNodes.size(); index++) {
+            Schema &arena = arenas[index];
+            const AdapterType &definitionNode = definitionNodes[index];
+            const std::string &definitionPath = definitionPaths[index];
+            const Subschema *subschema = subschemas[index];
+            tasks.push_back([this, &node, &arena, &definitionNode,
+                    &definitionPath, subschema, &rootScope, &fetchDoc,
+                    &freeDoc, &schemaCache]() {
+                // Each worker drives its own parser instance, since the
+                // members that track an in-progress parse cannot be shared
+                // between concurrent parses
+                SchemaParser workerParser(m_version);
+                workerParser.constraintBuilders = constraintBuilders;
+                workerParser.m_ownsConstraintBuilders = false;
+
+                // A copy of the seeded cache, so that references to other
+                // definitions resolve without touching shared state
+                SchemaCache workerCache = schemaCache;
+
+                workerParser.populateDefinition(arena, node, definitionNode,
+                        *subschema, rootScope, definitionPath, fetchDoc,
+                        freeDoc, workerCache);
+            });
+        }
+
+        executor.run(tasks);
+
+        // The target schema takes ownership of every sub-schema built by
+        // the workers, after which the arenas are empty shells
+        for (Schema &arena : arenas) {
+            schema.adoptSubschemas(arena);
+        }
+
+        // Sequential final pass over the whole document; '$ref's to the
+        // definitions populated above are satisfied from the seeded cache
+        populateSchemaWithCache(node, schema, fetchDoc, freeDoc,
+                schemaCache);
+    }
+
+private:
+
+    /**
+     * @brief  Populate a Schema object from a JSON Schema document, using
+     *         a schema cache provided by the caller
+     *
+     * Carries the body shared by the public populateSchema overloads. The
+     * cache may be seeded with sub-schemas that have been populated in
+     * advance, in which case references to the corresponding locations
+     * resolve to those sub-schemas rather than being parsed again.
+     */
+    template<typename AdapterType>
+    void populateSchemaWithCache(
+        const AdapterType &node,
+        Schema &schema,
+        const typename FunctionPtrs<AdapterType>::FetchDoc &fetchDoc,
+        const typename FunctionPtrs<AdapterType>::FreeDoc &freeDoc,
+        SchemaCache &schemaCache)
+    {
+        typename DocumentCache<AdapterType>::Type docCache;
+
+        // Property names stored by the constraints created during this parse
+        // are interned into the schema's own pool, so that each distinct
+        // name is stored once per schema rather than once per constraint
+        internal::StringInternPool::Scope internScope(schema.internPool());
+
+        // Frozen 'const' and 'enum' values are hash-consed through the
+        // schema's own pool, so that each distinct literal is frozen once
+        // per schema rather than once per constraint
+        internal::FrozenValuePool::Scope frozenScope(schema.frozenValuePool());
+
+        // Subschemas nested within the current node are populated through an
+        // explicit worklist of deferred tasks, rather than by recursing, so
+        // the depth of the C++ call stack does not grow with the nesting
+        // depth of the schema. The worklist is drained here, at the
+        // outermost call; makeOrReuseSchema appends a task for each new
+        // subschema it creates while a task is being processed.
+        PopulateWorklist populateWorklist;
+        PopulateWorklist * const previousWorklist = m_populateWorklist;
+        m_populateWorklist = &populateWorklist;
+
+        // Identical inline subschemas are shared through a cache of
+        // structural fingerprints, so that code-generated schemas which
+        // repeat the same shapes do not produce duplicate Subschema objects.
+        // A cross-parse cache installed by the registry overload takes the
+        // place of the per-parse cache, extending the sharing to identical
+        // shapes in schemas parsed earlier.
+        SchemaCache structuralCache;
+        SchemaCache * const previousStructuralCache = m_structuralCache;
+        m_structuralCache = m_sharedStructuralCache ? m_sharedStructuralCache
+                                                    : &structuralCache;
+
+        // Nodes resolved from JSON Pointers are cached for the duration of
+        // the parse, so that the many '$ref's typically naming the same
+        // few targets do not re-walk the document for each reference
+        typename PointerCache<AdapterType>::Type pointerCache;
+        void * const previousPointerCache = m_pointerCache;
+        m_pointerCache = &pointerCache;
 #if VALIJSON_USE_EXCEPTIONS
         try {
 #endif
             resolveThenPopulateSchema(schema, node, node, schema, opt::optional<std::string>(), "", fetchDoc, nullptr,
                     nullptr, docCache, schemaCache);
+
+            while (!populateWorklist.empty()) {
+                const std::function<void()> task = populateWorklist.front();
+                populateWorklist.pop_front();
+                task();
+            }
+#if VALIJSON_USE_EXCEPTIONS
+        } catch (...) {
+            m_populateWorklist = previousWorklist;
+            m_structuralCache = previousStructuralCache;
+            m_pointerCache = previousPointerCache;
+            freeDocumentCache<AdapterType>(docCache, freeDoc);
+            throw;
+        }
+#endif
+        m_populateWorklist = previousWorklist;
+        m_structuralCache = previousStructuralCache;
+        m_pointerCache = previousPointerCache;
+
+        freeDocumentCache<AdapterType>(docCache, freeDoc);
+    }
+
+    /**
+     * @brief  Populate a single definition sub-schema on behalf of the
+     *         parallel overload of populateSchema
+     *
+     * Sets up the same per-parse state as the outermost populateSchema
+     * call - worklist, structural cache, pointer cache and document cache
+     * - but scoped to one definition subtree, populating constraints into
+     * a sub-schema created in advance by the caller. Sub-schemas nested
+     * within the definition are created in the given arena, whose
+     * ownership the caller transfers to the target schema afterwards. The
+     * schema's intern pools are deliberately not activated, since they
+     * cannot be shared safely between the threads running these tasks.
+     *
+     * Must be called on a parser instance that is not being used for any
+     * other parse.
+     */
+    template<typename AdapterType>
+    void populateDefinition(
+        Schema &arena,
+        const AdapterType &rootNode,
+        const AdapterType &node,
+        const Subschema &subschema,
+        const opt::optional<std::string> &currentScope,
+        const std::string &nodePath,
+        const typename FunctionPtrs<AdapterType>::FetchDoc &fetchDoc,
+        const typename FunctionPtrs<AdapterType>::FreeDoc &freeDoc,
+        SchemaCache &schemaCache)
+    {
+        typename DocumentCache<AdapterType>::Type docCache;
+
+        PopulateWorklist populateWorklist;
+        m_populateWorklist = &populateWorklist;
+
+        SchemaCache structuralCache;
+        m_structuralCache = &structuralCache;
+
+        typename PointerCache<AdapterType>::Type pointerCache;
+        m_pointerCache = &pointerCache;
+
+#if VALIJSON_USE_EXCEPTIONS
+        try {
+#endif
+            populateSchema(arena, rootNode, node, subschema, currentScope,
+                    nodePath, fetchDoc, nullptr, nullptr, docCache,
+                    schemaCache);
+
+            while (!populateWorklist.empty()) {
+                const std::function<void()> task = populateWorklist.front();
+                populateWorklist.pop_front();
+                task();
+            }
 #if VALIJSON_USE_EXCEPTIONS
         } catch (...) {
+            m_populateWorklist = nullptr;
+            m_structuralCache = nullptr;
+            m_pointerCache = nullptr;
             freeDocumentCache<AdapterType>(docCache, freeDoc);
             throw;
         }
 #endif
+        m_populateWorklist = nullptr;
+        m_structuralCache = nullptr;
+        m_pointerCache = nullptr;
 
         freeDocumentCache<AdapterType>(docCache, freeDoc);
     }
 
+public:
+
+    /**
+     * @brief  Populate a Schema object, resolving remote references through
+     *         a shared document cache
+     *
+     * Remote documents are fetched through the given SharedDocumentCache
+     * rather than directly through a fetch function, so documents that have
+     * already been fetched while parsing another schema are reused instead
+     * of being fetched and parsed again. Documents used by this parse are
+     * pinned in the cache for the duration of the call and unpinned when it
+     * completes, at which point the cache may evict them to stay within its
+     * configured capacity.
+     *
+     * @param  node           Reference to node to parse
+     * @param  schema         Reference to Schema to populate
+     * @param  documentCache  Cache through which remote documents will be
+     *                        fetched and retained
+     */
+    template<typename AdapterType>
+    void populateSchema(
+        const AdapterType &node,
+        Schema &schema,
+        SharedDocumentCache<AdapterType> &documentCache)
+    {
+        typedef typename SharedDocumentCache<AdapterType>::DocumentType
+                DocumentType;
+
+        // The per-call document cache continues to track the documents used
+        // by this parse; on a miss it acquires through the shared cache,
+        // which pins the document, and the free path releases the pin
+        // instead of freeing the document
+        const typename FunctionPtrs<AdapterType>::FetchDoc fetchFn =
+                [&documentCache](const std::string &uri) {
+                    return documentCache.acquire(uri);
+                };
+        const typename FunctionPtrs<AdapterType>::FreeDoc freeFn =
+                [&documentCache](const DocumentType *document) {
+                    documentCache.release(document);
+                };
+
+        populateSchema(node, schema, fetchFn, freeFn);
+    }
+
+    /**
+     * @brief  Populate a Schema object, sharing resolved sub-schemas with
+     *         earlier parses through caches that outlive this call
+     *
+     * Cache entries whose keys are qualified with a document URI - that is,
+     * sub-schemas resolved from remote documents, or from documents that
+     * declare an 'id' - are looked up in, and published to, the given
+     * schema cache, so that a document of shared definitions referenced by
+     * many root schemas is parsed into Subschema objects exactly once.
+     * The structural cache extends the same treatment to identical inline
+     * sub-schemas. SchemaRegistry owns caches with the required lifetime
+     * and should normally be used instead of calling this directly.
+     *
+     * Sub-schemas found through these caches are owned by the Schema for
+     * which they were first populated. The caller must therefore keep
+     * every Schema populated against a given pair of caches alive for as
+     * long as any of them is in use.
+     *
+     * @param  node                  Reference to node to parse
+     * @param  schema                Reference to Schema to populate
+     * @param  documentCache         Cache through which remote documents
+     *                               will be fetched and retained
+     * @param  sharedSchemaCache     Cross-parse cache of sub-schemas keyed
+     *                               by document URI and JSON Pointer
+     * @param  sharedStructuralCache Cross-parse cache of sub-schemas keyed
+     *                               by structural fingerprint
+     */
+    template<typename AdapterType>
+    void populateSchema(
+        const AdapterType &node,
+        Schema &schema,
+        SharedDocumentCache<AdapterType> &documentCache,
+        SchemaCache &sharedSchemaCache,
+        SchemaCache &sharedStructuralCache)
+    {
+        SchemaCache * const previousSharedCache = m_sharedSchemaCache;
+        SchemaCache * const previousSharedStructural = m_sharedStructuralCache;
+        m_sharedSchemaCache = &sharedSchemaCache;
+        m_sharedStructuralCache = &sharedStructuralCache;
+#if VALIJSON_USE_EXCEPTIONS
+        try {
+#endif
+            populateSchema(node, schema, documentCache);
+#if VALIJSON_USE_EXCEPTIONS
+        } catch (...) {
+            m_sharedSchemaCache = previousSharedCache;
+            m_sharedStructuralCache = previousSharedStructural;
+            throw;
+        }
+#endif
+        m_sharedSchemaCache = previousSharedCache;
+        m_sharedStructuralCache = previousSharedStructural;
+    }
+
+    /**
+     * @brief  Populate a Schema object, prefetching remote references
+     *         concurrently before parsing
+     *
+     * The schema node is first walked to collect the URIs of the remote
+     * documents it references; those documents are fetched concurrently
+     * through the shared document cache, and any documents they reference
+     * in turn are fetched in subsequent waves until the reference graph is
+     * covered. Parsing then proceeds as usual, finding the documents
+     * already in the cache, so the cost of remote resolution approaches the
+     * latency of the deepest reference chain rather than the sum of all
+     * fetches.
+     *
+     * The prefetch pass is a best-effort approximation of the parser's
+     * resolution rules; any reference it fails to anticipate is simply
+     * fetched on demand during parsing, exactly as it would be without
+     * prefetching.
+     *
+     * @param  node                  Reference to node to parse
+     * @param  schema                Reference to Schema to populate
+     * @param  documentCache         Cache through which remote documents
+     *                               will be fetched and retained
+     * @param  maxConcurrentFetches  Maximum number of fetches in flight
+     */
+    template<typename AdapterType>
+    void populateSchema(
+        const AdapterType &node,
+        Schema &schema,
+        SharedDocumentCache<AdapterType> &documentCache,
+        size_t maxConcurrentFetches)
+    {
+        std::set<std::string> seenUris;
+        std::vector<std::string> wave;
+        collectExternalRefs(node, opt::optional<std::string>(), seenUris,
+                wave);
+
+        while (!wave.empty()) {
+            const std::vector<std::pair<std::string,
+                    const typename SharedDocumentCache<AdapterType>::DocumentType *>>
+                    fetched = documentCache.prefetch(wave,
+                            maxConcurrentFetches);
+            wave.clear();
+
+            // Scan each newly fetched document for further remote
+            // references, to be fetched in the next wave
+            for (const auto &entry : fetched) {
+                const AdapterType fetchedRoot(*entry.second);
+                collectExternalRefs(fetchedRoot,
+                        opt::optional<std::string>(entry.first), seenUris,
+                        wave);
+            }
+        }
+
+        populateSchema(node, schema, documentCache);
+    }
+
 private:
 
     typedef std::vector<std::pair<std::string, const ConstraintBuilder *>>
@@ -140,15 +614,221 @@ private:
 
     ConstraintBuilders constraintBuilders;
 
+    /// Whether the ConstraintBuilder pointers held by this parser should
+    /// be deleted when it is destroyed. The worker parsers created by the
+    /// parallel overload of populateSchema borrow the builders of the
+    /// parser they were created from, and must not delete them.
+    bool m_ownsConstraintBuilders = true;
+
     template<typename AdapterType>
     struct DocumentCache
     {
         typedef typename adapters::AdapterTraits<AdapterType>::DocumentType DocumentType;
 
-        typedef std::map<std::string, const DocumentType*> Type;
+        typedef internal::FlatHashMap<std::string, const DocumentType*> Type;
     };
 
-    typedef std::map<std::string, const Subschema *> SchemaCache;
+    /// Per-parse cache of nodes resolved from JSON Pointers, keyed on the
+    /// same document-and-pointer strings used by the schema cache, so that
+    /// repeated '$ref's to the same target walk the document only once
+    template<typename AdapterType>
+    struct PointerCache
+    {
+        typedef internal::FlatHashMap<std::string, AdapterType> Type;
+    };
+
+    /// Queue of deferred schema population tasks. Each task populates one
+    /// subschema from one node, and may enqueue further tasks for the
+    /// subschemas nested within that node. Tasks are type-erased closures so
+    /// that the worklist itself does not depend on the Adapter type.
+    typedef std::deque<std::function<void()>> PopulateWorklist;
+
+    /// Maximum nesting depth of a schema node that will be fingerprinted
+    /// for structural deduplication; deeper nodes are simply not shared,
+    /// which keeps the cost of fingerprinting bounded
+    static const size_t kMaxFingerprintDepth = 64;
+
+    /**
+     * @brief  Render a canonical fingerprint of a schema node
+     *
+     * The fingerprint is a serialisation of the node with object members
+     * ordered by name and with unambiguous length-prefixed strings, so two
+     * nodes produce the same fingerprint if and only if they are
+     * structurally identical. It is used to share a single Subschema
+     * between identical inline subschemas, which code-generated schemas
+     * tend to repeat many times.
+     *
+     * Nodes that contain a '\$ref' or 'id' member anywhere in their subtree
+     * are not fingerprinted, since their meaning depends on where they
+     * appear; nor are nodes nested more deeply than kMaxFingerprintDepth.
+     *
+     * @param  node    node to fingerprint
+     * @param  depth   current nesting depth within the node being
+     *                 fingerprinted
+     * @param  result  string that the fingerprint is appended to
+     *
+     * @return \c true if a fingerprint was produced; \c false if the node
+     *         is not eligible for structural deduplication
+     */
+    template<typename AdapterType>
+    static bool fingerprintSchemaNode(const AdapterType &node, size_t depth,
+            std::string &result)
+    {
+        if (depth > kMaxFingerprintDepth) {
+            return false;
+        }
+
+        if (node.isObject()) {
+            // Copy the members so that they can be visited in a canonical
+            // order, regardless of the order the underlying document
+            // parser happens to store them in
+            typedef std::pair<std::string, AdapterType> Member;
+            std::vector<Member> members;
+            for (const typename AdapterType::ObjectMember m : node.asObject()) {
+                if (m.first == "$ref" || m.first == "id") {
+                    return false;
+                }
+                members.push_back(Member(m.first, m.second));
+            }
+
+            // Adapters are not assignable, so sort an index into the
+            // members rather than the members themselves
+            std::vector<size_t> order;
+            for (size_t i = 0; i < members.size(); i++) {
+                order.push_back(i);
+            }
+            std::sort(order.begin(), order.end(),
+                    [&members](size_t lhs, size_t rhs) {
+                        return members[lhs].first < members[rhs].first;
+                    });
+
+            result += '{';
+            for (const size_t index : order) {
+                const Member &member = members[index];
+                result += std::to_string(member.first.size());
+                result += ':';
+                result += member.first;
+                result += ':';
+                if (!fingerprintSchemaNode(member.second, depth + 1, result)) {
+                    return false;
+                }
+            }
+            result += '}';
+
+        } else if (node.isArray()) {
+            result += '[';
+            for (const AdapterType element : node.asArray()) {
+                if (!fingerprintSchemaNode(element, depth + 1, result)) {
+                    return false;
+                }
+                result += ',';
+            }
+            result += ']';
+
+        } else if (node.isString()) {
+            const std::string value = node.asString();
+            result += 's';
+            result += std::to_string(value.size());
+            result += ':';
+            result += value;
+
+        } else if (node.isBool()) {
+            result += node.asBool() ? 't' : 'f';
+
+        } else if (node.isInteger()) {
+            result += 'i';
+            result += std::to_string(node.asInteger());
+
+        } else if (node.isNumber()) {
+            // Render with enough precision that distinct doubles never
+            // produce the same fingerprint
+            char buffer[32];
+            snprintf(buffer, sizeof(buffer), "d%.17g", node.asDouble());
+            result += buffer;
+
+        } else if (node.isNull()) {
+            result += 'n';
+
+        } else {
+            return false;
+        }
+
+        return true;
+    }
+
+    /**
+     * @brief  Recursively collect the URIs of remote documents that a
+     *         schema node refers to
+     *
+     * This mirrors the resolution rules applied by
+     * resolveThenPopulateSchema: the resolution scope is updated by 'id'
+     * attributes as the node is traversed, and a '\$ref' node terminates
+     * traversal of its branch, since the parser substitutes the referenced
+     * schema at that point. It is a best-effort pass used only to warm the
+     * document cache; missed references are fetched on demand by the
+     * parser.
+     *
+     * @param  node          node to scan
+     * @param  currentScope  URI for current resolution scope
+     * @param  seenUris      URIs already collected or scanned
+     * @param  wave          receives newly discovered document URIs
+     */
+    template<typename AdapterType>
+    void collectExternalRefs(
+        const AdapterType &node,
+        const opt::optional<std::string> &currentScope,
+        std::set<std::string> &seenUris,
+        std::vector<std::string> &wave)
+    {
+        if (node.isArray()) {
+            for (const AdapterType element : node.asArray()) {
+                collectExternalRefs(element, currentScope, seenUris, wave);
+            }
+            return;
+        }
+
+        if (!node.isObject()) {
+            return;
+        }
+
+        const typename AdapterType::Object object = node.asObject();
+        typename AdapterType::Object::const_iterator itr = object.find("$ref");
+        if (itr != object.end() && itr->second.maybeString()) {
+            const std::string jsonRef = itr->second.asString();
+            const opt::optional<std::string> documentUri =
+                    internal::json_reference::getJsonReferenceUri(jsonRef);
+            const opt::optional<std::string> actualDocumentUri =
+                    resolveDocumentUri(currentScope, documentUri);
+            if (actualDocumentUri &&
+                    (!currentScope || *actualDocumentUri != *currentScope) &&
+                    seenUris.insert(*actualDocumentUri).second) {
+                wave.push_back(*actualDocumentUri);
+            }
+
+            // The parser replaces a $ref node with the referenced schema,
+            // so sibling members are not parsed
+            return;
+        }
+
+        // Update the resolution scope, as populateSchema would
+        opt::optional<std::string> updatedScope = currentScope;
+        itr = object.find("id");
+        if (itr != object.end() && itr->second.maybeString()) {
+            const std::string id = itr->second.asString();
+            if (!currentScope || internal::uri::isUriAbsolute(id) ||
+                    internal::uri::isUrn(id)) {
+                updatedScope = id;
+            } else {
+                updatedScope = internal::uri::resolveRelativeUri(
+                        *currentScope, id);
+            }
+        }
+
+        for (typename AdapterType::Object::const_iterator m = object.begin();
+                m != object.end(); ++m) {
+            collectExternalRefs(m->second, updatedScope, seenUris, wave);
+        }
+    }
 
     /**
      * @brief  Free memory used by fetched documents
@@ -278,6 +958,29 @@ private:
         return "";
     }
 
+    /**
+     * Escape a member name for use as a JSON Pointer reference token,
+     * performing the inverse of the unescaping described in RFC 6901, so
+     * that a key seeded for a definition matches the pointer that a '$ref'
+     * to that definition would contain
+     */
+    static std::string escapeJsonPointerToken(const std::string &token)
+    {
+        std::string escaped;
+        escaped.reserve(token.size());
+        for (const char c : token) {
+            if (c == '~') {
+                escaped += "~0";
+            } else if (c == '/') {
+                escaped += "~1";
+            } else {
+                escaped += c;
+            }
+        }
+
+        return escaped;
+    }
+
     /**
      * @brief  Search the schema cache for a schema matching a given key
      *
@@ -327,11 +1030,52 @@ private:
     }
 
     /**
-     * @brief  Recursive helper function for retrieving or creating schemas
+     * @brief  Return whether a cache key remains meaningful beyond a
+     *         single parse
      *
-     * This function will be applied recursively until a concrete node is found.
-     * A concrete node is a node that contains actual schema constraints rather
-     * than a JSON Reference.
+     * Keys formed without a document URI consist only of a JSON Pointer,
+     * which is either empty or begins with '/'. Such keys describe a
+     * location within whichever document happens to be under parse, so
+     * they must not be shared between parses of different documents.
+     *
+     * @param  key  cache key to examine
+     */
+    static bool isSharableCacheKey(const std::string &key)
+    {
+        return !key.empty() && key.front() != '/';
+    }
+
+    /**
+     * @brief  Publish cache entries to the cross-parse schema cache
+     *
+     * Only keys that remain meaningful across parses are published, and
+     * keys that are already present are left untouched. Does nothing when
+     * no cross-parse cache is installed.
+     *
+     * @param  keys       list of candidate keys to publish
+     * @param  subschema  sub-schema that the keys will map to
+     */
+    void shareCacheKeys(const std::vector<std::string> &keys,
+            const Subschema *subschema)
+    {
+        if (!m_sharedSchemaCache) {
+            return;
+        }
+
+        for (const std::string &key : keys) {
+            if (isSharableCacheKey(key)) {
+                m_sharedSchemaCache->insert(
+                        SchemaCache::value_type(key, subschema));
+            }
+        }
+    }
+
+    /**
+     * @brief  Helper function for retrieving or creating schemas
+     *
+     * This function follows chains of JSON References iteratively until a
+     * concrete node is found. A concrete node is a node that contains actual
+     * schema constraints rather than a JSON Reference.
      *
      * This termination condition may be trigged by visiting the concrete node
      * at the end of a series of $ref nodes, or by finding a schema for one of
@@ -371,126 +1115,206 @@ private:
         SchemaCache &schemaCache,
         std::vector<std::string> &newCacheKeys)
     {
-        std::string jsonRef;
-
-        // Check for the first termination condition (found a non-$ref node)
-        if (!extractJsonReference(node, jsonRef)) {
-
-            // Construct a key that we can use to search the schema cache for
-            // a schema corresponding to the current node
-            const std::string schemaCacheKey = currentScope ? (*currentScope + nodePath) : nodePath;
+        // Adapters for the nodes visited while following a chain of JSON
+        // References; a deque preserves the addresses of its elements as it
+        // grows, so the 'current' pointers below remain valid
+        std::deque<AdapterType> visitedNodes;
+
+        const AdapterType *currentRootNode = &rootNode;
+        const AdapterType *currentNode = &node;
+        std::string currentNodePath = nodePath;
+
+        // Follow the chain of JSON References iteratively, until a concrete
+        // node or a cached schema is found
+        for (;;) {
+            std::string jsonRef;
+
+            // Check for the first termination condition (found a non-$ref
+            // node)
+            if (!extractJsonReference(*currentNode, jsonRef)) {
+
+                // Construct a key that we can use to search the schema cache
+                // for a schema corresponding to the current node
+                const std::string schemaCacheKey =
+                        currentScope ? (*currentScope + currentNodePath) : currentNodePath;
+
+                // Retrieve an existing schema from the cache if possible
+                const Subschema *cachedPtr = querySchemaCache(schemaCache, schemaCacheKey);
+
+                // Failing that, consult the cross-parse cache, which may
+                // hold the sub-schema from a parse of an earlier schema
+                // that resolved the same URI-qualified key
+                if (!cachedPtr && m_sharedSchemaCache &&
+                        isSharableCacheKey(schemaCacheKey)) {
+                    cachedPtr = querySchemaCache(*m_sharedSchemaCache,
+                            schemaCacheKey);
+                }
 
-            // Retrieve an existing schema from the cache if possible
-            const Subschema *cachedPtr = querySchemaCache(schemaCache, schemaCacheKey);
+                // Failing that, fingerprint the node and check whether a
+                // structurally identical subschema has been seen elsewhere
+                // in this parse; draft 3 subschemas are never shared, since
+                // their 'required' keyword modifies the enclosing schema
+                std::string fingerprint;
+                bool fingerprinted = false;
+                if (!cachedPtr && m_structuralCache && m_version != kDraft3) {
+                    fingerprinted = fingerprintSchemaNode(*currentNode, 0, fingerprint);
+                    if (fingerprinted) {
+                        cachedPtr = querySchemaCache(*m_structuralCache, fingerprint);
+                    }
+                }
 
-            // Create a new schema otherwise
-            const Subschema *subschema = cachedPtr ? cachedPtr : rootSchema.createSubschema();
+                // Create a new schema otherwise
+                const Subschema *subschema = cachedPtr ? cachedPtr : rootSchema.createSubschema();
+
+                // Add cache entries for keys belonging to any $ref nodes that
+                // were visited before arriving at the current node
+                updateSchemaCache(schemaCache, newCacheKeys, subschema);
+                shareCacheKeys(newCacheKeys, subschema);
+
+                // Schema cache did not contain a pre-existing schema
+                // corresponding to the current node, so the schema that was
+                // returned will need to be populated
+                if (!cachedPtr) {
+                    // Future occurrences of a structurally identical node
+                    // will share the subschema populated from this one
+                    if (fingerprinted) {
+                        m_structuralCache->insert(
+                                SchemaCache::value_type(fingerprint, subschema));
+                    }
 
-            // Add cache entries for keys belonging to any $ref nodes that were
-            // visited before arriving at the current node
-            updateSchemaCache(schemaCache, newCacheKeys, subschema);
+                    if (m_populateWorklist) {
+                        // Defer population of the new subschema to the
+                        // worklist drained by the outermost populateSchema
+                        // call, so that nested subschemas are processed
+                        // iteratively rather than recursively. The closure
+                        // owns copies of everything that may not outlive the
+                        // caller's stack frame.
+                        const AdapterType taskRootNode = *currentRootNode;
+                        const AdapterType taskNode = *currentNode;
+                        const bool hasOwnName = (ownName != nullptr);
+                        const std::string ownNameCopy = hasOwnName ? *ownName : std::string();
+                        m_populateWorklist->push_back(
+                                [this, &rootSchema, taskRootNode, taskNode, subschema,
+                                        currentScope, currentNodePath, fetchDoc, parentSubschema,
+                                        hasOwnName, ownNameCopy, &docCache, &schemaCache]() {
+                                    populateSchema(rootSchema, taskRootNode, taskNode,
+                                            *subschema, currentScope, currentNodePath,
+                                            fetchDoc, parentSubschema,
+                                            hasOwnName ? &ownNameCopy : nullptr,
+                                            docCache, schemaCache);
+                                });
+                    } else {
+                        populateSchema(rootSchema, *currentRootNode, *currentNode,
+                                *subschema, currentScope, currentNodePath, fetchDoc,
+                                parentSubschema, ownName, docCache, schemaCache);
+                    }
+                }
 
-            // Schema cache did not contain a pre-existing schema corresponding
-            // to the current node, so the schema that was returned will need
-            // to be populated
-            if (!cachedPtr) {
-                populateSchema(rootSchema, rootNode, node, *subschema,
-                        currentScope, nodePath, fetchDoc, parentSubschema,
-                        ownName, docCache, schemaCache);
+                return subschema;
             }
 
-            return subschema;
-        }
+            // Returns a document URI if the reference points somewhere
+            // other than the current document
+            const opt::optional<std::string> documentUri =
+                    internal::json_reference::getJsonReferenceUri(jsonRef);
+
+            // Extract JSON Pointer from JSON Reference, with any trailing
+            // slashes removed so that keys in the schema cache end
+            // consistently
+            const std::string actualJsonPointer = sanitiseJsonPointer(
+                    internal::json_reference::getJsonReferencePointer(jsonRef));
+
+            // Determine the actual document URI based on the resolution
+            // scope. An absolute document URI will take precedence when
+            // present, otherwise we need to resolve the URI relative to
+            // the current resolution scope
+            const opt::optional<std::string> actualDocumentUri =
+                    resolveDocumentUri(currentScope, documentUri);
+
+            // Construct a key to search the schema cache for an existing
+            // schema
+            const std::string queryKey =
+                    actualDocumentUri ? (*actualDocumentUri + actualJsonPointer) : actualJsonPointer;
+
+            // Check for the second termination condition (found a $ref node
+            // that already has an entry in the schema cache)
+            const Subschema *cachedPtr = querySchemaCache(schemaCache, queryKey);
+
+            // References into documents resolved while parsing an earlier
+            // schema may be satisfied by the cross-parse cache instead
+            if (!cachedPtr && m_sharedSchemaCache &&
+                    isSharableCacheKey(queryKey)) {
+                cachedPtr = querySchemaCache(*m_sharedSchemaCache, queryKey);
+                if (cachedPtr) {
+                    schemaCache.insert(
+                            SchemaCache::value_type(queryKey, cachedPtr));
+                }
+            }
 
-        // Returns a document URI if the reference points somewhere
-        // other than the current document
-        const opt::optional<std::string> documentUri = internal::json_reference::getJsonReferenceUri(jsonRef);
+            if (cachedPtr) {
+                updateSchemaCache(schemaCache, newCacheKeys, cachedPtr);
+                shareCacheKeys(newCacheKeys, cachedPtr);
+                return cachedPtr;
+            }
 
-        // Extract JSON Pointer from JSON Reference, with any trailing
-        // slashes removed so that keys in the schema cache end
-        // consistently
-        const std::string actualJsonPointer = sanitiseJsonPointer(
-                internal::json_reference::getJsonReferencePointer(jsonRef));
+            // A key that has already been visited while following this
+            // chain of references indicates a degenerate circular reference
+            if (std::find(newCacheKeys.begin(), newCacheKeys.end(), queryKey) != newCacheKeys.end()) {
+                throwRuntimeError("Circular JSON Reference detected while parsing " + queryKey);
+            }
 
-        // Determine the actual document URI based on the resolution
-        // scope. An absolute document URI will take precedence when
-        // present, otherwise we need to resolve the URI relative to
-        // the current resolution scope
-        const opt::optional<std::string> actualDocumentUri = resolveDocumentUri(currentScope, documentUri);
+            if (actualDocumentUri && (!currentScope || *actualDocumentUri != *currentScope)) {
+                const typename FunctionPtrs<AdapterType>::DocumentType *newDoc = nullptr;
 
-        // Construct a key to search the schema cache for an existing schema
-        const std::string queryKey = actualDocumentUri ? (*actualDocumentUri + actualJsonPointer) : actualJsonPointer;
+                // Have we seen this document before?
+                typename DocumentCache<AdapterType>::Type::iterator docCacheItr =
+                        docCache.find(*actualDocumentUri);
+                if (docCacheItr == docCache.end()) {
+                    // Resolve reference against remote document
+                    if (!fetchDoc) {
+                        throwRuntimeError("Fetching of remote JSON References not enabled.");
+                    }
 
-        // Check for the second termination condition (found a $ref node that
-        // already has an entry in the schema cache)
-        const Subschema *cachedPtr = querySchemaCache(schemaCache, queryKey);
-        if (cachedPtr) {
-            updateSchemaCache(schemaCache, newCacheKeys, cachedPtr);
-            return cachedPtr;
-        }
+                    // Returns a pointer to the remote document that was
+                    // retrieved, or null if retrieval failed. This class
+                    // will take ownership of the pointer, and call freeDoc
+                    // when it is no longer needed.
+                    newDoc = fetchDoc(*actualDocumentUri);
 
-        if (actualDocumentUri && (!currentScope || *actualDocumentUri != *currentScope)) {
-            const typename FunctionPtrs<AdapterType>::DocumentType *newDoc = nullptr;
+                    // Can't proceed without the remote document
+                    if (!newDoc) {
+                        throwRuntimeError("Failed to fetch referenced schema document: " + *actualDocumentUri);
+                    }
 
-            // Have we seen this document before?
-            typename DocumentCache<AdapterType>::Type::iterator docCacheItr =
-                    docCache.find(*actualDocumentUri);
-            if (docCacheItr == docCache.end()) {
-                // Resolve reference against remote document
-                if (!fetchDoc) {
-                    throwRuntimeError("Fetching of remote JSON References not enabled.");
-                }
+                    typedef typename DocumentCache<AdapterType>::Type::value_type
+                            DocCacheValueType;
 
-                // Returns a pointer to the remote document that was
-                // retrieved, or null if retrieval failed. This class
-                // will take ownership of the pointer, and call freeDoc
-                // when it is no longer needed.
-                newDoc = fetchDoc(*actualDocumentUri);
+                    docCache.insert(DocCacheValueType(*actualDocumentUri, newDoc));
 
-                // Can't proceed without the remote document
-                if (!newDoc) {
-                    throwRuntimeError("Failed to fetch referenced schema document: " + *actualDocumentUri);
+                } else {
+                    newDoc = docCacheItr->second;
                 }
 
-                typedef typename DocumentCache<AdapterType>::Type::value_type
-                        DocCacheValueType;
+                // Continue from the referenced node, with nested JSON
+                // References resolved relative to the new root node
+                visitedNodes.push_back(AdapterType(*newDoc));
+                currentRootNode = &visitedNodes.back();
 
-                docCache.insert(DocCacheValueType(*actualDocumentUri, newDoc));
+                visitedNodes.push_back(resolveJsonPointerCached(
+                        *currentRootNode, actualJsonPointer, queryKey));
+                currentNode = &visitedNodes.back();
 
             } else {
-                newDoc = docCacheItr->second;
+                // JSON References in the nested schema will be resolved
+                // relative to the current document
+                visitedNodes.push_back(resolveJsonPointerCached(
+                        *currentRootNode, actualJsonPointer, queryKey));
+                currentNode = &visitedNodes.back();
             }
 
-            const AdapterType newRootNode(*newDoc);
-
-            // Find where we need to be in the document
-            const AdapterType &referencedAdapter =
-                    internal::json_pointer::resolveJsonPointer(newRootNode,
-                            actualJsonPointer);
-
             newCacheKeys.push_back(queryKey);
-
-            // Populate the schema, starting from the referenced node, with
-            // nested JSON References resolved relative to the new root node
-            return makeOrReuseSchema(rootSchema, newRootNode, referencedAdapter,
-                    currentScope, actualJsonPointer, fetchDoc, parentSubschema,
-                    ownName, docCache, schemaCache, newCacheKeys);
-
+            currentNodePath = actualJsonPointer;
         }
-
-        // JSON References in nested schema will be resolved relative to the
-        // current document
-        const AdapterType &referencedAdapter =
-                internal::json_pointer::resolveJsonPointer(
-                        rootNode, actualJsonPointer);
-
-        newCacheKeys.push_back(queryKey);
-
-        // Populate the schema, starting from the referenced node, with
-        // nested JSON References resolved relative to the new root node
-        return makeOrReuseSchema(rootSchema, rootNode, referencedAdapter,
-                currentScope, actualJsonPointer, fetchDoc, parentSubschema,
-                ownName, docCache, schemaCache, newCacheKeys);
     }
 
     /**
@@ -541,6 +1365,228 @@ private:
                 schemaCache, schemaCacheKeysToCreate);
     }
 
+    /// Identifies the JSON Schema keywords recognised by populateSchema
+    enum Keyword
+    {
+        kKeywordId = 0,
+        kKeywordType,
+        kKeywordAllOf,
+        kKeywordAnyOf,
+        kKeywordConst,
+        kKeywordContains,
+        kKeywordDependencies,
+        kKeywordDescription,
+        kKeywordDivisibleBy,
+        kKeywordEnum,
+        kKeywordFormat,
+        kKeywordItems,
+        kKeywordAdditionalItems,
+        kKeywordIf,
+        kKeywordThen,
+        kKeywordElse,
+        kKeywordExclusiveMaximum,
+        kKeywordMaximum,
+        kKeywordMaxContains,
+        kKeywordMaxItems,
+        kKeywordMaxLength,
+        kKeywordMaxProperties,
+        kKeywordExclusiveMinimum,
+        kKeywordMinimum,
+        kKeywordMinContains,
+        kKeywordMinItems,
+        kKeywordMinLength,
+        kKeywordMinProperties,
+        kKeywordMultipleOf,
+        kKeywordNot,
+        kKeywordOneOf,
+        kKeywordPattern,
+        kKeywordProperties,
+        kKeywordPatternProperties,
+        kKeywordAdditionalProperties,
+        kKeywordPropertyNames,
+        kKeywordRequired,
+        kKeywordTitle,
+        kKeywordUniqueItems,
+
+        kNumKeywords
+    };
+
+    /**
+     * @brief  Map a schema object member name to a known keyword
+     *
+     * Dispatch switches on the first character of the name before comparing
+     * against the handful of keywords that share it, so that a schema node
+     * can be scanned with a single pass over its members instead of a
+     * separate lookup for each of the ~40 recognised keywords.
+     *
+     * @param  name     member name to look up
+     * @param  keyword  reference that receives the keyword on success
+     *
+     * @returns  true if the name matches a known keyword
+     */
+    static bool lookupKeyword(const std::string &name, Keyword &keyword)
+    {
+        if (name.empty()) {
+            return false;
+        }
+
+        switch (name[0]) {
+        case 'a':
+            if (name == "allOf") {
+                keyword = kKeywordAllOf;
+            } else if (name == "anyOf") {
+                keyword = kKeywordAnyOf;
+            } else if (name == "additionalItems") {
+                keyword = kKeywordAdditionalItems;
+            } else if (name == "additionalProperties") {
+                keyword = kKeywordAdditionalProperties;
+            } else {
+                return false;
+            }
+            return true;
+
+        case 'c':
+            if (name == "const") {
+                keyword = kKeywordConst;
+            } else if (name == "contains") {
+                keyword = kKeywordContains;
+            } else {
+                return false;
+            }
+            return true;
+
+        case 'd':
+            if (name == "dependencies") {
+                keyword = kKeywordDependencies;
+            } else if (name == "description") {
+                keyword = kKeywordDescription;
+            } else if (name == "divisibleBy") {
+                keyword = kKeywordDivisibleBy;
+            } else {
+                return false;
+            }
+            return true;
+
+        case 'e':
+            if (name == "enum") {
+                keyword = kKeywordEnum;
+            } else if (name == "exclusiveMaximum") {
+                keyword = kKeywordExclusiveMaximum;
+            } else if (name == "exclusiveMinimum") {
+                keyword = kKeywordExclusiveMinimum;
+            } else if (name == "else") {
+                keyword = kKeywordElse;
+            } else {
+                return false;
+            }
+            return true;
+
+        case 'f':
+            if (name == "format") {
+                keyword = kKeywordFormat;
+                return true;
+            }
+            return false;
+
+        case 'i':
+            if (name == "id") {
+                keyword = kKeywordId;
+            } else if (name == "items") {
+                keyword = kKeywordItems;
+            } else if (name == "if") {
+                keyword = kKeywordIf;
+            } else {
+                return false;
+            }
+            return true;
+
+        case 'm':
+            if (name == "maximum") {
+                keyword = kKeywordMaximum;
+            } else if (name == "maxContains") {
+                keyword = kKeywordMaxContains;
+            } else if (name == "maxItems") {
+                keyword = kKeywordMaxItems;
+            } else if (name == "maxLength") {
+                keyword = kKeywordMaxLength;
+            } else if (name == "maxProperties") {
+                keyword = kKeywordMaxProperties;
+            } else if (name == "minimum") {
+                keyword = kKeywordMinimum;
+            } else if (name == "minContains") {
+                keyword = kKeywordMinContains;
+            } else if (name == "minItems") {
+                keyword = kKeywordMinItems;
+            } else if (name == "minLength") {
+                keyword = kKeywordMinLength;
+            } else if (name == "minProperties") {
+                keyword = kKeywordMinProperties;
+            } else if (name == "multipleOf") {
+                keyword = kKeywordMultipleOf;
+            } else {
+                return false;
+            }
+            return true;
+
+        case 'n':
+            if (name == "not") {
+                keyword = kKeywordNot;
+                return true;
+            }
+            return false;
+
+        case 'o':
+            if (name == "oneOf") {
+                keyword = kKeywordOneOf;
+                return true;
+            }
+            return false;
+
+        case 'p':
+            if (name == "pattern") {
+                keyword = kKeywordPattern;
+            } else if (name == "properties") {
+                keyword = kKeywordProperties;
+            } else if (name == "patternProperties") {
+                keyword = kKeywordPatternProperties;
+            } else if (name == "propertyNames") {
+                keyword = kKeywordPropertyNames;
+            } else {
+                return false;
+            }
+            return true;
+
+        case 'r':
+            if (name == "required") {
+                keyword = kKeywordRequired;
+                return true;
+            }
+            return false;
+
+        case 't':
+            if (name == "type") {
+                keyword = kKeywordType;
+            } else if (name == "title") {
+                keyword = kKeywordTitle;
+            } else if (name == "then") {
+                keyword = kKeywordThen;
+            } else {
+                return false;
+            }
+            return true;
+
+        case 'u':
+            if (name == "uniqueItems") {
+                keyword = kKeywordUniqueItems;
+                return true;
+            }
+            return false;
+
+        default:
+            return false;
+        }
+    }
+
     /**
      * @brief  Populate a Schema object from JSON Schema document
      *
@@ -608,11 +1654,26 @@ private:
         }
 
         const typename AdapterType::Object object = node.asObject();
-        typename AdapterType::Object::const_iterator itr(object.end());
+        typedef typename AdapterType::Object::const_iterator ObjectIterator;
+        ObjectIterator itr(object.end());
+
+        // Scan the node's members once, recording where each recognised
+        // keyword occurs; the constraint-specific logic below then reads
+        // from this table instead of performing a lookup per keyword
+        std::vector<ObjectIterator> keywords(kNumKeywords, object.end());
+        std::vector<ObjectIterator> customKeywords;
+        for (ObjectIterator m = object.begin(); m != object.end(); ++m) {
+            Keyword keyword;
+            if (lookupKeyword(m->first, keyword)) {
+                keywords[keyword] = m;
+            } else if (!constraintBuilders.empty()) {
+                customKeywords.push_back(m);
+            }
+        }
 
         // Check for 'id' attribute and update current scope
         opt::optional<std::string> updatedScope;
-        if ((itr = object.find("id")) != object.end() && itr->second.maybeString()) {
+        if ((itr = keywords[kKeywordId]) != object.end() && itr->second.maybeString()) {
             const std::string id = itr->second.asString();
             rootSchema.setSubschemaId(&subschema, itr->second.asString());
             if (!currentScope || internal::uri::isUriAbsolute(id) || internal::uri::isUrn(id)) {
@@ -625,14 +1686,14 @@ private:
         }
 
         // Add the type constraint first to be the first one to check because other constraints may rely on it
-        if ((itr = object.find("type")) != object.end()) {
+        if ((itr = keywords[kKeywordType]) != object.end()) {
             rootSchema.addConstraintToSubschema(
                     makeTypeConstraint(rootSchema, rootNode, itr->second, updatedScope, nodePath + "/type", fetchDoc,
                             docCache, schemaCache),
                     &subschema);
         }
 
-        if ((itr = object.find("allOf")) != object.end()) {
+        if ((itr = keywords[kKeywordAllOf]) != object.end()) {
             rootSchema.addConstraintToSubschema(
                     makeAllOfConstraint(rootSchema, rootNode, itr->second,
                             updatedScope, nodePath + "/allOf", fetchDoc,
@@ -640,7 +1701,7 @@ private:
                     &subschema);
         }
 
-        if ((itr = object.find("anyOf")) != object.end()) {
+        if ((itr = keywords[kKeywordAnyOf]) != object.end()) {
             rootSchema.addConstraintToSubschema(
                     makeAnyOfConstraint(rootSchema, rootNode, itr->second,
                             updatedScope, nodePath + "/anyOf", fetchDoc,
@@ -648,18 +1709,22 @@ private:
                     &subschema);
         }
 
-        if ((itr = object.find("const")) != object.end()) {
+        if ((itr = keywords[kKeywordConst]) != object.end()) {
             rootSchema.addConstraintToSubschema(makeConstConstraint(itr->second), &subschema);
         }
 
-        if ((itr = object.find("contains")) != object.end()) {
+        if ((itr = keywords[kKeywordContains]) != object.end()) {
+            const ObjectIterator minContainsItr = keywords[kKeywordMinContains];
+            const ObjectIterator maxContainsItr = keywords[kKeywordMaxContains];
             rootSchema.addConstraintToSubschema(
                     makeContainsConstraint(rootSchema, rootNode, itr->second,
+                            minContainsItr == object.end() ? nullptr : &minContainsItr->second,
+                            maxContainsItr == object.end() ? nullptr : &maxContainsItr->second,
                             updatedScope, nodePath + "/contains", fetchDoc,
                             docCache, schemaCache), &subschema);
         }
 
-        if ((itr = object.find("dependencies")) != object.end()) {
+        if ((itr = keywords[kKeywordDependencies]) != object.end()) {
             rootSchema.addConstraintToSubschema(
                     makeDependenciesConstraint(rootSchema, rootNode,
                             itr->second, updatedScope,
@@ -668,7 +1733,7 @@ private:
                     &subschema);
         }
 
-        if ((itr = object.find("description")) != object.end()) {
+        if ((itr = keywords[kKeywordDescription]) != object.end()) {
             if (itr->second.maybeString()) {
                 rootSchema.setSubschemaDescription(&subschema,
                         itr->second.asString());
@@ -678,7 +1743,7 @@ private:
             }
         }
 
-        if ((itr = object.find("divisibleBy")) != object.end()) {
+        if ((itr = keywords[kKeywordDivisibleBy]) != object.end()) {
             if (m_version == kDraft3) {
                 if (itr->second.maybeInteger()) {
                     rootSchema.addConstraintToSubschema(
@@ -698,17 +1763,16 @@ private:
             }
         }
 
-        if ((itr = object.find("enum")) != object.end()) {
+        if ((itr = keywords[kKeywordEnum]) != object.end()) {
             rootSchema.addConstraintToSubschema(makeEnumConstraint(itr->second), &subschema);
         }
 
-        if ((itr = object.find("format")) != object.end()) {
+        if ((itr = keywords[kKeywordFormat]) != object.end()) {
             rootSchema.addConstraintToSubschema(makeFormatConstraint(itr->second), &subschema);
         }
 
         {
-            const typename AdapterType::Object::const_iterator itemsItr =
-                    object.find("items");
+            const ObjectIterator itemsItr = keywords[kKeywordItems];
 
             if (object.end() != itemsItr) {
                 if (!itemsItr->second.isArray()) {
@@ -720,8 +1784,8 @@ private:
                             &subschema);
 
                 } else {
-                    const typename AdapterType::Object::const_iterator
-                            additionalItemsItr = object.find("additionalItems");
+                    const ObjectIterator additionalItemsItr =
+                            keywords[kKeywordAdditionalItems];
                     rootSchema.addConstraintToSubschema(
                             makeLinearItemsConstraint(rootSchema, rootNode,
                                     itemsItr != object.end() ? &itemsItr->second : nullptr,
@@ -735,9 +1799,9 @@ private:
         }
 
         {
-            const typename AdapterType::Object::const_iterator ifItr = object.find("if");
-            const typename AdapterType::Object::const_iterator thenItr = object.find("then");
-            const typename AdapterType::Object::const_iterator elseItr = object.find("else");
+            const ObjectIterator ifItr = keywords[kKeywordIf];
+            const ObjectIterator thenItr = keywords[kKeywordThen];
+            const ObjectIterator elseItr = keywords[kKeywordElse];
 
             if (object.end() != ifItr) {
                 if (m_version == kDraft7) {
@@ -755,20 +1819,19 @@ private:
         }
 
         if (m_version == kDraft7) {
-            if ((itr = object.find("exclusiveMaximum")) != object.end()) {
+            if ((itr = keywords[kKeywordExclusiveMaximum]) != object.end()) {
                 rootSchema.addConstraintToSubschema(
                     makeMaximumConstraintExclusive(itr->second),
                     &subschema);
             }
 
-            if ((itr = object.find("maximum")) != object.end()) {
+            if ((itr = keywords[kKeywordMaximum]) != object.end()) {
                 rootSchema.addConstraintToSubschema(
                     makeMaximumConstraint<AdapterType>(itr->second, nullptr),
                     &subschema);
             }
-        } else if ((itr = object.find("maximum")) != object.end()) {
-            typename AdapterType::Object::const_iterator exclusiveMaximumItr =
-                    object.find("exclusiveMaximum");
+        } else if ((itr = keywords[kKeywordMaximum]) != object.end()) {
+            const ObjectIterator exclusiveMaximumItr = keywords[kKeywordExclusiveMaximum];
             if (exclusiveMaximumItr == object.end()) {
                 rootSchema.addConstraintToSubschema(
                         makeMaximumConstraint<AdapterType>(itr->second, nullptr),
@@ -778,39 +1841,39 @@ private:
                         makeMaximumConstraint(itr->second, &exclusiveMaximumItr->second),
                         &subschema);
             }
-        } else if (object.find("exclusiveMaximum") != object.end()) {
+        } else if (keywords[kKeywordExclusiveMaximum] != object.end()) {
             throwRuntimeError("'exclusiveMaximum' constraint only valid if a 'maximum' "
                     "constraint is also present");
         }
 
-        if ((itr = object.find("maxItems")) != object.end()) {
+        if ((itr = keywords[kKeywordMaxItems]) != object.end()) {
             rootSchema.addConstraintToSubschema(
                     makeMaxItemsConstraint(itr->second), &subschema);
         }
 
-        if ((itr = object.find("maxLength")) != object.end()) {
+        if ((itr = keywords[kKeywordMaxLength]) != object.end()) {
             rootSchema.addConstraintToSubschema(
                     makeMaxLengthConstraint(itr->second), &subschema);
         }
 
-        if ((itr = object.find("maxProperties")) != object.end()) {
+        if ((itr = keywords[kKeywordMaxProperties]) != object.end()) {
             rootSchema.addConstraintToSubschema(
                     makeMaxPropertiesConstraint(itr->second), &subschema);
         }
 
         if (m_version == kDraft7) {
-            if ((itr = object.find("exclusiveMinimum")) != object.end()) {
+            if ((itr = keywords[kKeywordExclusiveMinimum]) != object.end()) {
                 rootSchema.addConstraintToSubschema(
                         makeMinimumConstraintExclusive(itr->second), &subschema);
             }
 
-            if ((itr = object.find("minimum")) != object.end()) {
+            if ((itr = keywords[kKeywordMinimum]) != object.end()) {
                 rootSchema.addConstraintToSubschema(
                         makeMinimumConstraint<AdapterType>(itr->second, nullptr),
                         &subschema);
             }
-        } else if ((itr = object.find("minimum")) != object.end()) {
-            typename AdapterType::Object::const_iterator exclusiveMinimumItr = object.find("exclusiveMinimum");
+        } else if ((itr = keywords[kKeywordMinimum]) != object.end()) {
+            const ObjectIterator exclusiveMinimumItr = keywords[kKeywordExclusiveMinimum];
             if (exclusiveMinimumItr == object.end()) {
                 rootSchema.addConstraintToSubschema(
                         makeMinimumConstraint<AdapterType>(itr->second, nullptr),
@@ -820,27 +1883,27 @@ private:
                         makeMinimumConstraint<AdapterType>(itr->second, &exclusiveMinimumItr->second),
                         &subschema);
             }
-        } else if (object.find("exclusiveMinimum") != object.end()) {
+        } else if (keywords[kKeywordExclusiveMinimum] != object.end()) {
             throwRuntimeError("'exclusiveMinimum' constraint only valid if a 'minimum' "
                     "constraint is also present");
         }
 
-        if ((itr = object.find("minItems")) != object.end()) {
+        if ((itr = keywords[kKeywordMinItems]) != object.end()) {
             rootSchema.addConstraintToSubschema(
                     makeMinItemsConstraint(itr->second), &subschema);
         }
 
-        if ((itr = object.find("minLength")) != object.end()) {
+        if ((itr = keywords[kKeywordMinLength]) != object.end()) {
             rootSchema.addConstraintToSubschema(
                     makeMinLengthConstraint(itr->second), &subschema);
         }
 
-        if ((itr = object.find("minProperties")) != object.end()) {
+        if ((itr = keywords[kKeywordMinProperties]) != object.end()) {
             rootSchema.addConstraintToSubschema(
                     makeMinPropertiesConstraint(itr->second), &subschema);
         }
 
-        if ((itr = object.find("multipleOf")) != object.end()) {
+        if ((itr = keywords[kKeywordMultipleOf]) != object.end()) {
             if (m_version == kDraft3) {
                 throwRuntimeError("'multipleOf' constraint not available in draft 3");
             } else if (itr->second.maybeInteger()) {
@@ -856,21 +1919,21 @@ private:
             }
         }
 
-        if ((itr = object.find("not")) != object.end()) {
+        if ((itr = keywords[kKeywordNot]) != object.end()) {
             rootSchema.addConstraintToSubschema(
                     makeNotConstraint(rootSchema, rootNode, itr->second, updatedScope, nodePath + "/not", fetchDoc,
                             docCache, schemaCache),
                     &subschema);
         }
 
-        if ((itr = object.find("oneOf")) != object.end()) {
+        if ((itr = keywords[kKeywordOneOf]) != object.end()) {
             rootSchema.addConstraintToSubschema(
                     makeOneOfConstraint(rootSchema, rootNode, itr->second, updatedScope, nodePath + "/oneOf", fetchDoc,
                             docCache, schemaCache),
                     &subschema);
         }
 
-        if ((itr = object.find("pattern")) != object.end()) {
+        if ((itr = keywords[kKeywordPattern]) != object.end()) {
             rootSchema.addConstraintToSubschema(
                     makePatternConstraint(itr->second), &subschema);
         }
@@ -878,10 +1941,10 @@ private:
         {
             // Check for schema keywords that require the creation of a
             // PropertiesConstraint instance.
-            const typename AdapterType::Object::const_iterator
-                propertiesItr = object.find("properties"),
-                patternPropertiesItr = object.find("patternProperties"),
-                additionalPropertiesItr = object.find("additionalProperties");
+            const ObjectIterator
+                propertiesItr = keywords[kKeywordProperties],
+                patternPropertiesItr = keywords[kKeywordPatternProperties],
+                additionalPropertiesItr = keywords[kKeywordAdditionalProperties];
             if (object.end() != propertiesItr ||
                 object.end() != patternPropertiesItr ||
                 object.end() != additionalPropertiesItr) {
@@ -898,7 +1961,7 @@ private:
             }
         }
 
-        if ((itr = object.find("propertyNames")) != object.end()) {
+        if ((itr = keywords[kKeywordPropertyNames]) != object.end()) {
             if (m_version == kDraft7) {
                 rootSchema.addConstraintToSubschema(
                       makePropertyNamesConstraint(rootSchema, rootNode, itr->second, updatedScope,
@@ -909,7 +1972,7 @@ private:
             }
         }
 
-        if ((itr = object.find("required")) != object.end()) {
+        if ((itr = keywords[kKeywordRequired]) != object.end()) {
             if (m_version == kDraft3) {
                 if (parentSubschema && ownName) {
                     opt::optional<constraints::RequiredConstraint> constraint =
@@ -925,7 +1988,7 @@ private:
             }
         }
 
-        if ((itr = object.find("title")) != object.end()) {
+        if ((itr = keywords[kKeywordTitle]) != object.end()) {
             if (itr->second.maybeString()) {
                 rootSchema.setSubschemaTitle(&subschema, itr->second.asString());
             } else {
@@ -933,7 +1996,7 @@ private:
             }
         }
 
-        if ((itr = object.find("uniqueItems")) != object.end()) {
+        if ((itr = keywords[kKeywordUniqueItems]) != object.end()) {
             opt::optional<constraints::UniqueItemsConstraint> constraint = makeUniqueItemsConstraint(itr->second);
             if (constraint) {
                 rootSchema.addConstraintToSubschema(*constraint, &subschema);
@@ -941,12 +2004,16 @@ private:
         }
 
         for (const auto & constraintBuilder : constraintBuilders) {
-            if ((itr = object.find(constraintBuilder.first)) != object.end()) {
+            for (const ObjectIterator &member : customKeywords) {
+                if (member->first != constraintBuilder.first) {
+                    continue;
+                }
+
                 constraints::Constraint *constraint = nullptr;
 #if VALIJSON_USE_EXCEPTIONS
                 try {
 #endif
-                    constraint = constraintBuilder.second->make(itr->second);
+                    constraint = constraintBuilder.second->make(member->second);
                     rootSchema.addConstraintToSubschema(*constraint, &subschema);
                     delete constraint;
 #if VALIJSON_USE_EXCEPTIONS
@@ -955,17 +2022,58 @@ private:
                     throw;
                 }
 #endif
+                break;
             }
         }
     }
 
+    /**
+     * @brief  Resolve a JSON Pointer, consulting the per-parse cache
+     *
+     * On a cache hit the previously resolved node is returned without
+     * walking the document. On a miss, or when no parse-scoped cache is
+     * active, the pointer is parsed and resolved as usual, and the result
+     * is cached under the given key.
+     *
+     * @param  rootNode     node to use as root for JSON Pointer resolution
+     * @param  jsonPointer  string containing complete JSON Pointer
+     * @param  cacheKey     string identifying the document and pointer,
+     *                      unique among the keys used within one parse
+     *
+     * @return  an instance of AdapterType that wraps the referenced node
+     */
+    template<typename AdapterType>
+    AdapterType resolveJsonPointerCached(
+        const AdapterType &rootNode,
+        const std::string &jsonPointer,
+        const std::string &cacheKey)
+    {
+        typedef typename PointerCache<AdapterType>::Type Cache;
+
+        if (m_pointerCache == nullptr) {
+            return internal::json_pointer::ParsedJsonPointer(
+                    jsonPointer).resolve(rootNode);
+        }
+
+        Cache &cache = *static_cast<Cache *>(m_pointerCache);
+        const typename Cache::const_iterator itr = cache.find(cacheKey);
+        if (itr != cache.end()) {
+            return itr->second;
+        }
+
+        const AdapterType resolved = internal::json_pointer::ParsedJsonPointer(
+                jsonPointer).resolve(rootNode);
+        cache.insert(typename Cache::value_type(cacheKey, resolved));
+        return resolved;
+    }
+
     /**
      * @brief  Resolves a chain of JSON References before populating a schema
      *
      * This helper function is used directly by the publicly visible
      * populateSchema function. It ensures that the node being parsed is a
-     * concrete node, and not a JSON Reference. This function will call itself
-     * recursively to resolve references until a concrete node is found.
+     * concrete node, and not a JSON Reference, following chains of references
+     * iteratively until a concrete node is found.
      *
      * @param  rootSchema    The Schema instance, and root subschema, through
      *                       which other subschemas can be created and modified
@@ -998,56 +2106,84 @@ private:
         typename DocumentCache<AdapterType>::Type &docCache,
         SchemaCache &schemaCache)
     {
+        // Adapters for the nodes visited while following a chain of JSON
+        // References; a deque preserves the addresses of its elements as it
+        // grows, so the 'current' pointers below remain valid
+        std::deque<AdapterType> visitedNodes;
+
+        const AdapterType *currentRootNode = &rootNode;
+        const AdapterType *currentNode = &node;
+        opt::optional<std::string> scope = currentScope;
+        std::string currentNodePath = nodePath;
+
+        // Identifies the document that currentRootNode belongs to, for the
+        // pointer resolution cache; the empty string denotes the document
+        // that this parse started from
+        std::string currentDocKey;
+
+        // References visited while following the chain, used to detect
+        // degenerate circular references
+        std::set<std::string> visitedRefs;
+
+        // Resolve references iteratively, until a concrete node is found
         std::string jsonRef;
-        if (!extractJsonReference(node, jsonRef)) {
-            populateSchema(rootSchema, rootNode, node, subschema, currentScope, nodePath, fetchDoc, parentSchema,
-                    ownName, docCache, schemaCache);
-            return;
-        }
+        while (extractJsonReference(*currentNode, jsonRef)) {
 
-        // Returns a document URI if the reference points somewhere
-        // other than the current document
-        const opt::optional<std::string> documentUri = internal::json_reference::getJsonReferenceUri(jsonRef);
+            // Returns a document URI if the reference points somewhere
+            // other than the current document
+            const opt::optional<std::string> documentUri =
+                    internal::json_reference::getJsonReferenceUri(jsonRef);
 
-        // Extract JSON Pointer from JSON Reference
-        const std::string actualJsonPointer = sanitiseJsonPointer(
-                internal::json_reference::getJsonReferencePointer(jsonRef));
+            // Extract JSON Pointer from JSON Reference
+            const std::string actualJsonPointer = sanitiseJsonPointer(
+                    internal::json_reference::getJsonReferencePointer(jsonRef));
 
-        if (documentUri && (internal::uri::isUriAbsolute(*documentUri) || internal::uri::isUrn(*documentUri))) {
-            // Resolve reference against remote document
-            if (!fetchDoc) {
-                throwRuntimeError("Fetching of remote JSON References not enabled.");
+            const std::string refKey =
+                    (documentUri ? *documentUri : std::string()) + "#" + actualJsonPointer;
+            if (!visitedRefs.insert(refKey).second) {
+                throwRuntimeError("Circular JSON Reference detected while parsing " + refKey);
             }
 
-            const typename DocumentCache<AdapterType>::DocumentType *newDoc = fetchDoc(*documentUri);
+            if (documentUri && (internal::uri::isUriAbsolute(*documentUri) || internal::uri::isUrn(*documentUri))) {
+                // Resolve reference against remote document
+                if (!fetchDoc) {
+                    throwRuntimeError("Fetching of remote JSON References not enabled.");
+                }
 
-            // Can't proceed without the remote document
-            if (!newDoc) {
-                throwRuntimeError("Failed to fetch referenced schema document: " + *documentUri);
-            }
+                const typename DocumentCache<AdapterType>::DocumentType *newDoc = fetchDoc(*documentUri);
 
-            // Add to document cache
-            typedef typename DocumentCache<AdapterType>::Type::value_type DocCacheValueType;
+                // Can't proceed without the remote document
+                if (!newDoc) {
+                    throwRuntimeError("Failed to fetch referenced schema document: " + *documentUri);
+                }
 
-            docCache.insert(DocCacheValueType(*documentUri, newDoc));
+                // Add to document cache
+                typedef typename DocumentCache<AdapterType>::Type::value_type DocCacheValueType;
 
-            const AdapterType newRootNode(*newDoc);
+                docCache.insert(DocCacheValueType(*documentUri, newDoc));
 
-            const AdapterType &referencedAdapter =
-                internal::json_pointer::resolveJsonPointer(newRootNode, actualJsonPointer);
+                visitedNodes.push_back(AdapterType(*newDoc));
+                currentRootNode = &visitedNodes.back();
+                currentDocKey = *documentUri;
 
-            // TODO: Need to detect degenerate circular references
-            resolveThenPopulateSchema(rootSchema, newRootNode, referencedAdapter, subschema, {}, actualJsonPointer,
-                    fetchDoc, parentSchema, ownName, docCache, schemaCache);
+                visitedNodes.push_back(resolveJsonPointerCached(
+                        *currentRootNode, actualJsonPointer,
+                        currentDocKey + "#" + actualJsonPointer));
+                currentNode = &visitedNodes.back();
 
-        } else {
-            const AdapterType &referencedAdapter =
-                    internal::json_pointer::resolveJsonPointer(rootNode, actualJsonPointer);
+            } else {
+                visitedNodes.push_back(resolveJsonPointerCached(
+                        *currentRootNode, actualJsonPointer,
+                        currentDocKey + "#" + actualJsonPointer));
+                currentNode = &visitedNodes.back();
+            }
 
-            // TODO: Need to detect degenerate circular references
-            resolveThenPopulateSchema(rootSchema, rootNode, referencedAdapter, subschema, {}, actualJsonPointer,
-                    fetchDoc, parentSchema, ownName, docCache, schemaCache);
+            scope = opt::optional<std::string>();
+            currentNodePath = actualJsonPointer;
         }
+
+        populateSchema(rootSchema, *currentRootNode, *currentNode, subschema, scope, currentNodePath, fetchDoc,
+                parentSchema, ownName, docCache, schemaCache);
     }
 
     /**
@@ -1249,6 +2385,10 @@ private:
      * @param   contains             Optional pointer to a JSON node containing
      *                               an object mapping property names to
      *                               schemas.
+     * @param   minContains          Optional pointer to a JSON node containing
+     *                               the minimum number of matching values
+     * @param   maxContains          Optional pointer to a JSON node containing
+     *                               the maximum number of matching values
      * @param   currentScope         URI for current resolution scope
      * @param   containsPath         JSON Pointer representing the path to
      *                               the 'contains' node
@@ -1265,6 +2405,8 @@ private:
         Schema &rootSchema,
         const AdapterType &rootNode,
         const AdapterType &contains,
+        const AdapterType *minContains,
+        const AdapterType *maxContains,
         const opt::optional<std::string> currentScope,
         const std::string &containsPath,
         const typename FunctionPtrs<AdapterType>::FetchDoc fetchDoc,
@@ -1273,6 +2415,24 @@ private:
     {
         constraints::ContainsConstraint constraint;
 
+        if (minContains != nullptr) {
+            if (!minContains->maybeInteger() || minContains->asInteger() < 0) {
+                throwRuntimeError("Expected a non-negative integer value for "
+                        "'minContains' constraint.");
+            }
+            constraint.setMinContains(
+                    static_cast<uint64_t>(minContains->asInteger()));
+        }
+
+        if (maxContains != nullptr) {
+            if (!maxContains->maybeInteger() || maxContains->asInteger() < 0) {
+                throwRuntimeError("Expected a non-negative integer value for "
+                        "'maxContains' constraint.");
+            }
+            constraint.setMaxContains(
+                    static_cast<uint64_t>(maxContains->asInteger()));
+        }
+
         if (contains.isObject() || (m_version == kDraft7 && contains.maybeBool())) {
             const Subschema *subschema = makeOrReuseSchema<AdapterType>(
                     rootSchema, rootNode, contains, currentScope, containsPath,
@@ -1636,6 +2796,9 @@ private:
 
         constraints::MaximumConstraint constraint;
         constraint.setMaximum(node.asDouble());
+        if (node.isInteger()) {
+            constraint.setIntegerMaximum(node.asInteger());
+        }
 
         if (exclusiveMaximum) {
             if (!exclusiveMaximum->maybeBool()) {
@@ -1664,6 +2827,9 @@ private:
 
         constraints::MaximumConstraint constraint;
         constraint.setMaximum(node.asDouble());
+        if (node.isInteger()) {
+            constraint.setIntegerMaximum(node.asInteger());
+        }
         constraint.setExclusiveMaximum(true);
         return constraint;
     }
@@ -1765,6 +2931,9 @@ private:
 
         constraints::MinimumConstraint constraint;
         constraint.setMinimum(node.asDouble());
+        if (node.isInteger()) {
+            constraint.setIntegerMinimum(node.asInteger());
+        }
 
         if (exclusiveMinimum) {
             if (!exclusiveMinimum->maybeBool()) {
@@ -1793,6 +2962,9 @@ private:
 
         constraints::MinimumConstraint constraint;
         constraint.setMinimum(node.asDouble());
+        if (node.isInteger()) {
+            constraint.setIntegerMinimum(node.asInteger());
+        }
         constraint.setExclusiveMinimum(true);
         return constraint;
     }
@@ -2302,6 +3474,38 @@ private:
 
     /// Version of JSON Schema that should be expected when parsing
     Version m_version;
+
+    /// Worklist of deferred schema population tasks for the parse that is
+    /// currently in progress; points to a deque owned by the outermost
+    /// populateSchema call, or nullptr when no parse is in progress. Use of
+    /// this member means that a single SchemaParser instance must not be
+    /// used to parse multiple schemas concurrently.
+    PopulateWorklist *m_populateWorklist;
+
+    /// Cache mapping structural fingerprints to populated subschemas for
+    /// the parse that is currently in progress, used to share one Subschema
+    /// between identical inline subschemas; points to a map owned by the
+    /// outermost populateSchema call, or nullptr when no parse is in
+    /// progress
+    SchemaCache *m_structuralCache;
+
+    /// Cross-parse cache of sub-schemas keyed by document URI and JSON
+    /// Pointer; points to a map owned by the caller of the registry
+    /// overload of populateSchema, or nullptr when parses are independent
+    SchemaCache *m_sharedSchemaCache;
+
+    /// Cross-parse cache of sub-schemas keyed by structural fingerprint,
+    /// installed alongside m_sharedSchemaCache in place of the per-parse
+    /// structural cache
+    SchemaCache *m_sharedStructuralCache;
+
+    /// Cache of nodes resolved from JSON Pointers for the parse that is
+    /// currently in progress; points to a PointerCache owned by the
+    /// outermost populateSchema call, or nullptr when no parse is in
+    /// progress. Stored as an untyped pointer because the cache holds
+    /// adapters of the document type being parsed; it is only accessed from
+    /// contexts where that type is known.
+    void *m_pointerCache;
 };
 
 }  // namespace valijson
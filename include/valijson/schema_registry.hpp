@@ -0,0 +1,224 @@
+/**
+ * @file
+ *
+ * @brief   Registry that compiles many schemas against shared definitions
+ *
+ * Fleets that load hundreds of schemas, all referencing a common document
+ * of definitions, pay twice when each schema is parsed independently: the
+ * shared document is fetched and parsed per schema, and each schema gets
+ * private copies of every shared sub-schema. SchemaRegistry compiles many
+ * root schemas over a single SharedDocumentCache and a pair of schema
+ * caches that persist across parses, so each sub-schema resolved from a
+ * shared document exists exactly once and is referenced by every schema
+ * that uses it. Both warm-up time and resident memory improve by the
+ * sharing factor.
+ */
+
+#pragma once
+
+#include <deque>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <valijson/document_cache.hpp>
+#include <valijson/schema.hpp>
+#include <valijson/schema_parser.hpp>
+#include <valijson/exceptions.hpp>
+
+namespace valijson {
+
+/**
+ * @brief   Owner of a set of schemas that share resolved sub-schemas
+ *
+ * Schemas added to a registry are parsed through caches that outlive the
+ * individual parse, so sub-schemas resolved from remote documents - and
+ * structurally identical inline sub-schemas - are populated once and
+ * shared by reference. A shared sub-schema is owned by the Schema for
+ * which it was first populated, which is why the registry owns every
+ * Schema it produces: the pointers returned by addSchema() and getSchema()
+ * remain valid until the registry itself is destroyed, and no schema can
+ * outlive the sub-schemas it borrows.
+ *
+ * The registry is not thread-safe; schemas should be added from a single
+ * thread, typically at start-up. Once added, the Schema objects are
+ * immutable and may be validated against concurrently as usual.
+ *
+ * @tparam  AdapterType  Adapter type used to parse the schema documents
+ */
+template<typename AdapterType>
+class SchemaRegistry
+{
+public:
+    typedef typename SharedDocumentCache<AdapterType>::FetchDocFn FetchDocFn;
+    typedef typename SharedDocumentCache<AdapterType>::FreeDocFn FreeDocFn;
+
+    /**
+     * @brief  Construct a registry around a pair of fetch/free functions
+     *
+     * @param  fetchDoc            function used to fetch remote documents
+     * @param  freeDoc             function used to free fetched documents
+     * @param  version             version of JSON Schema to expect
+     * @param  maxCachedDocuments  number of remote documents to retain in
+     *                             the document cache, or 0 for no bound
+     */
+    SchemaRegistry(FetchDocFn fetchDoc, FreeDocFn freeDoc,
+            SchemaParser::Version version = SchemaParser::kDraft7,
+            size_t maxCachedDocuments = 0)
+      : m_parser(version),
+        m_documentCache(fetchDoc, freeDoc, maxCachedDocuments) { }
+
+    // Disable copy construction
+    SchemaRegistry(const SchemaRegistry &) = delete;
+
+    // Disable copy assignment
+    SchemaRegistry & operator=(const SchemaRegistry &) = delete;
+
+    /**
+     * @brief  Parse a schema document and add the result to the registry
+     *
+     * The schema is parsed over the registry's shared caches, so any
+     * sub-schema that resolves to the same remote target as one parsed for
+     * an earlier schema is reused rather than re-populated.
+     *
+     * @param  name  name under which the schema will be registered
+     * @param  node  reference to the root node of the schema document
+     *
+     * @throws std::runtime_error if a schema with the given name has
+     *         already been added, or if parsing fails
+     *
+     * @returns  pointer to the populated Schema, valid for the lifetime of
+     *           the registry
+     */
+    const Schema * addSchema(const std::string &name, const AdapterType &node)
+    {
+        if (m_schemasByName.find(name) != m_schemasByName.end()) {
+            throwRuntimeError(
+                    "Schema '" + name + "' has already been registered");
+        }
+
+        // A deque keeps earlier Schema objects, and therefore the shared
+        // sub-schemas they own, at stable addresses as schemas are added
+        m_schemas.emplace_back();
+        Schema &schema = m_schemas.back();
+
+#if VALIJSON_USE_EXCEPTIONS
+        try {
+#endif
+            m_parser.populateSchema(node, schema, m_documentCache,
+                    m_schemaCache, m_structuralCache);
+#if VALIJSON_USE_EXCEPTIONS
+        } catch (...) {
+            // Sub-schemas owned by the failed Schema may already have been
+            // published to the shared caches; purge them so later parses
+            // cannot reference storage that is about to be freed
+            purgeCacheEntries(schema);
+            m_schemas.pop_back();
+            throw;
+        }
+#endif
+
+        m_schemasByName.insert(typename SchemasByName::value_type(
+                name, &schema));
+
+        return &schema;
+    }
+
+    /**
+     * @brief  Return the schema registered under a given name
+     *
+     * @param  name  name the schema was registered under
+     *
+     * @returns  pointer to the Schema, or nullptr if the name is unknown
+     */
+    const Schema * getSchema(const std::string &name) const
+    {
+        const typename SchemasByName::const_iterator itr =
+                m_schemasByName.find(name);
+        return itr == m_schemasByName.end() ? nullptr : itr->second;
+    }
+
+    /**
+     * @brief  Return the number of schemas held by the registry
+     */
+    size_t numSchemas() const
+    {
+        return m_schemas.size();
+    }
+
+    /**
+     * @brief  Return the number of sub-schemas available for sharing
+     *
+     * Counts entries in the cross-parse caches; the difference between
+     * this and the total sub-schema count across all registered schemas
+     * indicates how much duplication the registry has avoided.
+     */
+    size_t numSharedSubschemas() const
+    {
+        return m_schemaCache.size() + m_structuralCache.size();
+    }
+
+    /**
+     * @brief  Return the document cache used to resolve remote references
+     *
+     * Exposed so that hit/miss counters can be inspected, and so that the
+     * cache can be pre-populated via prefetch() before schemas are added.
+     */
+    SharedDocumentCache<AdapterType> & documentCache()
+    {
+        return m_documentCache;
+    }
+
+private:
+    typedef std::map<std::string, const Schema *> SchemasByName;
+
+    /// Remove shared cache entries that point into a given Schema
+    void purgeCacheEntries(const Schema &schema)
+    {
+        purgeCacheEntries(schema, m_schemaCache);
+        purgeCacheEntries(schema, m_structuralCache);
+    }
+
+    static void purgeCacheEntries(const Schema &schema,
+            SchemaParser::SchemaCache &cache)
+    {
+        // Keys are collected first, since erasing from the flat hash map
+        // invalidates iterators
+        std::vector<std::string> doomed;
+        for (const typename SchemaParser::SchemaCache::value_type &entry : cache) {
+            bool owned = false;
+            schema.applyToSubschemas(
+                    [&entry, &owned](const Subschema &subschema) {
+                        owned = (&subschema == entry.second);
+                        return !owned;
+                    });
+            if (owned) {
+                doomed.push_back(entry.first);
+            }
+        }
+
+        for (const std::string &key : doomed) {
+            cache.erase(key);
+        }
+    }
+
+    /// Parser used for every schema added to the registry
+    SchemaParser m_parser;
+
+    /// Cache of fetched remote documents, shared across parses
+    SharedDocumentCache<AdapterType> m_documentCache;
+
+    /// Cross-parse cache of sub-schemas keyed by URI-qualified cache keys
+    SchemaParser::SchemaCache m_schemaCache;
+
+    /// Cross-parse cache of sub-schemas keyed by structural fingerprint
+    SchemaParser::SchemaCache m_structuralCache;
+
+    /// Schema objects owned by the registry, in insertion order
+    std::deque<Schema> m_schemas;
+
+    /// Index from registered name to Schema
+    SchemasByName m_schemasByName;
+};
+
+} // end namespace valijson
@@ -0,0 +1,1382 @@
+/**
+ * @file
+ *
+ * @brief   Versioned binary serialization of parsed schemas
+ *
+ * These functions convert a fully parsed Schema into a compact, versioned
+ * binary representation, and reconstruct an equivalent Schema from that
+ * representation. A schema can be parsed and serialized once, offline, and
+ * then loaded at process startup without re-running the schema parser, JSON
+ * pointer resolution, or $ref fetching. Loading is a single linear pass over
+ * the serialized bytes, which may be read from a memory-mapped file.
+ *
+ * The format stores the flattened subschema graph, with subschemas referred
+ * to by index, followed by a tagged record for each constraint. Values held
+ * by 'enum' and 'const' constraints are serializable when they are scalars,
+ * which is how both constraints store scalar values since freezing became
+ * canonical; composite enum or const values, and custom constraints derived
+ * from PolyConstraint, cannot be serialized and cause an exception to be
+ * thrown.
+ *
+ * Multi-byte integers are stored in the native byte order of the producing
+ * machine; a serialized schema is intended to be consumed by machines of the
+ * same architecture, and the magic number guards against obvious mismatches.
+ * The reader is not hardened against adversarial input, but every count and
+ * length field is checked against the bytes remaining in the buffer before
+ * it drives an allocation or a loop, so a truncated or corrupted buffer -
+ * such as an on-disk cache entry damaged by a crash - fails with an
+ * exception rather than consuming unbounded CPU or memory.
+ *
+ * The representation is position-independent: subschemas are referred to by
+ * index and the encoding contains no pointers, so a single process can
+ * serialize directly into a shared memory segment (or a file that workers
+ * memory-map) and every process on the host can read the same physical
+ * pages. Each consumer still reconstructs its own Schema, since the live
+ * Schema holds process-local heap pointers and vtables; workers that need
+ * to share the reconstructed objects themselves should load once and fork.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <valijson/adapters/scalar_value_adapter.hpp>
+#include <valijson/constraints/concrete_constraints.hpp>
+#include <valijson/constraints/constraint_visitor.hpp>
+#include <valijson/exceptions.hpp>
+#include <valijson/internal/frozen_value_pool.hpp>
+#include <valijson/schema.hpp>
+
+namespace valijson {
+namespace internal {
+
+/// Magic bytes placed at the start of a serialized schema
+static const char kMagicBytes[4] = { 'V', 'J', 'S', 'B' };
+
+/**
+ * @brief  Destination that serialized bytes are written to
+ *
+ * Abstracting the output allows the same writer to append to a growable
+ * vector, write directly into caller-provided memory such as a shared
+ * memory segment, or merely measure the encoded size.
+ */
+class ByteSink
+{
+public:
+    virtual ~ByteSink() = default;
+
+    virtual void write(const char *data, size_t size) = 0;
+};
+
+/// Sink that appends serialized bytes to a vector
+class VectorByteSink: public ByteSink
+{
+public:
+    explicit VectorByteSink(std::vector<char> &output)
+      : m_output(output) { }
+
+    void write(const char *data, size_t size) override
+    {
+        m_output.insert(m_output.end(), data, data + size);
+    }
+
+private:
+    std::vector<char> &m_output;
+};
+
+/// Sink that writes serialized bytes into a fixed-capacity buffer
+class BufferByteSink: public ByteSink
+{
+public:
+    BufferByteSink(char *buffer, size_t capacity)
+      : m_buffer(buffer),
+        m_capacity(capacity),
+        m_size(0) { }
+
+    void write(const char *data, size_t size) override
+    {
+        if (size > m_capacity - m_size) {
+            throwRuntimeError("Serialized schema does not fit in the "
+                    "provided buffer");
+        }
+
+        memcpy(m_buffer + m_size, data, size);
+        m_size += size;
+    }
+
+    size_t size() const
+    {
+        return m_size;
+    }
+
+private:
+    char * const m_buffer;
+    const size_t m_capacity;
+    size_t m_size;
+};
+
+/// Sink that discards serialized bytes but records their total size
+class CountingByteSink: public ByteSink
+{
+public:
+    CountingByteSink()
+      : m_size(0) { }
+
+    void write(const char *, size_t size) override
+    {
+        m_size += size;
+    }
+
+    size_t size() const
+    {
+        return m_size;
+    }
+
+private:
+    size_t m_size;
+};
+
+/**
+ * @brief  Serializes a Schema into a flat byte buffer
+ */
+class BinarySchemaWriter
+{
+public:
+    BinarySchemaWriter(const Schema &schema, ByteSink &sink)
+      : m_schema(schema),
+        m_sink(sink) { }
+
+    void write()
+    {
+        collectSubschemas();
+
+        appendBytes(kMagicBytes, 4);
+        append<uint32_t>(kVersion);
+        append<uint32_t>(static_cast<uint32_t>(m_subschemas.size()));
+
+        for (const Subschema *subschema : m_subschemas) {
+            writeSubschema(*subschema);
+        }
+    }
+
+    static const uint32_t kVersion = 2;
+    static const uint32_t kNullIndex = 0xffffffffu;
+
+    // Reserved index that refers to the schema's shared empty sub-schema,
+    // which lives outside the sub-schema set; constraints refer to it where
+    // a sub-schema keyword takes its permissive default - e.g. 'properties'
+    // uses it as the default 'additionalProperties' sub-schema
+    static const uint32_t kEmptyIndex = 0xfffffffeu;
+
+    // Stable constraint record tags; these are part of the serialized format
+    // and must not be renumbered
+    enum ConstraintTag
+    {
+        kAllOf = 1,
+        kAnyOf = 2,
+        kConditional = 3,
+        kConst = 4,
+        kContains = 5,
+        kDependencies = 6,
+        kEnum = 7,
+        kFormat = 8,
+        kLinearItems = 9,
+        kMaximum = 10,
+        kMaxItems = 11,
+        kMaxLength = 12,
+        kMaxProperties = 13,
+        kMinimum = 14,
+        kMinItems = 15,
+        kMinLength = 16,
+        kMinProperties = 17,
+        kMultipleOfDouble = 18,
+        kMultipleOfInt = 19,
+        kNot = 20,
+        kOneOf = 21,
+        kPattern = 22,
+        kProperties = 23,
+        kPropertyNames = 24,
+        kRequired = 25,
+        kSingularItems = 26,
+        kType = 27,
+        kUniqueItems = 28
+    };
+
+    // Stable scalar value tags
+    enum ScalarTag
+    {
+        kScalarNull = 0,
+        kScalarBool = 1,
+        kScalarInteger = 2,
+        kScalarDouble = 3,
+        kScalarString = 4
+    };
+
+private:
+    friend class SerializeConstraints;
+
+    /**
+     * @brief  Constraint visitor that appends one tagged record per
+     *         constraint to the output buffer
+     */
+    class SerializeConstraints: public constraints::ConstraintVisitor
+    {
+    public:
+        explicit SerializeConstraints(BinarySchemaWriter &writer)
+          : m_writer(writer) { }
+
+        bool visit(const AllOfConstraint &constraint) override
+        {
+            m_writer.append<uint8_t>(kAllOf);
+            writeSubschemaCollection(constraint);
+            return true;
+        }
+
+        bool visit(const AnyOfConstraint &constraint) override
+        {
+            m_writer.append<uint8_t>(kAnyOf);
+            writeSubschemaCollection(constraint);
+            return true;
+        }
+
+        bool visit(const ConditionalConstraint &constraint) override
+        {
+            m_writer.append<uint8_t>(kConditional);
+            m_writer.appendSubschema(constraint.getIfSubschema());
+            m_writer.appendSubschema(constraint.getThenSubschema());
+            m_writer.appendSubschema(constraint.getElseSubschema());
+            return true;
+        }
+
+        bool visit(const ConstConstraint &constraint) override
+        {
+            m_writer.append<uint8_t>(kConst);
+            m_writer.appendFrozenScalar(*constraint.getValue());
+            return true;
+        }
+
+        bool visit(const ContainsConstraint &constraint) override
+        {
+            m_writer.append<uint8_t>(kContains);
+            m_writer.appendSubschema(constraint.getSubschema());
+            m_writer.append<uint64_t>(constraint.getMinContains());
+            m_writer.append<uint64_t>(constraint.getMaxContains());
+            return true;
+        }
+
+        bool visit(const DependenciesConstraint &constraint) override
+        {
+            m_writer.append<uint8_t>(kDependencies);
+
+            size_t numPropertyDependencies = 0;
+            constraint.applyToPropertyDependencies(
+                    CountPairs(&numPropertyDependencies));
+            m_writer.append<uint32_t>(
+                    static_cast<uint32_t>(numPropertyDependencies));
+            constraint.applyToPropertyDependencies(
+                    WritePropertyDependencies(m_writer));
+
+            size_t numSchemaDependencies = 0;
+            constraint.applyToSchemaDependencies(
+                    CountPairs(&numSchemaDependencies));
+            m_writer.append<uint32_t>(
+                    static_cast<uint32_t>(numSchemaDependencies));
+            constraint.applyToSchemaDependencies(WriteSchemaDependencies(m_writer));
+
+            return true;
+        }
+
+        bool visit(const EnumConstraint &constraint) override
+        {
+            m_writer.append<uint8_t>(kEnum);
+
+            size_t numValues = 0;
+            constraint.applyToValues(
+                    [&numValues](const adapters::FrozenValue &) {
+                        numValues++;
+                        return true;
+                    });
+            m_writer.append<uint32_t>(static_cast<uint32_t>(numValues));
+
+            constraint.applyToValues(
+                    [this](const adapters::FrozenValue &value) {
+                        m_writer.appendFrozenScalar(value);
+                        return true;
+                    });
+            return true;
+        }
+
+        bool visit(const FormatConstraint &constraint) override
+        {
+            m_writer.append<uint8_t>(kFormat);
+            m_writer.appendString(constraint.getFormat());
+            return true;
+        }
+
+        bool visit(const FusedObjectConstraint &constraint) override
+        {
+            // A fused constraint is serialized as the records of its parts,
+            // so the format is unaffected by fusion and a deserialized
+            // schema can be re-fused with fuseObjectConstraints();
+            // writeSubschema() counts the parts rather than the fused
+            // constraint when framing the record count
+            if (constraint.hasProperties()) {
+                visit(constraint.getProperties());
+            }
+            if (constraint.hasPropertyNames()) {
+                visit(constraint.getPropertyNames());
+            }
+            if (constraint.hasRequired()) {
+                visit(constraint.getRequired());
+            }
+            if (constraint.hasMinProperties()) {
+                visit(constraint.getMinProperties());
+            }
+            if (constraint.hasMaxProperties()) {
+                visit(constraint.getMaxProperties());
+            }
+            return true;
+        }
+
+        bool visit(const LinearItemsConstraint &constraint) override
+        {
+            m_writer.append<uint8_t>(kLinearItems);
+            m_writer.append<uint32_t>(
+                    static_cast<uint32_t>(constraint.getItemSubschemaCount()));
+            constraint.applyToItemSubschemas(
+                    [this](unsigned int, const Subschema *subschema) {
+                        m_writer.appendSubschema(subschema);
+                        return true;
+                    });
+            m_writer.appendSubschema(constraint.getAdditionalItemsSubschema());
+            return true;
+        }
+
+        bool visit(const MaximumConstraint &constraint) override
+        {
+            m_writer.append<uint8_t>(kMaximum);
+            m_writer.append<double>(constraint.getMaximum());
+            m_writer.append<uint8_t>(constraint.getExclusiveMaximum() ? 1 : 0);
+            m_writer.append<uint8_t>(constraint.hasIntegerMaximum() ? 1 : 0);
+            if (constraint.hasIntegerMaximum()) {
+                m_writer.append<int64_t>(constraint.getIntegerMaximum());
+            }
+            return true;
+        }
+
+        bool visit(const MaxItemsConstraint &constraint) override
+        {
+            m_writer.append<uint8_t>(kMaxItems);
+            m_writer.append<uint64_t>(constraint.getMaxItems());
+            return true;
+        }
+
+        bool visit(const MaxLengthConstraint &constraint) override
+        {
+            m_writer.append<uint8_t>(kMaxLength);
+            m_writer.append<uint64_t>(constraint.getMaxLength());
+            return true;
+        }
+
+        bool visit(const MaxPropertiesConstraint &constraint) override
+        {
+            m_writer.append<uint8_t>(kMaxProperties);
+            m_writer.append<uint64_t>(constraint.getMaxProperties());
+            return true;
+        }
+
+        bool visit(const MinimumConstraint &constraint) override
+        {
+            m_writer.append<uint8_t>(kMinimum);
+            m_writer.append<double>(constraint.getMinimum());
+            m_writer.append<uint8_t>(constraint.getExclusiveMinimum() ? 1 : 0);
+            m_writer.append<uint8_t>(constraint.hasIntegerMinimum() ? 1 : 0);
+            if (constraint.hasIntegerMinimum()) {
+                m_writer.append<int64_t>(constraint.getIntegerMinimum());
+            }
+            return true;
+        }
+
+        bool visit(const MinItemsConstraint &constraint) override
+        {
+            m_writer.append<uint8_t>(kMinItems);
+            m_writer.append<uint64_t>(constraint.getMinItems());
+            return true;
+        }
+
+        bool visit(const MinLengthConstraint &constraint) override
+        {
+            m_writer.append<uint8_t>(kMinLength);
+            m_writer.append<uint64_t>(constraint.getMinLength());
+            return true;
+        }
+
+        bool visit(const MinPropertiesConstraint &constraint) override
+        {
+            m_writer.append<uint8_t>(kMinProperties);
+            m_writer.append<uint64_t>(constraint.getMinProperties());
+            return true;
+        }
+
+        bool visit(const MultipleOfDoubleConstraint &constraint) override
+        {
+            m_writer.append<uint8_t>(kMultipleOfDouble);
+            m_writer.append<double>(constraint.getDivisor());
+            return true;
+        }
+
+        bool visit(const MultipleOfIntConstraint &constraint) override
+        {
+            m_writer.append<uint8_t>(kMultipleOfInt);
+            m_writer.append<int64_t>(constraint.getDivisor());
+            return true;
+        }
+
+        bool visit(const NotConstraint &constraint) override
+        {
+            m_writer.append<uint8_t>(kNot);
+            m_writer.appendSubschema(constraint.getSubschema());
+            return true;
+        }
+
+        bool visit(const OneOfConstraint &constraint) override
+        {
+            m_writer.append<uint8_t>(kOneOf);
+            writeSubschemaCollection(constraint);
+            return true;
+        }
+
+        bool visit(const PatternConstraint &constraint) override
+        {
+            m_writer.append<uint8_t>(kPattern);
+            m_writer.appendString(
+                    constraint.getPattern(std::allocator<char>()));
+            return true;
+        }
+
+        VALIJSON_NORETURN bool visit(const constraints::PolyConstraint &) override
+        {
+            throwRuntimeError("Cannot serialize a custom constraint derived "
+                    "from PolyConstraint");
+        }
+
+        bool visit(const PropertiesConstraint &constraint) override
+        {
+            typedef constraints::PropertiesConstraint::String String;
+
+            m_writer.append<uint8_t>(kProperties);
+
+            size_t numProperties = 0;
+            constraint.applyToProperties(CountPairs(&numProperties));
+            m_writer.append<uint32_t>(static_cast<uint32_t>(numProperties));
+            constraint.applyToProperties(
+                    [this](const String &name, const Subschema *subschema) {
+                        m_writer.appendString(name.c_str());
+                        m_writer.appendSubschema(subschema);
+                        return true;
+                    });
+
+            size_t numPatternProperties = 0;
+            constraint.applyToPatternProperties(CountPairs(&numPatternProperties));
+            m_writer.append<uint32_t>(
+                    static_cast<uint32_t>(numPatternProperties));
+            constraint.applyToPatternProperties(
+                    [this](const String &pattern, const Subschema *subschema) {
+                        m_writer.appendString(pattern.c_str());
+                        m_writer.appendSubschema(subschema);
+                        return true;
+                    });
+
+            m_writer.appendSubschema(
+                    constraint.getAdditionalPropertiesSubschema());
+            return true;
+        }
+
+        bool visit(const PropertyNamesConstraint &constraint) override
+        {
+            m_writer.append<uint8_t>(kPropertyNames);
+            m_writer.appendSubschema(constraint.getSubschema());
+            return true;
+        }
+
+        bool visit(const RequiredConstraint &constraint) override
+        {
+            typedef constraints::RequiredConstraint::String String;
+
+            m_writer.append<uint8_t>(kRequired);
+
+            size_t numProperties = 0;
+            constraint.applyToRequiredProperties(
+                    [&numProperties](const String &) {
+                        numProperties++;
+                        return true;
+                    });
+            m_writer.append<uint32_t>(static_cast<uint32_t>(numProperties));
+
+            constraint.applyToRequiredProperties(
+                    [this](const String &name) {
+                        m_writer.appendString(name.c_str());
+                        return true;
+                    });
+            return true;
+        }
+
+        bool visit(const SingularItemsConstraint &constraint) override
+        {
+            m_writer.append<uint8_t>(kSingularItems);
+            m_writer.appendSubschema(constraint.getItemsSubschema());
+            return true;
+        }
+
+        bool visit(const TypeConstraint &constraint) override
+        {
+            m_writer.append<uint8_t>(kType);
+
+            size_t numNamedTypes = 0;
+            constraint.applyToNamedTypes(
+                    [&numNamedTypes](TypeConstraint::JsonType) {
+                        numNamedTypes++;
+                        return true;
+                    });
+            m_writer.append<uint32_t>(static_cast<uint32_t>(numNamedTypes));
+            constraint.applyToNamedTypes(
+                    [this](TypeConstraint::JsonType jsonType) {
+                        m_writer.append<uint8_t>(encodeJsonType(jsonType));
+                        return true;
+                    });
+
+            size_t numSchemaTypes = 0;
+            constraint.applyToSchemaTypes(CountPairs(&numSchemaTypes));
+            m_writer.append<uint32_t>(static_cast<uint32_t>(numSchemaTypes));
+            constraint.applyToSchemaTypes(
+                    [this](unsigned int, const Subschema *subschema) {
+                        m_writer.appendSubschema(subschema);
+                        return true;
+                    });
+            return true;
+        }
+
+        bool visit(const UniqueItemsConstraint &) override
+        {
+            m_writer.append<uint8_t>(kUniqueItems);
+            return true;
+        }
+
+    private:
+        /// Functor to count the entries passed to an applyTo... function
+        struct CountPairs
+        {
+            explicit CountPairs(size_t *count)
+              : m_count(count) { }
+
+            template<typename... Args>
+            bool operator()(const Args &...) const
+            {
+                (*m_count)++;
+                return true;
+            }
+
+        private:
+            size_t * const m_count;
+        };
+
+        /// Functor to write property-based dependencies, whose container
+        /// type is private to DependenciesConstraint
+        struct WritePropertyDependencies
+        {
+            explicit WritePropertyDependencies(BinarySchemaWriter &writer)
+              : m_writer(writer) { }
+
+            template<typename StringType, typename ContainerType>
+            bool operator()(const StringType &propertyName,
+                    const ContainerType &dependencyNames) const
+            {
+                m_writer.appendString(propertyName.c_str());
+                m_writer.append<uint32_t>(
+                        static_cast<uint32_t>(dependencyNames.size()));
+                for (const auto &dependencyName : dependencyNames) {
+                    m_writer.appendString(dependencyName.c_str());
+                }
+                return true;
+            }
+
+        private:
+            BinarySchemaWriter &m_writer;
+        };
+
+        /// Functor to write schema-based dependencies
+        struct WriteSchemaDependencies
+        {
+            explicit WriteSchemaDependencies(BinarySchemaWriter &writer)
+              : m_writer(writer) { }
+
+            template<typename StringType>
+            bool operator()(const StringType &propertyName,
+                    const Subschema *subschema) const
+            {
+                m_writer.appendString(propertyName.c_str());
+                m_writer.appendSubschema(subschema);
+                return true;
+            }
+
+        private:
+            BinarySchemaWriter &m_writer;
+        };
+
+        template<typename ConstraintType>
+        void writeSubschemaCollection(const ConstraintType &constraint)
+        {
+            size_t numSubschemas = 0;
+            constraint.applyToSubschemas(CountPairs(&numSubschemas));
+            m_writer.append<uint32_t>(static_cast<uint32_t>(numSubschemas));
+            constraint.applyToSubschemas(
+                    [this](unsigned int, const Subschema *subschema) {
+                        m_writer.appendSubschema(subschema);
+                        return true;
+                    });
+        }
+
+        static uint8_t encodeJsonType(constraints::TypeConstraint::JsonType jsonType)
+        {
+            typedef constraints::TypeConstraint TypeConstraint;
+
+            switch (jsonType) {
+            case TypeConstraint::kAny:
+                return 0;
+            case TypeConstraint::kArray:
+                return 1;
+            case TypeConstraint::kBoolean:
+                return 2;
+            case TypeConstraint::kInteger:
+                return 3;
+            case TypeConstraint::kNull:
+                return 4;
+            case TypeConstraint::kNumber:
+                return 5;
+            case TypeConstraint::kObject:
+                return 6;
+            case TypeConstraint::kString:
+                return 7;
+            }
+
+            throwRuntimeError("Unrecognised JSON type");
+        }
+
+        BinarySchemaWriter &m_writer;
+    };
+
+    void collectSubschemas()
+    {
+        m_schema.applyToSubschemas([this](const Subschema &subschema) {
+            if (m_subschemaIndices.insert(std::make_pair(&subschema,
+                    static_cast<uint32_t>(m_subschemas.size()))).second) {
+                m_subschemas.push_back(&subschema);
+            }
+            return true;
+        });
+    }
+
+    void writeSubschema(const Subschema &subschema)
+    {
+        uint8_t flags = 0;
+        if (subschema.getAlwaysInvalid()) {
+            flags |= 1u;
+        }
+        if (subschema.hasTitle()) {
+            flags |= 2u;
+        }
+        if (subschema.hasDescription()) {
+            flags |= 4u;
+        }
+        if (subschema.hasId()) {
+            flags |= 8u;
+        }
+        append<uint8_t>(flags);
+
+        if (subschema.hasTitle()) {
+            appendString(subschema.getTitle());
+        }
+        if (subschema.hasDescription()) {
+            appendString(subschema.getDescription());
+        }
+        if (subschema.hasId()) {
+            appendString(subschema.getId());
+        }
+
+        size_t numConstraints = 0;
+        subschema.forEachConstraint(
+                [&numConstraints](const constraints::Constraint &constraint) {
+                    // A fused object constraint is written as one record per
+                    // fused part; this is a cold path, so the cost of
+                    // dynamic_cast is acceptable here
+                    if (const auto *fused = dynamic_cast<
+                            const constraints::FusedObjectConstraint *>(&constraint)) {
+                        numConstraints += fused->numParts();
+                    } else {
+                        numConstraints++;
+                    }
+                    return true;
+                });
+        append<uint32_t>(static_cast<uint32_t>(numConstraints));
+
+        SerializeConstraints serializer(*this);
+        subschema.forEachConstraint(
+                [&serializer](const constraints::Constraint &constraint) {
+                    constraint.accept(serializer);
+                    return true;
+                });
+    }
+
+    template<typename IntType>
+    void append(IntType value)
+    {
+        const char *bytes = reinterpret_cast<const char *>(&value);
+        m_sink.write(bytes, sizeof(value));
+    }
+
+    void appendBytes(const char *data, size_t size)
+    {
+        m_sink.write(data, size);
+    }
+
+    void appendString(const std::string &value)
+    {
+        append<uint32_t>(static_cast<uint32_t>(value.size()));
+        appendBytes(value.data(), value.size());
+    }
+
+    void appendSubschema(const Subschema *subschema)
+    {
+        if (subschema == nullptr) {
+            append<uint32_t>(kNullIndex);
+            return;
+        }
+
+        if (subschema == m_schema.emptySubschema()) {
+            append<uint32_t>(kEmptyIndex);
+            return;
+        }
+
+        const auto itr = m_subschemaIndices.find(subschema);
+        if (itr == m_subschemaIndices.end()) {
+            throwRuntimeError("Cannot serialize a schema that refers to "
+                    "subschemas owned by another schema");
+        }
+
+        append<uint32_t>(itr->second);
+    }
+
+    void appendFrozenScalar(const adapters::FrozenValue &value)
+    {
+        // Pooled values are handed out through sharing wrappers; serialize
+        // the underlying instance. This is a cold path that is run once per
+        // value, so the cost of dynamic_cast is acceptable here
+        const adapters::FrozenValue *target = &value;
+        if (const auto *shared =
+                dynamic_cast<const adapters::SharedFrozenValue *>(target)) {
+            target = &shared->underlying();
+        }
+
+        const auto *frozen =
+                dynamic_cast<const adapters::ScalarValueFrozenValue *>(target);
+        if (frozen == nullptr) {
+            throwRuntimeError("Cannot serialize an enum or const value that "
+                    "is not a scalar");
+        }
+
+        const adapters::ScalarValue &scalar = frozen->getValue();
+        switch (scalar.type) {
+        case adapters::ScalarValue::kNull:
+            append<uint8_t>(kScalarNull);
+            break;
+        case adapters::ScalarValue::kBool:
+            append<uint8_t>(kScalarBool);
+            append<uint8_t>(scalar.boolValue ? 1 : 0);
+            break;
+        case adapters::ScalarValue::kInteger:
+            append<uint8_t>(kScalarInteger);
+            append<int64_t>(scalar.integerValue);
+            break;
+        case adapters::ScalarValue::kDouble:
+            append<uint8_t>(kScalarDouble);
+            append<double>(scalar.doubleValue);
+            break;
+        case adapters::ScalarValue::kString:
+            append<uint8_t>(kScalarString);
+            appendString(scalar.stringValue);
+            break;
+        }
+    }
+
+    const Schema &m_schema;
+    ByteSink &m_sink;
+    std::vector<const Subschema *> m_subschemas;
+    std::map<const Subschema *, uint32_t> m_subschemaIndices;
+};
+
+/**
+ * @brief  Reconstructs a Schema from its binary serialized form
+ */
+class BinarySchemaReader
+{
+public:
+    BinarySchemaReader(const char *data, size_t size, Schema &schema)
+      : m_data(data),
+        m_size(size),
+        m_offset(0),
+        m_schema(schema) { }
+
+    void read()
+    {
+        char magic[4];
+        readBytes(magic, 4);
+        if (memcmp(magic, kMagicBytes, 4) != 0) {
+            throwRuntimeError("Serialized schema has an unrecognised header");
+        }
+
+        const uint32_t version = readValue<uint32_t>();
+        if (version != BinarySchemaWriter::kVersion) {
+            throwRuntimeError("Serialized schema has unsupported version " +
+                    std::to_string(version));
+        }
+
+        const uint32_t numSubschemas = readCount();
+        if (numSubschemas == 0) {
+            throwRuntimeError("Serialized schema contains no subschemas");
+        }
+
+        // The root schema is serialized at index 0
+        m_subschemas.push_back(m_schema.root());
+        for (uint32_t i = 1; i < numSubschemas; i++) {
+            m_subschemas.push_back(m_schema.createSubschema());
+        }
+
+        for (uint32_t i = 0; i < numSubschemas; i++) {
+            readSubschema(m_subschemas[i]);
+        }
+    }
+
+private:
+    typedef BinarySchemaWriter Format;
+
+    void readSubschema(const Subschema *subschema)
+    {
+        const uint8_t flags = readValue<uint8_t>();
+        if (flags & 1u) {
+            m_schema.setAlwaysInvalid(subschema, true);
+        }
+        if (flags & 2u) {
+            m_schema.setSubschemaTitle(subschema, readString());
+        }
+        if (flags & 4u) {
+            m_schema.setSubschemaDescription(subschema, readString());
+        }
+        if (flags & 8u) {
+            m_schema.setSubschemaId(subschema, readString());
+        }
+
+        const uint32_t numConstraints = readCount();
+        for (uint32_t i = 0; i < numConstraints; i++) {
+            readConstraint(subschema);
+        }
+    }
+
+    void readConstraint(const Subschema *subschema)
+    {
+        const uint8_t tag = readValue<uint8_t>();
+
+        switch (tag) {
+        case Format::kAllOf: {
+            constraints::AllOfConstraint constraint;
+            readSubschemaCollection(constraint);
+            m_schema.addConstraintToSubschema(constraint, subschema);
+            break;
+        }
+
+        case Format::kAnyOf: {
+            constraints::AnyOfConstraint constraint;
+            readSubschemaCollection(constraint);
+            m_schema.addConstraintToSubschema(constraint, subschema);
+            break;
+        }
+
+        case Format::kConditional: {
+            constraints::ConditionalConstraint constraint;
+            constraint.setIfSubschema(readSubschema());
+            constraint.setThenSubschema(readSubschema());
+            constraint.setElseSubschema(readSubschema());
+            m_schema.addConstraintToSubschema(constraint, subschema);
+            break;
+        }
+
+        case Format::kConst: {
+            constraints::ConstConstraint constraint;
+            const adapters::ScalarValue value = readScalar();
+            constraint.setValue(adapters::ScalarValueAdapter(value));
+            m_schema.addConstraintToSubschema(constraint, subschema);
+            break;
+        }
+
+        case Format::kContains: {
+            constraints::ContainsConstraint constraint;
+            constraint.setSubschema(readSubschema());
+            constraint.setMinContains(readValue<uint64_t>());
+            constraint.setMaxContains(readValue<uint64_t>());
+            m_schema.addConstraintToSubschema(constraint, subschema);
+            break;
+        }
+
+        case Format::kDependencies: {
+            constraints::DependenciesConstraint constraint;
+
+            const uint32_t numPropertyDependencies = readCount();
+            for (uint32_t i = 0; i < numPropertyDependencies; i++) {
+                const std::string propertyName = readString();
+                const uint32_t numDependencies = readCount();
+                std::vector<std::string> dependencyNames;
+                dependencyNames.reserve(numDependencies);
+                for (uint32_t j = 0; j < numDependencies; j++) {
+                    dependencyNames.push_back(readString());
+                }
+                constraint.addPropertyDependencies(propertyName,
+                        dependencyNames);
+            }
+
+            const uint32_t numSchemaDependencies = readCount();
+            for (uint32_t i = 0; i < numSchemaDependencies; i++) {
+                const std::string propertyName = readString();
+                constraint.addSchemaDependency(propertyName, readSubschema());
+            }
+
+            m_schema.addConstraintToSubschema(constraint, subschema);
+            break;
+        }
+
+        case Format::kEnum: {
+            constraints::EnumConstraint constraint;
+            const uint32_t numValues = readCount();
+            for (uint32_t i = 0; i < numValues; i++) {
+                const adapters::ScalarValue value = readScalar();
+
+                // Adding through an adapter maintains the constraint's
+                // canonical hash index
+                constraint.addValue(adapters::ScalarValueAdapter(value));
+            }
+            m_schema.addConstraintToSubschema(constraint, subschema);
+            break;
+        }
+
+        case Format::kFormat: {
+            constraints::FormatConstraint constraint;
+            constraint.setFormat(readString());
+            m_schema.addConstraintToSubschema(constraint, subschema);
+            break;
+        }
+
+        case Format::kLinearItems: {
+            constraints::LinearItemsConstraint constraint;
+            const uint32_t numItemSubschemas = readCount();
+            for (uint32_t i = 0; i < numItemSubschemas; i++) {
+                constraint.addItemSubschema(readSubschema());
+            }
+            constraint.setAdditionalItemsSubschema(readSubschema());
+            m_schema.addConstraintToSubschema(constraint, subschema);
+            break;
+        }
+
+        case Format::kMaximum: {
+            constraints::MaximumConstraint constraint;
+            constraint.setMaximum(readValue<double>());
+            constraint.setExclusiveMaximum(readValue<uint8_t>() != 0);
+            if (readValue<uint8_t>() != 0) {
+                constraint.setIntegerMaximum(readValue<int64_t>());
+            }
+            m_schema.addConstraintToSubschema(constraint, subschema);
+            break;
+        }
+
+        case Format::kMaxItems: {
+            constraints::MaxItemsConstraint constraint;
+            constraint.setMaxItems(readValue<uint64_t>());
+            m_schema.addConstraintToSubschema(constraint, subschema);
+            break;
+        }
+
+        case Format::kMaxLength: {
+            constraints::MaxLengthConstraint constraint;
+            constraint.setMaxLength(readValue<uint64_t>());
+            m_schema.addConstraintToSubschema(constraint, subschema);
+            break;
+        }
+
+        case Format::kMaxProperties: {
+            constraints::MaxPropertiesConstraint constraint;
+            constraint.setMaxProperties(readValue<uint64_t>());
+            m_schema.addConstraintToSubschema(constraint, subschema);
+            break;
+        }
+
+        case Format::kMinimum: {
+            constraints::MinimumConstraint constraint;
+            constraint.setMinimum(readValue<double>());
+            constraint.setExclusiveMinimum(readValue<uint8_t>() != 0);
+            if (readValue<uint8_t>() != 0) {
+                constraint.setIntegerMinimum(readValue<int64_t>());
+            }
+            m_schema.addConstraintToSubschema(constraint, subschema);
+            break;
+        }
+
+        case Format::kMinItems: {
+            constraints::MinItemsConstraint constraint;
+            constraint.setMinItems(readValue<uint64_t>());
+            m_schema.addConstraintToSubschema(constraint, subschema);
+            break;
+        }
+
+        case Format::kMinLength: {
+            constraints::MinLengthConstraint constraint;
+            constraint.setMinLength(readValue<uint64_t>());
+            m_schema.addConstraintToSubschema(constraint, subschema);
+            break;
+        }
+
+        case Format::kMinProperties: {
+            constraints::MinPropertiesConstraint constraint;
+            constraint.setMinProperties(readValue<uint64_t>());
+            m_schema.addConstraintToSubschema(constraint, subschema);
+            break;
+        }
+
+        case Format::kMultipleOfDouble: {
+            constraints::MultipleOfDoubleConstraint constraint;
+            constraint.setDivisor(readValue<double>());
+            m_schema.addConstraintToSubschema(constraint, subschema);
+            break;
+        }
+
+        case Format::kMultipleOfInt: {
+            constraints::MultipleOfIntConstraint constraint;
+            constraint.setDivisor(readValue<int64_t>());
+            m_schema.addConstraintToSubschema(constraint, subschema);
+            break;
+        }
+
+        case Format::kNot: {
+            constraints::NotConstraint constraint;
+            constraint.setSubschema(readSubschema());
+            m_schema.addConstraintToSubschema(constraint, subschema);
+            break;
+        }
+
+        case Format::kOneOf: {
+            constraints::OneOfConstraint constraint;
+            readSubschemaCollection(constraint);
+            m_schema.addConstraintToSubschema(constraint, subschema);
+            break;
+        }
+
+        case Format::kPattern: {
+            constraints::PatternConstraint constraint;
+            constraint.setPattern(readString());
+            m_schema.addConstraintToSubschema(constraint, subschema);
+            break;
+        }
+
+        case Format::kProperties: {
+            constraints::PropertiesConstraint constraint;
+
+            const uint32_t numProperties = readCount();
+            for (uint32_t i = 0; i < numProperties; i++) {
+                const std::string name = readString();
+                constraint.addPropertySubschema(name.c_str(), readSubschema());
+            }
+
+            const uint32_t numPatternProperties = readCount();
+            for (uint32_t i = 0; i < numPatternProperties; i++) {
+                const std::string pattern = readString();
+                constraint.addPatternPropertySubschema(pattern.c_str(),
+                        readSubschema());
+            }
+
+            constraint.setAdditionalPropertiesSubschema(readSubschema());
+            m_schema.addConstraintToSubschema(constraint, subschema);
+            break;
+        }
+
+        case Format::kPropertyNames: {
+            constraints::PropertyNamesConstraint constraint;
+            constraint.setSubschema(readSubschema());
+            m_schema.addConstraintToSubschema(constraint, subschema);
+            break;
+        }
+
+        case Format::kRequired: {
+            constraints::RequiredConstraint constraint;
+            const uint32_t numProperties = readCount();
+            for (uint32_t i = 0; i < numProperties; i++) {
+                const std::string name = readString();
+                constraint.addRequiredProperty(name.c_str());
+            }
+            m_schema.addConstraintToSubschema(constraint, subschema);
+            break;
+        }
+
+        case Format::kSingularItems: {
+            constraints::SingularItemsConstraint constraint;
+            constraint.setItemsSubschema(readSubschema());
+            m_schema.addConstraintToSubschema(constraint, subschema);
+            break;
+        }
+
+        case Format::kType: {
+            constraints::TypeConstraint constraint;
+
+            const uint32_t numNamedTypes = readCount();
+            for (uint32_t i = 0; i < numNamedTypes; i++) {
+                constraint.addNamedType(decodeJsonType(readValue<uint8_t>()));
+            }
+
+            const uint32_t numSchemaTypes = readCount();
+            for (uint32_t i = 0; i < numSchemaTypes; i++) {
+                constraint.addSchemaType(readSubschema());
+            }
+
+            m_schema.addConstraintToSubschema(constraint, subschema);
+            break;
+        }
+
+        case Format::kUniqueItems: {
+            constraints::UniqueItemsConstraint constraint;
+            m_schema.addConstraintToSubschema(constraint, subschema);
+            break;
+        }
+
+        default:
+            throwRuntimeError("Serialized schema contains unrecognised "
+                    "constraint tag " + std::to_string(tag));
+        }
+    }
+
+    template<typename ConstraintType>
+    void readSubschemaCollection(ConstraintType &constraint)
+    {
+        const uint32_t numSubschemas = readCount();
+        for (uint32_t i = 0; i < numSubschemas; i++) {
+            constraint.addSubschema(readSubschema());
+        }
+    }
+
+    static constraints::TypeConstraint::JsonType decodeJsonType(uint8_t encoded)
+    {
+        typedef constraints::TypeConstraint TypeConstraint;
+
+        switch (encoded) {
+        case 0:
+            return TypeConstraint::kAny;
+        case 1:
+            return TypeConstraint::kArray;
+        case 2:
+            return TypeConstraint::kBoolean;
+        case 3:
+            return TypeConstraint::kInteger;
+        case 4:
+            return TypeConstraint::kNull;
+        case 5:
+            return TypeConstraint::kNumber;
+        case 6:
+            return TypeConstraint::kObject;
+        case 7:
+            return TypeConstraint::kString;
+        default:
+            throwRuntimeError("Serialized schema contains unrecognised "
+                    "JSON type");
+        }
+    }
+
+    adapters::ScalarValue readScalar()
+    {
+        const uint8_t tag = readValue<uint8_t>();
+        switch (tag) {
+        case Format::kScalarNull:
+            return adapters::ScalarValue::makeNull();
+        case Format::kScalarBool:
+            return adapters::ScalarValue::makeBool(readValue<uint8_t>() != 0);
+        case Format::kScalarInteger:
+            return adapters::ScalarValue::makeInteger(readValue<int64_t>());
+        case Format::kScalarDouble:
+            return adapters::ScalarValue::makeDouble(readValue<double>());
+        case Format::kScalarString: {
+            const std::string value = readString();
+            return adapters::ScalarValue::makeString(value.data(), value.size());
+        }
+        default:
+            throwRuntimeError("Serialized schema contains unrecognised "
+                    "scalar value tag");
+        }
+    }
+
+    const Subschema * readSubschema()
+    {
+        const uint32_t index = readValue<uint32_t>();
+        if (index == Format::kNullIndex) {
+            return nullptr;
+        }
+
+        if (index == Format::kEmptyIndex) {
+            return m_schema.emptySubschema();
+        }
+
+        if (index >= m_subschemas.size()) {
+            throwRuntimeError("Serialized schema contains an out-of-range "
+                    "subschema reference");
+        }
+
+        return m_subschemas[index];
+    }
+
+    void readBytes(char *destination, size_t size)
+    {
+        if (size > m_size - m_offset) {
+            throwRuntimeError("Unexpected end of serialized schema data");
+        }
+
+        memcpy(destination, m_data + m_offset, size);
+        m_offset += size;
+    }
+
+    template<typename IntType>
+    IntType readValue()
+    {
+        IntType result;
+        readBytes(reinterpret_cast<char *>(&result), sizeof(result));
+        return result;
+    }
+
+    /**
+     * @brief  Read a count of elements that remain to be decoded
+     *
+     * Every element encodes to at least one byte, so a record cannot hold
+     * more elements than there are bytes left in the buffer. Rejecting a
+     * larger count here bounds both the allocations that are sized from
+     * counts and the loops that are driven by them, so a corrupt or
+     * truncated input fails quickly instead of soaking up CPU or memory.
+     */
+    uint32_t readCount()
+    {
+        const uint32_t count = readValue<uint32_t>();
+        if (count > m_size - m_offset) {
+            throwRuntimeError("Serialized schema contains a count that "
+                    "exceeds the remaining data");
+        }
+
+        return count;
+    }
+
+    std::string readString()
+    {
+        const uint32_t size = readValue<uint32_t>();
+        if (size > m_size - m_offset) {
+            throwRuntimeError("Unexpected end of serialized schema data");
+        }
+
+        std::string result(m_data + m_offset, size);
+        m_offset += size;
+        return result;
+    }
+
+    const char *m_data;
+    const size_t m_size;
+    size_t m_offset;
+    Schema &m_schema;
+    std::vector<const Subschema *> m_subschemas;
+};
+
+} // namespace internal
+
+/**
+ * @brief  Serialize a parsed schema to a versioned binary representation
+ *
+ * The serialized bytes are appended to the output vector. Custom constraints
+ * derived from PolyConstraint, and 'enum' or 'const' values that are arrays
+ * or objects, cannot be serialized; attempting to do so causes an exception
+ * to be thrown.
+ *
+ * @param  schema  schema to be serialized
+ * @param  output  vector that the serialized bytes will be appended to
+ */
+inline void serializeBinarySchema(const Schema &schema, std::vector<char> &output)
+{
+    internal::VectorByteSink sink(output);
+    internal::BinarySchemaWriter(schema, sink).write();
+}
+
+/**
+ * @brief  Return the number of bytes a schema will occupy when serialized
+ *
+ * Intended for sizing a shared memory segment, or a file to be memory
+ * mapped, before serializing into it with the buffer-based overload of
+ * serializeBinarySchema(). Throws under the same conditions as serializing
+ * the schema would.
+ *
+ * @param  schema  schema to be measured
+ *
+ * @returns  exact size of the serialized representation, in bytes
+ */
+inline size_t measureBinarySchema(const Schema &schema)
+{
+    internal::CountingByteSink sink;
+    internal::BinarySchemaWriter(schema, sink).write();
+    return sink.size();
+}
+
+/**
+ * @brief  Serialize a parsed schema directly into caller-provided memory
+ *
+ * The serialized representation refers to subschemas by index and contains
+ * no pointers, so the buffer may be a shared memory segment or a memory
+ * mapped file: it remains valid at whatever address other processes map it,
+ * and may be consumed by any number of them concurrently. Use
+ * measureBinarySchema() to size the buffer; an exception is thrown if the
+ * schema does not fit.
+ *
+ * @param  schema    schema to be serialized
+ * @param  buffer    destination for the serialized bytes
+ * @param  capacity  number of bytes available at buffer
+ *
+ * @returns  number of bytes written
+ */
+inline size_t serializeBinarySchema(const Schema &schema, char *buffer,
+        size_t capacity)
+{
+    internal::BufferByteSink sink(buffer, capacity);
+    internal::BinarySchemaWriter(schema, sink).write();
+    return sink.size();
+}
+
+/**
+ * @brief  Reconstruct a schema from its binary serialized form
+ *
+ * The data may be read directly from a memory-mapped file; it is consumed in
+ * a single linear pass and does not need to remain valid after this function
+ * returns. An exception is thrown if the data is truncated, corrupt, or was
+ * produced by an incompatible version of the serializer.
+ *
+ * @param  data    pointer to the serialized bytes
+ * @param  size    number of serialized bytes
+ * @param  schema  empty Schema instance to be populated
+ */
+inline void deserializeBinarySchema(const char *data, size_t size, Schema &schema)
+{
+    // Property names read from the serialized form are interned into the
+    // schema's pool, just as they would be when parsing a schema document
+    internal::StringInternPool::Scope internScope(schema.internPool());
+
+    internal::BinarySchemaReader(data, size, schema).read();
+}
+
+}  // namespace valijson
@@ -0,0 +1,440 @@
+/**
+ * @file
+ *
+ * @brief   Functions for summarising the size and shape of a parsed Schema
+ *
+ * When many schemas are registered in one process, knowing which of them are
+ * expensive - in memory or in expected validation cost - is a prerequisite
+ * for deciding where to spend optimization effort. The collectSchemaStatistics
+ * function walks the Subschema graph of a parsed Schema and reports
+ * constraint counts by type, reference depth, regular expression and enum
+ * table sizes, and the number of bytes requested from the schema's
+ * CustomAlloc hook.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <deque>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <valijson/constraints/concrete_constraints.hpp>
+#include <valijson/constraints/constraint_visitor.hpp>
+#include <valijson/schema.hpp>
+
+namespace valijson {
+
+/**
+ * @brief  Summary of the size and shape of a parsed Schema
+ *
+ * Produced by collectSchemaStatistics(). Byte counts reflect the sizes that
+ * were requested from the schema's CustomAlloc hook for constraint and
+ * Subschema storage; they do not include allocator overhead, or container
+ * storage allocated through the default allocator.
+ */
+struct SchemaStatistics
+{
+    /// Number of sub-schemas owned by the schema, including the root
+    size_t numSubschemas = 0;
+
+    /// Total number of constraints across all sub-schemas
+    size_t numConstraints = 0;
+
+    /// Number of constraints of each type, keyed by the constraint class
+    /// name without its 'Constraint' suffix (e.g. 'Properties', 'Enum')
+    std::map<std::string, size_t> constraintCounts;
+
+    /// Length of the longest chain of sub-schema references reachable from
+    /// the root, counting the root itself as one level; references to the
+    /// shared empty sub-schema are not counted
+    size_t maxDepth = 0;
+
+    /// Number of regular expressions held by 'pattern' constraints and
+    /// 'patternProperties' entries
+    size_t numRegexes = 0;
+
+    /// Total number of values across all 'enum' constraints
+    size_t numEnumValues = 0;
+
+    /// Bytes requested from the CustomAlloc hook for constraint storage
+    size_t constraintBytes = 0;
+
+    /// Bytes requested from the CustomAlloc hook for Subschema instances
+    size_t subschemaBytes = 0;
+};
+
+/**
+ * @brief  Constraint visitor that accumulates statistics for one sub-schema
+ *
+ * For each constraint, the visitor records its type and storage size, and
+ * appends the sub-schemas it refers to so that the caller can compute the
+ * depth of the reference graph.
+ */
+class SchemaStatisticsCollector: public constraints::ConstraintVisitor
+{
+public:
+    SchemaStatisticsCollector(SchemaStatistics &statistics,
+            std::vector<const Subschema *> &references)
+      : m_statistics(statistics),
+        m_references(references) { }
+
+    bool visit(const AllOfConstraint &constraint) override
+    {
+        record("AllOf", constraint);
+        addSubschemaCollection(constraint);
+        return true;
+    }
+
+    bool visit(const AnyOfConstraint &constraint) override
+    {
+        record("AnyOf", constraint);
+        addSubschemaCollection(constraint);
+        return true;
+    }
+
+    bool visit(const ConditionalConstraint &constraint) override
+    {
+        record("Conditional", constraint);
+        addReference(constraint.getIfSubschema());
+        addReference(constraint.getThenSubschema());
+        addReference(constraint.getElseSubschema());
+        return true;
+    }
+
+    bool visit(const ConstConstraint &constraint) override
+    {
+        record("Const", constraint);
+        return true;
+    }
+
+    bool visit(const ContainsConstraint &constraint) override
+    {
+        record("Contains", constraint);
+        addReference(constraint.getSubschema());
+        return true;
+    }
+
+    bool visit(const DependenciesConstraint &constraint) override
+    {
+        record("Dependencies", constraint);
+        constraint.applyToSchemaDependencies(AddSecond(this));
+        return true;
+    }
+
+    bool visit(const EnumConstraint &constraint) override
+    {
+        record("Enum", constraint);
+        constraint.applyToValues([this](const adapters::FrozenValue &) {
+            m_statistics.numEnumValues++;
+            return true;
+        });
+        return true;
+    }
+
+    bool visit(const FormatConstraint &constraint) override
+    {
+        record("Format", constraint);
+        return true;
+    }
+
+    bool visit(const FusedObjectConstraint &constraint) override
+    {
+        // A fused constraint is counted once, but the references and
+        // regexes held by its parts still contribute to the totals
+        record("FusedObject", constraint);
+        if (constraint.hasProperties()) {
+            addPropertiesDetails(constraint.getProperties());
+        }
+        if (constraint.hasPropertyNames()) {
+            addReference(constraint.getPropertyNames().getSubschema());
+        }
+        return true;
+    }
+
+    bool visit(const LinearItemsConstraint &constraint) override
+    {
+        record("LinearItems", constraint);
+        constraint.applyToItemSubschemas(
+                [this](unsigned int, const Subschema *subschema) {
+                    addReference(subschema);
+                    return true;
+                });
+        addReference(constraint.getAdditionalItemsSubschema());
+        return true;
+    }
+
+    bool visit(const MaximumConstraint &constraint) override
+    {
+        record("Maximum", constraint);
+        return true;
+    }
+
+    bool visit(const MaxItemsConstraint &constraint) override
+    {
+        record("MaxItems", constraint);
+        return true;
+    }
+
+    bool visit(const MaxLengthConstraint &constraint) override
+    {
+        record("MaxLength", constraint);
+        return true;
+    }
+
+    bool visit(const MaxPropertiesConstraint &constraint) override
+    {
+        record("MaxProperties", constraint);
+        return true;
+    }
+
+    bool visit(const MinimumConstraint &constraint) override
+    {
+        record("Minimum", constraint);
+        return true;
+    }
+
+    bool visit(const MinItemsConstraint &constraint) override
+    {
+        record("MinItems", constraint);
+        return true;
+    }
+
+    bool visit(const MinLengthConstraint &constraint) override
+    {
+        record("MinLength", constraint);
+        return true;
+    }
+
+    bool visit(const MinPropertiesConstraint &constraint) override
+    {
+        record("MinProperties", constraint);
+        return true;
+    }
+
+    bool visit(const MultipleOfDoubleConstraint &constraint) override
+    {
+        record("MultipleOfDouble", constraint);
+        return true;
+    }
+
+    bool visit(const MultipleOfIntConstraint &constraint) override
+    {
+        record("MultipleOfInt", constraint);
+        return true;
+    }
+
+    bool visit(const NotConstraint &constraint) override
+    {
+        record("Not", constraint);
+        addReference(constraint.getSubschema());
+        return true;
+    }
+
+    bool visit(const OneOfConstraint &constraint) override
+    {
+        record("OneOf", constraint);
+        addSubschemaCollection(constraint);
+        return true;
+    }
+
+    bool visit(const PatternConstraint &constraint) override
+    {
+        record("Pattern", constraint);
+        m_statistics.numRegexes++;
+        return true;
+    }
+
+    bool visit(const constraints::PolyConstraint &constraint) override
+    {
+        record("Poly", constraint);
+        return true;
+    }
+
+    bool visit(const PropertiesConstraint &constraint) override
+    {
+        record("Properties", constraint);
+        addPropertiesDetails(constraint);
+        return true;
+    }
+
+    bool visit(const PropertyNamesConstraint &constraint) override
+    {
+        record("PropertyNames", constraint);
+        addReference(constraint.getSubschema());
+        return true;
+    }
+
+    bool visit(const RequiredConstraint &constraint) override
+    {
+        record("Required", constraint);
+        return true;
+    }
+
+    bool visit(const SingularItemsConstraint &constraint) override
+    {
+        record("SingularItems", constraint);
+        addReference(constraint.getItemsSubschema());
+        return true;
+    }
+
+    bool visit(const TypeConstraint &constraint) override
+    {
+        record("Type", constraint);
+        constraint.applyToSchemaTypes(
+                [this](unsigned int, const Subschema *subschema) {
+                    addReference(subschema);
+                    return true;
+                });
+        return true;
+    }
+
+    bool visit(const UniqueItemsConstraint &constraint) override
+    {
+        record("UniqueItems", constraint);
+        return true;
+    }
+
+private:
+    /// Functor that records the sub-schema in a (name, sub-schema) pair
+    struct AddSecond
+    {
+        explicit AddSecond(SchemaStatisticsCollector *collector)
+          : m_collector(collector) { }
+
+        template<typename StringType>
+        bool operator()(const StringType &, const Subschema *subschema) const
+        {
+            m_collector->addReference(subschema);
+            return true;
+        }
+
+        SchemaStatisticsCollector *m_collector;
+    };
+
+    void record(const char *name, const constraints::Constraint &constraint)
+    {
+        m_statistics.constraintCounts[name]++;
+        m_statistics.numConstraints++;
+        m_statistics.constraintBytes += constraint.sizeOf();
+    }
+
+    void addReference(const Subschema *subschema)
+    {
+        if (subschema != nullptr) {
+            m_references.push_back(subschema);
+        }
+    }
+
+    template<typename ConstraintType>
+    void addSubschemaCollection(const ConstraintType &constraint)
+    {
+        constraint.applyToSubschemas(
+                [this](unsigned int, const Subschema *subschema) {
+                    addReference(subschema);
+                    return true;
+                });
+    }
+
+    void addPropertiesDetails(const PropertiesConstraint &constraint)
+    {
+        typedef constraints::PropertiesConstraint::String String;
+
+        constraint.applyToProperties(
+                [this](const String &, const Subschema *subschema) {
+                    addReference(subschema);
+                    return true;
+                });
+
+        constraint.applyToPatternProperties(
+                [this](const String &, const Subschema *subschema) {
+                    m_statistics.numRegexes++;
+                    addReference(subschema);
+                    return true;
+                });
+
+        addReference(constraint.getAdditionalPropertiesSubschema());
+    }
+
+    SchemaStatistics &m_statistics;
+    std::vector<const Subschema *> &m_references;
+};
+
+/**
+ * @brief  Walk the Subschema graph of a Schema and summarise its contents
+ *
+ * Traversal covers every sub-schema owned by the schema, including any that
+ * are no longer reachable from the root, so the byte counts reflect what the
+ * schema is holding rather than what validation would touch. The reported
+ * depth, in contrast, only considers sub-schemas reachable from the root.
+ *
+ * This is a cold path intended for offline analysis; it allocates freely and
+ * should not be called while validating.
+ *
+ * @param  schema  Schema to be summarised
+ *
+ * @returns a populated SchemaStatistics instance
+ */
+inline SchemaStatistics collectSchemaStatistics(const Schema &schema)
+{
+    SchemaStatistics statistics;
+
+    // References are collected per sub-schema so that the depth of the
+    // reference graph can be computed once all sub-schemas have been visited
+    std::map<const Subschema *, std::vector<const Subschema *>> references;
+
+    schema.applyToSubschemas([&statistics, &references](
+            const Subschema &subschema) {
+        statistics.numSubschemas++;
+        SchemaStatisticsCollector collector(statistics,
+                references[&subschema]);
+        subschema.forEachConstraint(
+                [&collector](const constraints::Constraint &constraint) {
+                    constraint.accept(collector);
+                    return true;
+                });
+        return true;
+    });
+
+    // Every sub-schema is allocated through the CustomAlloc hook except the
+    // root, which is part of the Schema object itself; the shared empty
+    // sub-schema, which is not included in numSubschemas, is allocated
+    // through the hook, so the two balance out exactly
+    statistics.subschemaBytes = statistics.numSubschemas * sizeof(Subschema);
+
+    // Breadth-first traversal of the reference graph, visiting each
+    // sub-schema at its shallowest depth; the visited map doubles as a guard
+    // against reference cycles
+    std::map<const Subschema *, size_t> depths;
+    std::deque<const Subschema *> pending;
+    depths[schema.root()] = 1;
+    pending.push_back(schema.root());
+    statistics.maxDepth = 1;
+
+    while (!pending.empty()) {
+        const Subschema *current = pending.front();
+        pending.pop_front();
+        const size_t depth = depths[current];
+
+        const auto itr = references.find(current);
+        if (itr == references.end()) {
+            continue;
+        }
+
+        for (const Subschema *target : itr->second) {
+            if (target == schema.emptySubschema()) {
+                continue;
+            }
+            if (depths.insert(std::make_pair(target, depth + 1)).second) {
+                statistics.maxDepth = (std::max)(statistics.maxDepth,
+                        depth + 1);
+                pending.push_back(target);
+            }
+        }
+    }
+
+    return statistics;
+}
+
+}  // namespace valijson
@@ -0,0 +1,305 @@
+/**
+ * @file
+ *
+ * @brief   Caller-provided scratch arena for transient validation state
+ *
+ * A validation run builds short-lived containers - matched-property sets,
+ * sorted member name lists, uniqueness buckets - whose contents never
+ * outlive the run. Obtaining each of those nodes from the global allocator
+ * shows up prominently in allocator profiles on hot validation paths.
+ * ScratchArena is a monotonic bump allocator that a caller owns and passes
+ * into validation: allocations are pointer bumps within a reusable block,
+ * nothing is freed individually, and reset() recycles the memory between
+ * documents. Once the arena has grown to the high-water mark of a workload,
+ * steady-state validation performs no global-allocator calls for its
+ * transient containers.
+ *
+ * This is the per-validation counterpart to the CustomAlloc hooks on Schema
+ * and Subschema, which cover only schema-side storage.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <utility>
+
+namespace valijson {
+
+/**
+ * @brief   Monotonic bump allocator that is reset between validation runs
+ *
+ * Memory is carved from a chain of blocks; when the current block is
+ * exhausted, a larger one is requested from the global allocator. reset()
+ * does not return memory to the global allocator - it coalesces the chain
+ * into a single block sized to the high-water mark and rewinds it, so a
+ * warmed-up arena serves an entire validation run from one block.
+ *
+ * An arena must not be shared by validations running concurrently; use one
+ * arena per thread.
+ */
+class ScratchArena
+{
+public:
+    /**
+     * @brief  Construct an arena with an initial block capacity
+     *
+     * The first block is not allocated until the first allocation request.
+     *
+     * @param  initialCapacity  size in bytes of the first block
+     */
+    explicit ScratchArena(size_t initialCapacity = 4096)
+      : m_head(nullptr),
+        m_cursor(nullptr),
+        m_remaining(0),
+        m_nextBlockSize(initialCapacity < sizeof(Block) * 2 ? sizeof(Block) * 2 : initialCapacity),
+        m_blockAllocations(0) { }
+
+    ScratchArena(const ScratchArena &) = delete;
+    ScratchArena & operator=(const ScratchArena &) = delete;
+
+    ~ScratchArena()
+    {
+        releaseBlocks();
+    }
+
+    /**
+     * @brief  Allocate uninitialised storage from the arena
+     *
+     * @param  size       number of bytes to allocate
+     * @param  alignment  required alignment; must be a power of two
+     *
+     * @returns pointer to storage that remains valid until the arena is
+     *          reset or destroyed
+     */
+    void * allocate(size_t size, size_t alignment)
+    {
+        const size_t padding = (alignment - reinterpret_cast<uintptr_t>(m_cursor) % alignment) % alignment;
+        if (padding + size > m_remaining) {
+            addBlock(size + alignment);
+            return allocate(size, alignment);
+        }
+
+        m_cursor += padding;
+        m_remaining -= padding;
+
+        void *result = m_cursor;
+        m_cursor += size;
+        m_remaining -= size;
+        return result;
+    }
+
+    /**
+     * @brief  Recycle the arena's memory for the next validation run
+     *
+     * Everything previously allocated from the arena is invalidated. When
+     * the run spilled into more than one block, the chain is replaced by a
+     * single block covering the combined capacity, so subsequent runs of
+     * similar size are served without touching the global allocator.
+     */
+    void reset()
+    {
+        if (m_head && m_head->next) {
+            // Coalesce into one block at the high-water mark, so the next
+            // run of similar size is served without growing again
+            size_t total = 0;
+            for (const Block *block = m_head; block; block = block->next) {
+                total += block->capacity;
+            }
+            releaseBlocks();
+            m_nextBlockSize = total;
+            addBlock(0);
+            return;
+        }
+
+        if (m_head) {
+            m_cursor = m_head->data();
+            m_remaining = m_head->capacity;
+        }
+    }
+
+    /**
+     * @brief  Return the total capacity, in bytes, of the arena's blocks
+     */
+    size_t capacity() const
+    {
+        size_t total = 0;
+        for (const Block *block = m_head; block; block = block->next) {
+            total += block->capacity;
+        }
+        return total;
+    }
+
+    /**
+     * @brief  Return the number of blocks requested from the global
+     *         allocator over the arena's lifetime
+     *
+     * The count is cumulative and is not reduced by reset(). A warmed-up
+     * arena stops requesting blocks, so a workload that no longer grows
+     * this counter is running without global-allocator calls for its
+     * transient state.
+     */
+    size_t blockAllocations() const
+    {
+        return m_blockAllocations;
+    }
+
+private:
+    /// Header preceding the usable storage of each block
+    struct Block
+    {
+        /// Next (older, smaller) block in the chain
+        Block *next;
+
+        /// Number of usable bytes following this header
+        size_t capacity;
+
+        /// Start of the block's usable storage
+        char * data()
+        {
+            return reinterpret_cast<char *>(this + 1);
+        }
+    };
+
+    /// Chain a new block large enough for a pending allocation
+    void addBlock(size_t minimumSize)
+    {
+        size_t blockSize = m_nextBlockSize;
+        if (blockSize < minimumSize) {
+            blockSize = minimumSize;
+        }
+
+        Block *block = static_cast<Block *>(::operator new(sizeof(Block) + blockSize));
+        m_blockAllocations++;
+        block->next = m_head;
+        block->capacity = blockSize;
+        m_head = block;
+        m_cursor = block->data();
+        m_remaining = blockSize;
+
+        // Grow geometrically so a run that outgrows its arena settles after
+        // a handful of blocks
+        m_nextBlockSize = blockSize * 2;
+    }
+
+    /// Return every block to the global allocator
+    void releaseBlocks()
+    {
+        while (m_head) {
+            Block *next = m_head->next;
+            ::operator delete(m_head);
+            m_head = next;
+        }
+        m_cursor = nullptr;
+        m_remaining = 0;
+    }
+
+    /// Most recently added block; the only one allocations are served from
+    Block *m_head;
+
+    /// Position of the next allocation within the head block
+    char *m_cursor;
+
+    /// Bytes remaining in the head block
+    size_t m_remaining;
+
+    /// Capacity to request for the next block
+    size_t m_nextBlockSize;
+
+    /// Number of blocks requested from the global allocator so far
+    size_t m_blockAllocations;
+};
+
+/**
+ * @brief   STL-compatible allocator that draws from a ScratchArena
+ *
+ * Deallocation is a no-op for arena-backed storage; memory is reclaimed in
+ * bulk when the arena is reset. When constructed without an arena, the
+ * allocator falls back to the global allocator, so containers typed on
+ * ScratchAllocator behave normally when no arena has been provided.
+ */
+template<typename T>
+class ScratchAllocator
+{
+public:
+    typedef T value_type;
+    typedef T * pointer;
+    typedef const T * const_pointer;
+    typedef T & reference;
+    typedef const T & const_reference;
+    typedef std::size_t size_type;
+    typedef std::ptrdiff_t difference_type;
+
+    template<typename U>
+    struct rebind
+    {
+        typedef ScratchAllocator<U> other;
+    };
+
+    /// Construct an allocator that draws from an arena, or from the global
+    /// allocator when no arena is provided
+    explicit ScratchAllocator(ScratchArena *arena = nullptr)
+      : m_arena(arena) { }
+
+    template<typename U>
+    ScratchAllocator(const ScratchAllocator<U> &other)
+      : m_arena(other.arena()) { }
+
+    T * allocate(std::size_t n)
+    {
+        if (m_arena) {
+            return static_cast<T *>(m_arena->allocate(n * sizeof(T), alignof(T)));
+        }
+
+        return static_cast<T *>(::operator new(n * sizeof(T)));
+    }
+
+    void deallocate(T *ptr, std::size_t)
+    {
+        if (!m_arena) {
+            ::operator delete(ptr);
+        }
+    }
+
+    template<typename U, typename... Args>
+    void construct(U *ptr, Args&&... args)
+    {
+        new (ptr) U(std::forward<Args>(args)...);
+    }
+
+    template<typename U>
+    void destroy(U *ptr)
+    {
+        ptr->~U();
+    }
+
+    size_type max_size() const
+    {
+        return size_type(-1) / sizeof(T);
+    }
+
+    /// Arena that allocations are served from; may be null
+    ScratchArena * arena() const
+    {
+        return m_arena;
+    }
+
+private:
+    ScratchArena *m_arena;
+};
+
+template<typename T, typename U>
+bool operator==(const ScratchAllocator<T> &lhs, const ScratchAllocator<U> &rhs)
+{
+    return lhs.arena() == rhs.arena();
+}
+
+template<typename T, typename U>
+bool operator!=(const ScratchAllocator<T> &lhs, const ScratchAllocator<U> &rhs)
+{
+    return !(lhs == rhs);
+}
+
+}  // namespace valijson
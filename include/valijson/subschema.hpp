@@ -1,13 +1,23 @@
 #pragma once
 
+#include <algorithm>
+#include <cstddef>
 #include <functional>
 #include <memory>
 #include <vector>
 
 #include <valijson/constraints/constraint.hpp>
 #include <valijson/internal/optional.hpp>
+#include <valijson/internal/small_vector.hpp>
 #include <valijson/exceptions.hpp>
 
+/// Software prefetch hint; expands to nothing on compilers without one
+#if defined(__GNUC__) || defined(__clang__)
+#define VALIJSON_PREFETCH(address) __builtin_prefetch(address)
+#else
+#define VALIJSON_PREFETCH(address) ((void) 0)
+#endif
+
 namespace valijson {
 
 /**
@@ -98,6 +108,7 @@ public:
       : m_allocFn(allocFn)
       , m_freeFn(freeFn)
       , m_alwaysInvalid(false)
+      , m_constraints(allocFn, freeFn)
     {
         // explicitly initialise optionals. See: https://github.com/tristanpenman/valijson/issues/124
         m_description = opt::nullopt;
@@ -140,24 +151,94 @@ public:
     }
 
     /**
-     * @brief  Invoke a function on each child Constraint
+     * @brief  Add a constraint to this sub-schema, transferring its payload
      *
-     * This function will apply the callback function to each constraint in
-     * the Subschema, even if one of the invocations returns \c false. However,
-     * if one or more invocations of the callback function return \c false,
-     * this function will also return \c false.
+     * As with the copying overload, the constraint object itself is cloned
+     * into storage owned by this Subschema, but any deep payload it holds -
+     * such as frozen 'enum' values - is moved rather than copied, leaving
+     * the source constraint in a valid but unspecified state. This avoids
+     * a second deep copy when a freshly built constraint is added.
      *
-     * @returns  \c true if all invocations of the callback function are
-     *           successful, \c false otherwise
+     * @param  constraint  Reference to the constraint to consume
      */
-    bool apply(ApplyFunction &applyFunction) const
+    void addConstraint(Constraint &&constraint)
+    {
+        m_constraints.push_back(constraint.moveClone(m_allocFn, m_freeFn));
+    }
+
+    /**
+     * @brief  Return the number of bytes of contiguous storage needed to hold
+     *         copies of all constraints owned by this sub-schema
+     *
+     * Each constraint size is padded to the alignment of std::max_align_t, so
+     * that the result can be used to carve a single allocation into correctly
+     * aligned per-constraint slots.
+     */
+    size_t constraintStorageSize() const
+    {
+        size_t result = 0;
+        for (auto &&constraint : m_constraints) {
+            result += alignedConstraintSize(constraint->sizeOf());
+        }
+
+        return result;
+    }
+
+    /**
+     * @brief  Clone the constraints owned by this sub-schema into a
+     *         caller-provided buffer, replacing the original heap-allocated
+     *         instances
+     *
+     * The buffer must be at least as large as the value returned by
+     * constraintStorageSize(), and must remain valid for the lifetime of
+     * this Subschema. The cloned constraints will be destroyed when this
+     * Subschema is destroyed, but the storage itself belongs to the caller.
+     *
+     * @param  buffer  pointer to storage for the cloned constraints
+     *
+     * @returns  pointer to the first unused byte within the buffer
+     */
+    void * compactConstraints(void *buffer)
+    {
+        char *next = static_cast<char *>(buffer);
+        for (auto &&constraint : m_constraints) {
+            Constraint *clone = constraint->cloneInto(next);
+            next += alignedConstraintSize(clone->sizeOf());
+
+            // Replacing the owning pointer destroys the original constraint;
+            // the no-op free function leaves the cloned instance's storage
+            // to be reclaimed by the owner of the buffer
+            constraint = Constraint::OwningPointer(clone,
+                    Constraint::CustomDeleter<const Constraint>(placementFree));
+        }
+
+        return next;
+    }
+
+    /**
+     * @brief  Invoke a callable on each child Constraint
+     *
+     * The callable is invoked directly, without being wrapped in a
+     * type-erased std::function, which makes this the preferred entry point
+     * on hot paths such as validation.
+     *
+     * The callable will be applied to each constraint in the Subschema, even
+     * if one of the invocations returns \c false. However, if one or more
+     * invocations of the callable return \c false, this function will also
+     * return \c false.
+     *
+     * @returns  \c true if all invocations of the callable are successful,
+     *           \c false otherwise
+     */
+    template<typename FunctorType>
+    bool forEachConstraint(const FunctorType &fn) const
     {
         bool allTrue = true;
         for (auto &&constraint : m_constraints) {
             // Even if an application fails, we want to continue checking the
             // schema. In that case we set allTrue to false, and then fall
             // through to the next constraint
-            if (!applyFunction(*constraint)) {
+            if (!fn(*constraint)) {
                 allTrue = false;
             }
         }
@@ -165,6 +246,91 @@ public:
         return allTrue;
     }
 
+    /**
+     * @brief  Remove the constraints that match a predicate
+     *
+     * The matched constraints are destroyed, so any references or pointers
+     * to them, or to state they own, become invalid. The relative order of
+     * the remaining constraints is preserved.
+     *
+     * @param  predFn  callable that returns \c true for each Constraint
+     *                 that should be removed
+     */
+    template<typename PredicateFunction>
+    void removeConstraints(const PredicateFunction &predFn)
+    {
+        m_constraints.erase(
+                std::remove_if(m_constraints.begin(), m_constraints.end(),
+                        [&predFn](const Constraint::OwningPointer &constraint) {
+                            return predFn(*constraint);
+                        }),
+                m_constraints.end());
+    }
+
+    /**
+     * @brief  Reorder this sub-schema's constraints using a rank function
+     *
+     * Constraints are stored, and therefore evaluated, in the order they
+     * were added. This function re-orders them so that constraints with a
+     * lower rank are evaluated first, which allows cheap checks to reject a
+     * document before expensive ones run when validating in fail-fast mode.
+     * Constraints with equal ranks keep their relative order, so the pass
+     * is deterministic.
+     *
+     * Note that the new order also applies when validation is exhaustive,
+     * which affects the order in which errors are reported.
+     *
+     * @param  rankFn  callable that returns an integer rank for a given
+     *                 Constraint; lower ranks are evaluated earlier
+     */
+    template<typename RankFunction>
+    void scheduleConstraints(const RankFunction &rankFn)
+    {
+        std::stable_sort(m_constraints.begin(), m_constraints.end(),
+                [&rankFn](const Constraint::OwningPointer &lhs,
+                        const Constraint::OwningPointer &rhs) {
+                    return rankFn(*lhs) < rankFn(*rhs);
+                });
+    }
+
+    /**
+     * @brief  Invoke a callable on each child Constraint
+     *
+     * This is a stricter version of the forEachConstraint() function that
+     * will return immediately if any of the invocations of the callable
+     * return \c false.
+     *
+     * @returns  \c true if all invocations of the callable are successful,
+     *           \c false otherwise
+     */
+    template<typename FunctorType>
+    bool forEachConstraintStrict(const FunctorType &fn) const
+    {
+        for (auto &&constraint : m_constraints) {
+            if (!fn(*constraint)) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    /**
+     * @brief  Invoke a function on each child Constraint
+     *
+     * This function will apply the callback function to each constraint in
+     * the Subschema, even if one of the invocations returns \c false. However,
+     * if one or more invocations of the callback function return \c false,
+     * this function will also return \c false.
+     *
+     * @returns  \c true if all invocations of the callback function are
+     *           successful, \c false otherwise
+     */
+    bool apply(ApplyFunction &applyFunction) const
+    {
+        return forEachConstraint(applyFunction);
+    }
+
     /**
      * @brief  Invoke a function on each child Constraint
      *
@@ -177,13 +343,7 @@ public:
      */
     bool applyStrict(ApplyFunction &applyFunction) const
     {
-        for (auto &&constraint : m_constraints) {
-            if (!applyFunction(*constraint)) {
-                return false;
-            }
-        }
-
-        return true;
+        return forEachConstraintStrict(applyFunction);
     }
 
     bool getAlwaysInvalid() const
@@ -191,6 +351,34 @@ public:
         return m_alwaysInvalid;
     }
 
+    /**
+     * @brief  Return true if this sub-schema accepts every possible value
+     *
+     * A sub-schema that holds no constraints - such as 'true' or '{}' in a
+     * schema document - validates any value it is applied to. Validators can
+     * use this to skip traversal of subtrees that such a sub-schema governs.
+     */
+    bool isAlwaysValid() const
+    {
+        return !m_alwaysInvalid && m_constraints.empty();
+    }
+
+    /**
+     * @brief  Hint that this sub-schema's constraints are about to be
+     *         visited
+     *
+     * Issues a software prefetch for the first constraint, so that its
+     * cache line is being fetched while the caller finishes dispatching.
+     * Most effective on a compiled schema, where a sub-schema's
+     * constraints are adjacent in memory; see Schema::compile().
+     */
+    void prefetchConstraints() const
+    {
+        if (!m_constraints.empty()) {
+            VALIJSON_PREFETCH(m_constraints.front().get());
+        }
+    }
+
     /**
      * @brief  Get the description associated with this sub-schema
      *
@@ -311,16 +499,42 @@ public:
 
 protected:
 
+    /**
+     * @brief  Destroy all constraints owned by this sub-schema
+     *
+     * This is used by derived classes that need to control the point at
+     * which constraints are destroyed, relative to the storage that
+     * contains them.
+     */
+    void clearConstraints()
+    {
+        m_constraints.clear();
+    }
+
     CustomAlloc m_allocFn;
 
     CustomFree m_freeFn;
 
 private:
 
+    /// Round a constraint size up to the next multiple of the strictest
+    /// fundamental alignment
+    static size_t alignedConstraintSize(size_t size)
+    {
+        const size_t alignment = alignof(std::max_align_t);
+        return (size + alignment - 1) / alignment * alignment;
+    }
+
+    /// No-op free function for constraints whose storage is managed
+    /// externally, such as by a Schema-owned arena
+    static void placementFree(void *) { }
+
     bool m_alwaysInvalid;
 
     /// List of pointers to constraints that apply to this schema.
-    std::vector<Constraint::OwningPointer> m_constraints;
+    /// Inline storage covers the common case of a sub-schema with only a
+    /// few constraints; larger sets spill to the custom allocator
+    internal::SmallVector<Constraint::OwningPointer, 4> m_constraints;
 
     /// Schema description (optional)
     opt::optional<std::string> m_description;
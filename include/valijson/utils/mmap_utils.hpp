@@ -0,0 +1,344 @@
+/**
+ * @file
+ *
+ * @brief   Memory-mapped file loading
+ *
+ * loadFile() in file_utils.hpp reads a whole file into a std::string, which
+ * costs a full copy of the file and briefly doubles peak memory while the
+ * string grows. For large document corpora it is cheaper to map the file
+ * into the address space and parse directly from the mapped region.
+ *
+ * MemoryMappedFile provides a zero-copy read-only view of a file, backed by
+ * mmap on POSIX systems and MapViewOfFile on Windows, with a plain read()
+ * fallback elsewhere. A writable copy-on-write mode is also available so
+ * that in-situ parsers, such as RapidJson's ParseInsitu, can consume the
+ * mapped region directly; modified pages are private to the process and are
+ * never written back to the file.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <string>
+
+#if defined(_WIN32)
+#define VALIJSON_MMAP_WINDOWS 1
+#include <windows.h>
+#elif defined(__unix__) || defined(__APPLE__)
+#define VALIJSON_MMAP_POSIX 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#include <fstream>
+#endif
+
+namespace valijson {
+namespace utils {
+
+/**
+ * @brief  Zero-copy view of a file, mapped into the address space
+ *
+ * The mapping is released when the object is destroyed or when close() is
+ * called, so the view returned by data() must not outlive the object. In
+ * writable mode the object additionally guarantees that the byte following
+ * the file contents is a null terminator, which in-situ parsers rely on;
+ * when the file size is an exact multiple of the page size there is no
+ * spare byte in the mapping, and the file is loaded into an owned buffer
+ * instead.
+ */
+class MemoryMappedFile
+{
+public:
+    MemoryMappedFile()
+      : m_data(nullptr),
+        m_size(0)
+#if VALIJSON_MMAP_WINDOWS
+      , m_fileHandle(INVALID_HANDLE_VALUE)
+      , m_mappingHandle(nullptr)
+#endif
+    { }
+
+    MemoryMappedFile(const MemoryMappedFile &) = delete;
+    MemoryMappedFile & operator=(const MemoryMappedFile &) = delete;
+
+    ~MemoryMappedFile()
+    {
+        close();
+    }
+
+    /**
+     * @brief  Map a file into the address space
+     *
+     * Any existing mapping held by this object is released first. When
+     * \c writable is true the mapping is copy-on-write: the region returned
+     * by mutableData() may be modified freely, the underlying file is never
+     * changed, and the byte at data()[size()] is guaranteed to be zero.
+     *
+     * @param  path      path to the file to be mapped
+     * @param  writable  whether a mutable, null-terminated view is required
+     *
+     * @return  true if the file was mapped, false otherwise
+     */
+    bool open(const std::string &path, bool writable = false)
+    {
+        close();
+
+#if VALIJSON_MMAP_POSIX
+        const int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            return false;
+        }
+
+        struct stat fileInfo;
+        if (fstat(fd, &fileInfo) != 0 || fileInfo.st_size < 0) {
+            ::close(fd);
+            return false;
+        }
+
+        const size_t size = static_cast<size_t>(fileInfo.st_size);
+        if (size == 0) {
+            // Zero-length mappings are not permitted, so represent an empty
+            // file with an owned, null-terminated buffer
+            ::close(fd);
+            m_fallback.clear();
+            m_data = &m_fallback[0];
+            m_size = 0;
+            return true;
+        }
+
+        const size_t pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+        if (writable && size % pageSize == 0) {
+            // The mapping would end exactly on a page boundary, leaving no
+            // spare byte for the null terminator that in-situ parsers
+            // expect, so fall back to an owned copy
+            const bool loaded = readIntoFallback(fd, size);
+            ::close(fd);
+            return loaded;
+        }
+
+        void *mapping = mmap(nullptr, size,
+                writable ? (PROT_READ | PROT_WRITE) : PROT_READ,
+                MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (mapping == MAP_FAILED) {
+            return false;
+        }
+
+        // When the file does not end on a page boundary, the remainder of
+        // the final page is zero-filled, so writable mappings are already
+        // null-terminated
+        m_data = static_cast<char *>(mapping);
+        m_size = size;
+        return true;
+
+#elif VALIJSON_MMAP_WINDOWS
+        m_fileHandle = CreateFileA(path.c_str(), GENERIC_READ,
+                FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (m_fileHandle == INVALID_HANDLE_VALUE) {
+            return false;
+        }
+
+        LARGE_INTEGER fileSize;
+        if (!GetFileSizeEx(m_fileHandle, &fileSize) ||
+                fileSize.QuadPart < 0) {
+            close();
+            return false;
+        }
+
+        const size_t size = static_cast<size_t>(fileSize.QuadPart);
+        if (size == 0) {
+            close();
+            m_fallback.clear();
+            m_data = &m_fallback[0];
+            m_size = 0;
+            return true;
+        }
+
+        SYSTEM_INFO systemInfo;
+        GetSystemInfo(&systemInfo);
+        if (writable && size % systemInfo.dwPageSize == 0) {
+            const bool loaded = readIntoFallbackWindows(size);
+            CloseHandle(m_fileHandle);
+            m_fileHandle = INVALID_HANDLE_VALUE;
+            return loaded;
+        }
+
+        m_mappingHandle = CreateFileMappingA(m_fileHandle, nullptr,
+                writable ? PAGE_WRITECOPY : PAGE_READONLY, 0, 0, nullptr);
+        if (m_mappingHandle == nullptr) {
+            close();
+            return false;
+        }
+
+        void *mapping = MapViewOfFile(m_mappingHandle,
+                writable ? FILE_MAP_COPY : FILE_MAP_READ, 0, 0, 0);
+        if (mapping == nullptr) {
+            close();
+            return false;
+        }
+
+        m_data = static_cast<char *>(mapping);
+        m_size = size;
+        return true;
+
+#else
+        // No mapping primitive available; fall back to reading the file
+        // into an owned buffer
+        (void)writable;
+        std::ifstream file(path.c_str(), std::ios::binary);
+        if (!file.is_open()) {
+            return false;
+        }
+
+        file.seekg(0, std::ios::end);
+        const std::streamoff offset = file.tellg();
+        if (offset < 0) {
+            return false;
+        }
+
+        file.seekg(0, std::ios::beg);
+        m_fallback.resize(static_cast<size_t>(offset));
+        if (offset > 0 &&
+                !file.read(&m_fallback[0], static_cast<std::streamsize>(offset))) {
+            m_fallback.clear();
+            return false;
+        }
+
+        m_data = &m_fallback[0];
+        m_size = m_fallback.size();
+        return true;
+#endif
+    }
+
+    /// Release the mapping, invalidating any views previously returned
+    void close()
+    {
+#if VALIJSON_MMAP_POSIX
+        if (m_data != nullptr && m_fallback.empty() && m_size > 0) {
+            munmap(m_data, m_size);
+        }
+#elif VALIJSON_MMAP_WINDOWS
+        if (m_data != nullptr && m_fallback.empty() && m_size > 0) {
+            UnmapViewOfFile(m_data);
+        }
+        if (m_mappingHandle != nullptr) {
+            CloseHandle(m_mappingHandle);
+            m_mappingHandle = nullptr;
+        }
+        if (m_fileHandle != INVALID_HANDLE_VALUE) {
+            CloseHandle(m_fileHandle);
+            m_fileHandle = INVALID_HANDLE_VALUE;
+        }
+#endif
+        m_data = nullptr;
+        m_size = 0;
+        m_fallback.clear();
+        m_fallback.shrink_to_fit();
+    }
+
+    /// Returns true if a file is currently mapped
+    bool isOpen() const
+    {
+        return m_data != nullptr;
+    }
+
+    /// Pointer to the first byte of the file contents
+    const char * data() const
+    {
+        return m_data;
+    }
+
+    /**
+     * @brief  Mutable pointer to the first byte of the file contents
+     *
+     * Only meaningful when the file was opened with \c writable set to
+     * true; modifications affect private copy-on-write pages and are never
+     * written back to the file.
+     */
+    char * mutableData()
+    {
+        return m_data;
+    }
+
+    /// Number of bytes in the file
+    size_t size() const
+    {
+        return m_size;
+    }
+
+private:
+#if VALIJSON_MMAP_POSIX
+    bool readIntoFallback(int fd, size_t size)
+    {
+        m_fallback.resize(size);
+        size_t total = 0;
+        while (total < size) {
+            const ssize_t bytesRead = read(fd, &m_fallback[total],
+                    size - total);
+            if (bytesRead <= 0) {
+                m_fallback.clear();
+                return false;
+            }
+            total += static_cast<size_t>(bytesRead);
+        }
+
+        m_data = &m_fallback[0];
+        m_size = size;
+        return true;
+    }
+#elif VALIJSON_MMAP_WINDOWS
+    bool readIntoFallbackWindows(size_t size)
+    {
+        m_fallback.resize(size);
+        size_t total = 0;
+        while (total < size) {
+            DWORD bytesRead = 0;
+            const DWORD chunk = static_cast<DWORD>(
+                    (std::min)(size - total, size_t(1) << 30));
+            if (!ReadFile(m_fileHandle, &m_fallback[total], chunk,
+                    &bytesRead, nullptr) || bytesRead == 0) {
+                m_fallback.clear();
+                return false;
+            }
+            total += bytesRead;
+        }
+
+        m_data = &m_fallback[0];
+        m_size = size;
+        return true;
+    }
+#endif
+
+    char *m_data;
+    size_t m_size;
+
+    /// Owned storage used when the file cannot be mapped directly; a
+    /// std::string is always null-terminated at index size()
+    std::string m_fallback;
+
+#if VALIJSON_MMAP_WINDOWS
+    HANDLE m_fileHandle;
+    HANDLE m_mappingHandle;
+#endif
+};
+
+/**
+ * @brief  Map a file into memory as a zero-copy read-only view
+ *
+ * @param  path  path to the file to be mapped
+ * @param  dest  mapping object that will own the view
+ *
+ * @return  true if mapped, false otherwise
+ */
+inline bool mmapFile(const std::string &path, MemoryMappedFile &dest)
+{
+    return dest.open(path);
+}
+
+}  // namespace utils
+}  // namespace valijson
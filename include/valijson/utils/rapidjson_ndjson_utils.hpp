@@ -0,0 +1,431 @@
+/**
+ * @file
+ *
+ * @brief   Streaming validation of newline-delimited JSON files
+ *
+ * Ingest jobs that validate NDJSON files row by row tend to re-implement
+ * the same pipeline: read a line into a string, parse it into a fresh
+ * document, validate, and throw everything away. At millions of rows the
+ * copies and allocator churn dominate the actual validation work.
+ *
+ * NdjsonValidatorT maps the input file copy-on-write, splits it into rows
+ * by terminating each line in place, and parses each row in-situ with
+ * RapidJson, so row text is never copied. Rows are validated against a
+ * shared schema across a pool of worker threads, using the same chunked
+ * work-stealing distribution as BatchValidatorT; each worker reuses one
+ * document and one value allocator for every row it claims. The result is
+ * a packed per-row outcome bitmap plus one error record per failing row.
+ *
+ * The pipeline is tied to RapidJson, which is the only bundled parser with
+ * in-situ support; other adapters can still be batch-validated through
+ * BatchValidatorT after parsing documents by other means.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <exception>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <rapidjson/document.h>
+
+#include <valijson/adapters/rapidjson_adapter.hpp>
+#include <valijson/utils/mmap_utils.hpp>
+#include <valijson/exceptions.hpp>
+#include <valijson/schema.hpp>
+#include <valijson/validation_results.hpp>
+#include <valijson/validator.hpp>
+
+namespace valijson {
+
+/**
+ * @brief   Validates newline-delimited JSON files against one schema
+ *
+ * @tparam  RegexEngine  regular expression engine used for pattern
+ *                       constraint validation
+ */
+template<typename RegexEngine>
+class NdjsonValidatorT
+{
+public:
+    typedef typename ValidatorT<RegexEngine>::TypeCheckingMode TypeCheckingMode;
+
+    /// Describes why a single row failed to parse or validate
+    struct ErrorRecord
+    {
+        /// 1-based line number of the failing row in the input file
+        size_t lineNumber;
+
+        /// JSON Pointer to the failing node within the row, or an empty
+        /// string for errors at the row root and for parse errors
+        std::string jsonPointer;
+
+        /// Human-readable description of the failure
+        std::string description;
+    };
+
+    /// Aggregated outcome of one validateFile or validateBuffer call
+    struct Summary
+    {
+        /// One entry per row, in input order, true where the row parsed
+        /// and validated successfully; std::vector<bool> packs this into
+        /// a bitmap of one bit per row
+        std::vector<bool> outcomes;
+
+        /// One record per failing row, ordered by line number, capped at
+        /// the configured maximum
+        std::vector<ErrorRecord> errors;
+
+        /// Number of rows processed; blank lines are not counted as rows
+        size_t numRows = 0;
+
+        /// Number of rows that validated successfully
+        size_t numValid = 0;
+
+        /// True if failing rows exceeded the error record budget, in which
+        /// case errors describes only a subset of the failures
+        bool truncated = false;
+    };
+
+    /**
+     * @brief  Construct an NdjsonValidator that uses strong type checking
+     *         and one worker per hardware thread
+     */
+    NdjsonValidatorT()
+      : m_validator(),
+        m_numThreads(defaultNumThreads()) { }
+
+    /**
+     * @brief  Construct an NdjsonValidator using a specific type checking
+     *         mode and worker count
+     *
+     * @param  typeCheckingMode  choice of strong or weak type checking
+     * @param  numThreads        number of worker threads to use, or 0 to
+     *                           use one worker per hardware thread
+     */
+    explicit NdjsonValidatorT(TypeCheckingMode typeCheckingMode,
+            size_t numThreads = 0)
+      : m_validator(typeCheckingMode),
+        m_numThreads(numThreads == 0 ? defaultNumThreads() : numThreads) { }
+
+    /**
+     * @brief  Validate every row of a newline-delimited JSON file
+     *
+     * The file is mapped copy-on-write, so row text is parsed in place and
+     * the file on disk is never modified. Blank and whitespace-only lines
+     * are skipped; every other line is treated as one JSON document.
+     *
+     * @param  schema           schema to validate each row against
+     * @param  path             path to the NDJSON file
+     * @param  summary          receives per-row outcomes and error records
+     * @param  maxErrorRecords  maximum number of error records to collect,
+     *                          or 0 for no limit
+     *
+     * @returns  true if the file could be mapped, false otherwise; parse
+     *           and validation failures are reported through the summary,
+     *           not the return value
+     */
+    bool validateFile(const Schema &schema, const std::string &path,
+            Summary &summary, size_t maxErrorRecords = 0) const
+    {
+        utils::MemoryMappedFile file;
+        if (!file.open(path, true)) {
+            return false;
+        }
+
+        validateBuffer(schema, file.mutableData(), file.size(), summary,
+                maxErrorRecords);
+        return true;
+    }
+
+    /**
+     * @brief  Validate every row of an in-memory NDJSON buffer
+     *
+     * The buffer is modified: newlines are replaced with null terminators
+     * and rows are parsed in-situ, which unescapes string values in place.
+     * The byte at data[size] must be addressable and is overwritten with a
+     * null terminator when the final line is not newline-terminated, as
+     * with the writable mode of MemoryMappedFile.
+     *
+     * @param  schema           schema to validate each row against
+     * @param  data             pointer to the start of the buffer
+     * @param  size             number of bytes of NDJSON text
+     * @param  summary          receives per-row outcomes and error records
+     * @param  maxErrorRecords  maximum number of error records to collect,
+     *                          or 0 for no limit
+     */
+    void validateBuffer(const Schema &schema, char *data, size_t size,
+            Summary &summary, size_t maxErrorRecords = 0) const
+    {
+        precompilePatterns<RegexEngine>(schema);
+
+        const std::vector<Row> rows = splitRows(data, size);
+
+        // std::vector<bool> packs its elements, so neighbouring rows would
+        // race on the same byte; collect outcomes in plain chars first
+        std::vector<char> outcomes(rows.size(), 0);
+
+        const size_t numWorkers = std::min(
+                std::max<size_t>(m_numThreads, 1),
+                std::max<size_t>(rows.size(), 1));
+
+        // Split the rows into one contiguous chunk per worker; each chunk
+        // is consumed through an atomic cursor, by its owner or by thieves
+        std::vector<Chunk> chunks(numWorkers);
+        const size_t chunkSize = rows.size() / numWorkers;
+        const size_t remainder = rows.size() % numWorkers;
+        size_t begin = 0;
+        for (size_t i = 0; i < numWorkers; i++) {
+            const size_t end = begin + chunkSize + (i < remainder ? 1 : 0);
+            chunks[i].cursor.store(begin, std::memory_order_relaxed);
+            chunks[i].end = end;
+            begin = end;
+        }
+
+        std::vector<std::vector<ErrorRecord>> workerErrors(numWorkers);
+
+        std::atomic<bool> failed(false);
+        std::exception_ptr firstException = nullptr;
+        std::mutex exceptionMutex;
+
+        const auto worker = [&](size_t workerIndex) {
+#if VALIJSON_USE_EXCEPTIONS
+            try {
+#endif
+                runWorker(workerIndex, chunks, schema, rows, outcomes,
+                        workerErrors[workerIndex], maxErrorRecords, failed);
+#if VALIJSON_USE_EXCEPTIONS
+            } catch (...) {
+                failed.store(true, std::memory_order_relaxed);
+                std::lock_guard<std::mutex> lock(exceptionMutex);
+                if (!firstException) {
+                    firstException = std::current_exception();
+                }
+            }
+#endif
+        };
+
+        std::vector<std::thread> threads;
+        threads.reserve(numWorkers - 1);
+        for (size_t i = 1; i < numWorkers; i++) {
+            threads.emplace_back(worker, i);
+        }
+
+        worker(0);
+
+        for (std::thread &thread : threads) {
+            thread.join();
+        }
+
+#if VALIJSON_USE_EXCEPTIONS
+        if (firstException) {
+            std::rethrow_exception(firstException);
+        }
+#endif
+
+        summary.numRows = rows.size();
+        summary.numValid = 0;
+        for (const char outcome : outcomes) {
+            summary.numValid += outcome ? 1 : 0;
+        }
+        summary.outcomes.assign(outcomes.begin(), outcomes.end());
+
+        summary.errors.clear();
+        for (std::vector<ErrorRecord> &records : workerErrors) {
+            summary.errors.insert(summary.errors.end(),
+                    std::make_move_iterator(records.begin()),
+                    std::make_move_iterator(records.end()));
+        }
+        std::sort(summary.errors.begin(), summary.errors.end(),
+                [](const ErrorRecord &lhs, const ErrorRecord &rhs) {
+                    return lhs.lineNumber < rhs.lineNumber;
+                });
+        if (maxErrorRecords != 0 && summary.errors.size() > maxErrorRecords) {
+            summary.errors.resize(maxErrorRecords);
+        }
+
+        // Every failing row wants exactly one record, so fewer records
+        // than failures means the budget was exhausted somewhere
+        summary.truncated =
+                summary.errors.size() < summary.numRows - summary.numValid;
+    }
+
+private:
+    /// One null-terminated row of input text
+    struct Row
+    {
+        /// Pointer to the row text within the mapped buffer
+        char *text;
+
+        /// 1-based line number of the row in the input
+        size_t lineNumber;
+    };
+
+    /// Range of row indices consumed through an atomic cursor
+    struct Chunk
+    {
+        Chunk()
+          : cursor(0),
+            end(0) { }
+
+        std::atomic<size_t> cursor;
+        size_t end;
+    };
+
+    /**
+     * @brief  Split a buffer into rows, terminating each line in place
+     *
+     * Newlines, and the carriage returns preceding them in CRLF input, are
+     * overwritten with null terminators so that each row can be handed to
+     * an in-situ parser directly. Blank and whitespace-only lines are
+     * skipped, with line numbering preserved for error reporting.
+     */
+    static std::vector<Row> splitRows(char *data, size_t size)
+    {
+        std::vector<Row> rows;
+
+        char *cursor = data;
+        char * const bufferEnd = data + size;
+        size_t lineNumber = 1;
+
+        while (cursor < bufferEnd) {
+            char *newline = static_cast<char *>(
+                    memchr(cursor, '\n', static_cast<size_t>(bufferEnd - cursor)));
+            char *lineEnd = newline ? newline : bufferEnd;
+
+            if (lineEnd > cursor && lineEnd[-1] == '\r') {
+                lineEnd[-1] = '\0';
+            }
+            if (newline) {
+                *newline = '\0';
+            }
+
+            // A row without a trailing newline relies on the caller's
+            // guarantee that data[size] is a null terminator
+
+            const char *content = cursor;
+            while (*content == ' ' || *content == '\t') {
+                content++;
+            }
+            if (*content != '\0') {
+                rows.push_back(Row{cursor, lineNumber});
+            }
+
+            lineNumber++;
+            cursor = newline ? newline + 1 : bufferEnd;
+        }
+
+        return rows;
+    }
+
+    void runWorker(size_t workerIndex,
+            std::vector<Chunk> &chunks,
+            const Schema &schema,
+            const std::vector<Row> &rows,
+            std::vector<char> &outcomes,
+            std::vector<ErrorRecord> &errorRecords,
+            size_t maxErrorRecords,
+            std::atomic<bool> &failed) const
+    {
+        // One document and allocator per worker, reused for every row the
+        // worker claims; clearing the allocator recycles its pages instead
+        // of returning them to the system between rows
+        rapidjson::MemoryPoolAllocator<> valueAllocator;
+        rapidjson::Document document(&valueAllocator);
+
+        const size_t numChunks = chunks.size();
+
+        // Consume the worker's own chunk first, then steal from the other
+        // workers' chunks, starting with the nearest neighbour; the atomic
+        // cursor guarantees each row is claimed by exactly one worker
+        for (size_t offset = 0; offset < numChunks; offset++) {
+            Chunk &chunk = chunks[(workerIndex + offset) % numChunks];
+
+            while (true) {
+                if (failed.load(std::memory_order_relaxed)) {
+                    return;
+                }
+
+                const size_t index = chunk.cursor.fetch_add(1,
+                        std::memory_order_relaxed);
+                if (index >= chunk.end) {
+                    break;
+                }
+
+                outcomes[index] = validateRow(schema, rows[index], document,
+                        valueAllocator, errorRecords, maxErrorRecords) ? 1 : 0;
+            }
+        }
+    }
+
+    bool validateRow(const Schema &schema,
+            const Row &row,
+            rapidjson::Document &document,
+            rapidjson::MemoryPoolAllocator<> &valueAllocator,
+            std::vector<ErrorRecord> &errorRecords,
+            size_t maxErrorRecords) const
+    {
+        const bool recordErrors = maxErrorRecords == 0 ||
+                errorRecords.size() < maxErrorRecords;
+
+        document.ParseInsitu(row.text);
+
+        bool valid = false;
+        if (document.HasParseError()) {
+            if (recordErrors) {
+                errorRecords.push_back(ErrorRecord{row.lineNumber,
+                        std::string(),
+                        "Failed to parse row: RapidJson error code " +
+                                std::to_string(document.GetParseError()) +
+                                " at offset " +
+                                std::to_string(document.GetErrorOffset())});
+            }
+        } else {
+            const adapters::RapidJsonAdapter adapter(document);
+            if (recordErrors) {
+                // One error per failing row keeps records compact; the
+                // budget also stops the visitor evaluating constraints
+                // that could only add further errors
+                ValidationResults results(true, 1);
+                valid = m_validator.validate(*schema.root(), adapter,
+                        &results);
+                if (!valid && results.numErrors() > 0) {
+                    const ValidationResults::Error &error = *results.begin();
+                    errorRecords.push_back(ErrorRecord{row.lineNumber,
+                            error.jsonPointer(), error.description});
+                }
+            } else {
+                valid = m_validator.validate(*schema.root(), adapter,
+                        nullptr);
+            }
+        }
+
+        // Release the row's values before the next parse; the allocator
+        // keeps its pages, so steady-state rows allocate nothing
+        document.SetNull();
+        valueAllocator.Clear();
+
+        return valid;
+    }
+
+    static size_t defaultNumThreads()
+    {
+        const unsigned int numThreads = std::thread::hardware_concurrency();
+        return numThreads == 0 ? 1 : numThreads;
+    }
+
+    /// Validator shared by all workers; holds no mutable state
+    ValidatorT<RegexEngine> m_validator;
+
+    /// Number of workers used to process a file
+    size_t m_numThreads;
+};
+
+using NdjsonValidator = NdjsonValidatorT<DefaultRegexEngine>;
+
+}  // namespace valijson
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <string>
+
+#include <rapidjson/error/en.h>
+#include <rapidjson/memorystream.h>
+#include <rapidjson/reader.h>
+
+#include <valijson/sax_validator.hpp>
+#include <valijson/schema.hpp>
+#include <valijson/validation_results.hpp>
+
+namespace valijson {
+namespace utils {
+
+/**
+ * @brief  Validate a JSON document against a schema while parsing it with
+ *         a rapidjson Reader, without building a DOM
+ *
+ * The document text is parsed exactly once, and each parse event is fed to
+ * a SaxValidator as it is produced. An invalid document terminates the
+ * parse at the first violation, so a rejected document is never read past
+ * the byte that rejected it, and no rapidjson Document is constructed in
+ * either case. Subtrees that no subschema constrains - typically those
+ * admitted by 'additionalProperties': true - are skipped without being
+ * materialized.
+ *
+ * Only schemas whose container constraints can be evaluated incrementally
+ * are supported; see sax_validator.hpp for the list of unsupported
+ * constructs. When a ValidationResults object is provided, parsing
+ * continues past the first violation so that all errors can be collected,
+ * and unsupported constructs are reported there as validation errors.
+ *
+ * @param  schema   schema that the document must validate against
+ * @param  data     pointer to the document text
+ * @param  size     number of bytes of document text
+ * @param  results  optional pointer to a ValidationResults instance that
+ *                  will be used to report validation errors
+ *
+ * @return  true if the document parsed and validated, false otherwise
+ */
+template<typename RegexEngine>
+inline bool validateWithoutDom(const Subschema &schema, const char *data,
+        size_t size, ValidationResults *results = nullptr)
+{
+    SaxValidatorT<RegexEngine> handler(schema, results);
+
+    rapidjson::MemoryStream stream(data, size);
+    rapidjson::Reader reader;
+    const rapidjson::ParseResult result = reader.Parse<
+            rapidjson::kParseIterativeFlag |
+            rapidjson::kParseValidateEncodingFlag>(stream, handler);
+
+    if (result.IsError()) {
+        // Termination is how the handler stops the parse on the first
+        // violation; anything else is a malformed document
+        if (result.Code() != rapidjson::kParseErrorTermination && results) {
+            results->pushError(internal::ValidationContext(),
+                    std::string("Failed to parse the document: ") +
+                    rapidjson::GetParseError_En(result.Code()) + ".");
+        }
+        return false;
+    }
+
+    return handler.isValid() && handler.isComplete();
+}
+
+/// @see validateWithoutDom(const Subschema &, const char *, size_t,
+///      ValidationResults *)
+template<typename RegexEngine>
+inline bool validateWithoutDom(const Subschema &schema,
+        const std::string &document, ValidationResults *results = nullptr)
+{
+    return validateWithoutDom<RegexEngine>(schema, document.data(),
+            document.size(), results);
+}
+
+/// Non-template overloads using the default regular expression engine
+inline bool validateWithoutDom(const Subschema &schema, const char *data,
+        size_t size, ValidationResults *results = nullptr)
+{
+    return validateWithoutDom<DefaultRegexEngine>(schema, data, size, results);
+}
+
+/// @see validateWithoutDom(const Subschema &, const char *, size_t,
+///      ValidationResults *)
+inline bool validateWithoutDom(const Subschema &schema,
+        const std::string &document, ValidationResults *results = nullptr)
+{
+    return validateWithoutDom<DefaultRegexEngine>(schema, document.data(),
+            document.size(), results);
+}
+
+}  // namespace utils
+}  // namespace valijson
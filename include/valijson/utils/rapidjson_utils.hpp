@@ -6,6 +6,7 @@
 #include <rapidjson/document.h>
 
 #include <valijson/utils/file_utils.hpp>
+#include <valijson/utils/mmap_utils.hpp>
 
 namespace valijson {
 namespace utils {
@@ -42,5 +43,92 @@ inline bool loadDocument(const std::string &path, rapidjson::GenericDocument<Enc
     return true;
 }
 
+/**
+ * @brief  Parse a document directly from a region of memory
+ *
+ * Intended for use with memory-mapped files, where the document text is
+ * already resident and copying it into a std::string first would double
+ * peak memory. The region does not need to be null-terminated; string
+ * values are copied into the document's allocator as usual.
+ *
+ * @param  data      pointer to the start of the document text
+ * @param  size      number of bytes of document text
+ * @param  document  document object to be populated
+ *
+ * @return  true if parsed, false otherwise
+ */
+template<typename Encoding, typename Allocator>
+inline bool parseDocumentFromRegion(const char *data, size_t size,
+        rapidjson::GenericDocument<Encoding, Allocator> &document)
+{
+#if VALIJSON_USE_EXCEPTIONS
+    try {
+#endif
+        document.template Parse<rapidjson::kParseIterativeFlag>(data, size);
+        if (document.HasParseError()) {
+            std::cerr << "RapidJson failed to parse the document:" << std::endl;
+            std::cerr << "Parse error: " << document.GetParseError() << std::endl;
+            return false;
+        }
+#if VALIJSON_USE_EXCEPTIONS
+    } catch (const std::runtime_error &e) {
+        std::cerr << "RapidJson failed to parse the document:" << std::endl;
+        std::cerr << "Runtime error: " << e.what() << std::endl;
+        return false;
+    }
+#endif
+
+    return true;
+}
+
+/**
+ * @brief  Load a document by memory-mapping the file and parsing in situ
+ *
+ * The file is mapped copy-on-write and parsed with RapidJson's in-situ
+ * mode, so string values in the resulting document point into the mapped
+ * region rather than being copied into the document's allocator. The
+ * mapping must therefore outlive the document; the caller provides the
+ * MemoryMappedFile object that owns it. Modified pages are private to the
+ * process and are never written back to the file.
+ *
+ * @param  path      path to the file to be loaded
+ * @param  mapping   mapping object that will own the file contents, and
+ *                   must outlive \c document
+ * @param  document  document object to be populated
+ *
+ * @return  true if loaded and parsed, false otherwise
+ */
+template<typename Encoding, typename Allocator>
+inline bool loadDocumentInSitu(const std::string &path,
+        MemoryMappedFile &mapping,
+        rapidjson::GenericDocument<Encoding, Allocator> &document)
+{
+    if (!mapping.open(path, true)) {
+        std::cerr << "Failed to map json file '" << path << "'." << std::endl;
+        return false;
+    }
+
+#if VALIJSON_USE_EXCEPTIONS
+    try {
+#endif
+        document.template ParseInsitu<
+                rapidjson::kParseIterativeFlag |
+                rapidjson::kParseInsituFlag>(mapping.mutableData());
+        if (document.HasParseError()) {
+            std::cerr << "RapidJson failed to parse the document:" << std::endl;
+            std::cerr << "Parse error: " << document.GetParseError() << std::endl;
+            return false;
+        }
+#if VALIJSON_USE_EXCEPTIONS
+    } catch (const std::runtime_error &e) {
+        std::cerr << "RapidJson failed to parse the document:" << std::endl;
+        std::cerr << "Runtime error: " << e.what() << std::endl;
+        return false;
+    }
+#endif
+
+    return true;
+}
+
 }  // namespace utils
 }  // namespace valijson
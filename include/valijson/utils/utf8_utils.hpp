@@ -1,14 +1,42 @@
 #pragma once
 
 #include <assert.h>
+#include <cstring>
 #include <stdexcept>
 #include <string>
 
 #include <valijson/exceptions.hpp>
 
+#if defined(__x86_64__) || defined(_M_X64)
+#define VALIJSON_UTF8_SSE2 1
+#include <emmintrin.h>
+#if (defined(__GNUC__) || defined(__clang__)) && !defined(_MSC_VER)
+#define VALIJSON_UTF8_AVX2 1
+#include <immintrin.h>
+#endif
+#elif defined(__aarch64__)
+#define VALIJSON_UTF8_NEON 1
+#include <arm_neon.h>
+#endif
+
 /*
   Basic UTF-8 manipulation routines, adapted from code that was released into
   the public domain by Jeff Bezanson.
+
+  Counting the characters in a UTF-8 string amounts to counting the bytes
+  that are not continuation bytes (10xxxxxx). The counting routines below do
+  this with SIMD kernels where the target supports them - SSE2 and, when the
+  CPU provides it, AVX2 on x86-64, NEON on AArch64 - and an 8-bytes-at-a-time
+  arithmetic fallback elsewhere, with a plain byte loop for short strings and
+  trailing bytes. Continuation bytes have values in [0x80, 0xBF], which as
+  signed bytes is exactly the range below -64; the kernels count them with a
+  single signed comparison per byte.
+
+  Most strings in real documents are pure ASCII, for which the character
+  count is simply the byte count. Counting is therefore preceded by a scan
+  for the first block containing a high bit, which needs only a movemask (or
+  an AND against 0x80s) per block; the counting kernels are reached only
+  from the first block that actually contains a multi-byte character.
 */
 
 namespace valijson {
@@ -40,23 +68,332 @@ inline uint64_t u8_nextchar(const char *s, uint64_t *i)
     return ch;
 }
 
-/* number of characters */
-inline uint64_t u8_strlen(const char *s)
+/* count continuation bytes one byte at a time */
+inline uint64_t u8_count_continuation_scalar(const char *s, uint64_t bytes)
 {
-    constexpr auto maxLength = std::numeric_limits<uint64_t>::max();
     uint64_t count = 0;
+    for (uint64_t i = 0; i < bytes; i++) {
+        if (!isutf(s[i])) {
+            count++;
+        }
+    }
+
+    return count;
+}
+
+/* length of the all-ASCII prefix, in whole eight-byte blocks */
+inline uint64_t u8_ascii_prefix_swar(const char *s, uint64_t bytes)
+{
     uint64_t i = 0;
 
-    while (s[i] != 0 && u8_nextchar(s, &i) != 0) {
-        if (i == maxLength) {
-            throwRuntimeError(
-                    "String exceeded maximum size of " +
-                    std::to_string(maxLength) + " bytes.");
+    for (; i + 8 <= bytes; i += 8) {
+        uint64_t chunk;
+        memcpy(&chunk, s + i, 8);
+        if ((chunk & UINT64_C(0x8080808080808080)) != 0) {
+            break;
         }
-        count++;
     }
 
-    return count;
+    return i;
+}
+
+/* count continuation bytes eight at a time using ordinary arithmetic */
+inline uint64_t u8_count_continuation_swar(const char *s, uint64_t bytes)
+{
+    uint64_t count = 0;
+    uint64_t i = 0;
+
+    for (; i + 8 <= bytes; i += 8) {
+        uint64_t chunk;
+        memcpy(&chunk, s + i, 8);
+
+        // Set the low bit of each byte that matches 10xxxxxx, then sum the
+        // eight single-bit counts into the top byte of the product
+        const uint64_t mask =
+                (chunk >> 7) & ~(chunk >> 6) & UINT64_C(0x0101010101010101);
+        count += (mask * UINT64_C(0x0101010101010101)) >> 56;
+    }
+
+    return count + u8_count_continuation_scalar(s + i, bytes - i);
+}
+
+#if VALIJSON_UTF8_SSE2
+
+/* length of the all-ASCII prefix, in whole sixteen-byte blocks */
+inline uint64_t u8_ascii_prefix_sse2(const char *s, uint64_t bytes)
+{
+    uint64_t i = 0;
+
+    for (; i + 16 <= bytes; i += 16) {
+        const __m128i chunk =
+                _mm_loadu_si128(reinterpret_cast<const __m128i *>(s + i));
+        if (_mm_movemask_epi8(chunk) != 0) {
+            break;
+        }
+    }
+
+    return i;
+}
+
+/* count continuation bytes sixteen at a time */
+inline uint64_t u8_count_continuation_sse2(const char *s, uint64_t bytes)
+{
+    const __m128i threshold = _mm_set1_epi8(-64);
+    uint64_t count = 0;
+    uint64_t i = 0;
+
+    for (; i + 16 <= bytes; i += 16) {
+        const __m128i chunk =
+                _mm_loadu_si128(reinterpret_cast<const __m128i *>(s + i));
+#if defined(_MSC_VER)
+        const int mask = _mm_movemask_epi8(_mm_cmplt_epi8(chunk, threshold));
+        count += static_cast<unsigned>(__popcnt(mask));
+#else
+        const int mask = _mm_movemask_epi8(_mm_cmplt_epi8(chunk, threshold));
+        count += static_cast<unsigned>(__builtin_popcount(mask));
+#endif
+    }
+
+    return count + u8_count_continuation_scalar(s + i, bytes - i);
+}
+
+#if VALIJSON_UTF8_AVX2
+
+/* length of the all-ASCII prefix, in whole thirty-two byte blocks */
+__attribute__((target("avx2")))
+inline uint64_t u8_ascii_prefix_avx2(const char *s, uint64_t bytes)
+{
+    uint64_t i = 0;
+
+    for (; i + 32 <= bytes; i += 32) {
+        const __m256i chunk =
+                _mm256_loadu_si256(reinterpret_cast<const __m256i *>(s + i));
+        if (_mm256_movemask_epi8(chunk) != 0) {
+            break;
+        }
+    }
+
+    return i + u8_ascii_prefix_sse2(s + i, bytes - i);
+}
+
+/* count continuation bytes thirty-two at a time */
+__attribute__((target("avx2")))
+inline uint64_t u8_count_continuation_avx2(const char *s, uint64_t bytes)
+{
+    const __m256i threshold = _mm256_set1_epi8(-64);
+    uint64_t count = 0;
+    uint64_t i = 0;
+
+    for (; i + 32 <= bytes; i += 32) {
+        const __m256i chunk =
+                _mm256_loadu_si256(reinterpret_cast<const __m256i *>(s + i));
+        const int mask = _mm256_movemask_epi8(
+                _mm256_cmpgt_epi8(threshold, chunk));
+        count += static_cast<unsigned>(__builtin_popcount(mask));
+    }
+
+    return count + u8_count_continuation_sse2(s + i, bytes - i);
+}
+
+#endif  // VALIJSON_UTF8_AVX2
+
+#elif VALIJSON_UTF8_NEON
+
+/* length of the all-ASCII prefix, in whole sixteen-byte blocks */
+inline uint64_t u8_ascii_prefix_neon(const char *s, uint64_t bytes)
+{
+    uint64_t i = 0;
+
+    for (; i + 16 <= bytes; i += 16) {
+        const uint8x16_t chunk =
+                vld1q_u8(reinterpret_cast<const uint8_t *>(s + i));
+        if (vmaxvq_u8(chunk) >= 0x80) {
+            break;
+        }
+    }
+
+    return i;
+}
+
+/* count continuation bytes sixteen at a time */
+inline uint64_t u8_count_continuation_neon(const char *s, uint64_t bytes)
+{
+    const int8x16_t threshold = vdupq_n_s8(-64);
+    uint64_t count = 0;
+    uint64_t i = 0;
+
+    while (i + 16 <= bytes) {
+        // Each matching lane of the comparison is all ones; subtracting it
+        // from the per-lane accumulator adds one. The accumulator would
+        // overflow after 255 additions, so flush it at least every 255
+        // chunks.
+        uint8x16_t accumulator = vdupq_n_u8(0);
+        uint64_t chunks = (bytes - i) / 16;
+        if (chunks > 255) {
+            chunks = 255;
+        }
+
+        for (uint64_t c = 0; c < chunks; c++, i += 16) {
+            const int8x16_t chunk = vreinterpretq_s8_u8(
+                    vld1q_u8(reinterpret_cast<const uint8_t *>(s + i)));
+            accumulator = vsubq_u8(accumulator,
+                    vcltq_s8(chunk, threshold));
+        }
+
+        count += vaddlvq_u8(accumulator);
+    }
+
+    return count + u8_count_continuation_scalar(s + i, bytes - i);
+}
+
+#endif  // VALIJSON_UTF8_SSE2 / VALIJSON_UTF8_NEON
+
+/* length of the all-ASCII prefix, in whole blocks, using the fastest
+   kernel available; bytes beyond the returned prefix still need to be
+   examined, since a partial trailing block is never included */
+inline uint64_t u8_ascii_prefix(const char *s, uint64_t bytes)
+{
+#if VALIJSON_UTF8_SSE2
+#if VALIJSON_UTF8_AVX2
+    static const bool haveAvx2 = __builtin_cpu_supports("avx2") != 0;
+    if (haveAvx2 && bytes >= 32) {
+        return u8_ascii_prefix_avx2(s, bytes);
+    }
+#endif
+    return u8_ascii_prefix_sse2(s, bytes);
+#elif VALIJSON_UTF8_NEON
+    return u8_ascii_prefix_neon(s, bytes);
+#else
+    return u8_ascii_prefix_swar(s, bytes);
+#endif
+}
+
+/* count continuation bytes using the fastest kernel available */
+inline uint64_t u8_count_continuation(const char *s, uint64_t bytes)
+{
+    if (bytes < 16) {
+        return u8_count_continuation_scalar(s, bytes);
+    }
+
+#if VALIJSON_UTF8_SSE2
+#if VALIJSON_UTF8_AVX2
+    static const bool haveAvx2 = __builtin_cpu_supports("avx2") != 0;
+    if (haveAvx2 && bytes >= 32) {
+        return u8_count_continuation_avx2(s, bytes);
+    }
+#endif
+    return u8_count_continuation_sse2(s, bytes);
+#elif VALIJSON_UTF8_NEON
+    return u8_count_continuation_neon(s, bytes);
+#else
+    return u8_count_continuation_swar(s, bytes);
+#endif
+}
+
+/* number of characters in the first `bytes` bytes of s */
+inline uint64_t u8_strlen(const char *s, uint64_t bytes)
+{
+    // For the common case of a pure ASCII string, the scan runs to the end
+    // and the count below is over an empty or near-empty remainder
+    const uint64_t prefix = u8_ascii_prefix(s, bytes);
+    return bytes - u8_count_continuation(s + prefix, bytes - prefix);
+}
+
+/**
+ * @brief  Validate a UTF-8 string and count its characters in one pass
+ *
+ * Checks that the first `bytes` bytes of s form well-formed UTF-8 - correct
+ * continuation byte counts, no overlong encodings, no surrogates, and no
+ * code points beyond U+10FFFF - while counting the encoded characters. Runs
+ * of ASCII are skipped a block at a time; non-ASCII sequences are checked by
+ * a scalar loop.
+ *
+ * @param  s      string to examine
+ * @param  bytes  number of bytes to examine
+ * @param  count  receives the number of characters counted before the end
+ *                of the string or the first malformed sequence
+ *
+ * @returns  true if the examined bytes are well-formed UTF-8
+ */
+inline bool u8_validate_and_count(const char *s, uint64_t bytes,
+        uint64_t *count)
+{
+    const unsigned char *u = reinterpret_cast<const unsigned char *>(s);
+    uint64_t n = 0;
+    uint64_t i = 0;
+
+    while (i < bytes) {
+        // Fast path: skip whole blocks of ASCII
+        const uint64_t asciiBlocks = u8_ascii_prefix(s + i, bytes - i);
+        n += asciiBlocks;
+        i += asciiBlocks;
+
+        if (i >= bytes) {
+            break;
+        }
+
+        const unsigned char lead = u[i];
+        if (lead < 0x80) {
+            n++;
+            i++;
+            continue;
+        }
+
+        uint64_t sequenceLength;
+        unsigned char minSecond = 0x80;
+        unsigned char maxSecond = 0xBF;
+        if (lead >= 0xC2 && lead <= 0xDF) {
+            sequenceLength = 2;
+        } else if (lead >= 0xE0 && lead <= 0xEF) {
+            sequenceLength = 3;
+            if (lead == 0xE0) {
+                minSecond = 0xA0;         // reject overlong encodings
+            } else if (lead == 0xED) {
+                maxSecond = 0x9F;         // reject UTF-16 surrogates
+            }
+        } else if (lead >= 0xF0 && lead <= 0xF4) {
+            sequenceLength = 4;
+            if (lead == 0xF0) {
+                minSecond = 0x90;         // reject overlong encodings
+            } else if (lead == 0xF4) {
+                maxSecond = 0x8F;         // reject values above U+10FFFF
+            }
+        } else {
+            // Continuation byte without a lead, overlong 0xC0/0xC1 lead, or
+            // invalid 0xF5-0xFF lead
+            *count = n;
+            return false;
+        }
+
+        if (i + sequenceLength > bytes) {
+            *count = n;
+            return false;
+        }
+
+        if (u[i + 1] < minSecond || u[i + 1] > maxSecond) {
+            *count = n;
+            return false;
+        }
+
+        for (uint64_t j = 2; j < sequenceLength; j++) {
+            if ((u[i + j] & 0xC0) != 0x80) {
+                *count = n;
+                return false;
+            }
+        }
+
+        n++;
+        i += sequenceLength;
+    }
+
+    *count = n;
+    return true;
+}
+
+/* number of characters */
+inline uint64_t u8_strlen(const char *s)
+{
+    return u8_strlen(s, strlen(s));
 }
 
 }  // namespace utils
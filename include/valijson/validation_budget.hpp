@@ -0,0 +1,238 @@
+/**
+ * @file
+ *
+ * @brief   Deterministic cost budgets for in-flight validation
+ *
+ * Hostile or degenerate schema/document pairs - deeply nested values, or
+ * combinators whose branches multiply under large arrays - can make the
+ * cost of a validation run explode combinatorially. A deadline on a
+ * CancellationToken bounds wall-clock time, but the point at which it
+ * fires depends on machine load. The ValidationBudget defined here bounds
+ * the work itself: the validator counts constraint evaluations and regex
+ * executions against configurable limits, and checks the document depth
+ * of each sub-schema visit, abandoning the run deterministically once a
+ * limit is crossed.
+ *
+ * The counters are relaxed atomics, so a budget may be attached to a run
+ * that evaluates combinator branches in parallel; the limits are then
+ * enforced approximately, within one charge per worker.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+
+namespace valijson {
+
+/**
+ * @brief  Budget on the amount of work a validation run may perform
+ *
+ * A budget is handed to a validate call and charged by the validator as it
+ * works. Limits that are left at zero are unenforced. Once any limit is
+ * crossed the budget latches into the exceeded state, the remainder of the
+ * run is abandoned at the next sub-schema boundary, and the run reports
+ * failure, with the exhaustion recorded in the ValidationResults object
+ * where one was provided.
+ *
+ * A budget may be reused across sequential validation runs by calling
+ * reset() between them; the configured limits are retained.
+ */
+class ValidationBudget
+{
+public:
+
+    /**
+     * @brief  Construct a budget with no limits enforced
+     */
+    ValidationBudget()
+      : m_maxDocumentDepth(0),
+        m_maxConstraintEvaluations(0),
+        m_maxRegexExecutions(0),
+        m_constraintEvaluations(0),
+        m_regexExecutions(0),
+        m_exceededDocumentDepth(false),
+        m_exceededConstraintEvaluations(false),
+        m_exceededRegexExecutions(false) { }
+
+    ValidationBudget(const ValidationBudget &) = delete;
+    ValidationBudget & operator=(const ValidationBudget &) = delete;
+
+    /**
+     * @brief  Limit how deeply nested a validated value may be
+     *
+     * Depth is measured in context frames: the document root is at depth
+     * zero, and each array item or object property visited below it adds
+     * one. A limit of zero leaves depth unbounded.
+     *
+     * @param  maxDepth  greatest depth a sub-schema visit may occur at
+     */
+    void setMaxDocumentDepth(size_t maxDepth)
+    {
+        m_maxDocumentDepth = maxDepth;
+    }
+
+    /**
+     * @brief  Limit the number of constraints the run may evaluate
+     *
+     * Every constraint dispatched by the validator counts as one
+     * evaluation, including constraints within combinator branches that
+     * are later rejected. A limit of zero leaves the count unbounded.
+     *
+     * @param  maxEvaluations  number of constraint evaluations permitted
+     */
+    void setMaxConstraintEvaluations(size_t maxEvaluations)
+    {
+        m_maxConstraintEvaluations = maxEvaluations;
+    }
+
+    /**
+     * @brief  Limit the number of regular expression executions
+     *
+     * Each evaluation of a 'pattern' constraint, and each property name
+     * tested against a 'patternProperties' pattern or combined automaton,
+     * counts as one execution. A limit of zero leaves the count unbounded.
+     *
+     * @param  maxExecutions  number of regex executions permitted
+     */
+    void setMaxRegexExecutions(size_t maxExecutions)
+    {
+        m_maxRegexExecutions = maxExecutions;
+    }
+
+    /**
+     * @brief  Check a sub-schema visit's depth against the depth limit
+     *
+     * Called by the validator; exceeding the limit latches the budget into
+     * the exceeded state.
+     *
+     * @param  depth  depth of the value being validated
+     *
+     * @returns  true if the visit is within budget
+     */
+    bool checkDocumentDepth(size_t depth)
+    {
+        if (m_maxDocumentDepth != 0 && depth > m_maxDocumentDepth) {
+            m_exceededDocumentDepth.store(true, std::memory_order_relaxed);
+            return false;
+        }
+
+        return true;
+    }
+
+    /**
+     * @brief  Count one constraint evaluation against the budget
+     *
+     * @returns  true if the evaluation is within budget
+     */
+    bool chargeConstraintEvaluation()
+    {
+        const size_t count = m_constraintEvaluations.fetch_add(1,
+                std::memory_order_relaxed) + 1;
+        if (m_maxConstraintEvaluations != 0 &&
+                count > m_maxConstraintEvaluations) {
+            m_exceededConstraintEvaluations.store(true,
+                    std::memory_order_relaxed);
+            return false;
+        }
+
+        return true;
+    }
+
+    /**
+     * @brief  Count one regular expression execution against the budget
+     *
+     * @returns  true if the execution is within budget
+     */
+    bool chargeRegexExecution()
+    {
+        const size_t count = m_regexExecutions.fetch_add(1,
+                std::memory_order_relaxed) + 1;
+        if (m_maxRegexExecutions != 0 && count > m_maxRegexExecutions) {
+            m_exceededRegexExecutions.store(true, std::memory_order_relaxed);
+            return false;
+        }
+
+        return true;
+    }
+
+    /// Returns true if any limit has been crossed
+    bool exceeded() const
+    {
+        return m_exceededDocumentDepth.load(std::memory_order_relaxed) ||
+               m_exceededConstraintEvaluations.load(std::memory_order_relaxed) ||
+               m_exceededRegexExecutions.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief  Describe the first limit found to have been crossed
+     *
+     * @returns  short description of an exceeded limit, or nullptr if the
+     *           budget has not been exceeded
+     */
+    const char * exceededLimit() const
+    {
+        if (m_exceededDocumentDepth.load(std::memory_order_relaxed)) {
+            return "document depth";
+        }
+        if (m_exceededConstraintEvaluations.load(std::memory_order_relaxed)) {
+            return "constraint evaluations";
+        }
+        if (m_exceededRegexExecutions.load(std::memory_order_relaxed)) {
+            return "regex executions";
+        }
+        return nullptr;
+    }
+
+    /// Number of constraint evaluations charged so far
+    size_t constraintEvaluations() const
+    {
+        return m_constraintEvaluations.load(std::memory_order_relaxed);
+    }
+
+    /// Number of regular expression executions charged so far
+    size_t regexExecutions() const
+    {
+        return m_regexExecutions.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief  Clear the counters and the exceeded state, retaining the
+     *         configured limits, so that the budget can be reused for
+     *         another run
+     *
+     * Must not be called while a validation run is charging the budget.
+     */
+    void reset()
+    {
+        m_constraintEvaluations.store(0, std::memory_order_relaxed);
+        m_regexExecutions.store(0, std::memory_order_relaxed);
+        m_exceededDocumentDepth.store(false, std::memory_order_relaxed);
+        m_exceededConstraintEvaluations.store(false, std::memory_order_relaxed);
+        m_exceededRegexExecutions.store(false, std::memory_order_relaxed);
+    }
+
+private:
+
+    /// Greatest context depth permitted, or 0 for no limit
+    size_t m_maxDocumentDepth;
+
+    /// Number of constraint evaluations permitted, or 0 for no limit
+    size_t m_maxConstraintEvaluations;
+
+    /// Number of regex executions permitted, or 0 for no limit
+    size_t m_maxRegexExecutions;
+
+    /// Constraint evaluations charged so far
+    std::atomic<size_t> m_constraintEvaluations;
+
+    /// Regex executions charged so far
+    std::atomic<size_t> m_regexExecutions;
+
+    /// Latched when the corresponding limit is crossed
+    std::atomic<bool> m_exceededDocumentDepth;
+    std::atomic<bool> m_exceededConstraintEvaluations;
+    std::atomic<bool> m_exceededRegexExecutions;
+};
+
+}  // namespace valijson
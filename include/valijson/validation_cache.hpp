@@ -0,0 +1,184 @@
+/**
+ * @file
+ *
+ * @brief   Memoization of validation outcomes for repeated identical subtrees
+ *
+ * Documents that denormalize reference data often contain thousands of
+ * copies of the same small object, and the validator re-validates every
+ * copy from scratch. The ValidationCache defined here lets a validate call
+ * remember, per sub-schema, the outcome of validating a small subtree, so
+ * that later occurrences of a structurally identical subtree under the
+ * same sub-schema are resolved by a single lookup.
+ *
+ * Entries are keyed on the sub-schema's identity together with the
+ * subtree's canonical compact encoding - the same adapter-independent
+ * encoding used to hash-cons frozen values - so two subtrees share an
+ * entry exactly when they are structurally equal. Keying on the full
+ * encoding rather than a hash of it means a collision can never cause a
+ * wrong outcome to be returned. Subtrees whose encoding would exceed the
+ * configured size limit are not cached; for large subtrees the cost of
+ * encoding and storing the key would rival re-validation, and repeated
+ * identical subtrees are overwhelmingly small.
+ *
+ * The cache is not thread-safe; runs that evaluate combinator branches in
+ * parallel bypass it on those branches.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <unordered_map>
+
+#include <valijson/internal/json_hash.hpp>
+
+namespace valijson {
+
+class Subschema;
+
+/**
+ * @brief  Cache of validation outcomes for small subtrees
+ *
+ * A cache is handed to a validate call, which consults it before
+ * validating an array or object subtree and records the outcome
+ * afterwards. Cached outcomes are only trusted within the run that
+ * produced them: the validate overload taking a cache resets it at the
+ * start of each call, so entries never leak between documents or between
+ * schemas.
+ *
+ * Only the boolean outcome is cached. When a run is collecting errors,
+ * a cached failure is ignored and the subtree is re-validated, so that
+ * the error descriptions and locations reported for each occurrence are
+ * exactly those a run without the cache would produce.
+ */
+class ValidationCache
+{
+public:
+
+    /// Default limit on the encoded size of a cacheable subtree, in bytes
+    static const size_t kDefaultMaxEncodingBytes = 256;
+
+    /**
+     * @brief  Construct a cache for subtrees up to a given encoded size
+     *
+     * @param  maxEncodingBytes  greatest encoded size, in bytes, of a
+     *                           subtree worth caching
+     */
+    explicit ValidationCache(size_t maxEncodingBytes = kDefaultMaxEncodingBytes)
+      : m_maxEncodingBytes(maxEncodingBytes),
+        m_hits(0),
+        m_misses(0) { }
+
+    ValidationCache(const ValidationCache &) = delete;
+    ValidationCache & operator=(const ValidationCache &) = delete;
+
+    /// Greatest encoded size, in bytes, of a subtree worth caching
+    size_t maxEncodingBytes() const
+    {
+        return m_maxEncodingBytes;
+    }
+
+    /**
+     * @brief  Look up the cached outcome of validating a subtree
+     *
+     * @param  subschema  sub-schema the subtree is being validated against
+     * @param  encoding   canonical compact encoding of the subtree
+     * @param  outcome    reference that receives the cached outcome
+     *
+     * @returns  true if an outcome was found for the subtree
+     */
+    bool lookup(const Subschema *subschema, const std::string &encoding,
+            bool &outcome)
+    {
+        const Entries::const_iterator itr =
+                m_entries.find(Key(subschema, encoding));
+        if (itr == m_entries.end()) {
+            m_misses++;
+            return false;
+        }
+
+        m_hits++;
+        outcome = itr->second;
+        return true;
+    }
+
+    /**
+     * @brief  Record the outcome of validating a subtree
+     *
+     * @param  subschema  sub-schema the subtree was validated against
+     * @param  encoding   canonical compact encoding of the subtree
+     * @param  outcome    outcome of validating the subtree
+     */
+    void store(const Subschema *subschema, std::string encoding, bool outcome)
+    {
+        m_entries.insert(Entries::value_type(
+                Key(subschema, std::move(encoding)), outcome));
+    }
+
+    /// Number of lookups that found a cached outcome
+    size_t hits() const
+    {
+        return m_hits;
+    }
+
+    /// Number of lookups that did not find a cached outcome
+    size_t misses() const
+    {
+        return m_misses;
+    }
+
+    /// Number of outcomes currently cached
+    size_t size() const
+    {
+        return m_entries.size();
+    }
+
+    /**
+     * @brief  Discard all cached outcomes and clear the hit and miss
+     *         counts, retaining the configured size limit
+     *
+     * Called at the start of each validate call that uses the cache, since
+     * an outcome cached for one schema/document pair says nothing about
+     * another.
+     */
+    void reset()
+    {
+        m_entries.clear();
+        m_hits = 0;
+        m_misses = 0;
+    }
+
+private:
+
+    /// Identity of a cached subtree: the sub-schema it was validated
+    /// against and its canonical compact encoding
+    typedef std::pair<const Subschema *, std::string> Key;
+
+    struct KeyHash
+    {
+        size_t operator()(const Key &key) const
+        {
+            return internal::combineHash(
+                    std::hash<const Subschema *>()(key.first),
+                    internal::hashBytes(key.second.data(),
+                            key.second.size()));
+        }
+    };
+
+    typedef std::unordered_map<Key, bool, KeyHash> Entries;
+
+    /// Greatest encoded size, in bytes, of a subtree worth caching
+    size_t m_maxEncodingBytes;
+
+    /// Cached outcomes
+    Entries m_entries;
+
+    /// Number of lookups that found a cached outcome
+    size_t m_hits;
+
+    /// Number of lookups that did not
+    size_t m_misses;
+};
+
+}  // namespace valijson
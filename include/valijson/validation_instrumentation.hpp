@@ -0,0 +1,637 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+#include <valijson/constraints/constraint.hpp>
+#include <valijson/constraints/constraint_visitor.hpp>
+
+namespace valijson {
+
+class Subschema;
+
+/**
+ * @brief  Per-constraint-type counters collected while validating
+ *
+ * One slot is maintained for each kind of constraint. The invocation count
+ * records how many times a constraint of that kind was evaluated, and the
+ * accumulated time records how long those evaluations took, measured with
+ * the steady clock. Times are inclusive: a structural constraint such as
+ * 'properties' includes the time spent evaluating the constraints of its
+ * child schemas.
+ *
+ * This is a plain struct so that its counters can be exported directly to
+ * an external metrics system.
+ */
+struct ValidationStats
+{
+    /// Identifies the kind of constraint that a counter slot belongs to
+    enum ConstraintType
+    {
+        kAllOf = 0,
+        kAnyOf,
+        kConditional,
+        kConst,
+        kContains,
+        kDependencies,
+        kEnum,
+        kFormat,
+        kFusedObject,
+        kLinearItems,
+        kMaximum,
+        kMaxItems,
+        kMaxLength,
+        kMaxProperties,
+        kMinimum,
+        kMinItems,
+        kMinLength,
+        kMinProperties,
+        kMultipleOfDouble,
+        kMultipleOfInt,
+        kNot,
+        kOneOf,
+        kPattern,
+        kPoly,
+        kProperties,
+        kPropertyNames,
+        kRequired,
+        kSingularItems,
+        kType,
+        kUniqueItems,
+        kNumConstraintTypes
+    };
+
+    ValidationStats()
+    {
+        reset();
+    }
+
+    /// Reset all counters to zero
+    void reset()
+    {
+        for (size_t i = 0; i < kNumConstraintTypes; i++) {
+            invocations[i] = 0;
+            totalNanoseconds[i] = 0;
+        }
+    }
+
+    /// Total number of constraint evaluations across all kinds
+    uint64_t totalInvocations() const
+    {
+        uint64_t total = 0;
+        for (size_t i = 0; i < kNumConstraintTypes; i++) {
+            total += invocations[i];
+        }
+        return total;
+    }
+
+    /**
+     * @brief  Return the schema keyword-style name for a counter slot
+     *
+     * @param  index  one of the ConstraintType values
+     *
+     * @returns  name suitable for use as a metric label
+     */
+    static const char * constraintTypeName(size_t index)
+    {
+        static const char * const names[kNumConstraintTypes] = {
+            "allOf",
+            "anyOf",
+            "conditional",
+            "const",
+            "contains",
+            "dependencies",
+            "enum",
+            "format",
+            "fusedObject",
+            "linearItems",
+            "maximum",
+            "maxItems",
+            "maxLength",
+            "maxProperties",
+            "minimum",
+            "minItems",
+            "minLength",
+            "minProperties",
+            "multipleOfDouble",
+            "multipleOfInt",
+            "not",
+            "oneOf",
+            "pattern",
+            "poly",
+            "properties",
+            "propertyNames",
+            "required",
+            "singularItems",
+            "type",
+            "uniqueItems"
+        };
+
+        return (index < kNumConstraintTypes) ? names[index] : "unknown";
+    }
+
+    /// Number of times a constraint of each kind was evaluated
+    uint64_t invocations[kNumConstraintTypes];
+
+    /// Accumulated evaluation time for each kind, in nanoseconds
+    uint64_t totalNanoseconds[kNumConstraintTypes];
+};
+
+/**
+ * @brief  Decorating visitor that times constraint evaluations
+ *
+ * Each visit is forwarded to an inner visitor, with the elapsed time and an
+ * invocation count recorded against the constraint's kind in a
+ * ValidationStats object.
+ *
+ * @tparam  InnerVisitor  visitor that evaluation is delegated to
+ */
+template<typename InnerVisitor>
+class ProfilingVisitor: public constraints::ConstraintVisitor
+{
+public:
+    ProfilingVisitor(InnerVisitor &inner, ValidationStats &stats)
+      : m_inner(inner),
+        m_stats(stats) { }
+
+    bool visit(const AllOfConstraint &constraint) override
+    {
+        return record(ValidationStats::kAllOf, constraint);
+    }
+
+    bool visit(const AnyOfConstraint &constraint) override
+    {
+        return record(ValidationStats::kAnyOf, constraint);
+    }
+
+    bool visit(const ConditionalConstraint &constraint) override
+    {
+        return record(ValidationStats::kConditional, constraint);
+    }
+
+    bool visit(const ConstConstraint &constraint) override
+    {
+        return record(ValidationStats::kConst, constraint);
+    }
+
+    bool visit(const ContainsConstraint &constraint) override
+    {
+        return record(ValidationStats::kContains, constraint);
+    }
+
+    bool visit(const DependenciesConstraint &constraint) override
+    {
+        return record(ValidationStats::kDependencies, constraint);
+    }
+
+    bool visit(const EnumConstraint &constraint) override
+    {
+        return record(ValidationStats::kEnum, constraint);
+    }
+
+    bool visit(const FormatConstraint &constraint) override
+    {
+        return record(ValidationStats::kFormat, constraint);
+    }
+
+    bool visit(const FusedObjectConstraint &constraint) override
+    {
+        return record(ValidationStats::kFusedObject, constraint);
+    }
+
+    bool visit(const LinearItemsConstraint &constraint) override
+    {
+        return record(ValidationStats::kLinearItems, constraint);
+    }
+
+    bool visit(const MaximumConstraint &constraint) override
+    {
+        return record(ValidationStats::kMaximum, constraint);
+    }
+
+    bool visit(const MaxItemsConstraint &constraint) override
+    {
+        return record(ValidationStats::kMaxItems, constraint);
+    }
+
+    bool visit(const MaxLengthConstraint &constraint) override
+    {
+        return record(ValidationStats::kMaxLength, constraint);
+    }
+
+    bool visit(const MaxPropertiesConstraint &constraint) override
+    {
+        return record(ValidationStats::kMaxProperties, constraint);
+    }
+
+    bool visit(const MinimumConstraint &constraint) override
+    {
+        return record(ValidationStats::kMinimum, constraint);
+    }
+
+    bool visit(const MinItemsConstraint &constraint) override
+    {
+        return record(ValidationStats::kMinItems, constraint);
+    }
+
+    bool visit(const MinLengthConstraint &constraint) override
+    {
+        return record(ValidationStats::kMinLength, constraint);
+    }
+
+    bool visit(const MinPropertiesConstraint &constraint) override
+    {
+        return record(ValidationStats::kMinProperties, constraint);
+    }
+
+    bool visit(const MultipleOfDoubleConstraint &constraint) override
+    {
+        return record(ValidationStats::kMultipleOfDouble, constraint);
+    }
+
+    bool visit(const MultipleOfIntConstraint &constraint) override
+    {
+        return record(ValidationStats::kMultipleOfInt, constraint);
+    }
+
+    bool visit(const NotConstraint &constraint) override
+    {
+        return record(ValidationStats::kNot, constraint);
+    }
+
+    bool visit(const OneOfConstraint &constraint) override
+    {
+        return record(ValidationStats::kOneOf, constraint);
+    }
+
+    bool visit(const PatternConstraint &constraint) override
+    {
+        return record(ValidationStats::kPattern, constraint);
+    }
+
+    bool visit(const PolyConstraint &constraint) override
+    {
+        return record(ValidationStats::kPoly, constraint);
+    }
+
+    bool visit(const PropertiesConstraint &constraint) override
+    {
+        return record(ValidationStats::kProperties, constraint);
+    }
+
+    bool visit(const PropertyNamesConstraint &constraint) override
+    {
+        return record(ValidationStats::kPropertyNames, constraint);
+    }
+
+    bool visit(const RequiredConstraint &constraint) override
+    {
+        return record(ValidationStats::kRequired, constraint);
+    }
+
+    bool visit(const SingularItemsConstraint &constraint) override
+    {
+        return record(ValidationStats::kSingularItems, constraint);
+    }
+
+    bool visit(const TypeConstraint &constraint) override
+    {
+        return record(ValidationStats::kType, constraint);
+    }
+
+    bool visit(const UniqueItemsConstraint &constraint) override
+    {
+        return record(ValidationStats::kUniqueItems, constraint);
+    }
+
+private:
+
+    template<typename ConstraintType>
+    bool record(ValidationStats::ConstraintType type, const ConstraintType &constraint)
+    {
+        const std::chrono::steady_clock::time_point begin =
+                std::chrono::steady_clock::now();
+
+        const bool result = m_inner.visit(constraint);
+
+        m_stats.invocations[type]++;
+        m_stats.totalNanoseconds[type] +=
+                std::chrono::duration_cast<std::chrono::nanoseconds>(
+                        std::chrono::steady_clock::now() - begin).count();
+
+        return result;
+    }
+
+    /// Visitor that evaluation is delegated to
+    InnerVisitor &m_inner;
+
+    /// Counters that evaluations are recorded against
+    ValidationStats &m_stats;
+};
+
+
+/**
+ * @brief  Decorating visitor that emits constraint span events
+ *
+ * Each visit is bracketed by enterConstraint/leaveConstraint events on the
+ * trace sink, identified by the same constraint-kind enumeration that
+ * ValidationStats uses, and forwarded to an inner visitor. Spans nest:
+ * a structural constraint such as 'properties' stays open while the
+ * constraints of its child schemas are evaluated.
+ *
+ * @tparam  InnerVisitor  visitor that evaluation is delegated to
+ * @tparam  TraceSink     sink that span events are emitted to
+ */
+template<typename InnerVisitor, typename TraceSink>
+class TracingVisitor: public constraints::ConstraintVisitor
+{
+public:
+    TracingVisitor(InnerVisitor &inner, TraceSink &sink)
+      : m_inner(inner),
+        m_sink(sink) { }
+
+    bool visit(const AllOfConstraint &constraint) override
+    {
+        return record(ValidationStats::kAllOf, constraint);
+    }
+
+    bool visit(const AnyOfConstraint &constraint) override
+    {
+        return record(ValidationStats::kAnyOf, constraint);
+    }
+
+    bool visit(const ConditionalConstraint &constraint) override
+    {
+        return record(ValidationStats::kConditional, constraint);
+    }
+
+    bool visit(const ConstConstraint &constraint) override
+    {
+        return record(ValidationStats::kConst, constraint);
+    }
+
+    bool visit(const ContainsConstraint &constraint) override
+    {
+        return record(ValidationStats::kContains, constraint);
+    }
+
+    bool visit(const DependenciesConstraint &constraint) override
+    {
+        return record(ValidationStats::kDependencies, constraint);
+    }
+
+    bool visit(const EnumConstraint &constraint) override
+    {
+        return record(ValidationStats::kEnum, constraint);
+    }
+
+    bool visit(const FormatConstraint &constraint) override
+    {
+        return record(ValidationStats::kFormat, constraint);
+    }
+
+    bool visit(const FusedObjectConstraint &constraint) override
+    {
+        return record(ValidationStats::kFusedObject, constraint);
+    }
+
+    bool visit(const LinearItemsConstraint &constraint) override
+    {
+        return record(ValidationStats::kLinearItems, constraint);
+    }
+
+    bool visit(const MaximumConstraint &constraint) override
+    {
+        return record(ValidationStats::kMaximum, constraint);
+    }
+
+    bool visit(const MaxItemsConstraint &constraint) override
+    {
+        return record(ValidationStats::kMaxItems, constraint);
+    }
+
+    bool visit(const MaxLengthConstraint &constraint) override
+    {
+        return record(ValidationStats::kMaxLength, constraint);
+    }
+
+    bool visit(const MaxPropertiesConstraint &constraint) override
+    {
+        return record(ValidationStats::kMaxProperties, constraint);
+    }
+
+    bool visit(const MinimumConstraint &constraint) override
+    {
+        return record(ValidationStats::kMinimum, constraint);
+    }
+
+    bool visit(const MinItemsConstraint &constraint) override
+    {
+        return record(ValidationStats::kMinItems, constraint);
+    }
+
+    bool visit(const MinLengthConstraint &constraint) override
+    {
+        return record(ValidationStats::kMinLength, constraint);
+    }
+
+    bool visit(const MinPropertiesConstraint &constraint) override
+    {
+        return record(ValidationStats::kMinProperties, constraint);
+    }
+
+    bool visit(const MultipleOfDoubleConstraint &constraint) override
+    {
+        return record(ValidationStats::kMultipleOfDouble, constraint);
+    }
+
+    bool visit(const MultipleOfIntConstraint &constraint) override
+    {
+        return record(ValidationStats::kMultipleOfInt, constraint);
+    }
+
+    bool visit(const NotConstraint &constraint) override
+    {
+        return record(ValidationStats::kNot, constraint);
+    }
+
+    bool visit(const OneOfConstraint &constraint) override
+    {
+        return record(ValidationStats::kOneOf, constraint);
+    }
+
+    bool visit(const PatternConstraint &constraint) override
+    {
+        return record(ValidationStats::kPattern, constraint);
+    }
+
+    bool visit(const PolyConstraint &constraint) override
+    {
+        return record(ValidationStats::kPoly, constraint);
+    }
+
+    bool visit(const PropertiesConstraint &constraint) override
+    {
+        return record(ValidationStats::kProperties, constraint);
+    }
+
+    bool visit(const PropertyNamesConstraint &constraint) override
+    {
+        return record(ValidationStats::kPropertyNames, constraint);
+    }
+
+    bool visit(const RequiredConstraint &constraint) override
+    {
+        return record(ValidationStats::kRequired, constraint);
+    }
+
+    bool visit(const SingularItemsConstraint &constraint) override
+    {
+        return record(ValidationStats::kSingularItems, constraint);
+    }
+
+    bool visit(const TypeConstraint &constraint) override
+    {
+        return record(ValidationStats::kType, constraint);
+    }
+
+    bool visit(const UniqueItemsConstraint &constraint) override
+    {
+        return record(ValidationStats::kUniqueItems, constraint);
+    }
+
+private:
+
+    template<typename ConstraintType>
+    bool record(ValidationStats::ConstraintType type, const ConstraintType &constraint)
+    {
+        m_sink.enterConstraint(type);
+        const bool result = m_inner.visit(constraint);
+        m_sink.leaveConstraint(type, result);
+        return result;
+    }
+
+    /// Visitor that evaluation is delegated to
+    InnerVisitor &m_inner;
+
+    /// Sink that span events are emitted to
+    TraceSink &m_sink;
+};
+
+/**
+ * @brief  Default instrumentation policy, which records nothing
+ *
+ * Dispatch forwards straight to the constraint's accept function, so a
+ * build that uses this policy generates exactly the code it did before the
+ * instrumentation hook existed.
+ */
+struct NoInstrumentation
+{
+    template<typename VisitorType>
+    bool dispatch(const constraints::Constraint &constraint, VisitorType &visitor) const
+    {
+        return constraint.accept(visitor);
+    }
+};
+
+/**
+ * @brief  Instrumentation policy that records per-constraint-type counters
+ *
+ * When bound to a ValidationStats object, each constraint evaluation is
+ * dispatched through a ProfilingVisitor which counts and times it. A
+ * default-constructed instance is inert, and dispatches directly.
+ */
+class ProfilingInstrumentation
+{
+public:
+    ProfilingInstrumentation()
+      : m_stats(nullptr) { }
+
+    explicit ProfilingInstrumentation(ValidationStats &stats)
+      : m_stats(&stats) { }
+
+    template<typename VisitorType>
+    bool dispatch(const constraints::Constraint &constraint, VisitorType &visitor) const
+    {
+        if (!m_stats) {
+            return constraint.accept(visitor);
+        }
+
+        ProfilingVisitor<VisitorType> profilingVisitor(visitor, *m_stats);
+        return constraint.accept(profilingVisitor);
+    }
+
+private:
+    /// Counters that evaluations are recorded against; may be nullptr
+    ValidationStats *m_stats;
+};
+
+/**
+ * @brief  Instrumentation policy that emits validation span events
+ *
+ * Every template instantiation of the validator collapses into the same
+ * few frames in a sampled profile, so flamegraphs cannot say which part of
+ * a schema is hot. This policy brackets each sub-schema visit and each
+ * constraint evaluation with enter/leave events on a user-provided sink,
+ * letting an external tracer attribute cycles to schema locations.
+ *
+ * The sink must provide:
+ *
+ *     void enterSubschema(const Subschema &subschema);
+ *     void leaveSubschema(const Subschema &subschema, bool result);
+ *     void enterConstraint(ValidationStats::ConstraintType type);
+ *     void leaveConstraint(ValidationStats::ConstraintType type, bool result);
+ *
+ * Sub-schema events carry the Subschema itself, so a sink can label spans
+ * with getId() or getTitle(); constraint kinds can be labelled with
+ * ValidationStats::constraintTypeName(). A sink implementation is free to
+ * forward events to static tracepoints (USDT probes), write a folded-stack
+ * trace for flamegraph tooling, or feed an in-process profiler.
+ *
+ * A default-constructed instance is inert and dispatches directly; builds
+ * that use the default NoInstrumentation policy are unaffected entirely.
+ */
+template<typename TraceSink>
+class TracingInstrumentation
+{
+public:
+    TracingInstrumentation()
+      : m_sink(nullptr) { }
+
+    explicit TracingInstrumentation(TraceSink &sink)
+      : m_sink(&sink) { }
+
+    template<typename VisitorType>
+    bool dispatch(const constraints::Constraint &constraint, VisitorType &visitor) const
+    {
+        if (!m_sink) {
+            return constraint.accept(visitor);
+        }
+
+        TracingVisitor<VisitorType, TraceSink> tracingVisitor(visitor, *m_sink);
+        return constraint.accept(tracingVisitor);
+    }
+
+    /// Called by the validator when it begins visiting a sub-schema
+    void enterSubschema(const Subschema &subschema) const
+    {
+        if (m_sink) {
+            m_sink->enterSubschema(subschema);
+        }
+    }
+
+    /// Called by the validator when a sub-schema visit completes
+    void leaveSubschema(const Subschema &subschema, bool result) const
+    {
+        if (m_sink) {
+            m_sink->leaveSubschema(subschema, result);
+        }
+    }
+
+private:
+    /// Sink that span events are emitted to; may be nullptr
+    TraceSink *m_sink;
+};
+
+}  // namespace valijson
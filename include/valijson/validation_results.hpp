@@ -1,23 +1,75 @@
 #pragma once
 
-#include <deque>
 #include <string>
 #include <utility>
 #include <vector>
 
+#include <valijson/internal/small_vector.hpp>
+#include <valijson/internal/validation_context.hpp>
+
 namespace valijson {
 
+class Subschema;
+
 /**
  * @brief  Class that encapsulates the storage of validation errors.
  *
  * This class maintains an internal FIFO queue of errors that are reported
  * during validation. Errors are pushed on to the back of an internal
  * queue, and can retrieved by popping them from the front of the queue.
+ *
+ * Each error carries a structured error code identifying the kind of
+ * constraint that failed, alongside the human-readable description.
+ * Construction of description strings can be disabled entirely for
+ * consumers that only need the code and the location of the failure, which
+ * avoids most of the per-error string allocations on error-heavy
+ * workloads.
+ *
+ * A ValidationResults object can be reused across documents by calling
+ * clear() between validation runs. Error slots, and the string buffers
+ * within them, are recycled rather than destroyed, so a long-lived
+ * per-thread results object stops allocating once its storage has grown to
+ * the high-water mark of its workload; reserve() preallocates the slots up
+ * front.
  */
 class ValidationResults
 {
 public:
 
+    /**
+     * @brief  Identifies the kind of constraint that produced an error
+     */
+    enum ErrorCode
+    {
+        kUnspecified = 0,
+        kAnyOfFailed,
+        kBudgetExceeded,
+        kConditionalFailed,
+        kConstMismatch,
+        kContainsFailed,
+        kDependenciesFailed,
+        kEnumMismatch,
+        kFormatMismatch,
+        kItemsFailed,
+        kMaximumExceeded,
+        kMaxItemsExceeded,
+        kMaxLengthExceeded,
+        kMaxPropertiesExceeded,
+        kMinimumNotReached,
+        kMinItemsNotReached,
+        kMinLengthNotReached,
+        kMinPropertiesNotReached,
+        kMultipleOfMismatch,
+        kNotFailed,
+        kOneOfFailed,
+        kPatternMismatch,
+        kPropertiesFailed,
+        kPropertyNamesFailed,
+        kRequiredMissing,
+        kTypeMismatch,
+        kUniqueItemsViolated
+    };
+
     /**
      * @brief  Describes a validation error.
      *
@@ -26,27 +78,196 @@ public:
      */
     struct Error
     {
+        Error()
+          : code(kUnspecified),
+            subschema(nullptr) { }
+
+        Error(std::vector<std::string> contextArg, std::string descriptionArg)
+          : context(std::move(contextArg)),
+            description(std::move(descriptionArg)),
+            code(kUnspecified),
+            subschema(nullptr) { }
+
         /// Path to the node that failed validation.
         std::vector<std::string> context;
 
-        /// A detailed description of the validation error.
+        /// A detailed description of the validation error. Empty when the
+        /// owning ValidationResults was constructed with description
+        /// collection disabled.
         std::string description;
+
+        /// Kind of constraint that produced this error.
+        ErrorCode code;
+
+        /// Sub-schema that the node failed to validate against, where one
+        /// was involved; may be nullptr.
+        const Subschema *subschema;
+
+        /**
+         * @brief  Render the location of this error as a JSON Pointer
+         *
+         * The pointer is built on demand from the context path, with '~'
+         * and '/' characters in property names escaped as required by
+         * RFC 6901. An error at the document root yields an empty string.
+         */
+        std::string jsonPointer() const
+        {
+            std::string pointer;
+            for (size_t i = 1; i < context.size(); i++) {
+                const std::string &segment = context[i];
+                pointer += '/';
+
+                // Context strings have the form '[name]' or '[index]'
+                for (size_t j = 1; j + 1 < segment.size(); j++) {
+                    if (segment[j] == '~') {
+                        pointer += "~0";
+                    } else if (segment[j] == '/') {
+                        pointer += "~1";
+                    } else {
+                        pointer += segment[j];
+                    }
+                }
+            }
+
+            return pointer;
+        }
     };
 
+    /**
+     * @brief  Construct a ValidationResults that collects descriptions
+     */
+    ValidationResults()
+      : m_collectDescriptions(true),
+        m_maxErrors(0),
+        m_numErrors(0),
+        m_firstError(0),
+        m_cancelled(false),
+        m_budgetExceeded(false) { }
+
+    /**
+     * @brief  Construct a ValidationResults, optionally without descriptions
+     *
+     * @param  collectDescriptions  when false, the description field of
+     *                              reported errors is left empty and the
+     *                              cost of formatting the message strings
+     *                              is avoided; error codes and context
+     *                              paths are unaffected
+     * @param  maxErrors            stop collecting after this many errors,
+     *                              or 0 for no limit; validation also stops
+     *                              evaluating further constraints once the
+     *                              budget is exhausted
+     */
+    explicit ValidationResults(bool collectDescriptions, size_t maxErrors = 0)
+      : m_collectDescriptions(collectDescriptions),
+        m_maxErrors(maxErrors),
+        m_numErrors(0),
+        m_firstError(0),
+        m_cancelled(false),
+        m_budgetExceeded(false) { }
+
+    /**
+     * @brief  Limit the number of errors collected
+     *
+     * Once the limit has been reached, further calls to pushError are
+     * ignored, and the validator stops evaluating constraints whose only
+     * purpose would be to report additional errors. A limit of 0 means no
+     * limit.
+     *
+     * @param  maxErrors  maximum number of errors to collect
+     */
+    void setMaxErrors(size_t maxErrors)
+    {
+        m_maxErrors = maxErrors;
+    }
+
+    /// Returns true if the error budget has been exhausted
+    bool errorBudgetExhausted() const
+    {
+        return m_maxErrors != 0 && numErrors() >= m_maxErrors;
+    }
+
+    /**
+     * @brief  Record that the validation run was cancelled
+     *
+     * Set by the validator when a run is abandoned because its
+     * CancellationToken was cancelled or its deadline expired. A cancelled
+     * run reports failure, so this flag is what distinguishes a cancelled
+     * run from a document that genuinely failed validation.
+     */
+    void markCancelled()
+    {
+        m_cancelled = true;
+    }
+
+    /// Returns true if the validation run was cancelled before completing
+    bool cancelled() const
+    {
+        return m_cancelled;
+    }
+
+    /**
+     * @brief  Record that the validation run exceeded its budget
+     *
+     * Set by the validator when a run is abandoned because a limit on its
+     * ValidationBudget was crossed. A run that exceeds its budget reports
+     * failure, so this flag is what distinguishes an over-budget run from
+     * a document that genuinely failed validation.
+     */
+    void markBudgetExceeded()
+    {
+        m_budgetExceeded = true;
+    }
+
+    /// Returns true if the validation run exceeded its budget
+    bool budgetExceeded() const
+    {
+        return m_budgetExceeded;
+    }
+
+    /**
+     * @brief  Preallocate storage for a number of errors
+     *
+     * @param  capacity  number of error slots to allocate up front
+     */
+    void reserve(size_t capacity)
+    {
+        m_errors.reserve(capacity);
+    }
+
+    /**
+     * @brief  Reset this object so that it can be reused for another
+     *         validation run
+     *
+     * Pending errors are discarded and the cancelled and budget-exceeded
+     * flags are cleared. The
+     * error slots themselves, including the string buffers held by their
+     * context paths and descriptions, are retained and recycled by
+     * subsequent validation runs. The retained storage reflects the
+     * high-water mark of the runs seen so far; destroy the object to
+     * release it.
+     */
+    void clear()
+    {
+        m_numErrors = 0;
+        m_firstError = 0;
+        m_cancelled = false;
+        m_budgetExceeded = false;
+    }
+
     /**
      * @brief  Return begin iterator for results in the queue.
      */
-    std::deque<Error>::const_iterator begin() const
+    const Error * begin() const
     {
-        return m_errors.begin();
+        return m_errors.begin() + m_firstError;
     }
 
     /**
      * @brief  Return end iterator for results in the queue.
      */
-    std::deque<Error>::const_iterator end() const
+    const Error * end() const
     {
-        return m_errors.end();
+        return m_errors.begin() + m_numErrors;
     }
 
     /**
@@ -54,7 +275,7 @@ public:
      */
     size_t numErrors() const
     {
-        return m_errors.size();
+        return m_numErrors - m_firstError;
     }
 
     /**
@@ -64,7 +285,11 @@ public:
      */
     void pushError(const Error &error)
     {
-        m_errors.push_back(error);
+        if (errorBudgetExhausted()) {
+            return;
+        }
+
+        nextError() = error;
     }
 
     /**
@@ -76,7 +301,73 @@ public:
     void
     pushError(const std::vector<std::string> &context, const std::string &description)
     {
-        m_errors.push_back({context, description});
+        if (errorBudgetExhausted()) {
+            return;
+        }
+
+        Error &error = nextError();
+        error.context = context;
+        error.description = description;
+        error.code = kUnspecified;
+        error.subschema = nullptr;
+    }
+
+    /**
+     * @brief  Push an error onto the back of the queue.
+     *
+     * The path strings for the error are materialised from the chain of
+     * context frames maintained during validation.
+     *
+     * @param  context      Context frame for the validation error.
+     * @param  description  Description of the validation error.
+     */
+    void
+    pushError(const internal::ValidationContext &context, const std::string &description)
+    {
+        if (errorBudgetExhausted()) {
+            return;
+        }
+
+        Error &error = nextError();
+        context.materializeInto(error.context);
+        error.description = description;
+        error.code = kUnspecified;
+        error.subschema = nullptr;
+    }
+
+    /**
+     * @brief  Push a structured error onto the back of the queue.
+     *
+     * The description is produced by a functor that is only invoked when
+     * description collection is enabled, so that callers can defer the
+     * cost of formatting the message string until it is known to be
+     * needed.
+     *
+     * @param  context        Context frame for the validation error.
+     * @param  code           Kind of constraint that failed.
+     * @param  descriptionFn  Functor returning the description string.
+     * @param  subschema      Optional sub-schema that the node failed to
+     *                        validate against.
+     */
+    template<typename DescriptionFn>
+    void
+    pushError(const internal::ValidationContext &context, ErrorCode code,
+            const DescriptionFn &descriptionFn,
+            const Subschema *subschema = nullptr)
+    {
+        if (errorBudgetExhausted()) {
+            return;
+        }
+
+        Error &error = nextError();
+        context.materializeInto(error.context);
+        if (m_collectDescriptions) {
+            error.description = descriptionFn();
+        } else {
+            error.description.clear();
+        }
+        error.code = code;
+        error.subschema = subschema;
     }
 
     /**
@@ -89,19 +380,69 @@ public:
     bool
     popError(Error &error)
     {
-        if (m_errors.empty()) {
+        if (m_firstError == m_numErrors) {
             return false;
         }
 
-        error = m_errors.front();
-        m_errors.pop_front();
+        error = m_errors[m_firstError];
+        m_firstError++;
+
+        // Recycle the slots once the queue has been fully drained; the
+        // Error objects and their string buffers are retained
+        if (m_firstError == m_numErrors) {
+            m_numErrors = 0;
+            m_firstError = 0;
+        }
+
         return true;
     }
 
 private:
 
-    /// FIFO queue of validation errors that have been reported
-    std::deque<Error> m_errors;
+    /**
+     * @brief  Return the slot for the next error, recycling where possible
+     *
+     * Slots freed by clear(), or by draining the queue, are reused in
+     * place, so the strings held by a recycled slot keep their buffers and
+     * assignment into them usually allocates nothing. A fresh slot is
+     * constructed only above the high-water mark.
+     */
+    Error & nextError()
+    {
+        if (m_numErrors == m_errors.size()) {
+            m_errors.push_back(Error());
+        }
+
+        return m_errors[m_numErrors++];
+    }
+
+    /// Whether description strings should be rendered for new errors
+    bool m_collectDescriptions;
+
+    /// Maximum number of errors to collect, or 0 for no limit
+    size_t m_maxErrors;
+
+    /// Number of slots in m_errors that hold live errors; slots beyond
+    /// this index have been recycled and await reuse
+    size_t m_numErrors;
+
+    /// Errors that have been reported; inline storage covers the common
+    /// case of a validation run that produces only a few errors. Slots are
+    /// recycled rather than destroyed when the object is cleared, so the
+    /// vector's size tracks the high-water mark rather than the current
+    /// number of errors
+    internal::SmallVector<Error, 4> m_errors;
+
+    /// Index of the logical front of the queue; errors before this index
+    /// have been popped
+    size_t m_firstError;
+
+    /// Whether the validation run was abandoned due to cancellation
+    bool m_cancelled;
+
+    /// Whether the validation run was abandoned because its budget was
+    /// exceeded
+    bool m_budgetExceeded;
 };
 
 } // namespace valijson
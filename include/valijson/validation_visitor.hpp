@@ -1,14 +1,27 @@
 #pragma once
 
+#include <algorithm>
 #include <cmath>
 #include <string>
 #include <regex>
+#include <set>
+#include <type_traits>
 #include <unordered_map>
+#include <vector>
 
 #include <valijson/adapters/std_string_adapter.hpp>
+#include <valijson/cancellation.hpp>
+#include <valijson/validation_budget.hpp>
+#include <valijson/validation_cache.hpp>
 #include <valijson/constraints/concrete_constraints.hpp>
 #include <valijson/constraints/constraint_visitor.hpp>
 #include <utility>
+#include <valijson/internal/compact_frozen_value.hpp>
+#include <valijson/internal/json_hash.hpp>
+#include <valijson/internal/validation_context.hpp>
+#include <valijson/parallel_executor.hpp>
+#include <valijson/scratch_arena.hpp>
+#include <valijson/validation_instrumentation.hpp>
 #include <valijson/validation_results.hpp>
 
 #include <valijson/utils/utf8_utils.hpp>
@@ -26,9 +39,16 @@ class ValidationResults;
  * @brief   Implementation of the ConstraintVisitor interface that validates a
  *          target document
  *
- * @tparam  AdapterType  Adapter type for the target document.
+ * @tparam  AdapterType      Adapter type for the target document.
+ * @tparam  RegexEngine      Regular expression engine used for pattern
+ *                           constraint validation.
+ * @tparam  Instrumentation  Policy through which constraint evaluations are
+ *                           dispatched; the default policy forwards directly
+ *                           and adds no overhead, while
+ *                           ProfilingInstrumentation records per-constraint
+ *                           counters and timings.
  */
-template<typename AdapterType, typename RegexEngine>
+template<typename AdapterType, typename RegexEngine, typename Instrumentation = NoInstrumentation>
 class ValidationVisitor: public constraints::ConstraintVisitor
 {
 public:
@@ -37,26 +57,59 @@ public:
      * @brief  Construct a new validator for a given target value and context.
      *
      * @param  target       Target value to be validated
-     * @param  context      Current context for validation error descriptions,
-     *                      only used if results is set.
+     * @param  context      Context frame for validation error descriptions;
+     *                      path strings are only materialised from the chain
+     *                      of frames when an error is recorded. The frame
+     *                      must outlive this visitor.
      * @param  strictTypes  Use strict type comparison
      * @param  results      Optional pointer to ValidationResults object, for
      *                      recording error descriptions. If this pointer is set
      *                      to nullptr, validation errors will caused validation to
      *                      stop immediately.
-     * @param  regexesCache Cache of already created RegexEngine objects for pattern
-     *                      constraints.
+     * @param  instrumentation  Optional instrumentation policy instance,
+     *                      through which constraint evaluations are
+     *                      dispatched
+     * @param  parallel     Optional parallel evaluation options; when an
+     *                      executor is provided, the branches of wide
+     *                      'oneOf' and 'anyOf' combinators are evaluated as
+     *                      a batch of tasks on that executor
+     * @param  scratch      Optional scratch arena from which transient
+     *                      containers are allocated; the caller is expected
+     *                      to reset it between validation runs
+     * @param  cancellation Optional cancellation token, polled at sub-schema
+     *                      boundaries; when cancellation is requested or the
+     *                      token's deadline expires, validation is abandoned
+     * @param  budget       Optional validation budget, charged as constraints
+     *                      and regexes are evaluated; when a limit is
+     *                      crossed, validation is abandoned at the next
+     *                      sub-schema boundary
+     * @param  memo         Optional memoization cache; small array and
+     *                      object subtrees are validated once per
+     *                      sub-schema, with repeated structurally identical
+     *                      occurrences resolved by lookup
      */
     ValidationVisitor(const AdapterType &target,
-                      std::vector<std::string> context,
+                      const internal::ValidationContext &context,
                       const bool strictTypes,
                       ValidationResults *results,
-                      std::unordered_map<std::string, RegexEngine>& regexesCache)
+                      Instrumentation instrumentation = Instrumentation(),
+                      ParallelOptions parallel = ParallelOptions(),
+                      ScratchArena *scratch = nullptr,
+                      CancellationToken *cancellation = nullptr,
+                      ValidationBudget *budget = nullptr,
+                      ValidationCache *memo = nullptr)
       : m_target(target),
-        m_context(std::move(context)),
+        m_context(context),
         m_results(results),
         m_strictTypes(strictTypes),
-        m_regexesCache(regexesCache) { }
+        m_instrumentation(instrumentation),
+        m_parallel(parallel),
+        m_scratch(scratch),
+        m_cancellation(cancellation),
+        m_budget(budget),
+        m_memo(memo),
+        m_lengthComputed(false),
+        m_cachedLength(0) { }
 
     /**
      * @brief  Validate the target against a schema.
@@ -75,35 +128,141 @@ public:
      */
     bool validateSchema(const Subschema &subschema)
     {
+        // Span hooks exist only for instrumentation policies that declare
+        // them; with the default policy both calls compile to nothing
+        enterSubschemaSpan(m_instrumentation, subschema, 0);
+        const bool result = validateSchemaImpl(subschema);
+        leaveSubschemaSpan(m_instrumentation, subschema, result, 0);
+        return result;
+    }
+
+private:
+
+    /// Body of validateSchema(), separated so that the public entry point
+    /// can bracket it with instrumentation span events
+    bool validateSchemaImpl(const Subschema &subschema)
+    {
+        if (cancellationRequested()) {
+            return false;
+        }
+
+        if (m_budget != nullptr && (m_budget->exceeded() ||
+                !m_budget->checkDocumentDepth(m_context.depth()))) {
+            return false;
+        }
+
         if (subschema.getAlwaysInvalid()) {
             return false;
         }
 
-        // Wrap the validationCallback() function below so that it will be
-        // passed a reference to a constraint (_1), and a reference to the
-        // visitor (*this).
-        Subschema::ApplyFunction fn(std::bind(validationCallback, std::placeholders::_1, std::ref(*this)));
+        // A sub-schema without constraints accepts any value, so there is
+        // nothing to dispatch
+        if (subschema.isAlwaysValid()) {
+            return true;
+        }
 
-        // Perform validation against each constraint defined in the schema
-        if (m_results == nullptr) {
-            // The applyStrict() function will return immediately if the
-            // callback function returns false
-            if (!subschema.applyStrict(fn)) {
-                return false;
+        // When a memoization cache is attached, small array and object
+        // subtrees are keyed on their canonical compact encoding, so a
+        // subtree that has already been validated against this sub-schema
+        // is resolved by lookup. A cached failure is only trusted when
+        // errors are not being collected; re-validating a failing subtree
+        // reproduces the error descriptions for this occurrence
+        std::string memoKey;
+        bool memoStorable = false;
+        if (m_memo != nullptr && (m_target.isArray() || m_target.isObject()) &&
+                adapters::CompactFrozenValue::encode(m_target, memoKey,
+                        m_memo->maxEncodingBytes())) {
+            bool outcome = false;
+            if (m_memo->lookup(&subschema, memoKey, outcome)) {
+                if (outcome || m_results == nullptr) {
+                    return outcome;
+                }
+            } else {
+                memoStorable = true;
             }
-        } else {
-            // The apply() function will iterate over all constraints in the
-            // schema, even if the callback function returns false. Once
-            // iteration is complete, the apply() function will return true
-            // only if all invokations of the callback function returned true.
-            if (!subschema.apply(fn)) {
+        }
+
+        // Dispatch to each constraint's accept() function through the
+        // instrumentation policy, without wrapping the callback in a
+        // type-erased std::function; the default policy forwards directly
+        const auto fn = [this](const constraints::Constraint &constraint) {
+            if (m_budget != nullptr && !m_budget->chargeConstraintEvaluation()) {
                 return false;
             }
+            return m_instrumentation.dispatch(constraint, *this);
+        };
+
+        // Perform validation against each constraint defined in the schema
+        bool validated = true;
+        if (m_results == nullptr) {
+            // The forEachConstraintStrict() function will return immediately
+            // if the callback function returns false
+            validated = subschema.forEachConstraintStrict(fn);
+        } else if (m_results->errorBudgetExhausted()) {
+            // Errors reported beyond the budget would be discarded, so the
+            // remaining constraints are evaluated in fail-fast mode
+            validated = subschema.forEachConstraintStrict(fn);
+        } else {
+            // Iterate over all constraints in the schema, even when the
+            // callback reports failure, so that all errors are collected;
+            // stop early if the results object's error budget is exhausted
+            // mid-way, since further errors would be discarded anyway
+            const auto boundedFn =
+                    [this, &validated, &fn](const constraints::Constraint &constraint) {
+                        if (!fn(constraint)) {
+                            validated = false;
+                        }
+                        return !m_results->errorBudgetExhausted();
+                    };
+            subschema.forEachConstraintStrict(boundedFn);
         }
 
-        return true;
+        // An outcome is only cached when the run completed; a failure
+        // caused by cancellation or budget exhaustion says nothing about
+        // the subtree itself
+        if (memoStorable && !cancellationRequested() &&
+                (m_budget == nullptr || !m_budget->exceeded())) {
+            m_memo->store(&subschema, std::move(memoKey), validated);
+        }
+
+        return validated;
     }
 
+    /**
+     * @brief  Notify the instrumentation policy that a sub-schema visit is
+     *         beginning
+     *
+     * This overload is selected, via expression SFINAE, for policies that
+     * declare an enterSubschema() member function.
+     */
+    template<typename Policy>
+    static auto enterSubschemaSpan(const Policy &policy,
+            const Subschema &subschema, int)
+            -> decltype(policy.enterSubschema(subschema))
+    {
+        return policy.enterSubschema(subschema);
+    }
+
+    /// Fallback for policies without span hooks, which compiles away
+    template<typename Policy>
+    static void enterSubschemaSpan(const Policy &, const Subschema &, long) { }
+
+    /// Counterpart of enterSubschemaSpan(), reporting the visit's result
+    template<typename Policy>
+    static auto leaveSubschemaSpan(const Policy &policy,
+            const Subschema &subschema, bool result, int)
+            -> decltype(policy.leaveSubschema(subschema, result))
+    {
+        return policy.leaveSubschema(subschema, result);
+    }
+
+    /// Fallback for policies without span hooks, which compiles away
+    template<typename Policy>
+    static void leaveSubschemaSpan(const Policy &, const Subschema &, bool,
+            long) { }
+
+public:
+
     /**
      * @brief  Validate a value against an AllOfConstraint
      *
@@ -124,6 +283,8 @@ public:
      */
     bool visit(const AllOfConstraint &constraint) override
     {
+        prefetchBranches(constraint);
+
         bool validated = true;
         constraint.applyToSubschemas(
                 ValidateSubschemas(m_target, m_context, true, false, *this, m_results, nullptr, &validated));
@@ -150,21 +311,28 @@ public:
      */
     bool visit(const AnyOfConstraint &constraint) override
     {
+        if (shouldEvaluateBranchesInParallel(constraint)) {
+            return validateBranchesInParallel(constraint, false);
+        }
+
+        prefetchBranches(constraint);
+
         unsigned int numValidated = 0;
 
         ValidationResults newResults;
         ValidationResults *childResults = (m_results) ? &newResults : nullptr;
 
-        ValidationVisitor<AdapterType, RegexEngine> v(m_target, m_context, m_strictTypes, childResults, m_regexesCache);
+        ValidationVisitor v(m_target, m_context, m_strictTypes, childResults, m_instrumentation, m_parallel, m_scratch, m_cancellation, m_budget, m_memo);
         constraint.applyToSubschemas(
                 ValidateSubschemas(m_target, m_context, false, true, v, childResults, &numValidated, nullptr));
 
         if (numValidated == 0 && m_results) {
             ValidationResults::Error childError;
             while (childResults->popError(childError)) {
-                m_results->pushError( childError.context, childError.description);
+                m_results->pushError(childError);
             }
-            m_results->pushError(m_context, "Failed to validate against any schemas allowed by anyOf constraint.");
+            m_results->pushError(m_context, ValidationResults::kAnyOfFailed,
+                        [&]() { return "Failed to validate against any schemas allowed by anyOf constraint."; });
         }
 
         return numValidated > 0;
@@ -187,8 +355,10 @@ public:
         ValidationResults* conditionalResults = (m_results) ? &newResults : nullptr;
 
         // Create a validator to evaluate the conditional
-        ValidationVisitor ifValidator(m_target, m_context, m_strictTypes, nullptr, m_regexesCache);
-        ValidationVisitor thenElseValidator(m_target, m_context, m_strictTypes, conditionalResults, m_regexesCache);
+        ValidationVisitor ifValidator(m_target, m_context, m_strictTypes, nullptr,
+                m_instrumentation, m_parallel, m_scratch, m_cancellation, m_budget, m_memo);
+        ValidationVisitor thenElseValidator(m_target, m_context, m_strictTypes, conditionalResults,
+                m_instrumentation, m_parallel, m_scratch, m_cancellation, m_budget, m_memo);
 
         bool validated = false;
         if (ifValidator.validateSchema(*constraint.getIfSubschema())) {
@@ -202,9 +372,10 @@ public:
         if (!validated && m_results) {
             ValidationResults::Error conditionalError;
             while (conditionalResults->popError(conditionalError)) {
-                m_results->pushError(conditionalError.context, conditionalError.description);
+                m_results->pushError(conditionalError);
             }
-            m_results->pushError(m_context, "Failed to validate against a conditional schema set by if-then-else constraints.");
+            m_results->pushError(m_context, ValidationResults::kConditionalFailed,
+                        [&]() { return "Failed to validate against a conditional schema set by if-then-else constraints."; });
         }
 
         return validated;
@@ -221,9 +392,24 @@ public:
      */
     bool visit(const ConstConstraint &constraint) override
     {
+        // For composite expected values, comparing canonical hashes rejects
+        // most mismatches in a single pass over the target, without the
+        // virtual dispatch that a deep comparison through the abstract
+        // adapter interface incurs at every node. Hashing cannot model
+        // weakly-typed equality, so the pre-check requires strict types.
+        if (m_strictTypes && constraint.hasValueHash() &&
+                internal::hashJsonValue(m_target) != constraint.getValueHash()) {
+            if (m_results) {
+                m_results->pushError(m_context, ValidationResults::kConstMismatch,
+                        [&]() { return "Failed to match expected value set by 'const' constraint."; });
+            }
+            return false;
+        }
+
         if (!constraint.getValue()->equalTo(m_target, m_strictTypes)) {
             if (m_results) {
-                m_results->pushError(m_context, "Failed to match expected value set by 'const' constraint.");
+                m_results->pushError(m_context, ValidationResults::kConstMismatch,
+                        [&]() { return "Failed to match expected value set by 'const' constraint."; });
             }
             return false;
         }
@@ -235,7 +421,14 @@ public:
      * @brief  Validate current node using a 'contains' constraint
      *
      * A contains constraint is satisfied if the target is not an array, or if it is an array,
-     * only if it contains at least one value that matches the specified schema.
+     * only if the number of values that match the specified schema falls
+     * within the bounds set by 'minContains' and 'maxContains'. By default at
+     * least one match is required and there is no upper bound.
+     *
+     * The scan over the array stops as soon as the outcome is decided: when
+     * no upper bound applies, matching stops once 'minContains' matches have
+     * been found, and when an upper bound applies, it stops as soon as the
+     * bound is exceeded.
      *
      * @param   constraint  ContainsConstraint that the current node must validate against
      *
@@ -247,27 +440,61 @@ public:
             return true;
         }
 
+        const uint64_t minContains = constraint.getMinContains();
+        const uint64_t maxContains = constraint.getMaxContains();
+        const bool bounded = maxContains != ContainsConstraint::kUnbounded;
+
+        // A 'minContains' of zero with no upper bound accepts any array
+        // without inspecting its values
+        if (minContains == 0 && !bounded) {
+            return true;
+        }
+
         const Subschema *subschema = constraint.getSubschema();
         const typename AdapterType::Array arr = m_target.asArray();
 
-        bool validated = false;
+        uint64_t matches = 0;
         for (const auto &el : arr) {
-            ValidationVisitor containsValidator(el, m_context, m_strictTypes, nullptr, m_regexesCache);
+            ValidationVisitor containsValidator(el, m_context, m_strictTypes, nullptr,
+                    m_instrumentation, m_parallel, m_scratch, m_cancellation, m_budget, m_memo);
             if (containsValidator.validateSchema(*subschema)) {
-                validated = true;
-                break;
+                matches++;
+
+                // Stop scanning once the outcome can no longer change
+                if (bounded ? matches > maxContains : matches >= minContains) {
+                    break;
+                }
             }
         }
 
-        if (!validated) {
+        if (bounded && matches > maxContains) {
             if (m_results) {
-                m_results->pushError(m_context, "Failed to any values against subschema in 'contains' constraint.");
+                m_results->pushError(m_context, ValidationResults::kContainsFailed,
+                        [&]() { return "Array contains more than " +
+                                std::to_string(maxContains) + " values that "
+                                "match the subschema in 'contains' constraint."; });
             }
 
             return false;
         }
 
-        return validated;
+        if (matches < minContains) {
+            if (m_results) {
+                if (minContains == 1) {
+                    m_results->pushError(m_context, ValidationResults::kContainsFailed,
+                            [&]() { return "Failed to any values against subschema in 'contains' constraint."; });
+                } else {
+                    m_results->pushError(m_context, ValidationResults::kContainsFailed,
+                            [&]() { return "Array contains fewer than " +
+                                    std::to_string(minContains) + " values that "
+                                    "match the subschema in 'contains' constraint."; });
+                }
+            }
+
+            return false;
+        }
+
+        return true;
     }
 
     /**
@@ -297,13 +524,24 @@ public:
         // Object to be validated
         const typename AdapterType::Object object = m_target.asObject();
 
+        // Collect the object's member names once, in sorted order, so that
+        // each dependency check below is a binary search over a flat array
+        // rather than a separate probe of the object
+        ScratchStringVector memberNames(scratchAllocator<std::string>());
+        memberNames.reserve(object.size());
+        for (const typename AdapterType::ObjectMember m : object) {
+            memberNames.push_back(m.first);
+        }
+        std::sort(memberNames.begin(), memberNames.end());
+
         // Cleared if validation fails
         bool validated = true;
 
         // Iterate over all dependent properties defined by this constraint,
         // invoking the DependentPropertyValidator functor once for each
         // set of dependent properties
-        constraint.applyToPropertyDependencies(ValidatePropertyDependencies(object, m_context, m_results, &validated));
+        constraint.applyToPropertyDependencies(ValidatePropertyDependencies(
+                memberNames, m_context, m_results, &validated));
         if (!m_results && !validated) {
             return false;
         }
@@ -312,7 +550,7 @@ public:
         // invoking the DependentSchemaValidator function once for each schema
         // that must be validated if a given property is present
         constraint.applyToSchemaDependencies(ValidateSchemaDependencies(
-                object, m_context, *this, m_results, &validated));
+                memberNames, m_context, *this, m_results, &validated));
         if (!m_results && !validated) {
             return false;
         }
@@ -333,12 +571,24 @@ public:
     bool visit(const EnumConstraint &constraint) override
     {
         unsigned int numValidated = 0;
-        constraint.applyToValues(
-                ValidateEquality(m_target, m_context, false, true, m_strictTypes, nullptr, &numValidated));
+
+        // When strict type comparisons are in use, membership can be tested
+        // against the constraint's hash index, so that deep comparisons are
+        // only performed for values whose canonical hashes collide. Weak
+        // type comparisons cannot be modelled by a hash, so they fall back
+        // to a linear scan over the enum values.
+        if (m_strictTypes && constraint.hasHashIndex()) {
+            constraint.applyToValuesWithHash(internal::hashJsonValue(m_target),
+                    ValidateEquality(m_target, m_context, false, true, m_strictTypes, nullptr, &numValidated));
+        } else {
+            constraint.applyToValues(
+                    ValidateEquality(m_target, m_context, false, true, m_strictTypes, nullptr, &numValidated));
+        }
 
         if (numValidated == 0) {
             if (m_results) {
-                m_results->pushError(m_context, "Failed to match against any enum values.");
+                m_results->pushError(m_context, ValidationResults::kEnumMismatch,
+                        [&]() { return "Failed to match against any enum values."; });
             }
 
             return false;
@@ -375,53 +625,259 @@ public:
             return true;
         }
 
+        // The checker was resolved through the FormatCheckerRegistry when
+        // the constraint was populated; formats with no checker are treated
+        // as annotations and accepted
+        const FormatChecker checker = constraint.getChecker();
+        if (checker == nullptr) {
+            return true;
+        }
+
         const std::string s = m_target.asString();
-        const std::string format = constraint.getFormat();
-        if (format == "date") {
-            // Matches dates like: 2022-07-18
-            std::regex date_regex("^([0-9]+)-(0[1-9]|1[012])-(0[1-9]|[12][0-9]|3[01])$");
-            std::smatch matches;
-            if (std::regex_match(s, matches, date_regex)) {
-                const auto month = std::stoi(matches[2].str());
-                const auto day = std::stoi(matches[3].str());
-                return validate_date_range(month, day);
-            } else {
-                if (m_results) {
-                    m_results->pushError(m_context,
-                                         "String should be a valid date");
+        if (checker(s.data(), s.size())) {
+            return true;
+        }
+
+        if (m_results) {
+            m_results->pushError(m_context, ValidationResults::kFormatMismatch,
+                    [&]() {
+                        return "String should be a valid " +
+                                constraint.getFormat();
+                    });
+        }
+
+        return false;
+    }
+
+    /**
+     * @brief   Validate a value against a FusedObjectConstraint
+     *
+     * A FusedObjectConstraint aggregates the object-related constraints of a
+     * sub-schema, so that membership of required properties, property name
+     * validity, the property count, and the per-property sub-schemas can all
+     * be evaluated in a single pass over the target object's members, rather
+     * than each constraint traversing or probing the object separately.
+     *
+     * Non-object values are always considered valid.
+     *
+     * @param   constraint  Constraint that the target must validate against
+     *
+     * @return  \c true if the constraint is satisfied; \c false otherwise
+     */
+    bool visit(const FusedObjectConstraint &constraint) override
+    {
+        if ((m_strictTypes && !m_target.isObject()) || !m_target.maybeObject()) {
+            return true;
+        }
+
+        typedef constraints::PropertiesConstraint::String PatternString;
+
+        bool validated = true;
+
+        const PropertiesConstraint *properties =
+                constraint.hasProperties() ? &constraint.getProperties() : nullptr;
+        const Subschema *additionalProperties = properties ?
+                properties->getAdditionalPropertiesSubschema() : nullptr;
+        const std::regex *combined = properties ?
+                properties->combinedPatternRegex() : nullptr;
+        const bool additionalAlwaysValid = additionalProperties != nullptr &&
+                additionalProperties->isAlwaysValid();
+
+        const Subschema *propertyNamesSubschema = constraint.hasPropertyNames() ?
+                constraint.getPropertyNames().getSubschema() : nullptr;
+
+        const RequiredConstraint *required =
+                constraint.hasRequired() ? &constraint.getRequired() : nullptr;
+        const size_t numRequired = required ? required->requiredPropertyCount() : 0;
+        RequiredBitmap requiredFound(numRequired, scratchAllocator<uint64_t>());
+
+        uint64_t numMembers = 0;
+
+        // When none of the fused parts needs to inspect individual members -
+        // typically 'additionalProperties: true' alongside property-count
+        // limits - only the member count matters, so iteration over the
+        // object is skipped entirely
+        const bool needsMemberWalk = required != nullptr ||
+                propertyNamesSubschema != nullptr ||
+                (properties != nullptr && !(additionalAlwaysValid &&
+                        properties->propertySubschemaCount() == 0 &&
+                        properties->patternPropertySubschemaCount() == 0));
+
+        if (!needsMemberWalk) {
+            numMembers = m_target.asObject().size();
+        } else {
+            const typename AdapterType::Object object = m_target.asObject();
+            for (const typename AdapterType::ObjectMember m : object) {
+                numMembers++;
+
+                // Tick off required property names as they are seen, using the
+                // constraint's sorted name list rather than probing the object
+                if (required) {
+                    const size_t index = required->findRequiredProperty(m.first);
+                    if (index < numRequired) {
+                        requiredFound.set(index);
+                    }
+                }
+
+                // Validate the property's name; unlike a standalone
+                // PropertyNamesConstraint, which rejects silently, an error
+                // description naming the offending property is recorded
+                if (propertyNamesSubschema) {
+                    adapters::StdStringAdapter stringAdapter(m.first);
+                    ValidationVisitor<adapters::StdStringAdapter, RegexEngine, Instrumentation> nameValidator(
+                            stringAdapter, m_context, m_strictTypes, nullptr, m_instrumentation, m_parallel, m_scratch, m_cancellation, m_budget, m_memo);
+                    if (!nameValidator.validateSchema(*propertyNamesSubschema)) {
+                        if (!m_results) {
+                            return false;
+                        }
+                        m_results->pushError(m_context, ValidationResults::kPropertyNamesFailed,
+                                [&]() { return "Failed to validate property name against "
+                                        "'propertyNames' schema: '" + m.first + "'."; },
+                                propertyNamesSubschema);
+                        validated = false;
+                    }
+                }
+
+                if (!properties) {
+                    continue;
+                }
+
+                // Validate the property's value against the sub-schemas of any
+                // matching 'properties' and 'patternProperties' entries
+                bool matched = false;
+                bool failedFast = false;
+
+                if (const Subschema *subschema = properties->findPropertySubschema(m.first)) {
+                    matched = true;
+                    const internal::ValidationContext newContext(m_context, m.first);
+                    ValidationVisitor validator(m.second, newContext, m_strictTypes, m_results,
+                            m_instrumentation, m_parallel, m_scratch, m_cancellation, m_budget, m_memo);
+                    if (!validator.validateSchema(*subschema)) {
+                        if (!m_results) {
+                            return false;
+                        }
+                        m_results->pushError(m_context, ValidationResults::kPropertiesFailed,
+                                [&]() { return "Failed to validate against schema associated with property name '" +
+                                        m.first + "'."; }, subschema);
+                        validated = false;
+                    }
+                }
+
+                if (combined != nullptr) {
+                    chargeRegexExecution();
+                }
+                if (!combined || std::regex_search(m.first, *combined)) {
+                    properties->applyToPatternProperties(
+                            [&, this](const PatternString &pattern, const Subschema *subschema) {
+                                const std::regex &r = properties->getPatternPropertyRegex(pattern);
+                                chargeRegexExecution();
+                                if (!std::regex_search(m.first, r)) {
+                                    return true;
+                                }
+
+                                matched = true;
+                                const internal::ValidationContext newContext(m_context, m.first);
+                                ValidationVisitor validator(m.second, newContext, m_strictTypes,
+                                        m_results, m_instrumentation, m_parallel, m_scratch, m_cancellation, m_budget, m_memo);
+                                if (validator.validateSchema(*subschema)) {
+                                    return true;
+                                }
+
+                                if (!m_results) {
+                                    failedFast = true;
+                                    return false;
+                                }
+
+                                m_results->pushError(m_context, ValidationResults::kPropertiesFailed,
+                                        [&]() { return "Failed to validate against schema associated with pattern '" +
+                                                std::string(pattern.c_str()) + "'."; }, subschema);
+                                validated = false;
+                                return true;
+                            });
+                    if (failedFast) {
+                        return false;
+                    }
+                }
+
+                // Fall back to the 'additionalProperties' sub-schema, if any,
+                // for properties that did not match by name or pattern
+                if (!matched) {
+                    if (additionalAlwaysValid) {
+                        // the sub-schema accepts anything, so the member's value
+                        // need not be visited
+                    } else if (additionalProperties) {
+                        const internal::ValidationContext newContext(m_context, m.first);
+                        ValidationVisitor validator(m.second, newContext, m_strictTypes, m_results,
+                                m_instrumentation, m_parallel, m_scratch, m_cancellation, m_budget, m_memo);
+                        if (!validator.validateSchema(*additionalProperties)) {
+                            if (!m_results) {
+                                return false;
+                            }
+                            m_results->pushError(m_context, ValidationResults::kPropertiesFailed,
+                                    [&]() { return "Failed to validate against additional properties schema"; },
+                                    additionalProperties);
+                            validated = false;
+                        }
+                    } else {
+                        if (!m_results) {
+                            return false;
+                        }
+                        m_results->pushError(m_context, ValidationResults::kPropertiesFailed,
+                                [&]() { return "Object contains a property "
+                                    "that could not be validated using 'properties' "
+                                    "or 'additionalProperties' constraints: '" + m.first + "'."; });
+                        validated = false;
+                    }
                 }
-                return false;
             }
-        } else if (format == "time") {
-            // Matches times like: 16:52:45Z, 16:52:45+02:00
-            std::regex time_regex("^([01][0-9]|2[0-3]):([0-5][0-9]):([0-5][0-9]|60)(\\.[0-9]+)?(([Zz])|([\\+|\\-]([01][0-9]|2[0-3]):[0-5][0-9]))$");
-            if (std::regex_match(s, time_regex)) {
-                return true;
-            } else {
-                if (m_results) {
-                    m_results->pushError(m_context,
-                                         "String should be a valid time");
+        }
+
+        // Report required properties that were never seen; when the bitmap
+        // matches the expected mask, the per-name loop is skipped entirely
+        if (required && !requiredFound.all()) {
+            for (size_t index = 0; index < numRequired; index++) {
+                if (requiredFound.test(index)) {
+                    continue;
                 }
-                return false;
+                if (!m_results) {
+                    return false;
+                }
+                m_results->pushError(m_context, ValidationResults::kRequiredMissing,
+                        [&]() { return "Missing required property '" + std::string(
+                                required->requiredPropertyAt(index).c_str()) + "'."; });
+                validated = false;
             }
-        } else if (format == "date-time") {
-            // Matches data times like: 2022-07-18T16:52:45Z, 2022-07-18T16:52:45+02:00
-            std::regex datetime_regex("^([0-9]+)-(0[1-9]|1[012])-(0[1-9]|[12][0-9]|3[01])[Tt]([01][0-9]|2[0-3]):([0-5][0-9]):([0-5][0-9]|60)(\\.[0-9]+)?(([Zz])|([\\+|\\-]([01][0-9]|2[0-3]):[0-5][0-9]))$");
-            std::smatch matches;
-            if (std::regex_match(s, matches, datetime_regex)) {
-                const auto month = std::stoi(matches[2].str());
-                const auto day = std::stoi(matches[3].str());
-                return validate_date_range(month, day);
-            } else {
-                if (m_results) {
-                    m_results->pushError(m_context,
-                                         "String should be a valid date-time");
+        }
+
+        // Property count limits re-use the count accumulated while iterating
+        // above, rather than calling getObjectSize() again
+        if (constraint.hasMinProperties()) {
+            const uint64_t minProperties = constraint.getMinProperties().getMinProperties();
+            if (numMembers < minProperties) {
+                if (!m_results) {
+                    return false;
                 }
-                return false;
+                m_results->pushError(m_context, ValidationResults::kMinPropertiesNotReached,
+                        [&]() { return "Object should have no fewer than " + std::to_string(minProperties) +
+                        " properties."; });
+                validated = false;
             }
         }
 
-        return true;
+        if (constraint.hasMaxProperties()) {
+            const uint64_t maxProperties = constraint.getMaxProperties().getMaxProperties();
+            if (numMembers > maxProperties) {
+                if (!m_results) {
+                    return false;
+                }
+                m_results->pushError(m_context, ValidationResults::kMaxPropertiesExceeded,
+                        [&]() { return "Object should have no more than " + std::to_string(maxProperties) +
+                        " properties."; });
+                validated = false;
+            }
+        }
+
+        return validated;
     }
 
     /**
@@ -469,14 +925,15 @@ public:
                     if (!m_results) {
                         return false;
                     }
-                    m_results->pushError(m_context, "Array contains more items than allowed by items constraint.");
+                    m_results->pushError(m_context, ValidationResults::kItemsFailed,
+                        [&]() { return "Array contains more items than allowed by items constraint."; });
                     validated = false;
                 }
             }
 
             constraint.applyToItemSubschemas(
-                    ValidateItems(arr, m_context, true, m_results != nullptr, m_strictTypes, m_results, &numValidated,
-                            &validated, m_regexesCache));
+                    ValidateItems(arr, m_context, true, m_results != nullptr, m_strictTypes, m_results,
+                            m_instrumentation, m_parallel, m_scratch, m_cancellation, m_budget, m_memo, &numValidated, &validated));
 
             if (!m_results && !validated) {
                 return false;
@@ -495,15 +952,15 @@ public:
                         itr != arr.end(); ++itr) {
 
                     // Update context for current array item
-                    std::vector<std::string> newContext = m_context;
-                    newContext.push_back("[" + std::to_string(index) + "]");
+                    const internal::ValidationContext newContext(m_context, index);
 
-                    ValidationVisitor<AdapterType, RegexEngine> validator(*itr, newContext, m_strictTypes, m_results, m_regexesCache);
+                    ValidationVisitor validator(*itr, newContext, m_strictTypes, m_results, m_instrumentation, m_parallel, m_scratch, m_cancellation, m_budget, m_memo);
 
                     if (!validator.validateSchema(*additionalItemsSubschema)) {
                         if (m_results) {
-                            m_results->pushError(m_context, "Failed to validate item #" + std::to_string(index) +
-                                    " against additional items schema.");
+                            m_results->pushError(m_context, ValidationResults::kItemsFailed,
+                        [&]() { return "Failed to validate item #" + std::to_string(index) +
+                                    " against additional items schema."; }, additionalItemsSubschema);
                             validated = false;
                         } else {
                             return false;
@@ -514,8 +971,9 @@ public:
                 }
 
             } else if (m_results) {
-                m_results->pushError(m_context, "Cannot validate item #" + std::to_string(numValidated) +
-                        " or greater using 'items' constraint or 'additionalItems' constraint.");
+                m_results->pushError(m_context, ValidationResults::kItemsFailed,
+                        [&]() { return "Cannot validate item #" + std::to_string(numValidated) +
+                        " or greater using 'items' constraint or 'additionalItems' constraint."; });
                 validated = false;
 
             } else {
@@ -542,10 +1000,42 @@ public:
 
         const double maximum = constraint.getMaximum();
 
+        // Integer fast path: when the schema expressed the bound as an
+        // integer and the target is an integer, compare using integer
+        // arithmetic, avoiding the round trip through double
+        if (constraint.hasIntegerMaximum() && m_target.isInteger()) {
+            const int64_t integerMaximum = constraint.getIntegerMaximum();
+            int64_t value;
+            bool exceedsMaximum;
+            if (m_target.asInteger(value)) {
+                exceedsMaximum = constraint.getExclusiveMaximum() ?
+                        value >= integerMaximum : value > integerMaximum;
+            } else {
+                // The only integers that int64_t cannot represent are those
+                // above its range, which exceed any int64-expressed maximum
+                uint64_t unsignedValue;
+                exceedsMaximum = m_target.getUnsignedInteger(unsignedValue);
+            }
+            if (exceedsMaximum) {
+                if (m_results) {
+                    m_results->pushError(m_context, ValidationResults::kMaximumExceeded,
+                        [&]() { return (constraint.getExclusiveMaximum() ?
+                                    "Expected number less than " :
+                                    "Expected number less than or equal to ") +
+                            std::to_string(maximum); });
+                }
+
+                return false;
+            }
+
+            return true;
+        }
+
         if (constraint.getExclusiveMaximum()) {
             if (m_target.asDouble() >= maximum) {
                 if (m_results) {
-                    m_results->pushError(m_context, "Expected number less than " + std::to_string(maximum));
+                    m_results->pushError(m_context, ValidationResults::kMaximumExceeded,
+                        [&]() { return "Expected number less than " + std::to_string(maximum); });
                 }
 
                 return false;
@@ -553,7 +1043,8 @@ public:
 
         } else if (m_target.asDouble() > maximum) {
             if (m_results) {
-                m_results->pushError(m_context, "Expected number less than or equal to " + std::to_string(maximum));
+                m_results->pushError(m_context, ValidationResults::kMaximumExceeded,
+                        [&]() { return "Expected number less than or equal to " + std::to_string(maximum); });
             }
 
             return false;
@@ -581,8 +1072,9 @@ public:
         }
 
         if (m_results) {
-            m_results->pushError(m_context, "Array should contain no more than " + std::to_string(maxItems) +
-                    " elements.");
+            m_results->pushError(m_context, ValidationResults::kMaxItemsExceeded,
+                        [&]() { return "Array should contain no more than " + std::to_string(maxItems) +
+                    " elements."; });
         }
 
         return false;
@@ -601,16 +1093,16 @@ public:
             return true;
         }
 
-        const std::string s = m_target.asString();
-        const uint64_t len = utils::u8_strlen(s.c_str());
+        const uint64_t len = targetStringLength();
         const uint64_t maxLength = constraint.getMaxLength();
         if (len <= maxLength) {
             return true;
         }
 
         if (m_results) {
-            m_results->pushError(m_context, "String should be no more than " + std::to_string(maxLength) +
-                    " characters in length.");
+            m_results->pushError(m_context, ValidationResults::kMaxLengthExceeded,
+                        [&]() { return "String should be no more than " + std::to_string(maxLength) +
+                    " characters in length."; });
         }
 
         return false;
@@ -636,8 +1128,9 @@ public:
         }
 
         if (m_results) {
-            m_results->pushError(m_context, "Object should have no more than " + std::to_string(maxProperties) +
-                    " properties.");
+            m_results->pushError(m_context, ValidationResults::kMaxPropertiesExceeded,
+                        [&]() { return "Object should have no more than " + std::to_string(maxProperties) +
+                    " properties."; });
         }
 
         return false;
@@ -659,17 +1152,49 @@ public:
 
         const double minimum = constraint.getMinimum();
 
+        // Integer fast path: when the schema expressed the bound as an
+        // integer and the target is an integer, compare using integer
+        // arithmetic, avoiding the round trip through double
+        if (constraint.hasIntegerMinimum() && m_target.isInteger()) {
+            const int64_t integerMinimum = constraint.getIntegerMinimum();
+            int64_t value;
+            bool belowMinimum;
+            if (m_target.asInteger(value)) {
+                belowMinimum = constraint.getExclusiveMinimum() ?
+                        value <= integerMinimum : value < integerMinimum;
+            } else {
+                // The only integers that int64_t cannot represent are those
+                // above its range, which satisfy any int64-expressed minimum
+                belowMinimum = false;
+            }
+            if (belowMinimum) {
+                if (m_results) {
+                    m_results->pushError(m_context, ValidationResults::kMinimumNotReached,
+                        [&]() { return (constraint.getExclusiveMinimum() ?
+                                    "Expected number greater than " :
+                                    "Expected number greater than or equal to ") +
+                            std::to_string(minimum); });
+                }
+
+                return false;
+            }
+
+            return true;
+        }
+
         if (constraint.getExclusiveMinimum()) {
             if (m_target.asDouble() <= minimum) {
                 if (m_results) {
-                    m_results->pushError(m_context, "Expected number greater than " + std::to_string(minimum));
+                    m_results->pushError(m_context, ValidationResults::kMinimumNotReached,
+                        [&]() { return "Expected number greater than " + std::to_string(minimum); });
                 }
 
                 return false;
             }
         } else if (m_target.asDouble() < minimum) {
             if (m_results) {
-                m_results->pushError(m_context, "Expected number greater than or equal to " + std::to_string(minimum));
+                m_results->pushError(m_context, ValidationResults::kMinimumNotReached,
+                        [&]() { return "Expected number greater than or equal to " + std::to_string(minimum); });
             }
 
             return false;
@@ -697,8 +1222,9 @@ public:
         }
 
         if (m_results) {
-            m_results->pushError(m_context, "Array should contain no fewer than " + std::to_string(minItems) +
-                    " elements.");
+            m_results->pushError(m_context, ValidationResults::kMinItemsNotReached,
+                        [&]() { return "Array should contain no fewer than " + std::to_string(minItems) +
+                    " elements."; });
         }
 
         return false;
@@ -717,16 +1243,16 @@ public:
             return true;
         }
 
-        const std::string s = m_target.asString();
-        const uint64_t len = utils::u8_strlen(s.c_str());
+        const uint64_t len = targetStringLength();
         const uint64_t minLength = constraint.getMinLength();
         if (len >= minLength) {
             return true;
         }
 
         if (m_results) {
-            m_results->pushError(m_context, "String should be no fewer than " + std::to_string(minLength) +
-                    " characters in length.");
+            m_results->pushError(m_context, ValidationResults::kMinLengthNotReached,
+                        [&]() { return "String should be no fewer than " + std::to_string(minLength) +
+                    " characters in length."; });
         }
 
         return false;
@@ -752,8 +1278,9 @@ public:
         }
 
         if (m_results) {
-            m_results->pushError(m_context, "Object should have no fewer than " + std::to_string(minProperties) +
-                    " properties.");
+            m_results->pushError(m_context, ValidationResults::kMinPropertiesNotReached,
+                        [&]() { return "Object should have no fewer than " + std::to_string(minProperties) +
+                    " properties."; });
         }
 
         return false;
@@ -774,8 +1301,9 @@ public:
         if (m_target.maybeDouble()) {
             if (!m_target.asDouble(d)) {
                 if (m_results) {
-                    m_results->pushError(m_context, "Value could not be converted "
-                            "to a number to check if it is a multiple of " + std::to_string(divisor));
+                    m_results->pushError(m_context, ValidationResults::kMultipleOfMismatch,
+                        [&]() { return "Value could not be converted "
+                            "to a number to check if it is a multiple of " + std::to_string(divisor); });
                 }
                 return false;
             }
@@ -783,8 +1311,9 @@ public:
             int64_t i = 0;
             if (!m_target.asInteger(i)) {
                 if (m_results) {
-                    m_results->pushError(m_context, "Value could not be converted "
-                            "to a number to check if it is a multiple of " + std::to_string(divisor));
+                    m_results->pushError(m_context, ValidationResults::kMultipleOfMismatch,
+                        [&]() { return "Value could not be converted "
+                            "to a number to check if it is a multiple of " + std::to_string(divisor); });
                 }
                 return false;
             }
@@ -801,7 +1330,8 @@ public:
 
         if (fabs(r) > std::numeric_limits<double>::epsilon()) {
             if (m_results) {
-                m_results->pushError(m_context, "Value should be a multiple of " + std::to_string(divisor));
+                m_results->pushError(m_context, ValidationResults::kMultipleOfMismatch,
+                        [&]() { return "Value should be a multiple of " + std::to_string(divisor); });
             }
             return false;
         }
@@ -823,8 +1353,24 @@ public:
         int64_t i = 0;
         if (m_target.maybeInteger()) {
             if (!m_target.asInteger(i)) {
+                // Integers above the int64_t range are checked through the
+                // unsigned representation, avoiding both wrapping and a
+                // lossy round trip through double
+                uint64_t u = 0;
+                if (divisor > 0 && m_target.getUnsignedInteger(u)) {
+                    if (u % static_cast<uint64_t>(divisor) != 0) {
+                        if (m_results) {
+                            m_results->pushError(m_context, ValidationResults::kMultipleOfMismatch,
+                                [&]() { return "Value should be a multiple of " + std::to_string(divisor); });
+                        }
+                        return false;
+                    }
+                    return true;
+                }
+
                 if (m_results) {
-                    m_results->pushError(m_context, "Value could not be converted to an integer for multipleOf check");
+                    m_results->pushError(m_context, ValidationResults::kMultipleOfMismatch,
+                        [&]() { return "Value could not be converted to an integer for multipleOf check"; });
                 }
                 return false;
             }
@@ -832,7 +1378,8 @@ public:
             double d;
             if (!m_target.asDouble(d)) {
                 if (m_results) {
-                    m_results->pushError(m_context, "Value could not be converted to a double for multipleOf check");
+                    m_results->pushError(m_context, ValidationResults::kMultipleOfMismatch,
+                        [&]() { return "Value could not be converted to a double for multipleOf check"; });
                 }
                 return false;
             }
@@ -847,7 +1394,8 @@ public:
 
         if (i % divisor != 0) {
             if (m_results) {
-                m_results->pushError(m_context, "Value should be a multiple of " + std::to_string(divisor));
+                m_results->pushError(m_context, ValidationResults::kMultipleOfMismatch,
+                        [&]() { return "Value should be a multiple of " + std::to_string(divisor); });
             }
             return false;
         }
@@ -874,11 +1422,11 @@ public:
             return false;
         }
 
-        ValidationVisitor<AdapterType, RegexEngine> v(m_target, m_context, m_strictTypes, nullptr, m_regexesCache);
+        ValidationVisitor v(m_target, m_context, m_strictTypes, nullptr, m_instrumentation, m_parallel, m_scratch, m_cancellation, m_budget, m_memo);
         if (v.validateSchema(*subschema)) {
             if (m_results) {
-                m_results->pushError(m_context,
-                        "Target should not validate against schema specified in 'not' constraint.");
+                m_results->pushError(m_context, ValidationResults::kNotFailed,
+                        [&]() { return "Target should not validate against schema specified in 'not' constraint."; });
             }
 
             return false;
@@ -896,12 +1444,42 @@ public:
      */
     bool visit(const OneOfConstraint &constraint) override
     {
+        // When the branches are indexed by a discriminating property, the
+        // target's value for that property identifies the only branch that
+        // could validate, and the other branches are skipped. The index
+        // models strict equality, and skipping branches would change the
+        // set of reported errors, so it is only consulted in fail-fast mode
+        // with strict types; see indexOneOfDiscriminators()
+        if (!m_results && m_strictTypes && constraint.hasDiscriminator() && m_target.isObject()) {
+            const typename AdapterType::Object object = m_target.asObject();
+            const auto itr = object.find(
+                    constraint.getDiscriminatorProperty(std::allocator<char>()));
+            if (itr != object.end()) {
+                const Subschema *subschema = constraint.findDiscriminatedSubschema(
+                        internal::hashJsonValue(itr->second));
+                if (subschema == nullptr) {
+                    // The discriminator value matches none of the branches,
+                    // so none of them can validate
+                    return false;
+                }
+                ValidationVisitor v(m_target, m_context, m_strictTypes, nullptr,
+                        m_instrumentation, m_parallel, m_scratch, m_cancellation, m_budget, m_memo);
+                return v.validateSchema(*subschema);
+            }
+        }
+
+        if (shouldEvaluateBranchesInParallel(constraint)) {
+            return validateBranchesInParallel(constraint, true);
+        }
+
+        prefetchBranches(constraint);
+
         unsigned int numValidated = 0;
 
         ValidationResults newResults;
         ValidationResults *childResults = (m_results) ? &newResults : nullptr;
 
-        ValidationVisitor<AdapterType, RegexEngine> v(m_target, m_context, m_strictTypes, childResults, m_regexesCache);
+        ValidationVisitor v(m_target, m_context, m_strictTypes, childResults, m_instrumentation, m_parallel, m_scratch, m_cancellation, m_budget, m_memo);
         constraint.applyToSubschemas(
                 ValidateSubschemas(m_target, m_context, true, true, v, childResults, &numValidated, nullptr));
 
@@ -909,17 +1487,17 @@ public:
             if (m_results) {
                 ValidationResults::Error childError;
                 while (childResults->popError(childError)) {
-                    m_results->pushError(
-                            childError.context,
-                            childError.description);
+                    m_results->pushError(childError);
                 }
-                m_results->pushError(m_context, "Failed to validate against any "
-                        "child schemas allowed by oneOf constraint.");
+                m_results->pushError(m_context, ValidationResults::kOneOfFailed,
+                        [&]() { return "Failed to validate against any "
+                        "child schemas allowed by oneOf constraint."; });
             }
             return false;
         } else if (numValidated != 1) {
             if (m_results) {
-                m_results->pushError(m_context, "Failed to validate against exactly one child schema.");
+                m_results->pushError(m_context, ValidationResults::kOneOfFailed,
+                        [&]() { return "Failed to validate against exactly one child schema."; });
             }
             return false;
         }
@@ -940,15 +1518,15 @@ public:
             return true;
         }
 
-        std::string pattern(constraint.getPattern<std::string::allocator_type>());
-        auto it = m_regexesCache.find(pattern);
-        if (it == m_regexesCache.end()) {
-            it = m_regexesCache.emplace(pattern, RegexEngine(pattern)).first;
-        }
+        // The compiled regex is cached within the constraint itself, so it
+        // is shared by all validators that use this schema
+        const RegexEngine &regex = constraint.template getCompiledRegex<RegexEngine>();
 
-        if (!RegexEngine::search(m_target.asString(), it->second)) {
+        chargeRegexExecution();
+        if (!searchPattern(regex, typename RegexEngineHasViewSearch<RegexEngine>::type())) {
             if (m_results) {
-                m_results->pushError(m_context, "Failed to match regex specified by 'pattern' constraint.");
+                m_results->pushError(m_context, ValidationResults::kPatternMismatch,
+                        [&]() { return "Failed to match regex specified by 'pattern' constraint."; });
             }
 
             return false;
@@ -966,7 +1544,9 @@ public:
      */
     bool visit(const constraints::PolyConstraint &constraint) override
     {
-        return constraint.validate(m_target, m_context, m_results);
+        // PolyConstraint implementations receive the context as a vector of
+        // strings, so the chain of context frames is materialised here
+        return constraint.validate(m_target, m_context.materialize(), m_results);
     }
 
     /**
@@ -1002,7 +1582,7 @@ public:
         bool validated = true;
 
         // Track which properties have already been validated
-        std::set<std::string> propertiesMatched;
+        ScratchStringSet propertiesMatched(std::less<std::string>(), scratchAllocator<std::string>());
 
         // Validate properties against subschemas for matching 'properties'
         // constraints
@@ -1010,7 +1590,7 @@ public:
         constraint.applyToProperties(
                 ValidatePropertySubschemas(
                         object, m_context, true, m_results != nullptr, true, m_strictTypes, m_results,
-                        &propertiesMatched, &validated, m_regexesCache));
+                        m_instrumentation, m_parallel, m_scratch, m_cancellation, m_budget, m_memo, &propertiesMatched, &validated));
 
         // Exit early if validation failed, and we're not collecting exhaustive
         // validation results
@@ -1018,12 +1598,28 @@ public:
             return false;
         }
 
+        // When a combined automaton covering all patternProperties patterns
+        // is available, scan each property name once to find the names that
+        // match at least one pattern; all other names can then be skipped by
+        // each of the per-pattern passes below
+        ScratchStringSet patternCandidates(std::less<std::string>(), scratchAllocator<std::string>());
+        const ScratchStringSet *patternCandidatesPtr = nullptr;
+        if (const std::regex *combined = constraint.combinedPatternRegex()) {
+            for (const typename AdapterType::ObjectMember m : object) {
+                chargeRegexExecution();
+                if (std::regex_search(m.first, *combined)) {
+                    patternCandidates.insert(m.first);
+                }
+            }
+            patternCandidatesPtr = &patternCandidates;
+        }
+
         // Validate properties against subschemas for matching patternProperties
         // constraints
         constraint.applyToPatternProperties(
                 ValidatePatternPropertySubschemas(
-                        object, m_context, true, false, true, m_strictTypes, m_results, &propertiesMatched,
-                        &validated, m_regexesCache));
+                        constraint, object, m_context, true, false, true, m_strictTypes, m_results,
+                        m_instrumentation, m_parallel, m_scratch, m_cancellation, m_budget, m_memo, &propertiesMatched, &validated, patternCandidatesPtr));
 
         // Validate against additionalProperties subschema for any properties
         // that have not yet been matched
@@ -1039,9 +1635,10 @@ public:
                             break;
                         }
                     }
-                    m_results->pushError(m_context, "Object contains a property "
+                    m_results->pushError(m_context, ValidationResults::kPropertiesFailed,
+                        [&]() { return "Object contains a property "
                             "that could not be validated using 'properties' "
-                            "or 'additionalProperties' constraints: '" + unwanted + "'.");
+                            "or 'additionalProperties' constraints: '" + unwanted + "'."; });
                 }
 
                 return false;
@@ -1050,17 +1647,25 @@ public:
             return validated;
         }
 
+        // An 'additionalProperties' sub-schema without constraints accepts
+        // the remaining members regardless of their values, so there is no
+        // need to visit them
+        if (additionalPropertiesSubschema->isAlwaysValid()) {
+            return validated;
+        }
+
         for (const typename AdapterType::ObjectMember m : object) {
             if (propertiesMatched.find(m.first) == propertiesMatched.end()) {
                 // Update context
-                std::vector<std::string> newContext = m_context;
-                newContext.push_back("[" + m.first + "]");
+                const internal::ValidationContext newContext(m_context, m.first);
 
                 // Create a validator to validate the property's value
-                ValidationVisitor validator(m.second, newContext, m_strictTypes, m_results, m_regexesCache);
+                ValidationVisitor validator(m.second, newContext, m_strictTypes, m_results,
+                        m_instrumentation, m_parallel, m_scratch, m_cancellation, m_budget, m_memo);
                 if (!validator.validateSchema(*additionalPropertiesSubschema)) {
                     if (m_results) {
-                        m_results->pushError(m_context, "Failed to validate against additional properties schema");
+                        m_results->pushError(m_context, ValidationResults::kPropertiesFailed,
+                        [&]() { return "Failed to validate against additional properties schema"; }, additionalPropertiesSubschema);
                     }
 
                     validated = false;
@@ -1084,9 +1689,15 @@ public:
             return true;
         }
 
+        // A 'propertyNames' sub-schema without constraints accepts any name
+        if (constraint.getSubschema()->isAlwaysValid()) {
+            return true;
+        }
+
         for (const typename AdapterType::ObjectMember m : m_target.asObject()) {
             adapters::StdStringAdapter stringAdapter(m.first);
-            ValidationVisitor<adapters::StdStringAdapter, RegexEngine> validator(stringAdapter, m_context, m_strictTypes, nullptr, m_regexesCache);
+            ValidationVisitor<adapters::StdStringAdapter, RegexEngine, Instrumentation> validator(
+                    stringAdapter, m_context, m_strictTypes, nullptr, m_instrumentation, m_parallel, m_scratch, m_cancellation, m_budget, m_memo);
             if (!validator.validateSchema(*constraint.getSubschema())) {
                 return false;
             }
@@ -1111,12 +1722,42 @@ public:
             return true;
         }
 
-        bool validated = true;
+        // The constraint keeps its property names in sorted order, so rather
+        // than probing the object once per required name, the object's
+        // members are walked once, ticking each name off in a bitmap; the
+        // bitmap is then compared against the expected mask in one 64-bit
+        // compare per 64 names
+        const size_t numRequired = constraint.requiredPropertyCount();
+        RequiredBitmap found(numRequired, scratchAllocator<uint64_t>());
+        size_t numFound = 0;
+
         const typename AdapterType::Object object = m_target.asObject();
-        constraint.applyToRequiredProperties(
-                ValidateProperties(object, m_context, true, m_results != nullptr, m_results, &validated));
+        for (const typename AdapterType::ObjectMember m : object) {
+            const size_t index = constraint.findRequiredProperty(m.first);
+            if (index < numRequired && !found.test(index)) {
+                found.set(index);
+                if (++numFound == numRequired) {
+                    break;
+                }
+            }
+        }
 
-        return validated;
+        if (numFound == numRequired) {
+            return true;
+        }
+
+        if (m_results) {
+            for (size_t index = 0; index < numRequired; index++) {
+                if (!found.test(index)) {
+                    m_results->pushError(m_context, ValidationResults::kRequiredMissing,
+                        [&]() { return "Missing required property '" + std::string(
+                                    constraint.requiredPropertyAt(
+                                            index).c_str()) + "'."; });
+                }
+            }
+        }
+
+        return false;
     }
 
     /**
@@ -1145,22 +1786,38 @@ public:
             return true;
         }
 
+        // An 'items' sub-schema without constraints accepts every element,
+        // so iteration over the array is unnecessary
+        if (itemsSubschema->isAlwaysValid()) {
+            return true;
+        }
+
+        // Large arrays of raw numbers validated against a bounds-only item
+        // schema are common in telemetry workloads; when the adapter can
+        // sweep its array storage natively, the whole array is proven valid
+        // with one pass over the bounds instead of one visitor dispatch per
+        // element. A sweep that cannot prove validity falls through to the
+        // per-element loop, which reports accurate per-item errors.
+        if (validateNumericItems(*itemsSubschema)) {
+            return true;
+        }
+
         // Track whether validation has failed
         bool validated = true;
 
         unsigned int index = 0;
         for (const AdapterType &item : m_target.getArray()) {
             // Update context for current array item
-            std::vector<std::string> newContext = m_context;
-            newContext.push_back("[" + std::to_string(index) + "]");
+            const internal::ValidationContext newContext(m_context, index);
 
             // Create a validator for the current array item
-            ValidationVisitor<AdapterType, RegexEngine> validationVisitor(item, newContext, m_strictTypes, m_results, m_regexesCache);
+            ValidationVisitor validationVisitor(item, newContext, m_strictTypes, m_results, m_instrumentation, m_parallel, m_scratch, m_cancellation, m_budget, m_memo);
 
             // Perform validation
             if (!validationVisitor.validateSchema(*itemsSubschema)) {
                 if (m_results) {
-                    m_results->pushError(m_context, "Failed to validate item #" + std::to_string(index) + " in array.");
+                    m_results->pushError(m_context, ValidationResults::kItemsFailed,
+                        [&]() { return "Failed to validate item #" + std::to_string(index) + " in array."; });
                     validated = false;
                 } else {
                     return false;
@@ -1185,8 +1842,23 @@ public:
      */
     bool visit(const TypeConstraint &constraint) override
     {
-        // Check named types
-        {
+        // Fast path for named types: classify the target once, then test
+        // membership with a single bitwise AND against the mask that the
+        // constraint maintains over its named types
+        const unsigned int namedTypeMask = constraint.namedTypeMask();
+        if (namedTypeMask &
+                TypeConstraint::jsonTypeMask(TypeConstraint::kAny)) {
+            return true;
+        }
+
+        if (namedTypeMask & strictTypeMask()) {
+            return true;
+        }
+
+        // The weak typing maybe* probes are value-dependent and overlapping,
+        // so they cannot be modelled by the mask; when weak typing is in use
+        // and the strict mask misses, fall back to probing per named type
+        if (!m_strictTypes && namedTypeMask != 0) {
             // ValidateNamedTypes functor assumes target is invalid
             bool validated = false;
             constraint.applyToNamedTypes(ValidateNamedTypes(m_target, false, true, m_strictTypes, &validated));
@@ -1203,7 +1875,8 @@ public:
             if (numValidated > 0) {
                 return true;
             } else if (m_results) {
-                m_results->pushError(m_context, "Value type not permitted by 'type' constraint.");
+                m_results->pushError(m_context, ValidationResults::kTypeMismatch,
+                        [&]() { return "Value type not permitted by 'type' constraint."; });
             }
         }
 
@@ -1234,6 +1907,68 @@ public:
             return true;
         }
 
+        // Small arrays are checked with pairwise comparisons, which avoids
+        // the overhead of hashing every item and also acts as a fallback
+        // implementation for targets that cannot be hashed
+        if (array_size <= 8) {
+            return validateUniqueItemsPairwise();
+        }
+
+        // Larger arrays are grouped into buckets by canonical hash, so that
+        // deep comparisons are only performed between items whose hashes
+        // collide; for an array of n items with few duplicates this requires
+        // n hash computations rather than n^2 comparisons
+        bool validated = true;
+
+        typedef std::pair<unsigned int, AdapterType> IndexedItem;
+        typedef std::vector<IndexedItem, ScratchAllocator<IndexedItem>> Bucket;
+        typedef std::unordered_map<size_t, Bucket, std::hash<size_t>,
+                std::equal_to<size_t>, ScratchAllocator<std::pair<const size_t, Bucket>>> BucketMap;
+
+        BucketMap buckets(array_size, std::hash<size_t>(), std::equal_to<size_t>(),
+                scratchAllocator<std::pair<const size_t, Bucket>>());
+
+        unsigned int index = 0;
+        for (const AdapterType item : m_target.asArray()) {
+            const size_t itemHash = internal::hashJsonValue(item);
+            auto bucketItr = buckets.find(itemHash);
+            if (bucketItr == buckets.end()) {
+                bucketItr = buckets.emplace(itemHash,
+                        Bucket(scratchAllocator<IndexedItem>())).first;
+            }
+            auto &bucket = bucketItr->second;
+            for (const auto &seen : bucket) {
+                if (seen.second.equalTo(item, true)) {
+                    if (!m_results) {
+                        return false;
+                    }
+                    m_results->pushError(m_context, ValidationResults::kUniqueItemsViolated,
+                        [&]() { return "Elements at indexes #" + std::to_string(seen.first)
+                        + " and #" + std::to_string(index) + " violate uniqueness constraint."; });
+                    validated = false;
+                }
+            }
+            bucket.push_back(std::make_pair(index, item));
+            ++index;
+        }
+
+        return validated;
+    }
+
+private:
+
+    /**
+     * @brief   Validate a uniqueItems constraint using pairwise comparisons
+     *
+     * This is used for small arrays, where hashing each item costs more than
+     * it saves, and serves as a fallback for items that cannot be hashed.
+     *
+     * @return  true if validation succeeds, false otherwise
+     */
+    bool validateUniqueItemsPairwise()
+    {
+        const size_t array_size = m_target.getArraySize();
+
         bool validated = true;
 
         const typename AdapterType::Array targetArray = m_target.asArray();
@@ -1248,8 +1983,9 @@ public:
                     if (!m_results) {
                         return false;
                     }
-                    m_results->pushError(m_context, "Elements at indexes #" + std::to_string(outerIndex)
-                        + " and #" + std::to_string(innerIndex) + " violate uniqueness constraint.");
+                    m_results->pushError(m_context, ValidationResults::kUniqueItemsViolated,
+                        [&]() { return "Elements at indexes #" + std::to_string(outerIndex)
+                        + " and #" + std::to_string(innerIndex) + " violate uniqueness constraint."; });
                     validated = false;
                 }
                 ++innerIndex;
@@ -1260,7 +1996,236 @@ public:
         return validated;
     }
 
-private:
+    /// Sorted set of property names, allocated from the scratch arena when
+    /// one has been provided
+    typedef std::set<std::string, std::less<std::string>,
+            ScratchAllocator<std::string>> ScratchStringSet;
+
+    /// Vector of property names, allocated from the scratch arena when one
+    /// has been provided
+    typedef std::vector<std::string, ScratchAllocator<std::string>> ScratchStringVector;
+
+    /// Vector of flags, allocated from the scratch arena when one has been
+    /// provided
+    typedef std::vector<bool, ScratchAllocator<bool>> ScratchBoolVector;
+
+    /// Tracks which of a constraint's required property names have been seen
+    /// while walking an object's members
+    ///
+    /// One bit is set per name as members are ticked off, and completeness is
+    /// tested afterwards by comparing each word against a mask of the expected
+    /// bits - one 64-bit compare covers up to 64 names, so objects that do
+    /// satisfy their 'required' list are confirmed without scanning a per-name
+    /// flag array. Up to 128 names are tracked entirely on the stack; larger
+    /// sets spill into the scratch arena.
+    class RequiredBitmap
+    {
+    public:
+        RequiredBitmap(size_t numBits, const ScratchAllocator<uint64_t> &allocator)
+          : m_numBits(numBits),
+            m_spill(allocator)
+        {
+            m_inlineWords[0] = m_inlineWords[1] = 0;
+            if (numWords() > kNumInlineWords) {
+                m_spill.assign(numWords(), 0);
+            }
+        }
+
+        void set(size_t index)
+        {
+            words()[index / 64] |= static_cast<uint64_t>(1) << (index % 64);
+        }
+
+        bool test(size_t index) const
+        {
+            return (words()[index / 64] >> (index % 64)) & 1;
+        }
+
+        /// Return true if every tracked bit has been set
+        bool all() const
+        {
+            const uint64_t *w = words();
+            const size_t numWholeWords = m_numBits / 64;
+            for (size_t i = 0; i < numWholeWords; i++) {
+                if (w[i] != ~static_cast<uint64_t>(0)) {
+                    return false;
+                }
+            }
+
+            const size_t numTailBits = m_numBits % 64;
+            return numTailBits == 0 || w[numWholeWords] ==
+                    (static_cast<uint64_t>(1) << numTailBits) - 1;
+        }
+
+    private:
+        static const size_t kNumInlineWords = 2;
+
+        size_t numWords() const
+        {
+            return (m_numBits + 63) / 64;
+        }
+
+        uint64_t * words()
+        {
+            return m_spill.empty() ? m_inlineWords : m_spill.data();
+        }
+
+        const uint64_t * words() const
+        {
+            return m_spill.empty() ? m_inlineWords : m_spill.data();
+        }
+
+        size_t m_numBits;
+        uint64_t m_inlineWords[kNumInlineWords];
+        std::vector<uint64_t, ScratchAllocator<uint64_t>> m_spill;
+    };
+
+    /// Return an allocator for transient storage, drawing from the scratch
+    /// arena when one has been provided
+    template<typename T>
+    ScratchAllocator<T> scratchAllocator() const
+    {
+        return ScratchAllocator<T>(m_scratch);
+    }
+
+    /**
+     * @brief  Attempt to prove every array element valid against a
+     *         bounds-only item schema in a single pass
+     *
+     * The item schema is eligible when each of its constraints is a
+     * 'minimum' or 'maximum' bound - at most one of each kind - or a
+     * 'type' constraint that admits numbers; the adapter must be able to
+     * summarise the array as its
+     * numeric bounds. The analysis performs a few dynamic_casts, but it
+     * runs once per array rather than once per element, so its cost is
+     * amortised over the elements it saves from individual dispatch.
+     *
+     * @param  itemsSubschema  item schema that every element must satisfy
+     *
+     * @returns  \c true if every element was proven valid; \c false if the
+     *           schema or adapter is not eligible, or if any element may
+     *           fail, in which case the caller must validate each element
+     *           individually
+     */
+    bool validateNumericItems(const Subschema &itemsSubschema)
+    {
+        bool eligible = true;
+        bool hasMinimum = false;
+        bool exclusiveMinimum = false;
+        double minimum = 0;
+        bool hasMaximum = false;
+        bool exclusiveMaximum = false;
+        double maximum = 0;
+
+        // Largest magnitude at which every integer is exactly representable
+        // as a double; bounds beyond it cannot be checked faithfully in
+        // double arithmetic
+        static const int64_t kExactLimit = int64_t(1) << 53;
+
+        itemsSubschema.forEachConstraint(
+                [&](const constraints::Constraint &constraint) {
+            if (const auto *minConstraint = dynamic_cast<
+                    const constraints::MinimumConstraint *>(&constraint)) {
+                if (minConstraint->hasIntegerMinimum() &&
+                        (minConstraint->getIntegerMinimum() > kExactLimit ||
+                         minConstraint->getIntegerMinimum() < -kExactLimit)) {
+                    eligible = false;
+                    return false;
+                }
+                // allOf hoisting can place several 'minimum' bounds on one
+                // subschema; the sweep tracks a single bound, so a second
+                // one forces the per-element loop rather than silently
+                // replacing the first
+                if (hasMinimum) {
+                    eligible = false;
+                    return false;
+                }
+                hasMinimum = true;
+                exclusiveMinimum = minConstraint->getExclusiveMinimum();
+                minimum = minConstraint->getMinimum();
+                return true;
+            }
+
+            if (const auto *maxConstraint = dynamic_cast<
+                    const constraints::MaximumConstraint *>(&constraint)) {
+                if (maxConstraint->hasIntegerMaximum() &&
+                        (maxConstraint->getIntegerMaximum() > kExactLimit ||
+                         maxConstraint->getIntegerMaximum() < -kExactLimit)) {
+                    eligible = false;
+                    return false;
+                }
+                if (hasMaximum) {
+                    eligible = false;
+                    return false;
+                }
+                hasMaximum = true;
+                exclusiveMaximum = maxConstraint->getExclusiveMaximum();
+                maximum = maxConstraint->getMaximum();
+                return true;
+            }
+
+            if (const auto *typeConstraint = dynamic_cast<
+                    const constraints::TypeConstraint *>(&constraint)) {
+                // Every element the sweep accepts is a number, so a 'type'
+                // constraint is satisfied whenever its named types admit
+                // numbers and there are no schema-based types to evaluate
+                const unsigned int mask = typeConstraint->namedTypeMask();
+                if (typeConstraint->schemaTypeCount() == 0 &&
+                        (mask & (TypeConstraint::jsonTypeMask(TypeConstraint::kAny) |
+                                TypeConstraint::jsonTypeMask(TypeConstraint::kNumber)))) {
+                    return true;
+                }
+                eligible = false;
+                return false;
+            }
+
+            eligible = false;
+            return false;
+        });
+
+        if (!eligible) {
+            return false;
+        }
+
+        size_t size = 0;
+        double lowest = 0;
+        double highest = 0;
+        if (!m_target.getNumericArrayBounds(size, lowest, highest)) {
+            return false;
+        }
+
+        if (size == 0) {
+            return true;
+        }
+
+        if (hasMinimum &&
+                (exclusiveMinimum ? lowest <= minimum : lowest < minimum)) {
+            return false;
+        }
+
+        if (hasMaximum &&
+                (exclusiveMaximum ? highest >= maximum : highest > maximum)) {
+            return false;
+        }
+
+        return true;
+    }
+
+    /// Poll the cancellation token, where one has been provided; returns
+    /// true if this validation run should be abandoned
+    bool cancellationRequested() const
+    {
+        return m_cancellation != nullptr && m_cancellation->poll();
+    }
+
+    /// Count one regex execution against the budget, where one is attached;
+    /// exhaustion takes effect at the next sub-schema boundary
+    void chargeRegexExecution() const
+    {
+        if (m_budget != nullptr) {
+            m_budget->chargeRegexExecution();
+        }
+    }
 
     /**
      * @brief  Functor to compare a node with a collection of values
@@ -1269,7 +2234,7 @@ private:
     {
         ValidateEquality(
                 const AdapterType &target,
-                const std::vector<std::string> &context,
+                const internal::ValidationContext &context,
                 bool continueOnSuccess,
                 bool continueOnFailure,
                 bool strictTypes,
@@ -1295,7 +2260,8 @@ private:
             }
 
             if (m_results) {
-                m_results->pushError(m_context, "Target value and comparison value are not equal");
+                m_results->pushError(m_context, ValidationResults::kConstMismatch,
+                        [&]() { return "Target value and comparison value are not equal"; });
             }
 
             return m_continueOnFailure;
@@ -1303,7 +2269,7 @@ private:
 
     private:
         const AdapterType &m_target;
-        const std::vector<std::string> &m_context;
+        const internal::ValidationContext &m_context;
         bool m_continueOnSuccess;
         bool m_continueOnFailure;
         bool m_strictTypes;
@@ -1311,64 +2277,21 @@ private:
         unsigned int * const m_numValidated;
     };
 
-    /**
-     * @brief  Functor to validate the presence of a set of properties
-     */
-    struct ValidateProperties
-    {
-        ValidateProperties(
-                const typename AdapterType::Object &object,
-                const std::vector<std::string> &context,
-                bool continueOnSuccess,
-                bool continueOnFailure,
-                ValidationResults *results,
-                bool *validated)
-          : m_object(object),
-            m_context(context),
-            m_continueOnSuccess(continueOnSuccess),
-            m_continueOnFailure(continueOnFailure),
-            m_results(results),
-            m_validated(validated) { }
-
-        template<typename StringType>
-        bool operator()(const StringType &property) const
-        {
-            if (m_object.find(property.c_str()) == m_object.end()) {
-                if (m_validated) {
-                    *m_validated = false;
-                }
-
-                if (m_results) {
-                    m_results->pushError(m_context, "Missing required property '" +
-                            std::string(property.c_str()) + "'.");
-                }
-
-                return m_continueOnFailure;
-            }
-
-            return m_continueOnSuccess;
-        }
-
-    private:
-        const typename AdapterType::Object &m_object;
-        const std::vector<std::string> &m_context;
-        bool m_continueOnSuccess;
-        bool m_continueOnFailure;
-        ValidationResults * const m_results;
-        bool * const m_validated;
-    };
-
     /**
      * @brief  Functor to validate property-based dependencies
+     *
+     * Presence checks are performed against a sorted list of the target
+     * object's member names, prepared once by the caller, rather than by
+     * probing the object itself.
      */
     struct ValidatePropertyDependencies
     {
         ValidatePropertyDependencies(
-                const typename AdapterType::Object &object,
-                const std::vector<std::string> &context,
+                const ScratchStringVector &memberNames,
+                const internal::ValidationContext &context,
                 ValidationResults *results,
                 bool *validated)
-          : m_object(object),
+          : m_memberNames(memberNames),
             m_context(context),
             m_results(results),
             m_validated(validated) { }
@@ -1377,19 +2300,22 @@ private:
         bool operator()(const StringType &propertyName, const ContainerType &dependencyNames) const
         {
             const std::string propertyNameKey(propertyName.c_str());
-            if (m_object.find(propertyNameKey) == m_object.end()) {
+            if (!std::binary_search(m_memberNames.begin(),
+                    m_memberNames.end(), propertyNameKey)) {
                 return true;
             }
 
             typedef typename ContainerType::value_type ValueType;
             for (const ValueType &dependencyName : dependencyNames) {
                 const std::string dependencyNameKey(dependencyName.c_str());
-                if (m_object.find(dependencyNameKey) == m_object.end()) {
+                if (!std::binary_search(m_memberNames.begin(),
+                        m_memberNames.end(), dependencyNameKey)) {
                     if (m_validated) {
                         *m_validated = false;
                     }
                     if (m_results) {
-                        m_results->pushError(m_context, "Missing dependency '" + dependencyNameKey + "'.");
+                        m_results->pushError(m_context, ValidationResults::kDependenciesFailed,
+                        [&]() { return "Missing dependency '" + dependencyNameKey + "'."; });
                     } else {
                         return false;
                     }
@@ -1400,8 +2326,8 @@ private:
         }
 
     private:
-        const typename AdapterType::Object &m_object;
-        const std::vector<std::string> &m_context;
+        const ScratchStringVector &m_memberNames;
+        const internal::ValidationContext &m_context;
         ValidationResults * const m_results;
         bool * const m_validated;
     };
@@ -1413,23 +2339,33 @@ private:
     {
         ValidateItems(
                 const typename AdapterType::Array &arr,
-                const std::vector<std::string> &context,
+                const internal::ValidationContext &context,
                 bool continueOnSuccess,
                 bool continueOnFailure,
                 bool strictTypes,
                 ValidationResults *results,
+                Instrumentation instrumentation,
+                ParallelOptions parallel,
+                ScratchArena *scratch,
+                CancellationToken *cancellation,
+                ValidationBudget *budget,
+                ValidationCache *memo,
                 unsigned int *numValidated,
-                bool *validated,
-                std::unordered_map<std::string, RegexEngine>& regexesCache)
+                bool *validated)
           : m_arr(arr),
             m_context(context),
             m_continueOnSuccess(continueOnSuccess),
             m_continueOnFailure(continueOnFailure),
             m_strictTypes(strictTypes),
             m_results(results),
+            m_instrumentation(instrumentation),
+            m_parallel(parallel),
+            m_scratch(scratch),
+            m_cancellation(cancellation),
+            m_budget(budget),
+            m_memo(memo),
             m_numValidated(numValidated),
-            m_validated(validated),
-            m_regexesCache(regexesCache) { }
+            m_validated(validated) { }
 
         bool operator()(unsigned int index, const Subschema *subschema) const
         {
@@ -1439,15 +2375,15 @@ private:
             }
 
             // Update context
-            std::vector<std::string> newContext = m_context;
-            newContext.push_back("[" + std::to_string(index) + "]");
+            const internal::ValidationContext newContext(m_context, index);
 
             // Find array item
             typename AdapterType::Array::const_iterator itr = m_arr.begin();
             itr.advance(index);
 
             // Validate current array item
-            ValidationVisitor validator(*itr, newContext, m_strictTypes, m_results, m_regexesCache);
+            ValidationVisitor validator(*itr, newContext, m_strictTypes, m_results,
+                    m_instrumentation, m_parallel, m_scratch, m_cancellation, m_budget, m_memo);
             if (validator.validateSchema(*subschema)) {
                 if (m_numValidated) {
                     (*m_numValidated)++;
@@ -1461,8 +2397,9 @@ private:
             }
 
             if (m_results) {
-                m_results->pushError(newContext, "Failed to validate item #" + std::to_string(index) +
-                    " against corresponding item schema.");
+                m_results->pushError(newContext, ValidationResults::kItemsFailed,
+                        [&]() { return "Failed to validate item #" + std::to_string(index) +
+                    " against corresponding item schema."; }, subschema);
             }
 
             return m_continueOnFailure;
@@ -1470,14 +2407,19 @@ private:
 
     private:
         const typename AdapterType::Array &m_arr;
-        const std::vector<std::string> &m_context;
+        const internal::ValidationContext &m_context;
         bool m_continueOnSuccess;
         bool m_continueOnFailure;
         bool m_strictTypes;
         ValidationResults * const m_results;
+        Instrumentation m_instrumentation;
+        ParallelOptions m_parallel;
+        ScratchArena *m_scratch;
+        CancellationToken *m_cancellation;
+        ValidationBudget *m_budget;
+        ValidationCache *m_memo;
         unsigned int * const m_numValidated;
         bool * const m_validated;
-        std::unordered_map<std::string, RegexEngine>& m_regexesCache;
     };
 
     /**
@@ -1554,43 +2496,65 @@ private:
     struct ValidatePatternPropertySubschemas
     {
         ValidatePatternPropertySubschemas(
+                const PropertiesConstraint &constraint,
                 const typename AdapterType::Object &object,
-                const std::vector<std::string> &context,
+                const internal::ValidationContext &context,
                 bool continueOnSuccess,
                 bool continueOnFailure,
                 bool continueIfUnmatched,
                 bool strictTypes,
                 ValidationResults *results,
-                std::set<std::string> *propertiesMatched,
+                Instrumentation instrumentation,
+                ParallelOptions parallel,
+                ScratchArena *scratch,
+                CancellationToken *cancellation,
+                ValidationBudget *budget,
+                ValidationCache *memo,
+                ScratchStringSet *propertiesMatched,
                 bool *validated,
-                std::unordered_map<std::string, RegexEngine>& regexesCache)
-          : m_object(object),
+                const ScratchStringSet *patternCandidates)
+          : m_constraint(constraint),
+            m_object(object),
             m_context(context),
             m_continueOnSuccess(continueOnSuccess),
             m_continueOnFailure(continueOnFailure),
             m_continueIfUnmatched(continueIfUnmatched),
             m_strictTypes(strictTypes),
             m_results(results),
+            m_instrumentation(instrumentation),
+            m_parallel(parallel),
+            m_scratch(scratch),
+            m_cancellation(cancellation),
+            m_budget(budget),
+            m_memo(memo),
             m_propertiesMatched(propertiesMatched),
             m_validated(validated),
-            m_regexesCache(regexesCache) { }
+            m_patternCandidates(patternCandidates) { }
 
         template<typename StringType>
         bool operator()(const StringType &patternProperty, const Subschema *subschema) const
         {
             const std::string patternPropertyStr(patternProperty.c_str());
 
-            // It would be nice to store pre-allocated regex objects in the
-            // PropertiesConstraint. does std::regex currently support
-            // custom allocators? Anyway, this isn't an issue here, because Valijson's
-            // JSON Scheme validator does not yet support custom allocators.
-            const std::regex r(patternPropertyStr);
+            // The compiled regex is cached within the constraint itself, so
+            // the pattern is compiled at most once per schema
+            const std::regex &r = m_constraint.getPatternPropertyRegex(patternProperty);
 
             bool matchFound = false;
 
             // Recursively validate all matching properties
             typedef const typename AdapterType::ObjectMember ObjectMember;
             for (const ObjectMember m : m_object) {
+                // Names outside the prefiltered candidate set are known not
+                // to match any of the patterns
+                if (m_patternCandidates &&
+                        m_patternCandidates->find(m.first) == m_patternCandidates->end()) {
+                    continue;
+                }
+
+                if (m_budget != nullptr) {
+                    m_budget->chargeRegexExecution();
+                }
                 if (std::regex_search(m.first, r)) {
                     matchFound = true;
                     if (m_propertiesMatched) {
@@ -1598,18 +2562,19 @@ private:
                     }
 
                     // Update context
-                    std::vector<std::string> newContext = m_context;
-                    newContext.push_back("[" + m.first + "]");
+                    const internal::ValidationContext newContext(m_context, m.first);
 
                     // Recursively validate property's value
-                    ValidationVisitor validator(m.second, newContext, m_strictTypes, m_results, m_regexesCache);
+                    ValidationVisitor validator(m.second, newContext, m_strictTypes, m_results,
+                            m_instrumentation, m_parallel, m_scratch, m_cancellation, m_budget, m_memo);
                     if (validator.validateSchema(*subschema)) {
                         continue;
                     }
 
                     if (m_results) {
-                        m_results->pushError(m_context, "Failed to validate against schema associated with pattern '" +
-                                patternPropertyStr + "'.");
+                        m_results->pushError(m_context, ValidationResults::kPropertiesFailed,
+                        [&]() { return "Failed to validate against schema associated with pattern '" +
+                                patternPropertyStr + "'."; }, subschema);
                     }
 
                     if (m_validated) {
@@ -1631,16 +2596,23 @@ private:
         }
 
     private:
+        const PropertiesConstraint &m_constraint;
         const typename AdapterType::Object &m_object;
-        const std::vector<std::string> &m_context;
+        const internal::ValidationContext &m_context;
         const bool m_continueOnSuccess;
         const bool m_continueOnFailure;
         const bool m_continueIfUnmatched;
         const bool m_strictTypes;
         ValidationResults * const m_results;
-        std::set<std::string> * const m_propertiesMatched;
+        Instrumentation m_instrumentation;
+        ParallelOptions m_parallel;
+        ScratchArena *m_scratch;
+        CancellationToken *m_cancellation;
+        ValidationBudget *m_budget;
+        ValidationCache *m_memo;
+        ScratchStringSet * const m_propertiesMatched;
         bool * const m_validated;
-        std::unordered_map<std::string, RegexEngine>& m_regexesCache;
+        const ScratchStringSet * const m_patternCandidates;
     };
 
     /**
@@ -1651,15 +2623,20 @@ private:
     {
         ValidatePropertySubschemas(
                 const typename AdapterType::Object &object,
-                const std::vector<std::string> &context,
+                const internal::ValidationContext &context,
                 bool continueOnSuccess,
                 bool continueOnFailure,
                 bool continueIfUnmatched,
                 bool strictTypes,
                 ValidationResults *results,
-                std::set<std::string> *propertiesMatched,
-                bool *validated,
-                std::unordered_map<std::string, RegexEngine>& regexesCache)
+                Instrumentation instrumentation,
+                ParallelOptions parallel,
+                ScratchArena *scratch,
+                CancellationToken *cancellation,
+                ValidationBudget *budget,
+                ValidationCache *memo,
+                ScratchStringSet *propertiesMatched,
+                bool *validated)
           : m_object(object),
             m_context(context),
             m_continueOnSuccess(continueOnSuccess),
@@ -1667,9 +2644,14 @@ private:
             m_continueIfUnmatched(continueIfUnmatched),
             m_strictTypes(strictTypes),
             m_results(results),
+            m_instrumentation(instrumentation),
+            m_parallel(parallel),
+            m_scratch(scratch),
+            m_cancellation(cancellation),
+            m_budget(budget),
+            m_memo(memo),
             m_propertiesMatched(propertiesMatched),
-            m_validated(validated),
-            m_regexesCache(regexesCache) { }
+            m_validated(validated) { }
 
         template<typename StringType>
         bool operator()(const StringType &propertyName, const Subschema *subschema) const
@@ -1685,18 +2667,19 @@ private:
             }
 
             // Update context
-            std::vector<std::string> newContext = m_context;
-            newContext.push_back("[" + propertyNameKey + "]");
+            const internal::ValidationContext newContext(m_context, propertyNameKey);
 
             // Recursively validate property's value
-            ValidationVisitor validator(itr->second, newContext, m_strictTypes, m_results, m_regexesCache);
+            ValidationVisitor validator(itr->second, newContext, m_strictTypes, m_results,
+                    m_instrumentation, m_parallel, m_scratch, m_cancellation, m_budget, m_memo);
             if (validator.validateSchema(*subschema)) {
                 return m_continueOnSuccess;
             }
 
             if (m_results) {
-                m_results->pushError(m_context, "Failed to validate against schema associated with property name '" +
-                        propertyNameKey + "'.");
+                m_results->pushError(m_context, ValidationResults::kPropertiesFailed,
+                        [&]() { return "Failed to validate against schema associated with property name '" +
+                        propertyNameKey + "'."; }, subschema);
             }
 
             if (m_validated) {
@@ -1708,15 +2691,20 @@ private:
 
     private:
         const typename AdapterType::Object &m_object;
-        const std::vector<std::string> &m_context;
+        const internal::ValidationContext &m_context;
         const bool m_continueOnSuccess;
         const bool m_continueOnFailure;
         const bool m_continueIfUnmatched;
         const bool m_strictTypes;
         ValidationResults * const m_results;
-        std::set<std::string> * const m_propertiesMatched;
+        Instrumentation m_instrumentation;
+        ParallelOptions m_parallel;
+        ScratchArena *m_scratch;
+        CancellationToken *m_cancellation;
+        ValidationBudget *m_budget;
+        ValidationCache *m_memo;
+        ScratchStringSet * const m_propertiesMatched;
         bool * const m_validated;
-        std::unordered_map<std::string, RegexEngine>& m_regexesCache;
     };
 
     /**
@@ -1725,12 +2713,12 @@ private:
     struct ValidateSchemaDependencies
     {
         ValidateSchemaDependencies(
-                const typename AdapterType::Object &object,
-                const std::vector<std::string> &context,
+                const ScratchStringVector &memberNames,
+                const internal::ValidationContext &context,
                 ValidationVisitor &validationVisitor,
                 ValidationResults *results,
                 bool *validated)
-          : m_object(object),
+          : m_memberNames(memberNames),
             m_context(context),
             m_validationVisitor(validationVisitor),
             m_results(results),
@@ -1740,7 +2728,8 @@ private:
         bool operator()(const StringType &propertyName, const Subschema *schemaDependency) const
         {
             const std::string propertyNameKey(propertyName.c_str());
-            if (m_object.find(propertyNameKey) == m_object.end()) {
+            if (!std::binary_search(m_memberNames.begin(),
+                    m_memberNames.end(), propertyNameKey)) {
                 return true;
             }
 
@@ -1749,7 +2738,8 @@ private:
                     *m_validated = false;
                 }
                 if (m_results) {
-                    m_results->pushError(m_context, "Failed to validate against dependent schema.");
+                    m_results->pushError(m_context, ValidationResults::kDependenciesFailed,
+                        [&]() { return "Failed to validate against dependent schema."; }, schemaDependency);
                 } else {
                     return false;
                 }
@@ -1759,8 +2749,8 @@ private:
         }
 
     private:
-        const typename AdapterType::Object &m_object;
-        const std::vector<std::string> &m_context;
+        const ScratchStringVector &m_memberNames;
+        const internal::ValidationContext &m_context;
         ValidationVisitor &m_validationVisitor;
         ValidationResults * const m_results;
         bool * const m_validated;
@@ -1781,11 +2771,184 @@ private:
      * The functor uses output parameters (provided at construction) to update
      * validation state that may be needed by the caller.
      */
+    /**
+     * @brief  Return true if a combinator's branches should be evaluated
+     *         in parallel
+     *
+     * Parallel evaluation requires an executor and a branch count at or
+     * above the configured threshold; narrow combinators are not worth the
+     * task dispatch overhead.
+     */
+    template<typename ConstraintType>
+    bool shouldEvaluateBranchesInParallel(const ConstraintType &constraint) const
+    {
+        if (m_parallel.executor == nullptr) {
+            return false;
+        }
+
+        size_t numBranches = 0;
+        constraint.applyToSubschemas(
+                [&numBranches](unsigned int, const Subschema *) {
+                    numBranches++;
+                    return true;
+                });
+
+        return numBranches >= 2 && numBranches >= m_parallel.minBranches;
+    }
+
+    /**
+     * @brief  Prefetch the constraints of each of a combinator's branches
+     *
+     * Called on entry to a combinator, so the first cache line of every
+     * branch's constraint storage is being fetched while earlier branches
+     * are evaluated. On a schema compiled in visit order - see
+     * layoutConstraintsInVisitOrder() in validator.hpp - the branches are
+     * adjacent in the arena, so the prefetches cover a contiguous range.
+     */
+    template<typename ConstraintType>
+    static void prefetchBranches(const ConstraintType &constraint)
+    {
+        constraint.applyToSubschemas(
+                [](unsigned int, const Subschema *subschema) {
+                    if (subschema != nullptr) {
+                        subschema->prefetchConstraints();
+                    }
+                    return true;
+                });
+    }
+
+    /**
+     * @brief  Evaluate the branches of a 'oneOf' or 'anyOf' combinator as a
+     *         batch of tasks on the configured executor
+     *
+     * Each branch is validated by its own visitor into its own results
+     * object, and the per-branch outcomes are aggregated in branch order
+     * once the batch completes, so the verdict and the order of reported
+     * errors match serial evaluation. Evaluation is speculative: every
+     * branch runs, whereas serial 'anyOf' evaluation stops at the first
+     * success.
+     *
+     * @param  constraint  combinator whose branches should be evaluated
+     * @param  exactlyOne  \c true for 'oneOf' semantics, \c false for
+     *                     'anyOf'
+     *
+     * @return  \c true if the combinator is satisfied; \c false otherwise
+     */
+    template<typename ConstraintType>
+    bool validateBranchesInParallel(const ConstraintType &constraint,
+            bool exactlyOne)
+    {
+        std::vector<const Subschema *> branches;
+        constraint.applyToSubschemas(
+                [&branches](unsigned int, const Subschema *subschema) {
+                    branches.push_back(subschema);
+                    return true;
+                });
+
+        const size_t numBranches = branches.size();
+        std::vector<ValidationResults> branchResults(
+                m_results ? numBranches : 0);
+        std::vector<unsigned char> branchValidated(numBranches, 0);
+
+        std::vector<std::function<void()>> tasks;
+        tasks.reserve(numBranches);
+        for (size_t index = 0; index < numBranches; index++) {
+            const Subschema *subschema = branches[index];
+            ValidationResults *results =
+                    m_results ? &branchResults[index] : nullptr;
+            unsigned char *validated = &branchValidated[index];
+            tasks.push_back([this, subschema, results, validated]() {
+                // Branch visitors deliberately do not carry the executor:
+                // combinators nested inside a branch task are evaluated
+                // serially, since a bounded executor could otherwise
+                // deadlock waiting for workers that are themselves waiting
+                // on nested batches. The scratch arena is not carried
+                // either, as it is not safe to bump-allocate from multiple
+                // threads. The cancellation token is carried, so parallel
+                // branches observe cancellation just as serial ones do.
+                // The memoization cache is not carried, as it is not
+                // thread-safe
+                ValidationVisitor branchVisitor(m_target, m_context,
+                        m_strictTypes, results, m_instrumentation,
+                        ParallelOptions(), nullptr, m_cancellation, m_budget,
+                        nullptr);
+                *validated = branchVisitor.validateSchema(*subschema) ? 1 : 0;
+            });
+        }
+
+        m_parallel.executor->run(tasks);
+
+        size_t numValidated = 0;
+        for (size_t index = 0; index < numBranches; index++) {
+            if (branchValidated[index]) {
+                numValidated++;
+            }
+        }
+
+        if (exactlyOne) {
+            if (numValidated == 1) {
+                return true;
+            }
+            if (m_results) {
+                if (numValidated == 0) {
+                    mergeBranchErrors(branches, branchResults,
+                            branchValidated);
+                    m_results->pushError(m_context,
+                            ValidationResults::kOneOfFailed,
+                            [&]() { return "Failed to validate against any "
+                            "child schemas allowed by oneOf constraint."; });
+                } else {
+                    m_results->pushError(m_context,
+                            ValidationResults::kOneOfFailed,
+                            [&]() { return "Failed to validate against exactly one child schema."; });
+                }
+            }
+            return false;
+        }
+
+        if (numValidated > 0) {
+            return true;
+        }
+        if (m_results) {
+            mergeBranchErrors(branches, branchResults, branchValidated);
+            m_results->pushError(m_context, ValidationResults::kAnyOfFailed,
+                    [&]() { return "Failed to validate against any schemas allowed by anyOf constraint."; });
+        }
+        return false;
+    }
+
+    /**
+     * @brief  Copy the errors of each failing branch into the main results
+     *         object, in branch order
+     *
+     * Each branch's own errors are followed by a per-branch failure record,
+     * matching the order produced by serial evaluation.
+     */
+    void mergeBranchErrors(const std::vector<const Subschema *> &branches,
+            std::vector<ValidationResults> &branchResults,
+            const std::vector<unsigned char> &branchValidated)
+    {
+        for (size_t index = 0; index < branches.size(); index++) {
+            if (branchValidated[index]) {
+                continue;
+            }
+
+            ValidationResults::Error error;
+            while (branchResults[index].popError(error)) {
+                m_results->pushError(error);
+            }
+
+            m_results->pushError(m_context, ValidationResults::kUnspecified,
+                    [index]() { return "Failed to validate against child schema #" + std::to_string(index) + "."; },
+                    branches[index]);
+        }
+    }
+
     struct ValidateSubschemas
     {
         ValidateSubschemas(
                 const AdapterType &adapter,
-                const std::vector<std::string> &context,
+                const internal::ValidationContext &context,
                 bool continueOnSuccess,
                 bool continueOnFailure,
                 ValidationVisitor &validationVisitor,
@@ -1816,8 +2979,8 @@ private:
             }
 
             if (m_results) {
-                m_results->pushError(m_context,
-                        "Failed to validate against child schema #" + std::to_string(index) + ".");
+                m_results->pushError(m_context, ValidationResults::kUnspecified,
+                        [&]() { return "Failed to validate against child schema #" + std::to_string(index) + "."; }, subschema);
             }
 
             return m_continueOnFailure;
@@ -1825,7 +2988,7 @@ private:
 
     private:
         const AdapterType &m_adapter;
-        const std::vector<std::string> &m_context;
+        const internal::ValidationContext &m_context;
         bool m_continueOnSuccess;
         bool m_continueOnFailure;
         ValidationVisitor &m_validationVisitor;
@@ -1835,64 +2998,116 @@ private:
     };
 
     /**
-     * @brief  Callback function that passes a visitor to a constraint.
+     * @brief  Return the length, in characters, of the target string
+     *
+     * The target value does not change over the lifetime of a visitor, so
+     * the UTF-8 length is computed on first use and then reused; subschemas
+     * that define both minLength and maxLength only pay for one pass over
+     * the string.
+     *
+     * Must only be called once the caller has established that the target
+     * is (or may be) a string.
+     */
+    /**
+     * @brief  Classify the target's type as a bitmask of named JSON types
      *
-     * @param  constraint  Reference to constraint to be visited
-     * @param  visitor     Reference to visitor to be applied
+     * Probes the target once, returning a mask of the TypeConstraint named
+     * types that the value strictly satisfies; weak typing conversions are
+     * not considered. An integer value satisfies both 'integer' and
+     * 'number'.
      *
-     * @return  true if the visitor returns successfully, false otherwise.
+     * @returns  bitmask with bits given by TypeConstraint::jsonTypeMask()
      */
-    static bool validationCallback(const constraints::Constraint &constraint, ValidationVisitor<AdapterType, RegexEngine> &visitor)
+    unsigned int strictTypeMask() const
     {
-        return constraint.accept(visitor);
+        if (m_target.isArray()) {
+            return TypeConstraint::jsonTypeMask(TypeConstraint::kArray);
+        } else if (m_target.isObject()) {
+            return TypeConstraint::jsonTypeMask(TypeConstraint::kObject);
+        } else if (m_target.isString()) {
+            return TypeConstraint::jsonTypeMask(TypeConstraint::kString);
+        } else if (m_target.isNull()) {
+            return TypeConstraint::jsonTypeMask(TypeConstraint::kNull);
+        } else if (m_target.isBool()) {
+            return TypeConstraint::jsonTypeMask(TypeConstraint::kBoolean);
+        } else if (m_target.isInteger()) {
+            return TypeConstraint::jsonTypeMask(TypeConstraint::kInteger) |
+                    TypeConstraint::jsonTypeMask(TypeConstraint::kNumber);
+        } else if (m_target.isNumber()) {
+            return TypeConstraint::jsonTypeMask(TypeConstraint::kNumber);
+        }
+
+        return 0;
     }
 
     /**
-     * @brief    Helper function to validate if day is valid for given month
-     *
-     * @param    month   Month, 1-12
-     * @param    day     Day, 1-31
+     * @brief  Detects whether a regex engine provides the optional zero-copy
+     *         search overload that takes a character range
+     */
+    template<typename Engine>
+    struct RegexEngineHasViewSearch
+    {
+        template<typename T>
+        static std::true_type test(
+                decltype(T::search(static_cast<const char *>(nullptr), size_t(0),
+                        std::declval<const T &>())) *);
+
+        template<typename>
+        static std::false_type test(...);
+
+        typedef decltype(test<Engine>(nullptr)) type;
+    };
+
+    /**
+     * @brief  Search the target string using the engine's zero-copy overload
      *
-     * @return   \c true if day is valid for given month, \c false otherwise.
+     * When the adapter can expose its storage as a view, no copy of the
+     * target string is made; among other things this keeps property name
+     * validation against a 'pattern' constraint free of heap allocations.
      */
-    bool validate_date_range(int month, int day)
+    bool searchPattern(const RegexEngine &regex, std::true_type)
     {
-        if (month == 2) {
-            if (day < 0 || day > 29) {
-                if (m_results) {
-                    m_results->pushError(m_context,
-                                         "String should be a valid date-time");
-                }
-                return false;
-            }
-        } else {
-            int limit = 31;
-            if (month <= 7) {
-                if (month % 2 == 0) {
-                    limit = 30;
-                }
-            } else {
-                if (month % 2 != 0) {
-                    limit = 30;
-                }
-            }
-            if (day < 0 || day > limit) {
-                if (m_results) {
-                    m_results->pushError(m_context,
-                                         "String should be a valid date-time");
-                }
-                return false;
+        internal::string_view view;
+        std::string scratch;
+        if (m_target.getStringView(view, scratch)) {
+            return RegexEngine::search(view.data(), view.size(), regex);
+        }
+
+        return RegexEngine::search(m_target.asString(), regex);
+    }
+
+    /**
+     * @brief  Search the target string using the engine's std::string
+     *         overload, for custom engines without a zero-copy overload
+     */
+    bool searchPattern(const RegexEngine &regex, std::false_type)
+    {
+        return RegexEngine::search(m_target.asString(), regex);
+    }
+
+    uint64_t targetStringLength()
+    {
+        if (!m_lengthComputed) {
+            // A zero-copy view is used when the adapter's storage allows it
+            internal::string_view view;
+            std::string scratch;
+            if (!m_target.getStringView(view, scratch)) {
+                scratch = m_target.asString();
+                view = internal::string_view(scratch);
             }
 
+            m_cachedLength = utils::u8_strlen(view.data(), view.size());
+            m_lengthComputed = true;
         }
-        return true;
+
+        return m_cachedLength;
     }
 
     /// The JSON value being validated
     AdapterType m_target;
 
-    /// Vector of strings describing the current object context
-    std::vector<std::string> m_context;
+    /// Context frame describing the location of the value being validated
+    const internal::ValidationContext &m_context;
 
     /// Optional pointer to a ValidationResults object to be populated
     ValidationResults *m_results;
@@ -1900,8 +3115,29 @@ private:
     /// Option to use strict type comparison
     bool m_strictTypes;
 
-    /// Cached regex objects for pattern constraint
-    std::unordered_map<std::string, RegexEngine>& m_regexesCache;
+    /// Policy through which constraint evaluations are dispatched
+    Instrumentation m_instrumentation;
+
+    /// Options for parallel evaluation of combinator branches
+    ParallelOptions m_parallel;
+
+    /// Optional arena from which transient containers are allocated
+    ScratchArena *m_scratch;
+
+    /// Optional token through which this validation run can be cancelled
+    CancellationToken *m_cancellation;
+
+    /// Optional budget charged as the run performs work
+    ValidationBudget *m_budget;
+
+    /// Optional cache of validation outcomes for small subtrees
+    ValidationCache *m_memo;
+
+    /// Whether the length of the target string has been computed yet
+    bool m_lengthComputed;
+
+    /// Memoised length of the target string, in characters
+    uint64_t m_cachedLength;
 };
 
 }  // namespace valijson
@@ -1,6 +1,16 @@
 #pragma once
 
+#include <algorithm>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+#include <valijson/adapters/scalar_value_adapter.hpp>
+#include <valijson/internal/json_hash.hpp>
+#include <valijson/parallel_executor.hpp>
 #include <valijson/schema.hpp>
+#include <valijson/schema_statistics.hpp>
 #include <valijson/validation_visitor.hpp>
 
 namespace valijson {
@@ -56,15 +66,325 @@ public:
      * @param  results  An optional pointer to a ValidationResults instance that
      *                  will be used to report validation errors
      *
+     * This function is const, and a Validator instance holds no mutable
+     * state, so a single Validator may be shared by multiple threads that
+     * validate against the same schema concurrently. Regular expressions
+     * are compiled once per schema and cached within the constraints
+     * themselves, rather than in per-Validator storage.
+     *
+     * @returns  true if validation succeeds, false otherwise
+     */
+    template<typename AdapterType>
+    bool validate(const Subschema &schema, const AdapterType &target,
+            ValidationResults *results) const
+    {
+        // Construct a ValidationVisitor to perform validation at the root
+        // level; path strings for error descriptions are only materialised
+        // from the chain of context frames when an error is recorded
+        const internal::ValidationContext rootContext;
+        ValidationVisitor<AdapterType, RegexEngine> v(target, rootContext,
+                strictTypes, results);
+
+        return v.validateSchema(schema);
+    }
+
+    /**
+     * @brief  Validate a JSON document while collecting profiling statistics.
+     *
+     * Behaves exactly like the plain \c validate overload, but dispatches
+     * every constraint evaluation through a ProfilingInstrumentation policy
+     * that records per-constraint-type invocation counts and wall-clock
+     * timings in the provided ValidationStats instance. Counters are
+     * accumulated rather than reset, so the same instance may be reused
+     * across several calls to aggregate statistics.
+     *
+     * The instrumented visitor is a distinct template instantiation, so the
+     * plain overload is unaffected and pays no cost for this facility.
+     *
+     * @param  schema   The schema to validate against
+     * @param  target   A rapidjson::Value to be validated
+     * @param  results  An optional pointer to a ValidationResults instance that
+     *                  will be used to report validation errors
+     * @param  stats    ValidationStats instance that accumulates counters
+     *
+     * @returns  true if validation succeeds, false otherwise
+     */
+    template<typename AdapterType>
+    bool validate(const Subschema &schema, const AdapterType &target,
+            ValidationResults *results, ValidationStats &stats) const
+    {
+        const internal::ValidationContext rootContext;
+        ValidationVisitor<AdapterType, RegexEngine, ProfilingInstrumentation> v(
+                target, rootContext, strictTypes, results,
+                ProfilingInstrumentation(stats));
+
+        return v.validateSchema(schema);
+    }
+
+    /**
+     * @brief  Validate a JSON document while emitting span events to a
+     *         trace sink.
+     *
+     * Behaves exactly like the plain \c validate overload, but brackets
+     * each sub-schema visit and each constraint evaluation with
+     * enter/leave events on the sink carried by the supplied
+     * TracingInstrumentation policy, so an external tracer can attribute
+     * cycles to schema locations rather than to one monolithic visitor
+     * frame. See TracingInstrumentation for the sink interface.
+     *
+     * The traced visitor is a distinct template instantiation, so the
+     * plain overload is unaffected and pays no cost for this facility.
+     *
+     * @param  schema   The schema to validate against
+     * @param  target   Document to be validated
+     * @param  results  An optional pointer to a ValidationResults instance
+     *                  that will be used to report validation errors
+     * @param  tracing  Policy carrying the sink that span events are
+     *                  emitted to
+     *
+     * @returns  true if validation succeeds, false otherwise
+     */
+    template<typename AdapterType, typename TraceSink>
+    bool validate(const Subschema &schema, const AdapterType &target,
+            ValidationResults *results,
+            const TracingInstrumentation<TraceSink> &tracing) const
+    {
+        const internal::ValidationContext rootContext;
+        ValidationVisitor<AdapterType, RegexEngine,
+                TracingInstrumentation<TraceSink>> v(
+                target, rootContext, strictTypes, results, tracing);
+
+        return v.validateSchema(schema);
+    }
+
+    /**
+     * @brief  Validate a JSON document, evaluating wide combinators in
+     *         parallel.
+     *
+     * Behaves exactly like the plain \c validate overload, but the branches
+     * of 'oneOf' and 'anyOf' constraints with at least
+     * ParallelOptions::minBranches branches are evaluated as a batch of
+     * tasks on the supplied executor, which can reduce single-document
+     * latency for schemas dominated by wide combinators. Outcomes are
+     * aggregated in branch order, so the verdict and the order of reported
+     * errors match serial validation.
+     *
+     * The schema must not be modified while validation is in progress; this
+     * is the same requirement that applies to concurrent validation from
+     * multiple threads.
+     *
+     * @param  schema    The schema to validate against
+     * @param  target    Document to be validated
+     * @param  results   An optional pointer to a ValidationResults instance
+     *                   that will be used to report validation errors
+     * @param  parallel  Options naming the executor and the branch-count
+     *                   threshold for parallel evaluation
+     *
+     * @returns  true if validation succeeds, false otherwise
+     */
+    template<typename AdapterType>
+    bool validate(const Subschema &schema, const AdapterType &target,
+            ValidationResults *results, const ParallelOptions &parallel) const
+    {
+        const internal::ValidationContext rootContext;
+        ValidationVisitor<AdapterType, RegexEngine> v(target, rootContext,
+                strictTypes, results, NoInstrumentation(), parallel);
+
+        return v.validateSchema(schema);
+    }
+
+    /**
+     * @brief  Validate a JSON document using a caller-provided scratch
+     *         arena for transient allocations.
+     *
+     * Behaves exactly like the plain \c validate overload, but the
+     * short-lived containers built during validation - matched-property
+     * sets, sorted member name lists, uniqueness buckets - are allocated
+     * from the supplied arena instead of the global allocator. The arena is
+     * reset at the start of each call, so once it has grown to the
+     * high-water mark of a workload, steady-state validation performs no
+     * global-allocator calls for that transient state.
+     *
+     * An arena must not be shared by validations running concurrently; use
+     * one arena per thread.
+     *
+     * @param  schema   The schema to validate against
+     * @param  target   Document to be validated
+     * @param  results  An optional pointer to a ValidationResults instance
+     *                  that will be used to report validation errors
+     * @param  scratch  Arena from which transient containers are allocated;
+     *                  its contents are invalidated by this call
+     *
      * @returns  true if validation succeeds, false otherwise
      */
     template<typename AdapterType>
     bool validate(const Subschema &schema, const AdapterType &target,
-            ValidationResults *results)
+            ValidationResults *results, ScratchArena &scratch) const
+    {
+        scratch.reset();
+
+        const internal::ValidationContext rootContext;
+        ValidationVisitor<AdapterType, RegexEngine> v(target, rootContext,
+                strictTypes, results, NoInstrumentation(), ParallelOptions(),
+                &scratch);
+
+        return v.validateSchema(schema);
+    }
+
+    /**
+     * @brief  Validate a JSON document, subject to cooperative cancellation.
+     *
+     * Behaves exactly like the plain \c validate overload, but the supplied
+     * CancellationToken is polled at sub-schema boundaries as validation
+     * proceeds. When cancellation is requested - explicitly via
+     * CancellationToken::cancel(), or implicitly by a deadline attached to
+     * the token - the remainder of the run is abandoned: this function
+     * returns false, and where a ValidationResults instance was provided,
+     * its cancelled() flag is set so that a cancelled run can be
+     * distinguished from a document that failed validation.
+     *
+     * Polling the token costs a relaxed atomic load per sub-schema, with
+     * the clock consulted for deadline checks at a much lower rate, so the
+     * overhead on uncancelled runs is negligible.
+     *
+     * @param  schema        The schema to validate against
+     * @param  target        Document to be validated
+     * @param  results       An optional pointer to a ValidationResults
+     *                       instance that will be used to report validation
+     *                       errors
+     * @param  cancellation  Token polled during validation; may be shared
+     *                       with other runs that should be cancelled as a
+     *                       group
+     *
+     * @returns  true if validation succeeds, false if the document failed
+     *           validation or the run was cancelled
+     */
+    template<typename AdapterType>
+    bool validate(const Subschema &schema, const AdapterType &target,
+            ValidationResults *results, CancellationToken &cancellation) const
+    {
+        const internal::ValidationContext rootContext;
+        ValidationVisitor<AdapterType, RegexEngine> v(target, rootContext,
+                strictTypes, results, NoInstrumentation(), ParallelOptions(),
+                nullptr, &cancellation);
+
+        const bool validated = v.validateSchema(schema);
+
+        // A combinator can absorb the failure of a cancelled sub-schema -
+        // 'not' inverts it, 'if' redirects it - so the token is checked
+        // again here to make sure a cancelled run never reports success
+        if (cancellation.isCancelled()) {
+            if (results) {
+                results->markCancelled();
+            }
+            return false;
+        }
+
+        return validated;
+    }
+
+    /**
+     * @brief  Validate a JSON document subject to a budget on the work the
+     *         run may perform.
+     *
+     * Behaves exactly like the plain \c validate overload, but the supplied
+     * ValidationBudget is charged as validation proceeds: each constraint
+     * evaluation and each regular expression execution counts against its
+     * limits, and the depth of each value visited is checked against the
+     * depth limit. When any limit is crossed, the remainder of the run is
+     * abandoned at the next sub-schema boundary: this function returns
+     * false, and where a ValidationResults instance was provided, an error
+     * with code kBudgetExceeded is recorded and its budgetExceeded() flag
+     * is set, so that an over-budget run can be distinguished from a
+     * document that failed validation.
+     *
+     * Unlike a deadline on a CancellationToken, which fires at a point that
+     * depends on machine load, a budget bounds the work itself, so the same
+     * schema/document pair is accepted or rejected deterministically.
+     *
+     * @param  schema   The schema to validate against
+     * @param  target   Document to be validated
+     * @param  results  An optional pointer to a ValidationResults instance
+     *                  that will be used to report validation errors
+     * @param  budget   Budget charged during validation; call
+     *                  ValidationBudget::reset() before reusing it for
+     *                  another run
+     *
+     * @returns  true if validation succeeds, false if the document failed
+     *           validation or the budget was exceeded
+     */
+    template<typename AdapterType>
+    bool validate(const Subschema &schema, const AdapterType &target,
+            ValidationResults *results, ValidationBudget &budget) const
+    {
+        const internal::ValidationContext rootContext;
+        ValidationVisitor<AdapterType, RegexEngine> v(target, rootContext,
+                strictTypes, results, NoInstrumentation(), ParallelOptions(),
+                nullptr, nullptr, &budget);
+
+        const bool validated = v.validateSchema(schema);
+
+        // A combinator can absorb the failure of an abandoned sub-schema -
+        // 'not' inverts it, 'if' redirects it - so the budget is checked
+        // again here to make sure an over-budget run never reports success
+        if (budget.exceeded()) {
+            if (results) {
+                const char *limit = budget.exceededLimit();
+                results->pushError(rootContext,
+                        ValidationResults::kBudgetExceeded,
+                        [limit]() {
+                            return "Validation abandoned after exceeding "
+                                    "its budget for " + std::string(limit);
+                        });
+                results->markBudgetExceeded();
+            }
+            return false;
+        }
+
+        return validated;
+    }
+
+    /**
+     * @brief  Validate a JSON document, memoizing the outcomes of repeated
+     *         identical subtrees.
+     *
+     * Behaves exactly like the plain \c validate overload, but small array
+     * and object subtrees are validated once per sub-schema; later
+     * occurrences of a structurally identical subtree under the same
+     * sub-schema are resolved by a cache lookup. This pays off on documents
+     * that denormalize reference data, where the same small object appears
+     * many times; documents without repeated subtrees pay only the cost of
+     * encoding their small subtrees.
+     *
+     * The accepted/rejected outcome and the errors recorded in an optional
+     * ValidationResults instance are identical to those the plain overload
+     * would produce: when errors are being collected, a cached failure is
+     * ignored and the subtree is re-validated so that each occurrence
+     * reports its own errors.
+     *
+     * The cache is reset at the start of each call, since an outcome cached
+     * for one schema/document pair says nothing about another; constructing
+     * the cache once and reusing it across calls merely avoids re-growing
+     * its hash table.
+     *
+     * @param  schema   The schema to validate against
+     * @param  target   Document to be validated
+     * @param  results  An optional pointer to a ValidationResults instance
+     *                  that will be used to report validation errors
+     * @param  cache    Cache in which subtree outcomes are recorded
+     *
+     * @returns  true if validation succeeds
+     */
+    template<typename AdapterType>
+    bool validate(const Subschema &schema, const AdapterType &target,
+            ValidationResults *results, ValidationCache &cache) const
     {
-        // Construct a ValidationVisitor to perform validation at the root level
-        ValidationVisitor<AdapterType, RegexEngine> v(target,
-                std::vector<std::string>(1, "<root>"), strictTypes, results, regexesCache);
+        cache.reset();
+
+        const internal::ValidationContext rootContext;
+        ValidationVisitor<AdapterType, RegexEngine> v(target, rootContext,
+                strictTypes, results, NoInstrumentation(), ParallelOptions(),
+                nullptr, nullptr, nullptr, &cache);
 
         return v.validateSchema(schema);
     }
@@ -73,9 +393,6 @@ private:
 
     /// Flag indicating that strict type comparisons should be used
     bool strictTypes;
-
-    /// Cached regex objects for pattern constraint. Key - pattern.
-    std::unordered_map<std::string, RegexEngine> regexesCache;
 };
 
 /**
@@ -91,10 +408,795 @@ struct DefaultRegexEngine
         return std::regex_search(s, r.regex);
     }
 
+    /**
+     * @brief  Search a character range without materialising a std::string
+     *
+     * This overload is optional for custom regex engines; when absent, the
+     * validator falls back to the std::string overload.
+     */
+    static bool search(const char *data, size_t size, const DefaultRegexEngine& r)
+    {
+        return std::regex_search(data, data + size, r.regex);
+    }
+
 private:
     std::regex regex;
 };
 
+/**
+ * @brief  Eagerly compile the regular expressions used by the 'pattern' and
+ *         'patternProperties' constraints in a schema
+ *
+ * Without this, each regular expression is compiled the first time that its
+ * constraint is visited during validation. Calling this function after parsing
+ * a schema moves that cost to a predictable point in time, which can be useful
+ * when the first validation attempt is latency sensitive.
+ *
+ * Compiled expressions are stored within the constraints themselves, so they
+ * are shared by all Validator instances that use the schema.
+ *
+ * @tparam  RegexEngine  regular expression engine used for pattern constraint
+ *                       validation
+ *
+ * @param  schema  Schema whose regular expressions should be compiled
+ */
+template<typename RegexEngine = DefaultRegexEngine>
+void precompilePatterns(const Schema &schema)
+{
+    const auto fn = [](const constraints::Constraint &constraint) {
+        // This is a cold path that is run at most once per schema, so the
+        // cost of dynamic_cast is acceptable here
+        if (const auto *pattern =
+                dynamic_cast<const constraints::PatternConstraint *>(&constraint)) {
+            pattern->getCompiledRegex<RegexEngine>();
+        } else if (const auto *properties =
+                dynamic_cast<const constraints::PropertiesConstraint *>(&constraint)) {
+            properties->precompilePatternRegexes();
+        }
+
+        return true;
+    };
+
+    schema.applyToSubschemas([&fn](const Subschema &subschema) {
+        subschema.forEachConstraint(fn);
+        return true;
+    });
+}
+
+/**
+ * @brief  Estimate the relative cost of evaluating a constraint
+ *
+ * Constraints are grouped into coarse tiers: checks that inspect only the
+ * target's type or size, then scalar comparisons, then passes over string
+ * contents, then constraints that apply sub-schemas to members or elements,
+ * and finally combinators that may evaluate several sub-schemas. Custom
+ * constraints derived from PolyConstraint have unknown cost and are placed
+ * in the most expensive tier.
+ *
+ * @param  constraint  Constraint whose cost should be estimated
+ *
+ * @returns  integer rank; lower means cheaper
+ */
+inline int estimateConstraintCost(const constraints::Constraint &constraint)
+{
+    using namespace constraints;
+
+    // This is a cold path that is run once per schema, so the cost of
+    // dynamic_cast is acceptable here
+    if (dynamic_cast<const TypeConstraint *>(&constraint)) {
+        return 0;
+    }
+
+    if (dynamic_cast<const RequiredConstraint *>(&constraint) ||
+        dynamic_cast<const MinItemsConstraint *>(&constraint) ||
+        dynamic_cast<const MaxItemsConstraint *>(&constraint) ||
+        dynamic_cast<const MinPropertiesConstraint *>(&constraint) ||
+        dynamic_cast<const MaxPropertiesConstraint *>(&constraint) ||
+        dynamic_cast<const MinimumConstraint *>(&constraint) ||
+        dynamic_cast<const MaximumConstraint *>(&constraint) ||
+        dynamic_cast<const MultipleOfIntConstraint *>(&constraint) ||
+        dynamic_cast<const MultipleOfDoubleConstraint *>(&constraint) ||
+        dynamic_cast<const ConstConstraint *>(&constraint) ||
+        dynamic_cast<const EnumConstraint *>(&constraint)) {
+        return 1;
+    }
+
+    if (dynamic_cast<const MinLengthConstraint *>(&constraint) ||
+        dynamic_cast<const MaxLengthConstraint *>(&constraint) ||
+        dynamic_cast<const PatternConstraint *>(&constraint) ||
+        dynamic_cast<const FormatConstraint *>(&constraint)) {
+        return 2;
+    }
+
+    if (dynamic_cast<const PropertiesConstraint *>(&constraint) ||
+        dynamic_cast<const FusedObjectConstraint *>(&constraint) ||
+        dynamic_cast<const PropertyNamesConstraint *>(&constraint) ||
+        dynamic_cast<const LinearItemsConstraint *>(&constraint) ||
+        dynamic_cast<const SingularItemsConstraint *>(&constraint) ||
+        dynamic_cast<const DependenciesConstraint *>(&constraint) ||
+        dynamic_cast<const ContainsConstraint *>(&constraint) ||
+        dynamic_cast<const UniqueItemsConstraint *>(&constraint)) {
+        return 3;
+    }
+
+    return 4;
+}
+
+/**
+ * @brief  Reorder each sub-schema's constraints so cheap checks run first
+ *
+ * Constraints are normally evaluated in the order they appear in the schema
+ * document, so an expensive combinator such as 'oneOf' can run before a
+ * trivial 'type' check that would have rejected the document outright. This
+ * pass sorts every sub-schema's constraints by estimated cost, which lets
+ * fail-fast validation reject invalid documents after the cheapest failing
+ * check. Constraints with equal estimated cost keep their relative order.
+ *
+ * The new order also applies when validating exhaustively, so the order of
+ * reported errors may change after calling this function.
+ *
+ * @param  schema  Schema whose constraints should be re-ordered
+ */
+inline void scheduleCheapConstraintsFirst(Schema &schema)
+{
+    schema.scheduleConstraints([](const constraints::Constraint &constraint) {
+        return estimateConstraintCost(constraint);
+    });
+}
+
+/**
+ * @brief  Merge a sub-schema's 'required' constraints into one
+ *
+ * Several 'required' constraints on the same sub-schema - typically left
+ * behind by flattenAllOfConstraints() - each probe the target object for
+ * their own list of names. Requiring all of the names is equivalent to
+ * requiring the union, so the constraints are replaced by a single
+ * constraint over the combined list.
+ *
+ * @param  subschema  Sub-schema whose 'required' constraints should merge
+ */
+inline void mergeRequiredConstraints(Subschema &subschema)
+{
+    using namespace constraints;
+
+    std::vector<const RequiredConstraint *> parts;
+
+    // This is a cold path that is run once per schema, so the cost of
+    // dynamic_cast is acceptable here
+    subschema.forEachConstraint([&parts](const Constraint &constraint) {
+        if (const auto *r = dynamic_cast<const RequiredConstraint *>(&constraint)) {
+            parts.push_back(r);
+        }
+        return true;
+    });
+
+    if (parts.size() < 2) {
+        return;
+    }
+
+    RequiredConstraint merged;
+    for (const RequiredConstraint *part : parts) {
+        part->applyToRequiredProperties(
+                [&merged](const RequiredConstraint::String &name) {
+                    merged.addRequiredProperty(
+                            std::string(name.data(), name.size()));
+                    return true;
+                });
+    }
+
+    // The merged constraint is added (which clones it into the sub-schema)
+    // before the originals are removed
+    subschema.addConstraint(merged);
+    subschema.removeConstraints([&parts](const Constraint &constraint) {
+        return std::find(parts.begin(), parts.end(), &constraint) !=
+                parts.end();
+    });
+}
+
+/**
+ * @brief  Merge a sub-schema's 'properties' constraints into one, where
+ *         doing so cannot change the result of validation
+ *
+ * Several 'properties' constraints on the same sub-schema - typically left
+ * behind by flattenAllOfConstraints() - each traverse the target object's
+ * members. When their property names and patterns are pairwise disjoint,
+ * and every constraint accepts additional properties unconditionally,
+ * validating against the union of their maps is equivalent, and a single
+ * traversal suffices.
+ *
+ * A constraint whose 'additionalProperties' sub-schema is missing (which
+ * rejects unmatched members) or non-trivial applies it to exactly the
+ * members its own maps do not cover, so widening the maps would change
+ * its reach; such constraints are never merged. Overlapping names are
+ * also left alone, since a name constrained by two maps cannot be
+ * expressed as one entry.
+ *
+ * @param  subschema  Sub-schema whose 'properties' constraints should merge
+ */
+inline void mergePropertiesConstraints(Subschema &subschema)
+{
+    using namespace constraints;
+
+    std::vector<const PropertiesConstraint *> parts;
+
+    // This is a cold path that is run once per schema, so the cost of
+    // dynamic_cast is acceptable here
+    subschema.forEachConstraint([&parts](const Constraint &constraint) {
+        if (const auto *p = dynamic_cast<const PropertiesConstraint *>(&constraint)) {
+            parts.push_back(p);
+        }
+        return true;
+    });
+
+    if (parts.size() < 2) {
+        return;
+    }
+
+    std::set<std::string> names;
+    std::set<std::string> patterns;
+    for (const PropertiesConstraint *part : parts) {
+        const Subschema *additional = part->getAdditionalPropertiesSubschema();
+        if (additional == nullptr || !additional->isAlwaysValid()) {
+            return;
+        }
+
+        bool disjoint = true;
+        part->applyToProperties(
+                [&](const PropertiesConstraint::String &name, const Subschema *) {
+                    disjoint = names.insert(
+                            std::string(name.data(), name.size())).second;
+                    return disjoint;
+                });
+        if (!disjoint) {
+            return;
+        }
+
+        part->applyToPatternProperties(
+                [&](const PropertiesConstraint::String &pattern, const Subschema *) {
+                    disjoint = patterns.insert(
+                            std::string(pattern.data(), pattern.size())).second;
+                    return disjoint;
+                });
+        if (!disjoint) {
+            return;
+        }
+    }
+
+    PropertiesConstraint merged;
+    merged.setAdditionalPropertiesSubschema(
+            parts.front()->getAdditionalPropertiesSubschema());
+    for (const PropertiesConstraint *part : parts) {
+        part->applyToProperties(
+                [&merged](const PropertiesConstraint::String &name,
+                        const Subschema *propertySubschema) {
+                    merged.addPropertySubschema(
+                            std::string(name.data(), name.size()),
+                            propertySubschema);
+                    return true;
+                });
+        part->applyToPatternProperties(
+                [&merged](const PropertiesConstraint::String &pattern,
+                        const Subschema *patternSubschema) {
+                    merged.addPatternPropertySubschema(
+                            std::string(pattern.data(), pattern.size()),
+                            patternSubschema);
+                    return true;
+                });
+    }
+
+    // The merged constraint is added (which clones it into the sub-schema)
+    // before the originals are removed
+    subschema.addConstraint(merged);
+    subschema.removeConstraints([&parts](const Constraint &constraint) {
+        return std::find(parts.begin(), parts.end(), &constraint) !=
+                parts.end();
+    });
+}
+
+/**
+ * @brief  Hoist the branches of 'allOf' constraints into the sub-schemas
+ *         that hold them
+ *
+ * An 'allOf' constraint validates the same target against each of its
+ * branch sub-schemas in turn, so five branches produced by code-generated
+ * inheritance - an OpenAPI base type and its extensions, for example -
+ * each dispatch their own 'type' check and re-walk the same object
+ * members. Since 'allOf' is plain conjunction, its branch constraints can
+ * instead be copied into the sub-schema that holds the combinator, and
+ * the combinator removed, eliminating the per-branch dispatch.
+ *
+ * After hoisting, 'required' constraints accumulated from the branches
+ * are merged into one, and disjoint 'properties' constraints are merged
+ * so that the object's members are traversed once; see
+ * mergeRequiredConstraints() and mergePropertiesConstraints() for the
+ * conditions under which merging is possible. A combinator with a branch
+ * that refers, directly or through nested 'allOf' constraints, back to
+ * the sub-schema holding it is left in place, since recursion cannot be
+ * flattened; each branch's constraints are hoisted into a given
+ * sub-schema at most once, so shared and cyclic branches are safe.
+ *
+ * The flattened schema produces the same verdicts, but errors that were
+ * reported through the combinator ("Failed to validate against child
+ * schema...") are reported directly by the hoisted constraints, and a
+ * flattened schema serializes in its flattened form.
+ *
+ * Call this after parsing, and before the schema is shared with validating
+ * threads. It composes with the other passes, and should be run before
+ * fuseObjectConstraints(), so that hoisted object constraints are
+ * candidates for fusion.
+ *
+ * @param  schema  Schema whose 'allOf' constraints should be flattened
+ */
+inline void flattenAllOfConstraints(Schema &schema)
+{
+    using namespace constraints;
+
+    schema.transformSubschemas([](Subschema &subschema) {
+        // Branches whose constraints have already been hoisted into this
+        // sub-schema; hoisting each branch at most once ensures that
+        // cyclic references terminate
+        std::set<const Subschema *> hoisted;
+        hoisted.insert(&subschema);
+
+        while (true) {
+            const AllOfConstraint *target = nullptr;
+
+            // This is a cold path that is run once per schema, so the cost
+            // of dynamic_cast is acceptable here
+            subschema.forEachConstraint([&](const Constraint &constraint) {
+                const auto *allOf =
+                        dynamic_cast<const AllOfConstraint *>(&constraint);
+                if (allOf == nullptr) {
+                    return true;
+                }
+
+                // A branch that refers back to this sub-schema would copy
+                // the combinator into itself, so it is left in place
+                bool hoistable = true;
+                allOf->applyToSubschemas(
+                        [&](unsigned int, const Subschema *branch) {
+                            hoistable = (branch != &subschema);
+                            return hoistable;
+                        });
+                if (!hoistable) {
+                    return true;
+                }
+
+                target = allOf;
+                return false;
+            });
+
+            if (target == nullptr) {
+                break;
+            }
+
+            std::vector<const Subschema *> branches;
+            target->applyToSubschemas(
+                    [&branches](unsigned int, const Subschema *branch) {
+                        branches.push_back(branch);
+                        return true;
+                    });
+
+            // The combinator is removed before its branches are copied, so
+            // that nested 'allOf' constraints hoisted from the branches are
+            // picked up by later iterations of this loop
+            subschema.removeConstraints([target](const Constraint &constraint) {
+                return &constraint == target;
+            });
+
+            for (const Subschema *branch : branches) {
+                if (!hoisted.insert(branch).second) {
+                    continue;
+                }
+
+                branch->forEachConstraint(
+                        [&subschema](const Constraint &constraint) {
+                            subschema.addConstraint(constraint);
+                            return true;
+                        });
+            }
+        }
+
+        mergeRequiredConstraints(subschema);
+        mergePropertiesConstraints(subschema);
+    });
+}
+
+/**
+ * @brief  Fuse each sub-schema's object-related constraints into a single
+ *         constraint that scans the object's members once
+ *
+ * A sub-schema that constrains an object may hold up to five constraints
+ * that each traverse, probe or size the same object during validation:
+ * 'properties' (with 'patternProperties' and 'additionalProperties'),
+ * 'required', 'propertyNames', 'minProperties' and 'maxProperties'. This
+ * pass replaces them, wherever at least two are present, with a single
+ * FusedObjectConstraint that a validator evaluates in one pass over the
+ * object's members.
+ *
+ * The fused constraint produces the same verdict as the constraints it
+ * replaces, but errors may be reported in a different order, because they
+ * are discovered member-by-member rather than constraint-by-constraint.
+ *
+ * Call this after parsing, and before the schema is shared with validating
+ * threads. Serialization is unaffected: a fused constraint is written as
+ * the records of its original parts.
+ *
+ * @param  schema  Schema whose object constraints should be fused
+ */
+inline void fuseObjectConstraints(Schema &schema)
+{
+    using namespace constraints;
+
+    schema.transformSubschemas([](Subschema &subschema) {
+        const PropertiesConstraint *properties = nullptr;
+        const RequiredConstraint *required = nullptr;
+        const PropertyNamesConstraint *propertyNames = nullptr;
+        const MinPropertiesConstraint *minProperties = nullptr;
+        const MaxPropertiesConstraint *maxProperties = nullptr;
+        bool duplicates = false;
+
+        // This is a cold path that is run once per schema, so the cost of
+        // dynamic_cast is acceptable here
+        subschema.forEachConstraint([&](const Constraint &constraint) {
+            if (const auto *p = dynamic_cast<const PropertiesConstraint *>(&constraint)) {
+                duplicates = duplicates || (properties != nullptr);
+                properties = p;
+            } else if (const auto *r = dynamic_cast<const RequiredConstraint *>(&constraint)) {
+                duplicates = duplicates || (required != nullptr);
+                required = r;
+            } else if (const auto *n = dynamic_cast<const PropertyNamesConstraint *>(&constraint)) {
+                duplicates = duplicates || (propertyNames != nullptr);
+                propertyNames = n;
+            } else if (const auto *lo = dynamic_cast<const MinPropertiesConstraint *>(&constraint)) {
+                duplicates = duplicates || (minProperties != nullptr);
+                minProperties = lo;
+            } else if (const auto *hi = dynamic_cast<const MaxPropertiesConstraint *>(&constraint)) {
+                duplicates = duplicates || (maxProperties != nullptr);
+                maxProperties = hi;
+            }
+            return true;
+        });
+
+        const size_t numParts =
+                (properties ? 1 : 0) + (required ? 1 : 0) +
+                (propertyNames ? 1 : 0) + (minProperties ? 1 : 0) +
+                (maxProperties ? 1 : 0);
+
+        // Fusing a single constraint would not save a traversal, and a
+        // sub-schema holding several constraints of the same kind is left
+        // alone rather than guessing which instance to fuse
+        if (duplicates || numParts < 2) {
+            return;
+        }
+
+        // The fused constraint copies its parts, so it is added (which
+        // clones it into the sub-schema) before the originals are removed
+        const FusedObjectConstraint fused(properties, required, propertyNames,
+                minProperties, maxProperties);
+        subschema.addConstraint(fused);
+
+        subschema.removeConstraints([](const Constraint &constraint) {
+            return dynamic_cast<const PropertiesConstraint *>(&constraint) != nullptr ||
+                   dynamic_cast<const RequiredConstraint *>(&constraint) != nullptr ||
+                   dynamic_cast<const PropertyNamesConstraint *>(&constraint) != nullptr ||
+                   dynamic_cast<const MinPropertiesConstraint *>(&constraint) != nullptr ||
+                   dynamic_cast<const MaxPropertiesConstraint *>(&constraint) != nullptr;
+        });
+    });
+}
+
+/**
+ * @brief  Build a discriminator index for 'oneOf' constraints whose
+ *         sub-schemas are distinguished by a constant property
+ *
+ * A common schema idiom gives every branch of a 'oneOf' a property with a
+ * distinct constant value - for example a 'type' property constrained by
+ * 'const', or by a single-value 'enum', in each branch. For such schemas
+ * the target's value for that property identifies the only branch that
+ * could possibly validate, so the remaining branches can be skipped rather
+ * than evaluated and rejected one at a time.
+ *
+ * This pass detects the idiom: for each 'oneOf' constraint it searches for
+ * a property that every branch pins to a constant value through its
+ * 'properties' keyword, with values whose canonical hashes are pairwise
+ * distinct, and attaches an index from value hash to branch. A validator
+ * only consults the index in fail-fast mode with strict type checking,
+ * because the index models strict equality and skipping branches would
+ * change the set of reported errors; see
+ * ValidationVisitor::visit(const OneOfConstraint &).
+ *
+ * Call this after parsing, and before the schema is shared with validating
+ * threads. It composes with the other passes: properties fused by
+ * fuseObjectConstraints() are recognised. The index is derived data and is
+ * not serialized, so the pass should be run again after deserializing a
+ * schema.
+ *
+ * @param  schema  Schema whose 'oneOf' constraints should be indexed
+ */
+inline void indexOneOfDiscriminators(Schema &schema)
+{
+    using namespace constraints;
+
+    // Returns true if a property sub-schema pins the property to a constant
+    // value whose canonical hash can be computed
+    const auto constantValueHash = [](const Subschema *subschema, size_t &valueHash) {
+        bool found = false;
+
+        // This is a cold path that is run once per schema, so the cost of
+        // dynamic_cast is acceptable here
+        subschema->forEachConstraint([&](const Constraint &constraint) {
+            if (const auto *constConstraint = dynamic_cast<const ConstConstraint *>(&constraint)) {
+                if (constConstraint->hasValueHash()) {
+                    valueHash = constConstraint->getValueHash();
+                    found = true;
+                } else if (const auto *scalar = dynamic_cast<const adapters::ScalarValueFrozenValue *>(
+                        constConstraint->getValue())) {
+                    valueHash = internal::hashJsonValue(adapters::ScalarValueAdapter(scalar->getValue()));
+                    found = true;
+                }
+                return false;
+            }
+
+            if (const auto *enumConstraint = dynamic_cast<const EnumConstraint *>(&constraint)) {
+                size_t numValues = 0;
+                const adapters::FrozenValue *singleValue = nullptr;
+                enumConstraint->applyToValues([&](const adapters::FrozenValue &value) {
+                    singleValue = &value;
+                    numValues++;
+                    return numValues < 2;
+                });
+                if (numValues == 1) {
+                    if (const auto *scalar = dynamic_cast<const adapters::ScalarValueFrozenValue *>(singleValue)) {
+                        valueHash = internal::hashJsonValue(adapters::ScalarValueAdapter(scalar->getValue()));
+                        found = true;
+                    }
+                }
+                return false;
+            }
+
+            return true;
+        });
+
+        return found;
+    };
+
+    // Returns the 'properties' constraint governing a branch, whether it is
+    // standalone or part of a fused object constraint
+    const auto propertiesOf = [](const Subschema *branch) -> const PropertiesConstraint * {
+        const PropertiesConstraint *properties = nullptr;
+        bool duplicates = false;
+
+        branch->forEachConstraint([&](const Constraint &constraint) {
+            const auto *p = dynamic_cast<const PropertiesConstraint *>(&constraint);
+            if (!p) {
+                if (const auto *fused = dynamic_cast<const FusedObjectConstraint *>(&constraint)) {
+                    if (fused->hasProperties()) {
+                        p = &fused->getProperties();
+                    }
+                }
+            }
+            if (p) {
+                duplicates = duplicates || (properties != nullptr);
+                properties = p;
+            }
+            return true;
+        });
+
+        return duplicates ? nullptr : properties;
+    };
+
+    // Returns true if a branch pins the named property to a constant value,
+    // and provides the canonical hash of that value
+    const auto discriminatorHashOf = [&](const Subschema *branch, const std::string &propertyName,
+            size_t &valueHash) {
+        const PropertiesConstraint *properties = propertiesOf(branch);
+        if (!properties) {
+            return false;
+        }
+
+        const Subschema *propertySubschema = nullptr;
+        properties->applyToProperties(
+                [&](const PropertiesConstraint::String &name, const Subschema *subschema) {
+                    if (propertyName.compare(name.c_str()) == 0) {
+                        propertySubschema = subschema;
+                        return false;
+                    }
+                    return true;
+                });
+
+        return propertySubschema != nullptr && constantValueHash(propertySubschema, valueHash);
+    };
+
+    schema.transformSubschemas([&](Subschema &subschema) {
+        std::vector<const Constraint *> replaced;
+        std::vector<OneOfConstraint> indexed;
+
+        subschema.forEachConstraint([&](const Constraint &constraint) {
+            const auto *oneOf = dynamic_cast<const OneOfConstraint *>(&constraint);
+            if (!oneOf || oneOf->hasDiscriminator()) {
+                return true;
+            }
+
+            std::vector<const Subschema *> branches;
+            oneOf->applyToSubschemas([&](unsigned int, const Subschema *branch) {
+                branches.push_back(branch);
+                return true;
+            });
+
+            // With a single branch there is nothing to discriminate between
+            if (branches.size() < 2) {
+                return true;
+            }
+
+            // Any property that the first branch pins to a constant value is
+            // a candidate; the remaining branches decide whether it is usable
+            const PropertiesConstraint *firstProperties = propertiesOf(branches[0]);
+            if (!firstProperties) {
+                return true;
+            }
+
+            std::vector<std::string> candidates;
+            firstProperties->applyToProperties(
+                    [&](const PropertiesConstraint::String &name, const Subschema *propertySubschema) {
+                        size_t valueHash;
+                        if (constantValueHash(propertySubschema, valueHash)) {
+                            candidates.push_back(name.c_str());
+                        }
+                        return true;
+                    });
+
+            for (const std::string &candidate : candidates) {
+                std::vector<size_t> valueHashes(branches.size());
+                bool usable = true;
+                for (size_t i = 0; usable && i < branches.size(); i++) {
+                    usable = discriminatorHashOf(branches[i], candidate, valueHashes[i]);
+                }
+                if (!usable) {
+                    continue;
+                }
+
+                // The indexed copy replaces the original constraint; index
+                // insertion fails when two branches share a value hash, in
+                // which case the candidate cannot discriminate between them
+                OneOfConstraint copy(*oneOf);
+                copy.setDiscriminatorProperty(candidate);
+                for (size_t i = 0; usable && i < branches.size(); i++) {
+                    usable = copy.addDiscriminatorValue(valueHashes[i], branches[i]);
+                }
+                if (!usable) {
+                    continue;
+                }
+
+                replaced.push_back(oneOf);
+                indexed.push_back(copy);
+                break;
+            }
+
+            return true;
+        });
+
+        if (replaced.empty()) {
+            return;
+        }
+
+        // The indexed copies are added (which clones them into the
+        // sub-schema) after the originals are removed
+        subschema.removeConstraints([&](const Constraint &constraint) {
+            return std::find(replaced.begin(), replaced.end(), &constraint) != replaced.end();
+        });
+        for (const OneOfConstraint &constraint : indexed) {
+            subschema.addConstraint(constraint);
+        }
+    });
+}
+
+/**
+ * @brief  Recompile a schema so constraints are laid out in expected visit
+ *         order, with branches weighted by a caller-provided function
+ *
+ * Schema::compile() makes each sub-schema's constraints contiguous, but
+ * places the sub-schemas themselves in an arbitrary order, so the branches
+ * of a combinator such as 'allOf' can still land far apart in the arena.
+ * This pass performs a depth-first traversal of the schema graph from the
+ * root - visiting each sub-schema's references in the order a validator
+ * dispatches to them - and recompiles the schema with sub-schemas laid out
+ * in that order, so a branch's constraints follow its parent's in memory.
+ *
+ * Where a sub-schema references several others, the weight function breaks
+ * the tie: children with larger weights are laid out first. Weights would
+ * typically come from measured branch frequencies, for example counters
+ * gathered through the validation instrumentation surface; a weight of
+ * zero is fine and preserves reference order.
+ *
+ * Call this after parsing and after any passes that add or remove
+ * constraints, such as fuseObjectConstraints(), since recompiling clones
+ * the constraints that exist at the time of the call. It must not run
+ * while other threads are validating against the schema.
+ *
+ * @param  schema    Schema to be recompiled in visit order
+ * @param  weightFn  callable that returns an integer weight for a given
+ *                   Subschema; larger weights are laid out earlier
+ */
+template<typename WeightFunction>
+inline void layoutConstraintsInVisitOrder(Schema &schema,
+        const WeightFunction &weightFn)
+{
+    // Collect the sub-schemas referenced by each sub-schema's constraints,
+    // in dispatch order; the statistics collector already knows how to
+    // enumerate references for every constraint type, and the counters it
+    // gathers along the way are simply discarded
+    std::map<const Subschema *, std::vector<const Subschema *>> references;
+    SchemaStatistics discardedStatistics;
+    schema.applyToSubschemas([&](const Subschema &subschema) {
+        SchemaStatisticsCollector collector(discardedStatistics,
+                references[&subschema]);
+        subschema.forEachConstraint(
+                [&collector](const constraints::Constraint &constraint) {
+                    constraint.accept(collector);
+                    return true;
+                });
+        return true;
+    });
+
+    // Iterative depth-first traversal from the root; children are pushed in
+    // reverse so that the heaviest child is laid out, and later faulted in,
+    // immediately after its parent. The scheduled set guards against
+    // reference cycles
+    std::vector<const Subschema *> order;
+    std::set<const Subschema *> scheduled;
+    std::vector<const Subschema *> stack;
+    stack.push_back(schema.root());
+    scheduled.insert(schema.root());
+
+    while (!stack.empty()) {
+        const Subschema *current = stack.back();
+        stack.pop_back();
+        order.push_back(current);
+
+        const auto itr = references.find(current);
+        if (itr == references.end()) {
+            continue;
+        }
+
+        std::vector<const Subschema *> children;
+        for (const Subschema *child : itr->second) {
+            if (child != schema.emptySubschema() &&
+                    scheduled.insert(child).second) {
+                children.push_back(child);
+            }
+        }
+
+        std::stable_sort(children.begin(), children.end(),
+                [&weightFn](const Subschema *lhs, const Subschema *rhs) {
+                    return weightFn(*lhs) > weightFn(*rhs);
+                });
+
+        for (auto child = children.rbegin(); child != children.rend();
+                ++child) {
+            stack.push_back(*child);
+        }
+    }
+
+    // Sub-schemas unreachable from the root are appended by compile()
+    schema.compile(order);
+}
+
+/**
+ * @brief  Recompile a schema so constraints are laid out in expected visit
+ *         order
+ *
+ * Equivalent to the weighted overload with all sub-schemas weighted
+ * equally, so each sub-schema's references are laid out in dispatch order.
+ *
+ * @param  schema  Schema to be recompiled in visit order
+ */
+inline void layoutConstraintsInVisitOrder(Schema &schema)
+{
+    layoutConstraintsInVisitOrder(schema,
+            [](const Subschema &) { return 0u; });
+}
+
 using Validator = ValidatorT<DefaultRegexEngine>;
 
 }  // namespace valijson
@@ -0,0 +1,140 @@
+#include <sstream>
+#include <stdexcept>
+
+#include <QJsonDocument>
+#include <QJsonParseError>
+#include <QString>
+
+#include <valijson/adapters/qtjson_adapter.hpp>
+#include <valijson/resumable_validator.hpp>
+#include <valijson/schema.hpp>
+#include <valijson/schema_parser.hpp>
+#include <valijson/validation_results.hpp>
+
+#include "validationworker.h"
+
+namespace {
+
+// Number of deferred work items validated between cancellation checks; small
+// enough that an abandoned validation of a large document stops promptly
+const size_t sliceSize = 2048;
+
+} // end anonymous namespace
+
+ValidationWorker::ValidationWorker(QObject * parent)
+  : QObject(parent)
+  , m_latestRequest(0)
+{
+}
+
+void ValidationWorker::supersede(quint64 latestRequest)
+{
+    m_latestRequest.storeRelease(latestRequest);
+}
+
+bool ValidationWorker::superseded(quint64 request) const
+{
+    return m_latestRequest.loadAcquire() != request;
+}
+
+void ValidationWorker::process(quint64 request, const QString & schemaText, const QString & documentText)
+{
+    // Requests queue up behind a slow validation; skip those that were
+    // superseded before they even started
+    if (superseded(request)) {
+        return;
+    }
+
+    const auto schema = schemaText.toUtf8();
+    const auto doc = documentText.toUtf8();
+
+    QString errors;
+    QJsonDocument schemaJson;
+    QJsonDocument documentJson;
+
+    if (schema.isEmpty()) {
+        if (doc.isEmpty()) {
+            emit finished(request,
+              "Please provide a schema and a document to be validated.\n\n"
+              "Note that this example uses QtJson, which does not consider non-array and "
+              "non-object values to be valid JSON documents.");
+            return;
+        } else {
+            errors += "Schema error: must not be empty\n\n";
+        }
+    } else {
+        QJsonParseError error;
+        schemaJson = QJsonDocument::fromJson(schema, &error);
+        if (schemaJson.isNull()) {
+            errors += QString("Schema error: ") + error.errorString() + "\n\n";
+        }
+    }
+
+    if (doc.isEmpty()) {
+        if (!schema.isEmpty()) {
+            errors += "Document error: must not be empty\n\n";
+        }
+    } else {
+        QJsonParseError error;
+        documentJson = QJsonDocument::fromJson(doc, &error);
+        if (documentJson.isNull()) {
+            errors += QString("Document error: ") + error.errorString() + "\n\n";
+        }
+    }
+
+    if (!errors.isEmpty()) {
+        emit finished(request, errors);
+        return;
+    }
+
+    valijson::Schema parsedSchema;
+    try {
+        valijson::adapters::QtJsonAdapter adapter(schemaJson.object());
+        valijson::SchemaParser parser;
+        parser.populateSchema(adapter, parsedSchema);
+    } catch (std::runtime_error & error) {
+        emit finished(request, QString("Schema error: ") + error.what());
+        return;
+    }
+
+    // Schema parsing is not interruptible, but a request superseded while it
+    // ran can at least skip validation
+    if (superseded(request)) {
+        return;
+    }
+
+    // Validate in slices so that an in-flight validation of a large document
+    // can be abandoned as soon as a newer edit arrives
+    valijson::ValidationResults results;
+    valijson::adapters::QtJsonAdapter adapter(documentJson.object());
+    valijson::ResumableValidation<valijson::adapters::QtJsonAdapter> session(
+        parsedSchema, adapter, &results);
+
+    while (!session.step(sliceSize)) {
+        if (superseded(request)) {
+            return;
+        }
+    }
+
+    if (session.isValid()) {
+        emit finished(request, "Document is valid.");
+        return;
+    }
+
+    valijson::ValidationResults::Error error;
+    unsigned int errorNum = 1;
+    std::stringstream ss;
+    while (results.popError(error)) {
+        std::string context;
+        for (auto & itr : error.context) {
+            context += itr;
+        }
+
+        ss << "Validation error #" << errorNum << std::endl
+            << "  context: " << context << std::endl
+            << "  desc:    " << error.description << std::endl;
+        ++errorNum;
+    }
+
+    emit finished(request, QString::fromStdString(ss.str()));
+}
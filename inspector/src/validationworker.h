@@ -0,0 +1,35 @@
+#pragma once
+
+#include <QAtomicInteger>
+#include <QObject>
+
+// Performs schema parsing and document validation away from the GUI thread.
+//
+// An instance is moved to a worker thread by the Window; requests arrive via
+// the process() slot and results are posted back through the finished()
+// signal, both as queued cross-thread connections. Each request carries a
+// monotonically increasing number, and the GUI thread records the latest
+// number via supersede(); a request that is no longer the latest is
+// abandoned, either before it starts or at the next cancellation check
+// between validation slices.
+class ValidationWorker : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit ValidationWorker(QObject * parent = nullptr);
+
+    // Called from the GUI thread to mark older requests as stale
+    void supersede(quint64 latestRequest);
+
+public slots:
+    void process(quint64 request, const QString & schemaText, const QString & documentText);
+
+signals:
+    void finished(quint64 request, const QString & message);
+
+private:
+    bool superseded(quint64 request) const;
+
+    QAtomicInteger<quint64> m_latestRequest;
+};
@@ -1,6 +1,3 @@
-#include <sstream>
-#include <stdexcept>
-
 #include <QFile>
 #include <QFileDialog>
 #include <QMenu>
@@ -9,21 +6,26 @@
 #include <QString>
 #include <QTabWidget>
 #include <QTextEdit>
+#include <QThread>
+#include <QTimer>
 #include <QToolBar>
 #include <QToolButton>
 
-#include <valijson/adapters/qtjson_adapter.hpp>
-#include <valijson/schema.hpp>
-#include <valijson/schema_parser.hpp>
-#include <valijson/validation_results.hpp>
-#include <valijson/validator.hpp>
-
 #include "highlighter.h"
+#include "validationworker.h"
 #include "window.h"
 
+namespace {
+
+// Delay between the last edit and the validation it triggers; long enough to
+// coalesce a burst of keystrokes, short enough to feel responsive
+const int debounceIntervalMsec = 300;
+
+} // end anonymous namespace
+
 Window::Window(QWidget * parent)
   : QMainWindow(parent)
-  , m_schema(nullptr)
+  , m_validationRequest(0)
 {
     setWindowTitle("JSON Inspector");
 
@@ -47,10 +49,34 @@ Window::Window(QWidget * parent)
     setCentralWidget(verticalSplitter);
     setStatusBar(statusBar);
 
-    connect(m_documentEditor, SIGNAL(textChanged()), this, SLOT(refreshJson()));
-    connect(m_schemaEditor, SIGNAL(textChanged()), this, SLOT(refreshJson()));
+    // Parsing and validation run on a worker thread, so that editing a large
+    // schema or document does not stall the GUI; requests and results cross
+    // the thread boundary as queued signals
+    m_workerThread = new QThread(this);
+    m_worker = new ValidationWorker();
+    m_worker->moveToThread(m_workerThread);
+    connect(m_workerThread, &QThread::finished, m_worker, &QObject::deleteLater);
+    connect(this, &Window::validationRequested, m_worker, &ValidationWorker::process);
+    connect(m_worker, &ValidationWorker::finished, this, &Window::handleValidationResults);
+    m_workerThread->start();
+
+    m_debounceTimer = new QTimer(this);
+    m_debounceTimer->setSingleShot(true);
+    m_debounceTimer->setInterval(debounceIntervalMsec);
+    connect(m_debounceTimer, &QTimer::timeout, this, &Window::startValidation);
+
+    connect(m_documentEditor, SIGNAL(textChanged()), this, SLOT(scheduleValidation()));
+    connect(m_schemaEditor, SIGNAL(textChanged()), this, SLOT(scheduleValidation()));
+
+    startValidation();
+}
 
-    refreshJson();
+Window::~Window()
+{
+    // Mark any in-flight validation as stale so the worker stops promptly
+    m_worker->supersede(++m_validationRequest);
+    m_workerThread->quit();
+    m_workerThread->wait();
 }
 
 QTextEdit * Window::createEditor(bool readOnly)
@@ -116,61 +142,36 @@ QToolBar * Window::createToolBar()
     return toolbar;
 }
 
-void Window::refreshJson()
+void Window::scheduleValidation()
 {
-    QString errors;
-    m_errors->setText("");
-
-    const auto schema = m_schemaEditor->toPlainText().toUtf8();
-    const auto doc = m_documentEditor->toPlainText().toUtf8();
-
-    if (schema.isEmpty()) {
-        if (doc.isEmpty()) {
-            m_errors->setText(
-              "Please provide a schema and a document to be validated.\n\n"
-              "Note that this example uses QtJson, which does not consider non-array and "
-              "non-object values to be valid JSON documents.");
-            return;
-        } else {
-            errors += "Schema error: must not be empty\n\n";
-        }
-    } else {
-        QJsonParseError error;
-        m_schemaJson = QJsonDocument::fromJson(schema, &error);
-        if (m_schemaJson.isNull()) {
-            errors += QString("Schema error: ") + error.errorString() + "\n\n";
-        }
-    }
+    // Abandon any in-flight validation right away - its input is already
+    // stale - and restart the debounce window
+    m_worker->supersede(m_validationRequest + 1);
+    m_debounceTimer->start();
+}
 
-    if (doc.isEmpty()) {
-        if (!schema.isEmpty()) {
-            errors += "Document error: must not be empty\n\n";
-        }
-    } else {
-        QJsonParseError error;
-        m_documentJson = QJsonDocument::fromJson(doc, &error);
-        if (m_documentJson.isNull()) {
-            errors += QString("Document error: ") + error.errorString() + "\n\n";
-        }
-    }
+void Window::startValidation()
+{
+    const quint64 request = ++m_validationRequest;
+    m_worker->supersede(request);
 
-    if (!errors.isEmpty()) {
-      m_errors->setText(errors);
-      return;
-    }
+    statusBar()->showMessage("Validating...");
 
-    try {
-        valijson::adapters::QtJsonAdapter adapter(m_schemaJson.object());
-        valijson::SchemaParser parser;
-        delete m_schema;
-        m_schema = new valijson::Schema();
-        parser.populateSchema(adapter, *m_schema);
-        validate();
-    } catch (std::runtime_error & error) {
-        delete m_schema;
-        m_schema = nullptr;
-        m_errors->setText(QString("Schema error: ") + error.what());
+    emit validationRequested(request,
+        m_schemaEditor->toPlainText(),
+        m_documentEditor->toPlainText());
+}
+
+void Window::handleValidationResults(quint64 request, const QString & message)
+{
+    // Results from an abandoned request may still arrive; show only the
+    // results that match the latest request
+    if (request != m_validationRequest) {
+        return;
     }
+
+    statusBar()->clearMessage();
+    m_errors->setText(message);
 }
 
 void Window::showOpenDocumentDialog()
@@ -192,32 +193,3 @@ void Window::showOpenSchemaDialog()
         m_schemaEditor->setText(file.readAll());
     }
 }
-
-void Window::validate()
-{
-    valijson::ValidationResults results;
-    valijson::Validator validator;
-    valijson::adapters::QtJsonAdapter adapter(m_documentJson.object());
-
-    if (validator.validate(*m_schema, adapter, &results)) {
-        m_errors->setText("Document is valid.");
-        return;
-    }
-
-    valijson::ValidationResults::Error error;
-    unsigned int errorNum = 1;
-    std::stringstream ss;
-    while (results.popError(error)) {
-        std::string context;
-        for (auto & itr : error.context) {
-            context += itr;
-        }
-
-        ss << "Validation error #" << errorNum << std::endl
-            << "  context: " << context << std::endl
-            << "  desc:    " << error.description << std::endl;
-        ++errorNum;
-    }
-
-    m_errors->setText(QString::fromStdString(ss.str()));
-}
\ No newline at end of file
@@ -1,18 +1,16 @@
 #pragma once
 
-#include <QJsonDocument>
 #include <QMainWindow>
 
-class QJsonDocument;
 class QSplitter;
 class QStatusBar;
 class QTabWidget;
 class QTextEdit;
+class QThread;
+class QTimer;
 class QToolBar;
 
-namespace valijson {
-    class Schema;
-}
+class ValidationWorker;
 
 class Window : public QMainWindow
 {
@@ -20,13 +18,21 @@ class Window : public QMainWindow
 
 public:
     explicit Window(QWidget * parent = 0);
+    ~Window();
+
+signals:
+    void validationRequested(quint64 request, const QString & schemaText, const QString & documentText);
 
 public slots:
-    void refreshJson();
+    void scheduleValidation();
 
     void showOpenDocumentDialog();
     void showOpenSchemaDialog();
 
+private slots:
+    void startValidation();
+    void handleValidationResults(quint64 request, const QString & message);
+
 private:
     QTextEdit * createEditor(bool readOnly);
     QSplitter * createSplitter(QWidget * left, QWidget * right, bool horizontal);
@@ -34,15 +40,14 @@ private:
     QTabWidget * createTabWidget(QWidget * child, const QString & name);
     QToolBar * createToolBar();
 
-    void validate();
-
     QTextEdit * m_documentEditor;
     QTextEdit * m_schemaEditor;
 
     QTextEdit * m_errors;
 
-    QJsonDocument m_documentJson;
-    QJsonDocument m_schemaJson;
+    QTimer * m_debounceTimer;
+    QThread * m_workerThread;
+    ValidationWorker * m_worker;
 
-    valijson::Schema * m_schema;
+    quint64 m_validationRequest;
 };
@@ -0,0 +1,14 @@
+/**
+ * @file
+ *
+ * @brief   Definitions for the explicit instantiations declared in
+ *          valijson/instantiations.hpp
+ *
+ * Compiled once into the valijson_precompiled static library, so that
+ * translation units including valijson/instantiations.hpp need not
+ * re-instantiate the validation templates for the rapidjson adapter.
+ */
+
+#define VALIJSON_DEFINE_INSTANTIATIONS
+
+#include <valijson/instantiations.hpp>
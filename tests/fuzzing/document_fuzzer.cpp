@@ -0,0 +1,304 @@
+/**
+ * Persistent-mode fuzzing harness for the document side of validation.
+ *
+ * The schema-oriented harnesses (fuzzer.cpp, perf_fuzzer.cpp) re-enter
+ * schema parsing on every input, so most of each execution is spent in
+ * SchemaParser rather than in the code the fuzzer is meant to explore. This
+ * harness compiles a fixed set of representative schemas exactly once, and
+ * treats every input as a document to validate against one of them: the
+ * first byte selects the schema, and the remaining bytes are parsed as the
+ * document. Each execution therefore exercises only adapter traversal and
+ * ValidationVisitor dispatch, which raises throughput by orders of
+ * magnitude and reaches the constraint-evaluation bugs - algorithmic
+ * blowups included - correspondingly sooner.
+ *
+ * The embedded schemas are chosen to cover the major constraint families:
+ * typed objects with patterns and bounds, combinators over '$ref'-linked
+ * definitions, string formats and enums, a recursive tree schema, and
+ * tuple items with dependencies and patternProperties.
+ *
+ * When compiled with VALIJSON_FUZZ_REPLAY_MAIN defined, the harness builds
+ * as a standalone binary that replays a corpus in a timed loop and reports
+ * executions per second, serving as a macro throughput benchmark for
+ * release comparisons; see the fuzz_replay target in CMakeLists.txt.
+ */
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+
+#include <document.h>
+#include <valijson/adapters/rapidjson_adapter.hpp>
+#include <valijson/schema.hpp>
+#include <valijson/schema_parser.hpp>
+#include <valijson/validation_results.hpp>
+#include <valijson/validator.hpp>
+
+using valijson::Schema;
+using valijson::SchemaParser;
+using valijson::ValidationResults;
+using valijson::Validator;
+using valijson::adapters::RapidJsonAdapter;
+
+namespace {
+
+const char * const kSchemaDocuments[] = {
+
+    // Typed object: properties with patterns and numeric bounds, required
+    // members, bounded arrays with uniqueItems, closed to additions
+    R"({
+        "type": "object",
+        "properties": {
+            "name": { "type": "string", "pattern": "^[a-z][a-z0-9_]*$", "minLength": 1, "maxLength": 64 },
+            "count": { "type": "integer", "minimum": 0, "maximum": 1000000 },
+            "ratio": { "type": "number", "exclusiveMinimum": 0, "exclusiveMaximum": 1 },
+            "tags": { "type": "array", "items": { "type": "string" }, "uniqueItems": true, "maxItems": 16 }
+        },
+        "required": ["name", "count"],
+        "additionalProperties": false
+    })",
+
+    // Combinators over definitions connected through '$ref'
+    R"({
+        "definitions": {
+            "id": { "type": "integer", "minimum": 1 },
+            "label": { "type": "string", "minLength": 1 },
+            "entry": {
+                "type": "object",
+                "properties": {
+                    "id": { "$ref": "#/definitions/id" },
+                    "label": { "$ref": "#/definitions/label" }
+                },
+                "required": ["id"]
+            }
+        },
+        "oneOf": [
+            { "$ref": "#/definitions/entry" },
+            { "type": "array", "items": { "$ref": "#/definitions/entry" }, "minItems": 1 }
+        ],
+        "not": { "type": "null" }
+    })",
+
+    // String formats, enumerated and constant values
+    R"({
+        "type": "object",
+        "properties": {
+            "created": { "type": "string", "format": "date-time" },
+            "contact": { "type": "string", "format": "email" },
+            "link": { "type": "string", "format": "uri" },
+            "state": { "enum": ["new", "active", "closed"] },
+            "version": { "const": 2 }
+        }
+    })",
+
+    // Recursive tree, exercising deep visitor recursion through '$ref'
+    R"({
+        "type": "object",
+        "properties": {
+            "value": { "type": "string" },
+            "children": { "type": "array", "items": { "$ref": "#" }, "maxItems": 32 }
+        },
+        "required": ["value"],
+        "additionalProperties": false
+    })",
+
+    // Tuple items, dependencies, patternProperties and propertyNames
+    R"({
+        "type": "object",
+        "properties": {
+            "pair": {
+                "type": "array",
+                "items": [ { "type": "string" }, { "type": "number" } ],
+                "additionalItems": false
+            }
+        },
+        "patternProperties": {
+            "^x-": { "type": "string" }
+        },
+        "propertyNames": { "pattern": "^[a-zA-Z][a-zA-Z0-9_-]*$" },
+        "dependencies": {
+            "pair": ["kind"]
+        }
+    })"
+};
+
+const size_t kNumSchemas = sizeof(kSchemaDocuments) / sizeof(kSchemaDocuments[0]);
+
+/// Schemas compiled once, on the first execution, and reused by every
+/// subsequent one; this is what makes the harness 'persistent'
+struct CompiledSchemas
+{
+    CompiledSchemas()
+    {
+        for (size_t i = 0; i < kNumSchemas; i++) {
+            rapidjson::Document document;
+            document.Parse(kSchemaDocuments[i]);
+            if (document.HasParseError()) {
+                fprintf(stderr, "document_fuzzer: embedded schema %zu does not parse\n", i);
+                abort();
+            }
+
+            SchemaParser parser;
+            const RapidJsonAdapter adapter(document);
+            parser.populateSchema(adapter, schemas[i]);
+        }
+    }
+
+    Schema schemas[kNumSchemas];
+};
+
+} // namespace
+
+extern "C" int
+LLVMFuzzerTestOneInput(const uint8_t *data, size_t size)
+{
+    static const CompiledSchemas compiled;
+
+    if (size < 2) {
+        return 0;
+    }
+
+    const Schema &schema = compiled.schemas[data[0] % kNumSchemas];
+
+    rapidjson::Document document;
+    document.Parse(reinterpret_cast<const char *>(data) + 1, size - 1);
+    if (document.HasParseError()) {
+        return 0;
+    }
+
+    const RapidJsonAdapter adapter(document);
+    Validator validator;
+    try {
+        if (!validator.validate(schema, adapter, nullptr)) {
+            // Invalid documents are validated a second time collecting
+            // results, so that error description and context formatting
+            // are fuzzed as well
+            ValidationResults results;
+            validator.validate(schema, adapter, &results);
+        }
+    } catch (std::exception &) {
+        return 0;
+    }
+
+    return 0;
+}
+
+#ifdef VALIJSON_FUZZ_REPLAY_MAIN
+
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#ifndef _WIN32
+#include <dirent.h>
+#include <sys/stat.h>
+#endif
+
+namespace {
+
+bool readFile(const std::string &path, std::string &contents)
+{
+    std::ifstream file(path.c_str(), std::ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    contents.assign(std::istreambuf_iterator<char>(file),
+            std::istreambuf_iterator<char>());
+    return true;
+}
+
+void collectInputs(const std::string &path, std::vector<std::string> &inputs)
+{
+#ifndef _WIN32
+    struct stat status;
+    if (stat(path.c_str(), &status) == 0 && S_ISDIR(status.st_mode)) {
+        if (DIR *handle = opendir(path.c_str())) {
+            while (const dirent *entry = readdir(handle)) {
+                const std::string name = entry->d_name;
+                if (name != "." && name != "..") {
+                    collectInputs(path + "/" + name, inputs);
+                }
+            }
+            closedir(handle);
+        }
+        return;
+    }
+#endif
+
+    std::string contents;
+    if (readFile(path, contents)) {
+        inputs.push_back(contents);
+    } else {
+        fprintf(stderr, "fuzz_replay: could not read %s\n", path.c_str());
+    }
+}
+
+} // namespace
+
+/**
+ * Corpus-replay throughput mode. Loads every input under the given files
+ * and directories, replays the whole corpus in a timed loop, and reports
+ * aggregate executions per second - a macro benchmark covering document
+ * parsing, adapter traversal and validation against the pre-compiled
+ * schemas, suitable for comparing releases.
+ */
+int main(int argc, char **argv)
+{
+    size_t iterations = 100;
+    std::vector<std::string> inputs;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--iterations") == 0 && i + 1 < argc) {
+            iterations = static_cast<size_t>(atol(argv[++i]));
+        } else {
+            collectInputs(argv[i], inputs);
+        }
+    }
+
+    if (inputs.empty() || iterations == 0) {
+        fprintf(stderr,
+                "Usage: %s [--iterations N] <corpus file or directory>...\n",
+                argv[0]);
+        return 1;
+    }
+
+    // A single warm-up pass compiles the schemas and touches every input,
+    // so the timed loop measures steady-state throughput
+    size_t totalBytes = 0;
+    for (const std::string &input : inputs) {
+        LLVMFuzzerTestOneInput(
+                reinterpret_cast<const uint8_t *>(input.data()),
+                input.size());
+        totalBytes += input.size();
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    for (size_t iteration = 0; iteration < iterations; iteration++) {
+        for (const std::string &input : inputs) {
+            LLVMFuzzerTestOneInput(
+                    reinterpret_cast<const uint8_t *>(input.data()),
+                    input.size());
+        }
+    }
+    const auto finish = std::chrono::steady_clock::now();
+
+    const double seconds = std::chrono::duration<double>(finish - start).count();
+    const size_t executions = iterations * inputs.size();
+
+    printf("inputs:        %zu\n", inputs.size());
+    printf("iterations:    %zu\n", iterations);
+    printf("executions:    %zu\n", executions);
+    printf("elapsed:       %.3f s\n", seconds);
+    printf("throughput:    %.0f execs/s\n",
+            seconds > 0 ? executions / seconds : 0.0);
+    printf("bandwidth:     %.2f MB/s\n",
+            seconds > 0 ? (iterations * totalBytes) / seconds / 1e6 : 0.0);
+
+    return 0;
+}
+
+#endif // VALIJSON_FUZZ_REPLAY_MAIN
@@ -37,3 +37,25 @@ find ../.. -name "*.o" -exec ar rcs fuzz_lib.a {} \;
 
 zip "${OUT}/fuzzer_seed_corpus.zip" \
 	"${SRC}/valijson/doc/schema/draft-03.json"
+
+# Persistent-mode harness: schemas are compiled once and each input is a
+# document validated against one of them, so executions stay inside the
+# validation stack instead of re-parsing schemas
+
+# shellcheck disable=SC2086
+"$CXX" $CXXFLAGS -DVALIJSON_USE_EXCEPTIONS=1 \
+	-I/src/valijson/thirdparty/rapidjson/include \
+	-I/src/valijson/thirdparty/rapidjson/include/rapidjson \
+	-I/src/valijson/include \
+	-I/src/valijson/include/valijson \
+	-I/src/valijson/include/valijson/adapters \
+	-c document_fuzzer.cpp -o document_fuzzer.o
+
+# shellcheck disable=SC2086
+"$CXX" $CXXFLAGS "$LIB_FUZZING_ENGINE" \
+	-DVALIJSON_USE_EXCEPTIONS=1 \
+	-rdynamic document_fuzzer.o \
+	-o "${OUT}/document_fuzzer" fuzz_lib.a
+
+zip "${OUT}/document_fuzzer_seed_corpus.zip" \
+	"${SRC}"/valijson/tests/fuzzing/document_corpus/*.json
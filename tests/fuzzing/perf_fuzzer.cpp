@@ -0,0 +1,136 @@
+/**
+ * Fuzzing harness that hunts for algorithmic blowups rather than crashes.
+ *
+ * Inputs are JSON arrays of the form [schema, document]. Each input is
+ * validated with profiling instrumentation enabled, and the constraint
+ * evaluation counts and accumulated evaluation time are compared against
+ * budgets that grow linearly with the size of the input. An input whose
+ * validation cost exceeds its budget indicates super-linear behaviour -
+ * catastrophic regex backtracking, quadratic uniqueItems comparisons and
+ * the like - and is archived into a regression corpus directory so that it
+ * can be replayed by the benchmark suite (see
+ * benchmarks/benchmark_perf_corpus.cpp).
+ *
+ * Environment variables:
+ *  - VALIJSON_PERF_CORPUS_DIR  directory that flagged inputs are written
+ *                              to; defaults to ./perf-regression-corpus
+ *  - VALIJSON_PERF_FUZZ_TRAP   when set, the harness aborts on a flagged
+ *                              input so that libFuzzer treats it as a
+ *                              finding and minimises it
+ */
+
+#include <cinttypes>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <stdexcept>
+#include <sys/stat.h>
+
+#include <document.h>
+#include <valijson/adapters/rapidjson_adapter.hpp>
+#include <valijson/schema.hpp>
+#include <valijson/schema_parser.hpp>
+#include <valijson/validation_instrumentation.hpp>
+#include <valijson/validator.hpp>
+
+using valijson::Schema;
+using valijson::SchemaParser;
+using valijson::ValidationStats;
+using valijson::Validator;
+using valijson::adapters::RapidJsonAdapter;
+
+namespace {
+
+// Budgets are linear in the input size, with a fixed allowance so that
+// tiny inputs with legitimately dense schemas are not flagged. The slopes
+// are deliberately generous; anything that trips them is pathological, not
+// merely slow.
+const uint64_t kBaseEvaluationBudget = 50000;
+const uint64_t kEvaluationsPerByte = 200;
+const uint64_t kBaseNanosecondBudget = 5000000;     // 5ms
+const uint64_t kNanosecondsPerByte = 20000;         // 20us
+
+uint64_t fnv1aHash(const uint8_t *data, size_t size)
+{
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    for (size_t i = 0; i < size; i++) {
+        hash = (hash ^ data[i]) * 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+void archiveFlaggedInput(const uint8_t *data, size_t size)
+{
+    const char *dir = getenv("VALIJSON_PERF_CORPUS_DIR");
+    if (!dir) {
+        dir = "perf-regression-corpus";
+    }
+    mkdir(dir, 0755);
+
+    char path[512];
+    snprintf(path, sizeof(path), "%s/perf-%016" PRIx64 ".json", dir,
+            fnv1aHash(data, size));
+    FILE *fp = fopen(path, "wb");
+    if (fp) {
+        fwrite(data, size, 1, fp);
+        fclose(fp);
+        fprintf(stderr, "perf_fuzzer: archived pathological input to %s\n", path);
+    }
+}
+
+} // namespace
+
+extern "C" int
+LLVMFuzzerTestOneInput(const uint8_t *data, size_t size)
+{
+    if (size < 3) {
+        return 0;
+    }
+
+    rapidjson::Document document;
+    document.Parse(reinterpret_cast<const char *>(data), size);
+    if (document.HasParseError() || !document.IsArray() || document.Size() != 2) {
+        return 0;
+    }
+
+    Schema schema;
+    SchemaParser parser;
+    const RapidJsonAdapter schemaAdapter(document[0]);
+    try {
+        parser.populateSchema(schemaAdapter, schema);
+    } catch (std::exception &) {
+        return 0;
+    }
+
+    ValidationStats stats;
+    Validator validator;
+    const RapidJsonAdapter targetAdapter(document[1]);
+    try {
+        validator.validate(schema, targetAdapter, nullptr, stats);
+    } catch (std::exception &) {
+        return 0;
+    }
+
+    uint64_t totalNanoseconds = 0;
+    for (size_t i = 0; i < ValidationStats::kNumConstraintTypes; i++) {
+        totalNanoseconds += stats.totalNanoseconds[i];
+    }
+
+    const uint64_t evaluationBudget = kBaseEvaluationBudget + kEvaluationsPerByte * size;
+    const uint64_t nanosecondBudget = kBaseNanosecondBudget + kNanosecondsPerByte * size;
+
+    if (stats.totalInvocations() > evaluationBudget || totalNanoseconds > nanosecondBudget) {
+        fprintf(stderr,
+                "perf_fuzzer: input of %zu bytes cost %" PRIu64 " evaluations "
+                "(budget %" PRIu64 ") and %" PRIu64 " ns (budget %" PRIu64 ")\n",
+                size, stats.totalInvocations(), evaluationBudget,
+                totalNanoseconds, nanosecondBudget);
+        archiveFlaggedInput(data, size);
+
+        if (getenv("VALIJSON_PERF_FUZZ_TRAP")) {
+            abort();
+        }
+    }
+
+    return 0;
+}
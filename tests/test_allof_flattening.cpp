@@ -0,0 +1,175 @@
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include <valijson/adapters/rapidjson_adapter.hpp>
+#include <valijson/schema.hpp>
+#include <valijson/schema_parser.hpp>
+#include <valijson/validation_results.hpp>
+#include <valijson/validator.hpp>
+
+using valijson::adapters::RapidJsonAdapter;
+using valijson::Schema;
+using valijson::SchemaParser;
+using valijson::ValidationResults;
+using valijson::Validator;
+
+namespace {
+
+// The code-generated inheritance shape the pass is aimed at: a base type
+// and an extension combined through allOf
+const char kInheritanceSchema[] = R"({
+    "allOf": [
+        {
+            "type": "object",
+            "properties": { "id": { "type": "integer" } },
+            "required": ["id"]
+        },
+        {
+            "properties": { "label": { "type": "string" } },
+            "required": ["label"]
+        }
+    ]
+})";
+
+const char *kInheritanceDocuments[] = {
+    R"({ "id": 1, "label": "ok" })",
+    R"({ "id": 1 })",
+    R"({ "label": "ok" })",
+    R"({ "id": "1", "label": "ok" })",
+    R"(17)",
+};
+
+}  // namespace
+
+class TestAllOfFlattening : public ::testing::Test
+{
+protected:
+
+    void parseSchema(const char *schemaJson, Schema &schema)
+    {
+        m_schemaDocument.Parse(schemaJson);
+        ASSERT_FALSE(m_schemaDocument.HasParseError());
+
+        SchemaParser parser;
+        RapidJsonAdapter adapter(m_schemaDocument);
+        ASSERT_NO_THROW(parser.populateSchema(adapter, schema));
+    }
+
+    static bool validate(const Schema &schema, const char *documentJson)
+    {
+        rapidjson::Document document;
+        document.Parse(documentJson);
+        EXPECT_FALSE(document.HasParseError());
+
+        Validator validator;
+        return validator.validate(schema, RapidJsonAdapter(document),
+                nullptr);
+    }
+
+private:
+
+    rapidjson::Document m_schemaDocument;
+};
+
+TEST_F(TestAllOfFlattening, VerdictsUnchangedByFlattening)
+{
+    Schema plain;
+    parseSchema(kInheritanceSchema, plain);
+
+    Schema flattened;
+    parseSchema(kInheritanceSchema, flattened);
+    valijson::flattenAllOfConstraints(flattened);
+
+    for (const char *document : kInheritanceDocuments) {
+        EXPECT_EQ(validate(plain, document), validate(flattened, document))
+                << "document: " << document;
+    }
+}
+
+TEST_F(TestAllOfFlattening, NestedAllOfIsFlattenedTransitively)
+{
+    const char *schemaJson = R"({
+        "allOf": [
+            { "allOf": [
+                { "required": ["a"] },
+                { "required": ["b"] }
+            ] },
+            { "required": ["c"] }
+        ]
+    })";
+
+    Schema schema;
+    parseSchema(schemaJson, schema);
+    valijson::flattenAllOfConstraints(schema);
+
+    EXPECT_TRUE(validate(schema, R"({ "a": 1, "b": 2, "c": 3 })"));
+    EXPECT_FALSE(validate(schema, R"({ "a": 1, "b": 2 })"));
+    EXPECT_FALSE(validate(schema, R"({ "b": 2, "c": 3 })"));
+}
+
+TEST_F(TestAllOfFlattening, DuplicateBoundsRemainConjoined)
+{
+    // Hoisting places both 'minimum' bounds on the items sub-schema; every
+    // consumer of the flattened schema - including the numeric-array sweep
+    // - must enforce the stricter bound, not just the last one hoisted
+    const char *schemaJson = R"({
+        "items": {
+            "allOf": [
+                { "minimum": 10 },
+                { "minimum": 5 }
+            ]
+        }
+    })";
+
+    Schema schema;
+    parseSchema(schemaJson, schema);
+    valijson::flattenAllOfConstraints(schema);
+
+    EXPECT_FALSE(validate(schema, "[7]"));
+    EXPECT_FALSE(validate(schema, "[5]"));
+    EXPECT_TRUE(validate(schema, "[10]"));
+    EXPECT_TRUE(validate(schema, "[11, 12]"));
+}
+
+TEST_F(TestAllOfFlattening, RecursiveBranchesAreLeftInPlace)
+{
+    // The branch refers back to the sub-schema holding the combinator, so
+    // the combinator cannot be flattened; it must keep validating
+    const char *schemaJson = R"({
+        "definitions": {
+            "node": {
+                "allOf": [ { "type": "object" } ],
+                "properties": {
+                    "next": { "$ref": "#/definitions/node" }
+                }
+            }
+        },
+        "$ref": "#/definitions/node"
+    })";
+
+    Schema schema;
+    parseSchema(schemaJson, schema);
+    valijson::flattenAllOfConstraints(schema);
+
+    EXPECT_TRUE(validate(schema, R"({ "next": { "next": {} } })"));
+    EXPECT_FALSE(validate(schema, R"({ "next": 3 })"));
+    EXPECT_FALSE(validate(schema, R"("scalar")"));
+}
+
+TEST_F(TestAllOfFlattening, ComposesWithErrorReporting)
+{
+    Schema schema;
+    parseSchema(kInheritanceSchema, schema);
+    valijson::flattenAllOfConstraints(schema);
+
+    rapidjson::Document document;
+    document.Parse(R"({ "id": "wrong" })");
+    ASSERT_FALSE(document.HasParseError());
+
+    Validator validator;
+    ValidationResults results;
+    EXPECT_FALSE(validator.validate(schema, RapidJsonAdapter(document),
+            &results));
+    EXPECT_GT(results.numErrors(), 0u);
+}
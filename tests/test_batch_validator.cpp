@@ -0,0 +1,151 @@
+#include <deque>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <valijson/adapters/rapidjson_adapter.hpp>
+#include <valijson/batch_validator.hpp>
+#include <valijson/schema.hpp>
+#include <valijson/schema_parser.hpp>
+#include <valijson/validation_results.hpp>
+#include <valijson/validator.hpp>
+
+using valijson::adapters::RapidJsonAdapter;
+using valijson::BatchValidator;
+using valijson::Schema;
+using valijson::SchemaParser;
+using valijson::ValidationResults;
+using valijson::Validator;
+
+class TestBatchValidator : public ::testing::Test
+{
+protected:
+
+    void parseSchema(const char *schemaJson)
+    {
+        m_schemaDocument.Parse(schemaJson);
+        ASSERT_FALSE(m_schemaDocument.HasParseError());
+
+        SchemaParser parser;
+        RapidJsonAdapter adapter(m_schemaDocument);
+        ASSERT_NO_THROW(parser.populateSchema(adapter, m_schema));
+    }
+
+    // Parses one JSON document per entry; the backing documents are kept
+    // alive by the fixture for the lifetime of the adapters
+    std::vector<RapidJsonAdapter> parseBatch(
+            const std::vector<std::string> &documents)
+    {
+        m_documents.clear();
+        for (const std::string &json : documents) {
+            m_documents.emplace_back();
+            m_documents.back().Parse(json.c_str());
+            EXPECT_FALSE(m_documents.back().HasParseError());
+        }
+
+        std::vector<RapidJsonAdapter> adapters;
+        for (const rapidjson::Document &document : m_documents) {
+            adapters.emplace_back(document);
+        }
+        return adapters;
+    }
+
+    Schema m_schema;
+
+private:
+
+    rapidjson::Document m_schemaDocument;
+    std::deque<rapidjson::Document> m_documents;
+};
+
+TEST_F(TestBatchValidator, OutcomesMatchSingleDocumentValidator)
+{
+    parseSchema(R"({
+        "type": "object",
+        "properties": {
+            "id": { "type": "integer", "minimum": 1 },
+            "name": { "type": "string", "pattern": "^[a-z]+$" }
+        },
+        "required": ["id"]
+    })");
+
+    std::vector<std::string> documents;
+    for (int i = 0; i < 40; i++) {
+        switch (i % 4) {
+        case 0:
+            documents.push_back(R"({ "id": 1, "name": "ok" })");
+            break;
+        case 1:
+            documents.push_back(R"({ "name": "missing" })");
+            break;
+        case 2:
+            documents.push_back(R"({ "id": 0 })");
+            break;
+        default:
+            documents.push_back(R"({ "id": 7 })");
+            break;
+        }
+    }
+
+    const std::vector<RapidJsonAdapter> batch = parseBatch(documents);
+
+    Validator single;
+    BatchValidator batchValidator(Validator::kStrongTypes, 4);
+    const std::vector<bool> outcomes =
+            batchValidator.validate(m_schema, batch, nullptr);
+
+    ASSERT_EQ(batch.size(), outcomes.size());
+    for (size_t i = 0; i < batch.size(); i++) {
+        EXPECT_EQ(single.validate(m_schema, batch[i], nullptr), outcomes[i])
+                << "document " << i;
+    }
+}
+
+TEST_F(TestBatchValidator, PerDocumentErrorsAreCollected)
+{
+    parseSchema(R"({ "type": "object", "required": ["id"] })");
+
+    const std::vector<RapidJsonAdapter> batch = parseBatch({
+        R"({ "id": 1 })",
+        R"({})",
+        R"([])",
+    });
+
+    BatchValidator batchValidator(Validator::kStrongTypes, 2);
+    std::vector<ValidationResults> results;
+    const std::vector<bool> outcomes =
+            batchValidator.validate(m_schema, batch, &results);
+
+    ASSERT_EQ(batch.size(), results.size());
+    EXPECT_TRUE(outcomes[0]);
+    EXPECT_EQ(0u, results[0].numErrors());
+    EXPECT_FALSE(outcomes[1]);
+    EXPECT_GT(results[1].numErrors(), 0u);
+    EXPECT_FALSE(outcomes[2]);
+    EXPECT_GT(results[2].numErrors(), 0u);
+}
+
+TEST_F(TestBatchValidator, SingleWorkerBehavesIdentically)
+{
+    parseSchema(R"({ "type": "integer", "maximum": 5 })");
+
+    const std::vector<RapidJsonAdapter> batch = parseBatch({
+        "1", "10", "5", "6",
+    });
+
+    BatchValidator oneWorker(Validator::kStrongTypes, 1);
+    BatchValidator manyWorkers(Validator::kStrongTypes, 4);
+
+    EXPECT_EQ(oneWorker.validate(m_schema, batch, nullptr),
+            manyWorkers.validate(m_schema, batch, nullptr));
+}
+
+TEST_F(TestBatchValidator, EmptyBatch)
+{
+    parseSchema(R"({ "type": "integer" })");
+
+    const std::vector<RapidJsonAdapter> batch;
+    BatchValidator batchValidator;
+    EXPECT_TRUE(batchValidator.validate(m_schema, batch, nullptr).empty());
+}
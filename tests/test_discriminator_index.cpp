@@ -0,0 +1,164 @@
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include <valijson/adapters/rapidjson_adapter.hpp>
+#include <valijson/schema.hpp>
+#include <valijson/schema_parser.hpp>
+#include <valijson/validation_results.hpp>
+#include <valijson/validator.hpp>
+
+using valijson::adapters::RapidJsonAdapter;
+using valijson::Schema;
+using valijson::SchemaParser;
+using valijson::ValidationResults;
+using valijson::Validator;
+
+namespace {
+
+// Every branch pins 'kind' to a distinct constant - the idiom the index
+// is built to recognise
+const char kDiscriminatedSchema[] = R"({
+    "oneOf": [
+        {
+            "type": "object",
+            "properties": {
+                "kind": { "const": "circle" },
+                "radius": { "type": "number" }
+            },
+            "required": ["kind", "radius"]
+        },
+        {
+            "type": "object",
+            "properties": {
+                "kind": { "const": "square" },
+                "side": { "type": "number" }
+            },
+            "required": ["kind", "side"]
+        },
+        {
+            "type": "object",
+            "properties": {
+                "kind": { "const": "line" },
+                "length": { "type": "number" }
+            },
+            "required": ["kind", "length"]
+        }
+    ]
+})";
+
+const char *kDocuments[] = {
+    R"({ "kind": "circle", "radius": 1.5 })",      // valid, first branch
+    R"({ "kind": "square", "side": 2 })",          // valid, middle branch
+    R"({ "kind": "line", "length": 10 })",         // valid, last branch
+    R"({ "kind": "circle", "side": 2 })",          // right kind, wrong shape
+    R"({ "kind": "triangle", "side": 2 })",        // unknown discriminator
+    R"({ "radius": 1.5 })",                        // discriminator missing
+    R"({ "kind": 42, "radius": 1.5 })",            // non-string discriminator
+    R"("not an object")",
+};
+
+}  // namespace
+
+class TestDiscriminatorIndex : public ::testing::Test
+{
+protected:
+
+    void parseSchema(const char *schemaJson, Schema &schema)
+    {
+        m_schemaDocument.Parse(schemaJson);
+        ASSERT_FALSE(m_schemaDocument.HasParseError());
+
+        SchemaParser parser;
+        RapidJsonAdapter adapter(m_schemaDocument);
+        ASSERT_NO_THROW(parser.populateSchema(adapter, schema));
+    }
+
+    static bool validate(const Schema &schema, const char *documentJson,
+            ValidationResults *results = nullptr)
+    {
+        rapidjson::Document document;
+        document.Parse(documentJson);
+        EXPECT_FALSE(document.HasParseError());
+
+        Validator validator;
+        return validator.validate(schema, RapidJsonAdapter(document),
+                results);
+    }
+
+private:
+
+    rapidjson::Document m_schemaDocument;
+};
+
+TEST_F(TestDiscriminatorIndex, VerdictsUnchangedByIndexing)
+{
+    Schema plain;
+    parseSchema(kDiscriminatedSchema, plain);
+
+    Schema indexed;
+    parseSchema(kDiscriminatedSchema, indexed);
+    valijson::indexOneOfDiscriminators(indexed);
+
+    for (const char *document : kDocuments) {
+        // Fail-fast, where the index is consulted
+        EXPECT_EQ(validate(plain, document), validate(indexed, document))
+                << "document: " << document;
+
+        // Exhaustive, where every branch must still be reported on
+        ValidationResults plainResults;
+        ValidationResults indexedResults;
+        EXPECT_EQ(validate(plain, document, &plainResults),
+                validate(indexed, document, &indexedResults))
+                << "document: " << document;
+        EXPECT_EQ(plainResults.numErrors(), indexedResults.numErrors())
+                << "document: " << document;
+    }
+}
+
+TEST_F(TestDiscriminatorIndex, NonDiscriminatedOneOfIsUnaffected)
+{
+    // Branches distinguished by type rather than by a constant property;
+    // the pass must leave the combinator fully functional
+    const char *schemaJson = R"({
+        "oneOf": [
+            { "type": "string" },
+            { "type": "integer" }
+        ]
+    })";
+
+    Schema schema;
+    parseSchema(schemaJson, schema);
+    valijson::indexOneOfDiscriminators(schema);
+
+    EXPECT_TRUE(validate(schema, R"("text")"));
+    EXPECT_TRUE(validate(schema, "7"));
+    EXPECT_FALSE(validate(schema, "null"));
+    EXPECT_FALSE(validate(schema, "[1]"));
+}
+
+TEST_F(TestDiscriminatorIndex, SingleValueEnumsAreRecognised)
+{
+    // A one-element 'enum' pins a property just as 'const' does
+    const char *schemaJson = R"({
+        "oneOf": [
+            {
+                "properties": { "tag": { "enum": ["a"] } },
+                "required": ["tag", "left"]
+            },
+            {
+                "properties": { "tag": { "enum": ["b"] } },
+                "required": ["tag", "right"]
+            }
+        ]
+    })";
+
+    Schema schema;
+    parseSchema(schemaJson, schema);
+    valijson::indexOneOfDiscriminators(schema);
+
+    EXPECT_TRUE(validate(schema, R"({ "tag": "a", "left": 1 })"));
+    EXPECT_TRUE(validate(schema, R"({ "tag": "b", "right": 1 })"));
+    EXPECT_FALSE(validate(schema, R"({ "tag": "a", "right": 1 })"));
+    EXPECT_FALSE(validate(schema, R"({ "tag": "c", "left": 1 })"));
+}
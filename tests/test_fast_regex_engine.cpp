@@ -0,0 +1,97 @@
+#include <regex>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <valijson/fast_regex_engine.hpp>
+
+using valijson::FastRegexEngine;
+
+namespace {
+
+// Patterns inside the NFA subset, outside it (forcing the std::regex
+// fallback), and syntactically invalid; correctness is defined as exact
+// agreement with std::regex in ECMAScript mode
+const char *kPatterns[] = {
+    "abc", "^abc$", "a.c", "a*", "a+b?", "^$", ".*",
+    "^[a-z]+$", "[^a-z]", "[abc]{2}", "[A-Za-z0-9_-]+", "[-a]", "[a-]",
+    "]x", "[]a]?", "[]]", "[^]]+",
+    "^\\d{3}-\\d{4}$", "\\w+@\\w+\\.com", "\\s", "\\S+", "\\.", "a\\*b",
+    "(foo|bar)+", "(?:ab)+c", "colou?r", "^(a|b|c){2,3}$", "x{0,2}y",
+    "a$", "^a", "a{2}", "\\d*\\.\\d+", "[\\d]", "[\\w-]+",
+    "(a)(b)", "(?=x)y", "^(?!foo)", "\\bword\\b",
+};
+
+const char *kInputs[] = {
+    "", "a", "b", "]", "a]", "abc", "xyz", "aab", "abab",
+    "123-4567", "foo", "bar", "foobar", "color", "colour",
+    "user@example.com", "hello world", "3.14", "x-1", "word",
+    "ABC", "aa", "xxy", "[]",
+};
+
+}  // namespace
+
+class TestFastRegexEngine : public ::testing::Test
+{
+
+};
+
+TEST_F(TestFastRegexEngine, AgreesWithStdRegex)
+{
+    for (const char *pattern : kPatterns) {
+        bool patternValid = true;
+        std::regex reference;
+        try {
+            reference = std::regex(pattern);
+        } catch (const std::regex_error &) {
+            patternValid = false;
+        }
+
+        if (!patternValid) {
+            EXPECT_THROW(FastRegexEngine engine(pattern), std::regex_error)
+                    << "pattern: " << pattern;
+            continue;
+        }
+
+        const FastRegexEngine engine(pattern);
+        for (const char *input : kInputs) {
+            const std::string target(input);
+            EXPECT_EQ(std::regex_search(target, reference),
+                    FastRegexEngine::search(target, engine))
+                    << "pattern: " << pattern << " input: " << input;
+        }
+    }
+}
+
+TEST_F(TestFastRegexEngine, LeadingClosingBracketUsesEcmaSemantics)
+{
+    // ECMA-262 reads '[]' as an empty class, so '[]a]?' can only match via
+    // the trailing '?'; under the POSIX reading - ']' as a literal - it
+    // would match almost everything. Exercised separately because this
+    // divergence once slipped through the subset boundary.
+    const FastRegexEngine engine("[]a]?");
+    const std::regex reference("[]a]?");
+
+    for (const char *input : { "b", "]", "a]", "xyz]", "" }) {
+        EXPECT_EQ(std::regex_search(std::string(input), reference),
+                FastRegexEngine::search(std::string(input), engine))
+                << "input: " << input;
+    }
+}
+
+TEST_F(TestFastRegexEngine, SearchesCharacterRanges)
+{
+    const FastRegexEngine engine("^[a-z]+$");
+    const std::string buffer = "abcDEF";
+
+    // The range overload must honour the size rather than any terminator
+    EXPECT_TRUE(FastRegexEngine::search(buffer.data(), 3, engine));
+    EXPECT_FALSE(FastRegexEngine::search(buffer.data(), 6, engine));
+}
+
+TEST_F(TestFastRegexEngine, InvalidPatternsThrow)
+{
+    EXPECT_THROW(FastRegexEngine engine("(unclosed"), std::regex_error);
+    EXPECT_THROW(FastRegexEngine engine("a{2,1}"), std::regex_error);
+}
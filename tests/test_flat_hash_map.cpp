@@ -0,0 +1,151 @@
+#include <cstdint>
+#include <random>
+#include <string>
+#include <unordered_map>
+
+#include <gtest/gtest.h>
+
+#include <valijson/internal/flat_hash_map.hpp>
+
+using valijson::internal::FlatHashMap;
+
+namespace {
+
+typedef FlatHashMap<std::string, int> Map;
+
+// A hash that collides everything into one probe sequence, so that
+// backward-shift deletion is exercised on every erase
+struct CollidingHash
+{
+    size_t operator()(const std::string &) const
+    {
+        return 42;
+    }
+};
+
+}  // namespace
+
+class TestFlatHashMap : public ::testing::Test
+{
+
+};
+
+TEST_F(TestFlatHashMap, InsertFindAndOverwriteSemantics)
+{
+    Map map;
+    EXPECT_EQ(0u, map.size());
+    EXPECT_EQ(map.end(), map.find("missing"));
+
+    const auto inserted = map.insert(std::make_pair(std::string("a"), 1));
+    EXPECT_TRUE(inserted.second);
+    EXPECT_EQ(1, inserted.first->second);
+
+    // A second insert with the same key must not overwrite, matching the
+    // std::map semantics the parser relies on
+    const auto repeated = map.insert(std::make_pair(std::string("a"), 9));
+    EXPECT_FALSE(repeated.second);
+    EXPECT_EQ(1, repeated.first->second);
+
+    EXPECT_EQ(1u, map.size());
+    ASSERT_NE(map.end(), map.find("a"));
+    EXPECT_EQ(1, map.find("a")->second);
+}
+
+TEST_F(TestFlatHashMap, EraseShiftsCollidingEntriesBack)
+{
+    // With every key on one probe sequence, erasing an early entry forces
+    // the later ones to shift back; all of them must remain findable
+    FlatHashMap<std::string, int, CollidingHash> map;
+    for (int i = 0; i < 16; i++) {
+        map.insert(std::make_pair("key" + std::to_string(i), i));
+    }
+
+    EXPECT_EQ(1u, map.erase("key0"));
+    EXPECT_EQ(0u, map.erase("key0"));
+    EXPECT_EQ(1u, map.erase("key7"));
+    EXPECT_EQ(14u, map.size());
+
+    for (int i = 0; i < 16; i++) {
+        const std::string key = "key" + std::to_string(i);
+        if (i == 0 || i == 7) {
+            EXPECT_EQ(map.end(), map.find(key));
+        } else {
+            ASSERT_NE(map.end(), map.find(key)) << key;
+            EXPECT_EQ(i, map.find(key)->second);
+        }
+    }
+}
+
+TEST_F(TestFlatHashMap, RandomisedOperationsMatchUnorderedMap)
+{
+    Map map;
+    std::unordered_map<std::string, int> reference;
+    std::mt19937 rng(20240817);
+
+    for (int operation = 0; operation < 20000; operation++) {
+        const std::string key = "k" + std::to_string(rng() % 500);
+        switch (rng() % 3) {
+        case 0: {
+            const int value = static_cast<int>(rng() % 1000);
+            EXPECT_EQ(reference.insert(std::make_pair(key, value)).second,
+                    map.insert(std::make_pair(key, value)).second);
+            break;
+        }
+        case 1:
+            EXPECT_EQ(reference.erase(key), map.erase(key));
+            break;
+        default: {
+            const auto expected = reference.find(key);
+            const auto actual = map.find(key);
+            ASSERT_EQ(expected == reference.end(), actual == map.end())
+                    << key;
+            if (expected != reference.end()) {
+                EXPECT_EQ(expected->second, actual->second);
+            }
+            break;
+        }
+        }
+        ASSERT_EQ(reference.size(), map.size());
+    }
+
+    // Iteration must visit exactly the surviving entries
+    size_t visited = 0;
+    for (const auto &entry : map) {
+        const auto itr = reference.find(entry.first);
+        ASSERT_NE(reference.end(), itr);
+        EXPECT_EQ(itr->second, entry.second);
+        visited++;
+    }
+    EXPECT_EQ(reference.size(), visited);
+}
+
+TEST_F(TestFlatHashMap, ClearEmptiesTheMap)
+{
+    Map map;
+    for (int i = 0; i < 100; i++) {
+        map.insert(std::make_pair(std::to_string(i), i));
+    }
+
+    map.clear();
+    EXPECT_EQ(0u, map.size());
+    EXPECT_EQ(map.end(), map.find("5"));
+    EXPECT_EQ(map.begin(), map.end());
+
+    // The map must remain usable after clearing
+    map.insert(std::make_pair(std::string("fresh"), 1));
+    ASSERT_NE(map.end(), map.find("fresh"));
+}
+
+TEST_F(TestFlatHashMap, GrowthPreservesEntries)
+{
+    Map map;
+    for (int i = 0; i < 10000; i++) {
+        map.insert(std::make_pair(std::to_string(i), i));
+    }
+
+    EXPECT_EQ(10000u, map.size());
+    for (int i = 0; i < 10000; i += 97) {
+        ASSERT_NE(map.end(), map.find(std::to_string(i)));
+        EXPECT_EQ(i, map.find(std::to_string(i))->second);
+    }
+}
@@ -0,0 +1,152 @@
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include <valijson/adapters/rapidjson_adapter.hpp>
+#include <valijson/constraints/concrete_constraints.hpp>
+#include <valijson/schema.hpp>
+#include <valijson/schema_parser.hpp>
+#include <valijson/validation_results.hpp>
+#include <valijson/validator.hpp>
+
+using valijson::adapters::RapidJsonAdapter;
+using valijson::Schema;
+using valijson::SchemaParser;
+using valijson::ValidationResults;
+using valijson::Validator;
+
+namespace {
+
+const char kObjectSchema[] = R"({
+    "type": "object",
+    "properties": {
+        "name": { "type": "string" },
+        "count": { "type": "integer" }
+    },
+    "patternProperties": {
+        "^x-": { "type": "string" }
+    },
+    "additionalProperties": false,
+    "required": ["name"],
+    "propertyNames": { "pattern": "^[a-z][a-z-]*$" },
+    "minProperties": 1,
+    "maxProperties": 4
+})";
+
+const char *kDocuments[] = {
+    R"({ "name": "ok", "count": 1 })",                       // valid
+    R"({ "name": "ok", "x-note": "extension" })",            // valid
+    R"({ "count": 1 })",                                     // missing required
+    R"({ "name": 5 })",                                      // wrong property type
+    R"({ "name": "ok", "x-note": 5 })",                      // wrong pattern-property type
+    R"({ "name": "ok", "other": 1 })",                       // additional property
+    R"({})",                                                 // too few properties
+    R"({ "name": "ok", "count": 1, "x-a": "1", "x-b": "2", "x-c": "3" })",  // too many
+    R"(["not", "an", "object"])",                            // non-object target
+};
+
+}  // namespace
+
+class TestFusedObjectConstraints : public ::testing::Test
+{
+protected:
+
+    void parseSchema(const char *schemaJson, Schema &schema)
+    {
+        m_schemaDocument.Parse(schemaJson);
+        ASSERT_FALSE(m_schemaDocument.HasParseError());
+
+        SchemaParser parser;
+        RapidJsonAdapter adapter(m_schemaDocument);
+        ASSERT_NO_THROW(parser.populateSchema(adapter, schema));
+    }
+
+    static bool validate(const Schema &schema, const char *documentJson,
+            size_t *numErrors = nullptr)
+    {
+        rapidjson::Document document;
+        document.Parse(documentJson);
+        EXPECT_FALSE(document.HasParseError());
+
+        Validator validator;
+        if (numErrors == nullptr) {
+            return validator.validate(schema, RapidJsonAdapter(document),
+                    nullptr);
+        }
+
+        ValidationResults results;
+        const bool validated = validator.validate(schema,
+                RapidJsonAdapter(document), &results);
+        *numErrors = results.numErrors();
+        return validated;
+    }
+
+private:
+
+    rapidjson::Document m_schemaDocument;
+};
+
+TEST_F(TestFusedObjectConstraints, VerdictsUnchangedByFusion)
+{
+    Schema plain;
+    parseSchema(kObjectSchema, plain);
+
+    Schema fused;
+    parseSchema(kObjectSchema, fused);
+    valijson::fuseObjectConstraints(fused);
+
+    for (const char *document : kDocuments) {
+        EXPECT_EQ(validate(plain, document), validate(fused, document))
+                << "document: " << document;
+    }
+}
+
+TEST_F(TestFusedObjectConstraints, InvalidDocumentsStillReportErrors)
+{
+    Schema fused;
+    parseSchema(kObjectSchema, fused);
+    valijson::fuseObjectConstraints(fused);
+
+    for (const char *document : kDocuments) {
+        size_t numErrors = 0;
+        const bool validated = validate(fused, document, &numErrors);
+        EXPECT_EQ(validated, numErrors == 0) << "document: " << document;
+    }
+}
+
+TEST_F(TestFusedObjectConstraints, DuplicateConstraintsAreDeclined)
+{
+    using valijson::constraints::RequiredConstraint;
+    using valijson::constraints::MinPropertiesConstraint;
+
+    // Two 'required' constraints on one sub-schema cannot arise from a
+    // single parse, but can be constructed; fusion must leave such a
+    // sub-schema alone rather than guess which instance to fuse, and both
+    // constraints must still be enforced
+    Schema schema;
+    RequiredConstraint needsA;
+    needsA.addRequiredProperty("a");
+    schema.addConstraintToSubschema(needsA, schema.root());
+    RequiredConstraint needsB;
+    needsB.addRequiredProperty("b");
+    schema.addConstraintToSubschema(needsB, schema.root());
+    MinPropertiesConstraint minProperties;
+    minProperties.setMinProperties(2);
+    schema.addConstraintToSubschema(minProperties, schema.root());
+
+    valijson::fuseObjectConstraints(schema);
+
+    EXPECT_TRUE(validate(schema, R"({ "a": 1, "b": 2 })"));
+    EXPECT_FALSE(validate(schema, R"({ "a": 1 })"));
+    EXPECT_FALSE(validate(schema, R"({ "b": 2 })"));
+}
+
+TEST_F(TestFusedObjectConstraints, SingleConstraintIsLeftAlone)
+{
+    Schema schema;
+    parseSchema(R"({ "required": ["only"] })", schema);
+    valijson::fuseObjectConstraints(schema);
+
+    EXPECT_TRUE(validate(schema, R"({ "only": 1 })"));
+    EXPECT_FALSE(validate(schema, R"({ "other": 1 })"));
+}
@@ -0,0 +1,146 @@
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include <valijson/adapters/rapidjson_adapter.hpp>
+#include <valijson/internal/numeric_parsing.hpp>
+#include <valijson/schema.hpp>
+#include <valijson/schema_parser.hpp>
+#include <valijson/validator.hpp>
+
+using valijson::adapters::RapidJsonAdapter;
+using valijson::internal::parseDouble;
+using valijson::internal::parseInteger;
+using valijson::Schema;
+using valijson::SchemaParser;
+using valijson::Validator;
+
+namespace {
+
+bool parseIntegerString(const char *text, int64_t &result)
+{
+    return parseInteger(text, strlen(text), result);
+}
+
+bool parseDoubleString(const char *text, double &result)
+{
+    return parseDouble(text, strlen(text), result);
+}
+
+}  // namespace
+
+class TestNumericParsing : public ::testing::Test
+{
+
+};
+
+TEST_F(TestNumericParsing, IntegersAreParsed)
+{
+    int64_t result = 0;
+
+    EXPECT_TRUE(parseIntegerString("0", result));
+    EXPECT_EQ(0, result);
+
+    EXPECT_TRUE(parseIntegerString("42", result));
+    EXPECT_EQ(42, result);
+
+    EXPECT_TRUE(parseIntegerString("-7", result));
+    EXPECT_EQ(-7, result);
+
+    EXPECT_TRUE(parseIntegerString("+13", result));
+    EXPECT_EQ(13, result);
+
+    // Leading whitespace is accepted, as with the stream-based predecessor
+    EXPECT_TRUE(parseIntegerString("  42", result));
+    EXPECT_EQ(42, result);
+
+    EXPECT_TRUE(parseIntegerString("9223372036854775807", result));
+    EXPECT_EQ(INT64_MAX, result);
+
+    EXPECT_TRUE(parseIntegerString("-9223372036854775808", result));
+    EXPECT_EQ(INT64_MIN, result);
+}
+
+TEST_F(TestNumericParsing, MalformedIntegersAreRejected)
+{
+    int64_t result = 0;
+
+    EXPECT_FALSE(parseIntegerString("", result));
+    EXPECT_FALSE(parseIntegerString(" ", result));
+    EXPECT_FALSE(parseIntegerString("-", result));
+    EXPECT_FALSE(parseIntegerString("12x", result));
+    EXPECT_FALSE(parseIntegerString("1.5", result));
+    EXPECT_FALSE(parseIntegerString("42 ", result));  // trailing whitespace
+    EXPECT_FALSE(parseIntegerString("1e3", result));
+
+    // One beyond each end of the representable range
+    EXPECT_FALSE(parseIntegerString("9223372036854775808", result));
+    EXPECT_FALSE(parseIntegerString("-9223372036854775809", result));
+}
+
+TEST_F(TestNumericParsing, DoublesAreParsed)
+{
+    double result = 0;
+
+    EXPECT_TRUE(parseDoubleString("3.25", result));
+    EXPECT_EQ(3.25, result);
+
+    EXPECT_TRUE(parseDoubleString("-0.5", result));
+    EXPECT_EQ(-0.5, result);
+
+    EXPECT_TRUE(parseDoubleString("2e3", result));
+    EXPECT_EQ(2000.0, result);
+
+    EXPECT_TRUE(parseDoubleString(" 1.5", result));
+    EXPECT_EQ(1.5, result);
+
+    // A string longer than any small stack buffer must still parse
+    const std::string longNumber = "0." + std::string(200, '0') + "1";
+    EXPECT_TRUE(parseDouble(longNumber.data(), longNumber.size(), result));
+    EXPECT_GT(result, 0.0);
+}
+
+TEST_F(TestNumericParsing, MalformedDoublesAreRejected)
+{
+    double result = 0;
+
+    EXPECT_FALSE(parseDoubleString("", result));
+    EXPECT_FALSE(parseDoubleString("abc", result));
+    EXPECT_FALSE(parseDoubleString("1.5x", result));
+    EXPECT_FALSE(parseDoubleString("1.5 ", result));
+    EXPECT_FALSE(parseDoubleString("--1", result));
+}
+
+TEST_F(TestNumericParsing, WeakTypeCoercionUsesTheseSemantics)
+{
+    // End-to-end check that weak-type validation coerces string values
+    // through the same accept/reject boundary
+    rapidjson::Document schemaDocument;
+    schemaDocument.Parse(R"({ "type": "integer", "minimum": 10 })");
+    ASSERT_FALSE(schemaDocument.HasParseError());
+
+    Schema schema;
+    SchemaParser parser;
+    ASSERT_NO_THROW(parser.populateSchema(RapidJsonAdapter(schemaDocument),
+            schema));
+
+    Validator weak(Validator::kWeakTypes);
+    Validator strong(Validator::kStrongTypes);
+
+    rapidjson::Document document;
+    document.Parse(R"("42")");
+    ASSERT_FALSE(document.HasParseError());
+    EXPECT_TRUE(weak.validate(schema, RapidJsonAdapter(document), nullptr));
+    EXPECT_FALSE(strong.validate(schema, RapidJsonAdapter(document),
+            nullptr));
+
+    document.Parse(R"("7")");
+    ASSERT_FALSE(document.HasParseError());
+    EXPECT_FALSE(weak.validate(schema, RapidJsonAdapter(document), nullptr));
+
+    document.Parse(R"("12x")");
+    ASSERT_FALSE(document.HasParseError());
+    EXPECT_FALSE(weak.validate(schema, RapidJsonAdapter(document), nullptr));
+}
@@ -0,0 +1,149 @@
+#include <chrono>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include <valijson/adapters/rapidjson_adapter.hpp>
+#include <valijson/resumable_validator.hpp>
+#include <valijson/schema.hpp>
+#include <valijson/schema_parser.hpp>
+#include <valijson/validation_results.hpp>
+#include <valijson/validator.hpp>
+
+using valijson::adapters::RapidJsonAdapter;
+using valijson::ResumableValidationT;
+using valijson::Schema;
+using valijson::SchemaParser;
+using valijson::ValidationResults;
+using valijson::Validator;
+
+typedef ResumableValidationT<RapidJsonAdapter> ResumableValidation;
+
+namespace {
+
+const char kSchema[] = R"({
+    "type": "object",
+    "properties": {
+        "rows": {
+            "type": "array",
+            "items": {
+                "type": "object",
+                "properties": { "v": { "type": "integer", "minimum": 0 } },
+                "required": ["v"]
+            }
+        }
+    },
+    "required": ["rows"]
+})";
+
+const char kValidDocument[] =
+        R"({ "rows": [ { "v": 1 }, { "v": 2 }, { "v": 3 }, { "v": 4 } ] })";
+
+const char kInvalidDocument[] =
+        R"({ "rows": [ { "v": 1 }, { "v": -2 }, {}, { "v": 4 } ] })";
+
+}  // namespace
+
+class TestResumableValidation : public ::testing::Test
+{
+protected:
+
+    void parseSchema(const char *schemaJson)
+    {
+        m_schemaDocument.Parse(schemaJson);
+        ASSERT_FALSE(m_schemaDocument.HasParseError());
+
+        SchemaParser parser;
+        RapidJsonAdapter adapter(m_schemaDocument);
+        ASSERT_NO_THROW(parser.populateSchema(adapter, m_schema));
+    }
+
+    void parseDocument(const char *documentJson)
+    {
+        m_document.Parse(documentJson);
+        ASSERT_FALSE(m_document.HasParseError());
+    }
+
+    Schema m_schema;
+    rapidjson::Document m_document;
+
+private:
+
+    rapidjson::Document m_schemaDocument;
+};
+
+TEST_F(TestResumableValidation, SliceSizeDoesNotAffectVerdicts)
+{
+    parseSchema(kSchema);
+
+    for (const char *documentJson : { kValidDocument, kInvalidDocument }) {
+        parseDocument(documentJson);
+        const RapidJsonAdapter target(m_document);
+
+        Validator validator;
+        const bool expected = validator.validate(m_schema, target, nullptr);
+
+        for (const size_t sliceSize : { size_t(1), size_t(3), size_t(1000) }) {
+            ResumableValidation session(m_schema, target);
+            size_t slices = 0;
+            while (!session.step(sliceSize)) {
+                slices++;
+            }
+
+            EXPECT_TRUE(session.isComplete());
+            EXPECT_EQ(expected, session.isValid())
+                    << "document: " << documentJson
+                    << " slice size: " << sliceSize;
+
+            // A one-item slice over this document must take several slices,
+            // or the session never actually paused
+            if (sliceSize == 1) {
+                EXPECT_GT(slices, 1u);
+            }
+        }
+    }
+}
+
+TEST_F(TestResumableValidation, ErrorsMatchExhaustiveValidation)
+{
+    parseSchema(kSchema);
+    parseDocument(kInvalidDocument);
+    const RapidJsonAdapter target(m_document);
+
+    Validator validator;
+    ValidationResults expectedResults;
+    EXPECT_FALSE(validator.validate(m_schema, target, &expectedResults));
+
+    ValidationResults results;
+    ResumableValidation session(m_schema, target, &results);
+    while (!session.step(1)) {
+    }
+
+    EXPECT_FALSE(session.isValid());
+    EXPECT_GT(results.numErrors(), 0u);
+}
+
+TEST_F(TestResumableValidation, NoWorkBeforeFirstStep)
+{
+    parseSchema(kSchema);
+    parseDocument(kInvalidDocument);
+    const RapidJsonAdapter target(m_document);
+
+    ResumableValidation session(m_schema, target);
+    EXPECT_FALSE(session.isComplete());
+    EXPECT_TRUE(session.isValid());  // no failure found before any work
+}
+
+TEST_F(TestResumableValidation, StepForCompletesValidation)
+{
+    parseSchema(kSchema);
+    parseDocument(kValidDocument);
+    const RapidJsonAdapter target(m_document);
+
+    ResumableValidation session(m_schema, target);
+    while (!session.stepFor(std::chrono::milliseconds(10))) {
+    }
+
+    EXPECT_TRUE(session.isComplete());
+    EXPECT_TRUE(session.isValid());
+}
@@ -0,0 +1,169 @@
+#include <cstring>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include <valijson/adapters/rapidjson_adapter.hpp>
+#include <valijson/schema.hpp>
+#include <valijson/schema_parser.hpp>
+#include <valijson/sax_validator.hpp>
+#include <valijson/validation_results.hpp>
+
+using valijson::adapters::RapidJsonAdapter;
+using valijson::SaxValidator;
+using valijson::Schema;
+using valijson::SchemaParser;
+using valijson::ValidationResults;
+
+class TestSaxValidator : public ::testing::Test
+{
+protected:
+
+    void parseSchema(const char *schemaJson)
+    {
+        m_schemaDocument.Parse(schemaJson);
+        ASSERT_FALSE(m_schemaDocument.HasParseError());
+
+        SchemaParser parser;
+        RapidJsonAdapter adapter(m_schemaDocument);
+        ASSERT_NO_THROW(parser.populateSchema(adapter, m_schema));
+    }
+
+    static bool key(SaxValidator &validator, const char *name)
+    {
+        return validator.Key(name, strlen(name), true);
+    }
+
+    static bool string(SaxValidator &validator, const char *value)
+    {
+        return validator.String(value, strlen(value), true);
+    }
+
+    Schema m_schema;
+
+private:
+
+    rapidjson::Document m_schemaDocument;
+};
+
+TEST_F(TestSaxValidator, ValidObjectStream)
+{
+    parseSchema(R"({
+        "type": "object",
+        "properties": {
+            "name": { "type": "string", "minLength": 1 },
+            "count": { "type": "integer", "minimum": 0 }
+        },
+        "required": ["name"]
+    })");
+
+    SaxValidator validator(m_schema);
+    EXPECT_TRUE(validator.StartObject());
+    EXPECT_TRUE(key(validator, "name"));
+    EXPECT_TRUE(string(validator, "widget"));
+    EXPECT_TRUE(key(validator, "count"));
+    EXPECT_TRUE(validator.Int(3));
+    EXPECT_TRUE(validator.EndObject(2));
+
+    EXPECT_TRUE(validator.isComplete());
+    EXPECT_TRUE(validator.isValid());
+}
+
+TEST_F(TestSaxValidator, MissingRequiredPropertyFails)
+{
+    parseSchema(R"({
+        "type": "object",
+        "properties": { "name": { "type": "string" } },
+        "required": ["name"]
+    })");
+
+    SaxValidator validator(m_schema);
+    validator.StartObject();
+    validator.EndObject(0);
+
+    EXPECT_TRUE(validator.isComplete());
+    EXPECT_FALSE(validator.isValid());
+}
+
+TEST_F(TestSaxValidator, InvalidScalarDetectedMidStream)
+{
+    parseSchema(R"({
+        "type": "array",
+        "items": { "type": "integer", "maximum": 10 }
+    })");
+
+    SaxValidator validator(m_schema);
+    validator.StartArray();
+    validator.Int(5);
+    validator.Int(50);
+
+    // The offending element has been consumed, so validity is already
+    // queryable before the document completes
+    EXPECT_FALSE(validator.isValid());
+
+    validator.EndArray(2);
+    EXPECT_TRUE(validator.isComplete());
+    EXPECT_FALSE(validator.isValid());
+}
+
+TEST_F(TestSaxValidator, ErrorsAreReported)
+{
+    parseSchema(R"({ "type": "object", "required": ["id"] })");
+
+    ValidationResults results;
+    SaxValidator validator(m_schema, &results);
+    validator.StartObject();
+    validator.EndObject(0);
+
+    EXPECT_FALSE(validator.isValid());
+    EXPECT_GT(results.numErrors(), 0u);
+}
+
+TEST_F(TestSaxValidator, ResetAllowsReuse)
+{
+    parseSchema(R"({ "type": "string" })");
+
+    SaxValidator validator(m_schema);
+    EXPECT_TRUE(validator.Int(1) || true);  // consume the invalid document
+    EXPECT_TRUE(validator.isComplete());
+    EXPECT_FALSE(validator.isValid());
+
+    validator.reset();
+    EXPECT_FALSE(validator.isComplete());
+    string(validator, "ok");
+    EXPECT_TRUE(validator.isComplete());
+    EXPECT_TRUE(validator.isValid());
+}
+
+TEST_F(TestSaxValidator, NestedContainers)
+{
+    parseSchema(R"({
+        "type": "object",
+        "properties": {
+            "rows": {
+                "type": "array",
+                "items": {
+                    "type": "object",
+                    "properties": { "v": { "type": "number" } },
+                    "required": ["v"]
+                },
+                "minItems": 1
+            }
+        },
+        "required": ["rows"]
+    })");
+
+    SaxValidator validator(m_schema);
+    validator.StartObject();
+    key(validator, "rows");
+    validator.StartArray();
+    validator.StartObject();
+    key(validator, "v");
+    validator.Double(1.5);
+    validator.EndObject(1);
+    validator.EndArray(1);
+    validator.EndObject(1);
+
+    EXPECT_TRUE(validator.isComplete());
+    EXPECT_TRUE(validator.isValid());
+}
@@ -0,0 +1,127 @@
+#include <gtest/gtest.h>
+
+#include <valijson/adapters/rapidjson_adapter.hpp>
+#include <valijson/schema.hpp>
+#include <valijson/schema_parser.hpp>
+#include <valijson/validation_results.hpp>
+#include <valijson/validator.hpp>
+
+using valijson::adapters::RapidJsonAdapter;
+using valijson::Schema;
+using valijson::SchemaParser;
+using valijson::ValidationResults;
+using valijson::Validator;
+
+namespace {
+
+const char kSchema[] = R"({
+    "type": "object",
+    "properties": {
+        "name": { "type": "string", "pattern": "^[a-z]+$" },
+        "count": { "type": "integer", "minimum": 0, "maximum": 100 },
+        "tags": { "type": "array", "items": { "type": "string" }, "maxItems": 4 }
+    },
+    "required": ["name"],
+    "additionalProperties": false
+})";
+
+const char kValidDocument[] =
+        R"({ "name": "widget", "count": 3, "tags": ["a", "b"] })";
+
+const char kInvalidDocument[] =
+        R"({ "name": "Widget", "count": 200, "tags": [1], "extra": true })";
+
+}  // namespace
+
+class TestSchemaCompile : public ::testing::Test
+{
+protected:
+
+    void parseSchema(const char *schemaJson, Schema &schema)
+    {
+        m_schemaDocument.Parse(schemaJson);
+        ASSERT_FALSE(m_schemaDocument.HasParseError());
+
+        SchemaParser parser;
+        RapidJsonAdapter adapter(m_schemaDocument);
+        ASSERT_NO_THROW(parser.populateSchema(adapter, schema));
+    }
+
+    bool validate(const Schema &schema, const char *documentJson,
+            size_t *numErrors = nullptr)
+    {
+        rapidjson::Document document;
+        document.Parse(documentJson);
+        EXPECT_FALSE(document.HasParseError());
+
+        Validator validator;
+        if (numErrors == nullptr) {
+            return validator.validate(schema, RapidJsonAdapter(document),
+                    nullptr);
+        }
+
+        ValidationResults results;
+        const bool validated = validator.validate(schema,
+                RapidJsonAdapter(document), &results);
+        *numErrors = results.numErrors();
+        return validated;
+    }
+
+private:
+
+    rapidjson::Document m_schemaDocument;
+};
+
+TEST_F(TestSchemaCompile, VerdictsUnchangedByCompilation)
+{
+    Schema schema;
+    parseSchema(kSchema, schema);
+
+    size_t errorsBefore = 0;
+    EXPECT_TRUE(validate(schema, kValidDocument));
+    EXPECT_FALSE(validate(schema, kInvalidDocument, &errorsBefore));
+
+    schema.compile();
+
+    size_t errorsAfter = 0;
+    EXPECT_TRUE(validate(schema, kValidDocument));
+    EXPECT_FALSE(validate(schema, kInvalidDocument, &errorsAfter));
+    EXPECT_EQ(errorsBefore, errorsAfter);
+}
+
+TEST_F(TestSchemaCompile, CompilationIsIdempotent)
+{
+    Schema schema;
+    parseSchema(kSchema, schema);
+
+    schema.compile();
+    schema.compile();
+
+    EXPECT_TRUE(validate(schema, kValidDocument));
+    EXPECT_FALSE(validate(schema, kInvalidDocument));
+}
+
+TEST_F(TestSchemaCompile, LayoutOrderDoesNotAffectVerdicts)
+{
+    Schema schema;
+    parseSchema(kSchema, schema);
+
+    // The root alone is a valid (partial) layout order; the remaining
+    // sub-schemas are placed after it
+    std::vector<const valijson::Subschema *> layoutOrder;
+    layoutOrder.push_back(schema.root());
+    schema.compile(layoutOrder);
+
+    EXPECT_TRUE(validate(schema, kValidDocument));
+    EXPECT_FALSE(validate(schema, kInvalidDocument));
+}
+
+TEST_F(TestSchemaCompile, EmptySchemaCompiles)
+{
+    Schema schema;
+    parseSchema("{}", schema);
+    schema.compile();
+
+    EXPECT_TRUE(validate(schema, kValidDocument));
+    EXPECT_TRUE(validate(schema, "null"));
+}
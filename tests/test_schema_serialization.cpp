@@ -0,0 +1,132 @@
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <valijson/adapters/rapidjson_adapter.hpp>
+#include <valijson/schema.hpp>
+#include <valijson/schema_parser.hpp>
+#include <valijson/schema_serialization.hpp>
+#include <valijson/validator.hpp>
+
+using valijson::adapters::RapidJsonAdapter;
+using valijson::Schema;
+using valijson::SchemaParser;
+using valijson::Validator;
+
+namespace {
+
+// A schema that touches most of the serializable constraint families
+const char kSchema[] = R"({
+    "type": "object",
+    "properties": {
+        "name": { "type": "string", "pattern": "^[a-z]+$", "minLength": 1, "maxLength": 32 },
+        "count": { "type": "integer", "minimum": 0, "maximum": 100 },
+        "mode": { "enum": ["fast", "slow"] },
+        "tags": { "type": "array", "items": { "type": "string" }, "uniqueItems": true }
+    },
+    "required": ["name"],
+    "additionalProperties": false,
+    "dependencies": { "count": ["mode"] }
+})";
+
+}  // namespace
+
+class TestSchemaSerialization : public ::testing::Test
+{
+protected:
+
+    void serializeSchema(const char *schemaJson, std::vector<char> &buffer)
+    {
+        m_schemaDocument.Parse(schemaJson);
+        ASSERT_FALSE(m_schemaDocument.HasParseError());
+
+        Schema schema;
+        SchemaParser parser;
+        RapidJsonAdapter adapter(m_schemaDocument);
+        ASSERT_NO_THROW(parser.populateSchema(adapter, schema));
+        ASSERT_NO_THROW(valijson::serializeBinarySchema(schema, buffer));
+    }
+
+    static bool validate(const Schema &schema, const char *documentJson)
+    {
+        rapidjson::Document document;
+        document.Parse(documentJson);
+        EXPECT_FALSE(document.HasParseError());
+
+        Validator validator;
+        return validator.validate(schema, RapidJsonAdapter(document),
+                nullptr);
+    }
+
+private:
+
+    rapidjson::Document m_schemaDocument;
+};
+
+TEST_F(TestSchemaSerialization, RoundTripPreservesVerdicts)
+{
+    std::vector<char> buffer;
+    serializeSchema(kSchema, buffer);
+
+    Schema restored;
+    ASSERT_NO_THROW(
+            valijson::deserializeBinarySchema(buffer.data(), buffer.size(),
+                    restored));
+
+    EXPECT_TRUE(validate(restored,
+            R"({ "name": "widget", "count": 3, "mode": "fast" })"));
+    EXPECT_FALSE(validate(restored, R"({ "count": 3, "mode": "fast" })"));
+    EXPECT_FALSE(validate(restored,
+            R"({ "name": "Widget", "count": 3, "mode": "fast" })"));
+    EXPECT_FALSE(validate(restored,
+            R"({ "name": "widget", "count": 200, "mode": "fast" })"));
+    EXPECT_FALSE(validate(restored, R"({ "name": "widget", "count": 3 })"));
+    EXPECT_FALSE(validate(restored,
+            R"({ "name": "widget", "mode": "unknown" })"));
+    EXPECT_FALSE(validate(restored, R"({ "name": "widget", "extra": 1 })"));
+}
+
+TEST_F(TestSchemaSerialization, EveryTruncationIsRejected)
+{
+    std::vector<char> buffer;
+    serializeSchema(kSchema, buffer);
+
+    for (size_t length = 0; length < buffer.size(); length++) {
+        Schema schema;
+        EXPECT_THROW(
+                valijson::deserializeBinarySchema(buffer.data(), length,
+                        schema),
+                std::exception) << "truncation at byte " << length;
+    }
+}
+
+TEST_F(TestSchemaSerialization, CorruptBytesDoNotCrashOrHang)
+{
+    std::vector<char> buffer;
+    serializeSchema(kSchema, buffer);
+
+    // Overwriting any single byte with 0xFF - which turns count and length
+    // fields into huge values - must either produce a schema or throw; it
+    // must not drive an unbounded loop or allocation
+    for (size_t offset = 0; offset < buffer.size(); offset++) {
+        std::vector<char> mutated = buffer;
+        mutated[offset] = static_cast<char>(0xFF);
+
+        Schema schema;
+        try {
+            valijson::deserializeBinarySchema(mutated.data(),
+                    mutated.size(), schema);
+        } catch (const std::exception &) {
+            // Rejection is the expected outcome for most offsets
+        }
+    }
+}
+
+TEST_F(TestSchemaSerialization, EmptyInputIsRejected)
+{
+    Schema schema;
+    EXPECT_THROW(valijson::deserializeBinarySchema(nullptr, 0, schema),
+            std::exception);
+}
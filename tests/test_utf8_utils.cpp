@@ -0,0 +1,129 @@
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include <valijson/utils/utf8_utils.hpp>
+
+using valijson::utils::u8_ascii_prefix;
+using valijson::utils::u8_ascii_prefix_swar;
+using valijson::utils::u8_count_continuation;
+using valijson::utils::u8_count_continuation_scalar;
+using valijson::utils::u8_count_continuation_swar;
+using valijson::utils::u8_strlen;
+using valijson::utils::u8_validate_and_count;
+
+namespace {
+
+// Sample strings paired with their character counts; lengths straddle the
+// 8-, 16- and 32-byte block boundaries of the vector kernels
+struct Sample
+{
+    const char *text;
+    uint64_t characters;
+};
+
+const Sample kSamples[] = {
+    { "", 0 },
+    { "a", 1 },
+    { "hello", 5 },
+    { "exactly8", 8 },
+    { "just-over-8bytes", 16 },
+    { "a string comfortably longer than thirty-two bytes", 49 },
+    { "caf\xC3\xA9", 4 },                              // two-byte sequence
+    { "\xC3\xA9\xC3\xA9\xC3\xA9", 3 },                 // consecutive two-byte
+    { "snow: \xE2\x98\x83", 7 },                       // three-byte sequence
+    { "smile \xF0\x9F\x98\x80 end", 11 },              // four-byte sequence
+    { "mixed ascii then \xE2\x82\xAC\xE2\x82\xAC and ascii again padded out", 46 },
+};
+
+}  // namespace
+
+class TestUtf8Utils : public ::testing::Test
+{
+
+};
+
+TEST_F(TestUtf8Utils, StrlenCountsCharacters)
+{
+    for (const Sample &sample : kSamples) {
+        const std::string text(sample.text);
+        EXPECT_EQ(sample.characters, u8_strlen(text.data(), text.size()))
+                << "text: " << sample.text;
+    }
+}
+
+TEST_F(TestUtf8Utils, KernelsAgreeOnContinuationCounts)
+{
+    for (const Sample &sample : kSamples) {
+        const std::string text(sample.text);
+        const uint64_t expected =
+                u8_count_continuation_scalar(text.data(), text.size());
+        EXPECT_EQ(expected,
+                u8_count_continuation_swar(text.data(), text.size()));
+        EXPECT_EQ(expected,
+                u8_count_continuation(text.data(), text.size()));
+    }
+}
+
+TEST_F(TestUtf8Utils, AsciiPrefixIsAscii)
+{
+    for (const Sample &sample : kSamples) {
+        const std::string text(sample.text);
+
+        // The prefix counts whole blocks, so it never overshoots the first
+        // non-ASCII byte and never exceeds the string
+        for (const uint64_t prefix : {
+                u8_ascii_prefix(text.data(), text.size()),
+                u8_ascii_prefix_swar(text.data(), text.size()) }) {
+            ASSERT_LE(prefix, text.size());
+            for (uint64_t i = 0; i < prefix; i++) {
+                EXPECT_LT(static_cast<unsigned char>(text[i]), 0x80u);
+            }
+        }
+    }
+}
+
+TEST_F(TestUtf8Utils, ValidStringsAreAccepted)
+{
+    for (const Sample &sample : kSamples) {
+        const std::string text(sample.text);
+        uint64_t count = 0;
+        EXPECT_TRUE(u8_validate_and_count(text.data(), text.size(), &count))
+                << "text: " << sample.text;
+        EXPECT_EQ(sample.characters, count);
+    }
+}
+
+TEST_F(TestUtf8Utils, MalformedStringsAreRejected)
+{
+    const char *malformed[] = {
+        "\x80",                  // continuation byte without a lead
+        "abc\xBFxyz",            // stray continuation mid-string
+        "\xC0\xAF",              // overlong two-byte encoding
+        "\xC3",                  // truncated two-byte sequence
+        "\xE0\x80\xA0",          // overlong three-byte encoding
+        "\xED\xA0\x80",          // UTF-16 surrogate
+        "\xF0\x80\x80\x80",      // overlong four-byte encoding
+        "\xF4\x90\x80\x80",      // above U+10FFFF
+        "\xF5\x80\x80\x80",      // invalid lead byte
+        "\xE2\x98",              // truncated three-byte sequence
+        "\xE2\x28\x83",          // bad continuation byte
+    };
+
+    for (const char *text : malformed) {
+        uint64_t count = 0;
+        EXPECT_FALSE(u8_validate_and_count(text, strlen(text), &count))
+                << "text was accepted";
+    }
+}
+
+TEST_F(TestUtf8Utils, ValidationCountsUpToTheFault)
+{
+    // Ten valid characters, then a stray continuation byte
+    const std::string text = std::string("0123456789") + "\x80";
+    uint64_t count = 0;
+    EXPECT_FALSE(u8_validate_and_count(text.data(), text.size(), &count));
+    EXPECT_EQ(10u, count);
+}
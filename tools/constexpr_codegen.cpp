@@ -0,0 +1,750 @@
+/**
+ * Offline code generator that compiles a JSON Schema to a C++ header.
+ *
+ * The generated header contains one templated validation function per
+ * sub-schema, with type checks, bounds and required-property tables emitted
+ * as inline code and constexpr data, so that a schema that is stable for
+ * years can be validated with zero parse cost at startup and full inlining
+ * across the constraint graph. The functions are written against the same
+ * Adapter concept as the rest of the library (internal/adapter.hpp), so any
+ * adapter works with the generated code.
+ *
+ * Only the structural subset of JSON Schema is supported: 'type' (named
+ * types), 'required', 'properties' / 'patternProperties' /
+ * 'additionalProperties', 'items' / 'additionalItems', 'pattern',
+ * 'minLength' / 'maxLength', 'minimum' / 'maximum' (with exclusive bounds),
+ * 'multipleOf' (integer), 'minItems' / 'maxItems', 'minProperties' /
+ * 'maxProperties', 'allOf', 'anyOf', 'oneOf' and 'not'. A schema using any
+ * other constraint is rejected with an error naming the construct; such
+ * schemas should continue to use the runtime SchemaParser and Validator.
+ *
+ * Matching the runtime validator, the generated code uses strict type
+ * comparison and reports only a verdict, not per-location errors.
+ *
+ * Usage:
+ *
+ *   constexpr_codegen <schema.json> [namespace] > schema_generated.hpp
+ *
+ * Exit codes follow bundle.sh: 0 on success, 64 for usage errors, 65 for a
+ * schema that cannot be compiled.
+ */
+
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#include <valijson/adapters/nlohmann_json_adapter.hpp>
+#include <valijson/constraints/concrete_constraints.hpp>
+#include <valijson/constraints/constraint_visitor.hpp>
+#include <valijson/schema.hpp>
+#include <valijson/schema_parser.hpp>
+#include <valijson/utils/nlohmann_json_utils.hpp>
+
+using valijson::Schema;
+using valijson::SchemaParser;
+using valijson::Subschema;
+
+namespace {
+
+/// Render a string as a C++ string literal, escaping as octal where needed
+std::string cppStringLiteral(const std::string &value)
+{
+    std::string result = "\"";
+    for (const char c : value) {
+        const unsigned char byte = static_cast<unsigned char>(c);
+        if (c == '"' || c == '\\') {
+            result += '\\';
+            result += c;
+        } else if (byte < 0x20 || byte >= 0x7f) {
+            char buffer[8];
+            snprintf(buffer, sizeof(buffer), "\\%03o", byte);
+            result += buffer;
+            // Close and reopen the literal so that a following digit is not
+            // absorbed into the octal escape
+            result += "\" \"";
+        } else {
+            result += c;
+        }
+    }
+    result += '"';
+    return result;
+}
+
+/**
+ * @brief  Assigns an index to each reachable sub-schema and queues newly
+ *         discovered ones for emission
+ */
+class NodeRegistry
+{
+public:
+    size_t indexOf(const Subschema *subschema)
+    {
+        const std::map<const Subschema *, size_t>::const_iterator itr =
+                m_indices.find(subschema);
+        if (itr != m_indices.end()) {
+            return itr->second;
+        }
+
+        const size_t index = m_indices.size();
+        m_indices[subschema] = index;
+        m_pending.push_back(subschema);
+        return index;
+    }
+
+    bool hasPending() const
+    {
+        return !m_pending.empty();
+    }
+
+    const Subschema * popPending()
+    {
+        const Subschema *subschema = m_pending.front();
+        m_pending.pop_front();
+        return subschema;
+    }
+
+    size_t size() const
+    {
+        return m_indices.size();
+    }
+
+private:
+    std::map<const Subschema *, size_t> m_indices;
+    std::deque<const Subschema *> m_pending;
+};
+
+/**
+ * @brief  Visitor that emits the body of a validation function, one
+ *         statement block per constraint
+ *
+ * visit() returns \c false for constraints outside the supported subset,
+ * recording the name of the offending construct.
+ */
+class CodegenVisitor: public valijson::constraints::ConstraintVisitor
+{
+public:
+    CodegenVisitor(NodeRegistry &registry, std::ostringstream &body)
+      : m_registry(registry),
+        m_body(body) { }
+
+    const std::string & unsupportedConstruct() const
+    {
+        return m_unsupported;
+    }
+
+    bool visit(const valijson::constraints::AllOfConstraint &constraint) override
+    {
+        m_body << "    // allOf\n";
+        constraint.applyToSubschemas(
+                [this](unsigned int, const Subschema *subschema) {
+                    m_body << "    if (!validateNode" << m_registry.indexOf(subschema)
+                           << "(target)) {\n        return false;\n    }\n";
+                    return true;
+                });
+        m_body << "\n";
+        return true;
+    }
+
+    bool visit(const valijson::constraints::AnyOfConstraint &constraint) override
+    {
+        std::vector<size_t> children;
+        constraint.applyToSubschemas(
+                [this, &children](unsigned int, const Subschema *subschema) {
+                    children.push_back(m_registry.indexOf(subschema));
+                    return true;
+                });
+
+        m_body << "    // anyOf\n    if (!(";
+        for (size_t i = 0; i < children.size(); i++) {
+            if (i > 0) {
+                m_body << " ||\n            ";
+            }
+            m_body << "validateNode" << children[i] << "(target)";
+        }
+        m_body << ")) {\n        return false;\n    }\n\n";
+        return true;
+    }
+
+    bool visit(const valijson::constraints::ConditionalConstraint &) override
+    {
+        return unsupported("if/then/else");
+    }
+
+    bool visit(const valijson::constraints::ConstConstraint &) override
+    {
+        return unsupported("const");
+    }
+
+    bool visit(const valijson::constraints::ContainsConstraint &) override
+    {
+        return unsupported("contains");
+    }
+
+    bool visit(const valijson::constraints::DependenciesConstraint &) override
+    {
+        return unsupported("dependencies");
+    }
+
+    bool visit(const valijson::constraints::EnumConstraint &) override
+    {
+        return unsupported("enum");
+    }
+
+    bool visit(const valijson::constraints::FormatConstraint &) override
+    {
+        return unsupported("format");
+    }
+
+    bool visit(const valijson::constraints::FusedObjectConstraint &) override
+    {
+        // Produced by the schema optimiser, which is not expected to have
+        // run on a freshly parsed schema
+        return unsupported("fused object constraint");
+    }
+
+    bool visit(const valijson::constraints::LinearItemsConstraint &constraint) override
+    {
+        std::vector<size_t> itemNodes;
+        constraint.applyToItemSubschemas(
+                [this, &itemNodes](unsigned int, const Subschema *subschema) {
+                    itemNodes.push_back(m_registry.indexOf(subschema));
+                    return true;
+                });
+
+        const Subschema *additional = constraint.getAdditionalItemsSubschema();
+
+        m_body << "    // items (tuple form)\n"
+               << "    if (target.isArray()) {\n";
+        if (!additional && !itemNodes.empty()) {
+            m_body << "        if (target.getArraySize() > " << itemNodes.size()
+                   << ") {\n            return false;\n        }\n";
+        }
+        m_body << "        std::size_t index = 0;\n"
+               << "        for (const AdapterType item : target.getArray()) {\n";
+        for (size_t i = 0; i < itemNodes.size(); i++) {
+            m_body << "            " << (i > 0 ? "} else " : "") << "if (index == " << i << ") {\n"
+                   << "                if (!validateNode" << itemNodes[i]
+                   << "(item)) {\n                    return false;\n                }\n";
+        }
+        if (additional) {
+            m_body << "            " << (itemNodes.empty() ? "" : "} else ") << "{\n"
+                   << "                if (!validateNode" << m_registry.indexOf(additional)
+                   << "(item)) {\n                    return false;\n                }\n"
+                   << "            }\n";
+        } else if (!itemNodes.empty()) {
+            m_body << "            }\n";
+        }
+        m_body << "            ++index;\n"
+               << "        }\n"
+               << "        static_cast<void>(index);\n"
+               << "    }\n\n";
+        return true;
+    }
+
+    bool visit(const valijson::constraints::MaximumConstraint &constraint) override
+    {
+        m_body << "    // maximum\n"
+               << "    if (target.isNumber()) {\n";
+        if (constraint.hasIntegerMaximum()) {
+            m_body << "        if (target.isInteger()) {\n"
+                   << "            if (target.asInteger() "
+                   << (constraint.getExclusiveMaximum() ? ">=" : ">") << " INT64_C("
+                   << constraint.getIntegerMaximum() << ")) {\n"
+                   << "                return false;\n            }\n"
+                   << "        } else ";
+        } else {
+            m_body << "        ";
+        }
+        m_body << "if (target.asDouble() "
+               << (constraint.getExclusiveMaximum() ? ">=" : ">")
+               << " " << doubleLiteral(constraint.getMaximum()) << ") {\n"
+               << "            return false;\n        }\n"
+               << "    }\n\n";
+        return true;
+    }
+
+    bool visit(const valijson::constraints::MaxItemsConstraint &constraint) override
+    {
+        m_body << "    // maxItems\n"
+               << "    if (target.isArray() && target.getArraySize() > UINT64_C("
+               << constraint.getMaxItems() << ")) {\n        return false;\n    }\n\n";
+        return true;
+    }
+
+    bool visit(const valijson::constraints::MaxLengthConstraint &constraint) override
+    {
+        m_body << "    // maxLength\n"
+               << "    if (target.isString()) {\n"
+               << "        std::string stringValue;\n"
+               << "        target.getString(stringValue);\n"
+               << "        if (utf8Length(stringValue) > UINT64_C("
+               << constraint.getMaxLength() << ")) {\n            return false;\n        }\n"
+               << "    }\n\n";
+        return true;
+    }
+
+    bool visit(const valijson::constraints::MaxPropertiesConstraint &constraint) override
+    {
+        m_body << "    // maxProperties\n"
+               << "    if (target.isObject() && target.getObjectSize() > UINT64_C("
+               << constraint.getMaxProperties() << ")) {\n        return false;\n    }\n\n";
+        return true;
+    }
+
+    bool visit(const valijson::constraints::MinimumConstraint &constraint) override
+    {
+        m_body << "    // minimum\n"
+               << "    if (target.isNumber()) {\n";
+        if (constraint.hasIntegerMinimum()) {
+            m_body << "        if (target.isInteger()) {\n"
+                   << "            if (target.asInteger() "
+                   << (constraint.getExclusiveMinimum() ? "<=" : "<") << " INT64_C("
+                   << constraint.getIntegerMinimum() << ")) {\n"
+                   << "                return false;\n            }\n"
+                   << "        } else ";
+        } else {
+            m_body << "        ";
+        }
+        m_body << "if (target.asDouble() "
+               << (constraint.getExclusiveMinimum() ? "<=" : "<")
+               << " " << doubleLiteral(constraint.getMinimum()) << ") {\n"
+               << "            return false;\n        }\n"
+               << "    }\n\n";
+        return true;
+    }
+
+    bool visit(const valijson::constraints::MinItemsConstraint &constraint) override
+    {
+        m_body << "    // minItems\n"
+               << "    if (target.isArray() && target.getArraySize() < UINT64_C("
+               << constraint.getMinItems() << ")) {\n        return false;\n    }\n\n";
+        return true;
+    }
+
+    bool visit(const valijson::constraints::MinLengthConstraint &constraint) override
+    {
+        m_body << "    // minLength\n"
+               << "    if (target.isString()) {\n"
+               << "        std::string stringValue;\n"
+               << "        target.getString(stringValue);\n"
+               << "        if (utf8Length(stringValue) < UINT64_C("
+               << constraint.getMinLength() << ")) {\n            return false;\n        }\n"
+               << "    }\n\n";
+        return true;
+    }
+
+    bool visit(const valijson::constraints::MinPropertiesConstraint &constraint) override
+    {
+        m_body << "    // minProperties\n"
+               << "    if (target.isObject() && target.getObjectSize() < UINT64_C("
+               << constraint.getMinProperties() << ")) {\n        return false;\n    }\n\n";
+        return true;
+    }
+
+    bool visit(const valijson::constraints::MultipleOfDoubleConstraint &) override
+    {
+        return unsupported("multipleOf (non-integer)");
+    }
+
+    bool visit(const valijson::constraints::MultipleOfIntConstraint &constraint) override
+    {
+        m_body << "    // multipleOf\n"
+               << "    if (target.isNumber()) {\n"
+               << "        const std::int64_t integerValue = target.isInteger() ?\n"
+               << "                target.asInteger() : static_cast<std::int64_t>(target.asDouble());\n"
+               << "        if (integerValue != 0 && integerValue % INT64_C("
+               << constraint.getDivisor() << ") != 0) {\n            return false;\n        }\n"
+               << "    }\n\n";
+        return true;
+    }
+
+    bool visit(const valijson::constraints::NotConstraint &constraint) override
+    {
+        m_body << "    // not\n    if (validateNode"
+               << m_registry.indexOf(constraint.getSubschema())
+               << "(target)) {\n        return false;\n    }\n\n";
+        return true;
+    }
+
+    bool visit(const valijson::constraints::OneOfConstraint &constraint) override
+    {
+        std::vector<size_t> children;
+        constraint.applyToSubschemas(
+                [this, &children](unsigned int, const Subschema *subschema) {
+                    children.push_back(m_registry.indexOf(subschema));
+                    return true;
+                });
+
+        m_body << "    // oneOf\n    {\n        unsigned int numMatched = 0;\n";
+        for (const size_t child : children) {
+            m_body << "        if (validateNode" << child
+                   << "(target)) {\n            ++numMatched;\n        }\n";
+        }
+        m_body << "        if (numMatched != 1) {\n            return false;\n        }\n"
+               << "    }\n\n";
+        return true;
+    }
+
+    bool visit(const valijson::constraints::PatternConstraint &constraint) override
+    {
+        std::string pattern;
+        constraint.getPattern(pattern);
+
+        m_body << "    // pattern\n"
+               << "    if (target.isString()) {\n"
+               << "        static const std::regex patternRegex("
+               << cppStringLiteral(pattern) << ");\n"
+               << "        std::string stringValue;\n"
+               << "        target.getString(stringValue);\n"
+               << "        if (!std::regex_search(stringValue, patternRegex)) {\n"
+               << "            return false;\n        }\n"
+               << "    }\n\n";
+        return true;
+    }
+
+    bool visit(const valijson::constraints::PolyConstraint &) override
+    {
+        return unsupported("custom constraint");
+    }
+
+    bool visit(const valijson::constraints::PropertiesConstraint &constraint) override
+    {
+        struct NamedChild
+        {
+            std::string name;
+            size_t node;
+        };
+
+        std::vector<NamedChild> properties;
+        constraint.applyToProperties(
+                [this, &properties](const Subschema::PropertyName &name,
+                        const Subschema *subschema) {
+                    properties.push_back(NamedChild{
+                            std::string(name.c_str()), m_registry.indexOf(subschema)});
+                    return true;
+                });
+
+        std::vector<NamedChild> patternProperties;
+        constraint.applyToPatternProperties(
+                [this, &patternProperties](const Subschema::PropertyName &pattern,
+                        const Subschema *subschema) {
+                    patternProperties.push_back(NamedChild{
+                            std::string(pattern.c_str()), m_registry.indexOf(subschema)});
+                    return true;
+                });
+
+        const Subschema *additional = constraint.getAdditionalPropertiesSubschema();
+
+        m_body << "    // properties\n"
+               << "    if (target.isObject()) {\n"
+               << "        for (const typename AdapterType::ObjectMember member : target.asObject()) {\n"
+               << "            const std::string &memberName = member.first;\n"
+               << "            bool matched = false;\n";
+
+        for (const NamedChild &property : properties) {
+            m_body << "            if (memberName == " << cppStringLiteral(property.name) << ") {\n"
+                   << "                matched = true;\n"
+                   << "                if (!validateNode" << property.node
+                   << "(member.second)) {\n                    return false;\n                }\n"
+                   << "            }\n";
+        }
+
+        for (size_t i = 0; i < patternProperties.size(); i++) {
+            m_body << "            {\n"
+                   << "                static const std::regex propertyPattern" << i << "("
+                   << cppStringLiteral(patternProperties[i].name) << ");\n"
+                   << "                if (std::regex_search(memberName, propertyPattern" << i << ")) {\n"
+                   << "                    matched = true;\n"
+                   << "                    if (!validateNode" << patternProperties[i].node
+                   << "(member.second)) {\n                        return false;\n"
+                   << "                    }\n                }\n            }\n";
+        }
+
+        if (additional) {
+            m_body << "            if (!matched && !validateNode" << m_registry.indexOf(additional)
+                   << "(member.second)) {\n                return false;\n            }\n";
+        } else {
+            m_body << "            if (!matched) {\n                return false;\n            }\n";
+        }
+
+        m_body << "        }\n    }\n\n";
+        return true;
+    }
+
+    bool visit(const valijson::constraints::PropertyNamesConstraint &) override
+    {
+        return unsupported("propertyNames");
+    }
+
+    bool visit(const valijson::constraints::RequiredConstraint &constraint) override
+    {
+        std::vector<std::string> names;
+        constraint.applyToRequiredProperties(
+                [&names](const Subschema::PropertyName &name) {
+                    names.push_back(std::string(name.c_str()));
+                    return true;
+                });
+
+        m_body << "    // required\n"
+               << "    if (target.isObject()) {\n"
+               << "        static constexpr const char *const requiredProperties[] = {\n";
+        for (const std::string &name : names) {
+            m_body << "            " << cppStringLiteral(name) << ",\n";
+        }
+        m_body << "        };\n"
+               << "        const typename AdapterType::Object object = target.asObject();\n"
+               << "        for (const char *requiredProperty : requiredProperties) {\n"
+               << "            if (object.find(requiredProperty) == object.end()) {\n"
+               << "                return false;\n            }\n"
+               << "        }\n    }\n\n";
+        return true;
+    }
+
+    bool visit(const valijson::constraints::SingularItemsConstraint &constraint) override
+    {
+        const Subschema *itemsSubschema = constraint.getItemsSubschema();
+        if (!itemsSubschema) {
+            return true;
+        }
+
+        m_body << "    // items\n"
+               << "    if (target.isArray()) {\n"
+               << "        for (const AdapterType item : target.getArray()) {\n"
+               << "            if (!validateNode" << m_registry.indexOf(itemsSubschema)
+               << "(item)) {\n                return false;\n            }\n"
+               << "        }\n    }\n\n";
+        return true;
+    }
+
+    bool visit(const valijson::constraints::TypeConstraint &constraint) override
+    {
+        typedef valijson::constraints::TypeConstraint TypeConstraint;
+
+        if (constraint.schemaTypeCount() > 0) {
+            return unsupported("schema-based type");
+        }
+
+        std::vector<TypeConstraint::JsonType> types;
+        constraint.applyToNamedTypes(
+                [&types](TypeConstraint::JsonType type) {
+                    types.push_back(type);
+                    return true;
+                });
+
+        std::vector<std::string> checks;
+        for (const TypeConstraint::JsonType type : types) {
+            switch (type) {
+            case TypeConstraint::kAny:
+                return true;
+            case TypeConstraint::kArray:
+                checks.push_back("target.isArray()");
+                break;
+            case TypeConstraint::kBoolean:
+                checks.push_back("target.isBool()");
+                break;
+            case TypeConstraint::kInteger:
+                checks.push_back("target.isInteger()");
+                break;
+            case TypeConstraint::kNull:
+                checks.push_back("target.isNull()");
+                break;
+            case TypeConstraint::kNumber:
+                checks.push_back("target.isNumber()");
+                break;
+            case TypeConstraint::kObject:
+                checks.push_back("target.isObject()");
+                break;
+            case TypeConstraint::kString:
+                checks.push_back("target.isString()");
+                break;
+            }
+        }
+
+        m_body << "    // type\n    if (!(";
+        for (size_t i = 0; i < checks.size(); i++) {
+            if (i > 0) {
+                m_body << " || ";
+            }
+            m_body << checks[i];
+        }
+        m_body << ")) {\n        return false;\n    }\n\n";
+        return true;
+    }
+
+    bool visit(const valijson::constraints::UniqueItemsConstraint &) override
+    {
+        return unsupported("uniqueItems");
+    }
+
+private:
+    bool unsupported(const char *construct)
+    {
+        m_unsupported = construct;
+        return false;
+    }
+
+    static std::string doubleLiteral(double value)
+    {
+        std::ostringstream stream;
+        stream.precision(17);
+        stream << value;
+        const std::string text = stream.str();
+        // Keep the literal a double even when the value is integral
+        return text.find_first_of(".eEn") == std::string::npos ? text + ".0" : text;
+    }
+
+    NodeRegistry &m_registry;
+    std::ostringstream &m_body;
+    std::string m_unsupported;
+};
+
+/// Emit the body of one node's validation function, or exit on failure
+std::string emitNodeBody(NodeRegistry &registry, const Subschema &subschema,
+        size_t nodeIndex)
+{
+    std::ostringstream body;
+    CodegenVisitor visitor(registry, body);
+
+    bool supported = true;
+    Subschema::ApplyFunction fn(
+            [&visitor, &supported](const valijson::constraints::Constraint &constraint) {
+                if (!constraint.accept(visitor)) {
+                    supported = false;
+                }
+                return true;
+            });
+    subschema.apply(fn);
+
+    if (!supported) {
+        std::cerr << "Error: sub-schema " << nodeIndex << " uses '"
+                  << visitor.unsupportedConstruct()
+                  << "', which is outside the supported subset; "
+                  << "use the runtime Validator for this schema." << std::endl;
+        exit(65);
+    }
+
+    return body.str();
+}
+
+void usage()
+{
+    std::cerr <<
+        "Compiles a JSON Schema to a C++ header of templated validation functions\n"
+        "\n"
+        "The generated functions accept any type satisfying the valijson Adapter\n"
+        "concept. Only the structural subset of JSON Schema is supported; schemas\n"
+        "using other constructs are rejected and should use the runtime Validator.\n"
+        "\n"
+        "Output is written to STDOUT.\n"
+        "\n"
+        "Usage:\n"
+        "\n"
+        "  constexpr_codegen <schema.json> [namespace]\n"
+        "\n"
+        "Example usage:\n"
+        "\n"
+        "  constexpr_codegen config_schema.json config_schema > config_schema.hpp\n"
+        << std::endl;
+    exit(64);
+}
+
+} // end anonymous namespace
+
+int main(int argc, char **argv)
+{
+    if (argc < 2 || argc > 3) {
+        usage();
+    }
+
+    const std::string schemaPath = argv[1];
+    const std::string ns = argc == 3 ? argv[2] : "valijson_generated";
+
+    nlohmann::json schemaDocument;
+    if (!valijson::utils::loadDocument(schemaPath, schemaDocument)) {
+        std::cerr << "Error: failed to load schema from " << schemaPath << std::endl;
+        return 65;
+    }
+
+    Schema schema;
+    try {
+        SchemaParser parser;
+        valijson::adapters::NlohmannJsonAdapter schemaAdapter(schemaDocument);
+        parser.populateSchema(schemaAdapter, schema);
+    } catch (std::exception &e) {
+        std::cerr << "Error: failed to parse schema: " << e.what() << std::endl;
+        return 65;
+    }
+
+    NodeRegistry registry;
+    registry.indexOf(&schema);
+
+    std::vector<std::string> bodies;
+    while (registry.hasPending()) {
+        const Subschema *subschema = registry.popPending();
+        const size_t nodeIndex = bodies.size();
+        bodies.push_back(emitNodeBody(registry, *subschema, nodeIndex));
+    }
+
+    std::ostream &out = std::cout;
+    out << "// Generated by tools/constexpr_codegen.cpp from " << schemaPath << "\n"
+        << "// Do not edit; regenerate from the source schema instead.\n"
+        << "\n"
+        << "#pragma once\n"
+        << "\n"
+        << "#include <cstddef>\n"
+        << "#include <cstdint>\n"
+        << "#include <regex>\n"
+        << "#include <string>\n"
+        << "\n"
+        << "namespace " << ns << " {\n"
+        << "namespace detail {\n"
+        << "\n"
+        << "inline std::uint64_t utf8Length(const std::string &value)\n"
+        << "{\n"
+        << "    std::uint64_t length = 0;\n"
+        << "    for (const char c : value) {\n"
+        << "        if ((static_cast<unsigned char>(c) & 0xc0) != 0x80) {\n"
+        << "            ++length;\n"
+        << "        }\n"
+        << "    }\n"
+        << "    return length;\n"
+        << "}\n"
+        << "\n";
+
+    for (size_t i = 0; i < bodies.size(); i++) {
+        out << "template<typename AdapterType>\n"
+            << "bool validateNode" << i << "(const AdapterType &target);\n";
+    }
+
+    for (size_t i = 0; i < bodies.size(); i++) {
+        out << "\n"
+            << "template<typename AdapterType>\n"
+            << "bool validateNode" << i << "(const AdapterType &target)\n"
+            << "{\n"
+            << bodies[i]
+            << "    return true;\n"
+            << "}\n";
+    }
+
+    out << "\n"
+        << "} // namespace detail\n"
+        << "\n"
+        << "/// Validate a value against the schema compiled into this header\n"
+        << "template<typename AdapterType>\n"
+        << "bool validate(const AdapterType &target)\n"
+        << "{\n"
+        << "    return detail::validateNode0(target);\n"
+        << "}\n"
+        << "\n"
+        << "} // namespace " << ns << "\n";
+
+    return 0;
+}